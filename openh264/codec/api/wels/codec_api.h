@@ -335,7 +335,32 @@ class ISVCEncoder {
   * @return  CM_RETURN: 0 - success; otherwise - failed;
   */
   virtual int EXTAPI GetOption (ENCODER_OPTION eOptionId, void* pOption) = 0;
+
   virtual ~ISVCEncoder() {}
+
+  /* methods added after the destructor keep the vtable offsets of the ones above */
+  /**
+  * @brief   Queue one picture for encoding on the encoder's own thread and return without waiting for it
+  * @param   kpSrcPic the source picture, its pixel data must stay valid until the frame is returned by GetEncodedFrame()
+  * @param   pUserData opaque pointer handed back in SEncodedFrame::pUserData
+  * @return  CM_RETURN: 0 - success; cmRetryLater - ENCODER_OPTION_ASYNC_QUEUE_DEPTH frames are in flight, fetch and
+  *          release one first; otherwise - failed;
+  */
+  virtual int EXTAPI EncodeFrameAsync (const SSourcePicture* kpSrcPic, void* pUserData) = 0;
+
+  /**
+  * @brief   Get the next frame queued by EncodeFrameAsync(), in submission order
+  * @param   ppFrame the encoded frame, owned by the application until ReleaseEncodedFrame()
+  * @param   bWait block until the next frame is encoded if it is not ready yet
+  * @return  CM_RETURN: 0 - success; cmRetryLater - no frame is ready or nothing is queued; otherwise - failed;
+  */
+  virtual int EXTAPI GetEncodedFrame (SEncodedFrame** ppFrame, bool bWait) = 0;
+
+  /**
+  * @brief   Give a frame returned by GetEncodedFrame() back to the encoder so that its buffer can be reused
+  * @return  CM_RETURN: 0 - success; otherwise - failed;
+  */
+  virtual int EXTAPI ReleaseEncodedFrame (SEncodedFrame* pFrame) = 0;
 };
 
 
@@ -467,6 +492,80 @@ class ISVCDecoder {
   virtual ~ISVCDecoder() {}
 };
 
+/**
+* @brief Decoder of many independent streams sharing worker threads and a picture budget
+*
+* Access units of one stream are decoded one after the other and their pictures are returned in output order,
+* different streams are decoded in parallel on the workers. All calls may come from any application thread,
+* but calls for one stream must not overlap CloseStream() of that stream.
+*/
+class ISVCDecoderService {
+ public:
+  /**
+  * @brief  Start the workers
+  * @param  pParam  threads, stream count, queue depth and picture budget
+  * @return CM_RETURN: 0 - success; otherwise - failed;
+  */
+  virtual long EXTAPI Initialize (const SDecoderServiceParam* pParam) = 0;
+
+  /// close all streams and release the workers
+  virtual long EXTAPI Uninitialize() = 0;
+
+  /**
+  * @brief  Open a stream decoded with the given parameters
+  * @param  pParam  as for ISVCDecoder::Initialize()
+  * @param  pStreamId  id of the new stream for the other calls
+  * @return CM_RETURN: 0 - success; cmRetryLater - SDecoderServiceParam::iMaxStreams streams are open; otherwise - failed;
+  */
+  virtual long EXTAPI OpenStream (const SDecodingParam* pParam, int* pStreamId) = 0;
+
+  /**
+  * @brief  Drop the queued access units of the stream, wait for the one under decoding and free the stream
+  *         Frames of the stream not released yet stay valid until ReleaseDecodedFrame().
+  * @return CM_RETURN: 0 - success; otherwise - failed;
+  */
+  virtual long EXTAPI CloseStream (int iStreamId) = 0;
+
+  /**
+  * @brief  Queue one complete access unit of the stream for decoding and return without waiting for it
+  * @param  pSrc  the access unit, copied; NULL with iSrcLen 0 ends the stream and outputs the pictures still buffered
+  * @param  uiTimeStamp  handed back in SBufferInfo::uiOutYuvTimeStamp of the picture
+  * @return CM_RETURN: 0 - success; cmRetryLater - the stream's queue is full or the picture budget is used up;
+  *         otherwise - failed;
+  */
+  virtual long EXTAPI SubmitAccessUnit (int iStreamId, const unsigned char* pSrc, const int iSrcLen,
+                                        unsigned long long uiTimeStamp) = 0;
+
+  /**
+  * @brief  Get the next decoded picture of the stream, in output order
+  * @param  ppFrame  the picture, owned by the application until ReleaseDecodedFrame()
+  * @param  bWait  block while access units of the stream are still queued or under decoding
+  * @return CM_RETURN: 0 - success; cmRetryLater - no picture is ready; otherwise - failed;
+  */
+  virtual long EXTAPI GetDecodedFrame (int iStreamId, SDecodedFrame** ppFrame, bool bWait) = 0;
+
+  /**
+  * @brief  Give a picture returned by GetDecodedFrame() back, its buffer counts against the budget until then
+  * @return CM_RETURN: 0 - success; otherwise - failed;
+  */
+  virtual long EXTAPI ReleaseDecodedFrame (SDecodedFrame* pFrame) = 0;
+
+  /**
+  * @brief  ISVCDecoder::SetOption() on the decoder of the stream. Before the first SubmitAccessUnit() of the stream
+  *         the options only effective before Initialize() are accepted too. The service owns the threads, the frame
+  *         allocator and the end of stream of its decoders, their options are refused.
+  * @return CM_RETURN: 0 - success; otherwise - failed;
+  */
+  virtual long EXTAPI SetStreamOption (int iStreamId, DECODER_OPTION eOptionId, void* pOption) = 0;
+
+  /**
+  * @brief  ISVCDecoder::GetOption() on the decoder of the stream
+  * @return CM_RETURN: 0 - success; otherwise - failed;
+  */
+  virtual long EXTAPI GetStreamOption (int iStreamId, DECODER_OPTION eOptionId, void* pOption) = 0;
+  virtual ~ISVCDecoderService() {}
+};
+
 
 extern "C"
 {
@@ -490,6 +589,17 @@ int (*ForceIntraFrame) (ISVCEncoder*, bool bIDR);
 
 int (*SetOption) (ISVCEncoder*, ENCODER_OPTION eOptionId, void* pOption);
 int (*GetOption) (ISVCEncoder*, ENCODER_OPTION eOptionId, void* pOption);
+
+/* entries of the C++ virtual destructor, not to be called from C: one with the MSVC ABI, two otherwise */
+#if defined(_MSC_VER)
+void (*Destructor[1]) (ISVCEncoder*);
+#else
+void (*Destructor[2]) (ISVCEncoder*);
+#endif
+
+int (*EncodeFrameAsync) (ISVCEncoder*, const SSourcePicture* kpSrcPic, void* pUserData);
+int (*GetEncodedFrame) (ISVCEncoder*, SEncodedFrame** ppFrame, bool bWait);
+int (*ReleaseEncodedFrame) (ISVCEncoder*, SEncodedFrame* pFrame);
 };
 
 typedef struct ISVCDecoderVtbl ISVCDecoderVtbl;
@@ -534,6 +644,24 @@ DECODING_STATE (*DecodeFrameEx) (ISVCDecoder*, const unsigned char* pSrc,
 long (*SetOption) (ISVCDecoder*, DECODER_OPTION eOptionId, void* pOption);
 long (*GetOption) (ISVCDecoder*, DECODER_OPTION eOptionId, void* pOption);
 };
+
+typedef struct ISVCDecoderServiceVtbl ISVCDecoderServiceVtbl;
+typedef const ISVCDecoderServiceVtbl* ISVCDecoderService;
+struct ISVCDecoderServiceVtbl {
+long (*Initialize) (ISVCDecoderService*, const SDecoderServiceParam* pParam);
+long (*Uninitialize) (ISVCDecoderService*);
+
+long (*OpenStream) (ISVCDecoderService*, const SDecodingParam* pParam, int* pStreamId);
+long (*CloseStream) (ISVCDecoderService*, int iStreamId);
+
+long (*SubmitAccessUnit) (ISVCDecoderService*, int iStreamId, const unsigned char* pSrc, const int iSrcLen,
+                          unsigned long long uiTimeStamp);
+long (*GetDecodedFrame) (ISVCDecoderService*, int iStreamId, SDecodedFrame** ppFrame, bool bWait);
+long (*ReleaseDecodedFrame) (ISVCDecoderService*, SDecodedFrame* pFrame);
+
+long (*SetStreamOption) (ISVCDecoderService*, int iStreamId, DECODER_OPTION eOptionId, void* pOption);
+long (*GetStreamOption) (ISVCDecoderService*, int iStreamId, DECODER_OPTION eOptionId, void* pOption);
+};
 #endif
 
 typedef void (*WelsTraceCallback) (void* ctx, int level, const char* string);
@@ -572,6 +700,24 @@ long WelsCreateDecoder (ISVCDecoder** ppDecoder);
 */
 void WelsDestroyDecoder (ISVCDecoder* pDecoder);
 
+/** @brief   Create a multi-stream decoder service
+*   @param   ppService service to be created
+*   @return  0 - success; otherwise - failed;
+*/
+long WelsCreateDecoderService (ISVCDecoderService** ppService);
+
+
+/** @brief   Destroy a decoder service, uninitializing it if needed
+*   @param   pService the service to be destroyed
+*/
+void WelsDestroyDecoderService (ISVCDecoderService* pService);
+
+/** @brief   Set how many bytes of freed picture and other large buffers the process keeps for later encoder and
+*            decoder instances, so that reinitializing or recreating one does not go back to the system allocator
+*   @param   uiLimit  bytes kept, 64 MB by default; lowering it frees kept buffers right away, 0 keeps none
+*/
+void WelsSetBufferPoolLimit (unsigned int uiLimit);
+
 /** @brief   Get codec version
  *           Note, old versions of Mingw (GCC < 4.7) are buggy and use an
  *           incorrect/different ABI for calling this function, making it
@@ -51,6 +51,9 @@
 #define MAX_RTP_PAYLOAD_LEN             1000
 #define AVERAGE_RTP_PAYLOAD_LEN         800
 
+#define MAX_THREAD_POOL_NAME_LEN        32
+#define MAX_THREAD_AFFINITY_CPU_NUM     64
+
 
 #define SAVED_NALUNIT_NUM_TMP           ( (MAX_SPATIAL_LAYER_NUM*MAX_QUALITY_LAYER_NUM) + 1 + MAX_SPATIAL_LAYER_NUM )  ///< SPS/PPS + SEI/SSEI + PADDING_NAL
 #define MAX_SLICES_NUM_TMP              ( ( MAX_NAL_UNITS_IN_LAYER - SAVED_NALUNIT_NUM_TMP ) / 3 )
@@ -142,7 +145,12 @@ typedef enum {
 
   ENCODER_OPTION_IS_LOSSLESS_LINK,            ///< advanced algorithmetic settings
 
-  ENCODER_OPTION_BITS_VARY_PERCENTAGE        ///< bit vary percentage
+  ENCODER_OPTION_BITS_VARY_PERCENTAGE,       ///< bit vary percentage
+
+  ENCODER_OPTION_GET_SOURCE_BUFFER,          ///< read only, SSourcePicture describing the aligned and padded I420 buffer the next EncodeFrame() reads; fill it in place and pass it back to skip the input copy
+  ENCODER_OPTION_ASYNC_QUEUE_DEPTH,          ///< int, maximum number of EncodeFrameAsync() frames in flight, counting encoded frames not yet released; can only be changed while none are
+  ENCODER_OPTION_THREAD_POOL,                ///< SThreadPoolParam, run the slice tasks on an instance-owned or named pool instead of the process wide one; may be set before Initialize(), takes effect at the next (re)initialization
+  ENCODER_OPTION_MEMORY_USAGE                ///< read only, SMemoryUsage of the encoder since its last (re)initialization
 } ENCODER_OPTION;
 
 /**
@@ -169,6 +177,18 @@ typedef enum {
   DECODER_OPTION_IS_REF_PIC,             ///< feedback current frame is ref pic or not
   DECODER_OPTION_NUM_OF_FRAMES_REMAINING_IN_BUFFER,  ///< number of frames remaining in decoder buffer when pictures are required to re-ordered into display-order.
   DECODER_OPTION_NUM_OF_THREADS,         ///< number of decoding threads. The maximum thread count is equal or less than lesser of (cpu core counts and 16).
+  DECODER_OPTION_THREAD_POOL,            ///< SThreadPoolParam, number and cpu affinity of the decoding threads; decoding threads always belong to the instance, szPoolName is ignored
+  DECODER_OPTION_DEBLOCKING_THREAD,      ///< int, run the loop filter of each decoding thread on a worker one MB row behind reconstruction; 0 disables (default)
+  DECODER_OPTION_SLICE_THREADS,          ///< int, number of threads parsing and reconstructing the slices of one picture in parallel when DECODER_OPTION_NUM_OF_THREADS is off, the loop filter follows in slice order; 0 or 1 disables (default)
+  DECODER_OPTION_LOW_LATENCY_THREADS,    ///< int, with DECODER_OPTION_NUM_OF_THREADS, DecodeFrameNoDelay() returns each baseline picture from the call that fed it, as soon as its last MB row is reconstructed, instead of buffering it for one more call; 0 disables (default)
+  DECODER_OPTION_FRAME_ALLOCATOR,        ///< SDecoderFrameAllocator, decode pictures into application buffers, see DECODER_OPTION_OUTPUT_USER_FRAME; only effective before Initialize()
+  DECODER_OPTION_OUTPUT_FORMAT,          ///< int, EVideoFormatType of the output: videoFormatI420 (default), videoFormatBGR, videoFormatRGBA or videoFormatNV12, converted row by row as the picture is filtered; only effective before Initialize()
+  DECODER_OPTION_SCALED_OUTPUT,          ///< SDecoderScaledOutput, output only an I420 picture of that size, bilinearly scaled row by row as the picture is filtered; only effective before Initialize()
+  DECODER_OPTION_SKIP_FRAMES,            ///< int, EDecoderSkipFrames, pictures dropped right after their NAL header, counted in DECODER_OPTION_SKIPPED_FRAME_COUNT; turn off at an IDR picture
+  DECODER_OPTION_MEMORY_USAGE,           ///< read only, SMemoryUsage of the decoder since Initialize(), summed over its decoding threads
+  DECODER_OPTION_LAZY_BORDER_EXPANSION,  ///< int, do not pad the borders of reference pictures, motion compensation replicates the picture edge for blocks reaching outside instead; 0 disables (default), only effective before Initialize()
+  DECODER_OPTION_OUTPUT_USER_FRAME,      ///< read only, void*, with DECODER_OPTION_FRAME_ALLOCATOR the pUserFrame handle of the buffer holding the picture output by the last decoding call, NULL otherwise
+  DECODER_OPTION_SKIPPED_FRAME_COUNT,    ///< read only, unsigned int, number of pictures dropped by DECODER_OPTION_SKIP_FRAMES since Initialize(), not in SDecoderStatistics::uiDecodedFrameCount
 } DECODER_OPTION;
 
 /**
@@ -184,6 +204,15 @@ typedef enum {
   ERROR_CON_SLICE_MV_COPY_CROSS_IDR,
   ERROR_CON_SLICE_MV_COPY_CROSS_IDR_FREEZE_RES_CHANGE
 } ERROR_CON_IDC;
+
+/**
+* @brief Pictures the decoder drops without parsing their slices, see DECODER_OPTION_SKIP_FRAMES
+*/
+typedef enum {
+  DECODER_SKIP_NONE = 0,           ///< decode all pictures (default)
+  DECODER_SKIP_NON_REF,            ///< drop the pictures no other picture refers to (nal_ref_idc 0)
+  DECODER_SKIP_NON_INTRA           ///< decode IDR and I pictures only, e.g. for seeking or thumbnails
+} EDecoderSkipFrames;
 /**
 * @brief Feedback that whether or not have VCL NAL in current AU
 */
@@ -274,6 +303,15 @@ typedef enum {
   RC_OFF_MODE = -1,         ///< rate control off mode
 } RC_MODES;
 
+/**
+* @brief Enumerate the pass of the two-pass rate control
+*/
+typedef enum {
+  RC_SINGLE_PASS = 0,      ///< no statistics file
+  RC_FIRST_PASS  = 1,      ///< write the statistics file, P macroblocks are only searched as 16x16 to keep this pass fast
+  RC_SECOND_PASS = 2       ///< read the statistics file written by the first pass to allocate the bits
+} ERcPassType;
+
 /**
 * @brief Enumerate the type of profile id
 */
@@ -596,6 +634,12 @@ typedef struct TagEncParamExt {
   bool    bIsLosslessLink;             ///< LTR advanced setting
   bool    bFixRCOverShoot;             ///< fix rate control overshooting
   int     iIdrBitrateRatio;            ///< the target bits of IDR is (idr_bitrate_ratio/100) * average target bit per frame.
+  bool    bUseWavefrontMd;             ///< only used when uiSliceMode=0 and iMultipleThreadIdc>1, motion estimation and mode decision of P slices run in parallel on MB-row wavefronts while entropy coding stays sequential, the bitstream does not depend on the thread number
+  bool    bEnableFramePipeline;        ///< scale and denoise the next input picture on a lookahead thread while the current one is encoded; EncodeFrame() then returns the bitstream of the previous input picture, pass a NULL picture to flush the last one; a SetOption() reinitializing the encoder fails until it is flushed
+  bool    bEnablePyramidMe;            ///< camera video only, seed the motion search of P frames with vectors found on 1/4 and 1/16 size luma planes, finds larger motion at high resolutions
+  int     iLookaheadFrames;            ///< camera video only, [0, 16]: number of input pictures analysed ahead to steer the target bits and to place IDR pictures at scene cuts, 0 disables it; EncodeFrame() returns the bitstream of the picture that many inputs before, pass one NULL picture per held picture to flush them; a SetOption() reinitializing the encoder fails until they are flushed
+  ERcPassType eRcPass;                 ///< camera video with a bitrate, quality or timestamp rate control only: pass of the two-pass rate control, both passes have to encode the same input with the same settings
+  char*   pRcStatsFileName;            ///< statistics file written by RC_FIRST_PASS and read by RC_SECOND_PASS
 } SEncParamExt;
 
 /**
@@ -653,13 +697,84 @@ typedef struct {
   long long uiTimeStamp;
 } SFrameBSInfo, *PFrameBSInfo;
 
+/**
+* @brief Frame encoded by ISVCEncoder::EncodeFrameAsync()
+*/
+typedef struct {
+  int             iReturn;         ///< CM_RETURN of encoding this picture, what EncodeFrame() would have returned
+  SFrameBSInfo    sBsInfo;         ///< layer and NAL description, the layers lie back to back in pBsBuf
+  unsigned char*  pBsBuf;          ///< bitstream of the whole frame, sBsInfo.iFrameSizeInBytes long, owned by the frame
+  void*           pUserData;       ///< the pointer passed to EncodeFrameAsync() together with the source picture
+} SEncodedFrame;
+
+/**
+* @brief Worker threads of an encoder or decoder instance, see ENCODER_OPTION_THREAD_POOL / DECODER_OPTION_THREAD_POOL
+*/
+typedef struct {
+  int                 iThreadNum;                                   ///< number of worker threads, 0 keeps the count from iMultipleThreadIdc / DECODER_OPTION_NUM_OF_THREADS
+  char                szPoolName[MAX_THREAD_POOL_NAME_LEN];         ///< empty for a pool owned by the instance; instances naming the same pool share it, the first one sizes and pins it
+  int                 iAffinityCpuNum;                              ///< entries used in iAffinityCpu, 0 leaves thread placement to the OS
+  int                 iAffinityCpu[MAX_THREAD_AFFINITY_CPU_NUM];    ///< logical processor indices, worker i is pinned to iAffinityCpu[i % iAffinityCpuNum]; list the processors of a NUMA node to keep the pool there
+} SThreadPoolParam;
+
+/**
+* @brief Application allocator of the decoder's reconstructed pictures, see DECODER_OPTION_FRAME_ALLOCATOR
+*
+* Each buffer holds the padded I420 picture the decoder also predicts from, or with DECODER_OPTION_OUTPUT_FORMAT
+* or DECODER_OPTION_SCALED_OUTPUT the converted output picture only, the decoder then keeps its I420 pictures internal. The decoder asks for a fresh
+* buffer whenever it starts decoding into a recycled picture and releases the buffer it had there, or all of
+* them when it frees its pictures. An application that keeps its own reference on an output pUserFrame can
+* therefore use it without copying for as long as it likes. Both callbacks may be called from decoding threads.
+*/
+typedef struct {
+  void* pUserData;                 ///< passed back to both callbacks
+  /// return iSize bytes aligned to 16 and its handle in *ppUserFrame; NULL makes the decoder keep the picture's previous buffer
+  unsigned char* (*pfGetBuffer) (void* pUserData, int iSize, void** ppUserFrame);
+  /// the decoder no longer reads nor writes the buffer of pUserFrame
+  void (*pfReleaseBuffer) (void* pUserData, void* pUserFrame);
+} SDecoderFrameAllocator;
+
+/**
+* @brief Size of the decoder output, see DECODER_OPTION_SCALED_OUTPUT
+*
+* The cropped picture is scaled to iWidth x iHeight, the full size picture is not output. Meant for downscaling,
+* cannot be combined with an output format other than videoFormatI420.
+*/
+typedef struct {
+  int iWidth;                      ///< even output width, 0 outputs the decoded size (default)
+  int iHeight;                     ///< even output height, 0 outputs the decoded size
+} SDecoderScaledOutput;
+
+/**
+* @brief Parameters of ISVCDecoderService, which decodes many streams on shared worker threads
+*
+* iPictureBudget bounds the decoded pictures of all streams together: the reference and reordering pictures the
+* stream decoders hold and the frames the application has not released yet. Once they reach the budget,
+* SubmitAccessUnit() returns cmRetryLater for every stream until frames are released or streams closed.
+*/
+typedef struct {
+  SThreadPoolParam  sThreadPool;   ///< workers decoding all streams, iThreadNum 0 for one per cpu core; a named pool may be shared with encoders
+  int               iMaxStreams;   ///< streams open at the same time, 0 for 256
+  int               iQueueDepth;   ///< access units queued per stream before SubmitAccessUnit() returns cmRetryLater, 0 for 4
+  long long         iPictureBudget;///< bytes of decoded pictures of all streams, 0 for no limit
+} SDecoderServiceParam;
+
+/**
+* @brief Picture decoded by ISVCDecoderService, see GetDecodedFrame()
+*/
+typedef struct {
+  int           iStreamId;         ///< stream the picture belongs to
+  int           iDecodingState;    ///< DECODING_STATE of the access unit that output the picture
+  SBufferInfo   sBufferInfo;       ///< planes, size and format as from DecodeFrameNoDelay(), uiOutYuvTimeStamp as given to SubmitAccessUnit()
+} SDecodedFrame;
+
 /**
 *  @brief Structure for source picture
 */
 typedef struct Source_Picture_s {
-  int       iColorFormat;          ///< color space type
-  int       iStride[4];            ///< stride for each plane pData
-  unsigned char*  pData[4];        ///< plane pData
+  int       iColorFormat;          ///< color space type, videoFormatI420/NV12/BGR/BGRA/RGBA for encoder input
+  int       iStride[4];            ///< stride for each plane pData, in bytes for packed formats
+  unsigned char*  pData[4];        ///< plane pData, NV12 keeps interleaved UV in pData[1]
   int       iPicWidth;             ///< luma picture width in x coordinate
   int       iPicHeight;            ///< luma picture height in y coordinate
   long long uiTimeStamp;           ///< timestamp of the source picture, unit: millisecond
@@ -804,6 +919,31 @@ typedef struct TagVideoDecoderStatistics {
   unsigned int iStatisticsLogInterval;                  ///< frame interval of statistics log
 } SDecoderStatistics; // in building, coming soon
 
+/**
+* @brief Kinds of codec memory reported in SMemoryUsage, told apart by the tag of each allocation
+*/
+typedef enum {
+  MEMORY_CATEGORY_PICTURES = 0,    ///< source, reconstructed and reference pictures with their per picture data
+  MEMORY_CATEGORY_BITSTREAM,       ///< bitstream input, output and NAL buffers
+  MEMORY_CATEGORY_MB_CACHES,       ///< per macroblock and per block state and caches
+  MEMORY_CATEGORY_VAA,             ///< video analysis buffers of the encoder pre-processing
+  MEMORY_CATEGORY_OTHERS,          ///< contexts, parameter sets, tables and everything else
+  MEMORY_CATEGORY_NUM
+} EMemoryCategory;
+
+/**
+* @brief Memory of an encoder or decoder instance, see ENCODER_OPTION_MEMORY_USAGE / DECODER_OPTION_MEMORY_USAGE
+*
+* Counts the bytes held through the instance's allocator, alignment and block headers included, always on. A peak is the highest value its count had;
+* the total peak may be lower than the sum of the category peaks.
+*/
+typedef struct {
+  long long iCurrentBytes;                                   ///< bytes allocated now
+  long long iPeakBytes;                                      ///< highest iCurrentBytes
+  long long iCategoryCurrentBytes[MEMORY_CATEGORY_NUM];      ///< iCurrentBytes by EMemoryCategory
+  long long iCategoryPeakBytes[MEMORY_CATEGORY_NUM];         ///< highest iCategoryCurrentBytes
+} SMemoryUsage;
+
 /**
 * @brief Structure for sample aspect ratio (SAR) info in VUI
 */
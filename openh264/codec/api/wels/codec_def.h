@@ -83,7 +83,8 @@ typedef enum {
   cmUnknownReason,
   cmMallocMemeError,        ///< malloc a memory error
   cmInitExpected,           ///< initial action is expected
-  cmUnsupportedData
+  cmUnsupportedData,
+  cmRetryLater              ///< the request can not be served now, e.g. no asynchronously encoded frame is ready yet
 } CM_RETURN;
 
 /**
@@ -188,7 +189,7 @@ typedef struct TagSysMemBuffer {
   int iWidth;                    ///< width of decoded pic for display
   int iHeight;                   ///< height of decoded pic for display
   int iFormat;                   ///< type is "EVideoFormatType"
-  int iStride[2];                ///< stride of 2 component
+  int iStride[2];                ///< stride of 2 component, in bytes of the packed pixels for RGB formats, Y and UV for NV12
 } SSysMEMBuffer;
 
 /**
@@ -201,7 +202,7 @@ typedef struct TagBufferInfo {
   union {
     SSysMEMBuffer sSystemBuffer; ///<  memory info for one picture
   } UsrData;                     ///<  output buffer info
-  unsigned char* pDst[3];  //point to picture YUV data
+  unsigned char* pDst[3];  //point to picture YUV data, packed RGB output in pDst[0], NV12 keeps interleaved UV in pDst[1]
 } SBufferInfo;
 
 
@@ -0,0 +1,96 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ *
+ * \file    WelsBufferArena.h
+ *
+ * \brief   process wide cache of large codec buffers in size classes, reused across encoder and decoder instances
+ *
+ * \date    10/17/2026 Created
+ *
+ *************************************************************************************
+ */
+
+#ifndef _WELS_BUFFER_ARENA_H_
+#define _WELS_BUFFER_ARENA_H_
+
+#include "typedefs.h"
+#include "WelsLock.h"
+
+#define WELS_BUFFER_ARENA_MIN_SIZE       (64 * 1024)         // smaller blocks go to malloc directly
+#define WELS_BUFFER_ARENA_MAX_SIZE       (256 * 1024 * 1024)
+#define WELS_BUFFER_ARENA_MAX_ALIGN      64                  // largest alignment a block leaves room for
+#define WELS_BUFFER_ARENA_CLASS_NUM      49                  // four classes per power of two up to the max size
+#define WELS_BUFFER_ARENA_DEFAULT_LIMIT  (64 * 1024 * 1024)
+
+namespace WelsCommon {
+
+/*
+ * Blocks are rounded up to the next of four classes per power of two, so a picture of a slightly different size
+ * still finds a free block, at the cost of at most a quarter of the block. Released blocks are kept on a free
+ * list per class until the kept bytes would exceed the limit; the limit is shared by the whole process.
+ */
+class CWelsBufferArena {
+ public:
+  static CWelsBufferArena& GetInstance();
+
+  static bool IsArenaSize (const uint32_t kuiSize) {
+    return kuiSize >= WELS_BUFFER_ARENA_MIN_SIZE && kuiSize <= WELS_BUFFER_ARENA_MAX_SIZE;
+  }
+  // bytes malloc'ed for a block holding kuiSize bytes
+  static uint32_t GetBlockSize (const uint32_t kuiSize);
+
+  // block with room for kuiSize bytes, WELS_BUFFER_ARENA_MAX_ALIGN alignment and the aligned allocation header
+  void*       Acquire (const uint32_t kuiSize);
+  // kuiSize as given to Acquire()
+  void        Release (void* pBlock, const uint32_t kuiSize);
+
+  void        SetLimit (const uint32_t kuiLimit);
+  uint32_t    GetCachedBytes();
+
+ private:
+  CWelsBufferArena();
+  ~CWelsBufferArena();
+
+  static int32_t GetClass (const uint32_t kuiSize, uint32_t* pClassSize);
+  void        TrimLocked();
+
+  CWelsLock   m_cLock;
+  void*       m_pFreeBlocks[WELS_BUFFER_ARENA_CLASS_NUM]; // linked through their first bytes
+  uint32_t    m_uiCachedBytes;
+  uint32_t    m_uiLimit;
+
+  DISALLOW_COPY_AND_ASSIGN (CWelsBufferArena);
+};
+
+}
+
+#endif//_WELS_BUFFER_ARENA_H_
@@ -56,6 +56,7 @@ typedef    LPTHREAD_START_ROUTINE    LPWELS_THREAD_ROUTINE;
 
 typedef    CRITICAL_SECTION          WELS_MUTEX;
 typedef    HANDLE                    WELS_EVENT;
+typedef    CONDITION_VARIABLE        WELS_CONDITION;
 
 #define    WELS_THREAD_ROUTINE_TYPE         DWORD  WINAPI
 #define    WELS_THREAD_ROUTINE_RETURN(rc)   return (DWORD)rc;
@@ -92,6 +93,7 @@ typedef   pthread_t    WELS_THREAD_HANDLE;
 typedef  void* (*LPWELS_THREAD_ROUTINE) (void*);
 
 typedef   pthread_mutex_t           WELS_MUTEX;
+typedef   pthread_cond_t            WELS_CONDITION;
 
 #ifdef __APPLE__
 typedef   pthread_cond_t            WELS_EVENT;
@@ -122,6 +124,16 @@ WELS_THREAD_ERROR_CODE    WelsMutexLock (WELS_MUTEX*    mutex);
 WELS_THREAD_ERROR_CODE    WelsMutexUnlock (WELS_MUTEX* mutex);
 WELS_THREAD_ERROR_CODE    WelsMutexDestroy (WELS_MUTEX* mutex);
 
+/*
+ * Condition variables, always used with a WELS_MUTEX held around the state they guard: the state is changed and
+ * the condition signalled under the mutex, WelsConditionWait() releases the mutex while blocked and may wake up
+ * spuriously, so the waiter checks the state again in a loop.
+ */
+WELS_THREAD_ERROR_CODE    WelsConditionInit (WELS_CONDITION* pCond);
+WELS_THREAD_ERROR_CODE    WelsConditionDestroy (WELS_CONDITION* pCond);
+WELS_THREAD_ERROR_CODE    WelsConditionWait (WELS_CONDITION* pCond, WELS_MUTEX* pMutex);
+WELS_THREAD_ERROR_CODE    WelsConditionBroadcast (WELS_CONDITION* pCond);
+
 WELS_THREAD_ERROR_CODE    WelsEventOpen (WELS_EVENT* p_event, const char* event_name = NULL);
 WELS_THREAD_ERROR_CODE    WelsEventClose (WELS_EVENT* event, const char* event_name = NULL);
 
@@ -140,10 +152,63 @@ WELS_THREAD_ERROR_CODE    WelsThreadJoin (WELS_THREAD_HANDLE  thread);
 
 WELS_THREAD_HANDLE        WelsThreadSelf();
 
+/* pin the calling thread to logical processor iCpu, counted across all processor groups on Windows */
+WELS_THREAD_ERROR_CODE    WelsThreadSetAffinity (int32_t iCpu);
+
 WELS_THREAD_ERROR_CODE    WelsQueryLogicalProcessInfo (WelsLogicalProcessInfo* pInfo);
 
 void WelsSleep (uint32_t dwMilliSecond);
 
+/*
+ * Sequentially consistent atomics for the lock-free task queues of the thread pool, the 64-bit ones count memory.
+ * WelsAtomicAdd returns the new value, WelsAtomicCas returns non-zero if *pValue held iExpected and was replaced.
+ */
+#if defined(_WIN32) || defined(__CYGWIN__)
+static inline int32_t WelsAtomicLoad (volatile int32_t* pValue) {
+  return InterlockedCompareExchange ((volatile LONG*)pValue, 0, 0);
+}
+static inline void WelsAtomicStore (volatile int32_t* pValue, int32_t iValue) {
+  InterlockedExchange ((volatile LONG*)pValue, iValue);
+}
+static inline int32_t WelsAtomicAdd (volatile int32_t* pValue, int32_t iValue) {
+  return InterlockedExchangeAdd ((volatile LONG*)pValue, iValue) + iValue;
+}
+static inline int32_t WelsAtomicCas (volatile int32_t* pValue, int32_t iExpected, int32_t iDesired) {
+  return InterlockedCompareExchange ((volatile LONG*)pValue, iDesired, iExpected) == iExpected;
+}
+static inline int64_t WelsAtomicLoad64 (volatile int64_t* pValue) {
+  return InterlockedCompareExchange64 ((volatile LONGLONG*)pValue, 0, 0);
+}
+static inline int64_t WelsAtomicAdd64 (volatile int64_t* pValue, int64_t iValue) {
+  return InterlockedExchangeAdd64 ((volatile LONGLONG*)pValue, iValue) + iValue;
+}
+static inline int32_t WelsAtomicCas64 (volatile int64_t* pValue, int64_t iExpected, int64_t iDesired) {
+  return InterlockedCompareExchange64 ((volatile LONGLONG*)pValue, iDesired, iExpected) == iExpected;
+}
+#else
+static inline int32_t WelsAtomicLoad (volatile int32_t* pValue) {
+  return __atomic_load_n (pValue, __ATOMIC_SEQ_CST);
+}
+static inline void WelsAtomicStore (volatile int32_t* pValue, int32_t iValue) {
+  __atomic_store_n (pValue, iValue, __ATOMIC_SEQ_CST);
+}
+static inline int32_t WelsAtomicAdd (volatile int32_t* pValue, int32_t iValue) {
+  return __atomic_add_fetch (pValue, iValue, __ATOMIC_SEQ_CST);
+}
+static inline int32_t WelsAtomicCas (volatile int32_t* pValue, int32_t iExpected, int32_t iDesired) {
+  return __atomic_compare_exchange_n (pValue, &iExpected, iDesired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+static inline int64_t WelsAtomicLoad64 (volatile int64_t* pValue) {
+  return __atomic_load_n (pValue, __ATOMIC_SEQ_CST);
+}
+static inline int64_t WelsAtomicAdd64 (volatile int64_t* pValue, int64_t iValue) {
+  return __atomic_add_fetch (pValue, iValue, __ATOMIC_SEQ_CST);
+}
+static inline int32_t WelsAtomicCas64 (volatile int64_t* pValue, int64_t iExpected, int64_t iDesired) {
+  return __atomic_compare_exchange_n (pValue, &iExpected, iDesired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+#endif//_WIN32
+
 #ifdef  __cplusplus
 }
 #endif
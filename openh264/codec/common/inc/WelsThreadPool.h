@@ -38,79 +38,145 @@
  *************************************************************************************
  */
 
-
 #ifndef _WELS_THREAD_POOL_H_
 #define _WELS_THREAD_POOL_H_
 
 #include <stdio.h>
 #include "WelsTask.h"
-#include "WelsTaskThread.h"
+#include "WelsThread.h"
 #include "WelsList.h"
 
 namespace WelsCommon {
 
+/*
+ * Bounded lock-free multi-producer multi-consumer ring of tasks (sequence-numbered cells, D. Vyukov).
+ * Every pool worker owns one; any thread may push into it and idle workers steal from the others.
+ */
+class CWelsTaskQueue {
+ public:
+  CWelsTaskQueue();
+  ~CWelsTaskQueue();
+
+  bool        Init (const int32_t kiCapacity);
+  bool        Push (IWelsTask* pTask);
+  IWelsTask*  Pop();
+  bool        IsEmpty();
+
+ private:
+  typedef struct TagTaskCell {
+    volatile int32_t  iSequence;
+    IWelsTask*        pTask;
+  } STaskCell;
+
+  STaskCell*        m_pCells;
+  int32_t           m_iMask;
+  // producers and consumers hit different cache lines
+  volatile int32_t  m_iEnqueuePos;
+  uint8_t           m_uiPad[60];
+  volatile int32_t  m_iDequeuePos;
+
+  DISALLOW_COPY_AND_ASSIGN (CWelsTaskQueue);
+};
+
+class CWelsThreadPool;
+
+class CWelsPoolWorker : public CWelsThread {
+ public:
+  CWelsPoolWorker (CWelsThreadPool* pPool, const int32_t kiIndex, const int32_t kiAffinityCpu);
+  virtual ~CWelsPoolWorker();
+
+  virtual void Thread();
+  virtual void ExecuteTask();
+  void         Wake() {
+    SignalThread();
+  }
+  bool         IsStopping() const {
+    return GetEndFlag();
+  }
+  int32_t      GetIndex() const {
+    return m_iIndex;
+  }
+
+ private:
+  CWelsThreadPool*  m_pPool;
+  int32_t           m_iIndex;
+  int32_t           m_iAffinityCpu;
 
-class  CWelsThreadPool : public CWelsThread, public IWelsTaskThreadSink {
+  DISALLOW_COPY_AND_ASSIGN (CWelsPoolWorker);
+};
+
+class  CWelsThreadPool {
  public:
   enum {
     DEFAULT_THREAD_NUM = 4,
+    TASK_QUEUE_CAPACITY = 256,
+    MAX_AFFINITY_CPU_NUM = 64,
+    MAX_POOL_NAME_LEN = 32,
   };
 
+  // sizes the process wide pool, only while nobody references it
   static WELS_THREAD_ERROR_CODE SetThreadNum (int32_t iMaxThreadNum);
 
+  // the process wide pool
   static CWelsThreadPool* AddReference();
+  // a pool of its own for the caller; worker i is pinned to processor pAffinityCpus[i % iCpuNum] when iCpuNum > 0
+  static CWelsThreadPool* CreateInstance (int32_t iThreadNum, const int32_t* pAffinityCpus, int32_t iCpuNum);
+  // the pool called kpName, created with the given size and affinity by its first user
+  static CWelsThreadPool* AddNamedReference (const char* kpName, int32_t iThreadNum, const int32_t* pAffinityCpus,
+      int32_t iCpuNum);
+  // drops a reference got from any of the above, the last one stops the workers
   void RemoveInstance();
 
   static bool IsReferenced();
 
-  //IWelsTaskThreadSink
-  virtual WELS_THREAD_ERROR_CODE OnTaskStart (CWelsTaskThread* pThread,  IWelsTask* pTask);
-  virtual WELS_THREAD_ERROR_CODE OnTaskStop (CWelsTaskThread* pThread,  IWelsTask* pTask);
-
-  //  CWelsThread
-  virtual void ExecuteTask();
-
   WELS_THREAD_ERROR_CODE  QueueTask (IWelsTask* pTask);
   int32_t        GetThreadNum() const {
-    return m_iMaxThreadNum;
+    return m_iThreadNum;
   }
 
+  // run on the workers: drain the own queue, then steal, until nothing is left
+  void           ExecuteWorkerTasks (CWelsPoolWorker* pWorker);
 
  protected:
   WELS_THREAD_ERROR_CODE Init();
   WELS_THREAD_ERROR_CODE Uninit();
 
-  WELS_THREAD_ERROR_CODE CreateIdleThread();
-  void           DestroyThread (CWelsTaskThread* pThread);
-  WELS_THREAD_ERROR_CODE AddThreadToIdleQueue (CWelsTaskThread* pThread);
-  WELS_THREAD_ERROR_CODE AddThreadToBusyList (CWelsTaskThread* pThread);
-  WELS_THREAD_ERROR_CODE RemoveThreadFromBusyList (CWelsTaskThread* pThread);
-  bool           AddTaskToWaitedList (IWelsTask* pTask);
-  CWelsTaskThread*   GetIdleThread();
-  IWelsTask*         GetWaitedTask();
-  int32_t            GetIdleThreadNum();
-  int32_t            GetBusyThreadNum();
-  int32_t            GetWaitedTaskNum();
+  IWelsTask*         GetTask (const int32_t kiWorkerIdx);
+  bool               HasWaitedTask();
+  void               WakeIdleWorker (const int32_t kiPreferredIdx);
   void               ClearWaitedTasks();
 
  private:
-  CWelsThreadPool();
+  CWelsThreadPool (int32_t iThreadNum, const int32_t* pAffinityCpus, int32_t iCpuNum);
   virtual ~CWelsThreadPool();
-  
+
+  static CWelsThreadPool* NewPool (int32_t iThreadNum, const int32_t* pAffinityCpus, int32_t iCpuNum);
   WELS_THREAD_ERROR_CODE StopAllRunning();
 
-  static int32_t   m_iRefCount;
   static int32_t   m_iMaxThreadNum;
   static CWelsThreadPool* m_pThreadPoolSelf;
+  static CWelsThreadPool* m_pNamedPools;
+
+  int32_t            m_iRefCount;
+  int32_t            m_iThreadNum;
+  int32_t            m_iAffinityCpus[MAX_AFFINITY_CPU_NUM];
+  int32_t            m_iAffinityCpuNum;
+  char               m_szName[MAX_POOL_NAME_LEN];
+  CWelsThreadPool*   m_pNextNamedPool;
+
+  int32_t            m_iWorkerNum;
+  CWelsPoolWorker**  m_pWorkers;
+  CWelsTaskQueue*    m_pTaskQueues;
+  // 1 while the worker waits on its event, cleared by whoever claims the wakeup
+  volatile int32_t*  m_pIdleFlags;
+  volatile int32_t   m_iNextQueueIdx;
 
-  CWelsNonDuplicatedList<IWelsTask>* m_cWaitedTasks;
-  CWelsNonDuplicatedList<CWelsTaskThread>* m_cIdleThreads;
-  CWelsList<CWelsTaskThread>* m_cBusyThreads;
+  // only used once every worker queue is full
+  CWelsList<IWelsTask>* m_cOverflowTasks;
+  volatile int32_t   m_iOverflowTaskNum;
+  CWelsLock          m_cLockOverflowTasks;
 
-  CWelsLock   m_cLockPool;
-  CWelsLock   m_cLockWaitedTasks;
-  CWelsLock   m_cLockIdleTasks;
-  CWelsLock   m_cLockBusyTasks;
+  CWelsLock          m_cLockPool;
 
   DISALLOW_COPY_AND_ASSIGN (CWelsThreadPool);
 };
@@ -119,6 +185,3 @@ class  CWelsThreadPool : public CWelsThread, public IWelsTaskThreadSink {
 
 
 #endif
-
-
-
@@ -0,0 +1,64 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ *
+ * \file    downsample_common.h
+ *
+ * \brief   general bilinear downsampling, usable on horizontal bands of the destination
+ *
+ * \date    10/16/2026 Created
+ *
+ *************************************************************************************
+ */
+
+#ifndef WELS_DOWNSAMPLE_COMMON_H__
+#define WELS_DOWNSAMPLE_COMMON_H__
+
+#include "typedefs.h"
+
+/*
+ * Rows [iFirstRow, iEndRow) of the kiDstWidth x kiDstHeight scaled picture, in 15 bit fixed point.
+ * Producing all rows in one or several calls gives the same picture.
+ */
+typedef void (*PGeneralBilinearDownsampleRowsFunc) (uint8_t* pDst, const int32_t kiDstStride, const int32_t kiDstWidth,
+    const int32_t kiDstHeight, const uint8_t* kpSrc, const int32_t kiSrcStride, const int32_t kiSrcWidth,
+    const int32_t kiSrcHeight, const int32_t kiFirstRow, const int32_t kiEndRow);
+
+void WelsGeneralBilinearDownsampleRows_c (uint8_t* pDst, const int32_t kiDstStride, const int32_t kiDstWidth,
+    const int32_t kiDstHeight, const uint8_t* kpSrc, const int32_t kiSrcStride, const int32_t kiSrcWidth,
+    const int32_t kiSrcHeight, const int32_t kiFirstRow, const int32_t kiEndRow);
+
+/*!
+ * \brief   source rows [0, return value) are read to produce destination row kiDstRow
+ */
+int32_t WelsGeneralBilinearSrcRowsNeeded (const int32_t kiDstHeight, const int32_t kiSrcHeight, const int32_t kiDstRow);
+
+#endif//WELS_DOWNSAMPLE_COMMON_H__
@@ -62,16 +62,34 @@ void ExpandPictureChromaUnalign_sse2 (uint8_t* pDst,
                                       const int32_t kiStride,
                                       const int32_t kiPicW,
                                       const int32_t kiPicH);
+void ExpandPictureLumaRows_sse2 (uint8_t* pDst,
+                                 const int32_t kiStride,
+                                 const int32_t kiPicW,
+                                 const int32_t kiRows);
+void ExpandPictureChromaRowsAlign_sse2 (uint8_t* pDst,
+                                        const int32_t kiStride,
+                                        const int32_t kiPicW,
+                                        const int32_t kiRows);
+void ExpandPictureChromaRowsUnalign_sse2 (uint8_t* pDst,
+                                          const int32_t kiStride,
+                                          const int32_t kiPicW,
+                                          const int32_t kiRows);
 #endif//X86_ASM
 
 #if defined(HAVE_NEON)
 void ExpandPictureLuma_neon (uint8_t* pDst, const int32_t kiStride, const int32_t kiPicW, const int32_t kiPicH);
 void ExpandPictureChroma_neon (uint8_t* pDst, const int32_t kiStride, const int32_t kiPicW, const int32_t kiPicH);
+void ExpandPictureLumaRows_neon (uint8_t* pDst, const int32_t kiStride, const int32_t kiPicW, const int32_t kiRows);
+void ExpandPictureChromaRows_neon (uint8_t* pDst, const int32_t kiStride, const int32_t kiPicW, const int32_t kiRows);
 #endif
 #if defined(HAVE_NEON_AARCH64)
 void ExpandPictureLuma_AArch64_neon (uint8_t* pDst, const int32_t kiStride, const int32_t kiPicW, const int32_t kiPicH);
 void ExpandPictureChroma_AArch64_neon (uint8_t* pDst, const int32_t kiStride, const int32_t kiPicW,
                                        const int32_t kiPicH);
+void ExpandPictureLumaRows_AArch64_neon (uint8_t* pDst, const int32_t kiStride, const int32_t kiPicW,
+                                         const int32_t kiRows);
+void ExpandPictureChromaRows_AArch64_neon (uint8_t* pDst, const int32_t kiStride, const int32_t kiPicW,
+                                           const int32_t kiRows);
 #endif
 
 #if defined(HAVE_MMI)
@@ -88,6 +106,8 @@ typedef void (*PExpandPictureFunc) (uint8_t* pDst, const int32_t kiStride, const
 typedef struct TagExpandPicFunc {
   PExpandPictureFunc pfExpandLumaPicture;
   PExpandPictureFunc pfExpandChromaPicture[2];
+  PExpandPictureFunc pfExpandLumaRows;          // left and right borders of kiPicH rows only
+  PExpandPictureFunc pfExpandChromaRows[2];
 } SExpandPicFunc;
 
 void PadMBLuma_c (uint8_t*& pDst, const int32_t& kiStride, const int32_t& kiPicW, const int32_t& kiPicH,
@@ -98,6 +118,16 @@ void PadMBChroma_c (uint8_t*& pDst, const int32_t& kiStride, const int32_t& kiPi
 void ExpandReferencingPicture (uint8_t* pData[3], int32_t iWidth, int32_t iHeight, int32_t iStride[3],
                                PExpandPictureFunc pExpLuma, PExpandPictureFunc pExpChrom[2]);
 
+/*!
+ * \brief  expand the borders of the luma rows [iStartRow, iEndRow) and of the matching chroma rows,
+ *         the top/bottom borders are done with the band holding the first/last row.
+ *         Padding a partition of [0, iHeight) gives the same picture as ExpandReferencingPicture(),
+ *         iStartRow has to be even.
+ */
+void ExpandReferencingPictureRows (uint8_t* pData[3], int32_t iWidth, int32_t iHeight, int32_t iStride[3],
+                                   int32_t iStartRow, int32_t iEndRow, PExpandPictureFunc pExpLumaRows,
+                                   PExpandPictureFunc pExpChromRows[2]);
+
 void InitExpandPictureFunc (SExpandPicFunc* pExpandPicFunc, const uint32_t kuiCPUFlags);
 
 #if defined(__cplusplus)
@@ -57,6 +57,13 @@ namespace WelsCommon {
 
 void InitMcFunc (SMcFunc* pMcFunc, uint32_t iCpu);
 
+/*!
+ * \brief   copy the iWidth x iHeight block at (iX, iY) of a plane into pDst, taking the pixels outside the
+ *          iPicWidth x iPicHeight picture from its nearest edge, i.e. what border expansion would have put there
+ */
+void McEmulateEdge_c (uint8_t* pDst, int32_t iDstStride, const uint8_t* pPlane, int32_t iPlaneStride,
+                      int32_t iX, int32_t iY, int32_t iWidth, int32_t iHeight, int32_t iPicWidth, int32_t iPicHeight);
+
 } // namespace WelsCommon
 
 
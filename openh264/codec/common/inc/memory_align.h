@@ -34,6 +34,7 @@
 #define WELS_COMMON_MEMORY_ALIGN_H__
 
 #include "typedefs.h"
+#include "codec_app_def.h"
 
 // NOTE: please do not clean below lines even comment, turn on for potential memory leak verify and memory usage monitor etc.
 //#define MEMORY_CHECK
@@ -60,7 +61,12 @@ void* WelsMallocz (const uint32_t kuiSize, const char* kpTag);
 void* WelsMalloc (const uint32_t kuiSize, const char* kpTag);
 void WelsFree (void* pPointer, const char* kpTag);
 const uint32_t WelsGetCacheLineSize() const;
-const uint32_t WelsGetMemoryUsage() const;
+const int64_t WelsGetMemoryUsage() const;
+/*!
+ * \brief   add the current and peak bytes of this allocator by EMemoryCategory to pUsage, the category of a
+ *          block is taken from its tag when allocated; safe to call while other threads allocate
+ */
+void WelsAddMemoryUsage (SMemoryUsage* pUsage) const;
 
  private:
 // private copy & assign constructors adding to fix klocwork scan issues
@@ -70,9 +76,11 @@ CMemoryAlign& operator= (const CMemoryAlign& kcMa);
  protected:
 uint32_t        m_nCacheLineSize;
 
-#ifdef MEMORY_MONITOR
-uint32_t        m_nMemoryUsageInBytes;
-#endif//MEMORY_MONITOR
+// updated with atomic adds, the usage report is always on
+volatile int64_t m_nMemoryUsageInBytes;
+volatile int64_t m_iPeakBytes;
+volatile int64_t m_iCategoryBytes[MEMORY_CATEGORY_NUM];
+volatile int64_t m_iCategoryPeakBytes[MEMORY_CATEGORY_NUM];
 };
 
 /*!
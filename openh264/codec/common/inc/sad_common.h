@@ -55,6 +55,17 @@ void WelsSampleSadFour4x4_c (uint8_t* iSample1, int32_t iStride1, uint8_t* iSamp
 void WelsSampleSadFour8x4_c (uint8_t* iSample1, int32_t iStride1, uint8_t* iSample2, int32_t iStride2, int32_t* pSad);
 void WelsSampleSadFour4x8_c (uint8_t* iSample1, int32_t iStride1, uint8_t* iSample2, int32_t iStride2, int32_t* pSad);
 
+/*!
+ * \brief  SAD of one block against iCount candidate positions pSample2 + kpOffset[i], results in pSad[i]
+ */
+void WelsSampleSadMulti16x16_c (uint8_t*, int32_t, uint8_t*, int32_t, const int32_t*, int32_t, int32_t*);
+void WelsSampleSadMulti16x8_c (uint8_t*, int32_t, uint8_t*, int32_t, const int32_t*, int32_t, int32_t*);
+void WelsSampleSadMulti8x16_c (uint8_t*, int32_t, uint8_t*, int32_t, const int32_t*, int32_t, int32_t*);
+void WelsSampleSadMulti8x8_c (uint8_t*, int32_t, uint8_t*, int32_t, const int32_t*, int32_t, int32_t*);
+void WelsSampleSadMulti4x4_c (uint8_t*, int32_t, uint8_t*, int32_t, const int32_t*, int32_t, int32_t*);
+void WelsSampleSadMulti8x4_c (uint8_t*, int32_t, uint8_t*, int32_t, const int32_t*, int32_t, int32_t*);
+void WelsSampleSadMulti4x8_c (uint8_t*, int32_t, uint8_t*, int32_t, const int32_t*, int32_t, int32_t*);
+
 #if defined(__cplusplus)
 extern "C" {
 #endif//__cplusplus
@@ -73,6 +84,16 @@ void WelsSampleSadFour8x16_sse2 (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*)
 void WelsSampleSadFour8x8_sse2 (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*);
 void WelsSampleSadFour4x4_sse2 (uint8_t*, int32_t, uint8_t*, int32_t, int32_t*);
 
+#if defined(HAVE_AVX2) && !defined(X86_32_ASM)
+void WelsSampleSadMulti16x16_avx2 (uint8_t*, int32_t, uint8_t*, int32_t, const int32_t*, int32_t, int32_t*);
+void WelsSampleSadMulti16x8_avx2 (uint8_t*, int32_t, uint8_t*, int32_t, const int32_t*, int32_t, int32_t*);
+void WelsSampleSadMulti8x16_avx2 (uint8_t*, int32_t, uint8_t*, int32_t, const int32_t*, int32_t, int32_t*);
+void WelsSampleSadMulti8x8_avx2 (uint8_t*, int32_t, uint8_t*, int32_t, const int32_t*, int32_t, int32_t*);
+
+void WelsSampleSadMulti16x16_avx512 (uint8_t*, int32_t, uint8_t*, int32_t, const int32_t*, int32_t, int32_t*);
+void WelsSampleSadMulti16x8_avx512 (uint8_t*, int32_t, uint8_t*, int32_t, const int32_t*, int32_t, int32_t*);
+#endif//HAVE_AVX2 && !X86_32_ASM
+
 #endif//X86_ASM
 
 #if defined (HAVE_NEON)
@@ -0,0 +1,155 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ *
+ * \file    WelsBufferArena.cpp
+ *
+ * \brief   process wide cache of large codec buffers in size classes, reused across encoder and decoder instances
+ *
+ * \date    10/17/2026 Created
+ *
+ *************************************************************************************
+ */
+
+#include <stdlib.h>
+#include "WelsBufferArena.h"
+#include "codec_api.h"
+
+// a block also holds the alignment slack and the header of the aligned allocation: pointer, size and category
+#define ARENA_BLOCK_SIZE(uiClassSize) ((uiClassSize) + WELS_BUFFER_ARENA_MAX_ALIGN - 1 + sizeof (void**) + 2 * sizeof (int32_t))
+
+namespace WelsCommon {
+
+CWelsBufferArena& CWelsBufferArena::GetInstance() {
+  // never destroyed, codec instances may still release blocks from static destructors
+  static CWelsBufferArena* pArena = new CWelsBufferArena;
+  return *pArena;
+}
+
+CWelsBufferArena::CWelsBufferArena()
+  : m_uiCachedBytes (0),
+    m_uiLimit (WELS_BUFFER_ARENA_DEFAULT_LIMIT) {
+  for (int32_t i = 0; i < WELS_BUFFER_ARENA_CLASS_NUM; i++) {
+    m_pFreeBlocks[i] = NULL;
+  }
+}
+
+CWelsBufferArena::~CWelsBufferArena() {
+  SetLimit (0);
+}
+
+int32_t CWelsBufferArena::GetClass (const uint32_t kuiSize, uint32_t* pClassSize) {
+  int32_t iLog2 = 0;
+  while ((kuiSize >> (iLog2 + 1)) != 0)
+    iLog2++;
+  const uint32_t kuiStep = 1u << (iLog2 - 2);
+  const uint32_t kuiClassSize = (kuiSize + kuiStep - 1) & ~ (kuiStep - 1);
+  *pClassSize = kuiClassSize;
+  // a size rounded up to the next power of two is the first class of it
+  return (iLog2 - 16) * 4 + (int32_t) (kuiClassSize / kuiStep) - 4;
+}
+
+uint32_t CWelsBufferArena::GetBlockSize (const uint32_t kuiSize) {
+  uint32_t uiClassSize = 0;
+  GetClass (kuiSize, &uiClassSize);
+  return ARENA_BLOCK_SIZE (uiClassSize);
+}
+
+void* CWelsBufferArena::Acquire (const uint32_t kuiSize) {
+  uint32_t uiClassSize = 0;
+  const int32_t kiClass = GetClass (kuiSize, &uiClassSize);
+  const uint32_t kuiBlockSize = ARENA_BLOCK_SIZE (uiClassSize);
+
+  m_cLock.Lock();
+  void* pBlock = m_pFreeBlocks[kiClass];
+  if (NULL != pBlock) {
+    m_pFreeBlocks[kiClass] = * (void**)pBlock;
+    m_uiCachedBytes -= kuiBlockSize;
+  }
+  m_cLock.Unlock();
+
+  if (NULL == pBlock)
+    pBlock = malloc (kuiBlockSize);
+  return pBlock;
+}
+
+void CWelsBufferArena::Release (void* pBlock, const uint32_t kuiSize) {
+  uint32_t uiClassSize = 0;
+  const int32_t kiClass = GetClass (kuiSize, &uiClassSize);
+  const uint32_t kuiBlockSize = ARENA_BLOCK_SIZE (uiClassSize);
+
+  m_cLock.Lock();
+  const bool kbKeep = (m_uiLimit >= kuiBlockSize && m_uiCachedBytes <= m_uiLimit - kuiBlockSize);
+  if (kbKeep) {
+    * (void**)pBlock = m_pFreeBlocks[kiClass];
+    m_pFreeBlocks[kiClass] = pBlock;
+    m_uiCachedBytes += kuiBlockSize;
+  }
+  m_cLock.Unlock();
+
+  if (!kbKeep)
+    free (pBlock);
+}
+
+// frees the largest blocks first, they are the least likely to be asked for again
+void CWelsBufferArena::TrimLocked() {
+  for (int32_t i = WELS_BUFFER_ARENA_CLASS_NUM - 1; i >= 0 && m_uiCachedBytes > m_uiLimit; i--) {
+    while (NULL != m_pFreeBlocks[i] && m_uiCachedBytes > m_uiLimit) {
+      void* pBlock = m_pFreeBlocks[i];
+      m_pFreeBlocks[i] = * (void**)pBlock;
+      free (pBlock);
+      m_uiCachedBytes -= ARENA_BLOCK_SIZE ((4u + (i & 3)) << (i / 4 + 14));
+    }
+  }
+}
+
+void CWelsBufferArena::SetLimit (const uint32_t kuiLimit) {
+  m_cLock.Lock();
+  m_uiLimit = kuiLimit;
+  TrimLocked();
+  m_cLock.Unlock();
+}
+
+uint32_t CWelsBufferArena::GetCachedBytes() {
+  m_cLock.Lock();
+  const uint32_t kuiCachedBytes = m_uiCachedBytes;
+  m_cLock.Unlock();
+  return kuiCachedBytes;
+}
+
+}
+
+/*
+*   WelsSetBufferPoolLimit
+*/
+void WelsSetBufferPoolLimit (unsigned int uiLimit) {
+  WelsCommon::CWelsBufferArena::GetInstance().SetLimit (uiLimit);
+}
@@ -95,6 +95,26 @@ WELS_THREAD_ERROR_CODE    WelsMutexDestroy (WELS_MUTEX* mutex) {
   return WELS_THREAD_ERROR_OK;
 }
 
+WELS_THREAD_ERROR_CODE    WelsConditionInit (WELS_CONDITION* pCond) {
+  InitializeConditionVariable (pCond);
+
+  return WELS_THREAD_ERROR_OK;
+}
+
+WELS_THREAD_ERROR_CODE    WelsConditionDestroy (WELS_CONDITION* pCond) {
+  return WELS_THREAD_ERROR_OK;
+}
+
+WELS_THREAD_ERROR_CODE    WelsConditionWait (WELS_CONDITION* pCond, WELS_MUTEX* pMutex) {
+  return SleepConditionVariableCS (pCond, pMutex, INFINITE) ? WELS_THREAD_ERROR_OK : WELS_THREAD_ERROR_GENERAL;
+}
+
+WELS_THREAD_ERROR_CODE    WelsConditionBroadcast (WELS_CONDITION* pCond) {
+  WakeAllConditionVariable (pCond);
+
+  return WELS_THREAD_ERROR_OK;
+}
+
 #else /* _WIN32 */
 
 WELS_THREAD_ERROR_CODE    WelsMutexInit (WELS_MUTEX*    mutex) {
@@ -113,6 +133,22 @@ WELS_THREAD_ERROR_CODE    WelsMutexDestroy (WELS_MUTEX* mutex) {
   return pthread_mutex_destroy (mutex);
 }
 
+WELS_THREAD_ERROR_CODE    WelsConditionInit (WELS_CONDITION* pCond) {
+  return pthread_cond_init (pCond, NULL);
+}
+
+WELS_THREAD_ERROR_CODE    WelsConditionDestroy (WELS_CONDITION* pCond) {
+  return pthread_cond_destroy (pCond);
+}
+
+WELS_THREAD_ERROR_CODE    WelsConditionWait (WELS_CONDITION* pCond, WELS_MUTEX* pMutex) {
+  return pthread_cond_wait (pCond, pMutex);
+}
+
+WELS_THREAD_ERROR_CODE    WelsConditionBroadcast (WELS_CONDITION* pCond) {
+  return pthread_cond_broadcast (pCond);
+}
+
 #endif /* !_WIN32 */
 
 #if defined(_WIN32) || defined(__CYGWIN__)
@@ -212,6 +248,42 @@ WELS_THREAD_HANDLE        WelsThreadSelf() {
   return GetCurrentThread();
 }
 
+WELS_THREAD_ERROR_CODE    WelsThreadSetAffinity (int32_t iCpu) {
+#ifdef WP80
+  return WELS_THREAD_ERROR_GENERAL;
+#elif defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0601
+  // beyond 64 processors windows splits them into groups, not necessarily of equal size
+  GROUP_AFFINITY sAffinity = {0};
+  const WORD kwGroupNum = GetActiveProcessorGroupCount();
+  WORD wGroup = 0;
+  DWORD dwIndex = (DWORD)iCpu;
+  if (iCpu < 0) {
+    return WELS_THREAD_ERROR_GENERAL;
+  }
+  while (wGroup < kwGroupNum && dwIndex >= GetActiveProcessorCount (wGroup)) {
+    dwIndex -= GetActiveProcessorCount (wGroup);
+    wGroup++;
+  }
+  if (wGroup == kwGroupNum) {
+    return WELS_THREAD_ERROR_GENERAL;
+  }
+  sAffinity.Group = wGroup;
+  sAffinity.Mask = (KAFFINITY)1 << dwIndex;
+  if (0 == SetThreadGroupAffinity (GetCurrentThread(), &sAffinity, NULL)) {
+    return WELS_THREAD_ERROR_GENERAL;
+  }
+  return WELS_THREAD_ERROR_OK;
+#else
+  if (iCpu < 0 || iCpu >= (int32_t) (sizeof (DWORD_PTR) * 8)) {
+    return WELS_THREAD_ERROR_GENERAL;
+  }
+  if (0 == SetThreadAffinityMask (GetCurrentThread(), (DWORD_PTR)1 << iCpu)) {
+    return WELS_THREAD_ERROR_GENERAL;
+  }
+  return WELS_THREAD_ERROR_OK;
+#endif
+}
+
 WELS_THREAD_ERROR_CODE    WelsQueryLogicalProcessInfo (WelsLogicalProcessInfo* pInfo) {
   SYSTEM_INFO  si;
 
@@ -266,6 +338,44 @@ WELS_THREAD_HANDLE        WelsThreadSelf() {
   return pthread_self();
 }
 
+WELS_THREAD_ERROR_CODE    WelsThreadSetAffinity (int32_t iCpu) {
+#if defined(__linux__) || defined(__GNU__)
+  WELS_THREAD_ERROR_CODE err = WELS_THREAD_ERROR_OK;
+  if (iCpu < 0) {
+    return WELS_THREAD_ERROR_GENERAL;
+  }
+#ifdef CPU_ALLOC
+  // sized for iCpu, the static cpu_set_t stops at CPU_SETSIZE
+  cpu_set_t* pCpuSet = CPU_ALLOC (iCpu + 1);
+  const size_t kuiSetSize = CPU_ALLOC_SIZE (iCpu + 1);
+  if (NULL == pCpuSet) {
+    return WELS_THREAD_ERROR_GENERAL;
+  }
+  CPU_ZERO_S (kuiSetSize, pCpuSet);
+  CPU_SET_S (iCpu, kuiSetSize, pCpuSet);
+  // pid 0 is the calling thread
+  if (sched_setaffinity (0, kuiSetSize, pCpuSet)) {
+    err = WELS_THREAD_ERROR_GENERAL;
+  }
+  CPU_FREE (pCpuSet);
+#else
+  cpu_set_t cpuset;
+  if (iCpu >= CPU_SETSIZE) {
+    return WELS_THREAD_ERROR_GENERAL;
+  }
+  CPU_ZERO (&cpuset);
+  CPU_SET (iCpu, &cpuset);
+  if (sched_setaffinity (0, sizeof (cpuset), &cpuset)) {
+    err = WELS_THREAD_ERROR_GENERAL;
+  }
+#endif
+  return err;
+#else
+  // no hard affinity on Mac OS X and the BSDs
+  return WELS_THREAD_ERROR_GENERAL;
+#endif
+}
+
 // unnamed semaphores aren't supported on OS X
 
 WELS_THREAD_ERROR_CODE    WelsEventOpen (WELS_EVENT* p_event, const char* event_name) {
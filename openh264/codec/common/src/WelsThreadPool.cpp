@@ -37,6 +37,9 @@
  *
  *************************************************************************************
  */
+
+
+#include <string.h>
 #include "typedefs.h"
 #include "memory_align.h"
 #include "WelsThreadPool.h"
@@ -52,17 +55,110 @@ CWelsLock& GetInitLock() {
 
 }
 
-int32_t CWelsThreadPool::m_iRefCount = 0;
+CWelsTaskQueue::CWelsTaskQueue() :
+  m_pCells (NULL), m_iMask (0), m_iEnqueuePos (0), m_iDequeuePos (0) {
+}
+
+CWelsTaskQueue::~CWelsTaskQueue() {
+  WELS_SAFE_FREE (m_pCells, "CWelsTaskQueue::m_pCells");
+}
+
+bool CWelsTaskQueue::Init (const int32_t kiCapacity) {
+  // the capacity has to be a power of two, positions wrap through m_iMask
+  m_pCells = static_cast<STaskCell*> (WelsMallocz (kiCapacity * sizeof (STaskCell), "CWelsTaskQueue::m_pCells"));
+  if (NULL == m_pCells) {
+    return false;
+  }
+  for (int32_t i = 0; i < kiCapacity; i++) {
+    m_pCells[i].iSequence = i;
+  }
+  m_iMask = kiCapacity - 1;
+  return true;
+}
+
+bool CWelsTaskQueue::Push (IWelsTask* pTask) {
+  int32_t iPos = WelsAtomicLoad (&m_iEnqueuePos);
+  while (true) {
+    STaskCell* pCell = &m_pCells[iPos & m_iMask];
+    const int32_t kiDiff = WelsAtomicLoad (&pCell->iSequence) - iPos;
+    if (0 == kiDiff) {
+      if (WelsAtomicCas (&m_iEnqueuePos, iPos, iPos + 1)) {
+        pCell->pTask = pTask;
+        WelsAtomicStore (&pCell->iSequence, iPos + 1);
+        return true;
+      }
+      iPos = WelsAtomicLoad (&m_iEnqueuePos);
+    } else if (kiDiff < 0) {
+      return false; // full
+    } else {
+      iPos = WelsAtomicLoad (&m_iEnqueuePos);
+    }
+  }
+}
+
+IWelsTask* CWelsTaskQueue::Pop() {
+  int32_t iPos = WelsAtomicLoad (&m_iDequeuePos);
+  while (true) {
+    STaskCell* pCell = &m_pCells[iPos & m_iMask];
+    const int32_t kiDiff = WelsAtomicLoad (&pCell->iSequence) - (iPos + 1);
+    if (0 == kiDiff) {
+      if (WelsAtomicCas (&m_iDequeuePos, iPos, iPos + 1)) {
+        IWelsTask* pTask = pCell->pTask;
+        WelsAtomicStore (&pCell->iSequence, iPos + m_iMask + 1);
+        return pTask;
+      }
+      iPos = WelsAtomicLoad (&m_iDequeuePos);
+    } else if (kiDiff < 0) {
+      return NULL; // empty
+    } else {
+      iPos = WelsAtomicLoad (&m_iDequeuePos);
+    }
+  }
+}
+
+bool CWelsTaskQueue::IsEmpty() {
+  return WelsAtomicLoad (&m_iEnqueuePos) == WelsAtomicLoad (&m_iDequeuePos);
+}
+
+CWelsPoolWorker::CWelsPoolWorker (CWelsThreadPool* pPool, const int32_t kiIndex, const int32_t kiAffinityCpu) :
+  m_pPool (pPool), m_iIndex (kiIndex), m_iAffinityCpu (kiAffinityCpu) {
+  WelsThreadSetName ("CWelsPoolWorker");
+}
+
+CWelsPoolWorker::~CWelsPoolWorker() {
+}
+
+void CWelsPoolWorker::Thread() {
+  // pinning is best effort, a processor the platform rejects leaves the worker floating
+  if (m_iAffinityCpu >= 0) {
+    WelsThreadSetAffinity (m_iAffinityCpu);
+  }
+  CWelsThread::Thread();
+}
+
+void CWelsPoolWorker::ExecuteTask() {
+  m_pPool->ExecuteWorkerTasks (this);
+}
+
 int32_t CWelsThreadPool::m_iMaxThreadNum = DEFAULT_THREAD_NUM;
 CWelsThreadPool* CWelsThreadPool::m_pThreadPoolSelf = NULL;
-
-CWelsThreadPool::CWelsThreadPool() :
-  m_cWaitedTasks (NULL), m_cIdleThreads (NULL), m_cBusyThreads (NULL) {
+CWelsThreadPool* CWelsThreadPool::m_pNamedPools = NULL;
+
+CWelsThreadPool::CWelsThreadPool (int32_t iThreadNum, const int32_t* pAffinityCpus, int32_t iCpuNum) :
+  m_iRefCount (0), m_iThreadNum (WELS_MAX (iThreadNum, 1)), m_iAffinityCpuNum (0), m_pNextNamedPool (NULL),
+  m_iWorkerNum (0), m_pWorkers (NULL), m_pTaskQueues (NULL), m_pIdleFlags (NULL), m_iNextQueueIdx (0),
+  m_cOverflowTasks (NULL), m_iOverflowTaskNum (0) {
+  m_szName[0] = '\0';
+  if (NULL != pAffinityCpus) {
+    m_iAffinityCpuNum = WELS_CLIP3 (iCpuNum, 0, MAX_AFFINITY_CPU_NUM);
+    for (int32_t i = 0; i < m_iAffinityCpuNum; i++) {
+      m_iAffinityCpus[i] = pAffinityCpus[i];
+    }
+  }
 }
 
 
 CWelsThreadPool::~CWelsThreadPool() {
-  //fprintf(stdout, "CWelsThreadPool::~CWelsThreadPool: delete %x, %x, %x\n", m_cWaitedTasks, m_cIdleThreads, m_cBusyThreads);
   if (0 != m_iRefCount) {
     m_iRefCount = 0;
     Uninit();
@@ -72,7 +168,7 @@ CWelsThreadPool::~CWelsThreadPool() {
 WELS_THREAD_ERROR_CODE CWelsThreadPool::SetThreadNum (int32_t iMaxThreadNum) {
   CWelsAutoLock  cLock (GetInitLock());
 
-  if (m_iRefCount != 0) {
+  if (NULL != m_pThreadPoolSelf) {
     return WELS_THREAD_ERROR_GENERAL;
   }
 
@@ -84,297 +180,255 @@ WELS_THREAD_ERROR_CODE CWelsThreadPool::SetThreadNum (int32_t iMaxThreadNum) {
 }
 
 
+CWelsThreadPool* CWelsThreadPool::NewPool (int32_t iThreadNum, const int32_t* pAffinityCpus, int32_t iCpuNum) {
+  CWelsThreadPool* pPool = new CWelsThreadPool (iThreadNum, pAffinityCpus, iCpuNum);
+  if (NULL == pPool) {
+    return NULL;
+  }
+  if (WELS_THREAD_ERROR_OK != pPool->Init()) {
+    pPool->Uninit();
+    delete pPool;
+    return NULL;
+  }
+  return pPool;
+}
+
 CWelsThreadPool* CWelsThreadPool::AddReference() {
   CWelsAutoLock  cLock (GetInitLock());
   if (m_pThreadPoolSelf == NULL) {
-    m_pThreadPoolSelf = new CWelsThreadPool();
+    m_pThreadPoolSelf = NewPool (m_iMaxThreadNum, NULL, 0);
     if (!m_pThreadPoolSelf) {
       return NULL;
     }
   }
 
-  if (m_iRefCount == 0) {
-    if (WELS_THREAD_ERROR_OK != m_pThreadPoolSelf->Init()) {
-      m_pThreadPoolSelf->Uninit();
-      delete m_pThreadPoolSelf;
-      m_pThreadPoolSelf = NULL;
-      return NULL;
-    }
-  }
-
-  ////fprintf(stdout, "m_iRefCount=%d, iMaxThreadNum=%d\n", m_iRefCount, m_iMaxThreadNum);
-
-  ++ m_iRefCount;
-  //fprintf(stdout, "m_iRefCount2=%d\n", m_iRefCount);
+  ++ m_pThreadPoolSelf->m_iRefCount;
   return m_pThreadPoolSelf;
 }
 
-void CWelsThreadPool::RemoveInstance() {
+CWelsThreadPool* CWelsThreadPool::CreateInstance (int32_t iThreadNum, const int32_t* pAffinityCpus,
+    int32_t iCpuNum) {
   CWelsAutoLock  cLock (GetInitLock());
-  //fprintf(stdout, "m_iRefCount=%d\n", m_iRefCount);
-  -- m_iRefCount;
-  if (0 == m_iRefCount) {
-    StopAllRunning();
-    Uninit();
-    if (m_pThreadPoolSelf) {
-      delete m_pThreadPoolSelf;
-      m_pThreadPoolSelf = NULL;
-    }
-    //fprintf(stdout, "m_iRefCount=%d, IdleThreadNum=%d, BusyThreadNum=%d, WaitedTask=%d\n", m_iRefCount, GetIdleThreadNum(), GetBusyThreadNum(), GetWaitedTaskNum());
+  CWelsThreadPool* pPool = NewPool (iThreadNum, pAffinityCpus, iCpuNum);
+  if (NULL != pPool) {
+    pPool->m_iRefCount = 1;
   }
+  return pPool;
 }
 
+CWelsThreadPool* CWelsThreadPool::AddNamedReference (const char* kpName, int32_t iThreadNum,
+    const int32_t* pAffinityCpus, int32_t iCpuNum) {
+  if (NULL == kpName || '\0' == kpName[0]) {
+    return CreateInstance (iThreadNum, pAffinityCpus, iCpuNum);
+  }
 
-bool CWelsThreadPool::IsReferenced() {
   CWelsAutoLock  cLock (GetInitLock());
-  return (m_iRefCount > 0);
-}
-
+  CWelsThreadPool* pPool = m_pNamedPools;
+  while (NULL != pPool && 0 != strncmp (pPool->m_szName, kpName, MAX_POOL_NAME_LEN - 1)) {
+    pPool = pPool->m_pNextNamedPool;
+  }
+  if (NULL == pPool) {
+    pPool = NewPool (iThreadNum, pAffinityCpus, iCpuNum);
+    if (NULL == pPool) {
+      return NULL;
+    }
+    strncpy (pPool->m_szName, kpName, MAX_POOL_NAME_LEN - 1); // confirmed_safe_unsafe_usage
+    pPool->m_szName[MAX_POOL_NAME_LEN - 1] = '\0';
+    pPool->m_pNextNamedPool = m_pNamedPools;
+    m_pNamedPools = pPool;
+  }
 
-WELS_THREAD_ERROR_CODE CWelsThreadPool::OnTaskStart (CWelsTaskThread* pThread, IWelsTask* pTask) {
-  AddThreadToBusyList (pThread);
-  //fprintf(stdout, "CWelsThreadPool::AddThreadToBusyList: Task %x at Thread %x\n", pTask, pThread);
-  return WELS_THREAD_ERROR_OK;
+  ++ pPool->m_iRefCount;
+  return pPool;
 }
 
-WELS_THREAD_ERROR_CODE CWelsThreadPool::OnTaskStop (CWelsTaskThread* pThread, IWelsTask* pTask) {
-  //fprintf(stdout, "CWelsThreadPool::OnTaskStop 0: Task %x at Thread %x Finished\n", pTask, pThread);
-
-  RemoveThreadFromBusyList (pThread);
-  AddThreadToIdleQueue (pThread);
+void CWelsThreadPool::RemoveInstance() {
+  CWelsAutoLock  cLock (GetInitLock());
+  -- m_iRefCount;
+  if (0 != m_iRefCount) {
+    return;
+  }
 
-  if (pTask && pTask->GetSink()) {
-    //fprintf(stdout, "CWelsThreadPool::OnTaskStop 1: Task %x at Thread %x Finished, m_pSink=%x\n", pTask, pThread, pTask->GetSink());
-    pTask->GetSink()->OnTaskExecuted();
-    ////fprintf(stdout, "CWelsThreadPool::OnTaskStop 1: Task %x at Thread %x Finished, m_pSink=%x\n", pTask, pThread, pTask->GetSink());
+  if (this == m_pThreadPoolSelf) {
+    m_pThreadPoolSelf = NULL;
+  } else if ('\0' != m_szName[0]) {
+    CWelsThreadPool** ppPool = &m_pNamedPools;
+    while (NULL != *ppPool && this != *ppPool) {
+      ppPool = & (*ppPool)->m_pNextNamedPool;
+    }
+    if (NULL != *ppPool) {
+      *ppPool = m_pNextNamedPool;
+    }
   }
-  //if (m_pSink) {
-  //  m_pSink->OnTaskExecuted (pTask);
-  //}
-  //fprintf(stdout, "CWelsThreadPool::OnTaskStop 2: Task %x at Thread %x Finished\n", pTask, pThread);
+  StopAllRunning();
+  Uninit();
+  delete this;
+}
 
-  SignalThread();
 
-  //fprintf(stdout, "ThreadPool: Task %x at Thread %x Finished\n", pTask, pThread);
-  return WELS_THREAD_ERROR_OK;
+bool CWelsThreadPool::IsReferenced() {
+  CWelsAutoLock  cLock (GetInitLock());
+  return (NULL != m_pThreadPoolSelf);
 }
 
 WELS_THREAD_ERROR_CODE CWelsThreadPool::Init() {
-  //fprintf(stdout, "Enter WelsThreadPool Init\n");
-
   CWelsAutoLock  cLock (m_cLockPool);
 
-  m_cWaitedTasks = new CWelsNonDuplicatedList<IWelsTask>();
-  m_cIdleThreads = new CWelsNonDuplicatedList<CWelsTaskThread>();
-  m_cBusyThreads = new CWelsList<CWelsTaskThread>();
-  if (NULL == m_cWaitedTasks || NULL == m_cIdleThreads || NULL == m_cBusyThreads) {
+  m_cOverflowTasks = new CWelsList<IWelsTask>();
+  m_pWorkers = static_cast<CWelsPoolWorker**> (WelsMallocz (m_iThreadNum * sizeof (CWelsPoolWorker*),
+               "CWelsThreadPool::m_pWorkers"));
+  m_pIdleFlags = static_cast<volatile int32_t*> (WelsMallocz (m_iThreadNum * sizeof (int32_t),
+                 "CWelsThreadPool::m_pIdleFlags"));
+  m_pTaskQueues = new CWelsTaskQueue[m_iThreadNum];
+  if (NULL == m_cOverflowTasks || NULL == m_pWorkers || NULL == m_pIdleFlags || NULL == m_pTaskQueues) {
     return WELS_THREAD_ERROR_GENERAL;
   }
 
-  for (int32_t i = 0; i < m_iMaxThreadNum; i++) {
-    if (WELS_THREAD_ERROR_OK != CreateIdleThread()) {
+  for (int32_t i = 0; i < m_iThreadNum; i++) {
+    if (!m_pTaskQueues[i].Init (TASK_QUEUE_CAPACITY)) {
       return WELS_THREAD_ERROR_GENERAL;
     }
   }
-
-  if (WELS_THREAD_ERROR_OK != Start()) {
-    return WELS_THREAD_ERROR_GENERAL;
+  for (int32_t i = 0; i < m_iThreadNum; i++) {
+    // a new worker waits on its event, so it starts out idle
+    m_pIdleFlags[i] = 1;
+    const int32_t kiAffinityCpu = m_iAffinityCpuNum > 0 ? m_iAffinityCpus[i % m_iAffinityCpuNum] : -1;
+    m_pWorkers[i] = new CWelsPoolWorker (this, i, kiAffinityCpu);
+    if (NULL == m_pWorkers[i]) {
+      return WELS_THREAD_ERROR_GENERAL;
+    }
+    m_iWorkerNum = i + 1;
+    if (WELS_THREAD_ERROR_OK != m_pWorkers[i]->Start()) {
+      return WELS_THREAD_ERROR_GENERAL;
+    }
   }
 
   return WELS_THREAD_ERROR_OK;
 }
 
 WELS_THREAD_ERROR_CODE CWelsThreadPool::StopAllRunning() {
-  WELS_THREAD_ERROR_CODE iReturn = WELS_THREAD_ERROR_OK;
-
-  ClearWaitedTasks();
-
-  while (GetBusyThreadNum() > 0) {
-    //WELS_INFO_TRACE ("CWelsThreadPool::Uninit - Waiting all thread to exit");
-    WelsSleep (10);
-  }
-
-  if (GetIdleThreadNum() != m_iMaxThreadNum) {
-    iReturn = WELS_THREAD_ERROR_GENERAL;
+  // a worker finishes the task in hand before it sees its end flag
+  for (int32_t i = 0; i < m_iWorkerNum; i++) {
+    m_pWorkers[i]->Kill();
   }
 
-  return iReturn;
+  ClearWaitedTasks();
+  return WELS_THREAD_ERROR_OK;
 }
 
 WELS_THREAD_ERROR_CODE CWelsThreadPool::Uninit() {
   WELS_THREAD_ERROR_CODE iReturn = WELS_THREAD_ERROR_OK;
   CWelsAutoLock  cLock (m_cLockPool);
 
-  iReturn = StopAllRunning();
-  if (WELS_THREAD_ERROR_OK != iReturn) {
-    return iReturn;
+  if (NULL != m_pWorkers) {
+    iReturn = StopAllRunning();
+    for (int32_t i = 0; i < m_iWorkerNum; i++) {
+      WELS_DELETE_OP (m_pWorkers[i]);
+    }
   }
+  m_iWorkerNum = 0;
 
-  m_cLockIdleTasks.Lock();
-  while (m_cIdleThreads->size() > 0) {
-    DestroyThread (m_cIdleThreads->begin());
-    m_cIdleThreads->pop_front();
+  if (NULL != m_pTaskQueues) {
+    delete [] m_pTaskQueues;
+    m_pTaskQueues = NULL;
   }
-  m_cLockIdleTasks.Unlock();
-
-  Kill();
-
-  WELS_DELETE_OP (m_cWaitedTasks);
-  WELS_DELETE_OP (m_cIdleThreads);
-  WELS_DELETE_OP (m_cBusyThreads);
+  WELS_SAFE_FREE (m_pWorkers, "CWelsThreadPool::m_pWorkers");
+  if (NULL != m_pIdleFlags) {
+    WelsFree ((void*)m_pIdleFlags, "CWelsThreadPool::m_pIdleFlags");
+    m_pIdleFlags = NULL;
+  }
+  WELS_DELETE_OP (m_cOverflowTasks);
 
   return iReturn;
 }
 
-void CWelsThreadPool::ExecuteTask() {
-  //fprintf(stdout, "ThreadPool: scheduled tasks: ExecuteTask\n");
-  CWelsTaskThread* pThread = NULL;
-  IWelsTask*    pTask = NULL;
-  while (GetWaitedTaskNum() > 0) {
-    //fprintf(stdout, "ThreadPool:  ExecuteTask: waiting task %d\n", GetWaitedTaskNum());
-    pThread = GetIdleThread();
-    if (pThread == NULL) {
-      //fprintf(stdout, "ThreadPool:  ExecuteTask: no IdleThread\n");
-
-      break;
+void CWelsThreadPool::ExecuteWorkerTasks (CWelsPoolWorker* pWorker) {
+  const int32_t kiIdx = pWorker->GetIndex();
+  while (!pWorker->IsStopping()) {
+    IWelsTask* pTask = GetTask (kiIdx);
+    if (NULL == pTask) {
+      // announce the idleness before the last look, so that a concurrent QueueTask() either finds the flag
+      // set and wakes us, or has its task seen here
+      WelsAtomicStore (&m_pIdleFlags[kiIdx], 1);
+      if (!HasWaitedTask() || !WelsAtomicCas (&m_pIdleFlags[kiIdx], 1, 0)) {
+        return;
+      }
+      continue;
     }
-    pTask = GetWaitedTask();
-    //fprintf(stdout, "ThreadPool:  ExecuteTask = %x at thread %x\n", pTask, pThread);
-    if (pTask) {
-      pThread->SetTask (pTask);
-    } else {
-      AddThreadToIdleQueue (pThread);
+
+    pTask->Execute();
+    if (pTask->GetSink()) {
+      pTask->GetSink()->OnTaskExecuted();
     }
   }
 }
 
 WELS_THREAD_ERROR_CODE CWelsThreadPool::QueueTask (IWelsTask* pTask) {
-  CWelsAutoLock  cLock (m_cLockPool);
-
-  //fprintf(stdout, "CWelsThreadPool::QueueTask: %d, pTask=%x\n", m_iRefCount, pTask);
-  if (GetWaitedTaskNum() == 0) {
-    CWelsTaskThread* pThread = GetIdleThread();
-
-    if (pThread != NULL) {
-      //fprintf(stdout, "ThreadPool:  ExecuteTask = %x at thread %x\n", pTask, pThread);
-      pThread->SetTask (pTask);
-
-      return WELS_THREAD_ERROR_OK;
-    }
-  }
-  //fprintf(stdout, "ThreadPool:  AddTaskToWaitedList: %x\n", pTask);
-  if (false == AddTaskToWaitedList (pTask)) {
+  if (NULL == pTask || 0 == m_iWorkerNum) {
     return WELS_THREAD_ERROR_GENERAL;
   }
 
-  //fprintf(stdout, "ThreadPool:  SignalThread: %x\n", pTask);
-  SignalThread();
-  return WELS_THREAD_ERROR_OK;
-}
-
-WELS_THREAD_ERROR_CODE CWelsThreadPool::CreateIdleThread() {
-  CWelsTaskThread* pThread = new CWelsTaskThread (this);
-
-  if (NULL == pThread) {
-    return WELS_THREAD_ERROR_GENERAL;
+  // spread the tasks over the worker queues, a busy worker's share is stolen by the idle ones
+  const int32_t kiStartIdx = (WelsAtomicAdd (&m_iNextQueueIdx, 1) & 0x7fffffff) % m_iWorkerNum;
+  bool bQueued = false;
+  for (int32_t i = 0; i < m_iWorkerNum && !bQueued; i++) {
+    bQueued = m_pTaskQueues[ (kiStartIdx + i) % m_iWorkerNum].Push (pTask);
   }
-
-  if (WELS_THREAD_ERROR_OK != pThread->Start()) {
-    return WELS_THREAD_ERROR_GENERAL;
+  if (!bQueued) {
+    CWelsAutoLock cLock (m_cLockOverflowTasks);
+    if (!m_cOverflowTasks->push_back (pTask)) {
+      return WELS_THREAD_ERROR_GENERAL;
+    }
+    WelsAtomicAdd (&m_iOverflowTaskNum, 1);
   }
-  //fprintf(stdout, "ThreadPool:  AddThreadToIdleQueue: %x\n", pThread);
-  AddThreadToIdleQueue (pThread);
 
+  WakeIdleWorker (kiStartIdx);
   return WELS_THREAD_ERROR_OK;
 }
 
-void  CWelsThreadPool::DestroyThread (CWelsTaskThread* pThread) {
-  pThread->Kill();
-  WELS_DELETE_OP (pThread);
-
-  return;
-}
-
-WELS_THREAD_ERROR_CODE CWelsThreadPool::AddThreadToIdleQueue (CWelsTaskThread* pThread) {
-  CWelsAutoLock cLock (m_cLockIdleTasks);
-  m_cIdleThreads->push_back (pThread);
-  return WELS_THREAD_ERROR_OK;
-}
-
-WELS_THREAD_ERROR_CODE CWelsThreadPool::AddThreadToBusyList (CWelsTaskThread* pThread) {
-  CWelsAutoLock cLock (m_cLockBusyTasks);
-  m_cBusyThreads->push_back (pThread);
-  return WELS_THREAD_ERROR_OK;
-}
-
-WELS_THREAD_ERROR_CODE CWelsThreadPool::RemoveThreadFromBusyList (CWelsTaskThread* pThread) {
-  CWelsAutoLock cLock (m_cLockBusyTasks);
-  if (m_cBusyThreads->erase (pThread)) {
-    return WELS_THREAD_ERROR_OK;
-  } else {
-    return WELS_THREAD_ERROR_GENERAL;
+void CWelsThreadPool::WakeIdleWorker (const int32_t kiPreferredIdx) {
+  for (int32_t i = 0; i < m_iWorkerNum; i++) {
+    const int32_t kiIdx = (kiPreferredIdx + i) % m_iWorkerNum;
+    if (WelsAtomicLoad (&m_pIdleFlags[kiIdx]) && WelsAtomicCas (&m_pIdleFlags[kiIdx], 1, 0)) {
+      m_pWorkers[kiIdx]->Wake();
+      return;
+    }
   }
 }
 
-bool  CWelsThreadPool::AddTaskToWaitedList (IWelsTask* pTask) {
-  CWelsAutoLock  cLock (m_cLockWaitedTasks);
-
-  return m_cWaitedTasks->push_back (pTask);
-}
-
-CWelsTaskThread*   CWelsThreadPool::GetIdleThread() {
-  CWelsAutoLock cLock (m_cLockIdleTasks);
-
-  if (NULL == m_cIdleThreads || m_cIdleThreads->size() == 0) {
-    return NULL;
+IWelsTask* CWelsThreadPool::GetTask (const int32_t kiWorkerIdx) {
+  IWelsTask* pTask = NULL;
+  for (int32_t i = 0; i < m_iWorkerNum && NULL == pTask; i++) {
+    pTask = m_pTaskQueues[ (kiWorkerIdx + i) % m_iWorkerNum].Pop();
   }
-
-  //fprintf(stdout, "CWelsThreadPool::GetIdleThread=%d\n", m_cIdleThreads->size());
-
-  CWelsTaskThread* pThread = m_cIdleThreads->begin();
-  m_cIdleThreads->pop_front();
-  return pThread;
-}
-
-int32_t  CWelsThreadPool::GetBusyThreadNum() {
-  return (m_cBusyThreads?m_cBusyThreads->size():0);
-}
-
-int32_t  CWelsThreadPool::GetIdleThreadNum() {
-  return (m_cIdleThreads?m_cIdleThreads->size():0);
-}
-
-int32_t  CWelsThreadPool::GetWaitedTaskNum() {
-  return (m_cWaitedTasks?m_cWaitedTasks->size():0);
+  if (NULL == pTask && WelsAtomicLoad (&m_iOverflowTaskNum) > 0) {
+    CWelsAutoLock cLock (m_cLockOverflowTasks);
+    if (m_cOverflowTasks->size() > 0) {
+      pTask = m_cOverflowTasks->begin();
+      m_cOverflowTasks->pop_front();
+      WelsAtomicAdd (&m_iOverflowTaskNum, -1);
+    }
+  }
+  return pTask;
 }
 
-IWelsTask* CWelsThreadPool::GetWaitedTask() {
-  CWelsAutoLock lock (m_cLockWaitedTasks);
-
-  if (NULL==m_cWaitedTasks || m_cWaitedTasks->size() == 0) {
-    return NULL;
+bool CWelsThreadPool::HasWaitedTask() {
+  for (int32_t i = 0; i < m_iWorkerNum; i++) {
+    if (!m_pTaskQueues[i].IsEmpty()) {
+      return true;
+    }
   }
-
-  IWelsTask* pTask = m_cWaitedTasks->begin();
-
-  m_cWaitedTasks->pop_front();
-
-  return pTask;
+  return WelsAtomicLoad (&m_iOverflowTaskNum) > 0;
 }
 
 void  CWelsThreadPool::ClearWaitedTasks() {
-  CWelsAutoLock cLock (m_cLockWaitedTasks);
-  if (NULL == m_cWaitedTasks) {
-    return;
-  }
   IWelsTask* pTask = NULL;
-  while (0 != m_cWaitedTasks->size()) {
-    pTask = m_cWaitedTasks->begin();
+  while (NULL != m_pTaskQueues && NULL != (pTask = GetTask (0))) {
     if (pTask->GetSink()) {
       pTask->GetSink()->OnTaskCancelled();
     }
-    m_cWaitedTasks->pop_front();
   }
 }
 
 }
+
@@ -253,6 +253,10 @@ int32_t WelsFwrite (const void* kpBuffer, int32_t iSize, int32_t iCount, WelsFil
   return (int32_t)fwrite (kpBuffer, iSize, iCount, pFp);
 }
 
+int32_t WelsFread (void* pBuffer, int32_t iSize, int32_t iCount, WelsFileHandle* pFp) {
+  return (int32_t)fread (pBuffer, iSize, iCount, pFp);
+}
+
 uint16_t WelsGetMillisecond (const SWelsTime* kpTp) {
   return kpTp->millitm;
 }
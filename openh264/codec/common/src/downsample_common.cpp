@@ -0,0 +1,120 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ *
+ * \file    downsample_common.cpp
+ *
+ * \brief   general bilinear downsampling, usable on horizontal bands of the destination
+ *
+ * \date    10/16/2026 Created
+ *
+ *************************************************************************************
+ */
+
+#include "downsample_common.h"
+#include "macros.h"
+
+#define DOWNSAMPLE_SCALE_BIT 15
+
+static inline int32_t BilinearScaleFactor (const int32_t kiSrcSize, const int32_t kiDstSize) {
+  return WELS_ROUND ((float)kiSrcSize / (float)kiDstSize * (1 << DOWNSAMPLE_SCALE_BIT));
+}
+
+int32_t WelsGeneralBilinearSrcRowsNeeded (const int32_t kiDstHeight, const int32_t kiSrcHeight, const int32_t kiDstRow) {
+  const int32_t kiYInverse = (1 << (DOWNSAMPLE_SCALE_BIT - 1)) + kiDstRow * BilinearScaleFactor (kiSrcHeight,
+                             kiDstHeight);
+  // the last row is not interpolated vertically
+  return (kiYInverse >> DOWNSAMPLE_SCALE_BIT) + (kiDstRow < kiDstHeight - 1 ? 2 : 1);
+}
+
+void WelsGeneralBilinearDownsampleRows_c (uint8_t* pDst, const int32_t kiDstStride, const int32_t kiDstWidth,
+    const int32_t kiDstHeight, const uint8_t* kpSrc, const int32_t kiSrcStride, const int32_t kiSrcWidth,
+    const int32_t kiSrcHeight, const int32_t kiFirstRow, const int32_t kiEndRow) {
+  const int32_t kiScaleBit = DOWNSAMPLE_SCALE_BIT;
+  const int32_t kiScale = (1 << kiScaleBit);
+  int32_t iScalex = BilinearScaleFactor (kiSrcWidth, kiDstWidth);
+  int32_t iScaley = BilinearScaleFactor (kiSrcHeight, kiDstHeight);
+  int64_t x;
+  int32_t iYInverse, iXInverse;
+  const int32_t kiEndInterpolated = WELS_MIN (kiEndRow, kiDstHeight - 1);
+
+  uint8_t* pByDst = pDst;
+  uint8_t* pByLineDst = pDst + kiFirstRow * kiDstStride;
+
+  iYInverse = (1 << (kiScaleBit - 1)) + kiFirstRow * iScaley;
+  for (int32_t i = kiFirstRow; i < kiEndInterpolated; i++) {
+    int32_t iYy = iYInverse >> kiScaleBit;
+    int32_t iFv = iYInverse & (kiScale - 1);
+
+    const uint8_t* pBySrc = kpSrc + iYy * kiSrcStride;
+
+    pByDst = pByLineDst;
+    iXInverse = 1 << (kiScaleBit - 1);
+    for (int32_t j = 0; j < kiDstWidth - 1; j++) {
+      int32_t iXx = iXInverse >> kiScaleBit;
+      int32_t iFu = iXInverse & (kiScale - 1);
+
+      const uint8_t* pByCurrent = pBySrc + iXx;
+      uint8_t a, b, c, d;
+
+      a = *pByCurrent;
+      b = * (pByCurrent + 1);
+      c = * (pByCurrent + kiSrcStride);
+      d = * (pByCurrent + kiSrcStride + 1);
+
+      x = (((int64_t) (kiScale - 1 - iFu)) * (kiScale - 1 - iFv) * a + ((int64_t)iFu) * (kiScale - 1 - iFv) * b + ((int64_t) (
+             kiScale - 1 - iFu)) * iFv * c +
+           ((int64_t)iFu) * iFv * d + (int64_t) (1 << (2 * kiScaleBit - 1))) >> (2 * kiScaleBit);
+      x = WELS_CLIP3 (x, 0, 255);
+      *pByDst++ = (uint8_t)x;
+
+      iXInverse += iScalex;
+    }
+    *pByDst = * (pBySrc + (iXInverse >> kiScaleBit));
+    pByLineDst += kiDstStride;
+    iYInverse += iScaley;
+  }
+
+  // last row special
+  if (kiEndRow == kiDstHeight && kiFirstRow < kiEndRow) {
+    int32_t iYy = iYInverse >> kiScaleBit;
+    const uint8_t* pBySrc = kpSrc + iYy * kiSrcStride;
+
+    pByDst = pByLineDst;
+    iXInverse = 1 << (kiScaleBit - 1);
+    for (int32_t j = 0; j < kiDstWidth; j++) {
+      int32_t iXx = iXInverse >> kiScaleBit;
+      *pByDst++ = * (pBySrc + iXx);
+
+      iXInverse += iScalex;
+    }
+  }
+}
@@ -348,16 +348,80 @@ static inline void ExpandPictureChroma_c (uint8_t* pDst, const int32_t kiStride,
   } while (i < kiPicH);
 }
 
+static inline void ExpandPictureRows_c (uint8_t* pDst, const int32_t kiStride, const int32_t kiPicW,
+                                        const int32_t kiRows, const int32_t kiPaddingLen) {
+  uint8_t* pTmp = pDst;
+  for (int32_t i = 0; i < kiRows; i++) {
+    memset (pTmp - kiPaddingLen, pTmp[0], kiPaddingLen);
+    memset (pTmp + kiPicW, pTmp[kiPicW - 1], kiPaddingLen);
+    pTmp += kiStride;
+  }
+}
+
+static void ExpandPictureLumaRows_c (uint8_t* pDst, const int32_t kiStride, const int32_t kiPicW,
+                                     const int32_t kiRows) {
+  ExpandPictureRows_c (pDst, kiStride, kiPicW, kiRows, PADDING_LENGTH);
+}
+
+static void ExpandPictureChromaRows_c (uint8_t* pDst, const int32_t kiStride, const int32_t kiPicW,
+                                       const int32_t kiRows) {
+  ExpandPictureRows_c (pDst, kiStride, kiPicW, kiRows, CHROMA_PADDING_LENGTH);
+}
+
+static inline void ExpandPlaneRows (uint8_t* pDst, const int32_t kiStride, const int32_t kiPicW,
+                                    const int32_t kiPicH, const int32_t kiStartRow, const int32_t kiEndRow, const int32_t kiPaddingLen,
+                                    PExpandPictureFunc pExpRows) {
+  int32_t i = 0;
+
+  // pad left and right
+  if (kiEndRow > kiStartRow)
+    pExpRows (pDst + kiStartRow * kiStride, kiStride, kiPicW, kiEndRow - kiStartRow);
+
+  // pad top and bottom, the first and last lines carry their corners already
+  if (0 == kiStartRow) {
+    uint8_t* pFirstLine = pDst - kiPaddingLen;
+    for (i = 1; i <= kiPaddingLen; i++)
+      memcpy (pFirstLine - i * kiStride, pFirstLine, kiPicW + (kiPaddingLen << 1)); // confirmed_safe_unsafe_usage
+  }
+  if (kiPicH == kiEndRow) {
+    uint8_t* pLastLine = pDst + (kiPicH - 1) * kiStride - kiPaddingLen;
+    for (i = 1; i <= kiPaddingLen; i++)
+      memcpy (pLastLine + i * kiStride, pLastLine, kiPicW + (kiPaddingLen << 1)); // confirmed_safe_unsafe_usage
+  }
+}
+
+// the kernels are picked like in ExpandReferencingPicture() so that both give the same picture
+void ExpandReferencingPictureRows (uint8_t* pData[3], int32_t iWidth, int32_t iHeight, int32_t iStride[3],
+                                   int32_t iStartRow, int32_t iEndRow, PExpandPictureFunc pExpLumaRows,
+                                   PExpandPictureFunc pExpChromRows[2]) {
+  const int32_t kiWidthUV           = iWidth >> 1;
+  PExpandPictureFunc pExpChromaRows = ExpandPictureChromaRows_c;
+  if (kiWidthUV >= 16)
+    pExpChromaRows = pExpChromRows[(kiWidthUV & 0x0F) == 0];
+
+  ExpandPlaneRows (pData[0], iStride[0], iWidth, iHeight, iStartRow, iEndRow, PADDING_LENGTH, pExpLumaRows);
+  ExpandPlaneRows (pData[1], iStride[1], kiWidthUV, iHeight >> 1, iStartRow >> 1, iEndRow >> 1,
+                   CHROMA_PADDING_LENGTH, pExpChromaRows);
+  ExpandPlaneRows (pData[2], iStride[2], kiWidthUV, iHeight >> 1, iStartRow >> 1, iEndRow >> 1,
+                   CHROMA_PADDING_LENGTH, pExpChromaRows);
+}
+
 void InitExpandPictureFunc (SExpandPicFunc* pExpandPicFunc, const uint32_t kuiCPUFlag) {
   pExpandPicFunc->pfExpandLumaPicture        = ExpandPictureLuma_c;
   pExpandPicFunc->pfExpandChromaPicture[0]   = ExpandPictureChroma_c;
   pExpandPicFunc->pfExpandChromaPicture[1]   = ExpandPictureChroma_c;
+  pExpandPicFunc->pfExpandLumaRows           = ExpandPictureLumaRows_c;
+  pExpandPicFunc->pfExpandChromaRows[0]      = ExpandPictureChromaRows_c;
+  pExpandPicFunc->pfExpandChromaRows[1]      = ExpandPictureChromaRows_c;
 
 #if defined(X86_ASM)
   if ((kuiCPUFlag & WELS_CPU_SSE2) == WELS_CPU_SSE2) {
     pExpandPicFunc->pfExpandLumaPicture      = ExpandPictureLuma_sse2;
     pExpandPicFunc->pfExpandChromaPicture[0] = ExpandPictureChromaUnalign_sse2;
     pExpandPicFunc->pfExpandChromaPicture[1] = ExpandPictureChromaAlign_sse2;
+    pExpandPicFunc->pfExpandLumaRows         = ExpandPictureLumaRows_sse2;
+    pExpandPicFunc->pfExpandChromaRows[0]    = ExpandPictureChromaRowsUnalign_sse2;
+    pExpandPicFunc->pfExpandChromaRows[1]    = ExpandPictureChromaRowsAlign_sse2;
   }
 #endif//X86_ASM
 #if defined(HAVE_NEON)
@@ -365,6 +429,9 @@ void InitExpandPictureFunc (SExpandPicFunc* pExpandPicFunc, const uint32_t kuiCP
     pExpandPicFunc->pfExpandLumaPicture      = ExpandPictureLuma_neon;
     pExpandPicFunc->pfExpandChromaPicture[0] = ExpandPictureChroma_neon;
     pExpandPicFunc->pfExpandChromaPicture[1] = ExpandPictureChroma_neon;
+    pExpandPicFunc->pfExpandLumaRows         = ExpandPictureLumaRows_neon;
+    pExpandPicFunc->pfExpandChromaRows[0]    = ExpandPictureChromaRows_neon;
+    pExpandPicFunc->pfExpandChromaRows[1]    = ExpandPictureChromaRows_neon;
   }
 #endif//HAVE_NEON
 #if defined(HAVE_NEON_AARCH64)
@@ -372,6 +439,9 @@ void InitExpandPictureFunc (SExpandPicFunc* pExpandPicFunc, const uint32_t kuiCP
     pExpandPicFunc->pfExpandLumaPicture      = ExpandPictureLuma_AArch64_neon;
     pExpandPicFunc->pfExpandChromaPicture[0] = ExpandPictureChroma_AArch64_neon;
     pExpandPicFunc->pfExpandChromaPicture[1] = ExpandPictureChroma_AArch64_neon;
+    pExpandPicFunc->pfExpandLumaRows         = ExpandPictureLumaRows_AArch64_neon;
+    pExpandPicFunc->pfExpandChromaRows[0]    = ExpandPictureChromaRows_AArch64_neon;
+    pExpandPicFunc->pfExpandChromaRows[1]    = ExpandPictureChromaRows_AArch64_neon;
   }
 #endif//HAVE_NEON_AARCH64
 #if defined(HAVE_MMI)
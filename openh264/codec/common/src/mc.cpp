@@ -38,6 +38,7 @@
  *************************************************************************************
  */
 
+#include <string.h>
 #include "mc.h"
 
 #include "cpu_core.h"
@@ -4603,3 +4604,20 @@ void WelsCommon::InitMcFunc (SMcFunc* pMcFuncs, uint32_t uiCpuFlag) {
   }
 #endif//HAVE_LSX
 }
+
+void WelsCommon::McEmulateEdge_c (uint8_t* pDst, int32_t iDstStride, const uint8_t* pPlane, int32_t iPlaneStride,
+                                  int32_t iX, int32_t iY, int32_t iWidth, int32_t iHeight, int32_t iPicWidth, int32_t iPicHeight) {
+  const int32_t kiLeft  = WELS_CLIP3 (-iX, 0, iWidth);
+  const int32_t kiRight = WELS_CLIP3 (iX + iWidth - iPicWidth, 0, iWidth - kiLeft);
+  const int32_t kiInner = iWidth - kiLeft - kiRight;
+  for (int32_t i = 0; i < iHeight; i++) {
+    const uint8_t* kpRow = pPlane + WELS_CLIP3 (iY + i, 0, iPicHeight - 1) * iPlaneStride;
+    if (kiLeft > 0)
+      memset (pDst, kpRow[0], kiLeft);
+    if (kiInner > 0)
+      memcpy (pDst + kiLeft, kpRow + iX + kiLeft, kiInner);
+    if (kiRight > 0)
+      memset (pDst + kiLeft + kiInner, kpRow[iPicWidth - 1], kiRight);
+    pDst += iDstStride;
+  }
+}
@@ -34,6 +34,8 @@
 #include <string.h>
 #include "memory_align.h"
 #include "macros.h"
+#include "WelsBufferArena.h"
+#include "WelsThreadLib.h"
 
 namespace WelsCommon {
 
@@ -45,10 +47,12 @@ static int32_t  g_iMemoryLength;
 
 
 CMemoryAlign::CMemoryAlign (const uint32_t kuiCacheLineSize)
-#ifdef MEMORY_MONITOR
-  : m_nMemoryUsageInBytes (0)
-#endif//MEMORY_MONITOR
-{
+  : m_nMemoryUsageInBytes (0) {
+  m_iPeakBytes  = 0;
+  for (int32_t i = 0; i < MEMORY_CATEGORY_NUM; i++) {
+    m_iCategoryBytes[i]     = 0;
+    m_iCategoryPeakBytes[i] = 0;
+  }
   if ((kuiCacheLineSize == 0) || (kuiCacheLineSize & 0x0f))
     m_nCacheLineSize = 0x10;
   else
@@ -61,11 +65,35 @@ CMemoryAlign::~CMemoryAlign() {
 #endif//MEMORY_MONITOR
 }
 
-void* WelsMalloc (const uint32_t kuiSize, const char* kpTag, const uint32_t kiAlign) {
+// the payload size is kept in front of the aligned pointer, with ARENA_BLOCK_FLAG for blocks of the arena;
+// blocks of CMemoryAlign keep their EMemoryCategory in front of the size
+#define ARENA_BLOCK_FLAG 0x80000000u
+#define PAYLOAD_SIZE(pPointer) (* ((uint32_t*) ((uint8_t*)(pPointer) - sizeof (void**) - sizeof (int32_t))))
+#define MEMORY_CATEGORY(pPointer) (* ((int32_t*) ((uint8_t*)(pPointer) - sizeof (void**) - 2 * sizeof (int32_t))))
+#define HEADER_SIZE           (sizeof (void**) + sizeof (int32_t))
+#define CATEGORY_HEADER_SIZE  (sizeof (void**) + 2 * sizeof (int32_t))
+// bytes a block of CMemoryAlign holds: payload, alignment slack and the header with the category
+#define BLOCK_LENGTH(pPointer, kuiAlign) \
+  ((int64_t) (PAYLOAD_SIZE (pPointer) & ~ARENA_BLOCK_FLAG) + (kuiAlign) - 1 + CATEGORY_HEADER_SIZE)
+
+static void* AlignBuffer (uint8_t* pBuf, const uint32_t kuiSizeField, const uint32_t kiAlign,
+                          const uint32_t kiHeaderSize) {
   const uint32_t kiSizeOfVoidPointer     = sizeof (void**);
   const uint32_t kiSizeOfInt             = sizeof (int32_t);
   const uint32_t kiAlignedBytes          = kiAlign - 1;
-  const uint32_t kiTrialRequestedSize    = kuiSize + kiAlignedBytes + kiSizeOfVoidPointer + kiSizeOfInt;
+  uint8_t* pAlignedBuffer;
+  pAlignedBuffer = pBuf + kiAlignedBytes + kiHeaderSize;
+  pAlignedBuffer -= ((uintptr_t) pAlignedBuffer & kiAlignedBytes);
+  * ((void**) (pAlignedBuffer - kiSizeOfVoidPointer)) = pBuf;
+  * ((uint32_t*) (pAlignedBuffer - (kiSizeOfVoidPointer + kiSizeOfInt))) = kuiSizeField;
+
+  return pAlignedBuffer;
+}
+
+static void* WelsMallocWithHeader (const uint32_t kuiSize, const char* kpTag, const uint32_t kiAlign,
+                                   const uint32_t kiHeaderSize) {
+  const uint32_t kiAlignedBytes          = kiAlign - 1;
+  const uint32_t kiTrialRequestedSize    = kuiSize + kiAlignedBytes + kiHeaderSize;
   const uint32_t kiActualRequestedSize   = kiTrialRequestedSize;
   const uint32_t kiPayloadSize          = kuiSize;
 
@@ -89,13 +117,41 @@ void* WelsMalloc (const uint32_t kuiSize, const char* kpTag, const uint32_t kiAl
     fflush (fpMemChkPoint);
   }
 #endif
-  uint8_t* pAlignedBuffer;
-  pAlignedBuffer = pBuf + kiAlignedBytes + kiSizeOfVoidPointer + kiSizeOfInt;
-  pAlignedBuffer -= ((uintptr_t) pAlignedBuffer & kiAlignedBytes);
-  * ((void**) (pAlignedBuffer - kiSizeOfVoidPointer)) = pBuf;
-  * ((int32_t*) (pAlignedBuffer - (kiSizeOfVoidPointer + kiSizeOfInt))) = kiPayloadSize;
+  return AlignBuffer (pBuf, kiPayloadSize, kiAlign, kiHeaderSize);
+}
 
-  return pAlignedBuffer;
+void* WelsMalloc (const uint32_t kuiSize, const char* kpTag, const uint32_t kiAlign) {
+  return WelsMallocWithHeader (kuiSize, kpTag, kiAlign, HEADER_SIZE);
+}
+
+// large blocks of codec instances come from and go back to the process wide arena
+static void* WelsArenaMalloc (const uint32_t kuiSize, const uint32_t kiAlign) {
+  uint8_t* pBuf = (uint8_t*) CWelsBufferArena::GetInstance().Acquire (kuiSize);
+  if (NULL == pBuf)
+    return NULL;
+  return AlignBuffer (pBuf, kuiSize | ARENA_BLOCK_FLAG, kiAlign, CATEGORY_HEADER_SIZE);
+}
+
+// tags name the buffers after their codec structures, which is enough to sort them for the usage report
+static int32_t WelsMemoryCategory (const char* kpTag) {
+  if (NULL == kpTag)
+    return MEMORY_CATEGORY_OTHERS;
+  if (strstr (kpTag, "Vaa") != NULL)
+    return MEMORY_CATEGORY_VAA;
+  if (strstr (kpTag, "Pic") != NULL || strstr (kpTag, "pic") != NULL)
+    return MEMORY_CATEGORY_PICTURES;
+  if (strstr (kpTag, "Bs") != NULL || strstr (kpTag, "Nal") != NULL || strstr (kpTag, "Access Unit") != NULL
+      || strstr (kpTag, "RawData") != NULL || strstr (kpTag, "SavedData") != NULL)
+    return MEMORY_CATEGORY_BITSTREAM;
+  if (strstr (kpTag, "Mb") != NULL || strstr (kpTag, "MB") != NULL || strstr (kpTag, "Block") != NULL)
+    return MEMORY_CATEGORY_MB_CACHES;
+  return MEMORY_CATEGORY_OTHERS;
+}
+
+static void WelsRaisePeak (volatile int64_t* pPeak, const int64_t kiValue) {
+  int64_t iPeak = WelsAtomicLoad64 (pPeak);
+  while (kiValue > iPeak && !WelsAtomicCas64 (pPeak, iPeak, kiValue))
+    iPeak = WelsAtomicLoad64 (pPeak);
 }
 
 void WelsFree (void* pPointer, const char* kpTag) {
@@ -126,31 +182,42 @@ void* CMemoryAlign::WelsMallocz (const uint32_t kuiSize, const char* kpTag) {
 }
 
 void* CMemoryAlign::WelsMalloc (const uint32_t kuiSize, const char* kpTag) {
-  void* pPointer = WelsCommon::WelsMalloc (kuiSize, kpTag, m_nCacheLineSize);
-#ifdef MEMORY_MONITOR
-  if (pPointer != NULL) {
-    const int32_t kiMemoryLength = * ((int32_t*) ((uint8_t*)pPointer - sizeof (void**) - sizeof (
-                                        int32_t))) + m_nCacheLineSize - 1 + sizeof (void**) + sizeof (int32_t);
-    m_nMemoryUsageInBytes += kiMemoryLength;
+  void* pPointer;
+  if (CWelsBufferArena::IsArenaSize (kuiSize) && m_nCacheLineSize <= WELS_BUFFER_ARENA_MAX_ALIGN)
+    pPointer = WelsArenaMalloc (kuiSize, m_nCacheLineSize);
+  else
+    pPointer = WelsMallocWithHeader (kuiSize, kpTag, m_nCacheLineSize, CATEGORY_HEADER_SIZE);
+  if (NULL == pPointer)
+    return NULL;
+  const int64_t kiMemoryLength = BLOCK_LENGTH (pPointer, m_nCacheLineSize);
 #ifdef MEMORY_CHECK
-    g_iMemoryLength = kiMemoryLength;
+  g_iMemoryLength = (int32_t)kiMemoryLength;
 #endif
-  }
-#endif//MEMORY_MONITOR
+  const int32_t kiCategory = WelsMemoryCategory (kpTag);
+  MEMORY_CATEGORY (pPointer) = kiCategory;
+  WelsRaisePeak (&m_iPeakBytes, WelsAtomicAdd64 (&m_nMemoryUsageInBytes, kiMemoryLength));
+  WelsRaisePeak (&m_iCategoryPeakBytes[kiCategory], WelsAtomicAdd64 (&m_iCategoryBytes[kiCategory], kiMemoryLength));
   return pPointer;
 }
 
 void CMemoryAlign::WelsFree (void* pPointer, const char* kpTag) {
-#ifdef MEMORY_MONITOR
   if (pPointer) {
-    const int32_t kiMemoryLength = * ((int32_t*) ((uint8_t*)pPointer - sizeof (void**) - sizeof (
-                                        int32_t))) + m_nCacheLineSize - 1 + sizeof (void**) + sizeof (int32_t);
-    m_nMemoryUsageInBytes -= kiMemoryLength;
+    const int64_t kiMemoryLength = BLOCK_LENGTH (pPointer, m_nCacheLineSize);
 #ifdef MEMORY_CHECK
-    g_iMemoryLength = kiMemoryLength;
+    g_iMemoryLength = (int32_t)kiMemoryLength;
 #endif
+    // a header overwritten by a buffer underrun must not take the counters out of the array
+    int32_t iCategory = MEMORY_CATEGORY (pPointer);
+    assert (iCategory >= 0 && iCategory < MEMORY_CATEGORY_NUM);
+    if (iCategory < 0 || iCategory >= MEMORY_CATEGORY_NUM)
+      iCategory = MEMORY_CATEGORY_OTHERS;
+    WelsAtomicAdd64 (&m_nMemoryUsageInBytes, -kiMemoryLength);
+    WelsAtomicAdd64 (&m_iCategoryBytes[iCategory], -kiMemoryLength);
+  }
+  if (pPointer && (PAYLOAD_SIZE (pPointer) & ARENA_BLOCK_FLAG)) {
+    CWelsBufferArena::GetInstance().Release (* (((void**) pPointer) - 1), PAYLOAD_SIZE (pPointer) & ~ARENA_BLOCK_FLAG);
+    return;
   }
-#endif//MEMORY_MONITOR
   WelsCommon::WelsFree (pPointer, kpTag);
 }
 
@@ -167,8 +234,17 @@ const uint32_t CMemoryAlign::WelsGetCacheLineSize() const {
   return m_nCacheLineSize;
 }
 
-const uint32_t CMemoryAlign::WelsGetMemoryUsage() const {
-  return m_nMemoryUsageInBytes;
+const int64_t CMemoryAlign::WelsGetMemoryUsage() const {
+  return WelsAtomicLoad64 (const_cast<volatile int64_t*> (&m_nMemoryUsageInBytes));
+}
+
+void CMemoryAlign::WelsAddMemoryUsage (SMemoryUsage* pUsage) const {
+  pUsage->iCurrentBytes += WelsGetMemoryUsage();
+  pUsage->iPeakBytes    += WelsAtomicLoad64 (const_cast<volatile int64_t*> (&m_iPeakBytes));
+  for (int32_t i = 0; i < MEMORY_CATEGORY_NUM; i++) {
+    pUsage->iCategoryCurrentBytes[i] += WelsAtomicLoad64 (const_cast<volatile int64_t*> (&m_iCategoryBytes[i]));
+    pUsage->iCategoryPeakBytes[i]    += WelsAtomicLoad64 (const_cast<volatile int64_t*> (&m_iCategoryPeakBytes[i]));
+  }
 }
 
 } // end of namespace WelsCommon
@@ -163,3 +163,18 @@ void WelsSampleSadFour4x8_c (uint8_t* iSample1, int32_t iStride1, uint8_t* iSamp
   * (pSad + 2) = WelsSampleSad4x8_c (iSample1, iStride1, (iSample2 - 1), iStride2);
   * (pSad + 3) = WelsSampleSad4x8_c (iSample1, iStride1, (iSample2 + 1), iStride2);
 }
+
+#define WELS_SAMPLE_SAD_MULTI_C(kiWidth, kiHeight) \
+void WelsSampleSadMulti##kiWidth##x##kiHeight##_c (uint8_t* pSample1, int32_t iStride1, uint8_t* pSample2, \
+    int32_t iStride2, const int32_t* kpOffset, int32_t iCount, int32_t* pSad) { \
+  for (int32_t i = 0; i < iCount; i++) \
+    pSad[i] = WelsSampleSad##kiWidth##x##kiHeight##_c (pSample1, iStride1, pSample2 + kpOffset[i], iStride2); \
+}
+
+WELS_SAMPLE_SAD_MULTI_C (16, 16)
+WELS_SAMPLE_SAD_MULTI_C (16, 8)
+WELS_SAMPLE_SAD_MULTI_C (8, 16)
+WELS_SAMPLE_SAD_MULTI_C (8, 8)
+WELS_SAMPLE_SAD_MULTI_C (4, 4)
+WELS_SAMPLE_SAD_MULTI_C (8, 4)
+WELS_SAMPLE_SAD_MULTI_C (4, 8)
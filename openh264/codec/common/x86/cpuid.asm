@@ -242,7 +242,7 @@ WELS_EXTERN WelsCPUDetectAVX512
     ; EBX[bit 31]: AVX512VL
     mov eax, 7
     cpuid
-    and ebx, 0xC0030000
+    and ebx, 0xD0030000
     mov eax, ebx
 
 %ifdef    X86_32
@@ -726,3 +726,61 @@ WELS_EXTERN ExpandPictureChromaUnalign_sse2
 
 
     ret
+
+%macro exp_rows_left_right_sse2 2   ; iPaddingSize [luma(32)/chroma(16)], u/a
+    push r4
+    push r5
+    push r6
+
+    %assign push_num 3
+    LOAD_4_PARA
+
+    SIGN_EXTENSION r1,r1d
+    SIGN_EXTENSION r2,r2d
+    SIGN_EXTENSION r3,r3d
+
+    mov r6,r3                               ;r6 = rows
+    lea r5,[r0-%1]                          ;left border dst
+    lea r3,[r0+r2-1]                        ;right border src
+    lea r4,[r3+1]                           ;right border dst
+
+    exp_left_right_sse2 %1,%2
+
+    LOAD_4_PARA_POP
+
+    pop r6
+    pop r5
+    pop r4
+
+    %assign push_num 0
+%endmacro
+
+;***********************************************************************----------------
+; void ExpandPictureLumaRows_sse2(  uint8_t *pDst,
+;                                   const int32_t iStride,
+;                                   const int32_t iWidth,
+;                                   const int32_t iRows );
+;***********************************************************************----------------
+WELS_EXTERN ExpandPictureLumaRows_sse2
+    exp_rows_left_right_sse2 32,a
+    ret
+
+;***********************************************************************----------------
+; void ExpandPictureChromaRowsAlign_sse2(   uint8_t *pDst,
+;                                           const int32_t iStride,
+;                                           const int32_t iWidth,
+;                                           const int32_t iRows );
+;***********************************************************************----------------
+WELS_EXTERN ExpandPictureChromaRowsAlign_sse2
+    exp_rows_left_right_sse2 16,a
+    ret
+
+;***********************************************************************----------------
+; void ExpandPictureChromaRowsUnalign_sse2( uint8_t *pDst,
+;                                           const int32_t iStride,
+;                                           const int32_t iWidth,
+;                                           const int32_t iRows );
+;***********************************************************************----------------
+WELS_EXTERN ExpandPictureChromaRowsUnalign_sse2
+    exp_rows_left_right_sse2 16,u
+    ret
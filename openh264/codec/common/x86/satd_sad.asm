@@ -2697,6 +2697,265 @@ WELS_EXTERN WelsSampleSadFour4x4_sse2
 ;
 ;***********************************************************************
 
+;***********************************************************************
+;
+;Pixel_sad_multi_wxh_avx2 BEGIN
+;
+;***********************************************************************
+%ifdef HAVE_AVX2
+%ifndef X86_32
+
+; load 2 rows of 16 pixels into one ymm
+%macro AVX2_Load2x16P 3 ; dst(mm#), p, stride
+    vmovdqu         x%1, [%2]
+    vinserti128     y%1, y%1, [%2 + %3], 1
+%endmacro
+
+; load 4 rows of 8 pixels into one ymm, p is advanced by 4 rows
+%macro AVX2_Load4x8P 4 ; dst(mm#), tmp(mm#), p, stride
+    vmovq           x%1, [%3]
+    vmovhps         x%1, x%1, [%3 + %4]
+    lea             %3, [%3 + 2 * %4]
+    vmovq           x%2, [%3]
+    vmovhps         x%2, x%2, [%3 + %4]
+    lea             %3, [%3 + 2 * %4]
+    vinserti128     y%1, y%1, x%2, 1
+%endmacro
+
+; accumulate the sad of 2 rows of 16 pixels at p, p is advanced by 2 rows
+%macro AVX2_Sad2x16P 5 ; acc(mm#), tmp(mm#), src(mm#), p, stride
+    AVX2_Load2x16P  %2, %4, %5
+    vpsadbw         y%2, y%2, y%3
+    vpaddd          y%1, y%1, y%2
+    lea             %4, [%4 + 2 * %5]
+%endmacro
+
+; accumulate the sad of 4 rows of 8 pixels at p, p is advanced by 4 rows
+%macro AVX2_Sad4x8P 6 ; acc(mm#), tmp(mm#), tmp2(mm#), src(mm#), p, stride
+    AVX2_Load4x8P   %2, %3, %5, %6
+    vpsadbw         y%2, y%2, y%4
+    vpaddd          y%1, y%1, y%2
+%endmacro
+
+; store the sum of the 4 qword sads held in acc as one dword
+%macro AVX2_StoreSadD 3 ; dst, acc(mm#), tmp(mm#)
+    vextracti128    x%3, y%2, 1
+    vpaddd          x%2, x%2, x%3
+    vpunpckhqdq     x%3, x%2, x%2
+    vpaddd          x%2, x%2, x%3
+    vmovd           %1, x%2
+%endmacro
+
+; the candidate loop reuses r0 as the candidate pointer once the block is loaded,
+; r4 walks the offsets, r5 counts down and r6 walks the results
+%macro SAD_MULTI_LOOP_BEGIN 0
+    test            r5, r5
+    jle             .done
+.loop:
+    movsxd          r0, dword [r4]
+    add             r0, r2
+    vpxor           ymm0, ymm0, ymm0
+%endmacro
+
+%macro SAD_MULTI_LOOP_END 0
+    AVX2_StoreSadD  [r6], mm0, mm1
+    add             r4, 4
+    add             r6, 4
+    sub             r5, 1
+    jnz             .loop
+.done:
+%endmacro
+
+;***********************************************************************
+;   void WelsSampleSadMulti16x16_avx2 (uint8_t* pSample1, int32_t iStride1, uint8_t* pSample2, int32_t iStride2,
+;                                      const int32_t* kpOffset, int32_t iCount, int32_t* pSad);
+;***********************************************************************
+WELS_EXTERN WelsSampleSadMulti16x16_avx2
+    %assign  push_num 0
+    LOAD_7_PARA
+    PUSH_XMM 10
+    SIGN_EXTENSION r1, r1d
+    SIGN_EXTENSION r3, r3d
+    SIGN_EXTENSION r5, r5d
+    AVX2_Load2x16P  mm2, r0, r1
+    lea             r0, [r0 + 2 * r1]
+    AVX2_Load2x16P  mm3, r0, r1
+    lea             r0, [r0 + 2 * r1]
+    AVX2_Load2x16P  mm4, r0, r1
+    lea             r0, [r0 + 2 * r1]
+    AVX2_Load2x16P  mm5, r0, r1
+    lea             r0, [r0 + 2 * r1]
+    AVX2_Load2x16P  mm6, r0, r1
+    lea             r0, [r0 + 2 * r1]
+    AVX2_Load2x16P  mm7, r0, r1
+    lea             r0, [r0 + 2 * r1]
+    AVX2_Load2x16P  mm8, r0, r1
+    lea             r0, [r0 + 2 * r1]
+    AVX2_Load2x16P  mm9, r0, r1
+    SAD_MULTI_LOOP_BEGIN
+    AVX2_Sad2x16P   mm0, mm1, mm2, r0, r3
+    AVX2_Sad2x16P   mm0, mm1, mm3, r0, r3
+    AVX2_Sad2x16P   mm0, mm1, mm4, r0, r3
+    AVX2_Sad2x16P   mm0, mm1, mm5, r0, r3
+    AVX2_Sad2x16P   mm0, mm1, mm6, r0, r3
+    AVX2_Sad2x16P   mm0, mm1, mm7, r0, r3
+    AVX2_Sad2x16P   mm0, mm1, mm8, r0, r3
+    AVX2_Sad2x16P   mm0, mm1, mm9, r0, r3
+    SAD_MULTI_LOOP_END
+    vzeroupper
+    POP_XMM
+    LOAD_7_PARA_POP
+    ret
+
+;***********************************************************************
+;   void WelsSampleSadMulti16x8_avx2 (uint8_t* pSample1, int32_t iStride1, uint8_t* pSample2, int32_t iStride2,
+;                                     const int32_t* kpOffset, int32_t iCount, int32_t* pSad);
+;***********************************************************************
+WELS_EXTERN WelsSampleSadMulti16x8_avx2
+    %assign  push_num 0
+    LOAD_7_PARA
+    SIGN_EXTENSION r1, r1d
+    SIGN_EXTENSION r3, r3d
+    SIGN_EXTENSION r5, r5d
+    AVX2_Load2x16P  mm2, r0, r1
+    lea             r0, [r0 + 2 * r1]
+    AVX2_Load2x16P  mm3, r0, r1
+    lea             r0, [r0 + 2 * r1]
+    AVX2_Load2x16P  mm4, r0, r1
+    lea             r0, [r0 + 2 * r1]
+    AVX2_Load2x16P  mm5, r0, r1
+    SAD_MULTI_LOOP_BEGIN
+    AVX2_Sad2x16P   mm0, mm1, mm2, r0, r3
+    AVX2_Sad2x16P   mm0, mm1, mm3, r0, r3
+    AVX2_Sad2x16P   mm0, mm1, mm4, r0, r3
+    AVX2_Sad2x16P   mm0, mm1, mm5, r0, r3
+    SAD_MULTI_LOOP_END
+    vzeroupper
+    LOAD_7_PARA_POP
+    ret
+
+;***********************************************************************
+;   void WelsSampleSadMulti8x16_avx2 (uint8_t* pSample1, int32_t iStride1, uint8_t* pSample2, int32_t iStride2,
+;                                     const int32_t* kpOffset, int32_t iCount, int32_t* pSad);
+;***********************************************************************
+WELS_EXTERN WelsSampleSadMulti8x16_avx2
+    %assign  push_num 0
+    LOAD_7_PARA
+    PUSH_XMM 7
+    SIGN_EXTENSION r1, r1d
+    SIGN_EXTENSION r3, r3d
+    SIGN_EXTENSION r5, r5d
+    AVX2_Load4x8P   mm2, mm6, r0, r1
+    AVX2_Load4x8P   mm3, mm6, r0, r1
+    AVX2_Load4x8P   mm4, mm6, r0, r1
+    AVX2_Load4x8P   mm5, mm6, r0, r1
+    SAD_MULTI_LOOP_BEGIN
+    AVX2_Sad4x8P    mm0, mm1, mm6, mm2, r0, r3
+    AVX2_Sad4x8P    mm0, mm1, mm6, mm3, r0, r3
+    AVX2_Sad4x8P    mm0, mm1, mm6, mm4, r0, r3
+    AVX2_Sad4x8P    mm0, mm1, mm6, mm5, r0, r3
+    SAD_MULTI_LOOP_END
+    vzeroupper
+    POP_XMM
+    LOAD_7_PARA_POP
+    ret
+
+;***********************************************************************
+;   void WelsSampleSadMulti8x8_avx2 (uint8_t* pSample1, int32_t iStride1, uint8_t* pSample2, int32_t iStride2,
+;                                    const int32_t* kpOffset, int32_t iCount, int32_t* pSad);
+;***********************************************************************
+WELS_EXTERN WelsSampleSadMulti8x8_avx2
+    %assign  push_num 0
+    LOAD_7_PARA
+    SIGN_EXTENSION r1, r1d
+    SIGN_EXTENSION r3, r3d
+    SIGN_EXTENSION r5, r5d
+    AVX2_Load4x8P   mm2, mm4, r0, r1
+    AVX2_Load4x8P   mm3, mm4, r0, r1
+    SAD_MULTI_LOOP_BEGIN
+    AVX2_Sad4x8P    mm0, mm1, mm4, mm2, r0, r3
+    AVX2_Sad4x8P    mm0, mm1, mm4, mm3, r0, r3
+    SAD_MULTI_LOOP_END
+    vzeroupper
+    LOAD_7_PARA_POP
+    ret
+
+; load 4 rows of 16 pixels into one zmm, p is advanced by 4 rows
+%macro AVX512_Load4x16P 3 ; dst(mm#), p, stride
+    vbroadcasti32x4 z%1, [%2]
+    vinserti32x4    z%1, z%1, [%2 + %3], 1
+    lea             %2, [%2 + 2 * %3]
+    vinserti32x4    z%1, z%1, [%2], 2
+    vinserti32x4    z%1, z%1, [%2 + %3], 3
+    lea             %2, [%2 + 2 * %3]
+%endmacro
+
+; accumulate the sad of 4 rows of 16 pixels at p, p is advanced by 4 rows
+%macro AVX512_Sad4x16P 5 ; acc(mm#), tmp(mm#), src(mm#), p, stride
+    AVX512_Load4x16P %2, %4, %5
+    vpsadbw         z%2, z%2, z%3
+    vpaddd          z%1, z%1, z%2
+%endmacro
+
+; the block is kept in zmm16 and up which need no saving on any abi
+%macro AVX512_SAD_MULTI_LOOP_END 0
+    vextracti64x4   ymm1, zmm0, 1
+    vpaddd          ymm0, ymm0, ymm1
+    SAD_MULTI_LOOP_END
+%endmacro
+
+;***********************************************************************
+;   void WelsSampleSadMulti16x16_avx512 (uint8_t* pSample1, int32_t iStride1, uint8_t* pSample2, int32_t iStride2,
+;                                        const int32_t* kpOffset, int32_t iCount, int32_t* pSad);
+;***********************************************************************
+WELS_EXTERN WelsSampleSadMulti16x16_avx512
+    %assign  push_num 0
+    LOAD_7_PARA
+    SIGN_EXTENSION r1, r1d
+    SIGN_EXTENSION r3, r3d
+    SIGN_EXTENSION r5, r5d
+    AVX512_Load4x16P mm16, r0, r1
+    AVX512_Load4x16P mm17, r0, r1
+    AVX512_Load4x16P mm18, r0, r1
+    AVX512_Load4x16P mm19, r0, r1
+    SAD_MULTI_LOOP_BEGIN
+    AVX512_Sad4x16P mm0, mm1, mm16, r0, r3
+    AVX512_Sad4x16P mm0, mm1, mm17, r0, r3
+    AVX512_Sad4x16P mm0, mm1, mm18, r0, r3
+    AVX512_Sad4x16P mm0, mm1, mm19, r0, r3
+    AVX512_SAD_MULTI_LOOP_END
+    vzeroupper
+    LOAD_7_PARA_POP
+    ret
+
+;***********************************************************************
+;   void WelsSampleSadMulti16x8_avx512 (uint8_t* pSample1, int32_t iStride1, uint8_t* pSample2, int32_t iStride2,
+;                                       const int32_t* kpOffset, int32_t iCount, int32_t* pSad);
+;***********************************************************************
+WELS_EXTERN WelsSampleSadMulti16x8_avx512
+    %assign  push_num 0
+    LOAD_7_PARA
+    SIGN_EXTENSION r1, r1d
+    SIGN_EXTENSION r3, r3d
+    SIGN_EXTENSION r5, r5d
+    AVX512_Load4x16P mm16, r0, r1
+    AVX512_Load4x16P mm17, r0, r1
+    SAD_MULTI_LOOP_BEGIN
+    AVX512_Sad4x16P mm0, mm1, mm16, r0, r3
+    AVX512_Sad4x16P mm0, mm1, mm17, r0, r3
+    AVX512_SAD_MULTI_LOOP_END
+    vzeroupper
+    LOAD_7_PARA_POP
+    ret
+
+%endif ; !X86_32
+%endif ; HAVE_AVX2
+;***********************************************************************
+;
+;Pixel_sad_multi_wxh_avx2 END
+;
+;***********************************************************************
+
 ;***********************************************************************
 ;   int32_t WelsSampleSad4x4_mmx (uint8_t *, int32_t, uint8_t *, int32_t )
 ;***********************************************************************
@@ -108,6 +108,7 @@ typedef struct tagFilesSet {
   string strBsFile;
   string strSeqFile;    // for cmd lines
   string strLayerCfgFile[MAX_DEPENDENCY_LAYER];
+  string strRcStatsFile;  // statistics file of the two-pass rate control
   char   sRecFileName[MAX_DEPENDENCY_LAYER][MAX_FNAME_LEN];
   uint32_t uiFrameToBeCoded;
   bool     bEnableMultiBsFile;
@@ -312,6 +313,10 @@ int ParseConfig (CReadConfig& cRdCfg, SSourcePicture* pSrcPic, SEncParamExt& pSv
           pSvcParam.iMultipleThreadIdc = MAX_THREADS_NUM;
       } else if (strTag[0].compare ("UseLoadBalancing") == 0) {
         pSvcParam.bUseLoadBalancing = (atoi (strTag[1].c_str())) ? true : false;
+      } else if (strTag[0].compare ("UseWavefrontMd") == 0) {
+        pSvcParam.bUseWavefrontMd = (atoi (strTag[1].c_str())) ? true : false;
+      } else if (strTag[0].compare ("FramePipeline") == 0) {
+        pSvcParam.bEnableFramePipeline = (atoi (strTag[1].c_str())) ? true : false;
       } else if (strTag[0].compare ("RCMode") == 0) {
         pSvcParam.iRCMode = (RC_MODES) atoi (strTag[1].c_str());
       } else if (strTag[0].compare ("TargetBitrate") == 0) {
@@ -330,10 +335,18 @@ int ParseConfig (CReadConfig& cRdCfg, SSourcePicture* pSrcPic, SEncParamExt& pSv
         pSvcParam.iMaxQp = atoi (strTag[1].c_str());
       } else if (strTag[0].compare ("MinQp") == 0) {
         pSvcParam.iMinQp = atoi (strTag[1].c_str());
+      } else if (strTag[0].compare ("LookaheadFrames") == 0) {
+        pSvcParam.iLookaheadFrames = atoi (strTag[1].c_str());
+      } else if (strTag[0].compare ("RcPass") == 0) {
+        pSvcParam.eRcPass = (ERcPassType)atoi (strTag[1].c_str());
+      } else if (strTag[0].compare ("RcStatsFile") == 0) {
+        sFileSet.strRcStatsFile = strTag[1];
       } else if (strTag[0].compare ("EnableDenoise") == 0) {
         pSvcParam.bEnableDenoise = atoi (strTag[1].c_str()) ? true : false;
       } else if (strTag[0].compare ("EnableSceneChangeDetection") == 0) {
         pSvcParam.bEnableSceneChangeDetect = atoi (strTag[1].c_str()) ? true : false;
+      } else if (strTag[0].compare ("EnablePyramidMe") == 0) {
+        pSvcParam.bEnablePyramidMe = atoi (strTag[1].c_str()) ? true : false;
       } else if (strTag[0].compare ("EnableBackgroundDetection") == 0) {
         pSvcParam.bEnableBackgroundDetection = atoi (strTag[1].c_str()) ? true : false;
       } else if (strTag[0].compare ("EnableAdaptiveQuantization") == 0) {
@@ -413,6 +426,7 @@ void PrintHelp() {
   printf ("  -complexity  Complexity mode (default: 0),0: low complexity, 1: medium complexity, 2: high complexity\n");
   printf ("  -denois      Control denoising  (default: 0)\n");
   printf ("  -scene       Control scene change detection (default: 0)\n");
+  printf ("  -pyramidme   Control the coarse to fine motion search on downsampled planes (default: 0)\n");
   printf ("  -bgd         Control background detection (default: 0)\n");
   printf ("  -aq          Control adaptive quantization (default: 0)\n");
   printf ("  -ltr         Control long term reference (default: 0)\n");
@@ -420,6 +434,8 @@ void PrintHelp() {
   printf ("  -ltrper      Control the long term reference marking period \n");
   printf ("  -threadIdc   0: auto(dynamic imp. internal encoder); 1: multiple threads imp. disabled; > 1: count number of threads \n");
   printf ("  -loadbalancing   0: turn off loadbalancing between slices when multi-threading available; 1: (default value) turn on loadbalancing between slices when multi-threading available\n");
+  printf ("  -wavefront   0: (default value) off; 1: run motion estimation and mode decision on MB-row wavefronts in single slice mode when multi-threading available\n");
+  printf ("  -pipeline    0: (default value) off; 1: preprocess the next input frame on a lookahead thread while the current one is encoded, output is delayed by one frame\n");
   printf ("  -deblockIdc  Loop filter idc (0: on, 1: off, \n");
   printf ("  -alphaOffset AlphaOffset(-6..+6): valid range \n");
   printf ("  -betaOffset  BetaOffset (-6..+6): valid range\n");
@@ -428,6 +444,9 @@ void PrintHelp() {
   printf ("  -maxbrTotal  Overall max bitrate\n");
   printf ("  -maxqp       Maximum Qp (default: %d, or for screen content usage: %d)\n", QP_MAX_VALUE, MAX_SCREEN_QP);
   printf ("  -minqp       Minimum Qp (default: %d, or for screen content usage: %d)\n", QP_MIN_VALUE, MIN_SCREEN_QP);
+  printf ("  -lookahead   Number of input frames (0..16) analysed ahead for rate control and IDR placement at scene cuts, output is delayed by as many frames (default: 0)\n");
+  printf ("  -pass        Two-pass rate control: 0: (default value) single pass; 1: first pass writing the statistics file; 2: second pass reading it\n");
+  printf ("  -passfile    Statistics file of the two-pass rate control\n");
   printf ("  -numl        Number Of Layers: Must exist with layer_cfg file and the number of input layer_cfg file must equal to the value set by this command\n");
   printf ("  The options below are layer-based: (need to be set with layer id)\n");
   printf ("  -lconfig     (Layer) (spatial layer configure file)\n");
@@ -523,6 +542,9 @@ int ParseCommandLine (int argc, char** argv, SSourcePicture* pSrcPic, SEncParamE
     else if (!strcmp (pCommand, "-scene") && (n < argc))
       pSvcParam.bEnableSceneChangeDetect = atoi (argv[n++]) ? true : false;
 
+    else if (!strcmp (pCommand, "-pyramidme") && (n < argc))
+      pSvcParam.bEnablePyramidMe = atoi (argv[n++]) ? true : false;
+
     else if (!strcmp (pCommand, "-bgd") && (n < argc))
       pSvcParam.bEnableBackgroundDetection = atoi (argv[n++]) ? true : false;
 
@@ -551,6 +573,10 @@ int ParseCommandLine (int argc, char** argv, SSourcePicture* pSrcPic, SEncParamE
       pSvcParam.iMultipleThreadIdc = atoi (argv[n++]);
     else if (!strcmp (pCommand, "-loadbalancing") && (n + 1 < argc)) {
       pSvcParam.bUseLoadBalancing = (atoi (argv[n++])) ? true : false;
+    } else if (!strcmp (pCommand, "-wavefront") && (n < argc)) {
+      pSvcParam.bUseWavefrontMd = (atoi (argv[n++])) ? true : false;
+    } else if (!strcmp (pCommand, "-pipeline") && (n < argc)) {
+      pSvcParam.bEnableFramePipeline = (atoi (argv[n++])) ? true : false;
     } else if (!strcmp (pCommand, "-deblockIdc") && (n < argc))
       pSvcParam.iLoopFilterDisableIdc = atoi (argv[n++]);
 
@@ -578,6 +604,15 @@ int ParseCommandLine (int argc, char** argv, SSourcePicture* pSrcPic, SEncParamE
     else if (!strcmp (pCommand, "-minqp") && (n < argc))
       pSvcParam.iMinQp = atoi (argv[n++]);
 
+    else if (!strcmp (pCommand, "-lookahead") && (n < argc))
+      pSvcParam.iLookaheadFrames = atoi (argv[n++]);
+
+    else if (!strcmp (pCommand, "-pass") && (n < argc))
+      pSvcParam.eRcPass = (ERcPassType)atoi (argv[n++]);
+
+    else if (!strcmp (pCommand, "-passfile") && (n < argc))
+      sFileSet.strRcStatsFile.assign (argv[n++]);
+
     else if (!strcmp (pCommand, "-numl") && (n < argc)) {
       pSvcParam.iSpatialLayerNum = atoi (argv[n++]);
     } else if (!strcmp (pCommand, "-lconfig") && (n < argc)) {
@@ -765,6 +800,8 @@ int ProcessEncoding (ISVCEncoder* pPtrEnc, int argc, char** argv, bool bConfigFi
   FILE* pFileYUV = NULL;
   int32_t iActualFrameEncodedCount = 0;
   int32_t iFrameIdx = 0;
+  bool bFlushDelayedFrame = false;
+  int32_t iDelayedFrames = 0;
   int32_t iTotalFrameMax = -1;
   uint8_t* pYUV = NULL;
   SSourcePicture* pSrcPic = NULL;
@@ -853,6 +890,8 @@ int ProcessEncoding (ISVCEncoder* pPtrEnc, int argc, char** argv, bool bConfigFi
   sSvcParam.iPicHeight = (!sSvcParam.iPicHeight) ? iSourceHeight : sSvcParam.iPicHeight;
 
   iTotalFrameMax = (int32_t)fs.uiFrameToBeCoded;
+  if (fs.strRcStatsFile.length() > 0)
+    sSvcParam.pRcStatsFileName = const_cast<char*> (fs.strRcStatsFile.c_str());
   //  sSvcParam.bSimulcastAVC = true;
   if (cmResultSuccess != pPtrEnc->InitializeExt (&sSvcParam)) { // SVC encoder initialization
     fprintf (stderr, "SVC encoder Initialize failed\n");
@@ -938,9 +977,11 @@ int ProcessEncoding (ISVCEncoder* pPtrEnc, int argc, char** argv, bool bConfigFi
     goto INSIDE_MEM_FREE;
   }
 
+  // the lookahead holds back as many frames as it analyses, the frame pipeline at least one
+  iDelayedFrames = (sSvcParam.iLookaheadFrames > 0) ? sSvcParam.iLookaheadFrames :
+                   (sSvcParam.bEnableFramePipeline ? 1 : 0);
   iFrameIdx = 0;
-  while (iFrameIdx < iTotalFrameMax && (((int32_t)fs.uiFrameToBeCoded <= 0)
-                                        || (iFrameIdx < (int32_t)fs.uiFrameToBeCoded))) {
+  while (!bFlushDelayedFrame || iDelayedFrames > 0) {
 
 #ifdef ONLY_ENC_FRAMES_NUM
     // Only encoded some limited frames here
@@ -948,15 +989,21 @@ int ProcessEncoding (ISVCEncoder* pPtrEnc, int argc, char** argv, bool bConfigFi
       break;
     }
 #endif//ONLY_ENC_FRAMES_NUM
-    bool bCanBeRead = false;
-    bCanBeRead = (fread (pYUV, 1, kiPicResSize, pFileYUV) == kiPicResSize);
+    bool bCanBeRead = iFrameIdx < iTotalFrameMax && (((int32_t)fs.uiFrameToBeCoded <= 0)
+                      || (iFrameIdx < (int32_t)fs.uiFrameToBeCoded));
+    bCanBeRead = bCanBeRead && (fread (pYUV, 1, kiPicResSize, pFileYUV) == kiPicResSize);
 
-    if (!bCanBeRead)
-      break;
+    if (!bCanBeRead) {
+      // a NULL picture flushes one of the frames still held back
+      if (iDelayedFrames <= 0)
+        break;
+      -- iDelayedFrames;
+      bFlushDelayedFrame = true;
+    }
     // To encoder this frame
     iStart = WelsTime();
     pSrcPic->uiTimeStamp = WELS_ROUND (iFrameIdx * (1000 / sSvcParam.fMaxFrameRate));
-    int iEncFrames = pPtrEnc->EncodeFrame (pSrcPic, &sFbi);
+    int iEncFrames = pPtrEnc->EncodeFrame (bFlushDelayedFrame ? NULL : pSrcPic, &sFbi);
     iTotal += WelsTime() - iStart;
     ++ iFrameIdx;
     if (videoFrameTypeSkip == sFbi.eFrameType) {
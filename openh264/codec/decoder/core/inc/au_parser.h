@@ -48,6 +48,61 @@
 
 namespace WelsDec {
 
+/*!
+ *************************************************************************************
+ * \brief   Find the first 0x 00 00 0x (x <= 3) triple, i.e. a start code, an emulation
+ *          prevention byte or a forbidden sequence, in a NAL bitstream
+ *
+ * \param   kpBuf       bitstream buffer
+ * \param   kiBufSize   count size of buffer
+ *
+ * \return  offset of the triple, kiBufSize if there is none, so that the bytes before
+ *          it may be copied as they are
+ *************************************************************************************
+ */
+int32_t WelsFindNalSyntaxBytes_c (const uint8_t* kpBuf, const int32_t kiBufSize);
+#if defined(X86_ASM)
+int32_t WelsFindNalSyntaxBytes_sse2 (const uint8_t* kpBuf, const int32_t kiBufSize);
+#if defined(HAVE_AVX2)
+int32_t WelsFindNalSyntaxBytes_avx2 (const uint8_t* kpBuf, const int32_t kiBufSize);
+#endif//HAVE_AVX2
+#endif//X86_ASM
+#if defined(HAVE_NEON)
+int32_t WelsFindNalSyntaxBytes_neon (const uint8_t* kpBuf, const int32_t kiBufSize);
+#endif//HAVE_NEON
+#if defined(HAVE_NEON_AARCH64)
+int32_t WelsFindNalSyntaxBytes_AArch64_neon (const uint8_t* kpBuf, const int32_t kiBufSize);
+#endif//HAVE_NEON_AARCH64
+
+#if defined(__cplusplus)
+extern "C" {
+#endif//__cplusplus
+
+/*
+ * Scan the triples starting in [0, iScanSize), iScanSize being a multiple of the vector size, for the first one;
+ * return the offset of the vector it starts in, iScanSize if there is none. The 2 bytes past iScanSize are read.
+ */
+#if defined(X86_ASM)
+int32_t WelsScanNalSyntaxBytes_sse2 (const uint8_t* kpBuf, int32_t iScanSize);
+#if defined(HAVE_AVX2)
+int32_t WelsScanNalSyntaxBytes_avx2 (const uint8_t* kpBuf, int32_t iScanSize);
+#endif//HAVE_AVX2
+#endif//X86_ASM
+
+#if defined(HAVE_NEON)
+int32_t WelsScanNalSyntaxBytes_neon (const uint8_t* kpBuf, int32_t iScanSize);
+#endif//HAVE_NEON
+
+#if defined(HAVE_NEON_AARCH64)
+int32_t WelsScanNalSyntaxBytes_AArch64_neon (const uint8_t* kpBuf, int32_t iScanSize);
+#endif//HAVE_NEON_AARCH64
+
+#if defined(__cplusplus)
+}
+#endif//__cplusplus
+
+void WelsInitNalScanFunc (PFindNalSyntaxBytesFunc* ppfFindNalSyntaxBytes, uint32_t uiCpuFlag);
+
 /*!
  *************************************************************************************
  * \brief   Start Code Prefix (0x 00 00 00 01) detection
@@ -62,7 +117,8 @@ namespace WelsDec {
  * \note    N/A
  *************************************************************************************
  */
-uint8_t* DetectStartCodePrefix (const uint8_t* kpBuf, int32_t* pOffset, int32_t iBufSize);
+uint8_t* DetectStartCodePrefix (const uint8_t* kpBuf, int32_t* pOffset, int32_t iBufSize,
+                                PFindNalSyntaxBytesFunc pfFindNalSyntaxBytes);
 
 /*!
  *************************************************************************************
@@ -87,10 +87,15 @@ void WelsCabacContextInit (PWelsDecoderContext  pCtx, uint8_t eSliceType, int32_
 int32_t InitCabacDecEngineFromBS (PWelsCabacDecEngine pDecEngine, SBitStringAux* pBsAux);
 void RestoreCabacDecEngineToBS (PWelsCabacDecEngine pDecEngine, SBitStringAux* pBsAux);
 //3. actual decoding
-int32_t Read32BitsCabac (PWelsCabacDecEngine pDecEngine, uint32_t& uiValue, int32_t& iNumBitsRead);
 int32_t DecodeBinCabac (PWelsCabacDecEngine pDecEngine, PWelsCabacCtx pBinCtx, uint32_t& uiBit);
 int32_t DecodeBypassCabac (PWelsCabacDecEngine pDecEngine, uint32_t& uiBinVal);
 int32_t  DecodeTerminateCabac (PWelsCabacDecEngine pDecEngine, uint32_t& uiBinVal);
+//iNumBins (<= 16) bypass bins, first decoded bin in the most significant position of uiBins
+int32_t DecodeBypassBinsCabac (PWelsCabacDecEngine pDecEngine, int32_t iNumBins, uint32_t& uiBins);
+//significant_coeff_flag/last_significant_coeff_flag of one block, pMapCtxIdx/pLastCtxIdx NULL for ctxIdxInc == position
+int32_t DecodeSignificanceMapCabac (PWelsCabacDecEngine pDecEngine, PWelsCabacCtx pMapCtx, PWelsCabacCtx pLastCtx,
+                                    const uint8_t* pMapCtxIdx, const uint8_t* pLastCtxIdx, int32_t iMaxPos,
+                                    int32_t* pSignificantMap, uint32_t& uiCoeffNum);
 
 //4. unary parsing
 int32_t DecodeUnaryBinCabac (PWelsCabacDecEngine pDecEngine, PWelsCabacCtx pBinCtx, int32_t iCtxOffset,
@@ -103,6 +108,18 @@ int32_t DecodeUEGMvCabac (PWelsCabacDecEngine pDecEngine, PWelsCabacCtx pBinCtx,
 
 #define WELS_CABAC_HALF    0x01FE
 #define WELS_CABAC_QUARTER 0x0100
+#define WELS_CABAC_WINDOW_BITS 64 //width of uiOffset
+
+/*!
+ * \brief   number of left shifts bringing a range in [2, 510] back to [256, 510]
+ */
+static inline int32_t WelsCabacRenormBits (uint32_t uiRange) {
+#if defined(__GNUC__)
+  return __builtin_clz (uiRange) - 23;
+#else
+  return uiRange >= WELS_CABAC_QUARTER ? 0 : g_kRenormTable256[uiRange];
+#endif
+}
 #define WELS_CABAC_FALSE_RETURN(iErrorInfo) \
 if(iErrorInfo) { \
   return iErrorInfo; \
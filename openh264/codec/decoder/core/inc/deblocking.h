@@ -86,6 +86,31 @@ void WelsDeblockingInitFilter (PWelsDecoderContext pCtx, SDeblockingFilter& pFil
 void WelsDeblockingFilterMB (PDqLayer pCurDqLayer, SDeblockingFilter& pFilter, int32_t& iFilterIdc,
                              PDeblockingFilterMbFunc pDeblockMb);
 
+/*!
+* \brief   start deblocking the current slice one MB row behind its reconstruction
+*
+* \param   kbThreadedDecoding  frame threads: also pad the borders and set pDec->pReadyEvent of each final row
+*
+* \note    the slice is filtered on the context's worker thread when bDeblockingThread is set,
+*          otherwise inline from WelsDeblockingStageProgress()/WelsDeblockingStageEnd()
+*/
+void WelsDeblockingStageBegin (PWelsDecoderContext pCtx, const bool kbThreadedDecoding);
+
+/*!
+* \brief   report the number of MBs of the slice reconstructed so far, called as MB rows complete
+*/
+void WelsDeblockingStageProgress (PWelsDecoderContext pCtx, const int32_t kiReconMbNum);
+
+/*!
+* \brief   finish filtering the slice, returns once all kiReconMbNum MBs are filtered
+*/
+void WelsDeblockingStageEnd (PWelsDecoderContext pCtx, const int32_t kiReconMbNum);
+
+/*!
+* \brief   stop the deblocking worker thread of the context
+*/
+void WelsDeblockingStageUninit (PWelsDecoderContext pCtx);
+
 /*!
  * \brief   pixel deblocking filtering
  *
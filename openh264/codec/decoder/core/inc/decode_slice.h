@@ -58,8 +58,34 @@ int32_t WelsDecodeMbCabacBSliceBaseMode0 (PWelsDecoderContext pCtx, PWelsNeighAv
 int32_t WelsTargetSliceConstruction (PWelsDecoderContext pCtx); //construction based on slice
 
 int32_t WelsDecodeSlice (PWelsDecoderContext pCtx, bool bFirstSliceInLayer, PNalUnit pNalCur);
+int32_t WelsCalcDeqCoeffScalingList (PWelsDecoderContext pCtx);
 int32_t WelsDecodeAndConstructSlice (PWelsDecoderContext pCtx);
 
+/*!
+* \brief   queue the slice whose header was just decoded into pCtx->pCurDqLayer for parsing and reconstruction on the
+*          slice threads
+*
+* \return  false if the slice has to be decoded inline (slice threads off, FMO, SVC layer, parse only, slice order
+*          not ascending, PPS change, queue full); queued slices must be run and finished before that
+*/
+bool WelsSliceThreadsQueue (PWelsDecoderContext pCtx, PNalUnit pNalCur);
+
+/*!
+* \brief   parse and reconstruct the queued slices in parallel, results in their jobs
+*/
+void WelsSliceThreadsRun (PWelsDecoderContext pCtx);
+
+/*!
+* \brief   take a run slice over into the decoding context as WelsTargetSliceConstruction() leaves it: MB accounting
+*          and loop filter; to be called in queue order
+*/
+int32_t WelsSliceThreadsFinish (PWelsDecoderContext pCtx, PSliceJob pJob);
+
+/*!
+* \brief   stop the slice threads and free the queue of the context
+*/
+void WelsSliceThreadsUninit (PWelsDecoderContext pCtx);
+
 int32_t WelsTargetMbConstruction (PWelsDecoderContext pCtx);
 
 int32_t WelsMbIntraPredictionConstruction (PWelsDecoderContext pCtx, PDqLayer pCurDqLayer, bool bOutput);
@@ -57,6 +57,7 @@
 #include "mc.h"
 #include "memory_align.h"
 #include "wels_decoder_thread.h"
+#include "output_convert.h"
 
 namespace WelsDec {
 #define MAX_PRED_MODE_ID_I16x16  3
@@ -137,6 +138,7 @@ typedef struct TagPpsBsInfo {
 //typedef int32_t (*rec_mb) (Mb *cur_mb, PWelsDecoderContext pCtx);
 
 /*typedef for get intra predictor func pointer*/
+typedef int32_t (*PFindNalSyntaxBytesFunc) (const uint8_t* kpBuf, const int32_t kiBufSize);
 typedef void (*PGetIntraPredFunc) (uint8_t* pPred, const int32_t kiLumaStride);
 typedef void (*PIdctResAddPredFunc) (uint8_t* pPred, const int32_t kiStride, int16_t* pRs);
 typedef void (*PIdctFourResAddPredFunc) (uint8_t* pPred, int32_t iStride, int16_t* pRs, const int8_t* pNzc);
@@ -208,6 +210,75 @@ typedef struct TagDeblockingFunc {
 
 } SDeblockingFunc, *PDeblockingFunc;
 
+/*
+ *  SDeblockingStage: deblocking of the current slice running one MB row behind its reconstruction,
+ *  on an own worker thread when enabled (see WelsDeblockingStageBegin)
+ */
+typedef struct TagDeblockingStage {
+  SDqLayer            sDqLayer;         // copy of the slice layer, its MB cursors move independently of reconstruction
+  SDeblockingFilter   sFilter;
+  int32_t             iFilterIdc;
+  PFmo                pFmo;
+  bool                bFmo;             // slice groups, rows are not filled in order so filtering waits for the slice end
+  PPicture            pDec;
+  bool                bThreadedDecoding;// signal pDec->pReadyEvent of each filtered row
+  bool                bPadBorder;       // reference picture: pad the border of each row once it is final
+  int32_t             iFirstMbXy;
+  int32_t             iNextMbXy;
+  int32_t             iMbNum;           // MBs of the slice filtered so far
+  const SOutputConvertFunc* pOutputConvert; // convert each final row into pDec->pOutput, NULL for I420 output
+  bool                bOnWorker;        // current slice is filtered by the worker thread
+
+  volatile int32_t    iReconMbNum;      // MBs of the slice reconstructed so far
+  volatile int32_t    iSliceEnd;        // iReconMbNum is final
+
+  bool                bThreadCreated;
+  bool                bQuit;
+  SWelsDecThread      sThread;
+  SWelsDecSemphore    sSliceStart;
+  SWelsDecEvent       sProgress;
+  SWelsDecEvent       sSliceDone;
+} SDeblockingStage, *PDeblockingStage;
+
+#define MAX_SLICE_JOB_NUM 32 // slices kept waiting for the slice threads before the queue is run
+
+/*
+ *  SSliceJob: a slice of the current access unit, header decoded, waiting to be parsed and reconstructed on the slice
+ *  threads
+ */
+typedef struct TagSliceJob {
+  SDqLayer            sDqLayer;         // slice layer as set up by its header, own MB cursors
+  SRefPic             sRefPic;          // reference lists of the slice after reordering
+  bool                bRPLRError;       // the reordering failed, MBs referring to it are concealed
+  PNalUnit            pNalCur;
+  int32_t             iParseRet;        // result of the parsing
+  int32_t             iRet;             // result of the reconstruction
+} SSliceJob, *PSliceJob;
+
+struct TagSliceThreads;
+typedef struct TagSliceThreadWorker {
+  struct TagWelsDecoderContext* pCtx;  // slice-local state of the worker, the rest is bound from the decoding context
+  SWelsCabacDecEngine sCabacDecEngine;
+  struct TagSliceThreads*       pThreads;
+  SWelsDecThread      sThread;
+  SWelsDecSemphore    sStart;
+  SWelsDecEvent       sDone;
+} SSliceThreadWorker, *PSliceThreadWorker;
+
+/*
+ *  SSliceThreads: slices of an access unit parsed and reconstructed in parallel, accounted and deblocked in slice
+ *  order afterwards (see WelsSliceThreadsQueue). Worker 0 is the decoding thread itself.
+ */
+typedef struct TagSliceThreads {
+  int32_t             iThreadNum;       // decoding threads of the slices including the decoding thread, <= 1 disables
+  PSliceJob           pJobs;
+  int32_t             iJobNum;
+  volatile int32_t    iNextJob;
+  int32_t             iThreadCreatedNum;
+  bool                bQuit;
+  SSliceThreadWorker  sWorker[WELS_DEC_MAX_NUM_CPU];
+} SSliceThreads, *PSliceThreads;
+
 typedef void (*PWelsNonZeroCountFunc) (int8_t* pNonZeroCount);
 typedef void (*PWelsBlockZeroFunc) (int16_t* block, int32_t stride);
 typedef  struct  TagBlockFunc {
@@ -457,7 +528,16 @@ typedef struct TagWelsDecoderContext {
   SCopyFunc sCopyFunc;
   /* For Deblocking */
   SDeblockingFunc     sDeblockingFunc;
+  SDeblockingStage    sDeblockingStage;
+  bool                bDeblockingThread; // filter on a worker thread one MB row behind reconstruction
+  SSliceThreads       sSliceThreads;
+  const SDecoderFrameAllocator* pFrameAllocator; // application allocator of the picture buffers, NULL for internal memory
+  EVideoFormatType    eOutputFormat;    // pictures are converted into this format as their rows become final
+  SOutputConvertFunc  sOutputConvertFunc;
+  SDecoderScaledOutput sScaledOutput;   // output size, 0 x 0 unless the output is scaled
+  PFindNalSyntaxBytesFunc pfFindNalSyntaxBytes; // start code and emulation prevention scan of WelsDecodeBs()
   SExpandPicFunc      sExpandPicFunc;
+  bool                bLazyBorderExpansion; // reference borders are left unpadded, MC emulates the picture edge
 
   /* For Block */
   SBlockFunc          sBlockFunc;
@@ -476,6 +556,8 @@ typedef struct TagWelsDecoderContext {
   int32_t iFeedbackNalRefIdc;
 
   bool bAuReadyFlag;   // true: one au is ready for decoding; false: default value
+  EDecoderSkipFrames eSkipFrames;   // pictures whose slices are dropped in ParseNalHeader()
+  bool bSkipCurrentPic;             // the slices of the current picture are dropped
 
   bool bPrintFrameErrorTraceFlag; //true: can print info for upper layer
   int32_t iIgnoredErrorInfoPacketCount; //store the packet number with error decoding info
@@ -484,12 +566,13 @@ typedef struct TagWelsDecoderContext {
 
   PWelsLastDecPicInfo pLastDecPicInfo;
 
-  SWelsCabacCtx sWelsCabacContexts[4][WELS_QP_MAX + 1][WELS_CONTEXT_COUNT];
+  const SWelsCabacCtx (*pCabacInitContexts)[WELS_QP_MAX + 1][WELS_CONTEXT_COUNT]; // [4], shared by all decoders
   bool bCabacInited;
   SWelsCabacCtx   pCabacCtx[WELS_CONTEXT_COUNT];
   PWelsCabacDecEngine   pCabacDecEngine;
   double dDecTime;
   SDecoderStatistics* pDecoderStatistics; // For real time debugging
+  uint32_t* pSkippedFrameCount; // pictures dropped by eSkipFrames, shared by the decoding threads like the statistics
   int32_t iMbEcedNum;
   int32_t iMbEcedPropNum;
   int32_t iMbNum;
@@ -525,6 +608,7 @@ typedef struct tagSWelsDecThread {
   uint32_t uiThrNum;
   uint32_t uiThrMaxNum;
   uint32_t uiThrStackSize;
+  int32_t iAffinityCpu; // logical processor the thread is pinned to, -1 for no pinning
   DECLARE_PROCTHREAD_PTR (pThrProcMain);
 } SWelsDecThreadInfo, *PWelsDecThreadInfo;
 
@@ -541,6 +625,7 @@ typedef struct tagSWelsDecThreadCtx {
   SWelsDecEvent sSliceDecodeStart;
   SWelsDecEvent sSliceDecodeFinish;
   int32_t       iPicBuffIdx; //picBuff Index
+  bool          bLowLatencyOutput; //picture is returned once sImageReady is set instead of being buffered
 } SWelsDecoderThreadCTX, *PWelsDecoderThreadCTX;
 
 static inline void ResetActiveSPSForEachLayer (PWelsDecoderContext pCtx) {
@@ -0,0 +1,156 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ *
+ * \file    output_convert.h
+ *
+ * \brief   I420 to packed RGB / NV12 conversion and scaling of the decoder output
+ *
+ * \date    10/16/2026 Created
+ *
+ *************************************************************************************
+ */
+
+#ifndef WELS_OUTPUT_CONVERT_H__
+#define WELS_OUTPUT_CONVERT_H__
+
+#include "typedefs.h"
+#include "picture.h"
+#include "downsample_common.h"
+
+namespace WelsDec {
+
+/*
+ * Converters read each chroma sample once for its 2x2 luma block. iWidth and iHeight must be even.
+ */
+typedef void (*PI420ToPackedRgbFunc) (uint8_t* pDst, int32_t iDstStride, const uint8_t* kpSrcY,
+                                      const uint8_t* kpSrcU, const uint8_t* kpSrcV, int32_t iSrcStrideY,
+                                      int32_t iSrcStrideUV, int32_t iWidth, int32_t iHeight);
+typedef void (*PI420ToNv12Func) (uint8_t* pDstY, uint8_t* pDstUV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                                 const uint8_t* kpSrcY, const uint8_t* kpSrcU, const uint8_t* kpSrcV,
+                                 int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth, int32_t iHeight);
+
+typedef struct TagOutputConvertFunc {
+  PI420ToPackedRgbFunc  pfI420ToBgr;
+  PI420ToPackedRgbFunc  pfI420ToRgba;
+  PI420ToNv12Func       pfI420ToNv12;
+  PGeneralBilinearDownsampleRowsFunc pfScaleRows;
+} SOutputConvertFunc;
+
+void WelsI420ToBgr_c (uint8_t* pDst, int32_t iDstStride, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+                      const uint8_t* kpSrcV, int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth, int32_t iHeight);
+void WelsI420ToRgba_c (uint8_t* pDst, int32_t iDstStride, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+                       const uint8_t* kpSrcV, int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth, int32_t iHeight);
+void WelsI420ToNv12_c (uint8_t* pDstY, uint8_t* pDstUV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                       const uint8_t* kpSrcY, const uint8_t* kpSrcU, const uint8_t* kpSrcV, int32_t iSrcStrideY,
+                       int32_t iSrcStrideUV, int32_t iWidth, int32_t iHeight);
+
+#if defined(X86_ASM)
+void WelsI420ToBgr_sse2 (uint8_t* pDst, int32_t iDstStride, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+                         const uint8_t* kpSrcV, int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth,
+                         int32_t iHeight);
+void WelsI420ToRgba_sse2 (uint8_t* pDst, int32_t iDstStride, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+                          const uint8_t* kpSrcV, int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth,
+                          int32_t iHeight);
+void WelsI420ToNv12_sse2 (uint8_t* pDstY, uint8_t* pDstUV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                          const uint8_t* kpSrcY, const uint8_t* kpSrcU, const uint8_t* kpSrcV, int32_t iSrcStrideY,
+                          int32_t iSrcStrideUV, int32_t iWidth, int32_t iHeight);
+#if defined(HAVE_AVX2)
+void WelsI420ToBgr_avx2 (uint8_t* pDst, int32_t iDstStride, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+                         const uint8_t* kpSrcV, int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth,
+                         int32_t iHeight);
+void WelsI420ToRgba_avx2 (uint8_t* pDst, int32_t iDstStride, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+                          const uint8_t* kpSrcV, int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth,
+                          int32_t iHeight);
+void WelsI420ToNv12_avx2 (uint8_t* pDstY, uint8_t* pDstUV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                          const uint8_t* kpSrcY, const uint8_t* kpSrcU, const uint8_t* kpSrcV, int32_t iSrcStrideY,
+                          int32_t iSrcStrideUV, int32_t iWidth, int32_t iHeight);
+#endif//HAVE_AVX2
+#endif//X86_ASM
+
+#if defined(__cplusplus)
+extern "C" {
+#endif//__cplusplus
+
+#if defined(X86_ASM)
+void WelsI420ToBgrRow_sse2 (uint8_t* pDst, const uint8_t* kpSrcY, const uint8_t* kpSrcU, const uint8_t* kpSrcV,
+                            int32_t iWidth);
+void WelsI420ToRgbaRow_sse2 (uint8_t* pDst, const uint8_t* kpSrcY, const uint8_t* kpSrcU, const uint8_t* kpSrcV,
+                             int32_t iWidth);
+void WelsInterleaveUVRow_sse2 (uint8_t* pDstUV, const uint8_t* kpSrcU, const uint8_t* kpSrcV, int32_t iWidthUV);
+
+#if defined(HAVE_AVX2)
+void WelsI420ToBgrRow_avx2 (uint8_t* pDst, const uint8_t* kpSrcY, const uint8_t* kpSrcU, const uint8_t* kpSrcV,
+                            int32_t iWidth);
+void WelsI420ToRgbaRow_avx2 (uint8_t* pDst, const uint8_t* kpSrcY, const uint8_t* kpSrcU, const uint8_t* kpSrcV,
+                             int32_t iWidth);
+void WelsInterleaveUVRow_avx2 (uint8_t* pDstUV, const uint8_t* kpSrcU, const uint8_t* kpSrcV, int32_t iWidthUV);
+#endif//HAVE_AVX2
+#endif//X86_ASM
+
+#if defined(__cplusplus)
+}
+#endif//__cplusplus
+
+void WelsInitOutputConvertFunc (SOutputConvertFunc* pFuncList, uint32_t uiCpuFlag);
+
+/*!
+ * \brief   whether the decoder can output pictures in kiFormat
+ */
+bool WelsIsOutputFormatSupported (const int32_t kiFormat);
+
+/*!
+ * \brief   bytes of the converted or scaled output of pPic, sets the strides of its planes
+ *
+ * \return  0 for I420 output, which is read from the picture itself
+ */
+int32_t WelsOutputBufferSize (PPicture pPic);
+
+/*!
+ * \brief   point the output planes of pPic into pBuffer of WelsOutputBufferSize() bytes
+ */
+void WelsBindOutputBuffer (PPicture pPic, uint8_t* pBuffer);
+
+/*!
+ * \brief   convert MB row kiMbY of pPic into its output once the rows above are converted
+ *
+ * \note    rows are converted in order only, rows skipped here are left to WelsConvertOutputRows()
+ */
+void WelsConvertOutputRow (const SOutputConvertFunc* pFunc, PPicture pPic, const int32_t kiMbY);
+
+/*!
+ * \brief   convert the MB rows of pPic not converted yet, up to kiEndMbY exclusive
+ */
+void WelsConvertOutputRows (const SOutputConvertFunc* pFunc, PPicture pPic, const int32_t kiEndMbY);
+
+} // namespace WelsDec
+
+#endif//WELS_OUTPUT_CONVERT_H__
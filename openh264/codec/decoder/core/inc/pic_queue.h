@@ -56,6 +56,7 @@ PPicture PrefetchPic (PPicBuff pPicBuff);  // To get current node applicable
 PPicture PrefetchPicForThread (PPicBuff pPicBuff); // To get current node applicable in the case of threaded mode
 PPicture PrefetchLastPicForThread (PPicBuff pPicBuff,
                                    const int32_t& iLast); // To get last node applicable in the case of threaded mode
+void* PicBuffUserFrame (PPicBuff pPicBuff, const uint8_t* kpDst); // application handle of the buffer holding kpDst
 
 } // namespace WelsDec
 
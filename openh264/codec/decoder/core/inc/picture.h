@@ -36,8 +36,10 @@
 
 #include "typedefs.h"
 #include "wels_common_defs.h"
+#include "wels_common_basis.h"
 #include "wels_const_common.h"
 #include "wels_decoder_thread.h"
+#include "codec_app_def.h"
 
 using namespace WelsCommon;
 
@@ -54,6 +56,16 @@ struct SPicture {
   uint8_t*        pData[4];               // pointer to picture planes respectively
   int32_t         iLinesize[4];// linesize of picture planes respectively used currently
   int32_t         iPlanes;                        // How many planes are introduced due to color space format?
+  const SDecoderFrameAllocator* pFrameAllocator;  // application allocator of pOutput[0] or else pBuffer[0], NULL for internal memory
+  void*           pUserFrame;             // application handle of the output buffer when pFrameAllocator is set
+  EVideoFormatType eOutputFormat;         // output format other than videoFormatI420 is converted into pOutput
+  int32_t         iOutputWidth;           // scaled I420 output size, 0 for none
+  int32_t         iOutputHeight;
+  uint8_t*        pOutput[3];             // converted output planes, pOutput[0] is the buffer; NULL for I420 output
+  int32_t         iOutputStride[2];
+  int32_t         iOutputMbRows;          // MB rows of pData converted into pOutput so far
+  int32_t         iScaledRows[2];         // luma and chroma rows of the scaled output produced so far
+  SPosOffset      sOutputCrop;            // cropping of the picture being decoded, the scaled output covers the cropped area
 // picture information
 
   /*******************************from EC mv copy****************************/
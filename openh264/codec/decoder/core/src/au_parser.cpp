@@ -45,6 +45,7 @@
 #include "decoder_core.h"
 #include "bit_stream.h"
 #include "memory_align.h"
+#include "cpu_core.h"
 
 #define _PARSE_NALHRD_VCLHRD_PARAMS_ 1
 
@@ -63,29 +64,132 @@ namespace WelsDec {
  * \note    N/A
  *************************************************************************************
  */
-uint8_t* DetectStartCodePrefix (const uint8_t* kpBuf, int32_t* pOffset, int32_t iBufSize) {
-  uint8_t* pBits = (uint8_t*)kpBuf;
+uint8_t* DetectStartCodePrefix (const uint8_t* kpBuf, int32_t* pOffset, int32_t iBufSize,
+                                PFindNalSyntaxBytesFunc pfFindNalSyntaxBytes) {
+  int32_t iIdx = 0;
 
-  do {
-    int32_t iIdx = 0;
-    while ((iIdx < iBufSize) && (! (*pBits))) {
-      ++ pBits;
-      ++ iIdx;
+  while (iIdx + 2 < iBufSize) {
+    iIdx += pfFindNalSyntaxBytes (kpBuf + iIdx, iBufSize - iIdx);
+    if (iIdx + 2 >= iBufSize)
+      break;
+    if (kpBuf[iIdx + 2] == 0x1) {
+      *pOffset = iIdx + 3;
+      return (uint8_t*)kpBuf + iIdx + 3;
     }
-    if (iIdx >= iBufSize)  break;
+    ++ iIdx; // 0x 00 00 00 may still end a longer prefix
+  }
 
-    ++ iIdx;
-    ++ pBits;
+  return NULL;
+}
 
-    if ((iIdx >= 3) && ((* (pBits - 1)) == 0x1)) {
-      *pOffset = (int32_t) (((uintptr_t)pBits) - ((uintptr_t)kpBuf));
-      return pBits;
+// whether any byte of a 64 bit word is zero
+#define HAS_ZERO_BYTE(x) (((x) - 0x0101010101010101ULL) & ~(x) & 0x8080808080808080ULL)
+
+int32_t WelsFindNalSyntaxBytes_c (const uint8_t* kpBuf, const int32_t kiBufSize) {
+  int32_t i = 0;
+  // a triple starts with two zero bytes, so 8 bytes without a zero byte hold none of its first byte
+  while (i + 9 < kiBufSize) {
+    uint64_t uiWord;
+    memcpy (&uiWord, kpBuf + i, sizeof (uiWord));
+    if (!HAS_ZERO_BYTE (uiWord)) {
+      i += 8;
+      continue;
+    }
+    for (const int32_t kiEnd = i + 8; i < kiEnd; ++i) {
+      if (kpBuf[i] == 0 && kpBuf[i + 1] == 0 && kpBuf[i + 2] <= 0x03)
+        return i;
     }
+  }
+  for (; i + 2 < kiBufSize; ++i) {
+    if (kpBuf[i] == 0 && kpBuf[i + 1] == 0 && kpBuf[i + 2] <= 0x03)
+      return i;
+  }
+  return kiBufSize;
+}
 
-    iBufSize -= iIdx;
-  }  while (1);
+#if defined(X86_ASM) || defined(HAVE_NEON) || defined(HAVE_NEON_AARCH64)
+typedef int32_t (*PScanNalSyntaxBytesFunc) (const uint8_t* kpBuf, int32_t iScanSize);
+
+// pfScan finds the kiAlign byte block of the first triple, the C code its offset within the block or the tail
+template<int32_t kiAlign>
+static inline int32_t FindNalSyntaxBytesSimd (PScanNalSyntaxBytesFunc pfScan, const uint8_t* kpBuf,
+    const int32_t kiBufSize) {
+  const int32_t kiScanSize = (kiBufSize - 2) & (~ (kiAlign - 1));
+  int32_t i = 0;
+  if (kiScanSize > 0)
+    i = pfScan (kpBuf, kiScanSize);
+  return i + WelsFindNalSyntaxBytes_c (kpBuf + i, kiBufSize - i);
+}
+#endif
 
-  return NULL;
+#if defined(X86_ASM)
+int32_t WelsFindNalSyntaxBytes_sse2 (const uint8_t* kpBuf, const int32_t kiBufSize) {
+  return FindNalSyntaxBytesSimd<16> (WelsScanNalSyntaxBytes_sse2, kpBuf, kiBufSize);
+}
+
+#if defined(HAVE_AVX2)
+int32_t WelsFindNalSyntaxBytes_avx2 (const uint8_t* kpBuf, const int32_t kiBufSize) {
+  return FindNalSyntaxBytesSimd<32> (WelsScanNalSyntaxBytes_avx2, kpBuf, kiBufSize);
+}
+#endif//HAVE_AVX2
+#endif//X86_ASM
+
+#if defined(HAVE_NEON)
+int32_t WelsFindNalSyntaxBytes_neon (const uint8_t* kpBuf, const int32_t kiBufSize) {
+  return FindNalSyntaxBytesSimd<16> (WelsScanNalSyntaxBytes_neon, kpBuf, kiBufSize);
+}
+#endif//HAVE_NEON
+
+#if defined(HAVE_NEON_AARCH64)
+int32_t WelsFindNalSyntaxBytes_AArch64_neon (const uint8_t* kpBuf, const int32_t kiBufSize) {
+  return FindNalSyntaxBytesSimd<16> (WelsScanNalSyntaxBytes_AArch64_neon, kpBuf, kiBufSize);
+}
+#endif//HAVE_NEON_AARCH64
+
+void WelsInitNalScanFunc (PFindNalSyntaxBytesFunc* ppfFindNalSyntaxBytes, uint32_t uiCpuFlag) {
+  *ppfFindNalSyntaxBytes = WelsFindNalSyntaxBytes_c;
+#if defined(X86_ASM)
+  if (uiCpuFlag & WELS_CPU_SSE2)
+    *ppfFindNalSyntaxBytes = WelsFindNalSyntaxBytes_sse2;
+#if defined(HAVE_AVX2)
+  if (uiCpuFlag & WELS_CPU_AVX2)
+    *ppfFindNalSyntaxBytes = WelsFindNalSyntaxBytes_avx2;
+#endif//HAVE_AVX2
+#endif//X86_ASM
+#if defined(HAVE_NEON)
+  if (uiCpuFlag & WELS_CPU_NEON)
+    *ppfFindNalSyntaxBytes = WelsFindNalSyntaxBytes_neon;
+#endif//HAVE_NEON
+#if defined(HAVE_NEON_AARCH64)
+  if (uiCpuFlag & WELS_CPU_NEON)
+    *ppfFindNalSyntaxBytes = WelsFindNalSyntaxBytes_AArch64_neon;
+#endif//HAVE_NEON_AARCH64
+}
+
+/*
+ * Whether the slice NAL at pNal, past its NAL header, belongs to a picture DECODER_OPTION_SKIP_FRAMES drops.
+ * Only first_mb_in_slice and slice_type are read, a picture is counted as dropped at its first slice.
+ */
+static bool IsSliceNalSkipped (PWelsDecoderContext pCtx, const SNalUnitHeader* kpNalUnitHeader, const uint8_t* kpNal,
+                               const int32_t kiNalSize) {
+  SBitStringAux sBs;
+  uint32_t uiFirstMb = 0, uiSliceType = 0;
+  if (pCtx->eSkipFrames == DECODER_SKIP_NONE || kpNalUnitHeader->eNalUnitType == NAL_UNIT_CODED_SLICE_IDR) {
+    pCtx->bSkipCurrentPic = false;
+    return false;
+  }
+  // broken headers are left to ParseSliceHeaderSyntaxs() to report
+  if (kiNalSize <= 0 || DecInitBits (&sBs, kpNal, kiNalSize << 3) != ERR_NONE || BsGetUe (&sBs, &uiFirstMb) != ERR_NONE
+      || BsGetUe (&sBs, &uiSliceType) != ERR_NONE)
+    return false;
+  if (uiFirstMb == 0 || pCtx->eSkipFrames == DECODER_SKIP_NON_REF) {
+    const bool kbSkipped = pCtx->eSkipFrames == DECODER_SKIP_NON_REF ? kpNalUnitHeader->uiNalRefIdc == 0 :
+                           (uiSliceType % 5 != I_SLICE && uiSliceType % 5 != SI_SLICE);
+    if (uiFirstMb == 0 && kbSkipped)
+      (*pCtx->pSkippedFrameCount)++;
+    pCtx->bSkipCurrentPic = kbSkipped;
+  }
+  return pCtx->bSkipCurrentPic;
 }
 
 /*!
@@ -268,6 +372,16 @@ uint8_t* ParseNalHeader (PWelsDecoderContext pCtx, SNalUnitHeader* pNalUnitHeade
   case NAL_UNIT_CODED_SLICE_IDR: {
     PAccessUnit pCurAu = NULL;
     uint32_t uiAvailNalNum;
+    if (IsSliceNalSkipped (pCtx, pNalUnitHeader, pNal + (bExtensionFlag ? NAL_UNIT_HEADER_EXT_SIZE : 0),
+                           iNalSize - (bExtensionFlag ? NAL_UNIT_HEADER_EXT_SIZE : 0))) {
+      // handled like a non VCL NAL, a picture pending in the AU list is over
+      pNalUnitHeader->eNalUnitType = NAL_UNIT_UNSPEC_0;
+      if (pCtx->pAccessUnitList->uiAvailUnitsNum > 0) {
+        pCtx->pAccessUnitList->uiEndPos = pCtx->pAccessUnitList->uiAvailUnitsNum - 1;
+        pCtx->bAuReadyFlag = true;
+      }
+      break;
+    }
     pCurNal = MemGetNextNal (&pCtx->pAccessUnitList, pCtx->pMemAlign);
     if (NULL == pCurNal) {
       WelsLog (pLogCtx, WELS_LOG_ERROR, "MemGetNextNal() fail due out of memory.");
@@ -34,7 +34,11 @@
 namespace WelsDec {
 static const int16_t g_kMvdBinPos2Ctx [8] = {0, 1, 2, 3, 3, 3, 3, 3};
 
-void WelsCabacGlobalInit (PWelsDecoderContext pCtx) {
+// initial states of all cabac_init_idc/QP combinations, the same for every decoder in the process
+static SWelsCabacCtx s_sWelsCabacContexts[4][WELS_QP_MAX + 1][WELS_CONTEXT_COUNT];
+static volatile int32_t s_iCabacContextsState = 0; // 0: not built, 1: under construction, 2: ready
+
+static void BuildCabacInitContexts() {
   for (int32_t iModel = 0; iModel < 4; iModel++) {
     for (int32_t iQp = 0; iQp <= WELS_QP_MAX; iQp++)
       for (int32_t iIdx = 0; iIdx < WELS_CONTEXT_COUNT; iIdx++) {
@@ -50,10 +54,22 @@ void WelsCabacGlobalInit (PWelsDecoderContext pCtx) {
           uiStateIdx = iPreCtxState - 64;
           uiValMps = 1;
         }
-        pCtx->sWelsCabacContexts[iModel][iQp][iIdx].uiState = uiStateIdx;
-        pCtx->sWelsCabacContexts[iModel][iQp][iIdx].uiMPS = uiValMps;
+        s_sWelsCabacContexts[iModel][iQp][iIdx].uiState = uiStateIdx;
+        s_sWelsCabacContexts[iModel][iQp][iIdx].uiMPS = uiValMps;
       }
   }
+}
+
+void WelsCabacGlobalInit (PWelsDecoderContext pCtx) {
+  if (WelsAtomicCas (&s_iCabacContextsState, 0, 1)) {
+    BuildCabacInitContexts();
+    WelsAtomicStore (&s_iCabacContextsState, 2);
+  } else {
+    while (WelsAtomicLoad (&s_iCabacContextsState) != 2) {
+      WelsSleep (0); // another decoder builds the table right now
+    }
+  }
+  pCtx->pCabacInitContexts = s_sWelsCabacContexts;
   pCtx->bCabacInited = true;
 }
 
@@ -63,7 +79,7 @@ void WelsCabacContextInit (PWelsDecoderContext  pCtx, uint8_t eSliceType, int32_
   if (!pCtx->bCabacInited) {
     WelsCabacGlobalInit (pCtx);
   }
-  memcpy (pCtx->pCabacCtx, pCtx->sWelsCabacContexts[iIdx][iQp],
+  memcpy (pCtx->pCabacCtx, pCtx->pCabacInitContexts[iIdx][iQp],
           WELS_CONTEXT_COUNT * sizeof (SWelsCabacCtx));
 }
 
@@ -102,115 +118,168 @@ void RestoreCabacDecEngineToBS (PWelsCabacDecEngine pDecEngine, PBitStringAux pB
 }
 
 // ------------------- 3. actual decoding
-int32_t Read32BitsCabac (PWelsCabacDecEngine pDecEngine, uint32_t& uiValue, int32_t& iNumBitsRead) {
+/*!
+ * \brief   refill the 64-bit offset window with as many whole bytes as fit
+ *          (at most 7 while iBitsLeft <= 0, i.e. 48 to 56 new bits)
+ * \return  ERR_NONE if at least one byte was read
+ */
+static inline int32_t RefillCabac (PWelsCabacDecEngine pDecEngine) {
   intX_t iLeftBytes = pDecEngine->pBuffEnd - pDecEngine->pBuffCurr;
-  iNumBitsRead = 0;
-  uiValue = 0;
+  int32_t iNumBytes = (WELS_CABAC_WINDOW_BITS - 9 - pDecEngine->iBitsLeft) >> 3;
+  uint8_t* pCurr = pDecEngine->pBuffCurr;
+  uint64_t uiOffset = pDecEngine->uiOffset;
   if (iLeftBytes <= 0) {
     return GENERATE_ERROR_NO (ERR_LEVEL_MB_DATA, ERR_CABAC_NO_BS_TO_READ);
   }
-  switch (iLeftBytes) {
-  case 3:
-    uiValue = ((pDecEngine->pBuffCurr[0]) << 16 | (pDecEngine->pBuffCurr[1]) << 8 | (pDecEngine->pBuffCurr[2]));
-    pDecEngine->pBuffCurr += 3;
-    iNumBitsRead = 24;
-    break;
-  case 2:
-    uiValue = ((pDecEngine->pBuffCurr[0]) << 8 | (pDecEngine->pBuffCurr[1]));
-    pDecEngine->pBuffCurr += 2;
-    iNumBitsRead = 16;
-    break;
-  case 1:
-    uiValue = pDecEngine->pBuffCurr[0];
-    pDecEngine->pBuffCurr += 1;
-    iNumBitsRead = 8;
-    break;
-  default:
-    uiValue = ((pDecEngine->pBuffCurr[0] << 24) | (pDecEngine->pBuffCurr[1]) << 16 | (pDecEngine->pBuffCurr[2]) << 8 |
-               (pDecEngine->pBuffCurr[3]));
-    pDecEngine->pBuffCurr += 4;
-    iNumBitsRead = 32;
-    break;
+  if (iLeftBytes >= 8) {
+    uint64_t uiValue = ((uint64_t)pCurr[0] << 56) | ((uint64_t)pCurr[1] << 48) | ((uint64_t)pCurr[2] << 40) |
+                       ((uint64_t)pCurr[3] << 32) | ((uint64_t)pCurr[4] << 24) | ((uint64_t)pCurr[5] << 16) |
+                       ((uint64_t)pCurr[6] << 8) | (uint64_t)pCurr[7];
+    uiOffset = (uiOffset << (iNumBytes << 3)) | (uiValue >> (64 - (iNumBytes << 3)));
+  } else {
+    iNumBytes = WELS_MIN (iNumBytes, (int32_t)iLeftBytes);
+    for (int32_t i = 0; i < iNumBytes; i++)
+      uiOffset = (uiOffset << 8) | pCurr[i];
   }
+  pDecEngine->uiOffset = uiOffset;
+  pDecEngine->pBuffCurr = pCurr + iNumBytes;
+  pDecEngine->iBitsLeft += iNumBytes << 3;
   return ERR_NONE;
 }
 
-int32_t DecodeBinCabac (PWelsCabacDecEngine pDecEngine, PWelsCabacCtx pBinCtx, uint32_t& uiBinVal) {
-  int32_t iErrorInfo = ERR_NONE;
+/*!
+ * \brief   decode one context coded bin without branching on MPS/LPS;
+ *          the renormalization shift is a leading zero count of the new range
+ */
+static inline int32_t DecodeDecisionBin (PWelsCabacDecEngine pDecEngine, PWelsCabacCtx pBinCtx, uint32_t& uiBinVal) {
   uint32_t uiState = pBinCtx->uiState;
-  uiBinVal = pBinCtx->uiMPS;
-  uint64_t uiOffset = pDecEngine->uiOffset;
+  uint32_t uiMps = pBinCtx->uiMPS;
   uint64_t uiRange = pDecEngine->uiRange;
+  uint64_t uiOffset = pDecEngine->uiOffset;
+  int32_t iBitsLeft = pDecEngine->iBitsLeft;
 
-  int32_t iRenorm = 1;
-  uint32_t uiRangeLPS = g_kuiCabacRangeLps[uiState][ (uiRange >> 6) & 0x03];
-  uiRange -= uiRangeLPS;
-  if (uiOffset >= (uiRange << pDecEngine->iBitsLeft)) { //LPS
-    uiOffset -= (uiRange << pDecEngine->iBitsLeft);
-    uiBinVal ^= 0x0001;
-    if (!uiState)
-      pBinCtx->uiMPS ^= 0x01;
-    pBinCtx->uiState = g_kuiStateTransTable[uiState][0];
-    iRenorm = g_kRenormTable256[uiRangeLPS];
-    uiRange = (uiRangeLPS << iRenorm);
-  } else {  //MPS
-    pBinCtx->uiState = g_kuiStateTransTable[uiState][1];
-    if (uiRange >= WELS_CABAC_QUARTER) {
-      pDecEngine->uiRange = uiRange;
-      return ERR_NONE;
-    } else {
-      uiRange <<= 1;
-    }
-  }
-  //Renorm
-  pDecEngine->uiRange = uiRange;
-  pDecEngine->iBitsLeft -= iRenorm;
-  if (pDecEngine->iBitsLeft > 0) {
-    pDecEngine->uiOffset = uiOffset;
+  uint64_t uiRangeLps = g_kuiCabacRangeLps[uiState][ (uiRange >> 6) & 0x03];
+  uiRange -= uiRangeLps;
+  uint64_t uiScaledRange = uiRange << iBitsLeft;
+  uint64_t uiLpsMask = 0 - (uint64_t) (uiOffset >= uiScaledRange); //all ones for LPS
+  uint32_t uiLps = (uint32_t)uiLpsMask & 0x01;
+  uiOffset -= uiScaledRange & uiLpsMask;
+  uiRange ^= (uiRange ^ uiRangeLps) & uiLpsMask;
+  uiBinVal = uiMps ^ uiLps;
+  pBinCtx->uiMPS = (uint8_t) (uiMps ^ (uiLps & (uiState == 0)));
+  pBinCtx->uiState = g_kuiStateTransTable[uiState][uiLps ^ 0x01];
+
+  int32_t iRenorm = WelsCabacRenormBits ((uint32_t)uiRange);
+  pDecEngine->uiRange = uiRange << iRenorm;
+  pDecEngine->uiOffset = uiOffset;
+  iBitsLeft -= iRenorm;
+  pDecEngine->iBitsLeft = iBitsLeft;
+  if (iBitsLeft > 0) {
     return ERR_NONE;
   }
-  uint32_t uiVal = 0;
-  int32_t iNumBitsRead = 0;
-  iErrorInfo = Read32BitsCabac (pDecEngine, uiVal, iNumBitsRead);
-  pDecEngine->uiOffset = (uiOffset << iNumBitsRead) | uiVal;
-  pDecEngine->iBitsLeft += iNumBitsRead;
+  int32_t iErrorInfo = RefillCabac (pDecEngine);
   if (iErrorInfo && pDecEngine->iBitsLeft < 0) {
     return iErrorInfo;
   }
   return ERR_NONE;
 }
 
-int32_t DecodeBypassCabac (PWelsCabacDecEngine pDecEngine, uint32_t& uiBinVal) {
-  int32_t iErrorInfo = ERR_NONE;
-  int32_t iBitsLeft = pDecEngine->iBitsLeft;
-  uint64_t uiOffset = pDecEngine->uiOffset;
-  uint64_t uiRangeValue;
-
+int32_t DecodeBinCabac (PWelsCabacDecEngine pDecEngine, PWelsCabacCtx pBinCtx, uint32_t& uiBinVal) {
+  return DecodeDecisionBin (pDecEngine, pBinCtx, uiBinVal);
+}
 
-  if (iBitsLeft <= 0) {
-    uint32_t uiVal = 0;
-    int32_t iNumBitsRead = 0;
-    iErrorInfo = Read32BitsCabac (pDecEngine, uiVal, iNumBitsRead);
-    uiOffset = (uiOffset << iNumBitsRead) | uiVal;
-    iBitsLeft = iNumBitsRead;
-    if (iErrorInfo && iBitsLeft == 0) {
+static inline int32_t DecodeBypassBin (PWelsCabacDecEngine pDecEngine, uint32_t& uiBinVal) {
+  if (pDecEngine->iBitsLeft <= 0) {
+    int32_t iErrorInfo = RefillCabac (pDecEngine);
+    if (iErrorInfo && pDecEngine->iBitsLeft <= 0) {
       return iErrorInfo;
     }
   }
-  iBitsLeft--;
-  uiRangeValue = (pDecEngine->uiRange << iBitsLeft);
-  if (uiOffset >= uiRangeValue) {
-    pDecEngine->iBitsLeft = iBitsLeft;
-    pDecEngine->uiOffset = uiOffset - uiRangeValue;
-    uiBinVal = 1;
+  int32_t iBitsLeft = --pDecEngine->iBitsLeft;
+  uint64_t uiScaledRange = pDecEngine->uiRange << iBitsLeft;
+  uint64_t uiOneMask = 0 - (uint64_t) (pDecEngine->uiOffset >= uiScaledRange);
+  pDecEngine->uiOffset -= uiScaledRange & uiOneMask;
+  uiBinVal = (uint32_t)uiOneMask & 0x01;
+  return ERR_NONE;
+}
+
+int32_t DecodeBypassCabac (PWelsCabacDecEngine pDecEngine, uint32_t& uiBinVal) {
+  return DecodeBypassBin (pDecEngine, uiBinVal);
+}
+
+int32_t DecodeBypassBinsCabac (PWelsCabacDecEngine pDecEngine, int32_t iNumBins, uint32_t& uiBins) {
+  uiBins = 0;
+  if (pDecEngine->iBitsLeft < iNumBins) {
+    RefillCabac (pDecEngine);
+  }
+  if (pDecEngine->iBitsLeft < iNumBins) { //tail of the slice data, keep the per bin error handling
+    uint32_t uiCode;
+    while (iNumBins--) {
+      WELS_READ_VERIFY (DecodeBypassBin (pDecEngine, uiCode));
+      uiBins = (uiBins << 1) | uiCode;
+    }
     return ERR_NONE;
   }
-  pDecEngine->iBitsLeft = iBitsLeft;
+  uint64_t uiRange = pDecEngine->uiRange;
+  uint64_t uiOffset = pDecEngine->uiOffset;
+  int32_t iBitsLeft = pDecEngine->iBitsLeft;
+  uint32_t uiValue = 0;
+  while (iNumBins--) {
+    uint64_t uiScaledRange = uiRange << (--iBitsLeft);
+    uint64_t uiOneMask = 0 - (uint64_t) (uiOffset >= uiScaledRange);
+    uiOffset -= uiScaledRange & uiOneMask;
+    uiValue = (uiValue << 1) | ((uint32_t)uiOneMask & 0x01);
+  }
   pDecEngine->uiOffset = uiOffset;
-  uiBinVal = 0;
+  pDecEngine->iBitsLeft = iBitsLeft;
+  uiBins = uiValue;
+  return ERR_NONE;
+}
+
+template<bool kbCtxIdxTable>
+static inline int32_t DecodeSignificanceMap (PWelsCabacDecEngine pDecEngine, PWelsCabacCtx pMapCtx,
+    PWelsCabacCtx pLastCtx, const uint8_t* pMapCtxIdx, const uint8_t* pLastCtxIdx, int32_t iMaxPos,
+    int32_t* pSignificantMap, uint32_t& uiCoeffNum) {
+  //work on a local copy so that the engine state stays in registers across the bins of the block
+  SWelsCabacDecEngine sEngine = *pDecEngine;
+  int32_t iErrorInfo = ERR_NONE;
+  uint32_t uiCode;
+  int32_t i;
+  uiCoeffNum = 0;
+  for (i = 0; i < iMaxPos; ++i) {
+    iErrorInfo = DecodeDecisionBin (&sEngine, pMapCtx + (kbCtxIdxTable ? pMapCtxIdx[i] : i), uiCode);
+    if (iErrorInfo)
+      break;
+    pSignificantMap[i] = uiCode;
+    if (uiCode) {
+      ++uiCoeffNum;
+      iErrorInfo = DecodeDecisionBin (&sEngine, pLastCtx + (kbCtxIdxTable ? pLastCtxIdx[i] : i), uiCode);
+      if (iErrorInfo || uiCode)
+        break;
+    }
+  }
+  *pDecEngine = sEngine;
+  if (iErrorInfo)
+    return iErrorInfo;
+  if (i < iMaxPos) { //last significant coefficient found
+    memset (pSignificantMap + i + 1, 0, (iMaxPos - i) * sizeof (int32_t));
+  } else { //the coefficient at iMaxPos is implicitly significant
+    pSignificantMap[iMaxPos] = 1;
+    ++uiCoeffNum;
+  }
   return ERR_NONE;
 }
 
+int32_t DecodeSignificanceMapCabac (PWelsCabacDecEngine pDecEngine, PWelsCabacCtx pMapCtx, PWelsCabacCtx pLastCtx,
+                                    const uint8_t* pMapCtxIdx, const uint8_t* pLastCtxIdx, int32_t iMaxPos,
+                                    int32_t* pSignificantMap, uint32_t& uiCoeffNum) {
+  if (pMapCtxIdx != NULL)
+    return DecodeSignificanceMap<true> (pDecEngine, pMapCtx, pLastCtx, pMapCtxIdx, pLastCtxIdx, iMaxPos,
+                                        pSignificantMap, uiCoeffNum);
+  return DecodeSignificanceMap<false> (pDecEngine, pMapCtx, pLastCtx, NULL, NULL, iMaxPos, pSignificantMap,
+                                       uiCoeffNum);
+}
+
 int32_t DecodeTerminateCabac (PWelsCabacDecEngine pDecEngine, uint32_t& uiBinVal) {
   int32_t iErrorInfo = ERR_NONE;
   uint64_t uiRange = pDecEngine->uiRange - 2;
@@ -222,15 +291,11 @@ int32_t DecodeTerminateCabac (PWelsCabacDecEngine pDecEngine, uint32_t& uiBinVal
     uiBinVal = 0;
     // Renorm
     if (uiRange < WELS_CABAC_QUARTER) {
-      int32_t iRenorm = g_kRenormTable256[uiRange];
+      int32_t iRenorm = WelsCabacRenormBits ((uint32_t)uiRange);
       pDecEngine->uiRange = (uiRange << iRenorm);
       pDecEngine->iBitsLeft -= iRenorm;
       if (pDecEngine->iBitsLeft < 0) {
-        uint32_t uiVal = 0;
-        int32_t iNumBitsRead = 0;
-        iErrorInfo = Read32BitsCabac (pDecEngine, uiVal, iNumBitsRead);
-        pDecEngine->uiOffset = (pDecEngine->uiOffset << iNumBitsRead) | uiVal;
-        pDecEngine->iBitsLeft += iNumBitsRead;
+        iErrorInfo = RefillCabac (pDecEngine);
       }
       if (iErrorInfo && pDecEngine->iBitsLeft < 0) {
         return iErrorInfo;
@@ -265,10 +330,9 @@ int32_t DecodeUnaryBinCabac (PWelsCabacDecEngine pDecEngine, PWelsCabacCtx pBinC
 int32_t DecodeExpBypassCabac (PWelsCabacDecEngine pDecEngine, int32_t iCount, uint32_t& uiSymVal) {
   uint32_t uiCode;
   int32_t iSymTmp = 0;
-  int32_t iSymTmp2 = 0;
   uiSymVal = 0;
   do {
-    WELS_READ_VERIFY (DecodeBypassCabac (pDecEngine, uiCode));
+    WELS_READ_VERIFY (DecodeBypassBin (pDecEngine, uiCode));
     if (uiCode == 1) {
       iSymTmp += (1 << iCount);
       ++iCount;
@@ -278,13 +342,11 @@ int32_t DecodeExpBypassCabac (PWelsCabacDecEngine pDecEngine, int32_t iCount, ui
     return GENERATE_ERROR_NO (ERR_LEVEL_MB_DATA, ERR_CABAC_UNEXPECTED_VALUE);
   }
 
-  while (iCount--) {
-    WELS_READ_VERIFY (DecodeBypassCabac (pDecEngine, uiCode));
-    if (uiCode == 1) {
-      iSymTmp2 |= (1 << iCount);
-    }
+  if (iCount) { //suffix bins in one go
+    WELS_READ_VERIFY (DecodeBypassBinsCabac (pDecEngine, iCount, uiCode));
+    iSymTmp += uiCode;
   }
-  uiSymVal = (uint32_t) (iSymTmp + iSymTmp2);
+  uiSymVal = (uint32_t)iSymTmp;
   return ERR_NONE;
 }
 
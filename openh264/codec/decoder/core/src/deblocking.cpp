@@ -1326,6 +1326,181 @@ void WelsDeblockingFilterMB (PDqLayer pCurDqLayer, SDeblockingFilter& pFilter, i
     pDeblockMb (pCurDqLayer, &pFilter, iBoundryFlag);
   }
 }
+
+static void DeblockingStagePadRow (PDeblockingStage pStage, const int32_t kiMbY) {
+  PPicture pDec = pStage->pDec;
+  const int32_t kiMbWidth = pStage->sDqLayer.iMbWidth;
+  const int32_t kiMbHeight = pStage->sDqLayer.iMbHeight;
+  const int32_t kiMbStep = (kiMbY == 0 || kiMbY == kiMbHeight - 1) ? 1 : WELS_MAX (kiMbWidth - 1, 1);
+  for (int32_t iMbX = 0; iMbX < kiMbWidth; iMbX += kiMbStep) {
+    PadMBLuma_c (pDec->pData[0], pDec->iLinesize[0], pDec->iWidthInPixel, pDec->iHeightInPixel,
+                 iMbX, kiMbY, kiMbWidth, kiMbHeight);
+    PadMBChroma_c (pDec->pData[1], pDec->iLinesize[1], pDec->iWidthInPixel / 2, pDec->iHeightInPixel / 2,
+                   iMbX, kiMbY, kiMbWidth, kiMbHeight);
+    PadMBChroma_c (pDec->pData[2], pDec->iLinesize[2], pDec->iWidthInPixel / 2, pDec->iHeightInPixel / 2,
+                   iMbX, kiMbY, kiMbWidth, kiMbHeight);
+  }
+}
+
+/*!
+* \brief   filter the MBs of the staged slice that no longer serve as intra prediction neighbours
+*
+* \param   kiReconMbNum  MBs of the slice reconstructed so far
+* \param   kbSliceEnd    kiReconMbNum is final, filter everything left
+*
+* \note    Row y feeds the intra prediction of row y + 1 unfiltered, so it is filtered only once
+*          row y + 1 is completely reconstructed.
+*/
+static void DeblockingStageRun (PDeblockingStage pStage, const int32_t kiReconMbNum, const bool kbSliceEnd) {
+  PDqLayer pDqLayer = &pStage->sDqLayer;
+  const int32_t kiMbWidth = pDqLayer->iMbWidth;
+  int32_t iMbLimit = kiReconMbNum;
+
+  if (!kbSliceEnd) {
+    if (pStage->bFmo) {
+      return;
+    }
+    const int32_t kiRowsDone = (pStage->iFirstMbXy + kiReconMbNum) / kiMbWidth;
+    iMbLimit = (kiRowsDone - 1) * kiMbWidth - pStage->iFirstMbXy;
+  }
+
+  while (pStage->iMbNum < iMbLimit && pStage->iNextMbXy >= 0) {
+    pDqLayer->iMbXyIndex = pStage->iNextMbXy;
+    pDqLayer->iMbX = pStage->iNextMbXy % kiMbWidth;
+    pDqLayer->iMbY = pStage->iNextMbXy / kiMbWidth;
+
+    WelsDeblockingFilterMB (pDqLayer, pStage->sFilter, pStage->iFilterIdc, WelsDeblockingMb);
+    if (pDqLayer->iMbX == kiMbWidth - 1 && pStage->bThreadedDecoding) {
+      // filtering a row touches the bottom lines of the row above, which only now is final and can be padded;
+      // the first row is padded ahead as well since MC reads the top padding once it is signalled.
+      // a row cut by the slice end is completed by a later slice
+      if (pStage->bPadBorder) {
+        if (pDqLayer->iMbY > 0) {
+          DeblockingStagePadRow (pStage, pDqLayer->iMbY - 1);
+        }
+        if (pDqLayer->iMbY == 0 || pDqLayer->iMbY == pDqLayer->iMbHeight - 1) {
+          DeblockingStagePadRow (pStage, pDqLayer->iMbY);
+        }
+      }
+      SET_EVENT (&pStage->pDec->pReadyEvent[pDqLayer->iMbY]);
+    }
+    if (pDqLayer->iMbX == kiMbWidth - 1 && pStage->pOutputConvert != NULL && pDqLayer->iMbY > 0) {
+      // the row above is final now and still warm in cache; the last row is left to the frame construction
+      WelsConvertOutputRow (pStage->pOutputConvert, pStage->pDec, pDqLayer->iMbY - 1);
+    }
+    ++pStage->iMbNum;
+
+    if (pStage->bFmo) {
+      pStage->iNextMbXy = FmoNextMb (pStage->pFmo, pStage->iNextMbXy);
+    } else {
+      ++pStage->iNextMbXy;
+    }
+  }
+}
+
+static WelsDecThreadFunc (DeblockingStageThreadProc, pArg) {
+  PDeblockingStage pStage = (PDeblockingStage)pArg;
+  while (1) {
+    WAIT_SEMAPHORE (&pStage->sSliceStart, WELS_DEC_THREAD_WAIT_INFINITE);
+    if (pStage->bQuit) {
+      break;
+    }
+    while (1) {
+      // read the end flag first, a set flag guarantees the final MB count
+      const bool kbSliceEnd = WelsAtomicLoad (&pStage->iSliceEnd) != 0;
+      DeblockingStageRun (pStage, WelsAtomicLoad (&pStage->iReconMbNum), kbSliceEnd);
+      if (kbSliceEnd) {
+        break;
+      }
+      WAIT_EVENT (&pStage->sProgress, WELS_DEC_THREAD_WAIT_INFINITE);
+    }
+    SET_EVENT (&pStage->sSliceDone);
+  }
+  WelsDecThreadReturn;
+}
+
+static bool DeblockingStageStartThread (PDeblockingStage pStage) {
+  if (pStage->bThreadCreated) {
+    return true;
+  }
+  pStage->bQuit = false;
+  CREATE_SEMAPHORE (&pStage->sSliceStart, 0, 1, NULL);
+  CREATE_EVENT (&pStage->sProgress, 0, 0, NULL);
+  CREATE_EVENT (&pStage->sSliceDone, 0, 0, NULL);
+  if (CREATE_THREAD (&pStage->sThread, DeblockingStageThreadProc, pStage) != 0) {
+    CLOSE_SEMAPHORE (&pStage->sSliceStart);
+    CLOSE_EVENT (&pStage->sProgress);
+    CLOSE_EVENT (&pStage->sSliceDone);
+    return false;
+  }
+  pStage->bThreadCreated = true;
+  return true;
+}
+
+void WelsDeblockingStageBegin (PWelsDecoderContext pCtx, const bool kbThreadedDecoding) {
+  PDeblockingStage pStage = &pCtx->sDeblockingStage;
+  PDqLayer pCurDqLayer = pCtx->pCurDqLayer;
+  PSliceHeader pSliceHeader = &pCurDqLayer->sLayerInfo.sSliceInLayer.sSliceHeaderExt.sSliceHeader;
+
+  pStage->sDqLayer = *pCurDqLayer;
+  pStage->iFilterIdc = 1;
+  if (pSliceHeader->uiDisableDeblockingFilterIdc != 1) {
+    WelsDeblockingInitFilter (pCtx, pStage->sFilter, pStage->iFilterIdc);
+  }
+  pStage->pFmo = pCtx->pFmo;
+  pStage->bFmo = pSliceHeader->pPps->uiNumSliceGroups > 1;
+  pStage->pDec = pCtx->pDec;
+  pStage->bThreadedDecoding = kbThreadedDecoding;
+  pStage->bPadBorder = kbThreadedDecoding && pCtx->uiNalRefIdc > 0 && !pCtx->bLazyBorderExpansion;
+  pStage->iFirstMbXy = pSliceHeader->iFirstMbInSlice;
+  pStage->iNextMbXy = pSliceHeader->iFirstMbInSlice;
+  pStage->iMbNum = 0;
+  pStage->pOutputConvert = (pStage->pDec->pOutput[0] != NULL && !pStage->bFmo) ? &pCtx->sOutputConvertFunc : NULL;
+  pStage->iReconMbNum = 0;
+  pStage->iSliceEnd = 0;
+
+  pStage->bOnWorker = pCtx->bDeblockingThread && DeblockingStageStartThread (pStage);
+  if (pStage->bOnWorker) {
+    RELEASE_SEMAPHORE (&pStage->sSliceStart);
+  }
+}
+
+void WelsDeblockingStageProgress (PWelsDecoderContext pCtx, const int32_t kiReconMbNum) {
+  PDeblockingStage pStage = &pCtx->sDeblockingStage;
+  if (pStage->bOnWorker) {
+    WelsAtomicStore (&pStage->iReconMbNum, kiReconMbNum);
+    SET_EVENT (&pStage->sProgress);
+  } else {
+    DeblockingStageRun (pStage, kiReconMbNum, false);
+  }
+}
+
+void WelsDeblockingStageEnd (PWelsDecoderContext pCtx, const int32_t kiReconMbNum) {
+  PDeblockingStage pStage = &pCtx->sDeblockingStage;
+  if (pStage->bOnWorker) {
+    WelsAtomicStore (&pStage->iReconMbNum, kiReconMbNum);
+    WelsAtomicStore (&pStage->iSliceEnd, 1);
+    SET_EVENT (&pStage->sProgress);
+    WAIT_EVENT (&pStage->sSliceDone, WELS_DEC_THREAD_WAIT_INFINITE);
+    pStage->bOnWorker = false;
+  } else {
+    DeblockingStageRun (pStage, kiReconMbNum, true);
+  }
+}
+
+void WelsDeblockingStageUninit (PWelsDecoderContext pCtx) {
+  PDeblockingStage pStage = &pCtx->sDeblockingStage;
+  if (!pStage->bThreadCreated) {
+    return;
+  }
+  pStage->bQuit = true;
+  RELEASE_SEMAPHORE (&pStage->sSliceStart);
+  WAIT_THREAD (&pStage->sThread);
+  CLOSE_SEMAPHORE (&pStage->sSliceStart);
+  CLOSE_EVENT (&pStage->sProgress);
+  CLOSE_EVENT (&pStage->sSliceDone);
+  pStage->bThreadCreated = false;
+}
 /*!
  * \brief   deblocking module initialize
  *
@@ -94,6 +94,7 @@ int32_t WelsTargetSliceConstruction (PWelsDecoderContext pCtx) {
   int32_t iTotalNumMb = pCurSlice->iTotalMbInCurSlice;
   int32_t iCountNumMb = 0;
   PDeblockingFilterMbFunc pDeblockMb = WelsDeblockingMb;
+  bool bDeblockingStage = false;
 
   if (!pCtx->sSpsPpsCtx.bAvcBasedFlag && iCurLayerWidth != pCtx->iCurSeqIntervalMaxPicWidth) {
     return ERR_INFO_WIDTH_MISMATCH;
@@ -111,6 +112,15 @@ int32_t WelsTargetSliceConstruction (PWelsDecoderContext pCtx) {
     pCurDqLayer->pDec->uiQualityId = pCurDqLayer->sLayerInfo.sNalHeaderExt.uiQualityId;
   }
 
+  // filter on the worker thread one MB row behind the reconstruction below; a converted output takes the
+  // rows through the stage as well, inline if need be, to convert each one as soon as it is final
+  if ((pCtx->bDeblockingThread && 1 != pSliceHeader->uiDisableDeblockingFilterIdc) || pCtx->pDec->pOutput[0] != NULL)
+    bDeblockingStage = !pCtx->pParam->bParseOnly && iTotalNumMb > 0 && (pCurSlice->eSliceType == I_SLICE
+                       || pCurSlice->eSliceType == P_SLICE || pCurSlice->eSliceType == B_SLICE);
+  if (bDeblockingStage) {
+    WelsDeblockingStageBegin (pCtx, false);
+  }
+
   do {
     if (iCountNumMb >= iTotalNumMb) {
       break;
@@ -122,6 +132,8 @@ int32_t WelsTargetSliceConstruction (PWelsDecoderContext pCtx) {
                  "WelsTargetSliceConstruction():::MB(%d, %d) construction error. pCurSlice_type:%d",
                  pCurDqLayer->iMbX, pCurDqLayer->iMbY, pCurSlice->eSliceType);
 
+        if (bDeblockingStage)
+          WelsDeblockingStageEnd (pCtx, iCountNumMb);
         return ERR_INFO_MB_RECON_FAIL;
       }
     }
@@ -138,6 +150,8 @@ int32_t WelsTargetSliceConstruction (PWelsDecoderContext pCtx) {
                "WelsTargetSliceConstruction():::pCtx->iTotalNumMbRec:%d, iTotalMbTargetLayer:%d",
                pCtx->iTotalNumMbRec, iTotalMbTargetLayer);
 
+      if (bDeblockingStage)
+        WelsDeblockingStageEnd (pCtx, iCountNumMb);
       return ERR_INFO_MB_NUM_EXCEED_FAIL;
     }
 
@@ -149,11 +163,18 @@ int32_t WelsTargetSliceConstruction (PWelsDecoderContext pCtx) {
     if (-1 == iNextMbXyIndex || iNextMbXyIndex >= iTotalMbTargetLayer) { // slice group boundary or end of a frame
       break;
     }
+    if (bDeblockingStage && pCurDqLayer->iMbX == pCurDqLayer->iMbWidth - 1) {
+      WelsDeblockingStageProgress (pCtx, iCountNumMb);
+    }
     pCurDqLayer->iMbX  = iNextMbXyIndex % pCurDqLayer->iMbWidth;
     pCurDqLayer->iMbY  = iNextMbXyIndex / pCurDqLayer->iMbWidth;
     pCurDqLayer->iMbXyIndex = iNextMbXyIndex;
   } while (1);
 
+  if (bDeblockingStage) {
+    WelsDeblockingStageEnd (pCtx, iCountNumMb);
+  }
+
   pCtx->pDec->iWidthInPixel  = iCurLayerWidth;
   pCtx->pDec->iHeightInPixel = iCurLayerHeight;
 
@@ -164,8 +185,8 @@ int32_t WelsTargetSliceConstruction (PWelsDecoderContext pCtx) {
     return ERR_NONE;
 
   if (1 == pSliceHeader->uiDisableDeblockingFilterIdc
-      || pCtx->pCurDqLayer->sLayerInfo.sSliceInLayer.iTotalMbInCurSlice <= 0) {
-    return ERR_NONE;//NO_SUPPORTED_FILTER_IDX
+      || pCtx->pCurDqLayer->sLayerInfo.sSliceInLayer.iTotalMbInCurSlice <= 0 || bDeblockingStage) {
+    return ERR_NONE;//NO_SUPPORTED_FILTER_IDX, or already filtered
   } else {
     WelsDeblockingFilterSlice (pCtx, pDeblockMb);
   }
@@ -174,6 +195,293 @@ int32_t WelsTargetSliceConstruction (PWelsDecoderContext pCtx) {
   return ERR_NONE;
 }
 
+static int32_t SliceThreadsReconstruct (PWelsDecoderContext pCtx) {
+  PDqLayer pCurDqLayer = pCtx->pCurDqLayer;
+  PSlice pCurSlice = &pCurDqLayer->sLayerInfo.sSliceInLayer;
+  PSliceHeader pSliceHeader = &pCurSlice->sSliceHeaderExt.sSliceHeader;
+  const int32_t kiTotalMbTargetLayer = pSliceHeader->pSps->uiTotalMbCount;
+  int32_t iNextMbXyIndex = pSliceHeader->iFirstMbInSlice;
+
+  for (int32_t iCountNumMb = 0; iCountNumMb < pCurSlice->iTotalMbInCurSlice
+       && iNextMbXyIndex < kiTotalMbTargetLayer; ++iCountNumMb, ++iNextMbXyIndex) {
+    pCurDqLayer->iMbX  = iNextMbXyIndex % pCurDqLayer->iMbWidth;
+    pCurDqLayer->iMbY  = iNextMbXyIndex / pCurDqLayer->iMbWidth;
+    pCurDqLayer->iMbXyIndex = iNextMbXyIndex;
+    if (WelsTargetMbConstruction (pCtx)) {
+      WelsLog (& (pCtx->sLogCtx), WELS_LOG_WARNING,
+               "SliceThreadsReconstruct():::MB(%d, %d) construction error. pCurSlice_type:%d",
+               pCurDqLayer->iMbX, pCurDqLayer->iMbY, pCurSlice->eSliceType);
+      return ERR_INFO_MB_RECON_FAIL;
+    }
+  }
+  return ERR_NONE;
+}
+
+/*
+ * share the decoder and picture state that parsing and reconstruction of a slice only read with the context of a slice
+ * thread; what a slice writes, MB cursors, entropy decoding and error flags, stays with the worker
+ */
+static void SliceThreadsBind (PSliceThreadWorker pWorker, PWelsDecoderContext pCtx) {
+  PWelsDecoderContext pWorkerCtx = pWorker->pCtx;
+
+  pWorkerCtx->pParam             = pCtx->pParam;
+  pWorkerCtx->sLogCtx            = pCtx->sLogCtx;
+  pWorkerCtx->pMemAlign          = pCtx->pMemAlign;
+  pWorkerCtx->pThreadCtx         = pCtx->pThreadCtx;
+  pWorkerCtx->pVlcTable          = pCtx->pVlcTable;
+  pWorkerCtx->pCabacInitContexts = pCtx->pCabacInitContexts;
+  pWorkerCtx->bCabacInited       = pCtx->bCabacInited;
+  pWorkerCtx->pCabacDecEngine    = &pWorker->sCabacDecEngine;
+  pWorkerCtx->sMb                = pCtx->sMb;
+
+  memcpy (pWorkerCtx->pGetI16x16LumaPredFunc, pCtx->pGetI16x16LumaPredFunc, sizeof (pCtx->pGetI16x16LumaPredFunc));
+  memcpy (pWorkerCtx->pGetI4x4LumaPredFunc, pCtx->pGetI4x4LumaPredFunc, sizeof (pCtx->pGetI4x4LumaPredFunc));
+  memcpy (pWorkerCtx->pGetIChromaPredFunc, pCtx->pGetIChromaPredFunc, sizeof (pCtx->pGetIChromaPredFunc));
+  memcpy (pWorkerCtx->pGetI8x8LumaPredFunc, pCtx->pGetI8x8LumaPredFunc, sizeof (pCtx->pGetI8x8LumaPredFunc));
+  pWorkerCtx->pIdctResAddPredFunc     = pCtx->pIdctResAddPredFunc;
+  pWorkerCtx->pIdctFourResAddPredFunc = pCtx->pIdctFourResAddPredFunc;
+  pWorkerCtx->pIdctResAddPredFunc8x8  = pCtx->pIdctResAddPredFunc8x8;
+  pWorkerCtx->sMcFunc                 = pCtx->sMcFunc;
+  pWorkerCtx->sBlockFunc              = pCtx->sBlockFunc;
+  pWorkerCtx->bLazyBorderExpansion    = pCtx->bLazyBorderExpansion;
+
+  pWorkerCtx->pDec         = pCtx->pDec;
+  pWorkerCtx->pTempDec     = pCtx->pTempDec;
+  pWorkerCtx->pFmo         = pCtx->pFmo;
+  pWorkerCtx->bNewSeqBegin = pCtx->bNewSeqBegin;
+  pWorkerCtx->iErrorCode   = pCtx->iErrorCode;
+  memcpy (pWorkerCtx->iDecBlockOffsetArray, pCtx->iDecBlockOffsetArray, sizeof (pCtx->iDecBlockOffsetArray));
+
+  // computed for the PPS of the queue by WelsSliceThreadsQueue(), left alone by WelsCalcDeqCoeffScalingList()
+  memcpy (pWorkerCtx->pDequant_coeff4x4, pCtx->pDequant_coeff4x4, sizeof (pCtx->pDequant_coeff4x4));
+  memcpy (pWorkerCtx->pDequant_coeff8x8, pCtx->pDequant_coeff8x8, sizeof (pCtx->pDequant_coeff8x8));
+  pWorkerCtx->iDequantCoeffPpsid   = pCtx->iDequantCoeffPpsid;
+  pWorkerCtx->bDequantCoeff4x4Init = pCtx->bDequantCoeff4x4Init;
+  pWorkerCtx->bUseScalingList      = pCtx->bUseScalingList;
+}
+
+// take jobs in queue order until none is left, pCtx is the context of the calling worker
+static void SliceThreadsRun (PSliceThreads pThreads, PWelsDecoderContext pCtx) {
+  int32_t iJob;
+  while ((iJob = WelsAtomicAdd (&pThreads->iNextJob, 1) - 1) < pThreads->iJobNum) {
+    PSliceJob pJob = &pThreads->pJobs[iJob];
+    pCtx->pCurDqLayer = &pJob->sDqLayer;
+    pCtx->pSps        = pJob->sDqLayer.sLayerInfo.pSps;
+    pCtx->pPps        = pJob->sDqLayer.sLayerInfo.pPps;
+    pCtx->sRefPic     = pJob->sRefPic;
+    pCtx->bRPLRError  = pJob->bRPLRError;
+    pJob->iParseRet   = WelsDecodeSlice (pCtx, false, pJob->pNalCur);
+    // the parsed MBs of a broken slice are reconstructed as well unless the picture is dropped for it
+    if (pJob->iParseRet == ERR_NONE || pCtx->pParam->eEcActiveIdc != ERROR_CON_DISABLE)
+      pJob->iRet = SliceThreadsReconstruct (pCtx);
+  }
+}
+
+static WelsDecThreadFunc (SliceThreadProc, pArg) {
+  PSliceThreadWorker pWorker = (PSliceThreadWorker)pArg;
+  PSliceThreads pThreads = pWorker->pThreads;
+  while (true) {
+    WAIT_SEMAPHORE (&pWorker->sStart, WELS_DEC_THREAD_WAIT_INFINITE);
+    if (pThreads->bQuit) {
+      break;
+    }
+    SliceThreadsRun (pThreads, pWorker->pCtx);
+    SET_EVENT (&pWorker->sDone);
+  }
+  WelsDecThreadReturn;
+}
+
+// make sure iWorkerNum workers have a context and, beyond worker 0, a running thread; returns the usable number
+static int32_t SliceThreadsStart (PWelsDecoderContext pCtx, int32_t iWorkerNum) {
+  PSliceThreads pThreads = &pCtx->sSliceThreads;
+  for (int32_t i = 0; i < iWorkerNum; ++i) {
+    PSliceThreadWorker pWorker = &pThreads->sWorker[i];
+    if (pWorker->pCtx == NULL) {
+      pWorker->pCtx = (PWelsDecoderContext)pCtx->pMemAlign->WelsMallocz (sizeof (SWelsDecoderContext),
+                      "pSliceThreads->sWorker[].pCtx");
+      if (pWorker->pCtx == NULL)
+        return i;
+    }
+    if (i == 0 || i < pThreads->iThreadCreatedNum)
+      continue;
+    pWorker->pThreads = pThreads;
+    CREATE_SEMAPHORE (&pWorker->sStart, 0, 1, NULL);
+    CREATE_EVENT (&pWorker->sDone, 0, 0, NULL);
+    if (CREATE_THREAD (&pWorker->sThread, SliceThreadProc, pWorker) != 0) {
+      CLOSE_SEMAPHORE (&pWorker->sStart);
+      CLOSE_EVENT (&pWorker->sDone);
+      return i;
+    }
+    pThreads->iThreadCreatedNum = i + 1;
+  }
+  return iWorkerNum;
+}
+
+bool WelsSliceThreadsQueue (PWelsDecoderContext pCtx, PNalUnit pNalCur) {
+  PSliceThreads pThreads = &pCtx->sSliceThreads;
+  PDqLayer pCurDqLayer = pCtx->pCurDqLayer;
+  PSlice pCurSlice = &pCurDqLayer->sLayerInfo.sSliceInLayer;
+  PSliceHeader pSliceHeader = &pCurSlice->sSliceHeaderExt.sSliceHeader;
+
+  if (pThreads->iThreadNum <= 1 || pCtx->pParam->bParseOnly || !pCtx->sSpsPpsCtx.bAvcBasedFlag
+      || pSliceHeader->pPps->uiNumSliceGroups > 1
+      || (pCurSlice->eSliceType != I_SLICE && pCurSlice->eSliceType != P_SLICE && pCurSlice->eSliceType != B_SLICE))
+    return false;
+
+  if (pThreads->iJobNum > 0) {
+    // the slices are parsed side by side in the MB arrays of the layer and deblocked in queue order, which has to
+    // match the order of the slices in the picture; their scaling lists are those of the one PPS
+    PSliceHeader pLastSliceHeader = &pThreads->pJobs[pThreads->iJobNum - 1].sDqLayer.sLayerInfo.sSliceInLayer
+                                    .sSliceHeaderExt.sSliceHeader;
+    if (pSliceHeader->iFirstMbInSlice <= pLastSliceHeader->iFirstMbInSlice
+        || pSliceHeader->pPps != pLastSliceHeader->pPps)
+      return false;
+  }
+
+  if (pThreads->pJobs == NULL) {
+    pThreads->pJobs = (PSliceJob)pCtx->pMemAlign->WelsMallocz (MAX_SLICE_JOB_NUM * sizeof (SSliceJob),
+                      "pSliceThreads->pJobs");
+    if (pThreads->pJobs == NULL)
+      return false;
+  }
+  if (pThreads->iJobNum == MAX_SLICE_JOB_NUM)
+    return false;
+
+  // shared by the slice threads, the parsing of each of them then finds it done
+  WelsCalcDeqCoeffScalingList (pCtx);
+  if (pSliceHeader->pPps->bEntropyCodingModeFlag && !pCtx->bCabacInited)
+    WelsCabacGlobalInit (pCtx);
+
+  PSliceJob pJob = &pThreads->pJobs[pThreads->iJobNum++];
+  pJob->sDqLayer   = *pCurDqLayer;
+  pJob->sRefPic    = pCtx->sRefPic;
+  pJob->bRPLRError = pCtx->bRPLRError;
+  pJob->pNalCur    = pNalCur;
+  pJob->iParseRet  = ERR_NONE;
+  pJob->iRet       = ERR_NONE;
+  return true;
+}
+
+void WelsSliceThreadsRun (PWelsDecoderContext pCtx) {
+  PSliceThreads pThreads = &pCtx->sSliceThreads;
+  const int32_t kiJobNum = pThreads->iJobNum;
+
+  if (kiJobNum == 0)
+    return;
+
+  for (int32_t i = 0; i < kiJobNum && pCtx->pTempDec == NULL; ++i) {
+    // scratch picture of bi-prediction, allocated lazily by the reconstruction otherwise
+    if (pThreads->pJobs[i].sDqLayer.sLayerInfo.sSliceInLayer.eSliceType == B_SLICE)
+      pCtx->pTempDec = AllocPicture (pCtx, pCtx->pSps->iMbWidth << 4, pCtx->pSps->iMbHeight << 4);
+  }
+
+  const int32_t kiWorkerNum = SliceThreadsStart (pCtx, WELS_MIN (pThreads->iThreadNum, kiJobNum));
+  pThreads->iNextJob = 0;
+  if (kiWorkerNum > 0) {
+    for (int32_t i = 0; i < kiWorkerNum; ++i) {
+      SliceThreadsBind (&pThreads->sWorker[i], pCtx);
+    }
+    for (int32_t i = 1; i < kiWorkerNum; ++i) {
+      RELEASE_SEMAPHORE (&pThreads->sWorker[i].sStart);
+    }
+    SliceThreadsRun (pThreads, pThreads->sWorker[0].pCtx);
+    for (int32_t i = 1; i < kiWorkerNum; ++i) {
+      WAIT_EVENT (&pThreads->sWorker[i].sDone, WELS_DEC_THREAD_WAIT_INFINITE);
+    }
+    for (int32_t i = 0; i < kiWorkerNum; ++i) {
+      pCtx->iErrorCode |= pThreads->sWorker[i].pCtx->iErrorCode;
+    }
+  } else {
+    // no memory for a worker context, decode on the decoding context itself
+    PDqLayer pCurDqLayer = pCtx->pCurDqLayer;
+    PSps pSps = pCtx->pSps;
+    PPps pPps = pCtx->pPps;
+    SRefPic sRefPic = pCtx->sRefPic;
+    bool bRPLRError = pCtx->bRPLRError;
+    SliceThreadsRun (pThreads, pCtx);
+    pCtx->pCurDqLayer = pCurDqLayer;
+    pCtx->pSps        = pSps;
+    pCtx->pPps        = pPps;
+    pCtx->sRefPic     = sRefPic;
+    pCtx->bRPLRError  = bRPLRError;
+  }
+}
+
+int32_t WelsSliceThreadsFinish (PWelsDecoderContext pCtx, PSliceJob pJob) {
+  PDqLayer pCurDqLayer = pCtx->pCurDqLayer;
+  PSlice pCurSlice = &pJob->sDqLayer.sLayerInfo.sSliceInLayer;
+  PSliceHeader pSliceHeader = &pCurSlice->sSliceHeaderExt.sSliceHeader;
+  const int32_t kiTotalMbTargetLayer = pSliceHeader->pSps->uiTotalMbCount;
+  const int32_t kiFirstMbXy = pSliceHeader->iFirstMbInSlice;
+
+  // the decoding context is left on the slice, as the inline decoding leaves it
+  *pCurDqLayer     = pJob->sDqLayer;
+  pCtx->sRefPic    = pJob->sRefPic;
+  pCtx->eSliceType = pSliceHeader->eSliceType;
+  if (pJob->iRet != ERR_NONE)
+    return pJob->iRet;
+
+  if (pJob > pCtx->sSliceThreads.pJobs) {
+    // the slice before ran over the start of this one, both were parsed into the same MBs at once
+    PSlice pLastSlice = &pJob[-1].sDqLayer.sLayerInfo.sSliceInLayer;
+    if (kiFirstMbXy < pLastSlice->sSliceHeaderExt.sSliceHeader.iFirstMbInSlice + pLastSlice->iTotalMbInCurSlice) {
+      WelsLog (& (pCtx->sLogCtx), WELS_LOG_WARNING,
+               "WelsSliceThreadsFinish():::slice at MB %d overlaps the previous one", kiFirstMbXy);
+      return ERR_INFO_MB_RECON_FAIL;
+    }
+  }
+
+  if (0 == kiFirstMbXy) {
+    pCtx->pDec->iSpsId = pSliceHeader->pSps->iSpsId;
+    pCtx->pDec->iPpsId = pSliceHeader->pPps->iPpsId;
+    pCtx->pDec->uiQualityId = pCurDqLayer->sLayerInfo.sNalHeaderExt.uiQualityId;
+  }
+  for (int32_t iMbXy = kiFirstMbXy; iMbXy < kiFirstMbXy + pCurSlice->iTotalMbInCurSlice
+       && iMbXy < kiTotalMbTargetLayer; ++iMbXy) {
+    if (!pCurDqLayer->pMbCorrectlyDecodedFlag[iMbXy]) { //already con-ed, overwrite
+      pCurDqLayer->pMbCorrectlyDecodedFlag[iMbXy] = true;
+      pCtx->pDec->iMbEcedPropNum += (pCurDqLayer->pMbRefConcealedFlag[iMbXy] ? 1 : 0);
+      ++pCtx->iTotalNumMbRec;
+    }
+  }
+  if (pCtx->iTotalNumMbRec > kiTotalMbTargetLayer) {
+    WelsLog (& (pCtx->sLogCtx), WELS_LOG_WARNING,
+             "WelsSliceThreadsFinish():::pCtx->iTotalNumMbRec:%d, iTotalMbTargetLayer:%d",
+             pCtx->iTotalNumMbRec, kiTotalMbTargetLayer);
+    return ERR_INFO_MB_NUM_EXCEED_FAIL;
+  }
+  pCtx->pDec->iWidthInPixel  = pCurDqLayer->iMbWidth << 4;
+  pCtx->pDec->iHeightInPixel = pCurDqLayer->iMbHeight << 4;
+
+  if (1 != pSliceHeader->uiDisableDeblockingFilterIdc && pCurSlice->iTotalMbInCurSlice > 0)
+    WelsDeblockingFilterSlice (pCtx, WelsDeblockingMb);
+  return ERR_NONE;
+}
+
+void WelsSliceThreadsUninit (PWelsDecoderContext pCtx) {
+  PSliceThreads pThreads = &pCtx->sSliceThreads;
+  pThreads->bQuit = true;
+  for (int32_t i = 1; i < pThreads->iThreadCreatedNum; ++i) {
+    RELEASE_SEMAPHORE (&pThreads->sWorker[i].sStart);
+    WAIT_THREAD (&pThreads->sWorker[i].sThread);
+    CLOSE_SEMAPHORE (&pThreads->sWorker[i].sStart);
+    CLOSE_EVENT (&pThreads->sWorker[i].sDone);
+  }
+  pThreads->iThreadCreatedNum = 0;
+  pThreads->bQuit = false;
+  for (int32_t i = 0; i < WELS_DEC_MAX_NUM_CPU; ++i) {
+    if (pThreads->sWorker[i].pCtx != NULL) {
+      pCtx->pMemAlign->WelsFree (pThreads->sWorker[i].pCtx, "pSliceThreads->sWorker[].pCtx");
+      pThreads->sWorker[i].pCtx = NULL;
+    }
+  }
+  if (pThreads->pJobs != NULL) {
+    pCtx->pMemAlign->WelsFree (pThreads->pJobs, "pSliceThreads->pJobs");
+    pThreads->pJobs = NULL;
+  }
+  pThreads->iJobNum = 0;
+}
+
 int32_t WelsMbInterSampleConstruction (PWelsDecoderContext pCtx, PDqLayer pCurDqLayer,
                                        uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iStrideL, int32_t iStrideC) {
   int32_t iMbXy = pCurDqLayer->iMbXyIndex;
@@ -1692,13 +2000,8 @@ int32_t WelsDecodeAndConstructSlice (PWelsDecoderContext pCtx) {
   pCurDqLayer->iMbY = iMbY;
   pCurDqLayer->iMbXyIndex = iNextMbXyIndex;
 
-  PDeblockingFilterMbFunc pDeblockMb = WelsDeblockingMb;
-
-  SDeblockingFilter pFilter;
-  int32_t iFilterIdc = 1;
-  if (pSliceHeader->uiDisableDeblockingFilterIdc != 1) {
-    WelsDeblockingInitFilter (pCtx, pFilter, iFilterIdc);
-  }
+  // rows are filtered, padded and signalled ready one row behind reconstruction
+  WelsDeblockingStageBegin (pCtx, true);
 
   do {
     if ((-1 == iNextMbXyIndex) || (iNextMbXyIndex >= kiCountNumMb)) { // slice group boundary or end of a frame
@@ -1710,6 +2013,7 @@ int32_t WelsDecodeAndConstructSlice (PWelsDecoderContext pCtx) {
     iRet = pDecMbFunc (pCtx, pNalCur, uiEosFlag);
     pCurDqLayer->pMbRefConcealedFlag[iNextMbXyIndex] = pCtx->bMbRefConcealed;
     if (iRet != ERR_NONE) {
+      WelsDeblockingStageEnd (pCtx, pSlice->iTotalMbInCurSlice);
       return iRet;
     }
     if (WelsTargetMbConstruction (pCtx)) {
@@ -1717,6 +2021,7 @@ int32_t WelsDecodeAndConstructSlice (PWelsDecoderContext pCtx) {
                "WelsTargetSliceConstruction():::MB(%d, %d) construction error. pCurSlice_type:%d",
                pCurDqLayer->iMbX, pCurDqLayer->iMbY, pSlice->eSliceType);
 
+      WelsDeblockingStageEnd (pCtx, pSlice->iTotalMbInCurSlice);
       return ERR_INFO_MB_RECON_FAIL;
     }
     memcpy (pCtx->pDec->pNzc[pCurDqLayer->iMbXyIndex], pCurDqLayer->pNzc[pCurDqLayer->iMbXyIndex], 24);
@@ -1724,20 +2029,6 @@ int32_t WelsDecodeAndConstructSlice (PWelsDecoderContext pCtx) {
       pCtx->sBlockFunc.pWelsSetNonZeroCountFunc (
         pCtx->pDec->pNzc[pCurDqLayer->iMbXyIndex]); // set all none-zero nzc to 1; dbk can be opti!
     }
-    WelsDeblockingFilterMB (pCurDqLayer, pFilter, iFilterIdc, pDeblockMb);
-    if (pCtx->uiNalRefIdc > 0) {
-      if (pCurDqLayer->iMbX == 0 || pCurDqLayer->iMbX == pCurDqLayer->iMbWidth - 1 || pCurDqLayer->iMbY == 0
-          || pCurDqLayer->iMbY == pCurDqLayer->iMbHeight - 1) {
-        PadMBLuma_c (pCurDqLayer->pDec->pData[0], pCurDqLayer->pDec->iLinesize[0], pCurDqLayer->pDec->iWidthInPixel,
-                     pCurDqLayer->pDec->iHeightInPixel, pCurDqLayer->iMbX, pCurDqLayer->iMbY, pCurDqLayer->iMbWidth, pCurDqLayer->iMbHeight);
-        PadMBChroma_c (pCurDqLayer->pDec->pData[1], pCurDqLayer->pDec->iLinesize[1], pCurDqLayer->pDec->iWidthInPixel / 2,
-                       pCurDqLayer->pDec->iHeightInPixel / 2, pCurDqLayer->iMbX, pCurDqLayer->iMbY, pCurDqLayer->iMbWidth,
-                       pCurDqLayer->iMbHeight);
-        PadMBChroma_c (pCurDqLayer->pDec->pData[2], pCurDqLayer->pDec->iLinesize[2], pCurDqLayer->pDec->iWidthInPixel / 2,
-                       pCurDqLayer->pDec->iHeightInPixel / 2, pCurDqLayer->iMbX, pCurDqLayer->iMbY, pCurDqLayer->iMbWidth,
-                       pCurDqLayer->iMbHeight);
-      }
-    }
     if (!pCurDqLayer->pMbCorrectlyDecodedFlag[iNextMbXyIndex]) { //already con-ed, overwrite
       pCurDqLayer->pMbCorrectlyDecodedFlag[iNextMbXyIndex] = true;
       pCtx->pDec->iMbEcedPropNum += (pCurDqLayer->pMbRefConcealedFlag[iNextMbXyIndex] ? 1 : 0);
@@ -1749,12 +2040,12 @@ int32_t WelsDecodeAndConstructSlice (PWelsDecoderContext pCtx) {
                "WelsTargetSliceConstruction():::pCtx->iTotalNumMbRec:%d, iTotalMbTargetLayer:%d",
                pCtx->iTotalNumMbRec, iTotalMbTargetLayer);
 
+      WelsDeblockingStageEnd (pCtx, pSlice->iTotalMbInCurSlice);
       return ERR_INFO_MB_NUM_EXCEED_FAIL;
     }
 
     ++pSlice->iTotalMbInCurSlice;
     if (uiEosFlag) { //end of slice
-      SET_EVENT (&pCtx->pDec->pReadyEvent[pCurDqLayer->iMbY]);
       break;
     }
     if (pSliceHeader->pPps->uiNumSliceGroups > 1) {
@@ -1769,15 +2060,11 @@ int32_t WelsDecodeAndConstructSlice (PWelsDecoderContext pCtx) {
     pCurDqLayer->iMbX = iMbX;
     pCurDqLayer->iMbY = iMbY;
     pCurDqLayer->iMbXyIndex = iNextMbXyIndex;
-    if (GetThreadCount (pCtx) > 1) {
-      if ((iMbY > iLastMby) && (iLastMbx == pCurDqLayer->iMbWidth - 1)) {
-        SET_EVENT (&pCtx->pDec->pReadyEvent[iLastMby]);
-      }
+    if ((iMbY > iLastMby) && (iLastMbx == pCurDqLayer->iMbWidth - 1)) {
+      WelsDeblockingStageProgress (pCtx, pSlice->iTotalMbInCurSlice);
     }
   } while (1);
-  if (GetThreadCount (pCtx) > 1) {
-    SET_EVENT (&pCtx->pDec->pReadyEvent[pCurDqLayer->iMbY]);
-  }
+  WelsDeblockingStageEnd (pCtx, pSlice->iTotalMbInCurSlice);
   return ERR_NONE;
 }
 
@@ -57,6 +57,7 @@
 namespace WelsDec {
 
 extern PPicture AllocPicture (PWelsDecoderContext pCtx, const int32_t kiPicWidth, const int32_t kiPicHeight);
+extern PPicture AllocPicBuffPicture (PWelsDecoderContext pCtx, const int32_t kiPicWidth, const int32_t kiPicHeight);
 
 extern void FreePicture (PPicture pPic, CMemoryAlign* pMa);
 
@@ -86,7 +87,7 @@ static int32_t CreatePicBuff (PWelsDecoderContext pCtx, PPicBuff* ppPicBuf, cons
   }
 
   for (iPicIdx = 0; iPicIdx < kiSize; ++ iPicIdx) {
-    PPicture pPic = AllocPicture (pCtx, kiPicWidth, kiPicHeight);
+    PPicture pPic = AllocPicBuffPicture (pCtx, kiPicWidth, kiPicHeight);
     if (NULL == pPic) {
       // init capacity first for free memory
       pPicBuf->iCapacity = iPicIdx;
@@ -130,7 +131,7 @@ static int32_t IncreasePicBuff (PWelsDecoderContext pCtx, PPicBuff* ppPicBuf, co
 
   // increase new PicBuf
   for (iPicIdx = kiOldSize; iPicIdx < kiNewSize; ++ iPicIdx) {
-    PPicture pPic = AllocPicture (pCtx, kiPicWidth, kiPicHeight);
+    PPicture pPic = AllocPicBuffPicture (pCtx, kiPicWidth, kiPicHeight);
     if (NULL == pPic) {
       // Set maximum capacity as the new malloc memory at the tail
       pPicNewBuf->iCapacity = iPicIdx;
@@ -322,6 +323,7 @@ void WelsDecoderDefaults (PWelsDecoderContext pCtx, SLogContext* pLogCtx) {
 
   pCtx->bAuReadyFlag              = 0;                  // au data is not ready
   pCtx->bCabacInited = false;
+  pCtx->pCabacInitContexts = NULL;
 
   pCtx->uiCpuFlag = WelsCPUFeatureDetect (&iCpuCores);
 
@@ -330,6 +332,9 @@ void WelsDecoderDefaults (PWelsDecoderContext pCtx, SLogContext* pLogCtx) {
   pCtx->iLastImgWidthInPixel      = 0;
   pCtx->iLastImgHeightInPixel     = 0;
   pCtx->bFreezeOutput = true;
+  pCtx->eOutputFormat             = videoFormatI420;
+  pCtx->eSkipFrames               = DECODER_SKIP_NONE;
+  pCtx->bSkipCurrentPic           = false;
 
   pCtx->iFrameNum                 = -1;
   pCtx->pLastDecPicInfo->iPrevFrameNum             = -1;
@@ -628,6 +633,9 @@ int32_t WelsOpenDecoder (PWelsDecoderContext pCtx, SLogContext* pLogCtx) {
  * \brief   Close decoder
  */
 void WelsCloseDecoder (PWelsDecoderContext pCtx) {
+  WelsDeblockingStageUninit (pCtx);
+  WelsSliceThreadsUninit (pCtx);
+
   WelsFreeDynamicMemory (pCtx);
 
   WelsFreeStaticMemory (pCtx);
@@ -756,7 +764,7 @@ int32_t WelsDecodeBs (PWelsDecoderContext pCtx, const uint8_t* kpBsBuf, const in
 
 
     if (NULL == DetectStartCodePrefix (kpBsBuf, &iOffset,
-                                       kiBsLen)) {  //CAN'T find the 00 00 01 start prefix from the source buffer
+                                       kiBsLen, pCtx->pfFindNalSyntaxBytes)) {  //CAN'T find the 00 00 01 start prefix from the source buffer
       pCtx->iErrorCode |= dsBitstreamError;
       return dsBitstreamError;
     }
@@ -781,6 +789,15 @@ int32_t WelsDecodeBs (PWelsDecoderContext pCtx, const uint8_t* kpBsBuf, const in
     bool bNalStartBytes = false;
 
     while (iSrcConsumed < iSrcLength) {
+      // bytes up to the next start code or emulation prevention byte are copied at once
+      const int32_t kiPlainBytes = pCtx->pfFindNalSyntaxBytes (pSrcNal + iSrcIdx, iSrcLength - iSrcConsumed);
+      if (kiPlainBytes > 0) {
+        memcpy (pDstNal + iDstIdx, pSrcNal + iSrcIdx, kiPlainBytes); // confirmed_safe_unsafe_usage
+        iDstIdx      += kiPlainBytes;
+        iSrcIdx      += kiPlainBytes;
+        iSrcConsumed += kiPlainBytes;
+        continue;
+      }
       if ((2 + iSrcConsumed < iSrcLength) && (0 == LD16 (pSrcNal + iSrcIdx)) && (pSrcNal[2 + iSrcIdx] <= 0x03)) {
         if (bNalStartBytes && (pSrcNal[2 + iSrcIdx] != 0x00 && pSrcNal[2 + iSrcIdx] != 0x01)) {
           pCtx->iErrorCode |= dsBitstreamError;
@@ -984,6 +1001,8 @@ void InitDecFuncs (PWelsDecoderContext pCtx, uint32_t uiCpuFlag) {
   InitMcFunc (& (pCtx->sMcFunc), uiCpuFlag);
   InitExpandPictureFunc (& (pCtx->sExpandPicFunc), uiCpuFlag);
   DeblockingInit (&pCtx->sDeblockingFunc, uiCpuFlag);
+  WelsInitOutputConvertFunc (&pCtx->sOutputConvertFunc, uiCpuFlag);
+  WelsInitNalScanFunc (&pCtx->pfFindNalSyntaxBytes, uiCpuFlag);
 }
 
 namespace {
@@ -207,19 +207,44 @@ static inline int32_t DecodeFrameConstruction (PWelsDecoderContext pCtx, uint8_t
 
   //////output:::normal path
   pDstInfo->uiOutYuvTimeStamp = pPic->uiTimeStamp;
-  ppDst[0]      = pPic->pData[0];
-  ppDst[1]      = pPic->pData[1];
-  ppDst[2]      = pPic->pData[2];
-
-  pDstInfo->UsrData.sSystemBuffer.iFormat = videoFormatI420;
-
   pDstInfo->UsrData.sSystemBuffer.iWidth = kiActualWidth;
   pDstInfo->UsrData.sSystemBuffer.iHeight = kiActualHeight;
-  pDstInfo->UsrData.sSystemBuffer.iStride[0] = pPic->iLinesize[0];
-  pDstInfo->UsrData.sSystemBuffer.iStride[1] = pPic->iLinesize[1];
-  ppDst[0] = ppDst[0] + pCtx->sFrameCrop.iTopOffset * 2 * pPic->iLinesize[0] + pCtx->sFrameCrop.iLeftOffset * 2;
-  ppDst[1] = ppDst[1] + pCtx->sFrameCrop.iTopOffset  * pPic->iLinesize[1] + pCtx->sFrameCrop.iLeftOffset;
-  ppDst[2] = ppDst[2] + pCtx->sFrameCrop.iTopOffset  * pPic->iLinesize[1] + pCtx->sFrameCrop.iLeftOffset;
+  if (pPic->pOutput[0] != NULL) {
+    // rows concealed after their conversion, or never passed through the deblocking stage, are converted here
+    if (pPic->iMbEcedNum > 0)
+      pPic->iOutputMbRows = 0;
+    WelsConvertOutputRows (&pCtx->sOutputConvertFunc, pPic, pPic->iHeightInPixel >> 4);
+  }
+  if (pPic->iOutputWidth > 0 && pPic->pOutput[0] != NULL) {
+    ppDst[0] = pPic->pOutput[0];
+    ppDst[1] = pPic->pOutput[1];
+    ppDst[2] = pPic->pOutput[2];
+    pDstInfo->UsrData.sSystemBuffer.iFormat = videoFormatI420;
+    pDstInfo->UsrData.sSystemBuffer.iStride[0] = pPic->iOutputStride[0];
+    pDstInfo->UsrData.sSystemBuffer.iStride[1] = pPic->iOutputStride[1];
+  } else if (pPic->pOutput[0] != NULL) {
+    const int32_t kiBpp = pPic->eOutputFormat == videoFormatBGR ? 3 : (pPic->eOutputFormat == videoFormatRGBA ? 4 : 1);
+    ppDst[0] = pPic->pOutput[0] + pCtx->sFrameCrop.iTopOffset * 2 * pPic->iOutputStride[0]
+               + pCtx->sFrameCrop.iLeftOffset * 2 * kiBpp;
+    ppDst[1] = pPic->pOutput[1] != NULL ? pPic->pOutput[1] + pCtx->sFrameCrop.iTopOffset * pPic->iOutputStride[1]
+               + pCtx->sFrameCrop.iLeftOffset * 2 : NULL;
+    ppDst[2] = NULL;
+    pDstInfo->UsrData.sSystemBuffer.iFormat = pPic->eOutputFormat;
+    pDstInfo->UsrData.sSystemBuffer.iStride[0] = pPic->iOutputStride[0];
+    pDstInfo->UsrData.sSystemBuffer.iStride[1] = pPic->iOutputStride[1];
+  } else {
+    ppDst[0]      = pPic->pData[0];
+    ppDst[1]      = pPic->pData[1];
+    ppDst[2]      = pPic->pData[2];
+
+    pDstInfo->UsrData.sSystemBuffer.iFormat = videoFormatI420;
+
+    pDstInfo->UsrData.sSystemBuffer.iStride[0] = pPic->iLinesize[0];
+    pDstInfo->UsrData.sSystemBuffer.iStride[1] = pPic->iLinesize[1];
+    ppDst[0] = ppDst[0] + pCtx->sFrameCrop.iTopOffset * 2 * pPic->iLinesize[0] + pCtx->sFrameCrop.iLeftOffset * 2;
+    ppDst[1] = ppDst[1] + pCtx->sFrameCrop.iTopOffset  * pPic->iLinesize[1] + pCtx->sFrameCrop.iLeftOffset;
+    ppDst[2] = ppDst[2] + pCtx->sFrameCrop.iTopOffset  * pPic->iLinesize[1] + pCtx->sFrameCrop.iLeftOffset;
+  }
   for (int i = 0; i < 3; ++i) {
     pDstInfo->pDst[i] = ppDst[i];
   }
@@ -246,6 +271,10 @@ static inline int32_t DecodeFrameConstruction (PWelsDecoderContext pCtx, uint8_t
   }
   pCtx->iLastImgWidthInPixel = pDstInfo->UsrData.sSystemBuffer.iWidth;
   pCtx->iLastImgHeightInPixel = pDstInfo->UsrData.sSystemBuffer.iHeight;
+  if (pPic->iOutputWidth > 0 && pPic->pOutput[0] != NULL) { // resolution changes are told by the decoded size
+    pDstInfo->UsrData.sSystemBuffer.iWidth = pPic->iOutputWidth;
+    pDstInfo->UsrData.sSystemBuffer.iHeight = pPic->iOutputHeight;
+  }
   if (pCtx->pParam->eEcActiveIdc == ERROR_CON_DISABLE) //no buffer output if EC is disabled and frame incomplete
     pDstInfo->iBufferStatus = (int32_t) (bFrameCompleteFlag
                                          && pPic->bIsComplete); // When EC disable, ECed picture not output
@@ -317,6 +346,51 @@ inline int32_t  WelsDecodeConstructSlice (PWelsDecoderContext pCtx, PNalUnit pCu
   return iRet;
 }
 
+/*
+ *  parse and reconstruct the slices queued for the slice threads, then take them over in slice order with the handling
+ *  DecodeCurrentAccessUnit() gives a slice decoded inline
+ */
+static int32_t  WelsDecodeConstructQueuedSlices (PWelsDecoderContext pCtx, bool* pAllRefComplete) {
+  PSliceThreads pThreads = &pCtx->sSliceThreads;
+  int32_t iRet = ERR_NONE;
+
+  WelsSliceThreadsRun (pCtx);
+  for (int32_t i = 0; i < pThreads->iJobNum; ++i) {
+    PSliceJob pJob = &pThreads->pJobs[i];
+    PNalUnit pNalCur = pJob->pNalCur;
+    if (pJob->iParseRet != ERR_NONE) {
+      WelsLog (& (pCtx->sLogCtx), WELS_LOG_WARNING,
+               "DecodeCurrentAccessUnit() failed (%d) in frame: %d uiDId: %d uiQId: %d",
+               pJob->iParseRet, pNalCur->sNalData.sVclNal.sSliceHeaderExt.sSliceHeader.iFrameNum,
+               pNalCur->sNalHeaderExt.uiDependencyId, pNalCur->sNalHeaderExt.uiQualityId);
+      *pAllRefComplete = false;
+      HandleReferenceLostL0 (pCtx, pNalCur);
+      if (pCtx->pParam->eEcActiveIdc == ERROR_CON_DISABLE) {
+        iRet = pJob->iParseRet;
+        if (pCtx->iTotalNumMbRec == 0)
+          pCtx->pDec = NULL;
+        break;
+      }
+    }
+
+    if ((iRet = WelsSliceThreadsFinish (pCtx, pJob)) != ERR_NONE) {
+      HandleReferenceLostL0 (pCtx, pNalCur);
+      pCtx->pDec->bIsComplete = false; // reconstruction error, directly set the flag false
+      break;
+    }
+    if (*pAllRefComplete && pCtx->eSliceType != I_SLICE) {
+      if (pCtx->sRefPic.uiRefCount[LIST_0] > 0) {
+        *pAllRefComplete &= CheckRefPicturesComplete (pCtx);
+      } else {
+        *pAllRefComplete = false;
+      }
+    }
+  }
+  pThreads->iJobNum = 0;
+
+  return iRet;
+}
+
 int32_t ParsePredWeightedTable (PBitStringAux pBs, PSliceHeader pSh) {
   uint32_t uiCode;
   int32_t iList = 0;
@@ -2597,6 +2671,9 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, SBuf
       pCtx->pDec->iMbNum = pCtx->pSps->iMbWidth * pCtx->pSps->iMbHeight;
       pCtx->pDec->iMbEcedNum = 0;
       pCtx->pDec->iMbEcedPropNum = 0;
+      pCtx->pDec->iOutputMbRows = 0;
+      pCtx->pDec->iScaledRows[0] = pCtx->pDec->iScaledRows[1] = 0;
+      pCtx->pDec->sOutputCrop = pCtx->pSps->sFrameCrop;
     }
     pCtx->bRPLRError = false;
     GetI4LumaIChromaAddrTable (pCtx->iDecBlockOffsetArray, pCtx->pDec->iLinesize[0], pCtx->pDec->iLinesize[1]);
@@ -2612,6 +2689,7 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, SBuf
      */
     while (iIdx <= iEndIdx) {
       bool         bReconstructSlice;
+      bool         bQueuedSlice = false;
       iCurrIdQ  = pNalCur->sNalHeaderExt.uiQualityId;
       iCurrIdD  = pNalCur->sNalHeaderExt.uiDependencyId;
       pSh       = &pNalCur->sNalData.sVclNal.sSliceHeaderExt.sSliceHeader;
@@ -2651,6 +2729,7 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, SBuf
           WelsLog (& (pCtx->sLogCtx), WELS_LOG_WARNING, "DecodeCurrentAccessUnit(), FmoParamUpdate failed, eSliceType: %d.",
                    pSh->eSliceType);
         }
+        WelsDecodeConstructQueuedSlices (pCtx, &bAllRefComplete);
         return GENERATE_ERROR_NO (ERR_LEVEL_SLICE_HEADER, ERR_INFO_FMO_INIT_FAIL);
       }
 
@@ -2674,7 +2753,8 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, SBuf
             //call GetPrevFrameNum() to get correct iPrevFrameNum to prevent frame gap warning
             iPrevFrameNum = pCtx->bNewSeqBegin ? 0 : GetPrevFrameNum (pCtx);
           }
-          if (!kbIdrFlag  &&
+          // the gaps left by DECODER_SKIP_NON_INTRA are the dropped pictures, which I pictures do not refer to
+          if (!kbIdrFlag  && pCtx->eSkipFrames != DECODER_SKIP_NON_INTRA &&
               pSh->iFrameNum != iPrevFrameNum &&
               pSh->iFrameNum != ((iPrevFrameNum + 1) & ((1 << dq_cur->sLayerInfo.pSps->uiLog2MaxFrameNum) -
                                  1))) {
@@ -2691,6 +2771,7 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, SBuf
 #else
               pCtx->bReferenceLostAtT0Flag = true;
 #endif
+              WelsDecodeConstructQueuedSlices (pCtx, &bAllRefComplete);
               return GENERATE_ERROR_NO (ERR_LEVEL_SLICE_HEADER, ERR_INFO_REFERENCE_PIC_LOST);
             }
           }
@@ -2707,6 +2788,7 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, SBuf
                      "reference picture introduced by this frame is lost during transmission! uiTId: %d",
                      pNalCur->sNalHeaderExt.uiTemporalId);
             if (pCtx->pParam->eEcActiveIdc == ERROR_CON_DISABLE) {
+              WelsDecodeConstructQueuedSlices (pCtx, &bAllRefComplete);
               if (pCtx->iTotalNumMbRec == 0)
                 pCtx->pDec = NULL;
               return iRet;
@@ -2723,7 +2805,19 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, SBuf
             SET_EVENT (&pThreadCtx->sSliceDecodeStart);
           }
           iRet = WelsDecodeAndConstructSlice (pCtx);
+        } else if (bReconstructSlice && WelsSliceThreadsQueue (pCtx, pNalCur)) {
+          bQueuedSlice = true; // parsed and reconstructed along with the other queued slices of the layer
+          iRet = ERR_NONE;
         } else {
+          // the queued slices go first, this one may change what they share; its layer is set up already
+          if (pCtx->sSliceThreads.iJobNum > 0) {
+            SDqLayer sDqLayer = *dq_cur;
+            SRefPic  sRefPic  = pCtx->sRefPic;
+            if ((iRet = WelsDecodeConstructQueuedSlices (pCtx, &bAllRefComplete)) != ERR_NONE)
+              return iRet;
+            *dq_cur       = sDqLayer;
+            pCtx->sRefPic = sRefPic;
+          }
           iRet = WelsDecodeSlice (pCtx, bFreshSliceAvailable, pNalCur);
         }
 
@@ -2741,13 +2835,13 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, SBuf
           }
         }
 
-        if (iThreadCount <= 1 && bReconstructSlice) {
+        if (iThreadCount <= 1 && bReconstructSlice && !bQueuedSlice) {
           if ((iRet = WelsDecodeConstructSlice (pCtx, pNalCur)) != ERR_NONE) {
             pCtx->pDec->bIsComplete = false; // reconstruction error, directly set the flag false
             return iRet;
           }
         }
-        if (bAllRefComplete && pCtx->eSliceType != I_SLICE) {
+        if (bAllRefComplete && pCtx->eSliceType != I_SLICE && !bQueuedSlice) {
           if (iThreadCount <= 1) {
             if (pCtx->sRefPic.uiRefCount[LIST_0] > 0) {
               bAllRefComplete &= CheckRefPicturesComplete (pCtx);
@@ -2778,6 +2872,11 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, SBuf
         break;
     }
 
+    // slices of the layer queued for the slice threads
+    if ((iRet = WelsDecodeConstructQueuedSlices (pCtx, &bAllRefComplete)) != ERR_NONE) {
+      return iRet;
+    }
+
     // Set the current dec picture complete flag. The flag will be reset when current picture need do ErrorCon.
     pCtx->pDec->bIsComplete = bAllRefComplete;
     if (!pCtx->pDec->bIsComplete) {  // Ref pictures ECed, result in ECed
@@ -2843,7 +2942,7 @@ int32_t DecodeCurrentAccessUnit (PWelsDecoderContext pCtx, uint8_t** ppDst, SBuf
               return iRet;
             }
           }
-          if (!pCtx->pParam->bParseOnly)
+          if (!pCtx->pParam->bParseOnly && !pCtx->bLazyBorderExpansion)
             ExpandReferencingPicture (pCtx->pDec->pData, pCtx->pDec->iWidthInPixel, pCtx->pDec->iHeightInPixel,
                                       pCtx->pDec->iLinesize,
                                       pCtx->sExpandPicFunc.pfExpandLumaPicture, pCtx->sExpandPicFunc.pfExpandChromaPicture);
@@ -443,9 +443,10 @@ int32_t MarkECFrameAsRef (PWelsDecoderContext pCtx) {
   if (iRet != ERR_NONE) {
     return iRet;
   }
-  ExpandReferencingPicture (pCtx->pDec->pData, pCtx->pDec->iWidthInPixel, pCtx->pDec->iHeightInPixel,
-                            pCtx->pDec->iLinesize,
-                            pCtx->sExpandPicFunc.pfExpandLumaPicture, pCtx->sExpandPicFunc.pfExpandChromaPicture);
+  if (!pCtx->bLazyBorderExpansion)
+    ExpandReferencingPicture (pCtx->pDec->pData, pCtx->pDec->iWidthInPixel, pCtx->pDec->iHeightInPixel,
+                              pCtx->pDec->iLinesize,
+                              pCtx->sExpandPicFunc.pfExpandLumaPicture, pCtx->sExpandPicFunc.pfExpandChromaPicture);
 
   return ERR_NONE;
 }
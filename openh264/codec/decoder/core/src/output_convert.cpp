@@ -0,0 +1,358 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ *
+ * \file    output_convert.cpp
+ *
+ * \brief   I420 to packed RGB / NV12 conversion and scaling of the decoder output
+ *
+ * \date    10/16/2026 Created
+ *
+ *************************************************************************************
+ */
+
+#include <string.h>
+#include "output_convert.h"
+#include "cpu_core.h"
+#include "macros.h"
+
+namespace WelsDec {
+
+// BT.601 limited range, 8 bit fixed point
+template<int32_t kiR, int32_t kiG, int32_t kiB, int32_t kiBpp>
+static inline void YuvToRgb (uint8_t* pDst, const int32_t kiY, const int32_t kiRv, const int32_t kiGuv,
+                             const int32_t kiBu) {
+  const int32_t kiLuma = 298 * (kiY - 16) + 128;
+  pDst[kiR] = WelsClip1 ((kiLuma + kiRv) >> 8);
+  pDst[kiG] = WelsClip1 ((kiLuma - kiGuv) >> 8);
+  pDst[kiB] = WelsClip1 ((kiLuma + kiBu) >> 8);
+  if (kiBpp == 4) {
+    pDst[3] = 255;
+  }
+}
+
+template<int32_t kiR, int32_t kiG, int32_t kiB, int32_t kiBpp>
+static void I420ToPackedRgb_c (uint8_t* pDst, int32_t iDstStride, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+                               const uint8_t* kpSrcV, int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth, int32_t iHeight) {
+  for (int32_t j = 0; j < iHeight; j += 2) {
+    const uint8_t* kpY0 = kpSrcY;
+    const uint8_t* kpY1 = kpSrcY + iSrcStrideY;
+    uint8_t* pDst0 = pDst;
+    uint8_t* pDst1 = pDst + iDstStride;
+    for (int32_t i = 0; i < iWidth; i += 2) {
+      const int32_t kiU = kpSrcU[i >> 1] - 128;
+      const int32_t kiV = kpSrcV[i >> 1] - 128;
+      const int32_t kiRv  = 409 * kiV;
+      const int32_t kiGuv = 100 * kiU + 208 * kiV;
+      const int32_t kiBu  = 516 * kiU;
+
+      YuvToRgb<kiR, kiG, kiB, kiBpp> (pDst0, kpY0[i], kiRv, kiGuv, kiBu);
+      YuvToRgb<kiR, kiG, kiB, kiBpp> (pDst0 + kiBpp, kpY0[i + 1], kiRv, kiGuv, kiBu);
+      YuvToRgb<kiR, kiG, kiB, kiBpp> (pDst1, kpY1[i], kiRv, kiGuv, kiBu);
+      YuvToRgb<kiR, kiG, kiB, kiBpp> (pDst1 + kiBpp, kpY1[i + 1], kiRv, kiGuv, kiBu);
+
+      pDst0 += kiBpp << 1;
+      pDst1 += kiBpp << 1;
+    }
+    kpSrcY += iSrcStrideY << 1;
+    kpSrcU += iSrcStrideUV;
+    kpSrcV += iSrcStrideUV;
+    pDst   += iDstStride << 1;
+  }
+}
+
+void WelsI420ToBgr_c (uint8_t* pDst, int32_t iDstStride, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+                      const uint8_t* kpSrcV, int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth, int32_t iHeight) {
+  I420ToPackedRgb_c<2, 1, 0, 3> (pDst, iDstStride, kpSrcY, kpSrcU, kpSrcV, iSrcStrideY, iSrcStrideUV, iWidth, iHeight);
+}
+
+void WelsI420ToRgba_c (uint8_t* pDst, int32_t iDstStride, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+                       const uint8_t* kpSrcV, int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth, int32_t iHeight) {
+  I420ToPackedRgb_c<0, 1, 2, 4> (pDst, iDstStride, kpSrcY, kpSrcU, kpSrcV, iSrcStrideY, iSrcStrideUV, iWidth, iHeight);
+}
+
+void WelsI420ToNv12_c (uint8_t* pDstY, uint8_t* pDstUV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                       const uint8_t* kpSrcY, const uint8_t* kpSrcU, const uint8_t* kpSrcV, int32_t iSrcStrideY,
+                       int32_t iSrcStrideUV, int32_t iWidth, int32_t iHeight) {
+  const int32_t kiWidthUV = iWidth >> 1;
+  for (int32_t j = 0; j < iHeight; j += 2) {
+    memcpy (pDstY, kpSrcY, iWidth); // confirmed_safe_unsafe_usage
+    memcpy (pDstY + iDstStrideY, kpSrcY + iSrcStrideY, iWidth); // confirmed_safe_unsafe_usage
+    for (int32_t i = 0; i < kiWidthUV; i++) {
+      pDstUV[i << 1]       = kpSrcU[i];
+      pDstUV[(i << 1) + 1] = kpSrcV[i];
+    }
+    pDstY  += iDstStrideY << 1;
+    kpSrcY += iSrcStrideY << 1;
+    pDstUV += iDstStrideUV;
+    kpSrcU += iSrcStrideUV;
+    kpSrcV += iSrcStrideUV;
+  }
+}
+
+#if defined(X86_ASM)
+typedef void (*PI420ToPackedRgbRowFunc) (uint8_t* pDst, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+    const uint8_t* kpSrcV, int32_t iWidth);
+typedef void (*PInterleaveUVRowFunc) (uint8_t* pDstUV, const uint8_t* kpSrcU, const uint8_t* kpSrcV, int32_t iWidthUV);
+
+// pfRow takes a multiple of kiAlign pixels, the columns right of them are left to the C code
+template<int32_t kiR, int32_t kiG, int32_t kiB, int32_t kiBpp, int32_t kiAlign>
+static void I420ToPackedRgbSimd (PI420ToPackedRgbRowFunc pfRow, uint8_t* pDst, int32_t iDstStride,
+                                 const uint8_t* kpSrcY, const uint8_t* kpSrcU, const uint8_t* kpSrcV,
+                                 int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth, int32_t iHeight) {
+  const int32_t kiSimdWidth = iWidth & (~ (kiAlign - 1));
+  if (kiSimdWidth > 0) {
+    for (int32_t j = 0; j < iHeight; j += 2) {
+      const uint8_t* kpU = kpSrcU + (j >> 1) * iSrcStrideUV;
+      const uint8_t* kpV = kpSrcV + (j >> 1) * iSrcStrideUV;
+      pfRow (pDst + j * iDstStride, kpSrcY + j * iSrcStrideY, kpU, kpV, kiSimdWidth);
+      pfRow (pDst + (j + 1) * iDstStride, kpSrcY + (j + 1) * iSrcStrideY, kpU, kpV, kiSimdWidth);
+    }
+  }
+  if (kiSimdWidth < iWidth) {
+    I420ToPackedRgb_c<kiR, kiG, kiB, kiBpp> (pDst + kiSimdWidth * kiBpp, iDstStride, kpSrcY + kiSimdWidth,
+        kpSrcU + (kiSimdWidth >> 1), kpSrcV + (kiSimdWidth >> 1), iSrcStrideY, iSrcStrideUV, iWidth - kiSimdWidth,
+        iHeight);
+  }
+}
+
+template<int32_t kiAlign>
+static void I420ToNv12Simd (PInterleaveUVRowFunc pfInterleave, uint8_t* pDstY, uint8_t* pDstUV, int32_t iDstStrideY,
+                            int32_t iDstStrideUV, const uint8_t* kpSrcY, const uint8_t* kpSrcU, const uint8_t* kpSrcV,
+                            int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth, int32_t iHeight) {
+  const int32_t kiWidthUV = iWidth >> 1;
+  const int32_t kiSimdWidthUV = kiWidthUV & (~ (kiAlign - 1));
+  for (int32_t j = 0; j < iHeight; j += 2) {
+    memcpy (pDstY, kpSrcY, iWidth); // confirmed_safe_unsafe_usage
+    memcpy (pDstY + iDstStrideY, kpSrcY + iSrcStrideY, iWidth); // confirmed_safe_unsafe_usage
+    if (kiSimdWidthUV > 0)
+      pfInterleave (pDstUV, kpSrcU, kpSrcV, kiSimdWidthUV);
+    for (int32_t i = kiSimdWidthUV; i < kiWidthUV; i++) {
+      pDstUV[i << 1]       = kpSrcU[i];
+      pDstUV[(i << 1) + 1] = kpSrcV[i];
+    }
+    pDstY  += iDstStrideY << 1;
+    kpSrcY += iSrcStrideY << 1;
+    pDstUV += iDstStrideUV;
+    kpSrcU += iSrcStrideUV;
+    kpSrcV += iSrcStrideUV;
+  }
+}
+
+void WelsI420ToBgr_sse2 (uint8_t* pDst, int32_t iDstStride, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+                         const uint8_t* kpSrcV, int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth,
+                         int32_t iHeight) {
+  I420ToPackedRgbSimd<2, 1, 0, 3, 8> (WelsI420ToBgrRow_sse2, pDst, iDstStride, kpSrcY, kpSrcU, kpSrcV, iSrcStrideY,
+                                      iSrcStrideUV, iWidth, iHeight);
+}
+
+void WelsI420ToRgba_sse2 (uint8_t* pDst, int32_t iDstStride, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+                          const uint8_t* kpSrcV, int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth,
+                          int32_t iHeight) {
+  I420ToPackedRgbSimd<0, 1, 2, 4, 8> (WelsI420ToRgbaRow_sse2, pDst, iDstStride, kpSrcY, kpSrcU, kpSrcV, iSrcStrideY,
+                                      iSrcStrideUV, iWidth, iHeight);
+}
+
+void WelsI420ToNv12_sse2 (uint8_t* pDstY, uint8_t* pDstUV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                          const uint8_t* kpSrcY, const uint8_t* kpSrcU, const uint8_t* kpSrcV, int32_t iSrcStrideY,
+                          int32_t iSrcStrideUV, int32_t iWidth, int32_t iHeight) {
+  I420ToNv12Simd<16> (WelsInterleaveUVRow_sse2, pDstY, pDstUV, iDstStrideY, iDstStrideUV, kpSrcY, kpSrcU, kpSrcV,
+                      iSrcStrideY, iSrcStrideUV, iWidth, iHeight);
+}
+
+#if defined(HAVE_AVX2)
+void WelsI420ToBgr_avx2 (uint8_t* pDst, int32_t iDstStride, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+                         const uint8_t* kpSrcV, int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth,
+                         int32_t iHeight) {
+  I420ToPackedRgbSimd<2, 1, 0, 3, 16> (WelsI420ToBgrRow_avx2, pDst, iDstStride, kpSrcY, kpSrcU, kpSrcV, iSrcStrideY,
+                                       iSrcStrideUV, iWidth, iHeight);
+}
+
+void WelsI420ToRgba_avx2 (uint8_t* pDst, int32_t iDstStride, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+                          const uint8_t* kpSrcV, int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth,
+                          int32_t iHeight) {
+  I420ToPackedRgbSimd<0, 1, 2, 4, 16> (WelsI420ToRgbaRow_avx2, pDst, iDstStride, kpSrcY, kpSrcU, kpSrcV, iSrcStrideY,
+                                       iSrcStrideUV, iWidth, iHeight);
+}
+
+void WelsI420ToNv12_avx2 (uint8_t* pDstY, uint8_t* pDstUV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                          const uint8_t* kpSrcY, const uint8_t* kpSrcU, const uint8_t* kpSrcV, int32_t iSrcStrideY,
+                          int32_t iSrcStrideUV, int32_t iWidth, int32_t iHeight) {
+  I420ToNv12Simd<32> (WelsInterleaveUVRow_avx2, pDstY, pDstUV, iDstStrideY, iDstStrideUV, kpSrcY, kpSrcU, kpSrcV,
+                      iSrcStrideY, iSrcStrideUV, iWidth, iHeight);
+}
+#endif//HAVE_AVX2
+#endif//X86_ASM
+
+// the scaler stays C: its 30 bit 2D weights need 64 bit products to match bit for bit
+void WelsInitOutputConvertFunc (SOutputConvertFunc* pFuncList, uint32_t uiCpuFlag) {
+  pFuncList->pfI420ToBgr   = WelsI420ToBgr_c;
+  pFuncList->pfI420ToRgba  = WelsI420ToRgba_c;
+  pFuncList->pfI420ToNv12  = WelsI420ToNv12_c;
+  pFuncList->pfScaleRows   = WelsGeneralBilinearDownsampleRows_c;
+
+#if defined(X86_ASM)
+  if (uiCpuFlag & WELS_CPU_SSE2) {
+    pFuncList->pfI420ToBgr   = WelsI420ToBgr_sse2;
+    pFuncList->pfI420ToRgba  = WelsI420ToRgba_sse2;
+    pFuncList->pfI420ToNv12  = WelsI420ToNv12_sse2;
+  }
+#if defined(HAVE_AVX2)
+  if (uiCpuFlag & WELS_CPU_AVX2) {
+    pFuncList->pfI420ToBgr   = WelsI420ToBgr_avx2;
+    pFuncList->pfI420ToRgba  = WelsI420ToRgba_avx2;
+    pFuncList->pfI420ToNv12  = WelsI420ToNv12_avx2;
+  }
+#endif//HAVE_AVX2
+#endif//X86_ASM
+}
+
+bool WelsIsOutputFormatSupported (const int32_t kiFormat) {
+  return kiFormat == videoFormatI420 || kiFormat == videoFormatBGR || kiFormat == videoFormatRGBA
+         || kiFormat == videoFormatNV12;
+}
+
+int32_t WelsOutputBufferSize (PPicture pPic) {
+  const int32_t kiPicWidth = pPic->iWidthInPixel;
+  const int32_t kiPicHeight = pPic->iHeightInPixel;
+  int32_t* pStride = pPic->iOutputStride;
+  if (pPic->iOutputWidth > 0) {
+    pStride[0] = WELS_ALIGN (pPic->iOutputWidth, 16);
+    pStride[1] = pStride[0] >> 1;
+    return pStride[0] * pPic->iOutputHeight + (pStride[1] * (pPic->iOutputHeight >> 1) << 1);
+  }
+  switch (pPic->eOutputFormat) {
+  case videoFormatBGR:
+    pStride[0] = pStride[1] = WELS_ALIGN (kiPicWidth * 3, 16);
+    return pStride[0] * kiPicHeight;
+  case videoFormatRGBA:
+    pStride[0] = pStride[1] = kiPicWidth << 2;
+    return pStride[0] * kiPicHeight;
+  case videoFormatNV12:
+    pStride[0] = pStride[1] = kiPicWidth;
+    return pStride[0] * kiPicHeight + pStride[1] * (kiPicHeight >> 1);
+  default:
+    pStride[0] = pStride[1] = 0;
+    return 0;
+  }
+}
+
+void WelsBindOutputBuffer (PPicture pPic, uint8_t* pBuffer) {
+  pPic->pOutput[0] = pBuffer;
+  pPic->pOutput[1] = pPic->pOutput[2] = NULL;
+  if (pPic->iOutputWidth > 0) {
+    pPic->pOutput[1] = pBuffer + pPic->iOutputStride[0] * pPic->iOutputHeight;
+    pPic->pOutput[2] = pPic->pOutput[1] + pPic->iOutputStride[1] * (pPic->iOutputHeight >> 1);
+  } else if (pPic->eOutputFormat == videoFormatNV12) {
+    pPic->pOutput[1] = pBuffer + pPic->iOutputStride[0] * pPic->iHeightInPixel;
+  }
+}
+
+/*
+ * Scale the rows of the cropped picture that only depend on the first kiEndMbY MB rows, all remaining
+ * rows once kiEndMbY reaches the bottom of the picture.
+ */
+static void ScaleOutputRows (const SOutputConvertFunc* pFunc, PPicture pPic, const int32_t kiEndMbY) {
+  const SPosOffset* kpCrop = &pPic->sOutputCrop;
+  const bool kbLastRow = (kiEndMbY << 4) >= pPic->iHeightInPixel;
+  for (int32_t i = 0; i < 3; i++) {
+    const int32_t kiShift = i > 0 ? 1 : 0; // crop offsets are in chroma samples
+    const int32_t kiSrcWidth = (pPic->iWidthInPixel >> kiShift) - ((kpCrop->iLeftOffset + kpCrop->iRightOffset) <<
+                               (1 - kiShift));
+    const int32_t kiSrcHeight = (pPic->iHeightInPixel >> kiShift) - ((kpCrop->iTopOffset + kpCrop->iBottomOffset) <<
+                                (1 - kiShift));
+    const int32_t kiSrcRows = ((kiEndMbY << 4) >> kiShift) - (kpCrop->iTopOffset << (1 - kiShift));
+    const int32_t kiDstWidth = pPic->iOutputWidth >> kiShift;
+    const int32_t kiDstHeight = pPic->iOutputHeight >> kiShift;
+    const int32_t kiFirstRow = pPic->iScaledRows[kiShift];
+    int32_t iEndRow = kbLastRow ? kiDstHeight : kiFirstRow;
+    while (iEndRow < kiDstHeight && WelsGeneralBilinearSrcRowsNeeded (kiDstHeight, kiSrcHeight, iEndRow) <= kiSrcRows)
+      ++iEndRow;
+    if (iEndRow <= kiFirstRow)
+      continue;
+    const uint8_t* kpSrc = pPic->pData[i] + (kpCrop->iTopOffset << (1 - kiShift)) * pPic->iLinesize[i]
+                           + (kpCrop->iLeftOffset << (1 - kiShift));
+    pFunc->pfScaleRows (pPic->pOutput[i], pPic->iOutputStride[kiShift], kiDstWidth, kiDstHeight, kpSrc,
+                        pPic->iLinesize[i], kiSrcWidth, kiSrcHeight, kiFirstRow, iEndRow);
+    if (i != 1)
+      pPic->iScaledRows[kiShift] = iEndRow;
+  }
+}
+
+static void ConvertOutputRows (const SOutputConvertFunc* pFunc, PPicture pPic, const int32_t kiMbY,
+                               const int32_t kiMbRows) {
+  if (pPic->iOutputWidth > 0) {
+    if (kiMbY == 0)
+      pPic->iScaledRows[0] = pPic->iScaledRows[1] = 0;
+    ScaleOutputRows (pFunc, pPic, kiMbY + kiMbRows);
+    return;
+  }
+  const int32_t kiY = kiMbY << 4;
+  const int32_t kiHeight = kiMbRows << 4;
+  const uint8_t* kpSrcY = pPic->pData[0] + kiY * pPic->iLinesize[0];
+  const uint8_t* kpSrcU = pPic->pData[1] + (kiY >> 1) * pPic->iLinesize[1];
+  const uint8_t* kpSrcV = pPic->pData[2] + (kiY >> 1) * pPic->iLinesize[2];
+  switch (pPic->eOutputFormat) {
+  case videoFormatBGR:
+    pFunc->pfI420ToBgr (pPic->pOutput[0] + kiY * pPic->iOutputStride[0], pPic->iOutputStride[0], kpSrcY, kpSrcU, kpSrcV,
+                        pPic->iLinesize[0], pPic->iLinesize[1], pPic->iWidthInPixel, kiHeight);
+    break;
+  case videoFormatRGBA:
+    pFunc->pfI420ToRgba (pPic->pOutput[0] + kiY * pPic->iOutputStride[0], pPic->iOutputStride[0], kpSrcY, kpSrcU, kpSrcV,
+                         pPic->iLinesize[0], pPic->iLinesize[1], pPic->iWidthInPixel, kiHeight);
+    break;
+  case videoFormatNV12:
+    pFunc->pfI420ToNv12 (pPic->pOutput[0] + kiY * pPic->iOutputStride[0], pPic->pOutput[1] + (kiY >> 1) * pPic->iOutputStride[1],
+                         pPic->iOutputStride[0], pPic->iOutputStride[1], kpSrcY, kpSrcU, kpSrcV,
+                         pPic->iLinesize[0], pPic->iLinesize[1], pPic->iWidthInPixel, kiHeight);
+    break;
+  default:
+    break;
+  }
+}
+
+void WelsConvertOutputRow (const SOutputConvertFunc* pFunc, PPicture pPic, const int32_t kiMbY) {
+  if (pPic->pOutput[0] == NULL || pPic->iOutputMbRows != kiMbY) {
+    return;
+  }
+  ConvertOutputRows (pFunc, pPic, kiMbY, 1);
+  pPic->iOutputMbRows = kiMbY + 1;
+}
+
+void WelsConvertOutputRows (const SOutputConvertFunc* pFunc, PPicture pPic, const int32_t kiEndMbY) {
+  if (pPic->pOutput[0] == NULL || pPic->iOutputMbRows >= kiEndMbY) {
+    return;
+  }
+  ConvertOutputRows (pFunc, pPic, pPic->iOutputMbRows, kiEndMbY - pPic->iOutputMbRows);
+  pPic->iOutputMbRows = kiEndMbY;
+}
+
+} // namespace WelsDec
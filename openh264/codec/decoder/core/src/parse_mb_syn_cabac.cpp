@@ -1318,47 +1318,17 @@ int32_t ParseCbfInfoCabac (PWelsNeighAvail pNeighAvail, uint8_t* pNzcCache, int3
 
 int32_t ParseSignificantMapCabac (int32_t* pSignificantMap, int32_t iResProperty, PWelsDecoderContext pCtx,
                                   uint32_t& uiCoeffNum) {
-  uint32_t uiCode;
-
   PWelsCabacCtx pMapCtx  = pCtx->pCabacCtx + (iResProperty == LUMA_DC_AC_8 ? NEW_CTX_OFFSET_MAP_8x8 : NEW_CTX_OFFSET_MAP)
                            + g_kBlockCat2CtxOffsetMap [iResProperty];
   PWelsCabacCtx pLastCtx = pCtx->pCabacCtx + (iResProperty == LUMA_DC_AC_8 ? NEW_CTX_OFFSET_LAST_8x8 :
                            NEW_CTX_OFFSET_LAST) + g_kBlockCat2CtxOffsetLast[iResProperty];
 
-
-  int32_t i;
-  uiCoeffNum = 0;
-  int32_t i0 = 0;
-  int32_t i1 = g_kMaxPos[iResProperty];
-
-  int32_t iCtx;
-
-  for (i = i0; i < i1; ++i) {
-    iCtx = (iResProperty == LUMA_DC_AC_8 ? g_kuiIdx2CtxSignificantCoeffFlag8x8[i] : i);
-    //read significant
-    WELS_READ_VERIFY (DecodeBinCabac (pCtx->pCabacDecEngine, pMapCtx + iCtx, uiCode));
-    if (uiCode) {
-      * (pSignificantMap++) = 1;
-      ++ uiCoeffNum;
-      //read last significant
-      iCtx = (iResProperty == LUMA_DC_AC_8 ? g_kuiIdx2CtxLastSignificantCoeffFlag8x8[i] : i);
-      WELS_READ_VERIFY (DecodeBinCabac (pCtx->pCabacDecEngine, pLastCtx + iCtx, uiCode));
-      if (uiCode) {
-        memset (pSignificantMap, 0, (i1 - i) * sizeof (int32_t));
-        return ERR_NONE;
-      }
-    } else
-      * (pSignificantMap++) = 0;
-  }
-
-  //deal with last pSignificantMap if no data
-  //if(i < i1+1)
-  {
-    *pSignificantMap = 1;
-    ++uiCoeffNum;
+  if (iResProperty == LUMA_DC_AC_8) {
+    return DecodeSignificanceMapCabac (pCtx->pCabacDecEngine, pMapCtx, pLastCtx, g_kuiIdx2CtxSignificantCoeffFlag8x8,
+                                       g_kuiIdx2CtxLastSignificantCoeffFlag8x8, g_kMaxPos[iResProperty], pSignificantMap, uiCoeffNum);
   }
-
-  return ERR_NONE;
+  return DecodeSignificanceMapCabac (pCtx->pCabacDecEngine, pMapCtx, pLastCtx, NULL, NULL, g_kMaxPos[iResProperty],
+                                     pSignificantMap, uiCoeffNum);
 }
 
 int32_t ParseSignificantCoeffCabac (int32_t* pSignificant, int32_t iResProperty, PWelsDecoderContext pCtx) {
@@ -41,6 +41,7 @@
 #include "decoder_context.h"
 #include "codec_def.h"
 #include "memory_align.h"
+#include "output_convert.h"
 
 namespace WelsDec {
 
@@ -59,13 +60,54 @@ void FreePicture (PPicture pPic, CMemoryAlign* pMa);
 
 
 
-PPicture AllocPicture (PWelsDecoderContext pCtx, const int32_t kiPicWidth, const int32_t kiPicHeight) {
-  PPicture pPic = NULL;
-  int32_t iPicWidth = 0;
-  int32_t iPicHeight = 0;
+static void PictureBufferSize (const int32_t kiPicWidth, const int32_t kiPicHeight, int32_t* pLumaSize,
+                               int32_t* pChromaSize) {
+  int32_t iPicWidth = WELS_ALIGN (kiPicWidth + (PADDING_LENGTH << 1), PICTURE_RESOLUTION_ALIGNMENT);
+  int32_t iPicHeight = WELS_ALIGN (kiPicHeight + (PADDING_LENGTH << 1), PICTURE_RESOLUTION_ALIGNMENT);
+  *pLumaSize   = iPicWidth * iPicHeight;
+  *pChromaSize = (iPicWidth >> 1) * (iPicHeight >> 1);
+}
+
+static void BindPictureBuffer (PPicture pPic, uint8_t* pBuffer, const int32_t kiLumaSize, const int32_t kiChromaSize) {
+  pPic->pBuffer[0]   = pBuffer;
+  pPic->pBuffer[1]   = pPic->pBuffer[0] + kiLumaSize;
+  pPic->pBuffer[2]   = pPic->pBuffer[1] + kiChromaSize;
+  pPic->pData[0]     = pPic->pBuffer[0] + (1 + pPic->iLinesize[0]) * PADDING_LENGTH;
+  pPic->pData[1]     = pPic->pBuffer[1] + /*WELS_ALIGN*/ (((1 + pPic->iLinesize[1]) * PADDING_LENGTH) >> 1);
+  pPic->pData[2]     = pPic->pBuffer[2] + /*WELS_ALIGN*/ (((1 + pPic->iLinesize[2]) * PADDING_LENGTH) >> 1);
+}
 
-  int32_t iPicChromaWidth   = 0;
-  int32_t iPicChromaHeight  = 0;
+/*
+ * Swap the application buffer of a recycled picture for a fresh one, so that the application may keep
+ * reading the picture it was given last time this one was output.
+ */
+static void RenewPictureBuffer (PPicture pPic) {
+  const SDecoderFrameAllocator* pAllocator = pPic->pFrameAllocator;
+  if (NULL == pAllocator)
+    return;
+  int32_t iLumaSize = 0, iChromaSize = 0, iSize;
+  if (pPic->pOutput[0] != NULL) {
+    iSize = WelsOutputBufferSize (pPic);
+  } else {
+    PictureBufferSize (pPic->iWidthInPixel, pPic->iHeightInPixel, &iLumaSize, &iChromaSize);
+    iSize = iLumaSize + (iChromaSize << 1);
+  }
+  void* pUserFrame = NULL;
+  uint8_t* pBuffer = pAllocator->pfGetBuffer (pAllocator->pUserData, iSize, &pUserFrame);
+  if (NULL == pBuffer)
+    return; // keep decoding into the previous buffer
+  pAllocator->pfReleaseBuffer (pAllocator->pUserData, pPic->pUserFrame);
+  pPic->pUserFrame = pUserFrame;
+  if (pPic->pOutput[0] != NULL) {
+    WelsBindOutputBuffer (pPic, pBuffer);
+  } else {
+    BindPictureBuffer (pPic, pBuffer, iLumaSize, iChromaSize);
+  }
+}
+
+static PPicture AllocPictureFrom (PWelsDecoderContext pCtx, const int32_t kiPicWidth, const int32_t kiPicHeight,
+                                  const SDecoderFrameAllocator* pAllocator) {
+  PPicture pPic = NULL;
   int32_t iLumaSize         = 0;
   int32_t iChromaSize       = 0;
   CMemoryAlign* pMa = pCtx->pMemAlign;
@@ -75,36 +117,51 @@ PPicture AllocPicture (PWelsDecoderContext pCtx, const int32_t kiPicWidth, const
 
   memset (pPic, 0, sizeof (SPicture));
 
-  iPicWidth = WELS_ALIGN (kiPicWidth + (PADDING_LENGTH << 1), PICTURE_RESOLUTION_ALIGNMENT);
-  iPicHeight = WELS_ALIGN (kiPicHeight + (PADDING_LENGTH << 1), PICTURE_RESOLUTION_ALIGNMENT);
-  iPicChromaWidth   = iPicWidth >> 1;
-  iPicChromaHeight  = iPicHeight >> 1;
-
-  iLumaSize     = iPicWidth * iPicHeight;
-  iChromaSize   = iPicChromaWidth * iPicChromaHeight;
+  PictureBufferSize (kiPicWidth, kiPicHeight, &iLumaSize, &iChromaSize);
+  pPic->iLinesize[0] = WELS_ALIGN (kiPicWidth + (PADDING_LENGTH << 1), PICTURE_RESOLUTION_ALIGNMENT);
+  pPic->iLinesize[1] = pPic->iLinesize[2] = pPic->iLinesize[0] >> 1;
+  pPic->eOutputFormat = pCtx->eOutputFormat;
+  pPic->iOutputWidth  = pCtx->sScaledOutput.iWidth;
+  pPic->iOutputHeight = pCtx->sScaledOutput.iHeight;
+  pPic->iWidthInPixel  = kiPicWidth;
+  pPic->iHeightInPixel = kiPicHeight;
 
   if (pCtx->pParam->bParseOnly) {
     pPic->pBuffer[0] = pPic->pBuffer[1] = pPic->pBuffer[2] = NULL;
     pPic->pData[0] = pPic->pData[1] = pPic->pData[2] = NULL;
-    pPic->iLinesize[0] = iPicWidth;
-    pPic->iLinesize[1] = pPic->iLinesize[2] = iPicChromaWidth;
   } else {
-    pPic->pBuffer[0] = static_cast<uint8_t*> (pMa->WelsMallocz (iLumaSize /* luma */
-                       + (iChromaSize << 1) /* Cb,Cr */, "_pic->buffer[0]"));
-    WELS_VERIFY_RETURN_PROC_IF (NULL, NULL == pPic->pBuffer[0], FreePicture (pPic, pMa));
-
-    memset (pPic->pBuffer[0], 128, (iLumaSize + (iChromaSize << 1)));
-    pPic->iLinesize[0] = iPicWidth;
-    pPic->iLinesize[1] = pPic->iLinesize[2] = iPicChromaWidth;
-    pPic->pBuffer[1]   = pPic->pBuffer[0] + iLumaSize;
-    pPic->pBuffer[2]   = pPic->pBuffer[1] + iChromaSize;
-    pPic->pData[0]     = pPic->pBuffer[0] + (1 + pPic->iLinesize[0]) * PADDING_LENGTH;
-    pPic->pData[1]     = pPic->pBuffer[1] + /*WELS_ALIGN*/ (((1 + pPic->iLinesize[1]) * PADDING_LENGTH) >> 1);
-    pPic->pData[2]     = pPic->pBuffer[2] + /*WELS_ALIGN*/ (((1 + pPic->iLinesize[2]) * PADDING_LENGTH) >> 1);
+    // the application allocates what is output: the converted or scaled picture if there is one, otherwise the picture
+    const int32_t kiOutputSize = WelsOutputBufferSize (pPic);
+    uint8_t* pBuffer = NULL;
+    if (pAllocator != NULL && kiOutputSize == 0) {
+      pBuffer = pAllocator->pfGetBuffer (pAllocator->pUserData, iLumaSize + (iChromaSize << 1), &pPic->pUserFrame);
+      if (pBuffer != NULL)
+        pPic->pFrameAllocator = pAllocator;
+    }
+    if (NULL == pBuffer) {
+      pBuffer = static_cast<uint8_t*> (pMa->WelsMallocz (iLumaSize /* luma */
+                                       + (iChromaSize << 1) /* Cb,Cr */, "_pic->buffer[0]"));
+      WELS_VERIFY_RETURN_PROC_IF (NULL, NULL == pBuffer, FreePicture (pPic, pMa));
+    }
+
+    memset (pBuffer, 128, (iLumaSize + (iChromaSize << 1)));
+    BindPictureBuffer (pPic, pBuffer, iLumaSize, iChromaSize);
+
+    if (kiOutputSize > 0) {
+      uint8_t* pOutput = NULL;
+      if (pAllocator != NULL) {
+        pOutput = pAllocator->pfGetBuffer (pAllocator->pUserData, kiOutputSize, &pPic->pUserFrame);
+        if (pOutput != NULL)
+          pPic->pFrameAllocator = pAllocator;
+      }
+      if (NULL == pOutput) {
+        pOutput = static_cast<uint8_t*> (pMa->WelsMallocz (kiOutputSize, "pPic->pOutput[0]"));
+        WELS_VERIFY_RETURN_PROC_IF (NULL, NULL == pOutput, FreePicture (pPic, pMa));
+      }
+      WelsBindOutputBuffer (pPic, pOutput);
+    }
   }
   pPic->iPlanes        = 3;    // yv12 in default
-  pPic->iWidthInPixel  = kiPicWidth;
-  pPic->iHeightInPixel = kiPicHeight;
   pPic->iFrameNum      = -1;
   pPic->iRefCount = 0;
 
@@ -135,8 +192,29 @@ PPicture AllocPicture (PWelsDecoderContext pCtx, const int32_t kiPicWidth, const
   return pPic;
 }
 
+PPicture AllocPicture (PWelsDecoderContext pCtx, const int32_t kiPicWidth, const int32_t kiPicHeight) {
+  return AllocPictureFrom (pCtx, kiPicWidth, kiPicHeight, NULL);
+}
+
+PPicture AllocPicBuffPicture (PWelsDecoderContext pCtx, const int32_t kiPicWidth, const int32_t kiPicHeight) {
+  return AllocPictureFrom (pCtx, kiPicWidth, kiPicHeight, pCtx->pFrameAllocator);
+}
+
 void FreePicture (PPicture pPic, CMemoryAlign* pMa) {
   if (NULL != pPic) {
+    if (pPic->pFrameAllocator != NULL) {
+      pPic->pFrameAllocator->pfReleaseBuffer (pPic->pFrameAllocator->pUserData, pPic->pUserFrame);
+      pPic->pFrameAllocator = NULL;
+      if (pPic->pOutput[0] != NULL) {
+        pPic->pOutput[0] = NULL;
+      } else {
+        pPic->pBuffer[0] = NULL;
+      }
+    }
+    if (pPic->pOutput[0]) {
+      pMa->WelsFree (pPic->pOutput[0], "pPic->pOutput[0]");
+      pPic->pOutput[0] = NULL;
+    }
     if (pPic->pBuffer[0]) {
       pMa->WelsFree (pPic->pBuffer[0], "pPic->pBuffer[0]");
       pPic->pBuffer[0] = NULL;
@@ -198,6 +276,7 @@ PPicture PrefetchPic (PPicBuff pPicBuf) {
   if (pPic != NULL) {
     pPicBuf->iCurrentIdx = iPicIdx;
     pPic->iPicBuffIdx = iPicIdx;
+    RenewPictureBuffer (pPic);
     return pPic;
   }
   for (iPicIdx = 0 ; iPicIdx <= pPicBuf->iCurrentIdx ; ++iPicIdx) {
@@ -211,6 +290,7 @@ PPicture PrefetchPic (PPicBuff pPicBuf) {
   pPicBuf->iCurrentIdx = iPicIdx;
   if (pPic != NULL) {
     pPic->iPicBuffIdx = iPicIdx;
+    RenewPictureBuffer (pPic);
   }
   return pPic;
 }
@@ -241,4 +321,28 @@ PPicture PrefetchLastPicForThread (PPicBuff pPicBuf, const int32_t& iLastPicBuff
   return pPic;
 }
 
+// the output planes may start past the buffer base by the cropping offsets, but never leave the buffer
+void* PicBuffUserFrame (PPicBuff pPicBuff, const uint8_t* kpDst) {
+  if (NULL == pPicBuff || NULL == kpDst)
+    return NULL;
+  for (int32_t i = 0; i < pPicBuff->iCapacity; ++i) {
+    PPicture pPic = pPicBuff->ppPic[i];
+    if (NULL == pPic || NULL == pPic->pFrameAllocator)
+      continue;
+    int32_t iLumaSize = 0, iChromaSize = 0, iSize;
+    const uint8_t* pBase;
+    if (pPic->pOutput[0] != NULL) {
+      pBase = pPic->pOutput[0];
+      iSize = WelsOutputBufferSize (pPic);
+    } else {
+      pBase = pPic->pBuffer[0];
+      PictureBufferSize (pPic->iWidthInPixel, pPic->iHeightInPixel, &iLumaSize, &iChromaSize);
+      iSize = iLumaSize + (iChromaSize << 1);
+    }
+    if (kpDst >= pBase && kpDst < pBase + iSize)
+      return pPic->pUserFrame;
+  }
+  return NULL;
+}
+
 } // namespace WelsDec
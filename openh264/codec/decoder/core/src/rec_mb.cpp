@@ -241,6 +241,9 @@ static inline int32_t GetRefPic (sMCRefMember* pMCRefMem, PWelsDecoderContext pC
 #ifndef MC_FLOW_SIMPLE_JUDGE
 #define MC_FLOW_SIMPLE_JUDGE 1
 #endif //MC_FLOW_SIMPLE_JUDGE
+// strides of the edge emulated blocks, room for the widest block and the over-read of the SIMD filters
+#define MC_EDGE_STRIDE_LUMA   32
+#define MC_EDGE_STRIDE_CHROMA 16
 void BaseMC (PWelsDecoderContext pCtx, sMCRefMember* pMCRefMem, const int32_t& listIdx, const int8_t& iRefIdx,
              int32_t iXOffset, int32_t iYOffset,
              SMcFunc* pMCFunc,
@@ -285,12 +288,38 @@ void BaseMC (PWelsDecoderContext pCtx, sMCRefMember* pMCRefMem, const int32_t& l
   uint8_t* pDstY = pMCRefMem->pDstY;
   uint8_t* pDstU = pMCRefMem->pDstU;
   uint8_t* pDstV = pMCRefMem->pDstV;
+  int32_t iSrcLineLuma = pMCRefMem->iSrcLineLuma;
+  int32_t iSrcLineChroma = pMCRefMem->iSrcLineChroma;
+
+  // without border expansion, a block whose 6-tap support leaves the picture is read from an edge emulated copy;
+  // the chroma support stays inside whenever the luma one does
+  ENFORCE_STACK_ALIGN_1D (uint8_t, uiEdgeY, MC_EDGE_STRIDE_LUMA * (16 + 6), 16);
+  ENFORCE_STACK_ALIGN_1D (uint8_t, uiEdgeU, MC_EDGE_STRIDE_CHROMA * (8 + 2), 16);
+  ENFORCE_STACK_ALIGN_1D (uint8_t, uiEdgeV, MC_EDGE_STRIDE_CHROMA * (8 + 2), 16);
+  const int32_t kiPosX = iFullMVx >> 2;
+  const int32_t kiPosY = iFullMVy >> 2;
+  if (pCtx->bLazyBorderExpansion && (kiPosX < 2 || kiPosY < 2 || kiPosX + iBlkWidth + 3 > pMCRefMem->iPicWidth
+                                     || kiPosY + iBlkHeight + 3 > pMCRefMem->iPicHeight)) {
+    const int32_t kiPosXChroma = iFullMVx >> 3;
+    const int32_t kiPosYChroma = iFullMVy >> 3;
+    McEmulateEdge_c (uiEdgeY, MC_EDGE_STRIDE_LUMA, pMCRefMem->pSrcY, iSrcLineLuma, kiPosX - 2, kiPosY - 2,
+                     iBlkWidth + 5, iBlkHeight + 5, pMCRefMem->iPicWidth, pMCRefMem->iPicHeight);
+    McEmulateEdge_c (uiEdgeU, MC_EDGE_STRIDE_CHROMA, pMCRefMem->pSrcU, iSrcLineChroma, kiPosXChroma, kiPosYChroma,
+                     iBlkWidthChroma + 1, iBlkHeightChroma + 1, pMCRefMem->iPicWidth >> 1, pMCRefMem->iPicHeight >> 1);
+    McEmulateEdge_c (uiEdgeV, MC_EDGE_STRIDE_CHROMA, pMCRefMem->pSrcV, iSrcLineChroma, kiPosXChroma, kiPosYChroma,
+                     iBlkWidthChroma + 1, iBlkHeightChroma + 1, pMCRefMem->iPicWidth >> 1, pMCRefMem->iPicHeight >> 1);
+    pSrcY = uiEdgeY + 2 * MC_EDGE_STRIDE_LUMA + 2;
+    pSrcU = uiEdgeU;
+    pSrcV = uiEdgeV;
+    iSrcLineLuma = MC_EDGE_STRIDE_LUMA;
+    iSrcLineChroma = MC_EDGE_STRIDE_CHROMA;
+  }
 
-  pMCFunc->pMcLumaFunc (pSrcY, pMCRefMem->iSrcLineLuma, pDstY, pMCRefMem->iDstLineLuma, iFullMVx, iFullMVy, iBlkWidth,
+  pMCFunc->pMcLumaFunc (pSrcY, iSrcLineLuma, pDstY, pMCRefMem->iDstLineLuma, iFullMVx, iFullMVy, iBlkWidth,
                         iBlkHeight);
-  pMCFunc->pMcChromaFunc (pSrcU, pMCRefMem->iSrcLineChroma, pDstU, pMCRefMem->iDstLineChroma, iFullMVx, iFullMVy,
+  pMCFunc->pMcChromaFunc (pSrcU, iSrcLineChroma, pDstU, pMCRefMem->iDstLineChroma, iFullMVx, iFullMVy,
                           iBlkWidthChroma, iBlkHeightChroma);
-  pMCFunc->pMcChromaFunc (pSrcV, pMCRefMem->iSrcLineChroma, pDstV, pMCRefMem->iDstLineChroma, iFullMVx, iFullMVy,
+  pMCFunc->pMcChromaFunc (pSrcV, iSrcLineChroma, pDstV, pMCRefMem->iDstLineChroma, iFullMVx, iFullMVy,
                           iBlkWidthChroma, iBlkHeightChroma);
 
 }
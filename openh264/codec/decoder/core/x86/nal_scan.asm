@@ -0,0 +1,114 @@
+;*!
+;* \copy
+;*     Copyright (c)  2009-2013, Cisco Systems
+;*     All rights reserved.
+;*
+;*     Redistribution and use in source and binary forms, with or without
+;*     modification, are permitted provided that the following conditions
+;*     are met:
+;*
+;*        * Redistributions of source code must retain the above copyright
+;*          notice, this list of conditions and the following disclaimer.
+;*
+;*        * Redistributions in binary form must reproduce the above copyright
+;*          notice, this list of conditions and the following disclaimer in
+;*          the documentation and/or other materials provided with the
+;*          distribution.
+;*
+;*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+;*     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+;*     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+;*     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+;*     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+;*     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+;*     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+;*     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+;*     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+;*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+;*     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+;*     POSSIBILITY OF SUCH DAMAGE.
+;*
+;*
+;*  nal_scan.asm
+;*
+;*  Abstract
+;*      search of the 0x 00 00 0x (x <= 3) triples of a NAL bitstream
+;*
+;*  History
+;*      10/17/2026 Created
+;*
+;*
+;*************************************************************************/
+
+%include "asm_inc.asm"
+
+SECTION .text
+
+;***********************************************************************
+;   int32_t WelsScanNalSyntaxBytes_sse2 (const uint8_t* kpBuf, int32_t iScanSize);
+;   iScanSize is a multiple of 16 and the 2 bytes following it are read;
+;   returns the offset of the first 16 byte block a triple starts in, iScanSize if there is none
+;***********************************************************************
+WELS_EXTERN WelsScanNalSyntaxBytes_sse2
+    push r3
+    %assign push_num 1
+    LOAD_2_PARA
+    SIGN_EXTENSION r1, r1d
+    xor             r2, r2
+    pxor            xmm3, xmm3
+    pcmpeqb         xmm4, xmm4
+    paddb           xmm4, xmm4
+    paddb           xmm4, xmm4              ; 0xfc, the bits a byte above 3 has
+.loop:
+    movdqu          xmm0, [r0 + r2]
+    movdqu          xmm1, [r0 + r2 + 1]
+    movdqu          xmm2, [r0 + r2 + 2]
+    por             xmm0, xmm1
+    pand            xmm2, xmm4
+    por             xmm0, xmm2
+    pcmpeqb         xmm0, xmm3
+    pmovmskb        r3d, xmm0
+    test            r3d, r3d
+    jnz             .done
+    add             r2, 16
+    cmp             r2, r1
+    jl              .loop
+.done:
+    mov             retrd, r2d
+    pop r3
+    ret
+
+%ifdef HAVE_AVX2
+;***********************************************************************
+;   int32_t WelsScanNalSyntaxBytes_avx2 (const uint8_t* kpBuf, int32_t iScanSize);
+;   iScanSize is a multiple of 32 and the 2 bytes following it are read;
+;   returns the offset of the first 32 byte block a triple starts in, iScanSize if there is none
+;***********************************************************************
+WELS_EXTERN WelsScanNalSyntaxBytes_avx2
+    push r3
+    %assign push_num 1
+    LOAD_2_PARA
+    SIGN_EXTENSION r1, r1d
+    xor             r2, r2
+    vpxor           ymm3, ymm3, ymm3
+    vpcmpeqb        ymm4, ymm4, ymm4
+    vpaddb          ymm4, ymm4, ymm4
+    vpaddb          ymm4, ymm4, ymm4
+.loop:
+    vmovdqu         ymm0, [r0 + r2]
+    vpor            ymm0, ymm0, [r0 + r2 + 1]
+    vpand           ymm2, ymm4, [r0 + r2 + 2]
+    vpor            ymm0, ymm0, ymm2
+    vpcmpeqb        ymm0, ymm0, ymm3
+    vpmovmskb       r3d, ymm0
+    test            r3d, r3d
+    jnz             .done
+    add             r2, 32
+    cmp             r2, r1
+    jl              .loop
+.done:
+    vzeroupper
+    mov             retrd, r2d
+    pop r3
+    ret
+%endif ; HAVE_AVX2
@@ -0,0 +1,345 @@
+;*!
+;* \copy
+;*     Copyright (c)  2009-2013, Cisco Systems
+;*     All rights reserved.
+;*
+;*     Redistribution and use in source and binary forms, with or without
+;*     modification, are permitted provided that the following conditions
+;*     are met:
+;*
+;*        * Redistributions of source code must retain the above copyright
+;*          notice, this list of conditions and the following disclaimer.
+;*
+;*        * Redistributions in binary form must reproduce the above copyright
+;*          notice, this list of conditions and the following disclaimer in
+;*          the documentation and/or other materials provided with the
+;*          distribution.
+;*
+;*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+;*     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+;*     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+;*     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+;*     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+;*     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+;*     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+;*     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+;*     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+;*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+;*     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+;*     POSSIBILITY OF SUCH DAMAGE.
+;*
+;*
+;*  output_convert.asm
+;*
+;*  Abstract
+;*      I420 to packed RGB / NV12 conversion of the decoder output
+;*
+;*  History
+;*      10/17/2026 Created
+;*
+;*
+;*************************************************************************/
+
+%include "asm_inc.asm"
+
+;***********************************************************************
+; Local Data (Read Only)
+;***********************************************************************
+
+SECTION .rodata align=16
+
+; BT.601 limited range, 8 bit fixed point; a luma word is paired with 1 and a chroma word U - 128 with V - 128
+align 16
+luma_coef: times 8 dw 298, -4640        ; 298 * (Y - 16) + 128
+rv_coef: times 8 dw 0, 409
+guv_coef: times 8 dw -100, -208
+bu_coef: times 8 dw 516, 0
+word_1: times 16 dw 1
+word_128: times 16 dw 128
+word_255: times 16 dw 255
+qword_lo3_mask: times 2 db 0xff, 0xff, 0xff, 0, 0, 0, 0, 0
+qword_mid3_mask: times 2 db 0, 0, 0, 0xff, 0xff, 0xff, 0, 0
+bgrx_to_bgr_shuf: times 2 db 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 0x80, 0x80, 0x80, 0x80
+
+;***********************************************************************
+; Code
+;***********************************************************************
+
+SECTION .text
+
+; the packed kernels convert one row, r0 = pDst, r1 = kpY, r2 = kpU, r3 = kpV, r4 = iWidth which counts down;
+; xmm0 / xmm2 hold the luma terms of the pixels 0-3 / 4-7 as dwords, xmm1 the words U - 128, V - 128 of 4 pairs
+
+; dst = 8 words of the clipped channel with the chroma term given by coef, tmp is destroyed
+%macro SSE2_ChannelWords 3 ; dst, tmp, coef
+    movdqa          %2, xmm1
+    pmaddwd         %2, %3
+    pshufd          %1, %2, 0x50
+    pshufd          %2, %2, 0xfa
+    paddd           %1, xmm0
+    paddd           %2, xmm2
+    psrad           %1, 8
+    psrad           %2, 8
+    packssdw        %1, %2
+%endmacro
+
+; R, G, B words of 8 pixels into xmm4, xmm5, xmm6, xmm7 is 0
+%macro SSE2_YuvToRgb8P 0
+    movq            xmm0, [r1]
+    punpcklbw       xmm0, xmm7
+    movd            xmm1, [r2]
+    movd            xmm2, [r3]
+    punpcklbw       xmm1, xmm2
+    punpcklbw       xmm1, xmm7
+    psubw           xmm1, [pic(word_128)]
+    movdqa          xmm2, xmm0
+    punpcklwd       xmm0, [pic(word_1)]
+    punpckhwd       xmm2, [pic(word_1)]
+    pmaddwd         xmm0, [pic(luma_coef)]
+    pmaddwd         xmm2, [pic(luma_coef)]
+    SSE2_ChannelWords xmm4, xmm3, [pic(rv_coef)]
+    SSE2_ChannelWords xmm5, xmm3, [pic(guv_coef)]
+    SSE2_ChannelWords xmm6, xmm3, [pic(bu_coef)]
+%endmacro
+
+; the 4 dwords B G R x of x into its low 12 bytes B G R, the high 4 bytes are cleared
+%macro SSE2_Bgrx4ToBgr 2 ; x, tmp
+    movdqa          %2, %1
+    psrlq           %2, 8
+    pand            %1, [pic(qword_lo3_mask)]
+    pand            %2, [pic(qword_mid3_mask)]
+    por             %1, %2
+    movdqa          %2, %1
+    psrldq          %2, 8
+    pslldq          %2, 6
+    movq            %1, %1
+    por             %1, %2
+%endmacro
+
+%macro SSE2_StoreBgr8P 0
+    packuswb        xmm6, xmm4
+    packuswb        xmm5, xmm7
+    movdqa          xmm0, xmm6
+    punpcklbw       xmm0, xmm5
+    punpckhbw       xmm6, xmm5
+    movdqa          xmm1, xmm0
+    punpcklwd       xmm0, xmm6
+    punpckhwd       xmm1, xmm6
+    SSE2_Bgrx4ToBgr xmm0, xmm2
+    SSE2_Bgrx4ToBgr xmm1, xmm2
+    movdqa          xmm2, xmm1
+    pslldq          xmm2, 12
+    por             xmm0, xmm2
+    psrldq          xmm1, 4
+    movdqu          [r0], xmm0
+    movq            [r0 + 16], xmm1
+%endmacro
+
+%macro SSE2_StoreRgba8P 0
+    packuswb        xmm4, xmm6
+    packuswb        xmm5, [pic(word_255)]
+    movdqa          xmm0, xmm4
+    punpcklbw       xmm0, xmm5
+    punpckhbw       xmm4, xmm5
+    movdqa          xmm1, xmm0
+    punpcklwd       xmm0, xmm4
+    punpckhwd       xmm1, xmm4
+    movdqu          [r0], xmm0
+    movdqu          [r0 + 16], xmm1
+%endmacro
+
+%macro SSE2_I420ToPackedRow 2 ; store macro, bytes per pixel
+    %assign  push_num 0
+    INIT_X86_32_PIC r5
+    LOAD_5_PARA
+    PUSH_XMM 8
+    SIGN_EXTENSION r4, r4d
+    pxor            xmm7, xmm7
+.loop:
+    SSE2_YuvToRgb8P
+    %1
+    add             r0, 8 * %2
+    add             r1, 8
+    add             r2, 4
+    add             r3, 4
+    sub             r4, 8
+    jg              .loop
+    POP_XMM
+    LOAD_5_PARA_POP
+    DEINIT_X86_32_PIC
+    ret
+%endmacro
+
+;***********************************************************************
+;   void WelsI420ToBgrRow_sse2 (uint8_t* pDst, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+;                               const uint8_t* kpSrcV, int32_t iWidth);
+;   iWidth is a multiple of 8
+;***********************************************************************
+WELS_EXTERN WelsI420ToBgrRow_sse2
+    SSE2_I420ToPackedRow SSE2_StoreBgr8P, 3
+
+;***********************************************************************
+;   void WelsI420ToRgbaRow_sse2 (uint8_t* pDst, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+;                                const uint8_t* kpSrcV, int32_t iWidth);
+;   iWidth is a multiple of 8
+;***********************************************************************
+WELS_EXTERN WelsI420ToRgbaRow_sse2
+    SSE2_I420ToPackedRow SSE2_StoreRgba8P, 4
+
+;***********************************************************************
+;   void WelsInterleaveUVRow_sse2 (uint8_t* pDstUV, const uint8_t* kpSrcU, const uint8_t* kpSrcV, int32_t iWidthUV);
+;   iWidthUV is a multiple of 16
+;***********************************************************************
+WELS_EXTERN WelsInterleaveUVRow_sse2
+    %assign  push_num 0
+    LOAD_4_PARA
+    SIGN_EXTENSION r3, r3d
+.loop:
+    movdqu          xmm0, [r1]
+    movdqu          xmm1, [r2]
+    movdqa          xmm2, xmm0
+    punpcklbw       xmm0, xmm1
+    punpckhbw       xmm2, xmm1
+    movdqu          [r0], xmm0
+    movdqu          [r0 + 16], xmm2
+    add             r0, 32
+    add             r1, 16
+    add             r2, 16
+    sub             r3, 16
+    jg              .loop
+    LOAD_4_PARA_POP
+    ret
+
+%ifdef HAVE_AVX2
+
+; the AVX2 kernels hold the pixels 0-7 in the low lane and 8-15 in the high lane of a ymm, so the luma terms
+; of the pixels 0-3, 8-11 are in ymm0 and of 4-7, 12-15 in ymm2, the chroma pairs 0-3, 4-7 in ymm1
+
+%macro AVX2_ChannelWords 3 ; dst, tmp, coef
+    vpmaddwd        %2, ymm1, %3
+    vpshufd         %1, %2, 0x50
+    vpshufd         %2, %2, 0xfa
+    vpaddd          %1, %1, ymm0
+    vpaddd          %2, %2, ymm2
+    vpsrad          %1, %1, 8
+    vpsrad          %2, %2, 8
+    vpackssdw       %1, %1, %2
+%endmacro
+
+; R, G, B words of 16 pixels into ymm4, ymm5, ymm6, ymm7 is 0
+%macro AVX2_YuvToRgb16P 0
+    vpmovzxbw       ymm0, [r1]
+    vmovq           xmm1, [r2]
+    vmovq           xmm2, [r3]
+    vpunpcklbw      xmm1, xmm1, xmm2
+    vpmovzxbw       ymm1, xmm1
+    vpsubw          ymm1, ymm1, [pic(word_128)]
+    vpunpckhwd      ymm2, ymm0, [pic(word_1)]
+    vpunpcklwd      ymm0, ymm0, [pic(word_1)]
+    vpmaddwd        ymm0, ymm0, [pic(luma_coef)]
+    vpmaddwd        ymm2, ymm2, [pic(luma_coef)]
+    AVX2_ChannelWords ymm4, ymm3, [pic(rv_coef)]
+    AVX2_ChannelWords ymm5, ymm3, [pic(guv_coef)]
+    AVX2_ChannelWords ymm6, ymm3, [pic(bu_coef)]
+%endmacro
+
+; each lane holds 8 pixels, stored as its first 16 bytes and then 8 bytes
+%macro AVX2_StoreBgr16P 0
+    vpackuswb       ymm6, ymm6, ymm4
+    vpackuswb       ymm5, ymm5, ymm7
+    vpunpcklbw      ymm0, ymm6, ymm5
+    vpunpckhbw      ymm6, ymm6, ymm5
+    vpunpcklwd      ymm1, ymm0, ymm6
+    vpunpckhwd      ymm0, ymm0, ymm6
+    vmovdqu         ymm3, [pic(bgrx_to_bgr_shuf)]
+    vpshufb         ymm1, ymm1, ymm3
+    vpshufb         ymm0, ymm0, ymm3
+    vpslldq         ymm2, ymm0, 12
+    vpor            ymm1, ymm1, ymm2
+    vpsrldq         ymm0, ymm0, 4
+    vmovdqu         [r0], xmm1
+    vmovq           [r0 + 16], xmm0
+    vextracti128    [r0 + 24], ymm1, 1
+    vextracti128    xmm0, ymm0, 1
+    vmovq           [r0 + 40], xmm0
+%endmacro
+
+%macro AVX2_StoreRgba16P 0
+    vpackuswb       ymm4, ymm4, ymm6
+    vpackuswb       ymm5, ymm5, [pic(word_255)]
+    vpunpcklbw      ymm0, ymm4, ymm5
+    vpunpckhbw      ymm4, ymm4, ymm5
+    vpunpcklwd      ymm1, ymm0, ymm4
+    vpunpckhwd      ymm0, ymm0, ymm4
+    vperm2i128      ymm2, ymm1, ymm0, 0x20
+    vperm2i128      ymm1, ymm1, ymm0, 0x31
+    vmovdqu         [r0], ymm2
+    vmovdqu         [r0 + 32], ymm1
+%endmacro
+
+%macro AVX2_I420ToPackedRow 2 ; store macro, bytes per pixel
+    %assign  push_num 0
+    INIT_X86_32_PIC r5
+    LOAD_5_PARA
+    PUSH_XMM 8
+    SIGN_EXTENSION r4, r4d
+    vpxor           ymm7, ymm7, ymm7
+.loop:
+    AVX2_YuvToRgb16P
+    %1
+    add             r0, 16 * %2
+    add             r1, 16
+    add             r2, 8
+    add             r3, 8
+    sub             r4, 16
+    jg              .loop
+    vzeroupper
+    POP_XMM
+    LOAD_5_PARA_POP
+    DEINIT_X86_32_PIC
+    ret
+%endmacro
+
+;***********************************************************************
+;   void WelsI420ToBgrRow_avx2 (uint8_t* pDst, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+;                               const uint8_t* kpSrcV, int32_t iWidth);
+;   iWidth is a multiple of 16
+;***********************************************************************
+WELS_EXTERN WelsI420ToBgrRow_avx2
+    AVX2_I420ToPackedRow AVX2_StoreBgr16P, 3
+
+;***********************************************************************
+;   void WelsI420ToRgbaRow_avx2 (uint8_t* pDst, const uint8_t* kpSrcY, const uint8_t* kpSrcU,
+;                                const uint8_t* kpSrcV, int32_t iWidth);
+;   iWidth is a multiple of 16
+;***********************************************************************
+WELS_EXTERN WelsI420ToRgbaRow_avx2
+    AVX2_I420ToPackedRow AVX2_StoreRgba16P, 4
+
+;***********************************************************************
+;   void WelsInterleaveUVRow_avx2 (uint8_t* pDstUV, const uint8_t* kpSrcU, const uint8_t* kpSrcV, int32_t iWidthUV);
+;   iWidthUV is a multiple of 32
+;***********************************************************************
+WELS_EXTERN WelsInterleaveUVRow_avx2
+    %assign  push_num 0
+    LOAD_4_PARA
+    SIGN_EXTENSION r3, r3d
+.loop:
+    vmovdqu         ymm0, [r1]
+    vmovdqu         ymm1, [r2]
+    vpunpcklbw      ymm2, ymm0, ymm1
+    vpunpckhbw      ymm0, ymm0, ymm1
+    vperm2i128      ymm1, ymm2, ymm0, 0x20
+    vperm2i128      ymm2, ymm2, ymm0, 0x31
+    vmovdqu         [r0], ymm1
+    vmovdqu         [r0 + 32], ymm2
+    add             r0, 64
+    add             r1, 32
+    add             r2, 32
+    sub             r3, 32
+    jg              .loop
+    vzeroupper
+    LOAD_4_PARA_POP
+    ret
+
+%endif ; HAVE_AVX2
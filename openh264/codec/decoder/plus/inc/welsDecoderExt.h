@@ -121,7 +121,20 @@ class CWelsDecoder : public ISVCDecoder {
   int32_t                 m_iCpuCount;
   int32_t                 m_iThreadCount;
   int32_t                 m_iCtxCount;
+  SThreadPoolParam        m_sThreadPoolParam;
+  bool                    m_bDeblockingThread;
+  int32_t                 m_iSliceThreads;
+  bool                    m_bLowLatencyThreads;
+  int32_t                 m_iLowLatencyHeldIdx;
+  PPicBuff                m_pLowLatencyHeldBuff;
+  SDecoderFrameAllocator  m_sFrameAllocator;
+  EVideoFormatType        m_eOutputFormat;
+  SDecoderScaledOutput    m_sScaledOutput;
+  EDecoderSkipFrames      m_eSkipFrames;
+  bool                    m_bLazyBorderExpansion;
   PPicBuff                m_pPicBuff;
+  uint32_t                m_uiSkippedFrameCount;
+  void*                   m_pOutputUserFrame;  // DECODER_OPTION_OUTPUT_USER_FRAME of the last decoding call
   bool                    m_bParamSetsLostFlag;
   bool                    m_bFreezeOutput;
   int32_t                 m_DecCtxActiveCount;
@@ -154,6 +167,10 @@ class CWelsDecoder : public ISVCDecoder {
   void BufferingReadyPicture (PWelsDecoderContext pCtx, unsigned char** ppDst, SBufferInfo* pDstInfo);
   void ReleaseBufferedReadyPictureReorder (PWelsDecoderContext pCtx, unsigned char** ppDst, SBufferInfo* pDstInfo, bool isFlush = false);
   void ReleaseBufferedReadyPictureNoReorder (PWelsDecoderContext pCtx, unsigned char** ppDst, SBufferInfo* pDstInfo);
+  bool IsLowLatencyOutput (PWelsDecoderThreadCTX pThrCtx);
+  void OutputLowLatencyPicture (PWelsDecoderThreadCTX pThrCtx, unsigned char** ppDst, SBufferInfo* pDstInfo);
+  void ReleaseLowLatencyHeldPicture();
+  void UpdateOutputUserFrame (SBufferInfo* pDstInfo);
 
   void OpenDecoderThreads();
   void CloseDecoderThreads();
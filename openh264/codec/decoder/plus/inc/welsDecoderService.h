@@ -0,0 +1,190 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ *
+ * \file    welsDecoderService.h
+ *
+ * \brief   ISVCDecoderService: per stream decoders on a shared thread pool with one picture budget
+ *
+ * \date    10/17/2026 Created
+ *
+ *************************************************************************************
+ */
+
+#ifndef WELS_PLUS_WELS_DECODER_SERVICE_H__
+#define WELS_PLUS_WELS_DECODER_SERVICE_H__
+
+#include "codec_api.h"
+#include "codec_app_def.h"
+#include "typedefs.h"
+#include "WelsThreadLib.h"
+#include "WelsThreadPool.h"
+
+#define DECODER_SERVICE_MAX_STREAMS_DEFAULT  256
+#define DECODER_SERVICE_MAX_STREAMS          4096
+#define DECODER_SERVICE_QUEUE_DEPTH_DEFAULT  4
+#define DECODER_SERVICE_QUEUE_DEPTH_MAX      64
+#define DECODER_SERVICE_AU_PER_RUN           4  // access units a stream decodes before it lets the others on the worker
+
+namespace WelsDec {
+
+class CWelsDecoderService;
+
+/*
+ * Picture buffer handed to the stream decoders through SDecoderFrameAllocator. It is referenced by the decoder
+ * holding it and by every frame of it the application has not released, and goes back to the service's free
+ * list with the last reference.
+ */
+typedef struct TagDecoderServiceBuffer {
+  struct TagDecoderServiceBuffer* pNext;  // free list link
+  uint8_t*                        pData;
+  int32_t                         iSize;
+  int32_t                         iRefCount;
+} SDecoderServiceBuffer;
+
+// sFrame has to stay the first member, the application only sees SDecodedFrame
+typedef struct TagDecoderServiceFrame {
+  SDecodedFrame                   sFrame;
+  SDecoderServiceBuffer*          pBuffer;
+  struct TagDecoderServiceFrame*  pNext;  // output queue or free list link
+  struct TagDecoderServiceFrame*  pNextAllocated;
+  bool                            bInUse; // queued in a stream or owned by the application
+} SDecoderServiceFrame;
+
+typedef struct TagDecoderServiceAu {
+  uint8_t*  pBs;
+  int32_t   iCapacity;
+  int32_t   iLen;                         // 0 ends the stream
+  uint64_t  uiTimeStamp;
+} SDecoderServiceAu;
+
+/*
+ * One stream: its decoder, the queue of submitted access units and the queue of output frames. The stream is its
+ * own pool task; it is queued at most once, which keeps its access units in order, and decodes a few of them
+ * per run so that busy streams do not starve the others.
+ */
+class CWelsDecoderStream : public WelsCommon::IWelsTask, public WelsCommon::IWelsTaskSink {
+ public:
+  CWelsDecoderStream (CWelsDecoderService* pService, const int32_t kiStreamId, const int32_t kiQueueDepth);
+  virtual ~CWelsDecoderStream();
+
+  int32_t         Init (const SDecodingParam* pParam, const SDecoderFrameAllocator* pAllocator);
+  int32_t         Submit (const uint8_t* kpSrc, const int32_t kiSrcLen, const uint64_t kuiTimeStamp);
+  int32_t         GetFrame (SDecodedFrame** ppFrame, const bool kbWait);
+  long            SetOption (DECODER_OPTION eOptionId, void* pOption);
+  long            GetOption (DECODER_OPTION eOptionId, void* pOption);
+  // drops the queued access units and waits until no worker runs the stream any more
+  void            Close();
+
+  virtual int     Execute();
+  virtual int     OnTaskExecuted();
+  virtual int     OnTaskCancelled();
+
+ private:
+  bool            InitDecoder();
+  void            DecodeAu (const SDecoderServiceAu* kpAu);
+  void            OutputPicture (uint8_t** ppDst, SBufferInfo* pDstInfo, const int32_t kiDecodingState);
+  void            FinishRun();
+
+  CWelsDecoderService*    m_pService;
+  int32_t                 m_iStreamId;
+  ISVCDecoder*            m_pDecoder;
+  SDecodingParam          m_sDecParam;
+  bool                    m_bDecoderInited;
+
+  SDecoderServiceAu*      m_pAus;
+  int32_t                 m_iQueueDepth;
+  int32_t                 m_iAuHead;
+  int32_t                 m_iAuCount;     // queued and under decoding
+  SDecoderServiceFrame*   m_pFrameHead;
+  SDecoderServiceFrame*   m_pFrameTail;
+  bool                    m_bScheduled;   // queued in or running on the pool
+  bool                    m_bClosing;
+
+  WELS_MUTEX              m_hStateMutex;  // the two queues and the flags
+  WELS_MUTEX              m_hDecoderMutex;// m_pDecoder, held while decoding
+  WELS_CONDITION          m_hFrameCond;   // an access unit retired, signalled under m_hStateMutex
+  WELS_CONDITION          m_hIdleCond;    // a closing stream left the pool, signalled under m_hStateMutex
+
+  DISALLOW_COPY_AND_ASSIGN (CWelsDecoderStream);
+};
+
+class CWelsDecoderService : public ISVCDecoderService {
+ public:
+  CWelsDecoderService();
+  virtual ~CWelsDecoderService();
+
+  virtual long EXTAPI Initialize (const SDecoderServiceParam* pParam);
+  virtual long EXTAPI Uninitialize();
+  virtual long EXTAPI OpenStream (const SDecodingParam* pParam, int* pStreamId);
+  virtual long EXTAPI CloseStream (int iStreamId);
+  virtual long EXTAPI SubmitAccessUnit (int iStreamId, const unsigned char* pSrc, const int iSrcLen,
+                                        unsigned long long uiTimeStamp);
+  virtual long EXTAPI GetDecodedFrame (int iStreamId, SDecodedFrame** ppFrame, bool bWait);
+  virtual long EXTAPI ReleaseDecodedFrame (SDecodedFrame* pFrame);
+  virtual long EXTAPI SetStreamOption (int iStreamId, DECODER_OPTION eOptionId, void* pOption);
+  virtual long EXTAPI GetStreamOption (int iStreamId, DECODER_OPTION eOptionId, void* pOption);
+
+  // for the streams
+  WelsCommon::CWelsThreadPool* GetThreadPool() {
+    return m_pThreadPool;
+  }
+  bool                  IsOverBudget();
+  SDecoderServiceFrame* NewFrame (SDecoderServiceBuffer* pBuffer);
+  void                  FreeFrame (SDecoderServiceFrame* pFrame);
+
+ private:
+  static unsigned char* GetBuffer (void* pUserData, int iSize, void** ppUserFrame);
+  static void           ReleaseBuffer (void* pUserData, void* pUserFrame);
+  void                  UnrefBuffer (SDecoderServiceBuffer* pBuffer);
+  CWelsDecoderStream*   GetStream (const int32_t kiStreamId);
+
+  WelsCommon::CWelsThreadPool*  m_pThreadPool;
+  CWelsDecoderStream**  m_ppStreams;
+  int32_t               m_iMaxStreams;
+  int32_t               m_iQueueDepth;
+  SDecoderFrameAllocator m_sAllocator;
+
+  int64_t               m_iPictureBudget;
+  int64_t               m_iUsedBytes;     // buffers held by decoders or frames
+  int64_t               m_iFreeBytes;     // buffers on m_pFreeBuffers
+  SDecoderServiceBuffer* m_pFreeBuffers;
+  SDecoderServiceFrame* m_pFreeFrames;
+  SDecoderServiceFrame* m_pAllocatedFrames;
+
+  WELS_MUTEX            m_hMutex;         // stream table, buffers and frames
+
+  DISALLOW_COPY_AND_ASSIGN (CWelsDecoderService);
+};
+
+}
+
+#endif//WELS_PLUS_WELS_DECODER_SERVICE_H__
@@ -93,6 +93,9 @@ DECLARE_PROCTHREAD (pThrProcInit, p) {
 #if defined(WIN32)
   _alloca (WELS_DEC_MAX_THREAD_STACK_SIZE * (sThreadInfo->uiThrNum + 1));
 #endif
+  if (sThreadInfo->iAffinityCpu >= 0) {
+    WelsThreadSetAffinity (sThreadInfo->iAffinityCpu);
+  }
   return sThreadInfo->pThrProcMain (p);
 }
 
@@ -123,6 +126,8 @@ DECLARE_PROCTHREAD (pThrProcFrame, p) {
     if (pThrCtx->sThreadInfo.uiCommand == WELS_DEC_THREAD_COMMAND_RUN) {
       CWelsDecoder* pWelsDecoder = (CWelsDecoder*)pThrCtx->threadCtxOwner;
       ConstructAccessUnit (pWelsDecoder, pThrCtx);
+      // the picture may have failed before DecodeFrameConstruction(), never leave a low-latency caller waiting
+      SET_EVENT (&pThrCtx->sImageReady);
     } else if (pThrCtx->sThreadInfo.uiCommand == WELS_DEC_THREAD_COMMAND_ABORT) {
       break;
     }
@@ -138,6 +143,8 @@ CWelsDecoder::CWelsDecoder (void)
     m_iThreadCount (0),
     m_iCtxCount (1),
     m_pPicBuff (NULL),
+    m_uiSkippedFrameCount (0),
+    m_pOutputUserFrame (NULL),
     m_bParamSetsLostFlag (false),
     m_bFreezeOutput (false),
     m_DecCtxActiveCount (0),
@@ -166,11 +173,22 @@ CWelsDecoder::CWelsDecoder (void)
   }
 
   ResetReorderingPictureBuffers (&m_sReoderingStatus, m_sPictInfoList, true);
+  memset (&m_sThreadPoolParam, 0, sizeof (m_sThreadPoolParam));
+  memset (&m_sFrameAllocator, 0, sizeof (m_sFrameAllocator));
+  m_eOutputFormat = videoFormatI420;
+  memset (&m_sScaledOutput, 0, sizeof (m_sScaledOutput));
+  m_eSkipFrames = DECODER_SKIP_NONE;
+  m_bLazyBorderExpansion = false;
 
   m_iCpuCount = GetCPUCount();
   if (m_iCpuCount > WELS_DEC_MAX_NUM_CPU) {
     m_iCpuCount = WELS_DEC_MAX_NUM_CPU;
   }
+  m_bDeblockingThread = false;
+  m_iSliceThreads = 0;
+  m_bLowLatencyThreads = false;
+  m_iLowLatencyHeldIdx = -1;
+  m_pLowLatencyHeldBuff = NULL;
 
   m_pDecThrCtx = new SWelsDecoderThreadCTX[m_iCtxCount];
   memset (m_pDecThrCtx, 0, sizeof (SWelsDecoderThreadCTX)*m_iCtxCount);
@@ -305,6 +323,8 @@ void CWelsDecoder::OpenDecoderThreads() {
       m_pDecThrCtx[i].sThreadInfo.uiThrMaxNum = m_iThreadCount;
       m_pDecThrCtx[i].sThreadInfo.uiThrNum = i;
       m_pDecThrCtx[i].sThreadInfo.uiThrStackSize = WELS_DEC_MAX_THREAD_STACK_SIZE;
+      m_pDecThrCtx[i].sThreadInfo.iAffinityCpu = m_sThreadPoolParam.iAffinityCpuNum > 0 ?
+          m_sThreadPoolParam.iAffinityCpu[i % m_sThreadPoolParam.iAffinityCpuNum] : -1;
       m_pDecThrCtx[i].sThreadInfo.pThrProcMain = pThrProcFrame;
       m_pDecThrCtx[i].sThreadInfo.sIsBusy = &m_sIsBusy;
       m_pDecThrCtx[i].sThreadInfo.uiCommand = WELS_DEC_THREAD_COMMAND_RUN;
@@ -352,8 +372,8 @@ void CWelsDecoder::UninitDecoderCtx (PWelsDecoderContext& pCtx) {
 
     if (pCtx->pMemAlign != NULL) {
       WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
-               "CWelsDecoder::UninitDecoder(), verify memory usage (%d bytes) after free..",
-               pCtx->pMemAlign->WelsGetMemoryUsage());
+               "CWelsDecoder::UninitDecoder(), verify memory usage (%lld bytes) after free..",
+               static_cast<long long> (pCtx->pMemAlign->WelsGetMemoryUsage()));
       delete pCtx->pMemAlign;
       pCtx->pMemAlign = NULL;
     }
@@ -379,6 +399,8 @@ int32_t CWelsDecoder::InitDecoder (const SDecodingParam* pParam) {
   OpenDecoderThreads();
   //reset decoder context
   memset (&m_sDecoderStatistics, 0, sizeof (SDecoderStatistics));
+  m_uiSkippedFrameCount = 0;
+  m_pOutputUserFrame = NULL;
   memset (&m_sLastDecPicInfo, 0, sizeof (SWelsLastDecPicInfo));
   memset (&m_sVlcTable, 0, sizeof (SVlcTable));
   UninitDecoder();
@@ -389,6 +411,8 @@ int32_t CWelsDecoder::InitDecoder (const SDecodingParam* pParam) {
       m_pDecThrCtx[i].pCtx->pThreadCtx = &m_pDecThrCtx[i];
     }
   }
+  m_iLowLatencyHeldIdx = -1; // pictures are reallocated
+  m_pLowLatencyHeldBuff = NULL;
   m_bParamSetsLostFlag = false;
   m_bFreezeOutput = false;
   return cmResultSuccess;
@@ -413,11 +437,19 @@ int32_t CWelsDecoder::InitDecoderCtx (PWelsDecoderContext& pCtx, const SDecoding
   //fill in default value into context
   pCtx->pLastDecPicInfo = &m_sLastDecPicInfo;
   pCtx->pDecoderStatistics = &m_sDecoderStatistics;
+  pCtx->pSkippedFrameCount = &m_uiSkippedFrameCount;
   pCtx->pVlcTable = &m_sVlcTable;
   pCtx->pPictInfoList = m_sPictInfoList;
   pCtx->pPictReoderingStatus = &m_sReoderingStatus;
   pCtx->pCsDecoder = &m_csDecoder;
   WelsDecoderDefaults (pCtx, &m_pWelsTrace->m_sLogCtx);
+  pCtx->bDeblockingThread = m_bDeblockingThread;
+  pCtx->sSliceThreads.iThreadNum = m_iSliceThreads;
+  pCtx->pFrameAllocator = (m_sFrameAllocator.pfGetBuffer != NULL && !pParam->bParseOnly) ? &m_sFrameAllocator : NULL;
+  pCtx->eOutputFormat = m_eOutputFormat;
+  pCtx->sScaledOutput = m_sScaledOutput;
+  pCtx->eSkipFrames = m_eSkipFrames;
+  pCtx->bLazyBorderExpansion = m_bLazyBorderExpansion;
   WelsDecoderSpsPpsDefaults (pCtx->sSpsPpsCtx);
   //check param and update decoder context
   pCtx->pParam = (SDecodingParam*)pCtx->pMemAlign->WelsMallocz (sizeof (SDecodingParam),
@@ -497,6 +529,100 @@ long CWelsDecoder::SetOption (DECODER_OPTION eOptID, void* pOption) {
     }
     return cmResultSuccess;
   }
+  if (eOptID == DECODER_OPTION_THREAD_POOL) {
+    // like DECODER_OPTION_NUM_OF_THREADS, only effective before Initialize()
+    if (pOption == NULL)
+      return cmInitParaError;
+    const SThreadPoolParam* pParam = (const SThreadPoolParam*)pOption;
+    if (pParam->iThreadNum < 0 || pParam->iAffinityCpuNum < 0 || pParam->iAffinityCpuNum > MAX_THREAD_AFFINITY_CPU_NUM)
+      return cmInitParaError;
+    m_sThreadPoolParam = *pParam;
+    m_sThreadPoolParam.szPoolName[0] = '\0';
+    if (pParam->iThreadNum > 0) {
+      int32_t iThreadNum = pParam->iThreadNum;
+      SetOption (DECODER_OPTION_NUM_OF_THREADS, &iThreadNum);
+    }
+    return cmResultSuccess;
+  }
+  if (eOptID == DECODER_OPTION_DEBLOCKING_THREAD) {
+    // may be set before Initialize(), applies from the next slice on
+    if (pOption == NULL)
+      return cmInitParaError;
+    m_bDeblockingThread = * ((int*)pOption) != 0;
+    for (int32_t i = 0; i < m_iCtxCount; ++i) {
+      if (m_pDecThrCtx[i].pCtx != NULL)
+        m_pDecThrCtx[i].pCtx->bDeblockingThread = m_bDeblockingThread;
+    }
+    return cmResultSuccess;
+  }
+  if (eOptID == DECODER_OPTION_SLICE_THREADS) {
+    // may be set before Initialize(), applies from the next access unit on
+    if (pOption == NULL)
+      return cmInitParaError;
+    m_iSliceThreads = WELS_CLIP3 (* ((int*)pOption), 0, WELS_DEC_MAX_NUM_CPU);
+    for (int32_t i = 0; i < m_iCtxCount; ++i) {
+      if (m_pDecThrCtx[i].pCtx != NULL)
+        m_pDecThrCtx[i].pCtx->sSliceThreads.iThreadNum = m_iSliceThreads;
+    }
+    return cmResultSuccess;
+  }
+  if (eOptID == DECODER_OPTION_LOW_LATENCY_THREADS) {
+    // may be set before Initialize(), applies from the next access unit on
+    if (pOption == NULL)
+      return cmInitParaError;
+    m_bLowLatencyThreads = * ((int*)pOption) != 0;
+    return cmResultSuccess;
+  }
+  if (eOptID == DECODER_OPTION_FRAME_ALLOCATOR) {
+    // like DECODER_OPTION_NUM_OF_THREADS, only effective before Initialize(), pictures never change hands
+    if (pOption == NULL || m_pDecThrCtx[0].pCtx != NULL)
+      return cmInitParaError;
+    const SDecoderFrameAllocator* pAllocator = (const SDecoderFrameAllocator*)pOption;
+    if ((pAllocator->pfGetBuffer == NULL) != (pAllocator->pfReleaseBuffer == NULL))
+      return cmInitParaError;
+    m_sFrameAllocator = *pAllocator;
+    return cmResultSuccess;
+  }
+  if (eOptID == DECODER_OPTION_OUTPUT_FORMAT) {
+    // the converted output is allocated along with the pictures, so only before Initialize() as well
+    if (pOption == NULL || m_pDecThrCtx[0].pCtx != NULL || !WelsIsOutputFormatSupported (* ((int*)pOption)))
+      return cmInitParaError;
+    if (* ((int*)pOption) != videoFormatI420 && m_sScaledOutput.iWidth > 0) // the scaled output is I420
+      return cmInitParaError;
+    m_eOutputFormat = (EVideoFormatType) * ((int*)pOption);
+    return cmResultSuccess;
+  }
+  if (eOptID == DECODER_OPTION_SCALED_OUTPUT) {
+    if (pOption == NULL || m_pDecThrCtx[0].pCtx != NULL)
+      return cmInitParaError;
+    const SDecoderScaledOutput* kpScaled = (const SDecoderScaledOutput*)pOption;
+    const bool kbScaled = kpScaled->iWidth > 0 || kpScaled->iHeight > 0;
+    if (kbScaled && (kpScaled->iWidth <= 0 || kpScaled->iHeight <= 0 || (kpScaled->iWidth & 1) || (kpScaled->iHeight & 1)
+                     || m_eOutputFormat != videoFormatI420))
+      return cmInitParaError;
+    m_sScaledOutput.iWidth = kbScaled ? kpScaled->iWidth : 0;
+    m_sScaledOutput.iHeight = kbScaled ? kpScaled->iHeight : 0;
+    return cmResultSuccess;
+  }
+  if (eOptID == DECODER_OPTION_LAZY_BORDER_EXPANSION) {
+    // references decoded so far are not padded, so there is no going back once decoding started
+    if (pOption == NULL || m_pDecThrCtx[0].pCtx != NULL)
+      return cmInitParaError;
+    m_bLazyBorderExpansion = * ((int*)pOption) != 0;
+    return cmResultSuccess;
+  }
+  if (eOptID == DECODER_OPTION_SKIP_FRAMES) {
+    if (pOption == NULL || * ((int*)pOption) < (int)DECODER_SKIP_NONE || * ((int*)pOption) > (int)DECODER_SKIP_NON_INTRA)
+      return cmInitParaError;
+    // kept across decoder resets, and followed by every decoding thread from the next picture on
+    m_eSkipFrames = (EDecoderSkipFrames) * ((int*)pOption);
+    for (int32_t i = 0; i < m_iCtxCount; ++i) {
+      if (m_pDecThrCtx[i].pCtx != NULL)
+        m_pDecThrCtx[i].pCtx->eSkipFrames = m_eSkipFrames;
+    }
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO, "CWelsDecoder::SetOption for SKIP_FRAMES = %d.", m_eSkipFrames);
+    return cmResultSuccess;
+  }
   for (int32_t i = 0; i < m_iCtxCount; ++i) {
     PWelsDecoderContext pDecContext = m_pDecThrCtx[i].pCtx;
     if (pDecContext == NULL && eOptID != DECODER_OPTION_TRACE_LEVEL &&
@@ -568,6 +694,14 @@ long CWelsDecoder::SetOption (DECODER_OPTION eOptID, void* pOption) {
       WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_WARNING,
                "CWelsDecoder::SetOption():DECODER_OPTION_GET_SAR_INFO: this option is get-only!");
       return cmInitParaError;
+    } else if (eOptID == DECODER_OPTION_MEMORY_USAGE) {
+      WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_WARNING,
+               "CWelsDecoder::SetOption():DECODER_OPTION_MEMORY_USAGE: this option is get-only!");
+      return cmInitParaError;
+    } else if (eOptID == DECODER_OPTION_OUTPUT_USER_FRAME || eOptID == DECODER_OPTION_SKIPPED_FRAME_COUNT) {
+      WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_WARNING,
+               "CWelsDecoder::SetOption():DECODER_OPTION_OUTPUT_USER_FRAME/SKIPPED_FRAME_COUNT: this option is get-only!");
+      return cmInitParaError;
     }
   }
   return cmInitParaError;
@@ -582,6 +716,61 @@ long CWelsDecoder::GetOption (DECODER_OPTION eOptID, void* pOption) {
     * ((int*)pOption) = m_iThreadCount;
     return cmResultSuccess;
   }
+  if (DECODER_OPTION_THREAD_POOL == eOptID) {
+    if (pOption == NULL)
+      return cmInitParaError;
+    * ((SThreadPoolParam*)pOption) = m_sThreadPoolParam;
+    ((SThreadPoolParam*)pOption)->iThreadNum = m_iThreadCount;
+    return cmResultSuccess;
+  }
+  if (DECODER_OPTION_DEBLOCKING_THREAD == eOptID) {
+    if (pOption == NULL)
+      return cmInitParaError;
+    * ((int*)pOption) = m_bDeblockingThread ? 1 : 0;
+    return cmResultSuccess;
+  }
+  if (DECODER_OPTION_SLICE_THREADS == eOptID) {
+    if (pOption == NULL)
+      return cmInitParaError;
+    * ((int*)pOption) = m_iSliceThreads;
+    return cmResultSuccess;
+  }
+  if (DECODER_OPTION_LOW_LATENCY_THREADS == eOptID) {
+    if (pOption == NULL)
+      return cmInitParaError;
+    * ((int*)pOption) = m_bLowLatencyThreads ? 1 : 0;
+    return cmResultSuccess;
+  }
+  if (DECODER_OPTION_FRAME_ALLOCATOR == eOptID) {
+    if (pOption == NULL)
+      return cmInitParaError;
+    * ((SDecoderFrameAllocator*)pOption) = m_sFrameAllocator;
+    return cmResultSuccess;
+  }
+  if (DECODER_OPTION_OUTPUT_FORMAT == eOptID) {
+    if (pOption == NULL)
+      return cmInitParaError;
+    * ((int*)pOption) = (int) m_eOutputFormat;
+    return cmResultSuccess;
+  }
+  if (DECODER_OPTION_SCALED_OUTPUT == eOptID) {
+    if (pOption == NULL)
+      return cmInitParaError;
+    * ((SDecoderScaledOutput*)pOption) = m_sScaledOutput;
+    return cmResultSuccess;
+  }
+  if (DECODER_OPTION_SKIP_FRAMES == eOptID) {
+    if (pOption == NULL)
+      return cmInitParaError;
+    * ((int*)pOption) = (int) m_eSkipFrames;
+    return cmResultSuccess;
+  }
+  if (DECODER_OPTION_LAZY_BORDER_EXPANSION == eOptID) {
+    if (pOption == NULL)
+      return cmInitParaError;
+    * ((int*)pOption) = m_bLazyBorderExpansion ? 1 : 0;
+    return cmResultSuccess;
+  }
   PWelsDecoderContext pDecContext = m_pDecThrCtx[0].pCtx;
   if (pDecContext == NULL)
     return cmInitExpected;
@@ -682,6 +871,20 @@ long CWelsDecoder::GetOption (DECODER_OPTION eOptID, void* pOption) {
     }
     * ((int*)pOption) = m_sReoderingStatus.iNumOfPicts;
     return cmResultSuccess;
+  } else if (DECODER_OPTION_OUTPUT_USER_FRAME == eOptID) {
+    * ((void**)pOption) = m_pOutputUserFrame;
+    return cmResultSuccess;
+  } else if (DECODER_OPTION_SKIPPED_FRAME_COUNT == eOptID) {
+    * ((unsigned int*)pOption) = m_uiSkippedFrameCount;
+    return cmResultSuccess;
+  } else if (DECODER_OPTION_MEMORY_USAGE == eOptID) {
+    SMemoryUsage* pUsage = static_cast<SMemoryUsage*> (pOption);
+    memset (pUsage, 0, sizeof (SMemoryUsage));
+    for (int32_t i = 0; i < m_iCtxCount; ++i) {
+      if (m_pDecThrCtx[i].pCtx != NULL && m_pDecThrCtx[i].pCtx->pMemAlign != NULL)
+        m_pDecThrCtx[i].pCtx->pMemAlign->WelsAddMemoryUsage (pUsage);
+    }
+    return cmResultSuccess;
   }
 
   return cmInitParaError;
@@ -707,6 +910,7 @@ DECODING_STATE CWelsDecoder::DecodeFrameNoDelay (const unsigned char* kpSrc,
       }
       SET_EVENT(&m_sReleaseBufferEvent);
     }
+    UpdateOutputUserFrame (pDstInfo);
     return (DECODING_STATE)iRet;
   }
   //SBufferInfo sTmpBufferInfo;
@@ -873,6 +1077,8 @@ DECODING_STATE CWelsDecoder::DecodeFrame2WithCtx (PWelsDecoderContext pDecContex
 
     OutputStatisticsLog (*pDecContext->pDecoderStatistics);
     if (GetThreadCount (pDecContext) >= 1) {
+      if (((PWelsDecoderThreadCTX)pDecContext->pThreadCtx)->bLowLatencyOutput)
+        return (DECODING_STATE)pDecContext->iErrorCode;
       WAIT_EVENT (&m_sReleaseBufferEvent, WELS_DEC_THREAD_WAIT_INFINITE);
       RESET_EVENT (&m_sBufferingEvent);
       BufferingReadyPicture (pDecContext, ppDst, pDstInfo);
@@ -899,6 +1105,8 @@ DECODING_STATE CWelsDecoder::DecodeFrame2WithCtx (PWelsDecoderContext pDecContex
   pDecContext->dDecTime += (iEnd - iStart) / 1e3;
 
   if (GetThreadCount (pDecContext) >= 1) {
+    if (((PWelsDecoderThreadCTX)pDecContext->pThreadCtx)->bLowLatencyOutput)
+      return dsErrorFree;
     WAIT_EVENT (&m_sReleaseBufferEvent, WELS_DEC_THREAD_WAIT_INFINITE);
     RESET_EVENT (&m_sBufferingEvent);
     BufferingReadyPicture (pDecContext, ppDst, pDstInfo);
@@ -914,7 +1122,9 @@ DECODING_STATE CWelsDecoder::DecodeFrame2 (const unsigned char* kpSrc,
     unsigned char** ppDst,
     SBufferInfo* pDstInfo) {
   PWelsDecoderContext pDecContext = m_pDecThrCtx[0].pCtx;
-  return DecodeFrame2WithCtx (pDecContext, kpSrc, kiSrcLen, ppDst, pDstInfo);
+  DECODING_STATE eState = DecodeFrame2WithCtx (pDecContext, kpSrc, kiSrcLen, ppDst, pDstInfo);
+  UpdateOutputUserFrame (pDstInfo);
+  return eState;
 }
 
 DECODING_STATE CWelsDecoder::FlushFrame (unsigned char** ppDst,
@@ -935,9 +1145,22 @@ DECODING_STATE CWelsDecoder::FlushFrame (unsigned char** ppDst,
       ReleaseBufferedReadyPictureReorder (NULL, ppDst, pDstInfo, true);
     }
   }
+  UpdateOutputUserFrame (pDstInfo);
   return dsErrorFree;
 }
 
+void CWelsDecoder::UpdateOutputUserFrame (SBufferInfo* pDstInfo) {
+  m_pOutputUserFrame = NULL;
+  if (NULL == m_sFrameAllocator.pfGetBuffer || 1 != pDstInfo->iBufferStatus)
+    return;
+  // the output picture is still held by the decoder until the next call, in its context's or the shared buffer
+  m_pOutputUserFrame = PicBuffUserFrame (m_pPicBuff, pDstInfo->pDst[0]);
+  for (int32_t i = 0; i < m_iCtxCount && NULL == m_pOutputUserFrame; ++i) {
+    if (m_pDecThrCtx[i].pCtx != NULL)
+      m_pOutputUserFrame = PicBuffUserFrame (m_pDecThrCtx[i].pCtx->pPicBuff, pDstInfo->pDst[0]);
+  }
+}
+
 void CWelsDecoder::OutputStatisticsLog (SDecoderStatistics& sDecoderStatistics) {
   if ((sDecoderStatistics.uiDecodedFrameCount > 0) && (sDecoderStatistics.iStatisticsLogInterval > 0)
       && ((sDecoderStatistics.uiDecodedFrameCount % sDecoderStatistics.iStatisticsLogInterval) == 0)) {
@@ -948,7 +1171,7 @@ void CWelsDecoder::OutputStatisticsLog (SDecoderStatistics& sDecoderStatistics)
               uiIDRLostNum=%d, uiFreezingIDRNum=%d, uiFreezingNonIDRNum=%d, iAvgLumaQp=%d, \
               iSpsReportErrorNum=%d, iSubSpsReportErrorNum=%d, iPpsReportErrorNum=%d, iSpsNoExistNalNum=%d, iSubSpsNoExistNalNum=%d, iPpsNoExistNalNum=%d, \
               uiProfile=%d, uiLevel=%d, \
-              iCurrentActiveSpsId=%d, iCurrentActivePpsId=%d,",
+              iCurrentActiveSpsId=%d, iCurrentActivePpsId=%d, skipped frames=%d,",
              sDecoderStatistics.uiWidth,
              sDecoderStatistics.uiHeight,
              sDecoderStatistics.fAverageFrameSpeedInMs,
@@ -979,7 +1202,8 @@ void CWelsDecoder::OutputStatisticsLog (SDecoderStatistics& sDecoderStatistics)
              sDecoderStatistics.uiLevel,
 
              sDecoderStatistics.iCurrentActiveSpsId,
-             sDecoderStatistics.iCurrentActivePpsId);
+             sDecoderStatistics.iCurrentActivePpsId,
+             m_uiSkippedFrameCount);
   }
 }
 
@@ -1191,6 +1415,48 @@ void CWelsDecoder::ReleaseBufferedReadyPictureNoReorder(PWelsDecoderContext pCtx
   return;
 }
 
+/*
+* Low-latency threaded output applies to baseline pictures only, and never lets a picture overtake
+* pictures that are still waiting in, or on their way to, the reordering buffer.
+*/
+bool CWelsDecoder::IsLowLatencyOutput (PWelsDecoderThreadCTX pThrCtx) {
+  PWelsDecoderContext pCtx = pThrCtx->pCtx;
+  if (!m_bLowLatencyThreads || pCtx->pSps == NULL)
+    return false;
+  if (pCtx->pSps->uiProfileIdc != 66 && pCtx->pSps->uiProfileIdc != 83)
+    return false;
+  if (m_sReoderingStatus.iNumOfPicts > 0)
+    return false;
+  return m_pLastDecThrCtx == NULL || m_pLastDecThrCtx->bLowLatencyOutput;
+}
+
+void CWelsDecoder::OutputLowLatencyPicture (PWelsDecoderThreadCTX pThrCtx, unsigned char** ppDst,
+    SBufferInfo* pDstInfo) {
+  memcpy (pDstInfo, &pThrCtx->sDstInfo, sizeof (SBufferInfo));
+  if (pDstInfo->iBufferStatus == 0)
+    return;
+  ppDst[0] = pDstInfo->pDst[0];
+  ppDst[1] = pDstInfo->pDst[1];
+  ppDst[2] = pDstInfo->pDst[2];
+  //keep the picture away from PrefetchPic() until the next one is returned, as a buffered picture is
+  ReleaseLowLatencyHeldPicture();
+  PPicBuff pPicBuff = pThrCtx->pCtx->pPicBuff;
+  if (pPicBuff == NULL || pThrCtx->iPicBuffIdx < 0 || pThrCtx->iPicBuffIdx >= pPicBuff->iCapacity)
+    return;
+  if (m_iThreadCount <= 1) ++pPicBuff->ppPic[pThrCtx->iPicBuffIdx]->iRefCount;
+  m_iLowLatencyHeldIdx = pThrCtx->iPicBuffIdx;
+  m_pLowLatencyHeldBuff = pPicBuff;
+}
+
+void CWelsDecoder::ReleaseLowLatencyHeldPicture() {
+  if (m_iLowLatencyHeldIdx >= 0 && m_pLowLatencyHeldBuff != NULL && m_pLowLatencyHeldBuff == m_pPicBuff
+      && m_iLowLatencyHeldIdx < m_pPicBuff->iCapacity) {
+    --m_pPicBuff->ppPic[m_iLowLatencyHeldIdx]->iRefCount;
+  }
+  m_iLowLatencyHeldIdx = -1;
+  m_pLowLatencyHeldBuff = NULL;
+}
+
 DECODING_STATE CWelsDecoder::ReorderPicturesInDisplay(PWelsDecoderContext pDecContext, unsigned char** ppDst,
   SBufferInfo* pDstInfo) {
   DECODING_STATE iRet = dsErrorFree;
@@ -1428,14 +1694,25 @@ int CWelsDecoder::ThreadDecodeFrameInternal (const unsigned char* kpSrc, const i
   m_pDecThrCtx[signal].kiSrcLen = kiSrcLen;
   m_pDecThrCtx[signal].ppDst = ppDst;
   memcpy (&m_pDecThrCtx[signal].sDstInfo, pDstInfo, sizeof (SBufferInfo));
+  m_pDecThrCtx[signal].sDstInfo.iBufferStatus = 0;
+  m_pDecThrCtx[signal].bLowLatencyOutput = false;
 
   ParseAccessUnit (m_pDecThrCtx[signal]);
+  m_pDecThrCtx[signal].bLowLatencyOutput = IsLowLatencyOutput (&m_pDecThrCtx[signal]);
   if (m_iThreadCount > 1) {
     m_pLastDecThrCtx = &m_pDecThrCtx[signal];
   }
   m_pDecThrCtx[signal].sThreadInfo.uiCommand = WELS_DEC_THREAD_COMMAND_RUN;
+  RESET_EVENT (&m_pDecThrCtx[signal].sImageReady);
   RELEASE_SEMAPHORE (&m_pDecThrCtx[signal].sThreadInfo.sIsActivated);
 
+  if (m_pDecThrCtx[signal].bLowLatencyOutput) {
+    // the worker goes on with reference marking while the caller parses the next access unit
+    WAIT_EVENT (&m_pDecThrCtx[signal].sImageReady, WELS_DEC_THREAD_WAIT_INFINITE);
+    OutputLowLatencyPicture (&m_pDecThrCtx[signal], ppDst, pDstInfo);
+    return state;
+  }
+
   // wait early picture
   if (m_DecCtxActiveCount >= m_iThreadCount) {
     WAIT_SEMAPHORE (&m_pDecThrCtxActive[0]->sThreadInfo.sIsIdle, WELS_DEC_THREAD_WAIT_INFINITE);
@@ -0,0 +1,635 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ *
+ *
+ * \file    welsDecoderService.cpp
+ *
+ * \brief   per stream decoders on a shared thread pool behind ISVCDecoderService
+ *
+ * \date    10/17/2026 Created
+ *
+ *************************************************************************************
+ */
+
+#include "welsDecoderService.h"
+#include "wels_decoder_thread.h"
+#include "memory_align.h"
+#include "macros.h"
+#include "error_code.h"
+
+using namespace WelsCommon;
+
+namespace WelsDec {
+
+CWelsDecoderStream::CWelsDecoderStream (CWelsDecoderService* pService, const int32_t kiStreamId,
+                                        const int32_t kiQueueDepth)
+  : IWelsTask (this),
+    m_pService (pService),
+    m_iStreamId (kiStreamId),
+    m_pDecoder (NULL),
+    m_bDecoderInited (false),
+    m_pAus (NULL),
+    m_iQueueDepth (kiQueueDepth),
+    m_iAuHead (0),
+    m_iAuCount (0),
+    m_pFrameHead (NULL),
+    m_pFrameTail (NULL),
+    m_bScheduled (false),
+    m_bClosing (false) {
+  memset (&m_sDecParam, 0, sizeof (m_sDecParam));
+  WelsMutexInit (&m_hStateMutex);
+  WelsMutexInit (&m_hDecoderMutex);
+  WelsConditionInit (&m_hFrameCond);
+  WelsConditionInit (&m_hIdleCond);
+}
+
+CWelsDecoderStream::~CWelsDecoderStream() {
+  // the decoder gives its buffers back to the service through the allocator
+  if (NULL != m_pDecoder) {
+    if (m_bDecoderInited)
+      m_pDecoder->Uninitialize();
+    WelsDestroyDecoder (m_pDecoder);
+    m_pDecoder = NULL;
+  }
+  while (NULL != m_pFrameHead) {
+    SDecoderServiceFrame* pFrame = m_pFrameHead;
+    m_pFrameHead = pFrame->pNext;
+    m_pService->FreeFrame (pFrame);
+  }
+  if (NULL != m_pAus) {
+    for (int32_t i = 0; i < m_iQueueDepth; i++) {
+      WELS_SAFE_FREE (m_pAus[i].pBs, "SDecoderServiceAu::pBs");
+    }
+    WELS_SAFE_FREE (m_pAus, "m_pAus");
+  }
+  WelsConditionDestroy (&m_hIdleCond);
+  WelsConditionDestroy (&m_hFrameCond);
+  WelsMutexDestroy (&m_hDecoderMutex);
+  WelsMutexDestroy (&m_hStateMutex);
+}
+
+int32_t CWelsDecoderStream::Init (const SDecodingParam* pParam, const SDecoderFrameAllocator* pAllocator) {
+  m_pAus = static_cast<SDecoderServiceAu*> (WelsMallocz (m_iQueueDepth * sizeof (SDecoderServiceAu),
+           "m_pAus"));
+  if (NULL == m_pAus)
+    return cmMallocMemeError;
+  if (ERR_NONE != WelsCreateDecoder (&m_pDecoder) || NULL == m_pDecoder)
+    return cmMallocMemeError;
+
+  // the workers of the service are the only threads of the stream
+  int32_t iDeblockingThread = 0;
+  m_pDecoder->SetOption (DECODER_OPTION_FRAME_ALLOCATOR, const_cast<SDecoderFrameAllocator*> (pAllocator));
+  m_pDecoder->SetOption (DECODER_OPTION_DEBLOCKING_THREAD, &iDeblockingThread);
+  // Initialize() waits for the first access unit, SetStreamOption() may still change the output until then
+  m_sDecParam = *pParam;
+  return cmResultSuccess;
+}
+
+bool CWelsDecoderStream::InitDecoder() {
+  if (!m_bDecoderInited)
+    m_bDecoderInited = (cmResultSuccess == m_pDecoder->Initialize (&m_sDecParam));
+  return m_bDecoderInited;
+}
+
+int32_t CWelsDecoderStream::Submit (const uint8_t* kpSrc, const int32_t kiSrcLen, const uint64_t kuiTimeStamp) {
+  WelsMutexLock (&m_hDecoderMutex);
+  const bool kbInited = InitDecoder();
+  WelsMutexUnlock (&m_hDecoderMutex);
+  if (!kbInited)
+    return cmInitParaError;
+
+  WelsMutexLock (&m_hStateMutex);
+  if (m_bClosing || m_iAuCount >= m_iQueueDepth) {
+    WelsMutexUnlock (&m_hStateMutex);
+    return cmRetryLater;
+  }
+  // the workers only touch the slots below m_iAuCount, this one is free to fill
+  SDecoderServiceAu* pAu = &m_pAus[ (m_iAuHead + m_iAuCount) % m_iQueueDepth];
+  if (pAu->iCapacity < kiSrcLen) {
+    WELS_SAFE_FREE (pAu->pBs, "SDecoderServiceAu::pBs");
+    pAu->iCapacity = 0;
+    pAu->pBs = static_cast<uint8_t*> (WelsMallocz (kiSrcLen, "SDecoderServiceAu::pBs"));
+    if (NULL == pAu->pBs) {
+      WelsMutexUnlock (&m_hStateMutex);
+      return cmMallocMemeError;
+    }
+    pAu->iCapacity = kiSrcLen;
+  }
+  if (kiSrcLen > 0)
+    memcpy (pAu->pBs, kpSrc, kiSrcLen);
+  pAu->iLen         = kiSrcLen;
+  pAu->uiTimeStamp  = kuiTimeStamp;
+  m_iAuCount++;
+  const bool kbQueue = !m_bScheduled;
+  m_bScheduled = true;
+  WelsMutexUnlock (&m_hStateMutex);
+
+  if (kbQueue && WELS_THREAD_ERROR_OK != m_pService->GetThreadPool()->QueueTask (this)) {
+    WelsMutexLock (&m_hStateMutex);
+    m_iAuCount--;
+    m_bScheduled = false;
+    WelsMutexUnlock (&m_hStateMutex);
+    return cmMallocMemeError;
+  }
+  return cmResultSuccess;
+}
+
+int CWelsDecoderStream::Execute() {
+  for (int32_t i = 0; i < DECODER_SERVICE_AU_PER_RUN; i++) {
+    WelsMutexLock (&m_hStateMutex);
+    if (m_bClosing || 0 == m_iAuCount) {
+      WelsMutexUnlock (&m_hStateMutex);
+      break;
+    }
+    const SDecoderServiceAu* kpAu = &m_pAus[m_iAuHead];
+    WelsMutexUnlock (&m_hStateMutex);
+
+    WelsMutexLock (&m_hDecoderMutex);
+    DecodeAu (kpAu);
+    WelsMutexUnlock (&m_hDecoderMutex);
+
+    WelsMutexLock (&m_hStateMutex);
+    m_iAuHead = (m_iAuHead + 1) % m_iQueueDepth;
+    m_iAuCount--;
+    WelsConditionBroadcast (&m_hFrameCond);
+    WelsMutexUnlock (&m_hStateMutex);
+  }
+  return cmResultSuccess;
+}
+
+int CWelsDecoderStream::OnTaskExecuted() {
+  WelsMutexLock (&m_hStateMutex);
+  // requeue behind the other streams instead of draining this one
+  if (!m_bClosing && m_iAuCount > 0) {
+    WelsMutexUnlock (&m_hStateMutex);
+    if (WELS_THREAD_ERROR_OK == m_pService->GetThreadPool()->QueueTask (this))
+      return cmResultSuccess;
+    WelsMutexLock (&m_hStateMutex);
+  }
+  FinishRun();
+  return cmResultSuccess;
+}
+
+int CWelsDecoderStream::OnTaskCancelled() {
+  WelsMutexLock (&m_hStateMutex);
+  FinishRun();
+  return cmResultSuccess;
+}
+
+// called with m_hStateMutex held, the stream must not be touched any more once Close() may see it idle
+void CWelsDecoderStream::FinishRun() {
+  m_bScheduled = false;
+  if (m_bClosing)
+    WelsConditionBroadcast (&m_hIdleCond);
+  WelsMutexUnlock (&m_hStateMutex);
+}
+
+void CWelsDecoderStream::Close() {
+  WelsMutexLock (&m_hStateMutex);
+  m_bClosing = true;
+  while (m_bScheduled)
+    WelsConditionWait (&m_hIdleCond, &m_hStateMutex);
+  WelsMutexUnlock (&m_hStateMutex);
+}
+
+void CWelsDecoderStream::DecodeAu (const SDecoderServiceAu* kpAu) {
+  uint8_t* pDst[3] = {NULL};
+  SBufferInfo sDstInfo;
+  memset (&sDstInfo, 0, sizeof (sDstInfo));
+  sDstInfo.uiInBsTimeStamp = kpAu->uiTimeStamp;
+
+  if (kpAu->iLen > 0) {
+    const DECODING_STATE keState = m_pDecoder->DecodeFrameNoDelay (kpAu->pBs, kpAu->iLen, pDst, &sDstInfo);
+    OutputPicture (pDst, &sDstInfo, keState);
+    return;
+  }
+
+  // end of stream: the last picture and then the ones still waiting for reordering
+  int32_t iEndOfStream = 1;
+  m_pDecoder->SetOption (DECODER_OPTION_END_OF_STREAM, &iEndOfStream);
+  DECODING_STATE eState = m_pDecoder->DecodeFrame2 (NULL, 0, pDst, &sDstInfo);
+  OutputPicture (pDst, &sDstInfo, eState);
+  int32_t iRemaining = 0;
+  m_pDecoder->GetOption (DECODER_OPTION_NUM_OF_FRAMES_REMAINING_IN_BUFFER, &iRemaining);
+  for (int32_t i = 0; i < iRemaining; i++) {
+    memset (pDst, 0, sizeof (pDst));
+    memset (&sDstInfo, 0, sizeof (sDstInfo));
+    eState = m_pDecoder->FlushFrame (pDst, &sDstInfo);
+    OutputPicture (pDst, &sDstInfo, eState);
+  }
+}
+
+void CWelsDecoderStream::OutputPicture (uint8_t** ppDst, SBufferInfo* pDstInfo, const int32_t kiDecodingState) {
+  void* pUserFrame = NULL;
+  if (1 != pDstInfo->iBufferStatus || cmResultSuccess != m_pDecoder->GetOption (DECODER_OPTION_OUTPUT_USER_FRAME,
+      &pUserFrame) || NULL == pUserFrame)
+    return;
+  // the frame holds its own reference, the decoder may recycle the picture right after
+  SDecoderServiceFrame* pFrame = m_pService->NewFrame (static_cast<SDecoderServiceBuffer*> (pUserFrame));
+  if (NULL == pFrame)
+    return;
+  pFrame->sFrame.iStreamId       = m_iStreamId;
+  pFrame->sFrame.iDecodingState  = kiDecodingState;
+  pFrame->sFrame.sBufferInfo     = *pDstInfo;
+  for (int32_t i = 0; i < 3; i++)
+    pFrame->sFrame.sBufferInfo.pDst[i] = ppDst[i];
+
+  WelsMutexLock (&m_hStateMutex);
+  if (NULL == m_pFrameTail)
+    m_pFrameHead = pFrame;
+  else
+    m_pFrameTail->pNext = pFrame;
+  m_pFrameTail = pFrame;
+  WelsMutexUnlock (&m_hStateMutex);
+}
+
+int32_t CWelsDecoderStream::GetFrame (SDecodedFrame** ppFrame, const bool kbWait) {
+  *ppFrame = NULL;
+  WelsMutexLock (&m_hStateMutex);
+  // the worker queues the frame before it retires the access unit, so no frame can follow an empty queue
+  while (NULL == m_pFrameHead && kbWait && m_iAuCount > 0)
+    WelsConditionWait (&m_hFrameCond, &m_hStateMutex);
+  SDecoderServiceFrame* pFrame = m_pFrameHead;
+  if (NULL != pFrame) {
+    m_pFrameHead = pFrame->pNext;
+    if (NULL == m_pFrameHead)
+      m_pFrameTail = NULL;
+    pFrame->pNext = NULL;
+    *ppFrame = &pFrame->sFrame;
+  }
+  WelsMutexUnlock (&m_hStateMutex);
+  return (NULL != *ppFrame) ? cmResultSuccess : cmRetryLater;
+}
+
+long CWelsDecoderStream::SetOption (DECODER_OPTION eOptionId, void* pOption) {
+  switch (eOptionId) {
+  case DECODER_OPTION_END_OF_STREAM:
+  case DECODER_OPTION_NUM_OF_THREADS:
+  case DECODER_OPTION_THREAD_POOL:
+  case DECODER_OPTION_DEBLOCKING_THREAD:
+  case DECODER_OPTION_SLICE_THREADS:
+  case DECODER_OPTION_LOW_LATENCY_THREADS:
+  case DECODER_OPTION_FRAME_ALLOCATOR:
+    return cmInitParaError;
+  default:
+    break;
+  }
+  WelsMutexLock (&m_hDecoderMutex);
+  const long kiRet = m_pDecoder->SetOption (eOptionId, pOption);
+  WelsMutexUnlock (&m_hDecoderMutex);
+  return kiRet;
+}
+
+long CWelsDecoderStream::GetOption (DECODER_OPTION eOptionId, void* pOption) {
+  WelsMutexLock (&m_hDecoderMutex);
+  const long kiRet = m_pDecoder->GetOption (eOptionId, pOption);
+  WelsMutexUnlock (&m_hDecoderMutex);
+  return kiRet;
+}
+
+CWelsDecoderService::CWelsDecoderService()
+  : m_pThreadPool (NULL),
+    m_ppStreams (NULL),
+    m_iMaxStreams (0),
+    m_iQueueDepth (0),
+    m_iPictureBudget (0),
+    m_iUsedBytes (0),
+    m_iFreeBytes (0),
+    m_pFreeBuffers (NULL),
+    m_pFreeFrames (NULL),
+    m_pAllocatedFrames (NULL) {
+  m_sAllocator.pUserData        = this;
+  m_sAllocator.pfGetBuffer      = GetBuffer;
+  m_sAllocator.pfReleaseBuffer  = ReleaseBuffer;
+  WelsMutexInit (&m_hMutex);
+}
+
+CWelsDecoderService::~CWelsDecoderService() {
+  Uninitialize();
+  WelsMutexDestroy (&m_hMutex);
+}
+
+long CWelsDecoderService::Initialize (const SDecoderServiceParam* pParam) {
+  if (NULL == pParam || pParam->iMaxStreams < 0 || pParam->iQueueDepth < 0 || pParam->iPictureBudget < 0)
+    return cmInitParaError;
+  Uninitialize();
+
+  m_iMaxStreams     = (0 == pParam->iMaxStreams) ? DECODER_SERVICE_MAX_STREAMS_DEFAULT
+                      : WELS_MIN (pParam->iMaxStreams, DECODER_SERVICE_MAX_STREAMS);
+  m_iQueueDepth     = (0 == pParam->iQueueDepth) ? DECODER_SERVICE_QUEUE_DEPTH_DEFAULT
+                      : WELS_MIN (pParam->iQueueDepth, DECODER_SERVICE_QUEUE_DEPTH_MAX);
+  m_iPictureBudget  = pParam->iPictureBudget;
+
+  const SThreadPoolParam& kThreadPool = pParam->sThreadPool;
+  const int32_t kiThreadNum = (kThreadPool.iThreadNum > 0) ? kThreadPool.iThreadNum : GetCPUCount();
+  const int32_t kiCpuNum = WELS_CLIP3 (kThreadPool.iAffinityCpuNum, 0, MAX_THREAD_AFFINITY_CPU_NUM);
+  int32_t iAffinityCpus[MAX_THREAD_AFFINITY_CPU_NUM];
+  for (int32_t i = 0; i < kiCpuNum; i++) {
+    iAffinityCpus[i] = kThreadPool.iAffinityCpu[i];
+  }
+  char szPoolName[MAX_THREAD_POOL_NAME_LEN];
+  memcpy (szPoolName, kThreadPool.szPoolName, MAX_THREAD_POOL_NAME_LEN);
+  szPoolName[MAX_THREAD_POOL_NAME_LEN - 1] = '\0';
+  m_pThreadPool = CWelsThreadPool::AddNamedReference (szPoolName, WELS_MAX (kiThreadNum, 1),
+                  iAffinityCpus, kiCpuNum);
+  if (NULL == m_pThreadPool)
+    return cmMallocMemeError;
+
+  m_ppStreams = static_cast<CWelsDecoderStream**> (WelsMallocz (m_iMaxStreams * sizeof (
+                  CWelsDecoderStream*), "m_ppStreams"));
+  if (NULL == m_ppStreams) {
+    Uninitialize();
+    return cmMallocMemeError;
+  }
+  return cmResultSuccess;
+}
+
+long CWelsDecoderService::Uninitialize() {
+  if (NULL != m_ppStreams) {
+    for (int32_t i = 0; i < m_iMaxStreams; i++) {
+      if (NULL != m_ppStreams[i]) {
+        m_ppStreams[i]->Close();
+        delete m_ppStreams[i];
+        m_ppStreams[i] = NULL;
+      }
+    }
+    WELS_SAFE_FREE (m_ppStreams, "m_ppStreams");
+  }
+
+  // frames the application did not release die with the service
+  while (NULL != m_pAllocatedFrames) {
+    SDecoderServiceFrame* pFrame = m_pAllocatedFrames;
+    m_pAllocatedFrames = pFrame->pNextAllocated;
+    if (pFrame->bInUse)
+      UnrefBuffer (pFrame->pBuffer);
+    WelsFree (pFrame, "SDecoderServiceFrame");
+  }
+  m_pFreeFrames = NULL;
+  while (NULL != m_pFreeBuffers) {
+    SDecoderServiceBuffer* pBuffer = m_pFreeBuffers;
+    m_pFreeBuffers = pBuffer->pNext;
+    WelsFree (pBuffer, "SDecoderServiceBuffer");
+  }
+  m_iUsedBytes = 0;
+  m_iFreeBytes = 0;
+
+  if (NULL != m_pThreadPool) {
+    m_pThreadPool->RemoveInstance();
+    m_pThreadPool = NULL;
+  }
+  return cmResultSuccess;
+}
+
+CWelsDecoderStream* CWelsDecoderService::GetStream (const int32_t kiStreamId) {
+  if (NULL == m_ppStreams || kiStreamId < 0 || kiStreamId >= m_iMaxStreams)
+    return NULL;
+  WelsMutexLock (&m_hMutex);
+  CWelsDecoderStream* pStream = m_ppStreams[kiStreamId];
+  WelsMutexUnlock (&m_hMutex);
+  return pStream;
+}
+
+long CWelsDecoderService::OpenStream (const SDecodingParam* pParam, int* pStreamId) {
+  if (NULL == m_ppStreams)
+    return cmInitExpected;
+  if (NULL == pParam || NULL == pStreamId)
+    return cmInitParaError;
+
+  WelsMutexLock (&m_hMutex);
+  int32_t iStreamId = 0;
+  while (iStreamId < m_iMaxStreams && NULL != m_ppStreams[iStreamId])
+    iStreamId++;
+  if (iStreamId == m_iMaxStreams) {
+    WelsMutexUnlock (&m_hMutex);
+    return cmRetryLater;
+  }
+  CWelsDecoderStream* pStream = new CWelsDecoderStream (this, iStreamId, m_iQueueDepth);
+  const int32_t kiRet = pStream->Init (pParam, &m_sAllocator);
+  if (cmResultSuccess == kiRet)
+    m_ppStreams[iStreamId] = pStream;
+  WelsMutexUnlock (&m_hMutex);
+
+  if (cmResultSuccess != kiRet) {
+    delete pStream;
+    return kiRet;
+  }
+  *pStreamId = iStreamId;
+  return cmResultSuccess;
+}
+
+long CWelsDecoderService::CloseStream (int iStreamId) {
+  if (NULL == m_ppStreams || iStreamId < 0 || iStreamId >= m_iMaxStreams)
+    return cmInitParaError;
+  WelsMutexLock (&m_hMutex);
+  CWelsDecoderStream* pStream = m_ppStreams[iStreamId];
+  m_ppStreams[iStreamId] = NULL;
+  WelsMutexUnlock (&m_hMutex);
+  if (NULL == pStream)
+    return cmInitParaError;
+
+  pStream->Close();
+  delete pStream;
+  return cmResultSuccess;
+}
+
+long CWelsDecoderService::SubmitAccessUnit (int iStreamId, const unsigned char* pSrc, const int iSrcLen,
+    unsigned long long uiTimeStamp) {
+  CWelsDecoderStream* pStream = GetStream (iStreamId);
+  if (NULL == pStream || iSrcLen < 0 || (iSrcLen > 0 && NULL == pSrc))
+    return cmInitParaError;
+  // the end of a stream only gives pictures back, let it through
+  if (iSrcLen > 0 && IsOverBudget())
+    return cmRetryLater;
+  return pStream->Submit (pSrc, iSrcLen, uiTimeStamp);
+}
+
+long CWelsDecoderService::GetDecodedFrame (int iStreamId, SDecodedFrame** ppFrame, bool bWait) {
+  CWelsDecoderStream* pStream = GetStream (iStreamId);
+  if (NULL == pStream || NULL == ppFrame)
+    return cmInitParaError;
+  return pStream->GetFrame (ppFrame, bWait);
+}
+
+long CWelsDecoderService::ReleaseDecodedFrame (SDecodedFrame* pFrame) {
+  // sFrame is the first member, so the application's pointer is the record itself
+  SDecoderServiceFrame* pServiceFrame = reinterpret_cast<SDecoderServiceFrame*> (pFrame);
+  if (NULL == pServiceFrame || !pServiceFrame->bInUse)
+    return cmInitParaError;
+  FreeFrame (pServiceFrame);
+  return cmResultSuccess;
+}
+
+long CWelsDecoderService::SetStreamOption (int iStreamId, DECODER_OPTION eOptionId, void* pOption) {
+  CWelsDecoderStream* pStream = GetStream (iStreamId);
+  if (NULL == pStream)
+    return cmInitParaError;
+  return pStream->SetOption (eOptionId, pOption);
+}
+
+long CWelsDecoderService::GetStreamOption (int iStreamId, DECODER_OPTION eOptionId, void* pOption) {
+  CWelsDecoderStream* pStream = GetStream (iStreamId);
+  if (NULL == pStream)
+    return cmInitParaError;
+  return pStream->GetOption (eOptionId, pOption);
+}
+
+bool CWelsDecoderService::IsOverBudget() {
+  WelsMutexLock (&m_hMutex);
+  const bool kbOver = (m_iPictureBudget > 0 && m_iUsedBytes >= m_iPictureBudget);
+  WelsMutexUnlock (&m_hMutex);
+  return kbOver;
+}
+
+unsigned char* CWelsDecoderService::GetBuffer (void* pUserData, int iSize, void** ppUserFrame) {
+  CWelsDecoderService* pService = static_cast<CWelsDecoderService*> (pUserData);
+  SDecoderServiceBuffer* pBuffer = NULL;
+
+  // streams of one resolution ask for the same sizes over and over
+  WelsMutexLock (&pService->m_hMutex);
+  SDecoderServiceBuffer** ppLink = &pService->m_pFreeBuffers;
+  while (NULL != *ppLink && (*ppLink)->iSize != iSize)
+    ppLink = & (*ppLink)->pNext;
+  if (NULL != *ppLink) {
+    pBuffer = *ppLink;
+    *ppLink = pBuffer->pNext;
+    pService->m_iFreeBytes -= iSize;
+  }
+  pService->m_iUsedBytes += iSize;
+  WelsMutexUnlock (&pService->m_hMutex);
+
+  if (NULL == pBuffer) {
+    const int32_t kiHeaderSize = WELS_ALIGN ((int32_t)sizeof (SDecoderServiceBuffer), 16);
+    pBuffer = static_cast<SDecoderServiceBuffer*> (WelsMallocz (kiHeaderSize + iSize,
+              "SDecoderServiceBuffer"));
+    if (NULL == pBuffer) {
+      WelsMutexLock (&pService->m_hMutex);
+      pService->m_iUsedBytes -= iSize;
+      WelsMutexUnlock (&pService->m_hMutex);
+      return NULL;
+    }
+    pBuffer->pData = reinterpret_cast<uint8_t*> (pBuffer) + kiHeaderSize;
+    pBuffer->iSize = iSize;
+  }
+  pBuffer->pNext      = NULL;
+  pBuffer->iRefCount  = 1;
+  *ppUserFrame = pBuffer;
+  return pBuffer->pData;
+}
+
+void CWelsDecoderService::ReleaseBuffer (void* pUserData, void* pUserFrame) {
+  static_cast<CWelsDecoderService*> (pUserData)->UnrefBuffer (static_cast<SDecoderServiceBuffer*> (pUserFrame));
+}
+
+void CWelsDecoderService::UnrefBuffer (SDecoderServiceBuffer* pBuffer) {
+  bool bFree = false;
+  WelsMutexLock (&m_hMutex);
+  if (0 == --pBuffer->iRefCount) {
+    m_iUsedBytes -= pBuffer->iSize;
+    // keep buffers for reuse within the budget, or without one as many as are in use
+    const int64_t kiKeepLimit = (m_iPictureBudget > 0) ? (m_iPictureBudget - m_iUsedBytes) : m_iUsedBytes;
+    bFree = (m_iFreeBytes + pBuffer->iSize > kiKeepLimit);
+    if (!bFree) {
+      pBuffer->pNext = m_pFreeBuffers;
+      m_pFreeBuffers = pBuffer;
+      m_iFreeBytes += pBuffer->iSize;
+    }
+  }
+  WelsMutexUnlock (&m_hMutex);
+  if (bFree)
+    WelsFree (pBuffer, "SDecoderServiceBuffer");
+}
+
+SDecoderServiceFrame* CWelsDecoderService::NewFrame (SDecoderServiceBuffer* pBuffer) {
+  WelsMutexLock (&m_hMutex);
+  SDecoderServiceFrame* pFrame = m_pFreeFrames;
+  if (NULL != pFrame) {
+    m_pFreeFrames = pFrame->pNext;
+  } else {
+    pFrame = static_cast<SDecoderServiceFrame*> (WelsMallocz (sizeof (SDecoderServiceFrame),
+             "SDecoderServiceFrame"));
+    if (NULL == pFrame) {
+      WelsMutexUnlock (&m_hMutex);
+      return NULL;
+    }
+    pFrame->pNextAllocated = m_pAllocatedFrames;
+    m_pAllocatedFrames = pFrame;
+  }
+  memset (&pFrame->sFrame, 0, sizeof (pFrame->sFrame));
+  pFrame->pNext   = NULL;
+  pFrame->pBuffer = pBuffer;
+  pFrame->bInUse  = true;
+  pBuffer->iRefCount++;
+  WelsMutexUnlock (&m_hMutex);
+  return pFrame;
+}
+
+void CWelsDecoderService::FreeFrame (SDecoderServiceFrame* pFrame) {
+  WelsMutexLock (&m_hMutex);
+  SDecoderServiceBuffer* pBuffer = pFrame->pBuffer;
+  pFrame->pBuffer = NULL;
+  pFrame->bInUse  = false;
+  pFrame->pNext   = m_pFreeFrames;
+  m_pFreeFrames   = pFrame;
+  WelsMutexUnlock (&m_hMutex);
+  UnrefBuffer (pBuffer);
+}
+
+} // namespace WelsDec
+
+using namespace WelsDec;
+
+/*
+*   WelsCreateDecoderService
+*   @return:    success in return 0, otherwise failed.
+*/
+long WelsCreateDecoderService (ISVCDecoderService** ppService) {
+  if (NULL == ppService) {
+    return ERR_INVALID_PARAMETERS;
+  }
+
+  *ppService = new CWelsDecoderService();
+
+  if (NULL == *ppService) {
+    return ERR_MALLOC_FAILED;
+  }
+
+  return ERR_NONE;
+}
+
+/*
+*   WelsDestroyDecoderService
+*/
+void WelsDestroyDecoderService (ISVCDecoderService* pService) {
+  if (NULL != pService) {
+    delete (CWelsDecoderService*)pService;
+  }
+}
@@ -18,18 +18,22 @@ DECODER_CPP_SRCS=\
 	$(DECODER_SRCDIR)/core/src/manage_dec_ref.cpp\
 	$(DECODER_SRCDIR)/core/src/memmgr_nal_unit.cpp\
 	$(DECODER_SRCDIR)/core/src/mv_pred.cpp\
+	$(DECODER_SRCDIR)/core/src/output_convert.cpp\
 	$(DECODER_SRCDIR)/core/src/parse_mb_syn_cabac.cpp\
 	$(DECODER_SRCDIR)/core/src/parse_mb_syn_cavlc.cpp\
 	$(DECODER_SRCDIR)/core/src/pic_queue.cpp\
 	$(DECODER_SRCDIR)/core/src/rec_mb.cpp\
 	$(DECODER_SRCDIR)/core/src/wels_decoder_thread.cpp\
 	$(DECODER_SRCDIR)/plus/src/welsDecoderExt.cpp\
+	$(DECODER_SRCDIR)/plus/src/welsDecoderService.cpp\
 
 DECODER_OBJS += $(DECODER_CPP_SRCS:.cpp=.$(OBJ))
 
 DECODER_ASM_SRCS=\
 	$(DECODER_SRCDIR)/core/x86/dct.asm\
 	$(DECODER_SRCDIR)/core/x86/intra_pred.asm\
+	$(DECODER_SRCDIR)/core/x86/nal_scan.asm\
+	$(DECODER_SRCDIR)/core/x86/output_convert.asm\
 
 DECODER_OBJSASM += $(DECODER_ASM_SRCS:.asm=.$(OBJ))
 ifeq ($(ASM_ARCH), x86)
@@ -40,6 +44,7 @@ OBJS += $(DECODER_OBJSASM)
 DECODER_ASM_ARM_SRCS=\
 	$(DECODER_SRCDIR)/core/arm/block_add_neon.S\
 	$(DECODER_SRCDIR)/core/arm/intra_pred_neon.S\
+	$(DECODER_SRCDIR)/core/arm/nal_scan_neon.S\
 
 DECODER_OBJSARM += $(DECODER_ASM_ARM_SRCS:.S=.$(OBJ))
 ifeq ($(ASM_ARCH), arm)
@@ -50,6 +55,7 @@ OBJS += $(DECODER_OBJSARM)
 DECODER_ASM_ARM64_SRCS=\
 	$(DECODER_SRCDIR)/core/arm64/block_add_aarch64_neon.S\
 	$(DECODER_SRCDIR)/core/arm64/intra_pred_aarch64_neon.S\
+	$(DECODER_SRCDIR)/core/arm64/nal_scan_aarch64_neon.S\
 
 DECODER_OBJSARM64 += $(DECODER_ASM_ARM64_SRCS:.S=.$(OBJ))
 ifeq ($(ASM_ARCH), arm64)
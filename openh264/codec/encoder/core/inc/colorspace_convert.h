@@ -0,0 +1,144 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file    colorspace_convert.h
+ *
+ * \brief   packed RGB / NV12 to I420 conversion for encoder input
+ *
+ * \date    10/16/2026 Created
+ *
+ *************************************************************************************
+ */
+
+#ifndef WELS_COLORSPACE_CONVERT_H__
+#define WELS_COLORSPACE_CONVERT_H__
+
+#include "typedefs.h"
+
+namespace WelsEnc {
+
+/*
+ * Converters read the source exactly once and write Y, U and V in the same pass,
+ * subsampling chroma over each 2x2 block. iWidth and iHeight must be even.
+ */
+typedef void (*PPackedRgbToI420Func) (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY,
+                                      int32_t iDstStrideUV, const uint8_t* kpSrc, int32_t iSrcStride,
+                                      int32_t iWidth, int32_t iHeight);
+typedef void (*PNv12ToI420Func) (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY,
+                                 int32_t iDstStrideUV, const uint8_t* kpSrcY, const uint8_t* kpSrcUV,
+                                 int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth, int32_t iHeight);
+
+typedef struct TagColorspaceConvertFunc {
+  PPackedRgbToI420Func  pfBgrToI420;
+  PPackedRgbToI420Func  pfBgraToI420;
+  PPackedRgbToI420Func  pfRgbaToI420;
+  PNv12ToI420Func       pfNv12ToI420;
+} SColorspaceConvertFunc;
+
+void WelsBgrToI420_c (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                      const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight);
+void WelsBgraToI420_c (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                       const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight);
+void WelsRgbaToI420_c (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                       const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight);
+void WelsNv12ToI420_c (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                       const uint8_t* kpSrcY, const uint8_t* kpSrcUV, int32_t iSrcStrideY, int32_t iSrcStrideUV,
+                       int32_t iWidth, int32_t iHeight);
+
+#if defined(X86_ASM)
+/*
+ * The SIMD converters run the kernels below over the widest part of the picture they take
+ * and leave the remaining columns to the C code.
+ */
+void WelsNv12ToI420_sse2 (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                          const uint8_t* kpSrcY, const uint8_t* kpSrcUV, int32_t iSrcStrideY, int32_t iSrcStrideUV,
+                          int32_t iWidth, int32_t iHeight);
+#if !defined(X86_32_ASM)
+void WelsBgrToI420_sse2 (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                         const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight);
+void WelsBgraToI420_sse2 (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                          const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight);
+void WelsRgbaToI420_sse2 (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                          const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight);
+#endif//!X86_32_ASM
+
+#if defined(HAVE_AVX2)
+void WelsNv12ToI420_avx2 (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                          const uint8_t* kpSrcY, const uint8_t* kpSrcUV, int32_t iSrcStrideY, int32_t iSrcStrideUV,
+                          int32_t iWidth, int32_t iHeight);
+#if !defined(X86_32_ASM)
+void WelsBgrToI420_avx2 (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                         const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight);
+void WelsBgraToI420_avx2 (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                          const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight);
+void WelsRgbaToI420_avx2 (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                          const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight);
+#endif//!X86_32_ASM
+#endif//HAVE_AVX2
+#endif//X86_ASM
+
+void WelsInitColorspaceConvertFunc (SColorspaceConvertFunc* pFuncList, uint32_t uiCpuFlag);
+
+#if defined(__cplusplus)
+extern "C" {
+#endif//__cplusplus
+
+#if defined(X86_ASM)
+void WelsDeinterleaveUVRow_sse2 (uint8_t* pDstU, uint8_t* pDstV, const uint8_t* kpSrcUV, int32_t iWidthUV);
+#if !defined(X86_32_ASM)
+void WelsBgrToI420TwoRows_sse2 (uint8_t* pDstY, int32_t iDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                                const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth);
+void WelsBgraToI420TwoRows_sse2 (uint8_t* pDstY, int32_t iDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                                 const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth);
+void WelsRgbaToI420TwoRows_sse2 (uint8_t* pDstY, int32_t iDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                                 const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth);
+#endif//!X86_32_ASM
+
+#if defined(HAVE_AVX2)
+void WelsDeinterleaveUVRow_avx2 (uint8_t* pDstU, uint8_t* pDstV, const uint8_t* kpSrcUV, int32_t iWidthUV);
+#if !defined(X86_32_ASM)
+void WelsBgrToI420TwoRows_avx2 (uint8_t* pDstY, int32_t iDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                                const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth);
+void WelsBgraToI420TwoRows_avx2 (uint8_t* pDstY, int32_t iDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                                 const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth);
+void WelsRgbaToI420TwoRows_avx2 (uint8_t* pDstY, int32_t iDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+                                 const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth);
+#endif//!X86_32_ASM
+#endif//HAVE_AVX2
+#endif//X86_ASM
+
+#if defined(__cplusplus)
+}
+#endif//__cplusplus
+
+}
+
+#endif//WELS_COLORSPACE_CONVERT_H__
@@ -81,8 +81,19 @@ void WelsBlockFuncInit (PSetNoneZeroCountZeroFunc* pfSetNZCZero,  int32_t iCpu);
 
 void PerformDeblockingFilter (sWelsEncCtx* pEnc);
 
+/*!
+ * \brief  pad the borders of the reconstructed picture by MB rows on the worker threads if it is kept for reference,
+ *         the full expansion at the reference list update is skipped then
+ */
+void PerformReferenceExpansion (sWelsEncCtx* pEnc);
+
 void DeblockingFilterFrameAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc);
 
+/*!
+ * \brief  MB-row wavefront deblocking of the current layer, run by the deblocking tasks and the encoding thread
+ */
+void DeblockingFilterRowsWavefront (sWelsEncCtx* pEnc);
+
 void DeblockingFilterSliceAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc, SSlice* pSlice);
 void DeblockingFilterSliceAvcbaseNull (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc, SSlice* pSlice);
 }
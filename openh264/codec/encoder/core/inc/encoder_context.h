@@ -50,6 +50,7 @@
 #include "stat.h"
 #include "macros.h"
 #include "rc.h"
+#include "rc_stats.h"
 #include "as264_common.h"
 #include "wels_preprocess.h"
 #include "wels_func_ptr_def.h"
@@ -166,6 +167,8 @@ typedef struct TagWelsEncCtx {
 
 // Rate control routine
   SWelsSvcRc*       pWelsSvcRc;
+  SWelsRcStats*     pRcStats;       // statistics file of the two-pass rate control, NULL for a single pass
+  int32_t           iInputFrameIdx; // input picture being encoded, counted across encoder resets, matches the records
   bool              bCheckWindowStatusRefreshFlag;
   int64_t           iCheckWindowStartTs;
   int64_t           iCheckWindowCurrentTs;
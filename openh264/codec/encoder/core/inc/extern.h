@@ -95,6 +95,16 @@ void WelsUninitEncoderExt (sWelsEncCtx** ppCtx);
  */
 int32_t WelsEncoderEncodeExt (sWelsEncCtx*, SFrameBSInfo* pFbi, const SSourcePicture* kpSrcPic);
 
+/*!
+ * \brief   pipelined svc encoding, kpSrcPic is preprocessed while the picture of the previous call is encoded
+ *
+ * \param   h           sWelsEncCtx*, encoder context
+ * \param   pFbi        FrameBSInfo*, the previous picture
+ * \param   kpSrcPic    Source picture, NULL to flush
+ * \return  EFrameType (videoFrameTypeIDR/videoFrameTypeI/videoFrameTypeP)
+ */
+int32_t WelsEncoderEncodePipelined (sWelsEncCtx*, SFrameBSInfo* pFbi, const SSourcePicture* kpSrcPic);
+
 int32_t WelsEncoderEncodeParameterSets (sWelsEncCtx* pCtx, void* pDst);
 
 /*
@@ -65,6 +65,59 @@ int32_t         iThreadIndex;   // thread index, zero based
 
 } SSliceThreadPrivateData;
 
+/*
+ *  Per-row MB progress of a wavefront, the waiters block on the condition of the row they wait for and are woken up
+ *  only when that row advances, see RowProgressWait() and RowProgressUpdate()
+ */
+typedef struct TagRowProgress {
+int32_t*                pMbCount;       // count of MBs done in each row, [iMbY]
+int32_t*                pWaiterNum;     // threads blocked on each row, [iMbY]
+WELS_CONDITION*         pCondRow;       // [iMbY]
+int32_t                 iRowNum;
+int32_t                 iNextRow;       // next row to be claimed by a worker
+WELS_MUTEX              mutexProgress;  // all of the above
+} SRowProgress;
+
+/*
+ *  MB-row wavefront ME/MD within a single slice: worker threads run mode decision and reconstruction
+ *  row by row, the encoding thread consumes the MD results in raster order for entropy coding
+ */
+#define WAVEFRONT_SCRATCH_BS_SIZE  (MAX_MACROBLOCK_SIZE_IN_BYTE_x2 << 2)  // per-worker buffer for CAVLC overflow check
+
+typedef struct TagWavefrontMbSyn {
+SMVComponentUnit        sMvComponents;
+int8_t                  iNonZeroCoeffCount[48];
+SMVUnitXY               sMbMvp[MB_BLOCK4x4_NUM];
+bool                    bPrevIntra4x4PredModeFlag[16];
+int8_t                  iRemIntra4x4PredModeFlag[16];
+bool                    bMbTypeSkip[4];
+uint8_t                 uiLumaI16x16Mode;
+uint8_t                 uiChmaI8x8Mode;
+bool                    bCollocatedPredFlag;
+uint8_t                 uiLumaQp;       // may be raised over the RC decision by CAVLC overflow handling
+uint8_t                 uiChromaQp;
+int32_t                 iCostLuma;
+SDCTCoeff               sDct;
+} SWavefrontMbSyn;      // MD output needed by the MB syntax writer, [iMbXY]
+
+typedef struct TagWavefrontMd {
+SSlice*                 pWorkerSlice;   // shadow slices with private MB cache and scratch bs, [iWorkerIdx]
+SWavefrontMbSyn*        pMbSyn;         // [iMbXY]
+SRowProgress            sProgress;      // MBs done by ME/MD and reconstruction
+int32_t                 iWorkerNum;
+const void*             pMdTemplate;    // SWelsMD initialized by the slice coding
+} SWavefrontMd;
+
+/*
+ *  MB-row wavefront deblocking of the whole picture: every row keeps two MBs behind the row above so that the
+ *  filtering order of the raster scan is preserved, the borders are padded as soon as a row is final
+ */
+typedef struct TagWavefrontDeblocking {
+SRowProgress            sProgress;      // MBs filtered
+bool                    bFilter;        // false if the picture is final, the rows are only padded then
+bool                    bExpandBorder;  // pad the reference borders along with the filtering
+} SWavefrontDeblocking;
+
 typedef struct TagSliceThreading {
 SSliceThreadPrivateData*        pThreadPEncCtx;// thread context, [iThreadIdx]
 char eventNamespace[100];
@@ -86,6 +139,9 @@ bool                            bThreadBsBufferUsage[MAX_THREADS_NUM];
 WELS_MUTEX                      mutexThreadBsBufferUsage;
 WELS_MUTEX                      mutexEvent;
 WELS_MUTEX                      mutexThreadSlcBuffReallocate;
+
+SWavefrontMd*                   pWavefrontMd;   // NULL if MB-row wavefront ME/MD is not used
+SWavefrontDeblocking*           pWavefrontDeblocking;
 } SSliceThreading;
 
 #endif//MULTIPLE_THREADING_DEFINES_H__
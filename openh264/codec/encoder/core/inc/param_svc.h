@@ -49,6 +49,7 @@
 #include "rc.h"
 #include "svc_enc_slice_segment.h"
 #include "as264_common.h"
+#include "crt_util_safe_x.h"
 
 namespace WelsEnc {
 
@@ -123,6 +124,13 @@ typedef struct TagWelsSvcCodingParam: SEncParamExt {
   int8_t   iDecompStages;          // GOP size dependency
   int32_t  iMaxNumRefFrame;
 
+  bool             bThreadPoolParam;  // run the tasks on the pool described by sThreadPool, not the process wide one
+  SThreadPoolParam sThreadPool;
+
+  char      sRcStatsFileName[MAX_FNAME_LEN]; // own copy of pRcStatsFileName, which is left NULL inside the encoder
+                                             // and points here in ENCODER_OPTION_SVC_ENCODE_PARAM_EXT
+  bool      bRcStatsAppend;   // set by an encoder reset keeping the pass and the file: append the first pass records
+
  public:
   TagWelsSvcCodingParam() {
     FillDefault();
@@ -144,6 +152,8 @@ typedef struct TagWelsSvcCodingParam: SEncParamExt {
     param.iMaxBitrate           = UNSPECIFIED_BIT_RATE;
     param.iMultipleThreadIdc    = 1;
     param.bUseLoadBalancing = true;
+    param.bUseWavefrontMd = false;
+    param.bEnableFramePipeline = false;
 
     param.iLTRRefNum            = 0;
     param.iLtrMarkPeriod        = 30;   //the min distance of two int32_t references
@@ -164,6 +174,7 @@ typedef struct TagWelsSvcCodingParam: SEncParamExt {
     param.iEntropyCodingModeFlag        = 0;
     param.bEnableDenoise                = false;        // denoise control
     param.bEnableSceneChangeDetect      = true;         // scene change detection control
+    param.bEnablePyramidMe              = false;        // coarse to fine motion search seeds
     param.bEnableBackgroundDetection    = true;         // background detection control
     param.bEnableAdaptiveQuant          = true;         // adaptive quantization control
     param.bEnableFrameSkip              = true;         // frame skipping
@@ -175,6 +186,9 @@ typedef struct TagWelsSvcCodingParam: SEncParamExt {
 
     param.iMaxQp = QP_MAX_VALUE;
     param.iMinQp = QP_MIN_VALUE;
+    param.iLookaheadFrames = 0;
+    param.eRcPass = RC_SINGLE_PASS;
+    param.pRcStatsFileName = NULL;
     param.iUsageType = CAMERA_VIDEO_REAL_TIME;
     param.uiMaxNalSize = 0;
     param.bIsLosslessLink = false;
@@ -228,6 +242,11 @@ typedef struct TagWelsSvcCodingParam: SEncParamExt {
 
     iDecompStages               = 0;    // GOP size dependency, unknown here and be revised later
     iBitsVaryPercentage = 10;
+
+    bThreadPoolParam            = false;
+    memset (&sThreadPool, 0, sizeof (sThreadPool));
+    sRcStatsFileName[0] = '\0';
+    bRcStatsAppend = false;
   }
 
   int32_t ParamBaseTranscode (const SEncParamBase& pCodingParam) {
@@ -303,6 +322,8 @@ typedef struct TagWelsSvcCodingParam: SEncParamExt {
 
     iMultipleThreadIdc = pCodingParam.iMultipleThreadIdc;
     bUseLoadBalancing = pCodingParam.bUseLoadBalancing;
+    bUseWavefrontMd = pCodingParam.bUseWavefrontMd;
+    bEnableFramePipeline = pCodingParam.bEnableFramePipeline;
 
     /* Deblocking loop filter */
     iLoopFilterDisableIdc       = pCodingParam.iLoopFilterDisableIdc;      // 0: on, 1: off, 2: on except for slice boundaries,
@@ -323,12 +344,20 @@ typedef struct TagWelsSvcCodingParam: SEncParamExt {
     }
     iMaxQp = pCodingParam.iMaxQp;
     iMinQp = pCodingParam.iMinQp;
+    iLookaheadFrames = pCodingParam.iLookaheadFrames;
+    eRcPass = pCodingParam.eRcPass;
+    pRcStatsFileName = NULL;
+    if (NULL != pCodingParam.pRcStatsFileName)
+      WelsStrncpy (sRcStatsFileName, MAX_FNAME_LEN, pCodingParam.pRcStatsFileName);
+    else
+      sRcStatsFileName[0] = '\0';
     uiMaxNalSize          = pCodingParam.uiMaxNalSize;
     /* Denoise Control */
     bEnableDenoise = pCodingParam.bEnableDenoise ? true : false;    // Denoise Control  // only support 0 or 1 now
 
     /* Scene change detection control */
     bEnableSceneChangeDetect   = pCodingParam.bEnableSceneChangeDetect;
+    bEnablePyramidMe           = pCodingParam.bEnablePyramidMe;
 
     /* Background detection Control */
     bEnableBackgroundDetection = pCodingParam.bEnableBackgroundDetection ? true : false;
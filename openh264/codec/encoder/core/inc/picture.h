@@ -57,6 +57,8 @@ bool      bRefBlockFeatureCalculated; // flag of whether pre-process is done
 uint16_t **pFeatureValuePointerList;//uint16_t* pFeatureValuePointerList[WELS_MAX (LIST_SIZE_SUM_16x16, LIST_SIZE_MSE_16x16)]
 } SScreenBlockFeatureStorage; //should be stored with RefPic, one for each frame
 
+#define PYRAMID_ME_LEVEL_NUM 2 // 1/2 and 1/4 size planes, i.e. 1/4 and 1/16 of the luma samples
+
 /*
  *  Reconstructed Picture definition
  *  It is used to express reference picture, also consequent reconstruction picture for output
@@ -96,10 +98,14 @@ uint8_t    uiRecieveConfirmed;
 uint8_t    uiTemporalId;
 uint8_t    uiSpatialId;
 int32_t   iFrameAverageQp;
+bool      bBorderExpanded;      // borders padded by the wavefront deblocking, no expansion needed for reference
 
 /*******************************for screen reference frames****************************/
 SScreenBlockFeatureStorage* pScreenBlockFeatureStorage;
 
+/*******************************for pyramid motion search******************************/
+struct TagPicture* pPyramidPlane[PYRAMID_ME_LEVEL_NUM]; // downsampled luma of the source, level 0 is the 1/2 size one
+
   /*
    *    set picture as unreferenced
    */
@@ -55,6 +55,12 @@ namespace WelsEnc {
 SPicture* AllocPicture (CMemoryAlign* pMa, const int32_t kiWidth, const int32_t kiHeight, bool bNeedMbInfo,
                         int32_t iNeedFeatureStorage);
 
+/*!
+ * \brief   alloc the downsampled planes of the pyramid motion search for a picture allocated by AllocPicture()
+ * \return  ENC_RETURN_SUCCESS if successful, the planes are freed with the picture in any case
+ */
+int32_t AllocPicturePyramid (CMemoryAlign* pMa, SPicture* pPic);
+
 /*!
  * \brief   free picture pData planes
  * \param   pic     picture pointer to be destoryed
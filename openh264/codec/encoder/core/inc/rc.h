@@ -119,6 +119,8 @@ enum {
 #define VGOP_BITS_PERCENTAGE_DIFF 5
 #define IDR_BITRATE_RATIO  4
 #define FRAME_iTargetBits_VARY_RANGE 50 // *INT_MULTIPLY
+#define LOOKAHEAD_BITS_VARY_RANGE 50 // *INT_MULTIPLY, target bits of a P frame scaled by its lookahead cost within this range
+#define RC_STATS_BITS_VARY_RANGE 60 // *INT_MULTIPLY, second pass target bits of a P frame scaled by its weight within this range
 //R-Q Model
 #define LINEAR_MODEL_DECAY_FACTOR 80 // *INT_MULTIPLY
 #define FRAME_CMPLX_RATIO_RANGE 20 // *INT_MULTIPLY
@@ -0,0 +1,127 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ *
+ * \file    rc_stats.h
+ *
+ * \brief   statistics file of the two-pass rate control: written by the first pass, read back by the second one
+ *
+ * \date    10/17/2026 Created
+ *
+ *************************************************************************************
+ */
+
+#ifndef WELS_RC_STATS_H__
+#define WELS_RC_STATS_H__
+
+#include "typedefs.h"
+#include "codec_app_def.h"
+#include "wels_const.h"
+#include "crt_util_safe_x.h"
+#include "svc_enc_macroblock.h"
+
+namespace WelsEnc {
+
+typedef struct TagWelsEncCtx sWelsEncCtx;
+
+#define RC_STATS_MAGIC          0x53435257  // "WRCS" in a little endian file
+#define RC_STATS_VERSION        3
+#define RC_STATS_CMPLX_EXP      0.6         // weight of a frame in the second pass is (bits * qstep) to this power
+
+/*
+ * File layout, native byte order:
+ *   header:  magic, version, layer number, MB width and MB height of each layer (int32_t each)
+ *   records: one per coded layer picture in coding order, the fields of SRcStatsFrame followed by
+ *            the coded bits of each MB of the layer (uint16_t, saturated)
+ */
+typedef struct TagRcStatsFrame {
+  int64_t   iTimeStamp;         // rate control timestamp, only checked against the one of the matched picture
+  int32_t   iFrameIdx;          // index of the input picture, records are matched on it
+  uint8_t   uiDependencyId;
+  uint8_t   uiTemporalId;
+  uint8_t   uiSliceType;        // I_SLICE or P_SLICE
+  uint8_t   uiAverageQp;
+  int32_t   iFrameBits;
+  uint16_t* pMbBits;
+} SRcStatsFrame;
+
+typedef struct TagRcStatsLayer {
+  int32_t       iMbWidth;
+  int32_t       iMbHeight;
+  SRcStatsFrame sFrame;         // first pass: picture being coded; second pass: record matched to it if bFrameValid
+  bool          bFrameValid;
+  int32_t*      pGomBits;       // second pass: first pass bits of each GOM of the matched record
+  double        dMeanWeight[MAX_TEMPORAL_LEVEL]; // second pass: mean weight of the P records of each temporal layer
+} SRcStatsLayer;
+
+typedef struct TagWelsRcStats {
+  ERcPassType     eRcPass;
+  WelsFileHandle* pFile;
+  int32_t         iLayerNum;
+  SRcStatsLayer   sLayer[MAX_DEPENDENCY_LAYER];
+  SRcStatsFrame   sNextFrame;   // second pass: record read ahead, not matched to a picture yet
+  bool            bNextValid;
+} SWelsRcStats;
+
+/*!
+ * \brief   open the statistics file of eRcPass, the second pass also scans it for the mean weights; a first pass
+ *          reopened by an encoder reset appends to the file; pEncCtx->pRcStats stays NULL for a single pass or when
+ *          the file can not be used
+ */
+void WelsRcStatsInit (sWelsEncCtx* pEncCtx);
+void WelsRcStatsUninit (sWelsEncCtx* pEncCtx);
+
+/*!
+ * \brief   first pass: start the record of the current layer picture;
+ *          second pass: match the record of the current layer picture by the input picture index, records of
+ *          skipped pictures are dropped; a record whose timestamp differs was written for another input, the rest
+ *          of the encoding then falls back to a single pass
+ */
+void WelsRcStatsPictureInit (sWelsEncCtx* pEncCtx, const long long kiTimeStamp);
+void WelsRcStatsMbInfoUpdate (sWelsEncCtx* pEncCtx, SMB* pCurMb, const int32_t kiMbBits);
+/*!
+ * \brief   first pass: write the record of the current layer picture once it is coded
+ */
+void WelsRcStatsPictureInfoUpdate (sWelsEncCtx* pEncCtx);
+
+/*!
+ * \brief   second pass: weight of the matched record over the mean weight of the P records of the same layers,
+ *          in INT_MULTIPLY units; false if there is no matched record or no P record to compare with
+ */
+bool WelsRcStatsWeightRatio (sWelsEncCtx* pEncCtx, int64_t* pRatio);
+/*!
+ * \brief   second pass: first pass bits of each GOM of the current layer picture, NULL without a matched record
+ */
+const int32_t* WelsRcStatsGomBits (sWelsEncCtx* pEncCtx);
+
+}
+
+#endif//WELS_RC_STATS_H__
@@ -180,7 +180,7 @@ SSliceHeaderExt sSliceHeaderExt;
 
 SMVUnitXY       sMvStartMin;
 SMVUnitXY       sMvStartMax;
-SMVUnitXY       sMvc[5];
+SMVUnitXY       sMvc[MAX_MVC_NUM];
 uint8_t         uiMvcNum;
 uint8_t         sScaleShift;
 
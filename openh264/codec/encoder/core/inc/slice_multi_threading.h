@@ -68,6 +68,13 @@ int32_t RequestMtResource (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pParam, con
 
 void ReleaseMtResource (sWelsEncCtx** ppCtx);
 
+int32_t RowProgressInit (SRowProgress* pProgress, const int32_t kiMaxRowNum, CMemoryAlign* pMa);
+void RowProgressUninit (SRowProgress* pProgress, CMemoryAlign* pMa);
+void RowProgressReset (SRowProgress* pProgress, const int32_t kiRowNum);
+int32_t RowProgressClaimRow (SRowProgress* pProgress);
+void RowProgressUpdate (SRowProgress* pProgress, const int32_t kiRow, const int32_t kiMbCount);
+void RowProgressWait (SRowProgress* pProgress, const int32_t kiRow, const int32_t kiMbCount);
+
 int32_t AppendSliceToFrameBs (sWelsEncCtx* pCtx, SLayerBSInfo* pLbi, const int32_t kiSliceCount);
 
 #if !defined(_WIN32)
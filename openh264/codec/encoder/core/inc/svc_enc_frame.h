@@ -68,6 +68,13 @@ uint8_t uiFMEGoodFrameCount;
 int32_t iHighFreMbCount;
 } SFeatureSearchPreparation; //maintain only one
 
+// the downsampled planes go with the reconstructed pictures, see SPicture::pPyramidPlane
+typedef struct TagPyramidMeStorage {
+SMVUnitXY*      pCoarseMv;      // vector of every 8x8 block on the 1/4 size plane (one per 2x2 MBs), in its pixels
+SMVUnitXY*      pMbMv;          // seed of every MB in quarter pel of the layer, refined on the 1/2 size plane
+bool            bMbMvAvailable; // whether pMbMv is valid for the current frame
+} SPyramidMeStorage;
+
 typedef struct TagSliceBufferInfo {
 SSlice*                 pSliceBuffer;  // slice buffer for multi thread,
 int32_t                 iMaxSliceNum;
@@ -124,6 +131,7 @@ int32_t*                pCountMbNumInSlice;
 bool                    bNeedAdjustingSlicing;
 
 SFeatureSearchPreparation* pFeatureSearchPreparation;
+SPyramidMeStorage*      pPyramidMe;     // coarse to fine motion search seeds, NULL if disabled
 
 SDqLayer*               pRefLayer;              // pointer to referencing dq_layer of current layer to be decoded
 };
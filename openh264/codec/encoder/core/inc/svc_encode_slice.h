@@ -176,6 +176,9 @@ int32_t WelsMdInterMbLoop (sWelsEncCtx* pEncCtx, SSlice* pSlice, void* pMd,
                            const int32_t kiSliceFirstMbXY); // for inter non-dynamic slice
 int32_t WelsMdInterMbLoopOverDynamicSlice (sWelsEncCtx* pEncCtx, SSlice* pSlice, void* pMd,
     const int32_t kiSliceFirstMbXY); // for inter dynamic slice
+int32_t WelsMdInterMbLoopWavefront (sWelsEncCtx* pEncCtx, SSlice* pSlice, void* pMd,
+                                    const int32_t kiSliceFirstMbXY); // for inter single slice with MB-row wavefront MD
+void WelsMdInterMbRowsWavefront (sWelsEncCtx* pEncCtx, const int32_t kiWorkerIdx); // wavefront MD worker
 
 
 bool DynSlcJudgeSliceBoundaryStepBack (void* pEncCtx, void* pSlice, SSliceCtx* pSliceCtx, SMB* pCurMb,
@@ -47,6 +47,9 @@
 namespace WelsEnc {
 #define CAMERA_STARTMV_RANGE (64)
 #define  ITERATIVE_TIMES  (16)
+#define SAD_MULTI_BATCH_NUM (16) // max candidates measured by one batch SAD call of the line search
+#define PYRAMID_ME_COARSE_RANGE (8) // full search range around zero on the 1/4 size plane, 32 pixels of the layer
+#define PYRAMID_ME_REFINE_RANGE (2) // search range around the predicted vectors on both downsampled planes
 #define CAMERA_MV_RANGE (CAMERA_STARTMV_RANGE+ITERATIVE_TIMES)
 #define CAMERA_MVD_RANGE  ((CAMERA_MV_RANGE+1)<<1) //mvd=mv_range*2;
 #define  BASE_MV_MB_NMB  ((2*CAMERA_MV_RANGE/MB_WIDTH_LUMA)-1)
@@ -321,6 +324,24 @@ int32_t RequestFeatureSearchPreparation (CMemoryAlign* pMa, const int32_t kiFram
     const int32_t iNeedFeatureStorage,
     SFeatureSearchPreparation* pFeatureSearchPreparation);
 int32_t ReleaseFeatureSearchPreparation (CMemoryAlign* pMa, uint16_t*& pFeatureOfBlock);
+int32_t RequestPyramidMeStorage (CMemoryAlign* pMa, const int32_t kiMbWidth, const int32_t kiMbHeight,
+                                 SPyramidMeStorage* pPyramidMe);
+void ReleasePyramidMeStorage (CMemoryAlign* pMa, SPyramidMeStorage* pPyramidMe);
+
+/*!
+ * \brief  8x8 full search by batched SAD of the kiRange window around ksCenter within [ksMin, ksMax], sBestMv and
+ *         iBestSad are only replaced by a strictly smaller SAD
+ */
+void PyramidBlockSearch (PSampleSadMultiFunc pSadMulti, uint8_t* pCur, const int32_t kiCurStride,
+                         uint8_t* pRef, const int32_t kiRefStride, const SMVUnitXY ksCenter, const int32_t kiRange,
+                         const SMVUnitXY ksMin, const SMVUnitXY ksMax, SMVUnitXY& sBestMv, int32_t& iBestSad);
+
+/*!
+ * \brief  coarse to fine search on the downsampled planes ppCurPlane/ppRefPlane, a full search of every 8x8 block of
+ *         the 1/4 size plane is refined per MB on the 1/2 size plane and kept in pMbMv as an initial candidate of the ME
+ */
+void PerformPyramidMotionSearch (SWelsFuncPtrList* pFuncList, SPyramidMeStorage* pPyramidMe, SPicture** ppCurPlane,
+                                 SPicture** ppRefPlane, const int32_t kiMbWidth, const int32_t kiMbHeight, const int32_t kiMvRange);
 
 #define FMESWITCH_DEFAULT_GOODFRAME_NUM (2)
 #define FME_DEFAULT_FEATURE_INDEX (0)
@@ -57,6 +57,7 @@
 #define PARA_SET_TYPE_PPS               2
 
 #define MAX_VERTICAL_MV_RANGE           1024  //TODO, for allocate enough memory for transpose
+#define MAX_MVC_NUM                     6     // maximal number of mv candidates for the ME initial point
 #define MAX_FRAME_RATE                  60      // maximal frame rate to support
 #define MIN_FRAME_RATE                  1       // minimal frame rate need support
 
@@ -118,6 +119,8 @@
 #define MAX_REF_PIC_COUNT               16 // 32 in standard, maximal Short + Long reference pictures
 #define MIN_REF_PIC_COUNT               1               // minimal count number of reference pictures, 1 short + 2 key reference based?
 #define MAX_MULTI_REF_PIC_COUNT         1       //maximum multi-reference number
+#define MAX_LOOKAHEAD_FRAMES            16      // maximal number of input pictures analysed ahead of the encoding
+#define MAX_STAGED_SET_NUM              (MAX_LOOKAHEAD_FRAMES + 1) // staged picture sets, "+1" is for the next input
 //#define TOTAL_REF_MINUS_HALF_GOP      1       // last t0 in last gop
 #define MAX_MMCO_COUNT                  66
 
@@ -52,6 +52,10 @@
 
 namespace WelsEnc {
 
+#define LOOKAHEAD_SEARCH_RANGE          4       // full search range of the lookahead on the 1/2 size luma
+#define LOOKAHEAD_SCENE_CUT_RATIO       65      // in percent, inter cost at least that part of the intra cost means a scene cut
+#define LOOKAHEAD_SCENE_CUT_MIN_COST    1       // average SATD per 1/2 size pixel below which no scene cut is declared
+
 typedef struct TagWelsEncCtx sWelsEncCtx;
 
 typedef  struct {
@@ -101,6 +105,9 @@ typedef struct TagVAAFrameInfo {
   ESceneChangeIdc eSceneChangeIdc;
   bool          bSceneChangeFlag;
   bool          bIdrPeriodFlag;
+
+  int32_t       iLookaheadFrameCost;  // low resolution cost of the current picture, 0 without lookahead
+  int32_t       iLookaheadWindowCost; // average cost of the pictures in the lookahead window, the current one included
 } SVAAFrameInfo;
 
 typedef struct SVAAFrameInfoExt_t: public SVAAFrameInfo {
@@ -115,6 +122,26 @@ typedef struct SVAAFrameInfoExt_t: public SVAAFrameInfo {
   uint8_t*    pVaaBlockStaticIdc[16];//real memory,
 } SVAAFrameInfoExt;
 
+/*
+ *  Lookahead analysis of a staged picture, done on 1/2 size luma when it is staged
+ */
+typedef struct TagLookaheadInfo {
+  SPicture*     pLowResPic;     // 1/2 size luma of the picture, reference of the analysis of the next one
+  int32_t       iIntraCost;     // sum of 8x8 SATD against the block DC
+  int32_t       iFrameCost;     // sum of the smaller of the intra and the inter 8x8 SATD
+  bool          bSceneCut;      // inter prediction from the previous picture barely helps
+} SLookaheadInfo;
+
+/*
+ *  Scene change detection and VAA of a staged picture against the input staged before it, done when it is staged
+ *  with the frame pipeline; taken over by the encoding only if it references that very picture as a P picture
+ */
+typedef struct TagStagedVaaInfo {
+  SVAAFrameInfo   sVaa;            // VAA and adaptive quant results of the highest layer
+  SPicture*       pRefPic;         // source picture the analysis referenced, NULL if none was analysed
+  ESceneChangeIdc eSceneChangeIdc;
+} SStagedVaaInfo;
+
 class CWelsPreProcess {
  public:
   CWelsPreProcess (sWelsEncCtx* pEncCtx);
@@ -128,6 +155,12 @@ class CWelsPreProcess {
   int32_t AllocSpatialPictures (sWelsEncCtx* pCtx, SWelsSvcCodingParam* pParam);
   void    FreeSpatialPictures (sWelsEncCtx* pCtx);
   int32_t BuildSpatialPicList (sWelsEncCtx* pEncCtx, const SSourcePicture* kpSrcPic);
+  int32_t GetSourceBuffer (sWelsEncCtx* pEncCtx, SSourcePicture* pSrcPic);
+  bool    IsStageReady (const SSourcePicture* kpSrcPic);
+  int32_t StagePicture (sWelsEncCtx* pEncCtx, const SSourcePicture* kpSrcPic, const int32_t kiSet);
+  void    CommitStagedPicture (const int32_t kiSet);
+  int32_t GetStagedPicture (SSourcePicture* pSrcPic, const bool kbFlush);
+  int32_t GetFreeStagedSet();
   int32_t AnalyzeSpatialPic (sWelsEncCtx* pEncCtx, const int32_t kiDIdx);
   int32_t UpdateSpatialPictures (sWelsEncCtx* pEncCtx, SWelsSvcCodingParam* pParam, const int8_t iCurTid,
                                  const int32_t d_idx);
@@ -135,6 +168,8 @@ class CWelsPreProcess {
   void    AnalyzePictureComplexity (sWelsEncCtx* pCtx, SPicture* pCurPicture, SPicture* pRefPicture,
                                     const int32_t kiDependencyId, const bool kbCalculateBGD);
   int32_t UpdateBlockIdcForScreen (uint8_t*  pCurBlockStaticPointer, const SPicture* kpRefPic, const SPicture* kpSrcPic);
+  void    DownsamplePyramid (SPicture* pSrc, const int32_t kiWidth, const int32_t kiHeight, SPicture** ppPlanes,
+                             const int32_t kiLevelNum);
 
 
   void UpdateSrcList (SPicture* pCurPicture, const int32_t kiCurDid, SPicture** pShortRefList,
@@ -146,6 +181,7 @@ class CWelsPreProcess {
  protected:
   bool GetSceneChangeFlag (ESceneChangeIdc eSceneChangeIdc);
   virtual  ESceneChangeIdc  DetectSceneChange (SPicture* pCurPicture, SPicture* pRefPicture = NULL) = 0;
+  ESceneChangeIdc  DetectVideoSceneChange (IWelsVP* pVp, SPicture* pCurPicture, SPicture* pRefPicture);
 
   void InitPixMap (const SPicture* pPicture, SPixMap* pPixMap);
 
@@ -155,28 +191,42 @@ class CWelsPreProcess {
   int32_t WelsPreprocessCreate();
   int32_t WelsPreprocessDestroy();
   int32_t InitLastSpatialPictures (sWelsEncCtx* pEncCtx);
+  int32_t InitSourceSize (sWelsEncCtx* pEncCtx, const SSourcePicture* kpSrcPic);
+  int32_t AllocStagedVaa (sWelsEncCtx* pEncCtx, SWelsSvcCodingParam* pParam);
+  void    FreeStagedVaa (sWelsEncCtx* pEncCtx);
 
  private:
   int32_t SingleLayerPreprocess (sWelsEncCtx* pEncCtx, const SSourcePicture* kpSrc, Scaled_Picture* m_sScaledPicture);
-
-  void  BilateralDenoising (SPicture* pSrc, const int32_t iWidth, const int32_t iHeight);
-
-  int32_t DownsamplePadding (SPicture* pSrc, SPicture* pDstPic,  int32_t iSrcWidth, int32_t iSrcHeight,
+  int32_t ScaleSourcePicture (IWelsVP* pVp, sWelsEncCtx* pEncCtx, const SSourcePicture* kpSrc,
+                              Scaled_Picture* pScaledPicture, SPicture** ppDstPic);
+  void    SwapInStagedPictures (sWelsEncCtx* pEncCtx, const int32_t kiSet);
+  void    AnalyzeStagedPicture (sWelsEncCtx* pEncCtx, const int32_t kiSet);
+  void    UpdateLookaheadCost (sWelsEncCtx* pEncCtx, const int32_t kiSet);
+  void    AnalyzeStagedVaa (sWelsEncCtx* pEncCtx, const int32_t kiSet);
+  SStagedVaaInfo* GetStagedVaa (const int32_t kiDidx, const SPicture* kpRefPic);
+  void    TakeStagedVaa (sWelsEncCtx* pEncCtx, const SStagedVaaInfo* kpStaged, SPicture* pCurPic);
+
+  void  BilateralDenoising (IWelsVP* pVp, SPicture* pSrc, const int32_t iWidth, const int32_t iHeight);
+
+  int32_t DownsamplePadding (IWelsVP* pVp, SPicture* pSrc, SPicture* pDstPic,  int32_t iSrcWidth, int32_t iSrcHeight,
                              int32_t iShrinkWidth, int32_t iShrinkHeight, int32_t iTargetWidth, int32_t iTargetHeight,
                              bool bForceCopy);
-
-  void    VaaCalculation (SVAAFrameInfo* pVaaInfo, SPicture* pCurPicture, SPicture* pRefPicture, bool bCalculateSQDiff,
-                          bool bCalculateVar, bool bCalculateBGD);
-  void    BackgroundDetection (SVAAFrameInfo* pVaaInfo, SPicture* pCurPicture, SPicture* pRefPicture, bool bDetectFlag);
-  void    AdaptiveQuantCalculation (SVAAFrameInfo* pVaaInfo, SPicture* pCurPicture, SPicture* pRefPicture);
+  void    DownsamplePyramid (IWelsVP* pVp, SPicture* pSrc, const int32_t kiWidth, const int32_t kiHeight,
+                             SPicture** ppPlanes, const int32_t kiLevelNum);
+
+  void    VaaCalculation (IWelsVP* pVp, SVAAFrameInfo* pVaaInfo, SPicture* pCurPicture, SPicture* pRefPicture,
+                          bool bCalculateSQDiff, bool bCalculateVar, bool bCalculateBGD);
+  void    BackgroundDetection (IWelsVP* pVp, SVAAFrameInfo* pVaaInfo, SPicture* pCurPicture, SPicture* pRefPicture,
+                               bool bDetectFlag);
+  void    AdaptiveQuantCalculation (IWelsVP* pVp, SVAAFrameInfo* pVaaInfo, SPicture* pCurPicture, SPicture* pRefPicture);
   void    Padding (uint8_t* pSrcY, uint8_t* pSrcU, uint8_t* pSrcV, int32_t iStrideY, int32_t iStrideUV,
                    int32_t iActualWidth, int32_t iPaddingWidth, int32_t iActualHeight, int32_t iPaddingHeight);
   void    SetRefMbType (sWelsEncCtx* pCtx, uint32_t** pRefMbTypeArray, int32_t iRefPicType);
 
   int32_t ColorspaceConvert (SWelsSvcCodingParam* pSvcParam, SPicture* pDstPic, const SSourcePicture* kpSrc,
-                             const int32_t kiWidth, const int32_t kiHeight);
-  void WelsMoveMemoryWrapper (SWelsSvcCodingParam* pSvcParam, SPicture* pDstPic, const SSourcePicture* kpSrc,
-                              const int32_t kiWidth, const int32_t kiHeight);
+                             const int32_t kiTargetWidth, const int32_t kiTargetHeight);
+  int32_t WelsMoveMemoryWrapper (SWelsSvcCodingParam* pSvcParam, SPicture* pDstPic, const SSourcePicture* kpSrc,
+                                 const int32_t kiWidth, const int32_t kiHeight);
 
   /*!
   * \brief  exchange two picture pData planes
@@ -191,6 +241,7 @@ class CWelsPreProcess {
   SPicture* GetBestRefPic (const int32_t kiDidx, const int32_t iRefTemporalIdx);
  protected:
   IWelsVP*         m_pInterfaceVp;
+  IWelsVP*         m_pLookaheadVp;  // staging side processing, used apart from the encoding one by the lookahead thread
   sWelsEncCtx*     m_pEncCtx;
   uint8_t          m_uiSpatialLayersInTemporal[MAX_DEPENDENCY_LAYER];
 
@@ -199,6 +250,22 @@ class CWelsPreProcess {
   SPicture*        m_pLastSpatialPicture[MAX_DEPENDENCY_LAYER][2];
   bool             m_bInitDone;
   uint8_t          m_uiSpatialPicNum[MAX_DEPENDENCY_LAYER];
+
+  /* Staged queue: the frame pipeline scales the next input on the lookahead thread while the head set is encoded,
+     the lookahead keeps iLookaheadFrames analysed sets queued before the head one is encoded */
+  Scaled_Picture   m_sStagedScaledPicture;
+  SPicture*        m_pStagedPic[MAX_STAGED_SET_NUM][MAX_DEPENDENCY_LAYER];
+  SSourcePicture   m_sStagedSrcPic[MAX_STAGED_SET_NUM];
+  SLookaheadInfo   m_sLookahead[MAX_STAGED_SET_NUM];
+  int32_t          m_iStagedSetNum;   // sets in the ring
+  int32_t          m_iStagedDepth;    // queued sets needed to encode the head one, unless flushing
+  int32_t          m_iStagedHead;     // set holding the picture to encode next
+  int32_t          m_iStagedCount;    // queued sets from m_iStagedHead on
+  int32_t          m_iLastAnalyzedSet; // reference of the next analysis, -1 if none
+  bool             m_bPendingSceneCut; // scene cut seen by the lookahead, not taken by a T0 picture yet
+  SStagedVaaInfo   m_sStagedVaa[MAX_STAGED_SET_NUM];
+  SPicture*        m_pLastStagedPic;   // highest layer of the input staged last, reference of the next staged VAA
+  int32_t          m_iCurStagedSet;    // set the picture being encoded was staged in, -1 if it was not
  protected:
   /* For Downsampling & VAA I420 based source pictures */
   SPicture*        m_pSpatialPic[MAX_DEPENDENCY_LAYER][MAX_REF_PIC_COUNT + 1];
@@ -57,7 +57,9 @@ class CWelsBaseTask : public WelsCommon::IWelsTask {
     WELS_ENC_TASK_ENCODE_SLICE_SIZECONSTRAINED = WELS_ENC_TASK_ENCODING,
     WELS_ENC_TASK_UPDATEMBMAP = 1,
     WELS_ENC_TASK_PREPROCESS = 2,
-    WELS_ENC_TASK_ALL = 3,
+    WELS_ENC_TASK_WAVEFRONT_MD = 3,
+    WELS_ENC_TASK_DEBLOCKING = 4,
+    WELS_ENC_TASK_ALL = 5,
   };
 
   CWelsBaseTask (WelsCommon::IWelsTaskSink* pSink): IWelsTask (pSink) {};
@@ -137,6 +137,65 @@ class CWelsUpdateMbMapTask : public CWelsBaseTask {
   int32_t m_iSliceIdx;
 };
 
+class CWelsWavefrontMdTask : public CWelsBaseTask {
+ public:
+  CWelsWavefrontMdTask (WelsCommon::IWelsTaskSink* pSink, sWelsEncCtx* pCtx, const int32_t iWorkerIdx);
+  virtual ~CWelsWavefrontMdTask();
+
+  virtual WelsErrorType Execute();
+
+  virtual uint32_t        GetTaskType() const {
+    return WELS_ENC_TASK_WAVEFRONT_MD;
+  }
+ protected:
+  sWelsEncCtx* m_pCtx;
+  int32_t m_iWorkerIdx;
+};
+
+class CWelsDeblockingTask : public CWelsBaseTask {
+ public:
+  CWelsDeblockingTask (WelsCommon::IWelsTaskSink* pSink, sWelsEncCtx* pCtx);
+  virtual ~CWelsDeblockingTask();
+
+  virtual WelsErrorType Execute();
+
+  virtual uint32_t        GetTaskType() const {
+    return WELS_ENC_TASK_DEBLOCKING;
+  }
+ protected:
+  sWelsEncCtx* m_pCtx;
+};
+
+//scales the next input picture while the current one is encoded, it is its own sink so that
+//the slice task accounting of the task manager is left alone
+class CWelsPreprocessTask : public CWelsBaseTask, public WelsCommon::IWelsTaskSink {
+ public:
+  CWelsPreprocessTask (sWelsEncCtx* pCtx);
+  virtual ~CWelsPreprocessTask();
+
+  void SetSource (const SSourcePicture* kpSrcPic, const int32_t kiSet);
+  WelsErrorType WaitExecuted();
+
+  virtual WelsErrorType Execute();
+
+  //IWelsTaskSink
+  virtual int OnTaskExecuted();
+  virtual int OnTaskCancelled();
+
+  virtual uint32_t        GetTaskType() const {
+    return WELS_ENC_TASK_PREPROCESS;
+  }
+ protected:
+  sWelsEncCtx* m_pCtx;
+  const SSourcePicture* m_pSrcPic;
+  int32_t m_iSet;
+  WelsErrorType m_eTaskResult;
+
+  int32_t      m_iWaitTaskNum;
+  WELS_EVENT   m_hTaskEvent;
+  WELS_MUTEX   m_hEventMutex;
+};
+
 }       //namespace
 #endif  //header guard
 
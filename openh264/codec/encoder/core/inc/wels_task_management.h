@@ -48,6 +48,8 @@
 
 namespace WelsEnc {
 
+class CWelsPreprocessTask;
+
 class IWelsTaskManage {
  public:
   virtual ~IWelsTaskManage() { }
@@ -58,6 +60,20 @@ class IWelsTaskManage {
   virtual void            InitFrame (const int32_t kiCurDid) {}
   virtual WelsErrorType   ExecuteTasks (const CWelsBaseTask::ETaskType iTaskType = CWelsBaseTask::WELS_ENC_TASK_ENCODING)
     = 0;
+  //queue the tasks and return at once, WaitTasks() blocks until they are all done
+  virtual WelsErrorType   ExecuteTasksAsync (const CWelsBaseTask::ETaskType iTaskType) {
+    return ExecuteTasks (iTaskType);
+  }
+  virtual WelsErrorType   WaitTasks() {
+    return ENC_RETURN_SUCCESS;
+  }
+  //scale the next input picture in the background, WaitPreprocess() blocks until it is staged
+  virtual WelsErrorType   ExecutePreprocessAsync (const SSourcePicture* kpSrcPic, const int32_t kiSet) {
+    return ENC_RETURN_UNSUPPORTED_PARA;
+  }
+  virtual WelsErrorType   WaitPreprocess() {
+    return ENC_RETURN_SUCCESS;
+  }
 
   static IWelsTaskManage* CreateTaskManage (sWelsEncCtx* pCtx, const int32_t iSpatialLayer, const bool bNeedLock);
 
@@ -78,6 +94,10 @@ class  CWelsTaskManageBase : public IWelsTaskManage, public WelsCommon::IWelsTas
   virtual void           InitFrame (const int32_t kiCurDid = 0);
 
   virtual WelsErrorType  ExecuteTasks (const CWelsBaseTask::ETaskType iTaskType = CWelsBaseTask::WELS_ENC_TASK_ENCODING);
+  virtual WelsErrorType  ExecuteTasksAsync (const CWelsBaseTask::ETaskType iTaskType);
+  virtual WelsErrorType  WaitTasks();
+  virtual WelsErrorType  ExecutePreprocessAsync (const SSourcePicture* kpSrcPic, const int32_t kiSet);
+  virtual WelsErrorType  WaitPreprocess();
 
   //IWelsTaskSink
   virtual WelsErrorType OnTaskExecuted();
@@ -89,6 +109,7 @@ class  CWelsTaskManageBase : public IWelsTaskManage, public WelsCommon::IWelsTas
   virtual WelsErrorType  CreateTasks (sWelsEncCtx* pEncCtx, const int32_t kiTaskCount);
 
   WelsErrorType          ExecuteTaskList(TASKLIST_TYPE** pTaskList);
+  WelsErrorType          CreateOwnThreadPool (const SThreadPoolParam& kParam);
 
  protected:
   sWelsEncCtx*    m_pEncCtx;
@@ -97,13 +118,17 @@ class  CWelsTaskManageBase : public IWelsTaskManage, public WelsCommon::IWelsTas
   TASKLIST_TYPE*  m_pcAllTaskList[CWelsBaseTask::WELS_ENC_TASK_ALL][MAX_DEPENDENCY_LAYER];
   TASKLIST_TYPE*  m_cEncodingTaskList[MAX_DEPENDENCY_LAYER];
   TASKLIST_TYPE*  m_cPreEncodingTaskList[MAX_DEPENDENCY_LAYER];
+  TASKLIST_TYPE*  m_cWavefrontMdTaskList[MAX_DEPENDENCY_LAYER];
+  TASKLIST_TYPE*  m_cDeblockingTaskList[MAX_DEPENDENCY_LAYER];
   int32_t         m_iTaskNum[MAX_DEPENDENCY_LAYER];
+  CWelsPreprocessTask* m_pPreprocessTask;
 
   //SLICE_PAIR_LIST *m_cSliceList;
 
   int32_t         m_iThreadNum;
 
   int32_t          m_iWaitTaskNum;
+  bool             m_bAsyncTasksQueued;
   WELS_EVENT       m_hTaskEvent;
   WELS_MUTEX       m_hEventMutex;
   WelsCommon::CWelsLock  m_cWaitTaskNumLock;
@@ -0,0 +1,261 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file    colorspace_convert.cpp
+ *
+ * \brief   packed RGB / NV12 to I420 conversion for encoder input
+ *
+ * \date    10/16/2026 Created
+ *
+ *************************************************************************************
+ */
+
+#include <string.h>
+#include "colorspace_convert.h"
+#include "cpu_core.h"
+#include "macros.h"
+
+namespace WelsEnc {
+
+// BT.601 limited range, 8 bit fixed point
+static inline uint8_t RgbToY (int32_t iR, int32_t iG, int32_t iB) {
+  return (uint8_t) (((66 * iR + 129 * iG + 25 * iB + 128) >> 8) + 16);
+}
+static inline uint8_t RgbToU (int32_t iR, int32_t iG, int32_t iB) {
+  return (uint8_t) ((-38 * iR - 74 * iG + 112 * iB + 32896) >> 8);
+}
+static inline uint8_t RgbToV (int32_t iR, int32_t iG, int32_t iB) {
+  return (uint8_t) ((112 * iR - 94 * iG - 18 * iB + 32896) >> 8);
+}
+
+template<int32_t kiR, int32_t kiG, int32_t kiB, int32_t kiBpp>
+static void PackedRgbToI420_c (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY,
+                               int32_t iDstStrideUV, const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight) {
+  for (int32_t j = 0; j < iHeight; j += 2) {
+    const uint8_t* kpSrc0 = kpSrc;
+    const uint8_t* kpSrc1 = kpSrc + iSrcStride;
+    uint8_t* pY0 = pDstY;
+    uint8_t* pY1 = pDstY + iDstStrideY;
+    for (int32_t i = 0; i < iWidth; i += 2) {
+      const int32_t kiR00 = kpSrc0[kiR], kiG00 = kpSrc0[kiG], kiB00 = kpSrc0[kiB];
+      const int32_t kiR01 = kpSrc0[kiBpp + kiR], kiG01 = kpSrc0[kiBpp + kiG], kiB01 = kpSrc0[kiBpp + kiB];
+      const int32_t kiR10 = kpSrc1[kiR], kiG10 = kpSrc1[kiG], kiB10 = kpSrc1[kiB];
+      const int32_t kiR11 = kpSrc1[kiBpp + kiR], kiG11 = kpSrc1[kiBpp + kiG], kiB11 = kpSrc1[kiBpp + kiB];
+
+      pY0[i]     = RgbToY (kiR00, kiG00, kiB00);
+      pY0[i + 1] = RgbToY (kiR01, kiG01, kiB01);
+      pY1[i]     = RgbToY (kiR10, kiG10, kiB10);
+      pY1[i + 1] = RgbToY (kiR11, kiG11, kiB11);
+
+      const int32_t kiAvgR = (kiR00 + kiR01 + kiR10 + kiR11 + 2) >> 2;
+      const int32_t kiAvgG = (kiG00 + kiG01 + kiG10 + kiG11 + 2) >> 2;
+      const int32_t kiAvgB = (kiB00 + kiB01 + kiB10 + kiB11 + 2) >> 2;
+      pDstU[i >> 1] = RgbToU (kiAvgR, kiAvgG, kiAvgB);
+      pDstV[i >> 1] = RgbToV (kiAvgR, kiAvgG, kiAvgB);
+
+      kpSrc0 += kiBpp << 1;
+      kpSrc1 += kiBpp << 1;
+    }
+    kpSrc += iSrcStride << 1;
+    pDstY += iDstStrideY << 1;
+    pDstU += iDstStrideUV;
+    pDstV += iDstStrideUV;
+  }
+}
+
+void WelsBgrToI420_c (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                      const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight) {
+  PackedRgbToI420_c<2, 1, 0, 3> (pDstY, pDstU, pDstV, iDstStrideY, iDstStrideUV, kpSrc, iSrcStride, iWidth, iHeight);
+}
+
+void WelsBgraToI420_c (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                       const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight) {
+  PackedRgbToI420_c<2, 1, 0, 4> (pDstY, pDstU, pDstV, iDstStrideY, iDstStrideUV, kpSrc, iSrcStride, iWidth, iHeight);
+}
+
+void WelsRgbaToI420_c (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                       const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight) {
+  PackedRgbToI420_c<0, 1, 2, 4> (pDstY, pDstU, pDstV, iDstStrideY, iDstStrideUV, kpSrc, iSrcStride, iWidth, iHeight);
+}
+
+void WelsNv12ToI420_c (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                       const uint8_t* kpSrcY, const uint8_t* kpSrcUV, int32_t iSrcStrideY, int32_t iSrcStrideUV,
+                       int32_t iWidth, int32_t iHeight) {
+  const int32_t kiWidthUV = iWidth >> 1;
+  for (int32_t j = 0; j < iHeight; j += 2) {
+    memcpy (pDstY, kpSrcY, iWidth); // confirmed_safe_unsafe_usage
+    memcpy (pDstY + iDstStrideY, kpSrcY + iSrcStrideY, iWidth); // confirmed_safe_unsafe_usage
+    for (int32_t i = 0; i < kiWidthUV; i++) {
+      pDstU[i] = kpSrcUV[i << 1];
+      pDstV[i] = kpSrcUV[(i << 1) + 1];
+    }
+    pDstY  += iDstStrideY << 1;
+    kpSrcY += iSrcStrideY << 1;
+    pDstU  += iDstStrideUV;
+    pDstV  += iDstStrideUV;
+    kpSrcUV += iSrcStrideUV;
+  }
+}
+
+#if defined(X86_ASM)
+typedef void (*PPackedRgbToI420TwoRowsFunc) (uint8_t* pDstY, int32_t iDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+    const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth);
+typedef void (*PDeinterleaveUVRowFunc) (uint8_t* pDstU, uint8_t* pDstV, const uint8_t* kpSrcUV, int32_t iWidthUV);
+
+// pfTwoRows takes a multiple of kiAlign pixels; with 3 bytes per pixel it reads a few bytes past the last one,
+// so at least one 2x2 block is always left to the C code
+template<int32_t kiR, int32_t kiG, int32_t kiB, int32_t kiBpp, int32_t kiAlign>
+static void PackedRgbToI420Simd (PPackedRgbToI420TwoRowsFunc pfTwoRows, uint8_t* pDstY, uint8_t* pDstU,
+                                 uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV, const uint8_t* kpSrc,
+                                 int32_t iSrcStride, int32_t iWidth, int32_t iHeight) {
+  const int32_t kiSimdWidth = ((kiBpp == 3) ? (iWidth - 2) : iWidth) & (~ (kiAlign - 1));
+  if (kiSimdWidth > 0) {
+    for (int32_t j = 0; j < iHeight; j += 2) {
+      pfTwoRows (pDstY + j * iDstStrideY, iDstStrideY, pDstU + (j >> 1) * iDstStrideUV, pDstV + (j >> 1) * iDstStrideUV,
+                 kpSrc + j * iSrcStride, iSrcStride, kiSimdWidth);
+    }
+  }
+  if (kiSimdWidth < iWidth) {
+    const int32_t kiDone = WELS_MAX (kiSimdWidth, 0);
+    PackedRgbToI420_c<kiR, kiG, kiB, kiBpp> (pDstY + kiDone, pDstU + (kiDone >> 1), pDstV + (kiDone >> 1), iDstStrideY,
+        iDstStrideUV, kpSrc + kiDone * kiBpp, iSrcStride, iWidth - kiDone, iHeight);
+  }
+}
+
+template<int32_t kiAlign>
+static void Nv12ToI420Simd (PDeinterleaveUVRowFunc pfDeinterleave, uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV,
+                            int32_t iDstStrideY, int32_t iDstStrideUV, const uint8_t* kpSrcY, const uint8_t* kpSrcUV,
+                            int32_t iSrcStrideY, int32_t iSrcStrideUV, int32_t iWidth, int32_t iHeight) {
+  const int32_t kiWidthUV = iWidth >> 1;
+  const int32_t kiSimdWidthUV = kiWidthUV & (~ (kiAlign - 1));
+  for (int32_t j = 0; j < iHeight; j += 2) {
+    memcpy (pDstY, kpSrcY, iWidth); // confirmed_safe_unsafe_usage
+    memcpy (pDstY + iDstStrideY, kpSrcY + iSrcStrideY, iWidth); // confirmed_safe_unsafe_usage
+    if (kiSimdWidthUV > 0)
+      pfDeinterleave (pDstU, pDstV, kpSrcUV, kiSimdWidthUV);
+    for (int32_t i = kiSimdWidthUV; i < kiWidthUV; i++) {
+      pDstU[i] = kpSrcUV[i << 1];
+      pDstV[i] = kpSrcUV[(i << 1) + 1];
+    }
+    pDstY  += iDstStrideY << 1;
+    kpSrcY += iSrcStrideY << 1;
+    pDstU  += iDstStrideUV;
+    pDstV  += iDstStrideUV;
+    kpSrcUV += iSrcStrideUV;
+  }
+}
+
+void WelsNv12ToI420_sse2 (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                          const uint8_t* kpSrcY, const uint8_t* kpSrcUV, int32_t iSrcStrideY, int32_t iSrcStrideUV,
+                          int32_t iWidth, int32_t iHeight) {
+  Nv12ToI420Simd<16> (WelsDeinterleaveUVRow_sse2, pDstY, pDstU, pDstV, iDstStrideY, iDstStrideUV, kpSrcY, kpSrcUV,
+                      iSrcStrideY, iSrcStrideUV, iWidth, iHeight);
+}
+
+#if !defined(X86_32_ASM)
+void WelsBgrToI420_sse2 (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                         const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight) {
+  PackedRgbToI420Simd<2, 1, 0, 3, 8> (WelsBgrToI420TwoRows_sse2, pDstY, pDstU, pDstV, iDstStrideY, iDstStrideUV,
+                                      kpSrc, iSrcStride, iWidth, iHeight);
+}
+
+void WelsBgraToI420_sse2 (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                          const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight) {
+  PackedRgbToI420Simd<2, 1, 0, 4, 8> (WelsBgraToI420TwoRows_sse2, pDstY, pDstU, pDstV, iDstStrideY, iDstStrideUV,
+                                      kpSrc, iSrcStride, iWidth, iHeight);
+}
+
+void WelsRgbaToI420_sse2 (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                          const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight) {
+  PackedRgbToI420Simd<0, 1, 2, 4, 8> (WelsRgbaToI420TwoRows_sse2, pDstY, pDstU, pDstV, iDstStrideY, iDstStrideUV,
+                                      kpSrc, iSrcStride, iWidth, iHeight);
+}
+#endif//!X86_32_ASM
+
+#if defined(HAVE_AVX2)
+void WelsNv12ToI420_avx2 (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                          const uint8_t* kpSrcY, const uint8_t* kpSrcUV, int32_t iSrcStrideY, int32_t iSrcStrideUV,
+                          int32_t iWidth, int32_t iHeight) {
+  Nv12ToI420Simd<32> (WelsDeinterleaveUVRow_avx2, pDstY, pDstU, pDstV, iDstStrideY, iDstStrideUV, kpSrcY, kpSrcUV,
+                      iSrcStrideY, iSrcStrideUV, iWidth, iHeight);
+}
+
+#if !defined(X86_32_ASM)
+void WelsBgrToI420_avx2 (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                         const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight) {
+  PackedRgbToI420Simd<2, 1, 0, 3, 16> (WelsBgrToI420TwoRows_avx2, pDstY, pDstU, pDstV, iDstStrideY, iDstStrideUV,
+                                       kpSrc, iSrcStride, iWidth, iHeight);
+}
+
+void WelsBgraToI420_avx2 (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                          const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight) {
+  PackedRgbToI420Simd<2, 1, 0, 4, 16> (WelsBgraToI420TwoRows_avx2, pDstY, pDstU, pDstV, iDstStrideY, iDstStrideUV,
+                                       kpSrc, iSrcStride, iWidth, iHeight);
+}
+
+void WelsRgbaToI420_avx2 (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iDstStrideY, int32_t iDstStrideUV,
+                          const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth, int32_t iHeight) {
+  PackedRgbToI420Simd<0, 1, 2, 4, 16> (WelsRgbaToI420TwoRows_avx2, pDstY, pDstU, pDstV, iDstStrideY, iDstStrideUV,
+                                       kpSrc, iSrcStride, iWidth, iHeight);
+}
+#endif//!X86_32_ASM
+#endif//HAVE_AVX2
+#endif//X86_ASM
+
+void WelsInitColorspaceConvertFunc (SColorspaceConvertFunc* pFuncList, uint32_t uiCpuFlag) {
+  pFuncList->pfBgrToI420   = WelsBgrToI420_c;
+  pFuncList->pfBgraToI420  = WelsBgraToI420_c;
+  pFuncList->pfRgbaToI420  = WelsRgbaToI420_c;
+  pFuncList->pfNv12ToI420  = WelsNv12ToI420_c;
+
+#if defined(X86_ASM)
+  if (uiCpuFlag & WELS_CPU_SSE2) {
+    pFuncList->pfNv12ToI420  = WelsNv12ToI420_sse2;
+#if !defined(X86_32_ASM)
+    pFuncList->pfBgrToI420   = WelsBgrToI420_sse2;
+    pFuncList->pfBgraToI420  = WelsBgraToI420_sse2;
+    pFuncList->pfRgbaToI420  = WelsRgbaToI420_sse2;
+#endif//!X86_32_ASM
+  }
+#if defined(HAVE_AVX2)
+  if (uiCpuFlag & WELS_CPU_AVX2) {
+    pFuncList->pfNv12ToI420  = WelsNv12ToI420_avx2;
+#if !defined(X86_32_ASM)
+    pFuncList->pfBgrToI420   = WelsBgrToI420_avx2;
+    pFuncList->pfBgraToI420  = WelsBgraToI420_avx2;
+    pFuncList->pfRgbaToI420  = WelsRgbaToI420_avx2;
+#endif//!X86_32_ASM
+  }
+#endif//HAVE_AVX2
+#endif//X86_ASM
+}
+
+}
@@ -40,6 +40,9 @@
 
 #include "deblocking.h"
 #include "cpu_core.h"
+#include "expand_pic.h"
+#include "wels_task_management.h"
+#include "slice_multi_threading.h"
 
 namespace WelsEnc {
 
@@ -653,6 +656,21 @@ void DeblockingMbAvcbase (SWelsFuncPtrList* pFunc, SMB* pCurMb, SDeblockingFilte
   }
 }
 
+static void DeblockingFrameFilterInit (SDqLayer* pCurDq, SDeblockingFilter* pFilter) {
+  SSliceHeaderExt* sSliceHeaderExt = &pCurDq->ppSliceInLayer[0]->sSliceHeaderExt;
+
+  pFilter->uiFilterIdc = (sSliceHeaderExt->sSliceHeader.uiDisableDeblockingFilterIdc != 0);
+
+  pFilter->iCsStride[0] = pCurDq->pDecPic->iLineSize[0];
+  pFilter->iCsStride[1] = pCurDq->pDecPic->iLineSize[1];
+  pFilter->iCsStride[2] = pCurDq->pDecPic->iLineSize[2];
+
+  pFilter->iSliceAlphaC0Offset = sSliceHeaderExt->sSliceHeader.iSliceAlphaC0Offset;
+  pFilter->iSliceBetaOffset     = sSliceHeaderExt->sSliceHeader.iSliceBetaOffset;
+
+  pFilter->iMbStride = pCurDq->iMbWidth;
+}
+
 void  DeblockingFilterFrameAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc) {
   int32_t i, j;
   const int32_t kiMbWidth   = pCurDq->iMbWidth;
@@ -665,16 +683,7 @@ void  DeblockingFilterFrameAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc) {
   if (sSliceHeaderExt->sSliceHeader.uiDisableDeblockingFilterIdc == 1)
     return;
 
-  pFilter.uiFilterIdc = (sSliceHeaderExt->sSliceHeader.uiDisableDeblockingFilterIdc != 0);
-
-  pFilter.iCsStride[0] = pCurDq->pDecPic->iLineSize[0];
-  pFilter.iCsStride[1] = pCurDq->pDecPic->iLineSize[1];
-  pFilter.iCsStride[2] = pCurDq->pDecPic->iLineSize[2];
-
-  pFilter.iSliceAlphaC0Offset = sSliceHeaderExt->sSliceHeader.iSliceAlphaC0Offset;
-  pFilter.iSliceBetaOffset     = sSliceHeaderExt->sSliceHeader.iSliceBetaOffset;
-
-  pFilter.iMbStride = kiMbWidth;
+  DeblockingFrameFilterInit (pCurDq, &pFilter);
 
   for (j = 0; j < kiMbHeight; ++j) {
     pFilter.pCsData[0] = pCurDq->pDecPic->pData[0] + ((j * pFilter.iCsStride[0]) << 4);
@@ -741,10 +750,107 @@ void DeblockingFilterSliceAvcbase (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc, SS
 void DeblockingFilterSliceAvcbaseNull (SDqLayer* pCurDq, SWelsFuncPtrList* pFunc, SSlice* pSlice) {
 }
 
+static inline void DeblockingExpandMbRow (SWelsFuncPtrList* pFunc, SPicture* pDecPic, const int32_t kiMbY) {
+  const int32_t kiStartRow = kiMbY << 4;
+  const int32_t kiEndRow   = WELS_MIN (kiStartRow + MB_HEIGHT_LUMA, pDecPic->iHeightInPixel);
+  ExpandReferencingPictureRows (pDecPic->pData, pDecPic->iWidthInPixel, pDecPic->iHeightInPixel, pDecPic->iLineSize,
+                                kiStartRow, kiEndRow, pFunc->sExpandPicFunc.pfExpandLumaRows,
+                                pFunc->sExpandPicFunc.pfExpandChromaRows);
+}
+
+void DeblockingFilterRowsWavefront (sWelsEncCtx* pEnc) {
+  SWavefrontDeblocking* pWavefront = pEnc->pSliceThreading->pWavefrontDeblocking;
+  SDqLayer* pCurDq          = pEnc->pCurDqLayer;
+  SWelsFuncPtrList* pFunc   = pEnc->pFuncList;
+  const int32_t kiMbWidth   = pCurDq->iMbWidth;
+  const int32_t kiMbHeight  = pCurDq->iMbHeight;
+  SMB* pCurrentMbBlock      = NULL;
+  int32_t iMbX              = 0;
+  int32_t iMbY              = 0;
+  SDeblockingFilter sFilter;
+
+  DeblockingFrameFilterInit (pCurDq, &sFilter);
+
+  for (;;) {
+    iMbY = RowProgressClaimRow (&pWavefront->sProgress);
+    if (iMbY >= kiMbHeight)
+      break;
+
+    //the picture is final already, rows can be padded in any order
+    if (!pWavefront->bFilter) {
+      DeblockingExpandMbRow (pFunc, pCurDq->pDecPic, iMbY);
+      continue;
+    }
+
+    pCurrentMbBlock    = &pCurDq->sMbDataP[iMbY * kiMbWidth];
+    sFilter.pCsData[0] = pCurDq->pDecPic->pData[0] + ((iMbY * sFilter.iCsStride[0]) << 4);
+    sFilter.pCsData[1] = pCurDq->pDecPic->pData[1] + ((iMbY * sFilter.iCsStride[1]) << 3);
+    sFilter.pCsData[2] = pCurDq->pDecPic->pData[2] + ((iMbY * sFilter.iCsStride[2]) << 3);
+    for (iMbX = 0; iMbX < kiMbWidth; iMbX++) {
+      //the top edge overlaps with the left edge of the top-right neighbor
+      if (iMbY > 0)
+        RowProgressWait (&pWavefront->sProgress, iMbY - 1, WELS_MIN (iMbX + 2, kiMbWidth));
+
+      DeblockingMbAvcbase (pFunc, pCurrentMbBlock, &sFilter);
+      ++pCurrentMbBlock;
+      sFilter.pCsData[0] += MB_WIDTH_LUMA;
+      sFilter.pCsData[1] += MB_WIDTH_CHROMA;
+      sFilter.pCsData[2] += MB_WIDTH_CHROMA;
+
+      RowProgressUpdate (&pWavefront->sProgress, iMbY, iMbX + 1);
+    }
+
+    //the row above is final once the current row is filtered, the last row once it is filtered itself
+    if (pWavefront->bExpandBorder) {
+      if (iMbY > 0)
+        DeblockingExpandMbRow (pFunc, pCurDq->pDecPic, iMbY - 1);
+      if (iMbY == kiMbHeight - 1)
+        DeblockingExpandMbRow (pFunc, pCurDq->pDecPic, iMbY);
+    }
+  }
+}
+
+static inline bool DeblockingWavefrontUsed (sWelsEncCtx* pEnc) {
+  return (NULL != pEnc->pTaskManage) && (NULL != pEnc->pSliceThreading)
+         && (NULL != pEnc->pSliceThreading->pWavefrontDeblocking) && (pEnc->pCurDqLayer->iMbHeight > 1);
+}
+
+// the borders are padded by the workers only if the picture goes to the reference list afterwards, and only for
+// widths the optimized full expansion is known to handle like the C one
+static inline bool DeblockingExpandBorderUsed (sWelsEncCtx* pEnc) {
+  const SSpatialLayerInternal* kpParamInternal = &pEnc->pSvcParam->sDependencyLayers[pEnc->uiDependencyId];
+  return (NRI_PRI_LOWEST != pEnc->eNalPriority)
+         && (kpParamInternal->iHighestTemporalId == 0 || pEnc->uiTemporalId < kpParamInternal->iHighestTemporalId)
+         && (0 == (pEnc->pDecPic->iWidthInPixel & 0x1F));
+}
+
+static void DeblockingWavefrontRun (sWelsEncCtx* pEnc, const bool kbFilter, const bool kbExpandBorder) {
+  SWavefrontDeblocking* pWavefront = pEnc->pSliceThreading->pWavefrontDeblocking;
+  RowProgressReset (&pWavefront->sProgress, pEnc->pCurDqLayer->iMbHeight);
+  pWavefront->bFilter       = kbFilter;
+  pWavefront->bExpandBorder = kbExpandBorder;
+
+  pEnc->pTaskManage->ExecuteTasksAsync (CWelsBaseTask::WELS_ENC_TASK_DEBLOCKING);
+  DeblockingFilterRowsWavefront (pEnc);
+  pEnc->pTaskManage->WaitTasks();
+  pEnc->pDecPic->bBorderExpanded = kbExpandBorder;
+}
+
+void PerformReferenceExpansion (sWelsEncCtx* pEnc) {
+  if (DeblockingWavefrontUsed (pEnc) && DeblockingExpandBorderUsed (pEnc)) {
+    DeblockingWavefrontRun (pEnc, false, true);
+  }
+}
+
 void PerformDeblockingFilter (sWelsEncCtx* pEnc) {
   SDqLayer* pCurLayer = pEnc->pCurDqLayer;
   SSlice* pSlice      = NULL;
 
+  if (pCurLayer->iLoopFilterDisableIdc == 0 && DeblockingWavefrontUsed (pEnc)) {
+    DeblockingWavefrontRun (pEnc, true, DeblockingExpandBorderUsed (pEnc));
+    return;
+  }
+
   if (pCurLayer->iLoopFilterDisableIdc == 0) {
     DeblockingFilterFrameAvcbase (pCurLayer, pEnc->pFuncList);
   } else if (pCurLayer->iLoopFilterDisableIdc == 2) {
@@ -759,6 +865,7 @@ void PerformDeblockingFilter (sWelsEncCtx* pEnc) {
       ++ iSliceIdx;
     } while (iSliceIdx < iSliceCount);
   }
+  PerformReferenceExpansion (pEnc);
 }
 
 void WelsBlockFuncInit (PSetNoneZeroCountZeroFunc* pfSetNZCZero,  int32_t iCpu) {
@@ -192,6 +192,9 @@ int32_t InitFunctionPointers (sWelsEncCtx* pEncCtx, SWelsSvcCodingParam* pParam,
 
   InitExpandPictureFunc (& (pFuncList->sExpandPicFunc), uiCpuFlag);
 
+  /* Input colorspace conversion */
+  WelsInitColorspaceConvertFunc (& (pFuncList->sColorspaceConvertFunc), uiCpuFlag);
+
   /* Intra_Prediction_fn*/
   WelsInitIntraPredFuncs (pFuncList, uiCpuFlag);
 
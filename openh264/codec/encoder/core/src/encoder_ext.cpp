@@ -463,6 +463,62 @@ int32_t ParamValidationExt (SLogContext* pLogCtx, SWelsSvcCodingParam* pCodingPa
     pCodingParam->bDeblockingParallelFlag = true;
   }
 
+  if (pCodingParam->bUseWavefrontMd && pCodingParam->iUsageType == SCREEN_CONTENT_REAL_TIME) {
+    WelsLog (pLogCtx, WELS_LOG_WARNING,
+             "ParamValidationExt(), bUseWavefrontMd not supported with iUsageType (%d)! bUseWavefrontMd adjusted to false",
+             pCodingParam->iUsageType);
+    pCodingParam->bUseWavefrontMd = false;
+  }
+  if (pCodingParam->bEnableFramePipeline && pCodingParam->iUsageType == SCREEN_CONTENT_REAL_TIME) {
+    WelsLog (pLogCtx, WELS_LOG_WARNING,
+             "ParamValidationExt(), bEnableFramePipeline not supported with iUsageType (%d)! bEnableFramePipeline adjusted to false",
+             pCodingParam->iUsageType);
+    pCodingParam->bEnableFramePipeline = false;
+  }
+  if (pCodingParam->bEnablePyramidMe && pCodingParam->iUsageType == SCREEN_CONTENT_REAL_TIME) {
+    WelsLog (pLogCtx, WELS_LOG_WARNING,
+             "ParamValidationExt(), bEnablePyramidMe not supported with iUsageType (%d)! bEnablePyramidMe adjusted to false",
+             pCodingParam->iUsageType);
+    pCodingParam->bEnablePyramidMe = false;
+  }
+  if (pCodingParam->iLookaheadFrames < 0 || pCodingParam->iLookaheadFrames > MAX_LOOKAHEAD_FRAMES) {
+    WelsLog (pLogCtx, WELS_LOG_WARNING,
+             "ParamValidationExt(), iLookaheadFrames (%d) out of range [0, %d]! iLookaheadFrames adjusted to %d",
+             pCodingParam->iLookaheadFrames, MAX_LOOKAHEAD_FRAMES,
+             WELS_CLIP3 (pCodingParam->iLookaheadFrames, 0, MAX_LOOKAHEAD_FRAMES));
+    pCodingParam->iLookaheadFrames = WELS_CLIP3 (pCodingParam->iLookaheadFrames, 0, MAX_LOOKAHEAD_FRAMES);
+  }
+  if (pCodingParam->iLookaheadFrames > 0 && pCodingParam->iUsageType == SCREEN_CONTENT_REAL_TIME) {
+    WelsLog (pLogCtx, WELS_LOG_WARNING,
+             "ParamValidationExt(), iLookaheadFrames not supported with iUsageType (%d)! iLookaheadFrames adjusted to 0",
+             pCodingParam->iUsageType);
+    pCodingParam->iLookaheadFrames = 0;
+  }
+  if (pCodingParam->eRcPass < RC_SINGLE_PASS || pCodingParam->eRcPass > RC_SECOND_PASS) {
+    WelsLog (pLogCtx, WELS_LOG_WARNING, "ParamValidationExt(), eRcPass (%d) invalid! eRcPass adjusted to RC_SINGLE_PASS",
+             pCodingParam->eRcPass);
+    pCodingParam->eRcPass = RC_SINGLE_PASS;
+  }
+  if (pCodingParam->eRcPass != RC_SINGLE_PASS && pCodingParam->iUsageType == SCREEN_CONTENT_REAL_TIME) {
+    WelsLog (pLogCtx, WELS_LOG_WARNING,
+             "ParamValidationExt(), eRcPass not supported with iUsageType (%d)! eRcPass adjusted to RC_SINGLE_PASS",
+             pCodingParam->iUsageType);
+    pCodingParam->eRcPass = RC_SINGLE_PASS;
+  }
+  if (pCodingParam->eRcPass != RC_SINGLE_PASS && (pCodingParam->iRCMode == RC_OFF_MODE
+      || pCodingParam->iRCMode == RC_BUFFERBASED_MODE)) {
+    WelsLog (pLogCtx, WELS_LOG_WARNING,
+             "ParamValidationExt(), eRcPass not supported with iRCMode (%d)! eRcPass adjusted to RC_SINGLE_PASS",
+             pCodingParam->iRCMode);
+    pCodingParam->eRcPass = RC_SINGLE_PASS;
+  }
+  if (pCodingParam->eRcPass != RC_SINGLE_PASS && pCodingParam->sRcStatsFileName[0] == '\0') {
+    WelsLog (pLogCtx, WELS_LOG_WARNING,
+             "ParamValidationExt(), eRcPass (%d) without pRcStatsFileName! eRcPass adjusted to RC_SINGLE_PASS",
+             pCodingParam->eRcPass);
+    pCodingParam->eRcPass = RC_SINGLE_PASS;
+  }
+
   // eSpsPpsIdStrategy checkings
   if (pCodingParam->iSpatialLayerNum > 1 && (!pCodingParam->bSimulcastAVC)
       && (SPS_LISTING & pCodingParam->eSpsPpsIdStrategy)) {
@@ -976,6 +1032,12 @@ void FreeDqLayer (SDqLayer*& pDq, CMemoryAlign* pMa) {
     pDq->pFeatureSearchPreparation = NULL;
   }
 
+  if (pDq->pPyramidMe) {
+    ReleasePyramidMeStorage (pMa, pDq->pPyramidMe);
+    pMa->WelsFree (pDq->pPyramidMe, "pPyramidMe");
+    pDq->pPyramidMe = NULL;
+  }
+
   UninitSlicePEncCtx (pDq, pMa);
   pDq->iMaxSliceNum = 0;
 
@@ -1054,6 +1116,10 @@ static inline int32_t InitDqLayers (sWelsEncCtx** ppCtx, SExistingParasetList* p
       pRefList->pRef[i] = AllocPicture (pMa, kiWidth, kiHeight, true,
                                         (iDlayerIndex == iDlayerCount - 1) ? kiNeedFeatureStorage : 0); // to use actual size of current layer
       WELS_VERIFY_RETURN_PROC_IF (1, (NULL == pRefList->pRef[i]), FreeRefList (pRefList, pMa, iNumRef))
+      if (pParam->bEnablePyramidMe) {
+        WELS_VERIFY_RETURN_PROC_IF (1, (ENC_RETURN_SUCCESS != AllocPicturePyramid (pMa, pRefList->pRef[i])),
+                                    FreeRefList (pRefList, pMa, iNumRef))
+      }
       ++ i;
     } while (i < 1 + iNumRef);
 
@@ -1134,6 +1200,16 @@ static inline int32_t InitDqLayers (sWelsEncCtx** ppCtx, SExistingParasetList* p
       pDqLayer->pFeatureSearchPreparation = NULL;
     }
 
+    if (pParam->bEnablePyramidMe) {
+      pDqLayer->pPyramidMe = static_cast<SPyramidMeStorage*> (pMa->WelsMallocz (sizeof (SPyramidMeStorage),
+                             "pPyramidMe"));
+      WELS_VERIFY_RETURN_IF (1, NULL == pDqLayer->pPyramidMe)
+      int32_t iReturn = RequestPyramidMeStorage (pMa, pDqLayer->iMbWidth, pDqLayer->iMbHeight, pDqLayer->pPyramidMe);
+      WELS_VERIFY_RETURN_IF (1, ENC_RETURN_SUCCESS != iReturn)
+    } else {
+      pDqLayer->pPyramidMe = NULL;
+    }
+
     (*ppCtx)->ppDqLayerList[iDlayerIndex] = pDqLayer;
 
     ++ iDlayerIndex;
@@ -1998,8 +2074,8 @@ void FreeMemorySvc (sWelsEncCtx** ppCtx) {
 #endif//MEMORY_MONITOR
 
     if ((*ppCtx)->pMemAlign != NULL) {
-      WelsLog (& (*ppCtx)->sLogCtx, WELS_LOG_INFO, "FreeMemorySvc(), verify memory usage (%d bytes) after free..",
-               (*ppCtx)->pMemAlign->WelsGetMemoryUsage());
+      WelsLog (& (*ppCtx)->sLogCtx, WELS_LOG_INFO, "FreeMemorySvc(), verify memory usage (%lld bytes) after free..",
+               static_cast<long long> ((*ppCtx)->pMemAlign->WelsGetMemoryUsage()));
       WELS_DELETE_OP ((*ppCtx)->pMemAlign);
     }
 
@@ -2012,6 +2088,7 @@ int32_t InitSliceSettings (SLogContext* pLogCtx,     SWelsSvcCodingParam* pCodin
                            const int32_t kiCpuCores, int16_t* pMaxSliceCount) {
   int32_t iSpatialIdx = 0, iSpatialNum = pCodingParam->iSpatialLayerNum;
   uint16_t iMaxSliceCount = 0;
+  bool bAllSingleSlice = true;
 
   do {
     SSpatialLayerConfig* pDlp           = &pCodingParam->sSpatialLayers[iSpatialIdx];
@@ -2044,11 +2121,19 @@ int32_t InitSliceSettings (SLogContext* pLogCtx,     SWelsSvcCodingParam* pCodin
     default:
       break;
     }
+    if (SM_SINGLE_SLICE != pSliceArgument->uiSliceMode)
+      bAllSingleSlice = false;
 
     ++ iSpatialIdx;
   } while (iSpatialIdx < iSpatialNum);
 
-  pCodingParam->iMultipleThreadIdc = WELS_MIN (kiCpuCores, iMaxSliceCount);
+  // MB-row wavefront ME/MD threads are not bounded by the slice count
+  if (pCodingParam->bUseWavefrontMd && bAllSingleSlice)
+    pCodingParam->iMultipleThreadIdc = kiCpuCores;
+  else if (pCodingParam->bEnableFramePipeline) // one more for the lookahead preprocessing
+    pCodingParam->iMultipleThreadIdc = WELS_MIN (kiCpuCores, iMaxSliceCount + 1);
+  else
+    pCodingParam->iMultipleThreadIdc = WELS_MIN (kiCpuCores, iMaxSliceCount);
   if (pCodingParam->iLoopFilterDisableIdc == 0
       && pCodingParam->iMultipleThreadIdc != 1) // Loop filter requested to be enabled, with threading enabled
     pCodingParam->iLoopFilterDisableIdc =
@@ -2373,6 +2458,7 @@ int32_t WelsInitEncoderExt (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pCodingPar
 
   pCtx->iStatisticsLogInterval = STATISTICS_LOG_INTERVAL_MS;
   pCtx->uiLastTimestamp = -1;
+  pCtx->iInputFrameIdx = -1;
   pCtx->bDeliveryFlag = true;
   *ppCtx = pCtx;
 
@@ -2693,6 +2779,9 @@ void PreprocessSliceCoding (sWelsEncCtx* pCtx) {
       pFuncList->pfCalculateSatd = CalculateSatdCost;
       pFuncList->pfInterFineMd = WelsMdInterFinePartition;
     }
+    // the first pass only has to measure the bits, sub 16x16 partitions are not worth their search time there
+    if (NULL != pCtx->pRcStats && RC_FIRST_PASS == pCtx->pRcStats->eRcPass)
+      pFuncList->pfInterFineMd = WelsMdInterFinePartitionNull;
   } else {
     pFuncList->sSampleDealingFuncs.pfMeCost = NULL;
   }
@@ -2764,6 +2853,20 @@ void PreprocessSliceCoding (sWelsEncCtx* pCtx) {
     }
   }
 
+  //coarse to fine seeds of the ME, the pyramid of the source is kept with the reconstruction so that the frames
+  //referencing it later search on it as it is
+  SPyramidMeStorage* pPyramidMe = pCurLayer->pPyramidMe;
+  if (pPyramidMe) {
+    pCtx->pVpp->DownsamplePyramid (pCtx->pEncPic, pCurLayer->iMbWidth << 4, pCurLayer->iMbHeight << 4,
+                                   pCurLayer->pDecPic->pPyramidPlane, PYRAMID_ME_LEVEL_NUM);
+    if (P_SLICE == pCtx->eSliceType && NULL != pCurLayer->pRefPic) {
+      PerformPyramidMotionSearch (pFuncList, pPyramidMe, pCurLayer->pDecPic->pPyramidPlane,
+                                  pCurLayer->pRefPic->pPyramidPlane, pCurLayer->iMbWidth, pCurLayer->iMbHeight, pCtx->iMvRange);
+    } else {
+      pPyramidMe->bMbMvAvailable = false;
+    }
+  }
+
   // update some layer dependent variable to save judgements in mb-level
   pCurLayer->bSatdInMdFlag = ((pFuncList->sSampleDealingFuncs.pfMeCost == pFuncList->sSampleDealingFuncs.pfSampleSatd)
                               && (pFuncList->sSampleDealingFuncs.pfMdCost == pFuncList->sSampleDealingFuncs.pfSampleSatd));
@@ -3492,6 +3595,11 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi, const SSour
     WelsLog (& (pCtx->sLogCtx), WELS_LOG_ERROR, "Failed in allocating memory in BuildSpatialPicList");
     return ENC_RETURN_MEMALLOCERR;
   }
+  if (iSpatialNum == -2) {
+    WelsLog (& (pCtx->sLogCtx), WELS_LOG_ERROR, "Failed in reading the input picture in BuildSpatialPicList");
+    return ENC_RETURN_INVALIDINPUT;
+  }
+  ++ pCtx->iInputFrameIdx;
 
   if (pCtx->pFuncList->pfRc.pfWelsUpdateMaxBrWindowStatus) {
     pCtx->pFuncList->pfRc.pfWelsUpdateMaxBrWindowStatus (pCtx, iSpatialNum, pFbi->uiTimeStamp);
@@ -3874,6 +3982,7 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi, const SSour
     }
 
     // deblocking filter
+    pCtx->pDecPic->bBorderExpanded = false;
     if (
       (!pCtx->pCurDqLayer->bDeblockingParallelFlag) &&
 #if !defined(ENABLE_FRAME_DUMP)
@@ -3883,6 +3992,9 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi, const SSour
       true
     ) {
       PerformDeblockingFilter (pCtx);
+    } else {
+      // filtered by the slice coding tasks or not at all, the reference borders can still be padded in parallel
+      PerformReferenceExpansion (pCtx);
     }
 
     pCtx->pFuncList->pfRc.pfWelsRcPictureInfoUpdate (pCtx, iLayerSize);
@@ -4151,6 +4263,57 @@ int32_t WelsEncoderEncodeExt (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi, const SSour
   return ENC_RETURN_SUCCESS;
 }
 
+/*!
+ * \brief   pipelined svc encoding, the input picture is staged, with the frame pipeline scaled on the lookahead
+ *          thread, while the head of the staged queue is encoded, so the output lags the input by one picture,
+ *          or by iLookaheadFrames pictures with the lookahead
+ *
+ * \pParam  pCtx            sWelsEncCtx*, encoder context
+ * \pParam  pFbi            FrameBSInfo*, left as videoFrameTypeSkip without layers if nothing was encoded
+ * \pParam  pSrcPic         Source Picture, NULL to flush the head of the staged queue
+ * \return  same as WelsEncoderEncodeExt()
+ */
+int32_t WelsEncoderEncodePipelined (sWelsEncCtx* pCtx, SFrameBSInfo* pFbi, const SSourcePicture* pSrcPic) {
+  if (pCtx == NULL) {
+    return ENC_RETURN_MEMALLOCERR;
+  }
+  CWelsPreProcess* pVpp     = pCtx->pVpp;
+  SSourcePicture sStagedPic;
+  const int32_t kiStagedSet = pVpp->GetStagedPicture (&sStagedPic, NULL == pSrcPic);
+  const int32_t kiNextSet   = pVpp->GetFreeStagedSet();
+  bool bLookahead           = false;
+  int32_t iRet              = ENC_RETURN_SUCCESS;
+
+  // a picture that resets the preprocessing is staged after the encoding, in the calling thread
+  if (pSrcPic != NULL && kiStagedSet >= 0 && pCtx->pTaskManage != NULL && pVpp->IsStageReady (pSrcPic)) {
+    bLookahead = (ENC_RETURN_SUCCESS == pCtx->pTaskManage->ExecutePreprocessAsync (pSrcPic, kiNextSet));
+  }
+
+  if (kiStagedSet >= 0) {
+    iRet = WelsEncoderEncodeExt (pCtx, pFbi, &sStagedPic);
+  } else {
+    pFbi->eFrameType  = videoFrameTypeSkip;
+    pFbi->iLayerNum   = 0;
+    pFbi->uiTimeStamp = 0;
+  }
+
+  if (bLookahead) {
+    if (ENC_RETURN_SUCCESS != pCtx->pTaskManage->WaitPreprocess())
+      bLookahead = false;
+  }
+  if ((iRet == ENC_RETURN_MEMALLOCERR) || (iRet == ENC_RETURN_MEMOVERFLOWFOUND) || (iRet == ENC_RETURN_VLCOVERFLOWFOUND))
+    return iRet;
+  if (pSrcPic != NULL) {
+    const int32_t kiStageRet = bLookahead ? 0 : pVpp->StagePicture (pCtx, pSrcPic, kiNextSet);
+    if (kiStageRet != 0) {
+      WelsLog (& (pCtx->sLogCtx), WELS_LOG_ERROR, "WelsEncoderEncodePipelined(), failed in staging the input picture");
+      return (kiStageRet == -2) ? ENC_RETURN_INVALIDINPUT : ENC_RETURN_MEMALLOCERR;
+    }
+    pVpp->CommitStagedPicture (kiNextSet);
+  }
+  return iRet;
+}
+
 /*!
  * \brief   Wels SVC encoder parameters adjustment
  *          SVC adjustment results in new requirement in memory blocks adjustment
@@ -4166,6 +4329,10 @@ int32_t WelsEncoderParamAdjust (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pNewPa
 
   if (NULL == ppCtx || NULL == *ppCtx || NULL == pNewParam) return 1;
 
+  // the thread pool is chosen at initialization only, keep it across resets
+  pNewParam->bThreadPoolParam = (*ppCtx)->pSvcParam->bThreadPoolParam;
+  pNewParam->sThreadPool      = (*ppCtx)->pSvcParam->sThreadPool;
+
   /* Check validation in new parameters */
   iReturn = ParamValidationExt (& (*ppCtx)->sLogCtx, pNewParam);
   if (iReturn != ENC_RETURN_SUCCESS) return iReturn;
@@ -4198,6 +4365,12 @@ int32_t WelsEncoderParamAdjust (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pNewPa
                (pOldParam->bEnableLongTermReference != pNewParam->bEnableLongTermReference) ||
                (pOldParam->iLTRRefNum != pNewParam->iLTRRefNum) ||
                (pOldParam->iMultipleThreadIdc != pNewParam->iMultipleThreadIdc) ||
+               (pOldParam->bUseWavefrontMd != pNewParam->bUseWavefrontMd) ||
+               (pOldParam->bEnableFramePipeline != pNewParam->bEnableFramePipeline) ||
+               (pOldParam->bEnablePyramidMe != pNewParam->bEnablePyramidMe) ||
+               (pOldParam->iLookaheadFrames != pNewParam->iLookaheadFrames) ||
+               (pOldParam->eRcPass != pNewParam->eRcPass) ||
+               (strncmp (pOldParam->sRcStatsFileName, pNewParam->sRcStatsFileName, MAX_FNAME_LEN) != 0) ||
                (pOldParam->bEnableBackgroundDetection != pNewParam->bEnableBackgroundDetection) ||
                (pOldParam->bEnableAdaptiveQuant != pNewParam->bEnableAdaptiveQuant) ||
                (pOldParam->eSpsPpsIdStrategy != pNewParam->eSpsPpsIdStrategy);
@@ -4303,6 +4476,14 @@ int32_t WelsEncoderParamAdjust (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pNewPa
     } while (iIndexD < pOldParam->iSpatialLayerNum);
   }
 
+  // the reset frees the staged queue, the pictures held by the frame pipeline or the lookahead have to be flushed
+  // with NULL input pictures first, they would be lost otherwise
+  if (bNeedReset && (*ppCtx)->pVpp->GetStagedPicture (NULL, true) >= 0) {
+    WelsLog (& (*ppCtx)->sLogCtx, WELS_LOG_ERROR,
+             "WelsEncoderParamAdjust(), input pictures are still held by the frame pipeline or the lookahead, flush them before the change");
+    return ENC_RETURN_UNSUPPORTED_PARA;
+  }
+
   if (bNeedReset) {
     SLogContext sLogCtx = (*ppCtx)->sLogCtx;
 
@@ -4323,6 +4504,7 @@ int32_t WelsEncoderParamAdjust (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pNewPa
     int32_t            iStatisticsLogInterval = (*ppCtx)->iStatisticsLogInterval;
     int64_t            iLastStatisticsLogTs = (*ppCtx)->iLastStatisticsLogTs;
     //for sEncoderStatistics
+    const int32_t      kiInputFrameIdx = (*ppCtx)->iInputFrameIdx;
 
     SExistingParasetList sExistingParasetList;
     SExistingParasetList* pExistingParasetList = NULL;
@@ -4337,11 +4519,18 @@ int32_t WelsEncoderParamAdjust (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pNewPa
       }
     }
 
+    // the first pass goes on with the same statistics file instead of rewriting it
+    pNewParam->bRcStatsAppend = (NULL != (*ppCtx)->pRcStats) && (pOldParam->eRcPass == pNewParam->eRcPass) &&
+                                (strncmp (pOldParam->sRcStatsFileName, pNewParam->sRcStatsFileName, MAX_FNAME_LEN) == 0);
+
     WelsUninitEncoderExt (ppCtx);
 
     /* Update new parameters */
-    if (WelsInitEncoderExt (ppCtx, pNewParam, &sLogCtx, pExistingParasetList))
+    const int32_t kiInitRet = WelsInitEncoderExt (ppCtx, pNewParam, &sLogCtx, pExistingParasetList);
+    pNewParam->bRcStatsAppend = false;
+    if (kiInitRet)
       return 1;
+    (*ppCtx)->pSvcParam->bRcStatsAppend = false;
     //if WelsInitEncoderExt succeed
     //for LTR or SPS,PPS ID update
     for (iIndexD = 0; iIndexD < pNewParam->iSpatialLayerNum; iIndexD++) {
@@ -4354,6 +4543,7 @@ int32_t WelsEncoderParamAdjust (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pNewPa
     (*ppCtx)->iStatisticsLogInterval = iStatisticsLogInterval;
     (*ppCtx)->iLastStatisticsLogTs = iLastStatisticsLogTs;
     //for sEncoderStatistics
+    (*ppCtx)->iInputFrameIdx = kiInputFrameIdx;
 
     //load back the needed structure for eSpsPpsIdStrategy
     if (((CONSTANT_ID != iOldSpsPpsIdStrategy) && (CONSTANT_ID != pNewParam->eSpsPpsIdStrategy))
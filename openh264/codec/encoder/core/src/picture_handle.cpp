@@ -121,6 +121,16 @@ SPicture* AllocPicture (CMemoryAlign* pMa, const int32_t kiWidth , const int32_t
   return pPic;
 }
 
+int32_t AllocPicturePyramid (CMemoryAlign* pMa, SPicture* pPic) {
+  const int32_t kiWidth  = WELS_ALIGN (pPic->iWidthInPixel, MB_WIDTH_LUMA);
+  const int32_t kiHeight = WELS_ALIGN (pPic->iHeightInPixel, MB_HEIGHT_LUMA);
+  for (int32_t i = 0; i < PYRAMID_ME_LEVEL_NUM; i++) {
+    pPic->pPyramidPlane[i] = AllocPicture (pMa, kiWidth >> (i + 1), kiHeight >> (i + 1), false, 0);
+    WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pPic->pPyramidPlane[i])
+  }
+  return ENC_RETURN_SUCCESS;
+}
+
 /*!
  * \brief   free picture pData planes
  * \param   pPic        picture pointer to be destoryed
@@ -175,6 +185,11 @@ void FreePicture (CMemoryAlign* pMa, SPicture** ppPic) {
       pPic->pScreenBlockFeatureStorage = NULL;
     }
 
+    for (int32_t i = 0; i < PYRAMID_ME_LEVEL_NUM; i++) {
+      if (pPic->pPyramidPlane[i])
+        FreePicture (pMa, &pPic->pPyramidPlane[i]);
+    }
+
     pMa->WelsFree (*ppPic, "pPic");
     *ppPic = NULL;
   }
@@ -42,6 +42,7 @@
  *
  *************************************************************************/
 #include "rc.h"
+#include "rc_stats.h"
 #include "encoder_context.h"
 #include "utils.h"
 #include "svc_enc_golomb.h"
@@ -169,7 +170,8 @@ void RcInitSequenceParameter (sWelsEncCtx* pEncCtx) {
 
     bMultiSliceMode = ((SM_RASTER_SLICE == pDLayerParam->sSliceArgument.uiSliceMode) ||
                        (SM_SIZELIMITED_SLICE    == pDLayerParam->sSliceArgument.uiSliceMode));
-    if (bMultiSliceMode)
+    // MB-row wavefront ME/MD decides a row ahead of entropy coding, GOM QP can not follow the coded bits
+    if (bMultiSliceMode || pEncCtx->pSvcParam->bUseWavefrontMd)
       pWelsSvcRc->iNumberMbGom = pWelsSvcRc->iNumberMbFrame;
   }
 }
@@ -579,6 +581,13 @@ void RcDecideTargetBits (sWelsEncCtx* pEncCtx) {
     } else {
       pWelsSvcRc->iTargetBits = pWelsSvcRc->iBitsPerFrame * IDR_BITRATE_RATIO;
     }
+    // second pass: the IDR gets the bits of as many average P frames as its first pass weight is worth
+    int64_t iWeightRatio = INT_MULTIPLY;
+    if (WelsRcStatsWeightRatio (pEncCtx, &iWeightRatio)) {
+      iWeightRatio = WELS_CLIP3 (iWeightRatio, INT_MULTIPLY, INT_MULTIPLY * IDR_BITRATE_RATIO * 2);
+      pWelsSvcRc->iTargetBits = static_cast<int32_t> (WELS_DIV_ROUND64 (static_cast<int64_t> (pWelsSvcRc->iBitsPerFrame)
+                                * iWeightRatio, INT_MULTIPLY));
+    }
   } else {
     if (pWelsSvcRc->iRemainingWeights > pTOverRc->iTlayerWeight ||
         (fix_rc_overshoot && pWelsSvcRc->iRemainingWeights == pTOverRc->iTlayerWeight))
@@ -586,6 +595,24 @@ void RcDecideTargetBits (sWelsEncCtx* pEncCtx) {
                                 pWelsSvcRc->iRemainingWeights);
     else //this case should be not hit. needs to more test case to verify this
       pWelsSvcRc->iTargetBits = pWelsSvcRc->iRemainingBits;
+    // move bits to the frames the lookahead finds more complex than the ones around them
+    const SVAAFrameInfo* kpVaa = pEncCtx->pVaa;
+    if (pEncCtx->pSvcParam->iLookaheadFrames > 0 && kpVaa->iLookaheadWindowCost > 0 && pWelsSvcRc->iTargetBits > 0) {
+      int64_t iCostRatio = WELS_DIV_ROUND64 (static_cast<int64_t> (kpVaa->iLookaheadFrameCost) * INT_MULTIPLY,
+                                             kpVaa->iLookaheadWindowCost);
+      iCostRatio = WELS_CLIP3 (iCostRatio, INT_MULTIPLY - LOOKAHEAD_BITS_VARY_RANGE,
+                               INT_MULTIPLY + LOOKAHEAD_BITS_VARY_RANGE);
+      pWelsSvcRc->iTargetBits = static_cast<int32_t> (WELS_DIV_ROUND64 (pWelsSvcRc->iTargetBits * iCostRatio,
+                                INT_MULTIPLY));
+    }
+    // second pass: move bits to the frames the first pass found more complex than the average of the sequence
+    int64_t iWeightRatio = INT_MULTIPLY;
+    if (pWelsSvcRc->iTargetBits > 0 && WelsRcStatsWeightRatio (pEncCtx, &iWeightRatio)) {
+      iWeightRatio = WELS_CLIP3 (iWeightRatio, INT_MULTIPLY - RC_STATS_BITS_VARY_RANGE,
+                                 INT_MULTIPLY + RC_STATS_BITS_VARY_RANGE);
+      pWelsSvcRc->iTargetBits = static_cast<int32_t> (WELS_DIV_ROUND64 (pWelsSvcRc->iTargetBits * iWeightRatio,
+                                INT_MULTIPLY));
+    }
     if ((pWelsSvcRc->iTargetBits <= 0) && ((pEncCtx->pSvcParam->iRCMode == RC_BITRATE_MODE)
                                            && (pEncCtx->pSvcParam->bEnableFrameSkip == false))) {
       pWelsSvcRc->iCurrentBitsLevel = BITS_EXCEEDED;
@@ -728,17 +755,21 @@ void RcGomTargetBits (sWelsEncCtx* pEncCtx, SSlice* pSlice) {
   } else if (kiComplexityIndex >= iLastGomIndex) {
     iAllocateBits = iLeftBits;
   } else {
-    pWelsSvcRc_Base = RcJudgeBaseUsability (pEncCtx);
-    pWelsSvcRc_Base = (pWelsSvcRc_Base) ? pWelsSvcRc_Base : pWelsSvcRc;
+    // second pass: the bits the first pass spent on each GOM steer the allocation instead of the SAD
+    const int32_t* kpGomSad = WelsRcStatsGomBits (pEncCtx);
+    if (NULL == kpGomSad) {
+      pWelsSvcRc_Base = RcJudgeBaseUsability (pEncCtx);
+      pWelsSvcRc_Base = (pWelsSvcRc_Base) ? pWelsSvcRc_Base : pWelsSvcRc;
+      kpGomSad = pWelsSvcRc_Base->pCurrentFrameGomSad;
+    }
     for (i = kiComplexityIndex + 1; i <= iLastGomIndex; i++) {
-      iSumSad += pWelsSvcRc_Base->pCurrentFrameGomSad[i];
+      iSumSad += kpGomSad[i];
     }
 
     if (0 == iSumSad)
       iAllocateBits = WELS_DIV_ROUND (iLeftBits, (iLastGomIndex - kiComplexityIndex));
     else
-      iAllocateBits = WELS_DIV_ROUND ((int64_t)iLeftBits * pWelsSvcRc_Base->pCurrentFrameGomSad[kiComplexityIndex + 1],
-                                      iSumSad);
+      iAllocateBits = WELS_DIV_ROUND ((int64_t)iLeftBits * kpGomSad[kiComplexityIndex + 1], iSumSad);
   }
   pSOverRc->iGomTargetBits = iAllocateBits;
 }
@@ -1178,6 +1209,7 @@ void  WelsRcPictureInitGom (sWelsEncCtx* pEncCtx, long long uiTimeStamp) {
   SWelsSvcRc* pWelsSvcRc           = &pEncCtx->pWelsSvcRc[pEncCtx->uiDependencyId];
   const int32_t kiSliceNum         = pEncCtx->pCurDqLayer->iMaxSliceNum;
   pWelsSvcRc->iContinualSkipFrames = 0;
+  WelsRcStatsPictureInit (pEncCtx, uiTimeStamp);
 
   if (pEncCtx->eSliceType == I_SLICE) {
     if (0 == pWelsSvcRc->iIdrNum) { //iIdrNum == 0 means encoder has been initialed
@@ -1218,6 +1250,7 @@ void  WelsRcPictureInfoUpdateGom (sWelsEncCtx* pEncCtx, int32_t iLayerSize) {
   int32_t iCodedBits = (iLayerSize << 3);
 
   RcUpdatePictureQpBits (pEncCtx, iCodedBits);
+  WelsRcStatsPictureInfoUpdate (pEncCtx);
 
   if (pEncCtx->eSliceType == P_SLICE) {
     RcUpdateFrameComplexity (pEncCtx);
@@ -1269,6 +1302,7 @@ void WelsRcMbInfoUpdateGom (sWelsEncCtx* pEncCtx, SMB* pCurMb, int32_t iCostLuma
   int32_t iCurMbBits = pEncCtx->pFuncList->pfGetBsPosition (pSlice) - pSOverRc->iBsPosSlice;
   pSOverRc->iFrameBitsSlice += iCurMbBits;
   pSOverRc->iGomBitsSlice += iCurMbBits;
+  WelsRcStatsMbInfoUpdate (pEncCtx, pCurMb, iCurMbBits);
 
   pWelsSvcRc->pGomCost[kiComplexityIndex] += iCostLuma;
   if (iCurMbBits > 0) {
@@ -1474,6 +1508,7 @@ void  WelsRcPictureInfoUpdateGomTimeStamp (sWelsEncCtx* pEncCtx, int32_t iLayerS
   int32_t iCodedBits = (iLayerSize << 3);
 
   RcUpdatePictureQpBits (pEncCtx, iCodedBits);
+  WelsRcStatsPictureInfoUpdate (pEncCtx);
   if (pEncCtx->eSliceType == P_SLICE) {
     RcUpdateFrameComplexity (pEncCtx);
   } else {
@@ -1567,6 +1602,7 @@ void  WelsRcInitFuncPointers (sWelsEncCtx* pEncCtx, RC_MODES iRcMode) {
 void  WelsRcInitModule (sWelsEncCtx* pEncCtx, RC_MODES iRcMode) {
   WelsRcInitFuncPointers (pEncCtx, iRcMode);
   RcInitSequenceParameter (pEncCtx);
+  WelsRcStatsInit (pEncCtx);
 }
 
 void  WelsRcFreeMemory (sWelsEncCtx* pEncCtx) {
@@ -1576,6 +1612,7 @@ void  WelsRcFreeMemory (sWelsEncCtx* pEncCtx) {
     pWelsSvcRc  = &pEncCtx->pWelsSvcRc[i];
     RcFreeLayerMemory (pWelsSvcRc, pEncCtx->pMemAlign);
   }
+  WelsRcStatsUninit (pEncCtx);
 }
 
 long long GetTimestampForRc (const long long uiTimeStamp, const long long uiLastTimeStamp, const float fFrameRate) {
@@ -0,0 +1,330 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ *
+ * \file    rc_stats.cpp
+ *
+ * \brief   statistics file of the two-pass rate control: written by the first pass, read back by the second one
+ *
+ * \date    10/17/2026 Created
+ *
+ *************************************************************************************
+ */
+
+#include <math.h>
+#include "rc_stats.h"
+#include "rc.h"
+#include "encoder_context.h"
+
+namespace WelsEnc {
+
+#define RC_STATS_FRAME_FIELD_NUM 7 // fields of SRcStatsFrame before the MB bits
+
+static int32_t RcStatsHeaderSize (const int32_t kiLayerNum) {
+  return (3 + 2 * kiLayerNum) * sizeof (int32_t);
+}
+
+// the bits a picture took at its quantizer step measure what the coding tools made of it, the complexity of the
+// preprocessing is computed again by the second pass from the same input and used by its rate control model anyway
+static double RcStatsWeight (const SRcStatsFrame* kpFrame) {
+  const double kdQStep = pow (2.0, (kpFrame->uiAverageQp - 4.0) / 6.0);
+  return pow (WELS_MAX (kpFrame->iFrameBits, 1) * kdQStep, RC_STATS_CMPLX_EXP);
+}
+
+static bool RcStatsWriteFrame (WelsFileHandle* pFile, const SRcStatsFrame* kpFrame, const int32_t kiMbNum) {
+  int32_t iCount = 0;
+  iCount += WelsFwrite (&kpFrame->iTimeStamp, sizeof (int64_t), 1, pFile);
+  iCount += WelsFwrite (&kpFrame->iFrameIdx, sizeof (int32_t), 1, pFile);
+  iCount += WelsFwrite (&kpFrame->uiDependencyId, sizeof (uint8_t), 1, pFile);
+  iCount += WelsFwrite (&kpFrame->uiTemporalId, sizeof (uint8_t), 1, pFile);
+  iCount += WelsFwrite (&kpFrame->uiSliceType, sizeof (uint8_t), 1, pFile);
+  iCount += WelsFwrite (&kpFrame->uiAverageQp, sizeof (uint8_t), 1, pFile);
+  iCount += WelsFwrite (&kpFrame->iFrameBits, sizeof (int32_t), 1, pFile);
+  iCount += WelsFwrite (kpFrame->pMbBits, sizeof (uint16_t), kiMbNum, pFile);
+  return iCount == RC_STATS_FRAME_FIELD_NUM + kiMbNum;
+}
+
+// the MB bits are skipped if kbSkipMbBits, a record of a layer the header does not describe ends the file
+static bool RcStatsReadFrame (SWelsRcStats* pStats, SRcStatsFrame* pFrame, const bool kbSkipMbBits) {
+  WelsFileHandle* pFile = pStats->pFile;
+  int32_t iCount = 0;
+  iCount += WelsFread (&pFrame->iTimeStamp, sizeof (int64_t), 1, pFile);
+  iCount += WelsFread (&pFrame->iFrameIdx, sizeof (int32_t), 1, pFile);
+  iCount += WelsFread (&pFrame->uiDependencyId, sizeof (uint8_t), 1, pFile);
+  iCount += WelsFread (&pFrame->uiTemporalId, sizeof (uint8_t), 1, pFile);
+  iCount += WelsFread (&pFrame->uiSliceType, sizeof (uint8_t), 1, pFile);
+  iCount += WelsFread (&pFrame->uiAverageQp, sizeof (uint8_t), 1, pFile);
+  iCount += WelsFread (&pFrame->iFrameBits, sizeof (int32_t), 1, pFile);
+  if (iCount != RC_STATS_FRAME_FIELD_NUM || pFrame->uiDependencyId >= pStats->iLayerNum
+      || pFrame->uiTemporalId >= MAX_TEMPORAL_LEVEL || pFrame->uiAverageQp > QP_MAX_VALUE)
+    return false;
+
+  const SRcStatsLayer* kpLayer = &pStats->sLayer[pFrame->uiDependencyId];
+  const int32_t kiMbNum = kpLayer->iMbWidth * kpLayer->iMbHeight;
+  if (kbSkipMbBits)
+    return 0 == WelsFseek (pFile, kiMbNum * sizeof (uint16_t), WELS_FILE_SEEK_CUR);
+  return kiMbNum == WelsFread (pFrame->pMbBits, sizeof (uint16_t), kiMbNum, pFile);
+}
+
+// checks that the file was written for the layers of this encoding, leaves it at the first record
+static bool RcStatsReadHeader (SWelsRcStats* pStats) {
+  int32_t iHeader[3] = {0};
+  if (3 != WelsFread (iHeader, sizeof (int32_t), 3, pStats->pFile) || iHeader[0] != RC_STATS_MAGIC
+      || iHeader[1] != RC_STATS_VERSION || iHeader[2] != pStats->iLayerNum)
+    return false;
+  for (int32_t i = 0; i < pStats->iLayerNum; i++) {
+    int32_t iMbSize[2] = {0};
+    if (2 != WelsFread (iMbSize, sizeof (int32_t), 2, pStats->pFile)
+        || iMbSize[0] != pStats->sLayer[i].iMbWidth || iMbSize[1] != pStats->sLayer[i].iMbHeight)
+      return false;
+  }
+  return true;
+}
+
+// kbAppend: the encoder was reset in the middle of the pass, keep the records written before
+static bool RcStatsOpenFirstPass (SWelsRcStats* pStats, const char* kpFileName, const bool kbAppend) {
+  if (kbAppend) {
+    pStats->pFile = WelsFopen (kpFileName, "r+b");
+    if (NULL == pStats->pFile)
+      return false;
+    return RcStatsReadHeader (pStats) && 0 == WelsFseek (pStats->pFile, 0, WESL_FILE_SEEK_END);
+  }
+
+  pStats->pFile = WelsFopen (kpFileName, "wb");
+  if (NULL == pStats->pFile)
+    return false;
+
+  const int32_t kiHeader[3] = {RC_STATS_MAGIC, RC_STATS_VERSION, pStats->iLayerNum};
+  int32_t iCount = WelsFwrite (kiHeader, sizeof (int32_t), 3, pStats->pFile);
+  for (int32_t i = 0; i < pStats->iLayerNum; i++) {
+    iCount += WelsFwrite (&pStats->sLayer[i].iMbWidth, sizeof (int32_t), 1, pStats->pFile);
+    iCount += WelsFwrite (&pStats->sLayer[i].iMbHeight, sizeof (int32_t), 1, pStats->pFile);
+  }
+  return iCount == 3 + 2 * pStats->iLayerNum;
+}
+
+static bool RcStatsOpenSecondPass (SWelsRcStats* pStats, const char* kpFileName) {
+  pStats->pFile = WelsFopen (kpFileName, "rb");
+  if (NULL == pStats->pFile || !RcStatsReadHeader (pStats))
+    return false;
+
+  // the target bits of a picture follow its weight relative to the P pictures of the whole sequence
+  double dWeightSum[MAX_DEPENDENCY_LAYER][MAX_TEMPORAL_LEVEL] = {{0}};
+  int32_t iWeightNum[MAX_DEPENDENCY_LAYER][MAX_TEMPORAL_LEVEL] = {{0}};
+  while (RcStatsReadFrame (pStats, &pStats->sNextFrame, true)) {
+    if (P_SLICE == pStats->sNextFrame.uiSliceType) {
+      dWeightSum[pStats->sNextFrame.uiDependencyId][pStats->sNextFrame.uiTemporalId] += RcStatsWeight (
+            &pStats->sNextFrame);
+      ++ iWeightNum[pStats->sNextFrame.uiDependencyId][pStats->sNextFrame.uiTemporalId];
+    }
+  }
+  for (int32_t i = 0; i < pStats->iLayerNum; i++) {
+    for (int32_t j = 0; j < MAX_TEMPORAL_LEVEL; j++) {
+      pStats->sLayer[i].dMeanWeight[j] = (iWeightNum[i][j] > 0) ? dWeightSum[i][j] / iWeightNum[i][j] : 0.0;
+    }
+  }
+
+  if (0 != WelsFseek (pStats->pFile, RcStatsHeaderSize (pStats->iLayerNum), WELS_FILE_SEEK_SET))
+    return false;
+  pStats->bNextValid = RcStatsReadFrame (pStats, &pStats->sNextFrame, false);
+  return true;
+}
+
+void WelsRcStatsInit (sWelsEncCtx* pEncCtx) {
+  SWelsSvcCodingParam* pParam = pEncCtx->pSvcParam;
+  CMemoryAlign* pMa           = pEncCtx->pMemAlign;
+  int32_t iMaxMbNum           = 0;
+
+  pEncCtx->pRcStats = NULL;
+  if (RC_SINGLE_PASS == pParam->eRcPass)
+    return;
+
+  SWelsRcStats* pStats = (SWelsRcStats*)pMa->WelsMallocz (sizeof (SWelsRcStats), "pRcStats");
+  if (NULL == pStats)
+    return;
+  pEncCtx->pRcStats = pStats;
+  pStats->eRcPass   = pParam->eRcPass;
+  pStats->iLayerNum = pParam->iSpatialLayerNum;
+
+  bool bUsable = true;
+  for (int32_t i = 0; i < pStats->iLayerNum; i++) {
+    SRcStatsLayer* pLayer   = &pStats->sLayer[i];
+    pLayer->iMbWidth        = (pParam->sSpatialLayers[i].iVideoWidth + 15) >> 4;
+    pLayer->iMbHeight       = (pParam->sSpatialLayers[i].iVideoHeight + 15) >> 4;
+    const int32_t kiMbNum   = pLayer->iMbWidth * pLayer->iMbHeight;
+    pLayer->sFrame.pMbBits  = (uint16_t*)pMa->WelsMallocz (kiMbNum * sizeof (uint16_t), "pRcStats->sFrame.pMbBits");
+    pLayer->pGomBits        = (int32_t*)pMa->WelsMallocz (kiMbNum * sizeof (int32_t), "pRcStats->pGomBits");
+    bUsable = bUsable && (NULL != pLayer->sFrame.pMbBits) && (NULL != pLayer->pGomBits);
+    iMaxMbNum = WELS_MAX (iMaxMbNum, kiMbNum);
+  }
+  pStats->sNextFrame.pMbBits = (uint16_t*)pMa->WelsMallocz (iMaxMbNum * sizeof (uint16_t),
+                               "pRcStats->sNextFrame.pMbBits");
+  bUsable = bUsable && (NULL != pStats->sNextFrame.pMbBits);
+
+  if (bUsable) {
+    bUsable = (RC_FIRST_PASS == pStats->eRcPass) ? RcStatsOpenFirstPass (pStats, pParam->sRcStatsFileName, pParam->bRcStatsAppend) :
+              RcStatsOpenSecondPass (pStats, pParam->sRcStatsFileName);
+  }
+  if (!bUsable) {
+    WelsLog (& (pEncCtx->sLogCtx), WELS_LOG_WARNING,
+             "WelsRcStatsInit(), statistics file %s not usable for eRcPass (%d), encoding as a single pass",
+             pParam->sRcStatsFileName, pParam->eRcPass);
+    WelsRcStatsUninit (pEncCtx);
+  }
+}
+
+void WelsRcStatsUninit (sWelsEncCtx* pEncCtx) {
+  SWelsRcStats* pStats  = pEncCtx->pRcStats;
+  CMemoryAlign* pMa     = pEncCtx->pMemAlign;
+  if (NULL == pStats)
+    return;
+
+  if (NULL != pStats->pFile) {
+    WelsFclose (pStats->pFile);
+    pStats->pFile = NULL;
+  }
+  for (int32_t i = 0; i < pStats->iLayerNum; i++) {
+    if (NULL != pStats->sLayer[i].sFrame.pMbBits)
+      pMa->WelsFree (pStats->sLayer[i].sFrame.pMbBits, "pRcStats->sFrame.pMbBits");
+    if (NULL != pStats->sLayer[i].pGomBits)
+      pMa->WelsFree (pStats->sLayer[i].pGomBits, "pRcStats->pGomBits");
+  }
+  if (NULL != pStats->sNextFrame.pMbBits)
+    pMa->WelsFree (pStats->sNextFrame.pMbBits, "pRcStats->sNextFrame.pMbBits");
+  pMa->WelsFree (pStats, "pRcStats");
+  pEncCtx->pRcStats = NULL;
+}
+
+void WelsRcStatsPictureInit (sWelsEncCtx* pEncCtx, const long long kiTimeStamp) {
+  SWelsRcStats* pStats  = pEncCtx->pRcStats;
+  if (NULL == pStats)
+    return;
+  const int32_t kiDid   = pEncCtx->uiDependencyId;
+  SRcStatsLayer* pLayer = &pStats->sLayer[kiDid];
+  const int32_t kiMbNum = pLayer->iMbWidth * pLayer->iMbHeight;
+  const int32_t kiFrameIdx = pEncCtx->iInputFrameIdx;
+
+  if (RC_FIRST_PASS == pStats->eRcPass) {
+    pLayer->sFrame.iTimeStamp = kiTimeStamp;
+    pLayer->sFrame.iFrameIdx  = kiFrameIdx;
+    memset (pLayer->sFrame.pMbBits, 0, kiMbNum * sizeof (uint16_t));
+    return;
+  }
+
+  // records are in coding order, drop the ones of pictures this pass skipped
+  pLayer->bFrameValid = false;
+  while (pStats->bNextValid && (pStats->sNextFrame.iFrameIdx < kiFrameIdx
+                                || (pStats->sNextFrame.iFrameIdx == kiFrameIdx && pStats->sNextFrame.uiDependencyId < kiDid))) {
+    pStats->bNextValid = RcStatsReadFrame (pStats, &pStats->sNextFrame, false);
+  }
+  if (!pStats->bNextValid || pStats->sNextFrame.iFrameIdx != kiFrameIdx
+      || pStats->sNextFrame.uiDependencyId != kiDid)
+    return; // skipped by the first pass
+  if (pStats->sNextFrame.iTimeStamp != kiTimeStamp) {
+    WelsLog (& (pEncCtx->sLogCtx), WELS_LOG_WARNING,
+             "WelsRcStatsPictureInit(), record of input picture %d has timestamp %lld instead of %lld, statistics file %s was written for another input, going on as a single pass",
+             kiFrameIdx, static_cast<long long> (pStats->sNextFrame.iTimeStamp), kiTimeStamp,
+             pEncCtx->pSvcParam->sRcStatsFileName);
+    pStats->bNextValid = false;
+    for (int32_t i = 0; i < pStats->iLayerNum; i++)
+      pStats->sLayer[i].bFrameValid = false;
+    return;
+  }
+
+  uint16_t* pMbBits     = pLayer->sFrame.pMbBits;
+  pLayer->sFrame        = pStats->sNextFrame;
+  pLayer->sFrame.pMbBits = pMbBits;
+  memcpy (pMbBits, pStats->sNextFrame.pMbBits, kiMbNum * sizeof (uint16_t));
+  pLayer->bFrameValid   = true;
+  pStats->bNextValid    = RcStatsReadFrame (pStats, &pStats->sNextFrame, false);
+
+  const int32_t kiMbNumGom = WELS_MAX (pEncCtx->pWelsSvcRc[kiDid].iNumberMbGom, 1);
+  memset (pLayer->pGomBits, 0, kiMbNum * sizeof (int32_t));
+  for (int32_t i = 0; i < kiMbNum; i++) {
+    pLayer->pGomBits[i / kiMbNumGom] += pMbBits[i];
+  }
+}
+
+void WelsRcStatsMbInfoUpdate (sWelsEncCtx* pEncCtx, SMB* pCurMb, const int32_t kiMbBits) {
+  SWelsRcStats* pStats  = pEncCtx->pRcStats;
+  if (NULL == pStats || RC_FIRST_PASS != pStats->eRcPass)
+    return;
+  SRcStatsLayer* pLayer = &pStats->sLayer[pEncCtx->uiDependencyId];
+  if (pCurMb->iMbXY < pLayer->iMbWidth * pLayer->iMbHeight)
+    pLayer->sFrame.pMbBits[pCurMb->iMbXY] = (uint16_t)WELS_CLIP3 (kiMbBits, 0, 0xffff);
+}
+
+void WelsRcStatsPictureInfoUpdate (sWelsEncCtx* pEncCtx) {
+  SWelsRcStats* pStats  = pEncCtx->pRcStats;
+  if (NULL == pStats || RC_FIRST_PASS != pStats->eRcPass || NULL == pStats->pFile)
+    return;
+  const int32_t kiDid         = pEncCtx->uiDependencyId;
+  const SWelsSvcRc* kpWelsSvcRc = &pEncCtx->pWelsSvcRc[kiDid];
+  SRcStatsLayer* pLayer       = &pStats->sLayer[kiDid];
+  SRcStatsFrame* pFrame       = &pLayer->sFrame;
+
+  pFrame->uiDependencyId    = kiDid;
+  pFrame->uiTemporalId      = pEncCtx->uiTemporalId;
+  pFrame->uiSliceType       = pEncCtx->eSliceType;
+  pFrame->uiAverageQp       = WELS_CLIP3 (kpWelsSvcRc->iAverageFrameQp, QP_MIN_VALUE, QP_MAX_VALUE);
+  pFrame->iFrameBits        = kpWelsSvcRc->iFrameDqBits;
+  if (!RcStatsWriteFrame (pStats->pFile, pFrame, pLayer->iMbWidth * pLayer->iMbHeight)) {
+    WelsLog (& (pEncCtx->sLogCtx), WELS_LOG_ERROR,
+             "WelsRcStatsPictureInfoUpdate(), writing statistics file %s failed, no more records written",
+             pEncCtx->pSvcParam->sRcStatsFileName);
+    WelsFclose (pStats->pFile);
+    pStats->pFile = NULL;
+  }
+}
+
+bool WelsRcStatsWeightRatio (sWelsEncCtx* pEncCtx, int64_t* pRatio) {
+  const SWelsRcStats* kpStats = pEncCtx->pRcStats;
+  if (NULL == kpStats || RC_SECOND_PASS != kpStats->eRcPass)
+    return false;
+  const SRcStatsLayer* kpLayer = &kpStats->sLayer[pEncCtx->uiDependencyId];
+  if (!kpLayer->bFrameValid)
+    return false;
+  const double kdMeanWeight = kpLayer->dMeanWeight[kpLayer->sFrame.uiTemporalId];
+  if (kdMeanWeight <= 0.0)
+    return false;
+  *pRatio = static_cast<int64_t> (RcStatsWeight (&kpLayer->sFrame) * INT_MULTIPLY / kdMeanWeight + 0.5);
+  return true;
+}
+
+const int32_t* WelsRcStatsGomBits (sWelsEncCtx* pEncCtx) {
+  const SWelsRcStats* kpStats = pEncCtx->pRcStats;
+  if (NULL == kpStats || RC_SECOND_PASS != kpStats->eRcPass)
+    return NULL;
+  const SRcStatsLayer* kpLayer = &kpStats->sLayer[pEncCtx->uiDependencyId];
+  return kpLayer->bFrameValid ? kpLayer->pGomBits : NULL;
+}
+
+}
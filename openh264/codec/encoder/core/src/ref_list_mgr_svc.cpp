@@ -371,10 +371,11 @@ bool WelsUpdateRefList (sWelsEncCtx* pCtx) {
 #if !defined(ENABLE_FRAME_DUMP) // to save complexity, 1/6/2009
     if ((pParamD->iHighestTemporalId == 0) || (kuiTid < pParamD->iHighestTemporalId))
 #endif// !ENABLE_FRAME_DUMP
-      // Expanding picture for future reference
-      ExpandReferencingPicture (pCtx->pDecPic->pData, pCtx->pDecPic->iWidthInPixel, pCtx->pDecPic->iHeightInPixel,
-                                pCtx->pDecPic->iLineSize,
-                                pCtx->pFuncList->sExpandPicFunc.pfExpandLumaPicture, pCtx->pFuncList->sExpandPicFunc.pfExpandChromaPicture);
+      // Expanding picture for future reference, unless done along with the deblocking
+      if (!pCtx->pDecPic->bBorderExpanded)
+        ExpandReferencingPicture (pCtx->pDecPic->pData, pCtx->pDecPic->iWidthInPixel, pCtx->pDecPic->iHeightInPixel,
+                                  pCtx->pDecPic->iLineSize,
+                                  pCtx->pFuncList->sExpandPicFunc.pfExpandLumaPicture, pCtx->pFuncList->sExpandPicFunc.pfExpandChromaPicture);
 
     // move picture in list
     pCtx->pDecPic->uiTemporalId = kuiTid;
@@ -775,10 +776,11 @@ bool WelsUpdateRefListScreen (sWelsEncCtx* pCtx) {
 #if !defined(ENABLE_FRAME_DUMP) // to save complexity, 1/6/2009
     if ((pParamD->iHighestTemporalId == 0) || (kuiTid < pParamD->iHighestTemporalId))
 #endif// !ENABLE_FRAME_DUMP
-      // Expanding picture for future reference
-      ExpandReferencingPicture (pCtx->pDecPic->pData, pCtx->pDecPic->iWidthInPixel, pCtx->pDecPic->iHeightInPixel,
-                                pCtx->pDecPic->iLineSize,
-                                pCtx->pFuncList->sExpandPicFunc.pfExpandLumaPicture, pCtx->pFuncList->sExpandPicFunc.pfExpandChromaPicture);
+      // Expanding picture for future reference, unless done along with the deblocking
+      if (!pCtx->pDecPic->bBorderExpanded)
+        ExpandReferencingPicture (pCtx->pDecPic->pData, pCtx->pDecPic->iWidthInPixel, pCtx->pDecPic->iHeightInPixel,
+                                  pCtx->pDecPic->iLineSize,
+                                  pCtx->pFuncList->sExpandPicFunc.pfExpandLumaPicture, pCtx->pFuncList->sExpandPicFunc.pfExpandChromaPicture);
 
     // move picture in list
     pCtx->pDecPic->uiTemporalId = pCtx->uiTemporalId;
@@ -333,6 +333,56 @@ int32_t WelsSampleSadIntra16x16Combined3_c (uint8_t* pDec, int32_t iDecStride, u
 
 }
 
+/*!
+ * \brief  batch SAD built on a single block SAD kernel, for the platforms without a dedicated multi candidate kernel
+ */
+#define WELS_SAMPLE_SAD_MULTI_ON_SINGLE(pfSadMulti, pfSad) \
+static void pfSadMulti (uint8_t* pSample1, int32_t iStride1, uint8_t* pSample2, int32_t iStride2, \
+                        const int32_t* kpOffset, int32_t iCount, int32_t* pSad) { \
+  for (int32_t i = 0; i < iCount; i++) \
+    pSad[i] = pfSad (pSample1, iStride1, pSample2 + kpOffset[i], iStride2); \
+}
+
+#if defined (X86_ASM)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti4x4_mmx, WelsSampleSad4x4_mmx)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti16x16_sse2, WelsSampleSad16x16_sse2)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti16x8_sse2, WelsSampleSad16x8_sse2)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti8x16_sse2, WelsSampleSad8x16_sse2)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti8x8_sse21, WelsSampleSad8x8_sse21)
+#endif
+
+#if defined (HAVE_NEON)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti4x4_neon, WelsSampleSad4x4_neon)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti16x16_neon, WelsSampleSad16x16_neon)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti16x8_neon, WelsSampleSad16x8_neon)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti8x16_neon, WelsSampleSad8x16_neon)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti8x8_neon, WelsSampleSad8x8_neon)
+#endif
+
+#if defined (HAVE_NEON_AARCH64)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti4x4_AArch64_neon, WelsSampleSad4x4_AArch64_neon)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti16x16_AArch64_neon, WelsSampleSad16x16_AArch64_neon)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti16x8_AArch64_neon, WelsSampleSad16x8_AArch64_neon)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti8x16_AArch64_neon, WelsSampleSad8x16_AArch64_neon)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti8x8_AArch64_neon, WelsSampleSad8x8_AArch64_neon)
+#endif
+
+#if defined (HAVE_MMI)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti4x4_mmi, WelsSampleSad4x4_mmi)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti16x16_mmi, WelsSampleSad16x16_mmi)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti16x8_mmi, WelsSampleSad16x8_mmi)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti8x16_mmi, WelsSampleSad8x16_mmi)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti8x8_mmi, WelsSampleSad8x8_mmi)
+#endif
+
+#if defined (HAVE_LASX)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti4x4_lasx, WelsSampleSad4x4_lasx)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti16x16_lasx, WelsSampleSad16x16_lasx)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti16x8_lasx, WelsSampleSad16x8_lasx)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti8x16_lasx, WelsSampleSad8x16_lasx)
+WELS_SAMPLE_SAD_MULTI_ON_SINGLE (WelsSampleSadMulti8x8_lasx, WelsSampleSad8x8_lasx)
+#endif
+
 void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
   //pfSampleSad init
   pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_16x16] = WelsSampleSad16x16_c;
@@ -360,6 +410,14 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
   pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_8x4] = WelsSampleSadFour8x4_c;
   pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_4x8] = WelsSampleSadFour4x8_c;
 
+  pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x16] = WelsSampleSadMulti16x16_c;
+  pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x8] = WelsSampleSadMulti16x8_c;
+  pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x16] = WelsSampleSadMulti8x16_c;
+  pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x8] = WelsSampleSadMulti8x8_c;
+  pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_4x4] = WelsSampleSadMulti4x4_c;
+  pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x4] = WelsSampleSadMulti8x4_c;
+  pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_4x8] = WelsSampleSadMulti4x8_c;
+
   pFuncList->sSampleDealingFuncs.pfIntra4x4Combined3Satd   = NULL;
   pFuncList->sSampleDealingFuncs.pfIntra8x8Combined3Satd   = NULL;
   pFuncList->sSampleDealingFuncs.pfIntra8x8Combined3Sad    = NULL;
@@ -369,6 +427,7 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
 #if defined (X86_ASM)
   if (uiCpuFlag & WELS_CPU_MMXEXT) {
     pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_4x4  ] = WelsSampleSad4x4_mmx;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_4x4] = WelsSampleSadMulti4x4_mmx;
   }
 
   if (uiCpuFlag & WELS_CPU_SSE2) {
@@ -377,6 +436,11 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
     pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_8x16] = WelsSampleSad8x16_sse2;
     pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_8x8] = WelsSampleSad8x8_sse21;
 
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x16] = WelsSampleSadMulti16x16_sse2;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x8] = WelsSampleSadMulti16x8_sse2;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x16] = WelsSampleSadMulti8x16_sse2;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x8] = WelsSampleSadMulti8x8_sse21;
+
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_16x16] = WelsSampleSadFour16x16_sse2;
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_16x8] = WelsSampleSadFour16x8_sse2;
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_8x16] = WelsSampleSadFour8x16_sse2;
@@ -410,8 +474,20 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_16x8]  = WelsSampleSatd16x8_avx2;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_8x16]  = WelsSampleSatd8x16_avx2;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_8x8]   = WelsSampleSatd8x8_avx2;
+#if !defined(X86_32_ASM)
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x16] = WelsSampleSadMulti16x16_avx2;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x8] = WelsSampleSadMulti16x8_avx2;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x16] = WelsSampleSadMulti8x16_avx2;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x8] = WelsSampleSadMulti8x8_avx2;
+#endif
+  }
+#if !defined(X86_32_ASM)
+  if ((uiCpuFlag & WELS_CPU_AVX2) && (uiCpuFlag & WELS_CPU_AVX512BW)) {
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x16] = WelsSampleSadMulti16x16_avx512;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x8] = WelsSampleSadMulti16x8_avx512;
   }
 #endif
+#endif
 #endif //(X86_ASM)
 
 #if defined (HAVE_NEON)
@@ -422,6 +498,12 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
     pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_8x16] = WelsSampleSad8x16_neon;
     pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_8x8] = WelsSampleSad8x8_neon;
 
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_4x4] = WelsSampleSadMulti4x4_neon;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x16] = WelsSampleSadMulti16x16_neon;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x8] = WelsSampleSadMulti16x8_neon;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x16] = WelsSampleSadMulti8x16_neon;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x8] = WelsSampleSadMulti8x8_neon;
+
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_16x16] = WelsSampleSadFour16x16_neon;
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_16x8] = WelsSampleSadFour16x8_neon;
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_8x16] = WelsSampleSadFour8x16_neon;
@@ -450,6 +532,12 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
     pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_8x16] = WelsSampleSad8x16_AArch64_neon;
     pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_8x8] = WelsSampleSad8x8_AArch64_neon;
 
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_4x4] = WelsSampleSadMulti4x4_AArch64_neon;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x16] = WelsSampleSadMulti16x16_AArch64_neon;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x8] = WelsSampleSadMulti16x8_AArch64_neon;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x16] = WelsSampleSadMulti8x16_AArch64_neon;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x8] = WelsSampleSadMulti8x8_AArch64_neon;
+
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_16x16] = WelsSampleSadFour16x16_AArch64_neon;
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_16x8] = WelsSampleSadFour16x8_AArch64_neon;
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_8x16] = WelsSampleSadFour8x16_AArch64_neon;
@@ -478,6 +566,12 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
     pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_8x8] = WelsSampleSad8x8_mmi;
     pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_4x4  ] = WelsSampleSad4x4_mmi;
 
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x16] = WelsSampleSadMulti16x16_mmi;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x8] = WelsSampleSadMulti16x8_mmi;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x16] = WelsSampleSadMulti8x16_mmi;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x8] = WelsSampleSadMulti8x8_mmi;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_4x4] = WelsSampleSadMulti4x4_mmi;
+
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_4x4  ] = WelsSampleSatd4x4_mmi;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_8x8  ] = WelsSampleSatd8x8_mmi;
     pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_8x16 ] = WelsSampleSatd8x16_mmi;
@@ -499,6 +593,12 @@ void WelsInitSampleSadFunc (SWelsFuncPtrList* pFuncList, uint32_t uiCpuFlag) {
     pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_16x8] = WelsSampleSad16x8_lasx;
     pFuncList->sSampleDealingFuncs.pfSampleSad[BLOCK_16x16] = WelsSampleSad16x16_lasx;
 
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_4x4] = WelsSampleSadMulti4x4_lasx;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x8] = WelsSampleSadMulti8x8_lasx;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x16] = WelsSampleSadMulti8x16_lasx;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x8] = WelsSampleSadMulti16x8_lasx;
+    pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_16x16] = WelsSampleSadMulti16x16_lasx;
+
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_16x16] = WelsSampleSadFour16x16_lasx;
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_16x8] = WelsSampleSadFour16x8_lasx;
     pFuncList->sSampleDealingFuncs.pfSample4Sad[BLOCK_8x16] = WelsSampleSadFour8x16_lasx;
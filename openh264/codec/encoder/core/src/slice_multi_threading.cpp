@@ -248,6 +248,154 @@ void DynamicAdjustSlicing (sWelsEncCtx* pCtx,
   pCurDqLayer->bNeedAdjustingSlicing = !DynamicAdjustSlicePEncCtxAll (pCurDqLayer, iRunLen);
 }
 
+int32_t RowProgressInit (SRowProgress* pProgress, const int32_t kiMaxRowNum, CMemoryAlign* pMa) {
+  int32_t iRow = 0;
+
+  pProgress->pMbCount   = (int32_t*)pMa->WelsMallocz (sizeof (int32_t) * kiMaxRowNum, "pRowMbCount");
+  pProgress->pWaiterNum = (int32_t*)pMa->WelsMallocz (sizeof (int32_t) * kiMaxRowNum, "pRowWaiterNum");
+  pProgress->pCondRow   = (WELS_CONDITION*)pMa->WelsMallocz (sizeof (WELS_CONDITION) * kiMaxRowNum, "pCondRow");
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, (NULL == pProgress->pMbCount) || (NULL == pProgress->pWaiterNum)
+                         || (NULL == pProgress->pCondRow))
+
+  if (WELS_THREAD_ERROR_OK != WelsMutexInit (&pProgress->mutexProgress))
+    return ENC_RETURN_UNEXPECTED;
+  for (iRow = 0; iRow < kiMaxRowNum; iRow++) {
+    if (WELS_THREAD_ERROR_OK != WelsConditionInit (&pProgress->pCondRow[iRow]))
+      return ENC_RETURN_UNEXPECTED;
+    pProgress->iRowNum = iRow + 1;
+  }
+  return ENC_RETURN_SUCCESS;
+}
+
+void RowProgressUninit (SRowProgress* pProgress, CMemoryAlign* pMa) {
+  int32_t iRow = 0;
+
+  if (NULL != pProgress->pCondRow) {
+    for (iRow = 0; iRow < pProgress->iRowNum; iRow++) {
+      WelsConditionDestroy (&pProgress->pCondRow[iRow]);
+    }
+    WelsMutexDestroy (&pProgress->mutexProgress);
+    pMa->WelsFree (pProgress->pCondRow, "pCondRow");
+    pProgress->pCondRow = NULL;
+  }
+  if (NULL != pProgress->pWaiterNum) {
+    pMa->WelsFree (pProgress->pWaiterNum, "pRowWaiterNum");
+    pProgress->pWaiterNum = NULL;
+  }
+  if (NULL != pProgress->pMbCount) {
+    pMa->WelsFree (pProgress->pMbCount, "pRowMbCount");
+    pProgress->pMbCount = NULL;
+  }
+  pProgress->iRowNum = 0;
+}
+
+// before the workers are started, nobody waits at this point
+void RowProgressReset (SRowProgress* pProgress, const int32_t kiRowNum) {
+  memset (pProgress->pMbCount, 0, sizeof (int32_t) * kiRowNum);
+  pProgress->iNextRow = 0;
+}
+
+int32_t RowProgressClaimRow (SRowProgress* pProgress) {
+  WelsMutexLock (&pProgress->mutexProgress);
+  const int32_t kiRow = pProgress->iNextRow++;
+  WelsMutexUnlock (&pProgress->mutexProgress);
+  return kiRow;
+}
+
+void RowProgressUpdate (SRowProgress* pProgress, const int32_t kiRow, const int32_t kiMbCount) {
+  WelsMutexLock (&pProgress->mutexProgress);
+  pProgress->pMbCount[kiRow] = kiMbCount;
+  if (pProgress->pWaiterNum[kiRow] > 0)
+    WelsConditionBroadcast (&pProgress->pCondRow[kiRow]);
+  WelsMutexUnlock (&pProgress->mutexProgress);
+}
+
+void RowProgressWait (SRowProgress* pProgress, const int32_t kiRow, const int32_t kiMbCount) {
+  WelsMutexLock (&pProgress->mutexProgress);
+  while (pProgress->pMbCount[kiRow] < kiMbCount) {
+    ++pProgress->pWaiterNum[kiRow];
+    WelsConditionWait (&pProgress->pCondRow[kiRow], &pProgress->mutexProgress);
+    --pProgress->pWaiterNum[kiRow];
+  }
+  WelsMutexUnlock (&pProgress->mutexProgress);
+}
+
+static int32_t RequestWavefrontMd (SSliceThreading* pSmt, SWelsSvcCodingParam* pCodingParam, CMemoryAlign* pMa) {
+  SWavefrontMd* pWavefront = NULL;
+  int32_t iMaxMbNum        = 0;
+  int32_t iMaxMbHeight     = 0;
+  int32_t iIdx             = 0;
+
+  for (iIdx = 0; iIdx < pCodingParam->iSpatialLayerNum; iIdx++) {
+    const SSpatialLayerConfig* kpDlp = &pCodingParam->sSpatialLayers[iIdx];
+    const int32_t kiMbWidth  = (kpDlp->iVideoWidth + 15) >> 4;
+    const int32_t kiMbHeight = (kpDlp->iVideoHeight + 15) >> 4;
+    if (SM_SINGLE_SLICE != kpDlp->sSliceArgument.uiSliceMode)
+      continue;
+    iMaxMbNum    = WELS_MAX (iMaxMbNum, kiMbWidth * kiMbHeight);
+    iMaxMbHeight = WELS_MAX (iMaxMbHeight, kiMbHeight);
+  }
+  if (0 == iMaxMbNum)
+    return ENC_RETURN_SUCCESS;
+
+  pWavefront = (SWavefrontMd*)pMa->WelsMallocz (sizeof (SWavefrontMd), "SWavefrontMd");
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, (NULL == pWavefront))
+  pSmt->pWavefrontMd = pWavefront;
+
+  pWavefront->iWorkerNum   = pCodingParam->iMultipleThreadIdc;
+  pWavefront->pWorkerSlice = (SSlice*)pMa->WelsMallocz (sizeof (SSlice) * pWavefront->iWorkerNum, "pWorkerSlice");
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, (NULL == pWavefront->pWorkerSlice))
+  if (ENC_RETURN_SUCCESS != InitSliceList (pWavefront->pWorkerSlice, NULL, pWavefront->iWorkerNum,
+      WAVEFRONT_SCRATCH_BS_SIZE, true, pMa))
+    return ENC_RETURN_MEMALLOCERR;
+
+  pWavefront->pMbSyn = (SWavefrontMbSyn*)pMa->WelsMallocz (sizeof (SWavefrontMbSyn) * iMaxMbNum, "pMbSyn");
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, (NULL == pWavefront->pMbSyn))
+  return RowProgressInit (&pWavefront->sProgress, iMaxMbHeight, pMa);
+}
+
+static void ReleaseWavefrontMd (SSliceThreading* pSmt, CMemoryAlign* pMa) {
+  SWavefrontMd* pWavefront = pSmt->pWavefrontMd;
+  if (NULL == pWavefront)
+    return;
+
+  RowProgressUninit (&pWavefront->sProgress, pMa);
+  FreeSliceBuffer (pWavefront->pWorkerSlice, pWavefront->iWorkerNum, pMa, "pWorkerSlice");
+  if (NULL != pWavefront->pMbSyn) {
+    pMa->WelsFree (pWavefront->pMbSyn, "pMbSyn");
+    pWavefront->pMbSyn = NULL;
+  }
+  pMa->WelsFree (pWavefront, "SWavefrontMd");
+  pSmt->pWavefrontMd = NULL;
+}
+
+static int32_t RequestWavefrontDeblocking (SSliceThreading* pSmt, SWelsSvcCodingParam* pCodingParam,
+    CMemoryAlign* pMa) {
+  SWavefrontDeblocking* pWavefront = NULL;
+  int32_t iMaxMbHeight             = 0;
+  int32_t iIdx                     = 0;
+
+  for (iIdx = 0; iIdx < pCodingParam->iSpatialLayerNum; iIdx++) {
+    iMaxMbHeight = WELS_MAX (iMaxMbHeight, (pCodingParam->sSpatialLayers[iIdx].iVideoHeight + 15) >> 4);
+  }
+
+  pWavefront = (SWavefrontDeblocking*)pMa->WelsMallocz (sizeof (SWavefrontDeblocking), "SWavefrontDeblocking");
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, (NULL == pWavefront))
+  pSmt->pWavefrontDeblocking = pWavefront;
+
+  return RowProgressInit (&pWavefront->sProgress, iMaxMbHeight, pMa);
+}
+
+static void ReleaseWavefrontDeblocking (SSliceThreading* pSmt, CMemoryAlign* pMa) {
+  SWavefrontDeblocking* pWavefront = pSmt->pWavefrontDeblocking;
+  if (NULL == pWavefront)
+    return;
+
+  RowProgressUninit (&pWavefront->sProgress, pMa);
+  pMa->WelsFree (pWavefront, "SWavefrontDeblocking");
+  pSmt->pWavefrontDeblocking = NULL;
+}
+
 int32_t RequestMtResource (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pCodingParam, const int32_t iCountBsLen,
                            const int32_t iMaxSliceBufferSize, bool bDynamicSlice) {
   CMemoryAlign* pMa             = NULL;
@@ -354,6 +502,13 @@ int32_t RequestMtResource (sWelsEncCtx** ppCtx, SWelsSvcCodingParam* pCodingPara
   iReturn = WelsMutexInit (& (*ppCtx)->mutexEncoderError);
   WELS_VERIFY_RETURN_IF (1, (WELS_THREAD_ERROR_OK != iReturn))
 
+  if (pPara->bUseWavefrontMd) {
+    iReturn = RequestWavefrontMd (pSmt, pPara, pMa);
+    WELS_VERIFY_RETURN_IF (1, (ENC_RETURN_SUCCESS != iReturn))
+  }
+  iReturn = RequestWavefrontDeblocking (pSmt, pPara, pMa);
+  WELS_VERIFY_RETURN_IF (1, (ENC_RETURN_SUCCESS != iReturn))
+
   MT_TRACE_LOG (pLogCtx, WELS_LOG_INFO, "RequestMtResource(), iThreadNum=%d, iMultipleThreadIdc= %d",
                 pPara->iMultipleThreadIdc,
                 (*ppCtx)->iMaxSliceCount);
@@ -411,6 +566,9 @@ void ReleaseMtResource (sWelsEncCtx** ppCtx) {
   }
   memset (&pSmt->bThreadBsBufferUsage, 0, MAX_THREADS_NUM * sizeof (bool));
 
+  ReleaseWavefrontMd (pSmt, pMa);
+  ReleaseWavefrontDeblocking (pSmt, pMa);
+
   if ((*ppCtx)->pTaskManage != NULL) {
     WELS_DELETE_OP ((*ppCtx)->pTaskManage);
   }
@@ -1011,6 +1011,10 @@ int32_t WelsMdP16x16 (SWelsFuncPtrList* pFunc, SDqLayer* pCurLayer, SWelsMD* pWe
       ++ pSlice->uiMvcNum;
     }
   }
+  //coarse to fine motion vector predictor
+  if (NULL != pCurLayer->pPyramidMe && pCurLayer->pPyramidMe->bMbMvAvailable) {
+    pSlice->sMvc[pSlice->uiMvcNum++] = pCurLayer->pPyramidMe->pMbMv[pCurMb->iMbXY];
+  }
 
   PredMv (&pMbCache->sMvComponents, 0, 4, 0, & (pMe16x16->sMvp));
   pFunc->pfMotionSearch[0] (pFunc, pCurLayer, pMe16x16, pSlice);
@@ -1267,6 +1271,10 @@ void WelsMdInterFinePartition (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SSlice* p
   }
 }
 
+void WelsMdInterFinePartitionNull (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SSlice* pSlice, SMB* pCurMb,
+                                   int32_t iBestCost) {
+}
+
 void WelsMdInterFinePartitionVaa (sWelsEncCtx* pEncCtx, SWelsMD* pWelsMd, SSlice* pSlice, SMB* pCurMb,
                                   int32_t iBestCost) {
   SDqLayer* pCurDqLayer = pEncCtx->pCurDqLayer;
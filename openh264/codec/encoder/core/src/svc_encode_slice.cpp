@@ -46,6 +46,7 @@
 #include "svc_set_mb_syn.h"
 #include "decode_mb_aux.h"
 #include "svc_mode_decision.h"
+#include "slice_multi_threading.h"
 
 namespace WelsEnc {
 //#define ENC_TRACE
@@ -686,6 +687,12 @@ int32_t WelsPSliceMdEnc (sWelsEncCtx* pEncCtx, SSlice* pSlice,  const bool kbIsH
   if (!pEncCtx->pCurDqLayer->bBaseLayerAvailableFlag || !kbIsHighestDlayerFlag)
     memset (&sMd.sMe, 0, sizeof (sMd.sMe));
 
+  //MB-row wavefront MD does not cover the inter-layer prediction of the enhancement layer
+  if (NULL != pEncCtx->pSliceThreading && NULL != pEncCtx->pSliceThreading->pWavefrontMd
+      && !pEncCtx->pCurDqLayer->bBaseLayerAvailableFlag && 0 == kiSliceFirstMbXY
+      && SM_SINGLE_SLICE == pEncCtx->pSvcParam->sSpatialLayers[pEncCtx->uiDependencyId].sSliceArgument.uiSliceMode)
+    return WelsMdInterMbLoopWavefront (pEncCtx, pSlice, &sMd, kiSliceFirstMbXY);
+
   //pMb loop
   return WelsMdInterMbLoop (pEncCtx, pSlice, &sMd, kiSliceFirstMbXY);
 }
@@ -1883,6 +1890,191 @@ TRY_REENCODING:
   return iEncReturn;
 }
 
+static inline void WavefrontSaveMbSyn (SWavefrontMbSyn* pMbSyn, const SMbCache* kpMbCache, const SMB* kpCurMb,
+                                       const int32_t kiCostLuma) {
+  pMbSyn->sMvComponents = kpMbCache->sMvComponents;
+  memcpy (pMbSyn->iNonZeroCoeffCount, kpMbCache->iNonZeroCoeffCount, sizeof (pMbSyn->iNonZeroCoeffCount));
+  memcpy (pMbSyn->sMbMvp, kpMbCache->sMbMvp, sizeof (pMbSyn->sMbMvp));
+  memcpy (pMbSyn->bPrevIntra4x4PredModeFlag, kpMbCache->pPrevIntra4x4PredModeFlag,
+          sizeof (pMbSyn->bPrevIntra4x4PredModeFlag));
+  memcpy (pMbSyn->iRemIntra4x4PredModeFlag, kpMbCache->pRemIntra4x4PredModeFlag,
+          sizeof (pMbSyn->iRemIntra4x4PredModeFlag));
+  memcpy (pMbSyn->bMbTypeSkip, kpMbCache->bMbTypeSkip, sizeof (pMbSyn->bMbTypeSkip));
+  pMbSyn->uiLumaI16x16Mode    = kpMbCache->uiLumaI16x16Mode;
+  pMbSyn->uiChmaI8x8Mode      = kpMbCache->uiChmaI8x8Mode;
+  pMbSyn->bCollocatedPredFlag = kpMbCache->bCollocatedPredFlag;
+  pMbSyn->uiLumaQp            = kpCurMb->uiLumaQp;
+  pMbSyn->uiChromaQp          = kpCurMb->uiChromaQp;
+  pMbSyn->iCostLuma           = kiCostLuma;
+  memcpy (&pMbSyn->sDct, kpMbCache->pDct, sizeof (SDCTCoeff));
+}
+
+static inline void WavefrontRestoreMbSyn (SMbCache* pMbCache, SMB* pCurMb, const SWavefrontMbSyn* kpMbSyn) {
+  pMbCache->sMvComponents = kpMbSyn->sMvComponents;
+  memcpy (pMbCache->iNonZeroCoeffCount, kpMbSyn->iNonZeroCoeffCount, sizeof (kpMbSyn->iNonZeroCoeffCount));
+  memcpy (pMbCache->sMbMvp, kpMbSyn->sMbMvp, sizeof (kpMbSyn->sMbMvp));
+  memcpy (pMbCache->pPrevIntra4x4PredModeFlag, kpMbSyn->bPrevIntra4x4PredModeFlag,
+          sizeof (kpMbSyn->bPrevIntra4x4PredModeFlag));
+  memcpy (pMbCache->pRemIntra4x4PredModeFlag, kpMbSyn->iRemIntra4x4PredModeFlag,
+          sizeof (kpMbSyn->iRemIntra4x4PredModeFlag));
+  memcpy (pMbCache->bMbTypeSkip, kpMbSyn->bMbTypeSkip, sizeof (kpMbSyn->bMbTypeSkip));
+  pMbCache->uiLumaI16x16Mode    = kpMbSyn->uiLumaI16x16Mode;
+  pMbCache->uiChmaI8x8Mode      = kpMbSyn->uiChmaI8x8Mode;
+  pMbCache->bCollocatedPredFlag = kpMbSyn->bCollocatedPredFlag;
+  pCurMb->uiLumaQp              = kpMbSyn->uiLumaQp;
+  pCurMb->uiChromaQp            = kpMbSyn->uiChromaQp;
+  memcpy (pMbCache->pDct, &kpMbSyn->sDct, sizeof (SDCTCoeff));
+}
+
+// worker slices take the slice settings of the coded slice but keep their own MB cache and scratch bs
+static void WavefrontInitWorkerSlice (SSlice* pWorkerSlice, const SSlice* kpSlice) {
+  const SMbCache kWorkerMbCache   = pWorkerSlice->sMbCacheInfo;
+  const SWelsSliceBs kWorkerBs    = pWorkerSlice->sSliceBs;
+
+  memcpy (pWorkerSlice, kpSlice, sizeof (SSlice));
+  pWorkerSlice->sMbCacheInfo      = kWorkerMbCache;
+  pWorkerSlice->sSliceBs          = kWorkerBs;
+  pWorkerSlice->pSliceBsa         = &pWorkerSlice->sSliceBs.sBsWrite;
+}
+
+// for inter single slice: ME/MD run on MB-row wavefronts in the worker threads, see WelsMdInterMbRowsWavefront(),
+// entropy coding and RC stay in raster order here so that the bitstream does not depend on the thread number
+int32_t WelsMdInterMbLoopWavefront (sWelsEncCtx* pEncCtx, SSlice* pSlice, void* pWelsMd,
+                                    const int32_t kiSliceFirstMbXY) {
+  SWavefrontMd* pWavefront = pEncCtx->pSliceThreading->pWavefrontMd;
+  SBitStringAux* pBs    = pSlice->pSliceBsa;
+  SDqLayer* pCurLayer   = pEncCtx->pCurDqLayer;
+  SMbCache* pMbCache    = &pSlice->sMbCacheInfo;
+  SMB* pMbList          = pCurLayer->sMbDataP;
+  SMB* pCurMb           = NULL;
+  const int32_t kiTotalNumMb = pCurLayer->iMbWidth * pCurLayer->iMbHeight;
+  int32_t iCurMbIdx     = kiSliceFirstMbXY;
+  int32_t iIdx          = 0;
+  int32_t iEncReturn    = ENC_RETURN_SUCCESS;
+
+  if (pEncCtx->pSvcParam->iEntropyCodingModeFlag) {
+    WelsInitSliceCabac (pEncCtx, pSlice);
+  }
+  pSlice->iMbSkipRun = 0;
+
+  RowProgressReset (&pWavefront->sProgress, pCurLayer->iMbHeight);
+  pWavefront->pMdTemplate = pWelsMd;
+  for (iIdx = 0; iIdx < pWavefront->iWorkerNum; iIdx++) {
+    WavefrontInitWorkerSlice (&pWavefront->pWorkerSlice[iIdx], pSlice);
+  }
+  pEncCtx->pTaskManage->ExecuteTasksAsync (CWelsBaseTask::WELS_ENC_TASK_WAVEFRONT_MD);
+
+  for (; iCurMbIdx < kiTotalNumMb; iCurMbIdx++) {
+    const SWavefrontMbSyn* kpMbSyn = &pWavefront->pMbSyn[iCurMbIdx];
+    pCurMb = &pMbList[iCurMbIdx];
+    RowProgressWait (&pWavefront->sProgress, pCurMb->iMbY, pCurMb->iMbX + 1);
+
+    //step(1): RC status of the current MB, QP has been decided by the MD worker
+    pEncCtx->pFuncList->pfRc.pfWelsRcMbInit (pEncCtx, pCurMb, pSlice);
+    WavefrontRestoreMbSyn (pMbCache, pCurMb, kpMbSyn);
+
+    //step(2): write bit stream, VLC overflow has been handled by the MD worker
+    iEncReturn = pEncCtx->pFuncList->pfWelsSpatialWriteMbSyn (pEncCtx, pSlice, pCurMb);
+    if (ENC_RETURN_SUCCESS != iEncReturn)
+      break;
+
+    //skip MB takes QP of the last coded MB, which is only known here
+    if (IS_SKIP (pCurMb->uiMbType)) {
+      pEncCtx->pFuncList->pfMdBackgroundInfoUpdate (pCurLayer, pCurMb, kpMbSyn->bCollocatedPredFlag,
+          pEncCtx->pRefPic->iPictureType);
+    }
+
+#if defined(MB_TYPES_CHECK)
+    WelsCountMbType (pEncCtx->sPerInfo.iMbCount, P_SLICE, pCurMb);
+#endif//MB_TYPES_CHECK
+
+    //step(3): update status and other parameters
+    pEncCtx->pFuncList->pfRc.pfWelsRcMbInfoUpdate (pEncCtx, pCurMb, kpMbSyn->iCostLuma, pSlice);
+  }
+
+  //the workers do not depend on the entropy coding, so wait for them also on error
+  pEncCtx->pTaskManage->WaitTasks();
+  if (ENC_RETURN_SUCCESS != iEncReturn)
+    return iEncReturn;
+
+  if (pSlice->iMbSkipRun) {
+    BsWriteUE (pBs, pSlice->iMbSkipRun);
+  }
+
+  return iEncReturn;
+}
+
+void WelsMdInterMbRowsWavefront (sWelsEncCtx* pEncCtx, const int32_t kiWorkerIdx) {
+  SWavefrontMd* pWavefront = pEncCtx->pSliceThreading->pWavefrontMd;
+  SSlice* pSlice        = &pWavefront->pWorkerSlice[kiWorkerIdx];
+  SBitStringAux* pBs    = pSlice->pSliceBsa;
+  SDqLayer* pCurLayer   = pEncCtx->pCurDqLayer;
+  SMbCache* pMbCache    = &pSlice->sMbCacheInfo;
+  SMB* pMbList          = pCurLayer->sMbDataP;
+  SMB* pCurMb           = NULL;
+  const int32_t kiMbWidth  = pCurLayer->iMbWidth;
+  const int32_t kiMbHeight = pCurLayer->iMbHeight;
+  const int32_t kiMvdInterTableStride = pEncCtx->iMvdCostTableStride;
+  uint16_t* pMvdCostTable = &pEncCtx->pMvdCostTable[pEncCtx->iMvdCostTableSize];
+  const int32_t kiSliceIdx = pSlice->iSliceIdx;
+  const uint8_t kuiChromaQpIndexOffset = pCurLayer->sLayerInfo.pPpsP->uiChromaQpIndexOffset;
+  const bool kbCavlc    = !pEncCtx->pSvcParam->iEntropyCodingModeFlag;
+  int32_t iMbX          = 0;
+  int32_t iMbY          = 0;
+  SWelsMD sMd;
+
+  memcpy (&sMd, pWavefront->pMdTemplate, sizeof (SWelsMD));
+
+  for (;;) {
+    iMbY = RowProgressClaimRow (&pWavefront->sProgress);
+    if (iMbY >= kiMbHeight)
+      break;
+
+    for (iMbX = 0; iMbX < kiMbWidth; iMbX++) {
+      pCurMb = &pMbList[iMbY * kiMbWidth + iMbX];
+      //the top-right neighbor has to be reconstructed
+      if (iMbY > 0)
+        RowProgressWait (&pWavefront->sProgress, iMbY - 1, WELS_MIN (iMbX + 2, kiMbWidth));
+
+      //step(1): set QP for the current MB
+      pEncCtx->pFuncList->pfRc.pfWelsRcMbInit (pEncCtx, pCurMb, pSlice);
+
+      //step (2). save some vale for future use, initial pWelsMd
+      WelsMdIntraInit (pEncCtx, pCurMb, pMbCache, 0);
+      WelsMdInterInit (pEncCtx, pSlice, pCurMb, 0);
+
+TRY_REENCODING:
+      WelsInitInterMDStruc (pCurMb, pMvdCostTable, kiMvdInterTableStride, &sMd);
+      pEncCtx->pFuncList->pfInterMd (pEncCtx, &sMd, pSlice, pCurMb, pMbCache);
+
+      //step (4): save from the MD process from future use
+      WelsMdInterSaveSadAndRefMbType ((pCurLayer->pDecPic->uiRefMbType), pMbCache, pCurMb, &sMd);
+
+      pEncCtx->pFuncList->pfMdBackgroundInfoUpdate (pCurLayer, pCurMb, pMbCache->bCollocatedPredFlag,
+          pEncCtx->pRefPic->iPictureType);
+
+      //step (5): update cache
+      UpdateNonZeroCountCache (pCurMb, pMbCache);
+
+      //step (6): CAVLC level overflow depends on the coefficients only, check it on the scratch bs
+      if (kbCavlc && !IS_SKIP (pCurMb->uiMbType) && (pCurMb->uiCbp > 0 || IS_INTRA16x16 (pCurMb->uiMbType))) {
+        InitBits (pBs, pSlice->sSliceBs.pBs, pSlice->sSliceBs.uiSize);
+        if (WelsWriteMbResidual (pEncCtx->pFuncList, pMbCache, pCurMb, pBs) && (pCurMb->uiLumaQp < 50)) {
+          UpdateQpForOverflow (pCurMb, kuiChromaQpIndexOffset);
+          goto TRY_REENCODING;
+        }
+      }
+
+      //step (7): reconstruct current MB
+      pCurMb->uiSliceIdc = kiSliceIdx;
+      OutputPMbWithoutConstructCsRsNoCopy (pEncCtx, pCurLayer, pSlice, pCurMb);
+
+      WavefrontSaveMbSyn (&pWavefront->pMbSyn[pCurMb->iMbXY], pMbCache, pCurMb, sMd.iCostLuma);
+      RowProgressUpdate (&pWavefront->sProgress, iMbY, iMbX + 1);
+    }
+  }
+}
+
 // Only for inter dynamic slicing
 int32_t WelsMdInterMbLoopOverDynamicSlice (sWelsEncCtx* pEncCtx, SSlice* pSlice, void* pWelsMd,
     const int32_t kiSliceFirstMbXY) {
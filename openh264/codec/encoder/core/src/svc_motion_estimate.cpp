@@ -41,6 +41,7 @@
 #include "cpu_core.h"
 #include "ls_defines.h"
 #include "svc_motion_estimate.h"
+#include "picture_handle.h"
 #include "wels_transpose_matrix.h"
 
 namespace WelsEnc {
@@ -222,14 +223,18 @@ void WelsMotionEstimateSearchScrolled (SWelsFuncPtrList* pFuncList, SDqLayer* pC
 bool WelsMotionEstimateInitialPoint (SWelsFuncPtrList* pFuncList, SWelsME* pMe, SSlice* pSlice, int32_t iStrideEnc,
                                      int32_t iStrideRef) {
   PSampleSadSatdCostFunc pSad    = pFuncList->sSampleDealingFuncs.pfSampleSad[pMe->uiBlockSize];
+  PSampleSadMultiFunc pSadMulti  = pFuncList->sSampleDealingFuncs.pfSampleSadMulti[pMe->uiBlockSize];
   const uint16_t* kpMvdCost  = pMe->pMvdCost;
   uint8_t* const kpEncMb    = pMe->pEncMb;
   int16_t iMvc0, iMvc1;
   int32_t iSadCost;
   int32_t iBestSadCost;
   uint8_t* pRefMb;
-  uint8_t* pFref2;
   uint32_t i;
+  SMVUnitXY sCandMv[1 + MAX_MVC_NUM];
+  int32_t iCandOffset[1 + MAX_MVC_NUM];
+  int32_t iCandSad[1 + MAX_MVC_NUM];
+  int32_t iCandNum = 0;
   const uint32_t kuiMvcNum    = pSlice->uiMvcNum;
   const SMVUnitXY* kpMvcList  = &pSlice->sMvc[0];
   const SMVUnitXY ksMvStartMin    = pSlice->sMvStartMin;
@@ -242,10 +247,7 @@ bool WelsMotionEstimateInitialPoint (SWelsFuncPtrList* pFuncList, SWelsME* pMe,
   sMv.iMvX  = WELS_CLIP3 ((2 + ksMvp.iMvX) >> 2, ksMvStartMin.iMvX, ksMvStartMax.iMvX);
   sMv.iMvY  = WELS_CLIP3 ((2 + ksMvp.iMvY) >> 2, ksMvStartMin.iMvY, ksMvStartMax.iMvY);
 
-  pRefMb = &pMe->pRefMb[sMv.iMvY * iStrideRef + sMv.iMvX];
-
-  iBestSadCost = pSad (kpEncMb, iStrideEnc, pRefMb, iStrideRef);
-  iBestSadCost += COST_MVD (kpMvdCost, ((sMv.iMvX) * (1 << 2)) - ksMvp.iMvX, ((sMv.iMvY) * (1 << 2)) - ksMvp.iMvY);
+  sCandMv[iCandNum++] = sMv;
 
   for (i = 0; i < kuiMvcNum; i++) {
     //clipping here is essential since some pOut-of-range MVC may happen here (i.e., refer to baseMV)
@@ -253,17 +255,30 @@ bool WelsMotionEstimateInitialPoint (SWelsFuncPtrList* pFuncList, SWelsME* pMe,
     iMvc1 = WELS_CLIP3 ((2 + kpMvcList[i].iMvY) >> 2, ksMvStartMin.iMvY, ksMvStartMax.iMvY);
 
     if (((iMvc0 - sMv.iMvX) || (iMvc1 - sMv.iMvY))) {
-      pFref2 = &pMe->pRefMb[iMvc1 * iStrideRef + iMvc0];
+      sCandMv[iCandNum].iMvX = iMvc0;
+      sCandMv[iCandNum].iMvY = iMvc1;
+      ++ iCandNum;
+    }
+  }
 
-      iSadCost = pSad (kpEncMb, iStrideEnc, pFref2, iStrideRef) +
-                 COST_MVD (kpMvdCost, (iMvc0 * (1 << 2)) - ksMvp.iMvX, (iMvc1 * (1 << 2)) - ksMvp.iMvY);
+  // all candidates are measured by one batch SAD call and then compared in order, a candidate equal to an earlier one
+  // can not win the strict comparison so it is harmless to measure it twice
+  for (i = 0; i < (uint32_t)iCandNum; i++)
+    iCandOffset[i] = sCandMv[i].iMvY * iStrideRef + sCandMv[i].iMvX;
+  pSadMulti (kpEncMb, iStrideEnc, pMe->pRefMb, iStrideRef, iCandOffset, iCandNum, iCandSad);
 
-      if (iSadCost < iBestSadCost) {
-        sMv.iMvX = iMvc0;
-        sMv.iMvY = iMvc1;
-        pRefMb = pFref2;
-        iBestSadCost = iSadCost;
-      }
+  pRefMb = &pMe->pRefMb[iCandOffset[0]];
+  iBestSadCost = iCandSad[0];
+  iBestSadCost += COST_MVD (kpMvdCost, ((sMv.iMvX) * (1 << 2)) - ksMvp.iMvX, ((sMv.iMvY) * (1 << 2)) - ksMvp.iMvY);
+
+  for (i = 1; i < (uint32_t)iCandNum; i++) {
+    iSadCost = iCandSad[i] +
+               COST_MVD (kpMvdCost, (sCandMv[i].iMvX * (1 << 2)) - ksMvp.iMvX, (sCandMv[i].iMvY * (1 << 2)) - ksMvp.iMvY);
+
+    if (iSadCost < iBestSadCost) {
+      sMv = sCandMv[i];
+      pRefMb = &pMe->pRefMb[iCandOffset[i]];
+      iBestSadCost = iSadCost;
     }
   }
 
@@ -335,6 +350,7 @@ bool WelsMeSadCostSelect (int32_t* iSadCost, const uint16_t* kpMvdCost, int32_t*
 void WelsDiamondSearch (SWelsFuncPtrList* pFuncList, SWelsME* pMe, SSlice* pSlice,
                         const int32_t kiStrideEnc,  const int32_t kiStrideRef) {
   PSample4SadCostFunc      pSad          =  pFuncList->sSampleDealingFuncs.pfSample4Sad[pMe->uiBlockSize];
+  PSampleSadMultiFunc      pSadMulti     =  pFuncList->sSampleDealingFuncs.pfSampleSadMulti[pMe->uiBlockSize];
 
   uint8_t* pFref = pMe->pRefMb;
   uint8_t* const kpEncMb = pMe->pEncMb;
@@ -351,13 +367,31 @@ void WelsDiamondSearch (SWelsFuncPtrList* pFuncList, SWelsME* pMe, SSlice* pSlic
 
   int32_t iTimeThreshold = ITERATIVE_TIMES;
   ENFORCE_STACK_ALIGN_1D (int32_t, iSadCosts, 4, 16)
+  // neighbours in the order of WelsMeSadCostSelect: up, down, left, right
+  const int32_t kiNeighbourOffset[4] = { -kiStrideRef, kiStrideRef, -1, 1 };
+  int32_t iOffsets[3];
+  int32_t iPrevCenter = -1;
 
   while (iTimeThreshold--) {
     pMe->sMv.iMvX = (iMvDx + pMe->sMvp.iMvX) >> 2;
     pMe->sMv.iMvY = (iMvDy + pMe->sMvp.iMvY) >> 2;
     if (!CheckMvInRange (pMe->sMv, ksMvStartMin, ksMvStartMax))
       continue;
-    pSad (kpEncMb, kiStrideEnc, pRefMb, kiStrideRef, &iSadCosts[0]);
+    if (iPrevCenter < 0) {
+      pSad (kpEncMb, kiStrideEnc, pRefMb, kiStrideRef, &iSadCosts[0]);
+    } else {
+      // the previous center costs more than the current one and can not be selected again,
+      // so only the other three neighbours are measured in one batch
+      int32_t iNum = 0;
+      for (int32_t i = 0; i < 4; i++) {
+        if (i != iPrevCenter)
+          iOffsets[iNum++] = kiNeighbourOffset[i];
+      }
+      pSadMulti (kpEncMb, kiStrideEnc, pRefMb, kiStrideRef, iOffsets, 3, &iSadCosts[0]);
+      for (int32_t i = 3; i > iPrevCenter; i--)
+        iSadCosts[i] = iSadCosts[i - 1];
+      iSadCosts[iPrevCenter] = iBestCost;
+    }
 
     int32_t iX, iY;
 
@@ -365,6 +399,9 @@ void WelsDiamondSearch (SWelsFuncPtrList* pFuncList, SWelsME* pMe, SSlice* pSlic
     if (kbIsBestCostWorse)
       break;
 
+    // the center moves to the selected neighbour, the old center is its opposite neighbour
+    iPrevCenter = (iY == 1) ? 1 : (iY == -1) ? 0 : (iX == 1) ? 3 : 2;
+
     iMvDx -= (iX * (1 << 2)) ;
     iMvDy -= (iY * (1 << 2)) ;
 
@@ -412,6 +449,36 @@ bool CheckDirectionalMvFalse (PSampleSadSatdCostFunc pSad, SWelsME* vpMe,
 /////////////////////////
 // Cross Search Basics
 /////////////////////////
+/*!
+ * \brief  measure the positions [iTargetPos, kiMaxPos) of one search line by batch SAD calls,
+ *         pRef and pMvdCost belong to iTargetPos, kiStep is the distance of two positions in the reference
+ */
+static void LineSearchBySadMulti (PSampleSadMultiFunc pSadMulti, uint8_t* pEncMb, const int32_t kiEncStride,
+                                  uint8_t* pRef, const int32_t kiRefStride, const int32_t kiStep,
+                                  int32_t iTargetPos, const int32_t kiMaxPos,
+                                  const uint16_t* pMvdCost, const int32_t kiFixedMvd,
+                                  uint32_t& uiBestCost, int32_t& iBestPos) {
+  int32_t iOffsets[SAD_MULTI_BATCH_NUM];
+  int32_t iSadCosts[SAD_MULTI_BATCH_NUM];
+  for (int32_t i = 0; i < SAD_MULTI_BATCH_NUM; i++)
+    iOffsets[i] = i * kiStep;
+
+  while (iTargetPos < kiMaxPos) {
+    const int32_t kiNum = WELS_MIN (SAD_MULTI_BATCH_NUM, kiMaxPos - iTargetPos);
+    pSadMulti (pEncMb, kiEncStride, pRef, kiRefStride, iOffsets, kiNum, iSadCosts);
+    for (int32_t i = 0; i < kiNum; i++) {
+      const uint32_t kuiSadCost = iSadCosts[i] + (kiFixedMvd + pMvdCost[i * (1 << 2)]);
+      if (kuiSadCost < uiBestCost) {
+        uiBestCost = kuiSadCost;
+        iBestPos = iTargetPos + i;
+      }
+    }
+    iTargetPos += kiNum;
+    pRef += kiNum * kiStep;
+    pMvdCost += kiNum * (1 << 2);
+  }
+}
+
 #if defined (X86_ASM)
 void CalcMvdCostx8_c (uint16_t* pMvdCost, const int32_t kiStartMv, uint16_t* pMvdTable, const uint16_t kiFixedCost) {
   uint16_t* pBaseCost  = pMvdCost;
@@ -443,7 +510,7 @@ void VerticalFullSearchUsingSSE41 (SWelsFuncPtrList* pFuncList, SWelsME* pMe,
   const int32_t kIsBlock16x16 = pMe->uiBlockSize == BLOCK_16x16;
   const int32_t kiEdgeBlocks = kIsBlock16x16 ? 16 : 8;
   PSampleSadHor8Func pSampleSadHor8 = pFuncList->pfSampleSadHor8[kIsBlock16x16];
-  PSampleSadSatdCostFunc pSad = pFuncList->sSampleDealingFuncs.pfSampleSad[pMe->uiBlockSize];
+  PSampleSadMultiFunc pSadMulti = pFuncList->sSampleDealingFuncs.pfSampleSadMulti[pMe->uiBlockSize];
   PTransposeMatrixBlockFunc TransposeMatrixBlock = kIsBlock16x16 ? TransposeMatrixBlock16x16_sse2 :
       TransposeMatrixBlock8x8_mmx;
   PTransposeMatrixBlocksFunc TransposeMatrixBlocks = kIsBlock16x16 ? TransposeMatrixBlocksx16_sse2 :
@@ -463,7 +530,7 @@ void VerticalFullSearchUsingSSE41 (SWelsFuncPtrList* pFuncList, SWelsME* pMe,
   TransposeMatrixBlocks (&uiMatrixRef[0][0], kiMatrixStride, pRef, kiRefStride, kiBlocksNum);
   ENFORCE_STACK_ALIGN_1D (uint16_t, uiBaseCost, 8, 16);
   int32_t iTargetPos   = iMinPos;
-  int16_t iBestPos    = pMe->sMv.iMvX;
+  int32_t iBestPos    = pMe->sMv.iMvX;
   uint32_t uiBestCost   = pMe->uiSadCost;
   uint32_t uiCostMin;
   int32_t iIndexMinPos;
@@ -485,17 +552,8 @@ void VerticalFullSearchUsingSSE41 (SWelsFuncPtrList* pFuncList, SWelsME* pMe,
   if (kiRemainingVectors > 0) {
     kpEncMb = pMe->pEncMb;
     pRef = &pMe->pColoRefMb[ (iTargetPos - kiCurMeBlockPix) * kiRefStride];
-    while (iTargetPos < iMaxPos) {
-      const uint16_t uiMvdCost = pMvdCost[iStartMv * (1 << 2)];
-      uint32_t uiSadCost = pSad (kpEncMb, kiEncStride, pRef, kiRefStride) + (iFixedMvd + uiMvdCost);
-      if (uiSadCost < uiBestCost) {
-        uiBestCost = uiSadCost;
-        iBestPos = iTargetPos;
-      }
-      iStartMv++;
-      pRef += kiRefStride;
-      ++iTargetPos;
-    }
+    LineSearchBySadMulti (pSadMulti, kpEncMb, kiEncStride, pRef, kiRefStride, kiRefStride, iTargetPos, iMaxPos,
+                          &pMvdCost[iStartMv * (1 << 2)], iFixedMvd, uiBestCost, iBestPos);
   }
   if (uiBestCost < pMe->uiSadCost) {
     SMVUnitXY sBestMv;
@@ -521,13 +579,13 @@ void HorizontalFullSearchUsingSSE41 (SWelsFuncPtrList* pFuncList, SWelsME* pMe,
   uint8_t* pRef         = &pMe->pColoRefMb[kiMinMv];
   const int32_t kIsBlock16x16 = pMe->uiBlockSize == BLOCK_16x16;
   PSampleSadHor8Func pSampleSadHor8 = pFuncList->pfSampleSadHor8[kIsBlock16x16];
-  PSampleSadSatdCostFunc pSad = pFuncList->sSampleDealingFuncs.pfSampleSad[pMe->uiBlockSize];
+  PSampleSadMultiFunc pSadMulti = pFuncList->sSampleDealingFuncs.pfSampleSadMulti[pMe->uiBlockSize];
   ENFORCE_STACK_ALIGN_1D (uint16_t, uiBaseCost, 8, 16);
   const int32_t kiNumVector = iMaxPos - iMinPos;
   int32_t iCountLoop8 = kiNumVector >> 3;
   const int32_t kiRemainingLoop8 = kiNumVector & 7;
   int32_t iTargetPos   = iMinPos;
-  int16_t iBestPos    = pMe->sMv.iMvX;
+  int32_t iBestPos    = pMe->sMv.iMvX;
   uint32_t uiBestCost   = pMe->uiSadCost;
   uint32_t uiCostMin;
   int32_t iIndexMinPos;
@@ -545,17 +603,8 @@ void HorizontalFullSearchUsingSSE41 (SWelsFuncPtrList* pFuncList, SWelsME* pMe,
     -- iCountLoop8;
   }
   if (kiRemainingLoop8 > 0) {
-    while (iTargetPos < iMaxPos) {
-      const uint16_t uiMvdCost = pMvdCost[iStartMv * (1 << 2)];
-      uint32_t uiSadCost = pSad (kpEncMb, kiEncStride, pRef, kiRefStride) + (iFixedMvd + uiMvdCost);
-      if (uiSadCost < uiBestCost) {
-        uiBestCost = uiSadCost;
-        iBestPos = iTargetPos;
-      }
-      iStartMv++;
-      ++pRef;
-      ++iTargetPos;
-    }
+    LineSearchBySadMulti (pSadMulti, kpEncMb, kiEncStride, pRef, kiRefStride, 1, iTargetPos, iMaxPos,
+                          &pMvdCost[iStartMv * (1 << 2)], iFixedMvd, uiBestCost, iBestPos);
   }
   if (uiBestCost < pMe->uiSadCost) {
     SMVUnitXY sBestMv;
@@ -570,7 +619,7 @@ void LineFullSearch_c (SWelsFuncPtrList* pFuncList, SWelsME* pMe,
                        const int32_t kiEncStride, const int32_t kiRefStride,
                        const int16_t iMinMv, const int16_t iMaxMv,
                        const bool bVerticalSearch) {
-  PSampleSadSatdCostFunc pSad = pFuncList->sSampleDealingFuncs.pfSampleSad[pMe->uiBlockSize];
+  PSampleSadMultiFunc pSadMulti = pFuncList->sSampleDealingFuncs.pfSampleSadMulti[pMe->uiBlockSize];
   const int32_t kiCurMeBlockPixX = pMe->iCurMeBlockPixX;
   const int32_t kiCurMeBlockPixY = pMe->iCurMeBlockPixY;
   int32_t iMinPos, iMaxPos;
@@ -598,16 +647,8 @@ void LineFullSearch_c (SWelsFuncPtrList* pFuncList, SWelsME* pMe,
   uint32_t uiBestCost    = 0xFFFFFFFF;
   int32_t iBestPos       = 0;
 
-  for (int32_t iTargetPos = iMinPos; iTargetPos < iMaxPos; ++ iTargetPos) {
-    uint8_t* const kpEncMb  = pMe->pEncMb;
-    uint32_t uiSadCost = pSad (kpEncMb, kiEncStride, pRef, kiRefStride) + (iFixedMvd + *pMvdCost);
-    if (uiSadCost < uiBestCost) {
-      uiBestCost  = uiSadCost;
-      iBestPos  = iTargetPos;
-    }
-    pRef += iStride;
-    pMvdCost += 4;
-  }
+  LineSearchBySadMulti (pSadMulti, pMe->pEncMb, kiEncStride, pRef, kiRefStride, iStride, iMinPos, iMaxPos,
+                        pMvdCost, iFixedMvd, uiBestCost, iBestPos);
 
   if (uiBestCost < pMe->uiSadCost) {
     SMVUnitXY sBestMv;
@@ -680,6 +721,144 @@ int32_t ReleaseFeatureSearchPreparation (CMemoryAlign* pMa, uint16_t*& pFeatureO
   return ENC_RETURN_UNEXPECTED;
 }
 
+/////////////////////////
+// Pyramid Search Basics
+/////////////////////////
+int32_t RequestPyramidMeStorage (CMemoryAlign* pMa, const int32_t kiMbWidth, const int32_t kiMbHeight,
+                                 SPyramidMeStorage* pPyramidMe) {
+  const int32_t kiGroupCount = ((kiMbWidth + 1) >> 1) * ((kiMbHeight + 1) >> 1);
+  pPyramidMe->pCoarseMv = (SMVUnitXY*)pMa->WelsMallocz (kiGroupCount * sizeof (SMVUnitXY), "pPyramidMe->pCoarseMv");
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pPyramidMe->pCoarseMv)
+  pPyramidMe->pMbMv = (SMVUnitXY*)pMa->WelsMallocz (kiMbWidth * kiMbHeight * sizeof (SMVUnitXY), "pPyramidMe->pMbMv");
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pPyramidMe->pMbMv)
+  pPyramidMe->bMbMvAvailable = false;
+
+  return ENC_RETURN_SUCCESS;
+}
+void ReleasePyramidMeStorage (CMemoryAlign* pMa, SPyramidMeStorage* pPyramidMe) {
+  if (pPyramidMe->pCoarseMv) {
+    pMa->WelsFree (pPyramidMe->pCoarseMv, "pPyramidMe->pCoarseMv");
+    pPyramidMe->pCoarseMv = NULL;
+  }
+  if (pPyramidMe->pMbMv) {
+    pMa->WelsFree (pPyramidMe->pMbMv, "pPyramidMe->pMbMv");
+    pPyramidMe->pMbMv = NULL;
+  }
+  pPyramidMe->bMbMvAvailable = false;
+}
+
+//8x8 full search of the window kiRange around ksCenter limited to [ksMin, ksMax], pure SAD with the earlier point kept on ties
+void PyramidBlockSearch (PSampleSadMultiFunc pSadMulti, uint8_t* pCur, const int32_t kiCurStride,
+                         uint8_t* pRef, const int32_t kiRefStride, const SMVUnitXY ksCenter, const int32_t kiRange,
+                         const SMVUnitXY ksMin, const SMVUnitXY ksMax, SMVUnitXY& sBestMv, int32_t& iBestSad) {
+  int32_t iOffset[SAD_MULTI_BATCH_NUM];
+  int32_t iSad[SAD_MULTI_BATCH_NUM];
+  const int32_t kiMinX = WELS_MAX (ksCenter.iMvX - kiRange, ksMin.iMvX);
+  const int32_t kiMaxX = WELS_MIN (ksCenter.iMvX + kiRange, ksMax.iMvX);
+  const int32_t kiMinY = WELS_MAX (ksCenter.iMvY - kiRange, ksMin.iMvY);
+  const int32_t kiMaxY = WELS_MIN (ksCenter.iMvY + kiRange, ksMax.iMvY);
+
+  for (int32_t iY = kiMinY; iY <= kiMaxY; iY++) {
+    for (int32_t iX = kiMinX; iX <= kiMaxX; iX += SAD_MULTI_BATCH_NUM) {
+      const int32_t kiCount = WELS_MIN (SAD_MULTI_BATCH_NUM, kiMaxX - iX + 1);
+      for (int32_t i = 0; i < kiCount; i++)
+        iOffset[i] = iY * kiRefStride + iX + i;
+      pSadMulti (pCur, kiCurStride, pRef, kiRefStride, iOffset, kiCount, iSad);
+      for (int32_t i = 0; i < kiCount; i++) {
+        if (iSad[i] < iBestSad) {
+          iBestSad = iSad[i];
+          sBestMv.iMvX = iX + i;
+          sBestMv.iMvY = iY;
+        }
+      }
+    }
+  }
+}
+
+void PerformPyramidMotionSearch (SWelsFuncPtrList* pFuncList, SPyramidMeStorage* pPyramidMe, SPicture** ppCurPlane,
+                                 SPicture** ppRefPlane, const int32_t kiMbWidth, const int32_t kiMbHeight, const int32_t kiMvRange) {
+  PSampleSadMultiFunc pSadMulti = pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x8];
+  const SMVUnitXY ksZeroMv = {0, 0};
+  const int32_t kiGroupWidth = (kiMbWidth + 1) >> 1;
+  const int32_t kiGroupHeight = (kiMbHeight + 1) >> 1;
+  SMVUnitXY sMin, sMax, sMv;
+  int32_t iBestSad;
+
+  pPyramidMe->bMbMvAvailable = false;
+  if (kiMbWidth < 2 || kiMbHeight < 2) //no 8x8 block fits the 1/4 size plane
+    return;
+
+  //  Step 1: full search of every 8x8 block of the 1/4 size plane, each covering 2x2 MBs,
+  //  the vectors of the left and top blocks are refined as well to follow large motion
+  SPicture* pCurPlane = ppCurPlane[1];
+  SPicture* pRefPlane = ppRefPlane[1];
+  int32_t iPlaneWidth = kiMbWidth << 2;
+  int32_t iPlaneHeight = kiMbHeight << 2;
+  int32_t iRange = kiMvRange >> 2;
+  for (int32_t iGroupY = 0; iGroupY < kiGroupHeight; iGroupY++) {
+    const int32_t kiPixY = WELS_MIN (iGroupY << 3, iPlaneHeight - 8);
+    for (int32_t iGroupX = 0; iGroupX < kiGroupWidth; iGroupX++) {
+      const int32_t kiPixX = WELS_MIN (iGroupX << 3, iPlaneWidth - 8);
+      const int32_t kiGroupXY = iGroupY * kiGroupWidth + iGroupX;
+      uint8_t* pCur = pCurPlane->pData[0] + kiPixY * pCurPlane->iLineSize[0] + kiPixX;
+      uint8_t* pRef = pRefPlane->pData[0] + kiPixY * pRefPlane->iLineSize[0] + kiPixX;
+      sMin.iMvX = WELS_MAX (-kiPixX, -iRange);
+      sMin.iMvY = WELS_MAX (-kiPixY, -iRange);
+      sMax.iMvX = WELS_MIN (iPlaneWidth - 8 - kiPixX, iRange);
+      sMax.iMvY = WELS_MIN (iPlaneHeight - 8 - kiPixY, iRange);
+
+      sMv = ksZeroMv;
+      iBestSad = INT_MAX;
+      PyramidBlockSearch (pSadMulti, pCur, pCurPlane->iLineSize[0], pRef, pRefPlane->iLineSize[0], ksZeroMv, 0, sMin, sMax,
+                          sMv, iBestSad);
+      PyramidBlockSearch (pSadMulti, pCur, pCurPlane->iLineSize[0], pRef, pRefPlane->iLineSize[0], ksZeroMv,
+                          PYRAMID_ME_COARSE_RANGE, sMin, sMax, sMv, iBestSad);
+      if (iGroupX > 0)
+        PyramidBlockSearch (pSadMulti, pCur, pCurPlane->iLineSize[0], pRef, pRefPlane->iLineSize[0],
+                            pPyramidMe->pCoarseMv[kiGroupXY - 1], PYRAMID_ME_REFINE_RANGE, sMin, sMax, sMv, iBestSad);
+      if (iGroupY > 0)
+        PyramidBlockSearch (pSadMulti, pCur, pCurPlane->iLineSize[0], pRef, pRefPlane->iLineSize[0],
+                            pPyramidMe->pCoarseMv[kiGroupXY - kiGroupWidth], PYRAMID_ME_REFINE_RANGE, sMin, sMax, sMv,
+                            iBestSad);
+      pPyramidMe->pCoarseMv[kiGroupXY] = sMv;
+    }
+  }
+
+  //  Step 2: refine the scaled vector of every MB on the 1/2 size plane
+  pCurPlane = ppCurPlane[0];
+  pRefPlane = ppRefPlane[0];
+  iPlaneWidth = kiMbWidth << 3;
+  iPlaneHeight = kiMbHeight << 3;
+  iRange = kiMvRange >> 1;
+  for (int32_t iMbY = 0; iMbY < kiMbHeight; iMbY++) {
+    const int32_t kiPixY = iMbY << 3;
+    for (int32_t iMbX = 0; iMbX < kiMbWidth; iMbX++) {
+      const int32_t kiPixX = iMbX << 3;
+      const SMVUnitXY ksCoarseMv = pPyramidMe->pCoarseMv[ (iMbY >> 1) * kiGroupWidth + (iMbX >> 1)];
+      uint8_t* pCur = pCurPlane->pData[0] + kiPixY * pCurPlane->iLineSize[0] + kiPixX;
+      uint8_t* pRef = pRefPlane->pData[0] + kiPixY * pRefPlane->iLineSize[0] + kiPixX;
+      SMVUnitXY sCenter;
+      sMin.iMvX = WELS_MAX (-kiPixX, -iRange);
+      sMin.iMvY = WELS_MAX (-kiPixY, -iRange);
+      sMax.iMvX = WELS_MIN (iPlaneWidth - 8 - kiPixX, iRange);
+      sMax.iMvY = WELS_MIN (iPlaneHeight - 8 - kiPixY, iRange);
+      sCenter.iMvX = WELS_CLIP3 (ksCoarseMv.iMvX * 2, sMin.iMvX, sMax.iMvX);
+      sCenter.iMvY = WELS_CLIP3 (ksCoarseMv.iMvY * 2, sMin.iMvY, sMax.iMvY);
+
+      sMv = sCenter;
+      iBestSad = INT_MAX;
+      PyramidBlockSearch (pSadMulti, pCur, pCurPlane->iLineSize[0], pRef, pRefPlane->iLineSize[0], sCenter, 0, sMin, sMax,
+                          sMv, iBestSad);
+      PyramidBlockSearch (pSadMulti, pCur, pCurPlane->iLineSize[0], pRef, pRefPlane->iLineSize[0], sCenter,
+                          PYRAMID_ME_REFINE_RANGE, sMin, sMax, sMv, iBestSad);
+      //to quarter pel of the layer
+      pPyramidMe->pMbMv[iMbY * kiMbWidth + iMbX].iMvX = sMv.iMvX * (1 << 3);
+      pPyramidMe->pMbMv[iMbY * kiMbWidth + iMbX].iMvY = sMv.iMvY * (1 << 3);
+    }
+  }
+  pPyramidMe->bMbMvAvailable = true;
+}
+
 int32_t RequestScreenBlockFeatureStorage (CMemoryAlign* pMa, const int32_t kiFrameWidth,  const int32_t kiFrameHeight,
     const int32_t iNeedFeatureStorage,
     SScreenBlockFeatureStorage* pScreenBlockFeatureStorage) {
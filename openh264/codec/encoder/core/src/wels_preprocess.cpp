@@ -35,6 +35,7 @@
 #include "encoder_context.h"
 #include "utils.h"
 #include "encoder.h"
+#include "svc_motion_estimate.h"
 
 namespace {
 
@@ -107,20 +108,36 @@ CWelsPreProcess* CWelsPreProcess::CreatePreProcess (sWelsEncCtx* pEncCtx) {
 
 CWelsPreProcess::CWelsPreProcess (sWelsEncCtx* pEncCtx) {
   m_pInterfaceVp = NULL;
+  m_pLookaheadVp = NULL;
   m_bInitDone = false;
   m_pEncCtx = pEncCtx;
   memset (&m_sScaledPicture, 0, sizeof (m_sScaledPicture));
+  memset (&m_sStagedScaledPicture, 0, sizeof (m_sStagedScaledPicture));
   memset (m_pSpatialPic, 0, sizeof (m_pSpatialPic));
+  memset (m_pStagedPic, 0, sizeof (m_pStagedPic));
+  memset (m_sStagedSrcPic, 0, sizeof (m_sStagedSrcPic));
+  memset (m_sLookahead, 0, sizeof (m_sLookahead));
+  m_iStagedSetNum = 0;
+  m_iStagedDepth = 0;
+  m_iStagedHead = 0;
+  m_iStagedCount = 0;
+  m_iLastAnalyzedSet = -1;
+  m_bPendingSceneCut = false;
+  memset (m_sStagedVaa, 0, sizeof (m_sStagedVaa));
+  m_pLastStagedPic = NULL;
+  m_iCurStagedSet = -1;
   memset (m_uiSpatialLayersInTemporal, 0, sizeof (m_uiSpatialLayersInTemporal));
   memset (m_uiSpatialPicNum, 0, sizeof (m_uiSpatialPicNum));
 }
 
 CWelsPreProcess::~CWelsPreProcess() {
   FreeScaledPic (&m_sScaledPicture,  m_pEncCtx->pMemAlign);
+  FreeScaledPic (&m_sStagedScaledPicture,  m_pEncCtx->pMemAlign);
   WelsPreprocessDestroy();
 }
 
 int32_t CWelsPreProcess::WelsPreprocessCreate() {
+  SWelsSvcCodingParam* pSvcParam = m_pEncCtx->pSvcParam;
   if (m_pInterfaceVp == NULL) {
     WelsCreateVpInterface ((void**) &m_pInterfaceVp, WELSVP_INTERFACE_VERION);
     if (!m_pInterfaceVp)
@@ -128,6 +145,13 @@ int32_t CWelsPreProcess::WelsPreprocessCreate() {
   } else
     goto exit;
 
+  // the staging of the next input runs next to the encoding, it must not share the processing state with it
+  if (pSvcParam->bEnableFramePipeline || pSvcParam->iLookaheadFrames > 0) {
+    WelsCreateVpInterface ((void**) &m_pLookaheadVp, WELSVP_INTERFACE_VERION);
+    if (!m_pLookaheadVp)
+      goto exit;
+  }
+
   return 0;
 
 exit:
@@ -138,6 +162,10 @@ exit:
 int32_t CWelsPreProcess::WelsPreprocessDestroy() {
   WelsDestroyVpInterface (m_pInterfaceVp, WELSVP_INTERFACE_VERION);
   m_pInterfaceVp = NULL;
+  if (m_pLookaheadVp) {
+    WelsDestroyVpInterface (m_pLookaheadVp, WELSVP_INTERFACE_VERION);
+    m_pLookaheadVp = NULL;
+  }
 
   return 0;
 }
@@ -157,8 +185,11 @@ int32_t CWelsPreProcess::WelsPreprocessReset (sWelsEncCtx* pCtx, int32_t iWidth,
   }
   if (pCtx) {
     FreeScaledPic (&m_sScaledPicture, pCtx->pMemAlign);
+    FreeScaledPic (&m_sStagedScaledPicture, pCtx->pMemAlign);
     iRet = InitLastSpatialPictures (pCtx);
     iRet = WelsInitScaledPic (pCtx->pSvcParam, &m_sScaledPicture, pCtx->pMemAlign);
+    if (0 == iRet && (pSvcParam->bEnableFramePipeline || pSvcParam->iLookaheadFrames > 0))
+      iRet = WelsInitScaledPic (pCtx->pSvcParam, &m_sStagedScaledPicture, pCtx->pMemAlign);
   }
 
   return iRet;
@@ -169,6 +200,20 @@ int32_t CWelsPreProcess::AllocSpatialPictures (sWelsEncCtx* pCtx, SWelsSvcCoding
   const int32_t kiDlayerCount   = pParam->iSpatialLayerNum;
   int32_t iDlayerIndex          = 0;
 
+  // the lookahead queues as many sets as it analyses, the frame pipeline one, plus the set the next input goes into
+  if (pParam->bEnableFramePipeline || pParam->iLookaheadFrames > 0) {
+    m_iStagedDepth  = WELS_MAX (pParam->iLookaheadFrames, 1);
+    m_iStagedSetNum = m_iStagedDepth + 1;
+  } else {
+    m_iStagedDepth  = 0;
+    m_iStagedSetNum = 0;
+  }
+  m_iStagedHead = m_iStagedCount = 0;
+  m_iLastAnalyzedSet = -1;
+  m_bPendingSceneCut = false;
+  m_pLastStagedPic = NULL;
+  m_iCurStagedSet = -1;
+
   // spatial pictures
   iDlayerIndex = 0;
   do {
@@ -186,6 +231,12 @@ int32_t CWelsPreProcess::AllocSpatialPictures (sWelsEncCtx* pCtx, SWelsSvcCoding
       ++ i;
     } while (i < kuiRefNumInTemporal);
 
+    for (int32_t iSet = 0; iSet < m_iStagedSetNum; iSet++) {
+      SPicture* pPic = AllocPicture (pMa, kiPicWidth, kiPicHeight, false, 0);
+      WELS_VERIFY_RETURN_IF (1, (NULL == pPic))
+      m_pStagedPic[iSet][iDlayerIndex] = pPic;
+    }
+
     if (pParam->iUsageType == SCREEN_CONTENT_REAL_TIME)
       m_uiSpatialLayersInTemporal[iDlayerIndex] = 1;
     else
@@ -194,7 +245,18 @@ int32_t CWelsPreProcess::AllocSpatialPictures (sWelsEncCtx* pCtx, SWelsSvcCoding
     ++ iDlayerIndex;
   } while (iDlayerIndex < kiDlayerCount);
 
-  return 0;
+  // 1/2 size luma of the highest spatial layer, analysed by the lookahead
+  if (pParam->iLookaheadFrames > 0) {
+    const int32_t kiMbWidth  = (pParam->sSpatialLayers[kiDlayerCount - 1].iVideoWidth + 15) >> 4;
+    const int32_t kiMbHeight = (pParam->sSpatialLayers[kiDlayerCount - 1].iVideoHeight + 15) >> 4;
+    for (int32_t iSet = 0; iSet < m_iStagedSetNum; iSet++) {
+      SPicture* pPic = AllocPicture (pMa, kiMbWidth << 3, kiMbHeight << 3, false, 0);
+      WELS_VERIFY_RETURN_IF (1, (NULL == pPic))
+      m_sLookahead[iSet].pLowResPic = pPic;
+    }
+  }
+
+  return AllocStagedVaa (pCtx, pParam);
 }
 
 void CWelsPreProcess::FreeSpatialPictures (sWelsEncCtx* pCtx) {
@@ -210,14 +272,28 @@ void CWelsPreProcess::FreeSpatialPictures (sWelsEncCtx* pCtx) {
       }
       ++ i;
     }
+    for (i = 0; i < MAX_STAGED_SET_NUM; i++) {
+      if (NULL != m_pStagedPic[i][j]) {
+        FreePicture (pMa, &m_pStagedPic[i][j]);
+      }
+    }
     m_uiSpatialLayersInTemporal[j] = 0;
     ++ j;
   }
+  for (int32_t iSet = 0; iSet < MAX_STAGED_SET_NUM; iSet++) {
+    if (NULL != m_sLookahead[iSet].pLowResPic) {
+      FreePicture (pMa, &m_sLookahead[iSet].pLowResPic);
+    }
+  }
+  FreeStagedVaa (pCtx);
+  m_iStagedHead = m_iStagedCount = 0;
+  m_iLastAnalyzedSet = -1;
+  m_pLastStagedPic = NULL;
+  m_iCurStagedSet = -1;
 }
 
-int32_t CWelsPreProcess::BuildSpatialPicList (sWelsEncCtx* pCtx, const SSourcePicture* kpSrcPic) {
+int32_t CWelsPreProcess::InitSourceSize (sWelsEncCtx* pCtx, const SSourcePicture* kpSrcPic) {
   SWelsSvcCodingParam* pSvcParam = pCtx->pSvcParam;
-  int32_t iSpatialNum = 0;
   int32_t iWidth = ((kpSrcPic->iPicWidth >> 1) << 1);
   int32_t iHeight = ((kpSrcPic->iPicHeight >> 1) << 1);
 
@@ -240,6 +316,14 @@ int32_t CWelsPreProcess::BuildSpatialPicList (sWelsEncCtx* pCtx, const SSourcePi
 
   if (m_pInterfaceVp == NULL)
     return -1;
+  return 0;
+}
+
+int32_t CWelsPreProcess::BuildSpatialPicList (sWelsEncCtx* pCtx, const SSourcePicture* kpSrcPic) {
+  int32_t iSpatialNum = 0;
+
+  if (InitSourceSize (pCtx, kpSrcPic) != 0)
+    return -1;
 
   pCtx->pVaa->bSceneChangeFlag = pCtx->pVaa->bIdrPeriodFlag = false;
 
@@ -248,6 +332,36 @@ int32_t CWelsPreProcess::BuildSpatialPicList (sWelsEncCtx* pCtx, const SSourcePi
   return iSpatialNum;
 }
 
+/*!
+ * \brief   expose the source picture the next BuildSpatialPicList() moves the input into
+ *          a caller filling it in place and passing it back to EncodeFrame() saves that copy; the buffer
+ *          rotates with the encoder's source list, so it must be queried again before every frame
+ * \return  0 - pSrcPic describes the internal I420 buffer; 1 - not available as input needs scaling or is pipelined
+ */
+int32_t CWelsPreProcess::GetSourceBuffer (sWelsEncCtx* pCtx, SSourcePicture* pSrcPic) {
+  SWelsSvcCodingParam* pSvcParam = pCtx->pSvcParam;
+  const int32_t kiDid = pSvcParam->iSpatialLayerNum - 1;
+
+  // a staged picture is not scaled into the encoder's source list
+  if (NULL != m_sScaledPicture.pScaledInputPicture || m_iStagedSetNum > 0)
+    return 1;
+
+  SPicture* pPic = GetCurrentOrigFrame (kiDid);
+  if (NULL == pPic)
+    return 1;
+
+  pSrcPic->iColorFormat = videoFormatI420;
+  pSrcPic->iPicWidth    = pSvcParam->sSpatialLayers[kiDid].iVideoWidth;
+  pSrcPic->iPicHeight   = pSvcParam->sSpatialLayers[kiDid].iVideoHeight;
+  for (int32_t i = 0; i < 3; i++) {
+    pSrcPic->pData[i]   = pPic->pData[i];
+    pSrcPic->iStride[i] = pPic->iLineSize[i];
+  }
+  pSrcPic->pData[3]     = NULL;
+  pSrcPic->iStride[3]   = 0;
+  return 0;
+}
+
 SPicture* CWelsPreProcess::GetBestRefPic (EUsageType iUsageType, bool bSceneLtr, EWelsSliceType eSliceType,
     int32_t kiDidx, int32_t iRefTemporalIdx) {
   assert (iUsageType == SCREEN_CONTENT_REAL_TIME);
@@ -257,6 +371,7 @@ SPicture* CWelsPreProcess::GetBestRefPic (EUsageType iUsageType, bool bSceneLtr,
   return m_pSpatialPic[0][BestRefCandidateParam->iSrcListIdx];
 
 }
+
 SPicture* CWelsPreProcess::GetBestRefPic (const int32_t kiDidx, const int32_t iRefTemporalIdx) {
 
   return m_pSpatialPic[kiDidx][iRefTemporalIdx];
@@ -281,27 +396,38 @@ int32_t CWelsPreProcess::AnalyzeSpatialPic (sWelsEncCtx* pCtx, const int32_t kiD
     SPicture* pRefPic = GetBestRefPic (pSvcParam->iUsageType, pCtx->bCurFrameMarkedAsSceneLtr, pCtx->eSliceType, kiDidx,
                                        iRefTemporalIdx);
 
-    VaaCalculation (pCtx->pVaa, pCurPic, pRefPic, false, bCalculateVar, bCalculateBGD);
+    VaaCalculation (m_pInterfaceVp, pCtx->pVaa, pCurPic, pRefPic, false, bCalculateVar, bCalculateBGD);
 
     if (pSvcParam->bEnableBackgroundDetection) {
-      BackgroundDetection (pCtx->pVaa, pCurPic, pRefPic, bCalculateBGD && pRefPic->iPictureType != I_SLICE);
+      BackgroundDetection (m_pInterfaceVp, pCtx->pVaa, pCurPic, pRefPic,
+                           bCalculateBGD && pRefPic->iPictureType != I_SLICE);
     }
     if (bNeededMbAq) {
-      AdaptiveQuantCalculation (pCtx->pVaa, pCurPic, pRefPic);
+      AdaptiveQuantCalculation (m_pInterfaceVp, pCtx->pVaa, pCurPic, pRefPic);
     }
   } else {
     SPicture* pRefPic = GetBestRefPic (kiDidx, iRefTemporalIdx);
     SPicture* pLastPic = m_pLastSpatialPicture[kiDidx][0];
     bool bCalculateSQDiff = ((pLastPic->pData[0] == pRefPic->pData[0]) && bNeededMbAq);
 
-    VaaCalculation (pCtx->pVaa, pCurPic, pRefPic, bCalculateSQDiff, bCalculateVar, bCalculateBGD);
+    // analysed when it was staged, against the previous input that the P picture references here as well
+    SStagedVaaInfo* pStaged = (pCtx->eSliceType == P_SLICE && pLastPic == pRefPic) ? GetStagedVaa (kiDidx, pRefPic) :
+                              NULL;
+    if (NULL != pStaged) {
+      TakeStagedVaa (pCtx, pStaged, pCurPic);
+      return 0;
+    }
+
+    VaaCalculation (m_pInterfaceVp, pCtx->pVaa, pCurPic, pRefPic, bCalculateSQDiff, bCalculateVar, bCalculateBGD);
 
     if (pSvcParam->bEnableBackgroundDetection) {
-      BackgroundDetection (pCtx->pVaa, pCurPic, pRefPic, bCalculateBGD && pRefPic->iPictureType != I_SLICE);
+      BackgroundDetection (m_pInterfaceVp, pCtx->pVaa, pCurPic, pRefPic,
+                           bCalculateBGD && pRefPic->iPictureType != I_SLICE);
     }
 
     if (bNeededMbAq) {
-      AdaptiveQuantCalculation (pCtx->pVaa, m_pLastSpatialPicture[kiDidx][1], m_pLastSpatialPicture[kiDidx][0]);
+      AdaptiveQuantCalculation (m_pInterfaceVp, pCtx->pVaa, m_pLastSpatialPicture[kiDidx][1],
+                                m_pLastSpatialPicture[kiDidx][0]);
     }
   }
   return 0;
@@ -341,31 +467,19 @@ int32_t CWelsPreProcess::UpdateSpatialPictures (sWelsEncCtx* pCtx, SWelsSvcCodin
 
 /*
  *   SingleLayerPreprocess: down sampling if applicable
- *  @return: exact number of spatial layers need to encoder indeed
+ *  @return: exact number of spatial layers need to encoder indeed, -2 if the input could not be read
  */
 int32_t CWelsPreProcess::SingleLayerPreprocess (sWelsEncCtx* pCtx, const SSourcePicture* kpSrc,
     Scaled_Picture* pScaledPicture) {
   SWelsSvcCodingParam* pSvcParam    = pCtx->pSvcParam;
   int8_t  iDependencyId             = pSvcParam->iSpatialLayerNum - 1;
 
-  SPicture* pSrcPic                 = NULL; // large
   SPicture* pDstPic                 = NULL; // small
-  SSpatialLayerConfig* pDlayerParam = NULL;
   SSpatialLayerInternal* pDlayerParamInternal = NULL;
   int32_t iSpatialNum               = 0;
-  int32_t iSrcWidth                 = 0;
-  int32_t iSrcHeight                = 0;
-  int32_t iTargetWidth              = 0;
-  int32_t iTargetHeight             = 0;
   int32_t iTemporalId = 0;
-  int32_t iClosestDid =  iDependencyId;
   pDlayerParamInternal = &pSvcParam->sDependencyLayers[iDependencyId];
-  pDlayerParam = &pSvcParam->sSpatialLayers[iDependencyId];
-  iTargetWidth   = pDlayerParam->iVideoWidth;
-  iTargetHeight  = pDlayerParam->iVideoHeight;
 
-  iSrcWidth   = pSvcParam->SUsedPicRect.iWidth;
-  iSrcHeight  = pSvcParam->SUsedPicRect.iHeight;
   if (pSvcParam->uiIntraPeriod) {
     pCtx->pVaa->bIdrPeriodFlag = (1 + pDlayerParamInternal->iFrameIndex >= (int32_t)pSvcParam->uiIntraPeriod) ? true :
                                  false;
@@ -377,32 +491,32 @@ int32_t CWelsPreProcess::SingleLayerPreprocess (sWelsEncCtx* pCtx, const SSource
     }
   }
 
-  pSrcPic = pScaledPicture->pScaledInputPicture ? pScaledPicture->pScaledInputPicture : GetCurrentOrigFrame (
-              iDependencyId);
-
-  WelsMoveMemoryWrapper (pSvcParam, pSrcPic, kpSrc, iSrcWidth, iSrcHeight);
-
-  if (pSvcParam->bEnableDenoise)
-    BilateralDenoising (pSrcPic, iSrcWidth, iSrcHeight);
-
-  // different scaling in between input picture and dst highest spatial picture.
-  int32_t iShrinkWidth  = iSrcWidth;
-  int32_t iShrinkHeight = iSrcHeight;
-  pDstPic = pSrcPic;
-  if (pScaledPicture->pScaledInputPicture) {
-    // for highest downsampling
-    pDstPic = GetCurrentOrigFrame (iDependencyId);
-    iShrinkWidth = pScaledPicture->iScaledWidth[iDependencyId];
-    iShrinkHeight = pScaledPicture->iScaledHeight[iDependencyId];
+  if (m_iStagedCount > 0) {
+    // scaled ahead when it was staged
+    SwapInStagedPictures (pCtx, m_iStagedHead);
+  } else {
+    SPicture* pSpatialPic[MAX_DEPENDENCY_LAYER];
+    for (int32_t i = 0; i < pSvcParam->iSpatialLayerNum; i++)
+      pSpatialPic[i] = GetCurrentOrigFrame (i);
+    if (ScaleSourcePicture (m_pInterfaceVp, pCtx, kpSrc, pScaledPicture, pSpatialPic) != 0) {
+      WelsLog (& (pCtx->sLogCtx), WELS_LOG_ERROR, "SingleLayerPreprocess(), failed in reading the input picture");
+      return -2;
+    }
+    m_iCurStagedSet = -1;
   }
-  DownsamplePadding (pSrcPic, pDstPic, iSrcWidth, iSrcHeight, iShrinkWidth, iShrinkHeight, iTargetWidth, iTargetHeight,
-                     false);
+  pDstPic = GetCurrentOrigFrame (iDependencyId);
 
   if (pSvcParam->bEnableSceneChangeDetect && !pCtx->pVaa->bIdrPeriodFlag) {
     if (pSvcParam->iUsageType == SCREEN_CONTENT_REAL_TIME) {
       pCtx->pVaa->eSceneChangeIdc = (pDlayerParamInternal->bEncCurFrmAsIdrFlag ? LARGE_CHANGED_SCENE :
                                      DetectSceneChange (pDstPic));
       pCtx->pVaa->bSceneChangeFlag = (LARGE_CHANGED_SCENE == pCtx->pVaa->eSceneChangeIdc);
+    } else if (pSvcParam->iLookaheadFrames > 0) {
+      // a scene cut found by the lookahead is taken by the next T0 picture
+      if (! (pDlayerParamInternal->iCodingIndex & (pSvcParam->uiGopSize - 1))) {
+        pCtx->pVaa->bSceneChangeFlag = m_bPendingSceneCut && !pDlayerParamInternal->bEncCurFrmAsIdrFlag;
+        m_bPendingSceneCut = false;
+      }
     } else {
       if ((!pDlayerParamInternal->bEncCurFrmAsIdrFlag)
           && ! (pDlayerParamInternal->iCodingIndex & (pSvcParam->uiGopSize - 1))) {
@@ -410,7 +524,9 @@ int32_t CWelsPreProcess::SingleLayerPreprocess (sWelsEncCtx* pCtx, const SSource
                             m_pSpatialPic[iDependencyId][m_uiSpatialLayersInTemporal[iDependencyId] +
                                 pCtx->pVaa->uiValidLongTermPicIdx] : m_pLastSpatialPicture[iDependencyId][0];
         //pCtx->pVaa->eSceneChangeIdc = DetectSceneChange (pDstPic, pRefPic);
-        pCtx->pVaa->bSceneChangeFlag = GetSceneChangeFlag (DetectSceneChange (pDstPic, pRefPic));
+        SStagedVaaInfo* pStaged = GetStagedVaa (iDependencyId, pRefPic);
+        pCtx->pVaa->bSceneChangeFlag = GetSceneChangeFlag ((NULL != pStaged) ? pStaged->eSceneChangeIdc :
+                                       DetectSceneChange (pDstPic, pRefPic));
       }
     }
   }
@@ -435,46 +551,376 @@ int32_t CWelsPreProcess::SingleLayerPreprocess (sWelsEncCtx* pCtx, const SSource
   m_pLastSpatialPicture[iDependencyId][1] = GetCurrentOrigFrame (iDependencyId);
   -- iDependencyId;
 
+  // other spacial layers, down sampled from the closest higher one by ScaleSourcePicture()
+  while (iDependencyId >= 0) {
+    pDlayerParamInternal = &pSvcParam->sDependencyLayers[iDependencyId];
+    iTemporalId = pDlayerParamInternal->uiCodingIdx2TemporalId[pDlayerParamInternal->iCodingIndex &
+                  (pSvcParam->uiGopSize - 1)];
+    pDstPic = GetCurrentOrigFrame (iDependencyId); // small
+
+    if ((iTemporalId != INVALID_TEMPORAL_ID)) {
+      WelsUpdateSpatialIdxMap (pCtx, iActualSpatialNum, pDstPic, iDependencyId);
+      iActualSpatialNum--;
+    }
+
+    m_pLastSpatialPicture[iDependencyId][1] = pDstPic;
+    -- iDependencyId;
+  }
+  return iSpatialNum;
+
+}
+
+/*!
+ * \brief   csc/denoise/downsample/padding of the input into one picture per spatial layer
+ *          touches nothing but ppDstPic and pScaledPicture, so it may run on the lookahead thread
+ * \return  0 - success; otherwise the input could not be copied or converted
+ */
+int32_t CWelsPreProcess::ScaleSourcePicture (IWelsVP* pVp, sWelsEncCtx* pCtx, const SSourcePicture* kpSrc,
+    Scaled_Picture* pScaledPicture, SPicture** ppDstPic) {
+  SWelsSvcCodingParam* pSvcParam    = pCtx->pSvcParam;
+  int8_t  iDependencyId             = pSvcParam->iSpatialLayerNum - 1;
+  SSpatialLayerConfig* pDlayerParam = &pSvcParam->sSpatialLayers[iDependencyId];
+  int32_t iTargetWidth              = pDlayerParam->iVideoWidth;
+  int32_t iTargetHeight             = pDlayerParam->iVideoHeight;
+  const int32_t kiSrcWidth          = pSvcParam->SUsedPicRect.iWidth;
+  const int32_t kiSrcHeight         = pSvcParam->SUsedPicRect.iHeight;
+  int32_t iClosestDid               = iDependencyId;
+
+  SPicture* pSrcPic = pScaledPicture->pScaledInputPicture ? pScaledPicture->pScaledInputPicture :
+                      ppDstPic[iDependencyId]; // large
+
+  if (WelsMoveMemoryWrapper (pSvcParam, pSrcPic, kpSrc, kiSrcWidth, kiSrcHeight) != 0)
+    return 1;
+
+  if (pSvcParam->bEnableDenoise)
+    BilateralDenoising (pVp, pSrcPic, kiSrcWidth, kiSrcHeight);
+
+  // different scaling in between input picture and dst highest spatial picture.
+  int32_t iShrinkWidth  = kiSrcWidth;
+  int32_t iShrinkHeight = kiSrcHeight;
+  SPicture* pDstPic = pSrcPic;
+  if (pScaledPicture->pScaledInputPicture) {
+    // for highest downsampling
+    pDstPic = ppDstPic[iDependencyId];
+    iShrinkWidth = pScaledPicture->iScaledWidth[iDependencyId];
+    iShrinkHeight = pScaledPicture->iScaledHeight[iDependencyId];
+  }
+  DownsamplePadding (pVp, pSrcPic, pDstPic, kiSrcWidth, kiSrcHeight, iShrinkWidth, iShrinkHeight, iTargetWidth,
+                     iTargetHeight, false);
+  -- iDependencyId;
 
   // generate other spacial layer
   // pSrc is
   //    -- padded input pic, if downsample should be applied to generate highest layer, [if] block above
   //    -- highest layer, if no downsampling, [else] block above
-  if (pSvcParam->iSpatialLayerNum > 1) {
-    while (iDependencyId >= 0) {
-      pDlayerParamInternal = &pSvcParam->sDependencyLayers[iDependencyId];
-      pDlayerParam = &pSvcParam->sSpatialLayers[iDependencyId];
-      SPicture* pSrcPic  = m_pLastSpatialPicture[iClosestDid][1]; // large
-      iTargetWidth  = pDlayerParam->iVideoWidth;
-      iTargetHeight = pDlayerParam->iVideoHeight;
-      iTemporalId = pDlayerParamInternal->uiCodingIdx2TemporalId[pDlayerParamInternal->iCodingIndex &
-                    (pSvcParam->uiGopSize - 1)];
-
-      // down sampling performed
-      int32_t iSrcWidth                 = pScaledPicture->iScaledWidth[iClosestDid];
-      int32_t iSrcHeight                = pScaledPicture->iScaledHeight[iClosestDid];
-      pDstPic = GetCurrentOrigFrame (iDependencyId); // small
-      iShrinkWidth = pScaledPicture->iScaledWidth[iDependencyId];
-      iShrinkHeight = pScaledPicture->iScaledHeight[iDependencyId];
-      DownsamplePadding (pSrcPic, pDstPic, iSrcWidth, iSrcHeight, iShrinkWidth, iShrinkHeight, iTargetWidth, iTargetHeight,
-                         true);
-
-      if ((iTemporalId != INVALID_TEMPORAL_ID)) {
-        WelsUpdateSpatialIdxMap (pCtx, iActualSpatialNum, pDstPic, iDependencyId);
-        iActualSpatialNum--;
+  while (iDependencyId >= 0) {
+    pDlayerParam = &pSvcParam->sSpatialLayers[iDependencyId];
+    pSrcPic       = ppDstPic[iClosestDid]; // large
+    iTargetWidth  = pDlayerParam->iVideoWidth;
+    iTargetHeight = pDlayerParam->iVideoHeight;
+
+    // down sampling performed
+    int32_t iSrcWidth  = pScaledPicture->iScaledWidth[iClosestDid];
+    int32_t iSrcHeight = pScaledPicture->iScaledHeight[iClosestDid];
+    pDstPic = ppDstPic[iDependencyId]; // small
+    iShrinkWidth = pScaledPicture->iScaledWidth[iDependencyId];
+    iShrinkHeight = pScaledPicture->iScaledHeight[iDependencyId];
+    DownsamplePadding (pVp, pSrcPic, pDstPic, iSrcWidth, iSrcHeight, iShrinkWidth, iShrinkHeight, iTargetWidth,
+                       iTargetHeight, true);
+
+    iClosestDid = iDependencyId;
+    -- iDependencyId;
+  }
+  return 0;
+}
+
+/*!
+ * \brief   whether the lookahead thread may scale kpSrcPic, i.e. no preprocessing reset is needed for it
+ */
+bool CWelsPreProcess::IsStageReady (const SSourcePicture* kpSrcPic) {
+  SWelsSvcCodingParam* pSvcParam = m_pEncCtx->pSvcParam;
+  return m_bInitDone && (NULL != m_pInterfaceVp) && (NULL != m_pLookaheadVp)
+         && (((kpSrcPic->iPicWidth >> 1) << 1) == pSvcParam->SUsedPicRect.iWidth)
+         && (((kpSrcPic->iPicHeight >> 1) << 1) == pSvcParam->SUsedPicRect.iHeight);
+}
+
+/*!
+ * \brief   scale the input picture into staged set kiSet, BuildSpatialPicList() of the next picture then
+ *          takes it over instead of the input
+ * \return  0 - success; -1 - failed in the preprocessing reset, which only happens when !IsStageReady (kpSrcPic)
+ *          and then must be called on the encoding thread; -2 - the input could not be read
+ */
+int32_t CWelsPreProcess::StagePicture (sWelsEncCtx* pCtx, const SSourcePicture* kpSrcPic, const int32_t kiSet) {
+  if (!IsStageReady (kpSrcPic) && InitSourceSize (pCtx, kpSrcPic) != 0)
+    return -1;
+
+  if (ScaleSourcePicture (m_pLookaheadVp, pCtx, kpSrcPic, &m_sStagedScaledPicture, m_pStagedPic[kiSet]) != 0)
+    return -2;
+  if (pCtx->pSvcParam->iLookaheadFrames > 0)
+    AnalyzeStagedPicture (pCtx, kiSet);
+  AnalyzeStagedVaa (pCtx, kiSet);
+
+  // keep the picture description, its planes may be released by the caller once EncodeFrame() returns
+  m_sStagedSrcPic[kiSet] = *kpSrcPic;
+  memset (m_sStagedSrcPic[kiSet].pData, 0, sizeof (m_sStagedSrcPic[kiSet].pData));
+  return 0;
+}
+
+/*!
+ * \brief   queue staged set kiSet, which must be the one GetFreeStagedSet() returned
+ */
+void CWelsPreProcess::CommitStagedPicture (const int32_t kiSet) {
+  assert (kiSet == GetFreeStagedSet());
+  ++ m_iStagedCount;
+}
+
+/*!
+ * \brief   describe the staged picture to encode next
+ * \param   kbFlush  true if no input follows, the queue then gives its head set out before it is full
+ * \return  staged set of it; -1 if there is none or the lookahead needs more pictures queued
+ */
+int32_t CWelsPreProcess::GetStagedPicture (SSourcePicture* pSrcPic, const bool kbFlush) {
+  if (m_iStagedCount <= 0 || (!kbFlush && m_iStagedCount < m_iStagedDepth))
+    return -1;
+  if (pSrcPic != NULL)
+    *pSrcPic = m_sStagedSrcPic[m_iStagedHead];
+  return m_iStagedHead;
+}
+
+/*!
+ * \brief   set the next input is staged into, it is not read by the encoding of the queued ones
+ */
+int32_t CWelsPreProcess::GetFreeStagedSet() {
+  return (m_iStagedHead + m_iStagedCount) % m_iStagedSetNum;
+}
+
+void CWelsPreProcess::SwapInStagedPictures (sWelsEncCtx* pCtx, const int32_t kiSet) {
+  if (pCtx->pSvcParam->iLookaheadFrames > 0)
+    UpdateLookaheadCost (pCtx, kiSet);
+  for (int32_t i = 0; i < pCtx->pSvcParam->iSpatialLayerNum; i++) {
+    SPicture** ppCurPic = &m_pSpatialPic[i][GetCurPicPosition (i)];
+    SPicture* pOldPic   = *ppCurPic;
+
+    *ppCurPic = m_pStagedPic[kiSet][i];
+    m_pStagedPic[kiSet][i] = pOldPic;
+    // the picture may still be the last one, which is then seen overwritten as in the unstaged path
+    if (m_pLastSpatialPicture[i][0] == pOldPic)
+      m_pLastSpatialPicture[i][0] = *ppCurPic;
+  }
+  m_iCurStagedSet = kiSet;
+  m_iStagedHead = (m_iStagedHead + 1) % m_iStagedSetNum;
+  -- m_iStagedCount;
+}
+
+/*!
+ * \brief   1/2 size luma cost of the picture staged into kiSet: per 8x8 block the SATD against the block DC and
+ *          after a small search in the previously analysed picture, a scene cut if the latter barely saves anything
+ *          runs with the staging of the picture, so on the lookahead thread with the frame pipeline
+ */
+void CWelsPreProcess::AnalyzeStagedPicture (sWelsEncCtx* pCtx, const int32_t kiSet) {
+  SWelsSvcCodingParam* pSvcParam  = pCtx->pSvcParam;
+  const int32_t kiDid             = pSvcParam->iSpatialLayerNum - 1;
+  const int32_t kiMbWidth         = (pSvcParam->sSpatialLayers[kiDid].iVideoWidth + 15) >> 4;
+  const int32_t kiMbHeight        = (pSvcParam->sSpatialLayers[kiDid].iVideoHeight + 15) >> 4;
+  const int32_t kiWidth           = kiMbWidth << 3;
+  const int32_t kiHeight          = kiMbHeight << 3;
+  PSampleSadSatdCostFunc pfSatd   = pCtx->pFuncList->sSampleDealingFuncs.pfSampleSatd[BLOCK_8x8];
+  PSampleSadMultiFunc pfSadMulti  = pCtx->pFuncList->sSampleDealingFuncs.pfSampleSadMulti[BLOCK_8x8];
+  SLookaheadInfo* pInfo           = &m_sLookahead[kiSet];
+  SLookaheadInfo* pRefInfo        = (m_iLastAnalyzedSet >= 0) ? &m_sLookahead[m_iLastAnalyzedSet] : NULL;
+  SPicture* pCurPic               = pInfo->pLowResPic;
+  const int32_t kiCurStride       = pCurPic->iLineSize[0];
+  const SMVUnitXY ksZeroMv        = {0, 0};
+  int64_t iIntraCost              = 0;
+  int64_t iFrameCost              = 0;
+  ENFORCE_STACK_ALIGN_1D (uint8_t, uiDcBlock, 64, 16);
+
+  DownsamplePyramid (m_pLookaheadVp, m_pStagedPic[kiSet][kiDid], kiMbWidth << 4, kiMbHeight << 4, &pCurPic, 1);
+
+  for (int32_t iY = 0; iY < kiHeight; iY += 8) {
+    for (int32_t iX = 0; iX < kiWidth; iX += 8) {
+      uint8_t* pCur = pCurPic->pData[0] + iY * kiCurStride + iX;
+      int32_t iSum = 0;
+      for (int32_t i = 0; i < 8; i++) {
+        for (int32_t j = 0; j < 8; j++)
+          iSum += pCur[i * kiCurStride + j];
       }
+      memset (uiDcBlock, (iSum + 32) >> 6, 64);
+      const int32_t kiIntraCost = pfSatd (pCur, kiCurStride, uiDcBlock, 8);
+      int32_t iCost = kiIntraCost;
+
+      if (NULL != pRefInfo) {
+        SPicture* pRefPic = pRefInfo->pLowResPic;
+        const int32_t kiRefStride = pRefPic->iLineSize[0];
+        uint8_t* pRef = pRefPic->pData[0] + iY * kiRefStride + iX;
+        SMVUnitXY sMin, sMax, sMv = ksZeroMv;
+        int32_t iBestSad = INT_MAX;
+        sMin.iMvX = WELS_MAX (-iX, -LOOKAHEAD_SEARCH_RANGE);
+        sMin.iMvY = WELS_MAX (-iY, -LOOKAHEAD_SEARCH_RANGE);
+        sMax.iMvX = WELS_MIN (kiWidth - 8 - iX, LOOKAHEAD_SEARCH_RANGE);
+        sMax.iMvY = WELS_MIN (kiHeight - 8 - iY, LOOKAHEAD_SEARCH_RANGE);
+        PyramidBlockSearch (pfSadMulti, pCur, kiCurStride, pRef, kiRefStride, ksZeroMv, LOOKAHEAD_SEARCH_RANGE,
+                            sMin, sMax, sMv, iBestSad);
+        iCost = WELS_MIN (iCost, pfSatd (pCur, kiCurStride, pRef + sMv.iMvY * kiRefStride + sMv.iMvX, kiRefStride));
+      }
+      iIntraCost += kiIntraCost;
+      iFrameCost += iCost;
+    }
+  }
 
-      m_pLastSpatialPicture[iDependencyId][1] = pDstPic;
+  pInfo->iIntraCost = (int32_t)WELS_MIN (iIntraCost, INT_MAX);
+  pInfo->iFrameCost = (int32_t)WELS_MIN (iFrameCost, INT_MAX);
+  // flat pictures are left alone, they cost next to nothing either way
+  pInfo->bSceneCut  = (NULL != pRefInfo) && (iFrameCost * 100 >= iIntraCost * LOOKAHEAD_SCENE_CUT_RATIO)
+                      && (iFrameCost >= (int64_t)kiWidth * kiHeight * LOOKAHEAD_SCENE_CUT_MIN_COST);
+  m_iLastAnalyzedSet = kiSet;
+}
 
-      iClosestDid = iDependencyId;
-      -- iDependencyId;
+/*!
+ * \brief   hand the lookahead costs of staged set kiSet, the head of the queue, over to the rate control
+ */
+void CWelsPreProcess::UpdateLookaheadCost (sWelsEncCtx* pCtx, const int32_t kiSet) {
+  int64_t iWindowCost = 0;
+  for (int32_t i = 0; i < m_iStagedCount; i++)
+    iWindowCost += m_sLookahead[ (m_iStagedHead + i) % m_iStagedSetNum].iFrameCost;
+
+  pCtx->pVaa->iLookaheadFrameCost  = m_sLookahead[kiSet].iFrameCost;
+  pCtx->pVaa->iLookaheadWindowCost = (int32_t) (iWindowCost / WELS_MAX (m_iStagedCount, 1));
+  m_bPendingSceneCut = m_bPendingSceneCut || m_sLookahead[kiSet].bSceneCut;
+}
 
+
+/*!
+ * \brief   per staged set results of the VAA done with the staging, only with the frame pipeline as the staging then
+ *          runs on the lookahead thread; screen content does not pipeline, and with background detection the encoding
+ *          copies the background MBs of the reference into its source, which the staging of the next picture would
+ *          have read before
+ */
+int32_t CWelsPreProcess::AllocStagedVaa (sWelsEncCtx* pCtx, SWelsSvcCodingParam* pParam) {
+  CMemoryAlign* pMa = pCtx->pMemAlign;
+  if (!pParam->bEnableFramePipeline || pParam->iUsageType == SCREEN_CONTENT_REAL_TIME
+      || pParam->bEnableBackgroundDetection)
+    return 0;
+
+  const int32_t kiDid    = pParam->iSpatialLayerNum - 1;
+  const int32_t kiMbNum  = ((pParam->sSpatialLayers[kiDid].iVideoWidth + 15) >> 4) *
+                           ((pParam->sSpatialLayers[kiDid].iVideoHeight + 15) >> 4);
+  for (int32_t iSet = 0; iSet < m_iStagedSetNum; iSet++) {
+    SVAAFrameInfo* pVaa = &m_sStagedVaa[iSet].sVaa;
+    pVaa->sVaaCalcInfo.pSad8x8 = static_cast<int32_t (*)[4]> (pMa->WelsMallocz (kiMbNum * 4 * sizeof (int32_t),
+        "pStagedVaa->sVaaCalcInfo.pSad8x8"));
+    WELS_VERIFY_RETURN_IF (1, (NULL == pVaa->sVaaCalcInfo.pSad8x8))
+    if (pParam->bEnableAdaptiveQuant) {
+      pVaa->sVaaCalcInfo.pSsd16x16 = static_cast<int32_t*> (pMa->WelsMallocz (kiMbNum * sizeof (int32_t),
+          "pStagedVaa->sVaaCalcInfo.pSsd16x16"));
+      WELS_VERIFY_RETURN_IF (1, (NULL == pVaa->sVaaCalcInfo.pSsd16x16))
+      pVaa->sVaaCalcInfo.pSum16x16 = static_cast<int32_t*> (pMa->WelsMallocz (kiMbNum * sizeof (int32_t),
+          "pStagedVaa->sVaaCalcInfo.pSum16x16"));
+      WELS_VERIFY_RETURN_IF (1, (NULL == pVaa->sVaaCalcInfo.pSum16x16))
+      pVaa->sVaaCalcInfo.pSumOfSquare16x16 = static_cast<int32_t*> (pMa->WelsMallocz (kiMbNum * sizeof (int32_t),
+          "pStagedVaa->sVaaCalcInfo.pSumOfSquare16x16"));
+      WELS_VERIFY_RETURN_IF (1, (NULL == pVaa->sVaaCalcInfo.pSumOfSquare16x16))
+      pVaa->sAdaptiveQuantParam.pMotionTextureUnit = static_cast<SMotionTextureUnit*> (pMa->WelsMallocz (
+            kiMbNum * sizeof (SMotionTextureUnit), "pStagedVaa->sAdaptiveQuantParam.pMotionTextureUnit"));
+      WELS_VERIFY_RETURN_IF (1, (NULL == pVaa->sAdaptiveQuantParam.pMotionTextureUnit))
+      pVaa->sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp = static_cast<int8_t*> (pMa->WelsMallocz (
+            kiMbNum * sizeof (int8_t), "pStagedVaa->sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp"));
+      WELS_VERIFY_RETURN_IF (1, (NULL == pVaa->sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp))
+      pVaa->sAdaptiveQuantParam.iAdaptiveQuantMode = pCtx->pVaa->sAdaptiveQuantParam.iAdaptiveQuantMode;
     }
   }
-  return iSpatialNum;
+  return 0;
+}
 
+void CWelsPreProcess::FreeStagedVaa (sWelsEncCtx* pCtx) {
+  CMemoryAlign* pMa = pCtx->pMemAlign;
+  for (int32_t iSet = 0; iSet < MAX_STAGED_SET_NUM; iSet++) {
+    SVAAFrameInfo* pVaa = &m_sStagedVaa[iSet].sVaa;
+    if (pVaa->sVaaCalcInfo.pSad8x8)
+      pMa->WelsFree (pVaa->sVaaCalcInfo.pSad8x8, "pStagedVaa->sVaaCalcInfo.pSad8x8");
+    if (pVaa->sVaaCalcInfo.pSsd16x16)
+      pMa->WelsFree (pVaa->sVaaCalcInfo.pSsd16x16, "pStagedVaa->sVaaCalcInfo.pSsd16x16");
+    if (pVaa->sVaaCalcInfo.pSum16x16)
+      pMa->WelsFree (pVaa->sVaaCalcInfo.pSum16x16, "pStagedVaa->sVaaCalcInfo.pSum16x16");
+    if (pVaa->sVaaCalcInfo.pSumOfSquare16x16)
+      pMa->WelsFree (pVaa->sVaaCalcInfo.pSumOfSquare16x16, "pStagedVaa->sVaaCalcInfo.pSumOfSquare16x16");
+    if (pVaa->sAdaptiveQuantParam.pMotionTextureUnit)
+      pMa->WelsFree (pVaa->sAdaptiveQuantParam.pMotionTextureUnit,
+                     "pStagedVaa->sAdaptiveQuantParam.pMotionTextureUnit");
+    if (pVaa->sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp)
+      pMa->WelsFree (pVaa->sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp,
+                     "pStagedVaa->sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp");
+  }
+  memset (m_sStagedVaa, 0, sizeof (m_sStagedVaa));
 }
 
+/*!
+ * \brief   scene change detection, VAA and adaptive quant of the highest layer of the picture
+ *          staged into kiSet against the one staged before, computed as for a P picture referencing it
+ *          both pictures stay untouched while the queued ones are encoded, so it may run on the lookahead thread
+ */
+void CWelsPreProcess::AnalyzeStagedVaa (sWelsEncCtx* pCtx, const int32_t kiSet) {
+  SWelsSvcCodingParam* pSvcParam = pCtx->pSvcParam;
+  SStagedVaaInfo* pInfo          = &m_sStagedVaa[kiSet];
+  SPicture* pCurPic              = m_pStagedPic[kiSet][pSvcParam->iSpatialLayerNum - 1];
+  SPicture* pRefPic              = m_pLastStagedPic;
+
+  if (NULL == pInfo->sVaa.sVaaCalcInfo.pSad8x8)
+    return;
+  m_pLastStagedPic = pCurPic;
+  pInfo->pRefPic   = pRefPic;
+  if (NULL == pRefPic)
+    return;
+
+  if (pSvcParam->bEnableSceneChangeDetect && pSvcParam->iLookaheadFrames == 0)
+    pInfo->eSceneChangeIdc = DetectVideoSceneChange (m_pLookaheadVp, pCurPic, pRefPic);
+  VaaCalculation (m_pLookaheadVp, &pInfo->sVaa, pCurPic, pRefPic, pSvcParam->bEnableAdaptiveQuant, false, false);
+  if (pSvcParam->bEnableAdaptiveQuant)
+    AdaptiveQuantCalculation (m_pLookaheadVp, &pInfo->sVaa, pCurPic, pRefPic);
+}
+
+/*!
+ * \brief   staged analysis of the picture being encoded if it referenced kpRefPic
+ * \return  NULL if the picture was not staged with it, which must then be analysed in place
+ */
+SStagedVaaInfo* CWelsPreProcess::GetStagedVaa (const int32_t kiDidx, const SPicture* kpRefPic) {
+  if (m_iCurStagedSet < 0 || kiDidx != m_pEncCtx->pSvcParam->iSpatialLayerNum - 1 || NULL == kpRefPic)
+    return NULL;
+  SStagedVaaInfo* pInfo = &m_sStagedVaa[m_iCurStagedSet];
+  if (NULL == pInfo->sVaa.sVaaCalcInfo.pSad8x8 || pInfo->pRefPic != kpRefPic)
+    return NULL;
+  return pInfo;
+}
+
+/*!
+ * \brief   copy the staged results over the ones AnalyzeSpatialPic() computes for a P picture
+ */
+void CWelsPreProcess::TakeStagedVaa (sWelsEncCtx* pCtx, const SStagedVaaInfo* kpStaged, SPicture* pCurPic) {
+  SWelsSvcCodingParam* pSvcParam = pCtx->pSvcParam;
+  SVAAFrameInfo* pVaa            = pCtx->pVaa;
+  const SVAAFrameInfo* kpSrc     = &kpStaged->sVaa;
+  const int32_t kiMbNum          = ((pCurPic->iWidthInPixel + 15) >> 4) * ((pCurPic->iHeightInPixel + 15) >> 4);
+
+  pVaa->sVaaCalcInfo.pCurY     = kpSrc->sVaaCalcInfo.pCurY;
+  pVaa->sVaaCalcInfo.pRefY     = kpSrc->sVaaCalcInfo.pRefY;
+  pVaa->sVaaCalcInfo.iFrameSad = kpSrc->sVaaCalcInfo.iFrameSad;
+  memcpy (pVaa->sVaaCalcInfo.pSad8x8, kpSrc->sVaaCalcInfo.pSad8x8, kiMbNum * 4 * sizeof (int32_t));
+  if (pSvcParam->bEnableAdaptiveQuant) {
+    memcpy (pVaa->sVaaCalcInfo.pSsd16x16, kpSrc->sVaaCalcInfo.pSsd16x16, kiMbNum * sizeof (int32_t));
+    memcpy (pVaa->sVaaCalcInfo.pSum16x16, kpSrc->sVaaCalcInfo.pSum16x16, kiMbNum * sizeof (int32_t));
+    memcpy (pVaa->sVaaCalcInfo.pSumOfSquare16x16, kpSrc->sVaaCalcInfo.pSumOfSquare16x16, kiMbNum * sizeof (int32_t));
+  }
+
+  if (pSvcParam->bEnableAdaptiveQuant) {
+    pVaa->sAdaptiveQuantParam.pCalcResult = & (pVaa->sVaaCalcInfo);
+    pVaa->sAdaptiveQuantParam.iAverMotionTextureIndexToDeltaQp =
+      kpSrc->sAdaptiveQuantParam.iAverMotionTextureIndexToDeltaQp;
+    memcpy (pVaa->sAdaptiveQuantParam.pMotionTextureUnit, kpSrc->sAdaptiveQuantParam.pMotionTextureUnit,
+            kiMbNum * sizeof (SMotionTextureUnit));
+    memcpy (pVaa->sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp,
+            kpSrc->sAdaptiveQuantParam.pMotionTextureIndexToDeltaQp, kiMbNum * sizeof (int8_t));
+  }
+}
 
 /*!
  * \brief   Whether input picture need be scaled?
@@ -565,13 +1011,94 @@ int32_t CWelsPreProcess::InitLastSpatialPictures (sWelsEncCtx* pCtx) {
 }
 //*********************************************************************************************************/
 
+/*!
+ * \brief   convert packed RGB/BGR or NV12 input into the I420 source picture in a single pass
+ * \return  0 - converted; otherwise the input is not supported and pDstPic is left untouched
+ */
 int32_t CWelsPreProcess::ColorspaceConvert (SWelsSvcCodingParam* pSvcParam, SPicture* pDstPic,
-    const SSourcePicture* kpSrc, const int32_t kiWidth, const int32_t kiHeight) {
-  return 1;
-  //not support yet
+    const SSourcePicture* kpSrc, const int32_t kiTargetWidth, const int32_t kiTargetHeight) {
+  SColorspaceConvertFunc* pCscFunc = &m_pEncCtx->pFuncList->sColorspaceConvertFunc;
+  PPackedRgbToI420Func pfPackedToI420 = NULL;
+  int32_t iBytesPerPixel = 0;
+
+  switch (kpSrc->iColorFormat & (~videoFormatVFlip)) {
+  case videoFormatBGR:
+    pfPackedToI420 = pCscFunc->pfBgrToI420;
+    iBytesPerPixel = 3;
+    break;
+  case videoFormatBGRA:
+    pfPackedToI420 = pCscFunc->pfBgraToI420;
+    iBytesPerPixel = 4;
+    break;
+  case videoFormatRGBA:
+    pfPackedToI420 = pCscFunc->pfRgbaToI420;
+    iBytesPerPixel = 4;
+    break;
+  case videoFormatNV12:
+    break;
+  default:
+    return 1; //not support yet
+  }
+
+  int32_t  iSrcWidth       = kpSrc->iPicWidth;
+  int32_t  iSrcHeight      = kpSrc->iPicHeight;
+
+  if (iSrcHeight > kiTargetHeight) iSrcHeight = kiTargetHeight;
+  if (iSrcWidth > kiTargetWidth)   iSrcWidth  = kiTargetWidth;
+
+  if (iSrcWidth & 0x1)  -- iSrcWidth;
+  if (iSrcHeight & 0x1) -- iSrcHeight;
+
+  const int32_t kiSrcTop  = pSvcParam->SUsedPicRect.iTop;
+  const int32_t kiSrcLeft = pSvcParam->SUsedPicRect.iLeft;
+
+  uint8_t* pDstY = pDstPic->pData[0];
+  uint8_t* pDstU = pDstPic->pData[1];
+  uint8_t* pDstV = pDstPic->pData[2];
+  const int32_t kiDstStrideY = pDstPic->iLineSize[0];
+  const int32_t kiDstStrideUV = pDstPic->iLineSize[1];
+
+  if (kpSrc->pData[0] == NULL || pDstY == NULL || pDstU == NULL || pDstV == NULL)
+    return 1;
+  if (iSrcWidth <= 0 || iSrcHeight <= 0 || (iSrcWidth * iSrcHeight > (MAX_MBS_PER_FRAME << 8)))
+    return 1;
+  if (kiSrcTop >= iSrcHeight || kiSrcLeft >= iSrcWidth)
+    return 1;
+  if (kiTargetWidth <= 0 || kiTargetHeight <= 0 || (kiTargetWidth * kiTargetHeight > (MAX_MBS_PER_FRAME << 8)))
+    return 1;
+  if (kiTargetWidth > kiDstStrideY)
+    return 1;
+
+  if (NULL != pfPackedToI420) {
+    int32_t iSrcStride = kpSrc->iStride[0];
+    if (iSrcWidth * iBytesPerPixel > iSrcStride)
+      return 1;
+    const uint8_t* kpSrcPixel = kpSrc->pData[0] + kiSrcTop * iSrcStride + kiSrcLeft * iBytesPerPixel;
+    if (kpSrc->iColorFormat & videoFormatVFlip) {
+      // bottom-up (DIB style) rows: walk the source backwards
+      kpSrcPixel = kpSrc->pData[0] + (kpSrc->iPicHeight - 1 - kiSrcTop) * iSrcStride + kiSrcLeft * iBytesPerPixel;
+      iSrcStride = -iSrcStride;
+    }
+    pfPackedToI420 (pDstY, pDstU, pDstV, kiDstStrideY, kiDstStrideUV, kpSrcPixel, iSrcStride, iSrcWidth, iSrcHeight);
+  } else {
+    const int32_t kiSrcStrideY = kpSrc->iStride[0];
+    const int32_t kiSrcStrideUV = kpSrc->iStride[1];
+    if (kpSrc->pData[1] == NULL || (kpSrc->iColorFormat & videoFormatVFlip) || iSrcWidth > kiSrcStrideY
+        || iSrcWidth > kiSrcStrideUV)
+      return 1;
+    const uint8_t* kpSrcY = kpSrc->pData[0] + kiSrcTop * kiSrcStrideY + kiSrcLeft;
+    const uint8_t* kpSrcUV = kpSrc->pData[1] + (kiSrcTop >> 1) * kiSrcStrideUV + ((kiSrcLeft >> 1) << 1);
+    pCscFunc->pfNv12ToI420 (pDstY, pDstU, pDstV, kiDstStrideY, kiDstStrideUV, kpSrcY, kpSrcUV, kiSrcStrideY,
+                            kiSrcStrideUV, iSrcWidth, iSrcHeight);
+  }
+
+  if (kiTargetWidth > iSrcWidth || kiTargetHeight > iSrcHeight) {
+    Padding (pDstY, pDstU, pDstV, kiDstStrideY, kiDstStrideUV, iSrcWidth, kiTargetWidth, iSrcHeight, kiTargetHeight);
+  }
+  return 0;
 }
 
-void CWelsPreProcess::BilateralDenoising (SPicture* pSrc, const int32_t kiWidth, const int32_t kiHeight) {
+void CWelsPreProcess::BilateralDenoising (IWelsVP* pVp, SPicture* pSrc, const int32_t kiWidth, const int32_t kiHeight) {
   int32_t iMethodIdx = METHOD_DENOISE;
   SPixMap sSrcPixMap;
   memset (&sSrcPixMap, 0, sizeof (sSrcPixMap));
@@ -586,10 +1113,14 @@ void CWelsPreProcess::BilateralDenoising (SPicture* pSrc, const int32_t kiWidth,
   sSrcPixMap.iStride[2] = pSrc->iLineSize[2];
   sSrcPixMap.eFormat = VIDEO_FORMAT_I420;
 
-  m_pInterfaceVp->Process (iMethodIdx, &sSrcPixMap, NULL);
+  pVp->Process (iMethodIdx, &sSrcPixMap, NULL);
 }
 
 ESceneChangeIdc CWelsPreProcessVideo::DetectSceneChange (SPicture* pCurPicture, SPicture* pRefPicture) {
+  return DetectVideoSceneChange (m_pInterfaceVp, pCurPicture, pRefPicture);
+}
+
+ESceneChangeIdc CWelsPreProcess::DetectVideoSceneChange (IWelsVP* pVp, SPicture* pCurPicture, SPicture* pRefPicture) {
   int32_t iMethodIdx = METHOD_SCENE_CHANGE_DETECTION_VIDEO;
   SSceneChangeResult sSceneChangeDetectResult = { SIMILAR_SCENE };
   SPixMap sSrcPixMap;
@@ -610,9 +1141,9 @@ ESceneChangeIdc CWelsPreProcessVideo::DetectSceneChange (SPicture* pCurPicture,
   sRefPixMap.sRect.iRectHeight = pRefPicture->iHeightInPixel;
   sRefPixMap.eFormat = VIDEO_FORMAT_I420;
 
-  int32_t iRet = m_pInterfaceVp->Process (iMethodIdx, &sSrcPixMap, &sRefPixMap);
+  int32_t iRet = pVp->Process (iMethodIdx, &sSrcPixMap, &sRefPixMap);
   if (iRet == 0) {
-    m_pInterfaceVp->Get (iMethodIdx, (void*)&sSceneChangeDetectResult);
+    pVp->Get (iMethodIdx, (void*)&sSceneChangeDetectResult);
     //bSceneChangeFlag = (sSceneChangeDetectResult.eSceneChangeIdc == LARGE_CHANGED_SCENE) ? true : false;
   }
   return sSceneChangeDetectResult.eSceneChangeIdc;
@@ -622,8 +1153,9 @@ SPicture* CWelsPreProcessVideo::GetCurrentOrigFrame (int32_t iDIdx) {
   return m_pSpatialPic[iDIdx][GetCurPicPosition (iDIdx)];
 }
 
-int32_t CWelsPreProcess::DownsamplePadding (SPicture* pSrc, SPicture* pDstPic,  int32_t iSrcWidth, int32_t iSrcHeight,
-    int32_t iShrinkWidth, int32_t iShrinkHeight, int32_t iTargetWidth, int32_t iTargetHeight, bool bForceCopy) {
+int32_t CWelsPreProcess::DownsamplePadding (IWelsVP* pVp, SPicture* pSrc, SPicture* pDstPic,  int32_t iSrcWidth,
+    int32_t iSrcHeight, int32_t iShrinkWidth, int32_t iShrinkHeight, int32_t iTargetWidth, int32_t iTargetHeight,
+    bool bForceCopy) {
   int32_t iRet = 0;
   SPixMap sSrcPixMap;
   SPixMap sDstPicMap;
@@ -654,7 +1186,7 @@ int32_t CWelsPreProcess::DownsamplePadding (SPicture* pSrc, SPicture* pDstPic,
     sDstPicMap.eFormat     = VIDEO_FORMAT_I420;
 
     if (iSrcWidth != iShrinkWidth || iSrcHeight != iShrinkHeight) {
-      iRet = m_pInterfaceVp->Process (iMethodIdx, &sSrcPixMap, &sDstPicMap);
+      iRet = pVp->Process (iMethodIdx, &sSrcPixMap, &sDstPicMap);
     } else {
       WelsMoveMemory_c (pDstPic->pData[0], pDstPic->pData[1], pDstPic->pData[2], pDstPic->iLineSize[0], pDstPic->iLineSize[1],
                         pSrc->pData[0], pSrc->pData[1], pSrc->pData[2], pSrc->iLineSize[0], pSrc->iLineSize[1],
@@ -673,9 +1205,44 @@ int32_t CWelsPreProcess::DownsamplePadding (SPicture* pSrc, SPicture* pDstPic,
   return iRet;
 }
 
+/*!
+ * \brief   halve the MB aligned kiWidth x kiHeight area of pSrc kiLevelNum times, each level from the previous
+ */
+void CWelsPreProcess::DownsamplePyramid (SPicture* pSrc, const int32_t kiWidth, const int32_t kiHeight,
+    SPicture** ppPlanes, const int32_t kiLevelNum) {
+  DownsamplePyramid (m_pInterfaceVp, pSrc, kiWidth, kiHeight, ppPlanes, kiLevelNum);
+}
+
+void CWelsPreProcess::DownsamplePyramid (IWelsVP* pVp, SPicture* pSrc, const int32_t kiWidth, const int32_t kiHeight,
+    SPicture** ppPlanes, const int32_t kiLevelNum) {
+  SPixMap sSrcPixMap;
+  SPixMap sDstPixMap;
+  int32_t iWidth = kiWidth;
+  int32_t iHeight = kiHeight;
+  memset (&sSrcPixMap, 0, sizeof (sSrcPixMap));
+  memset (&sDstPixMap, 0, sizeof (sDstPixMap));
+
+  InitPixMap (pSrc, &sSrcPixMap);
+  sSrcPixMap.iStride[2] = pSrc->iLineSize[2];
+  for (int32_t i = 0; i < kiLevelNum; i++) {
+    sSrcPixMap.sRect.iRectWidth  = iWidth;
+    sSrcPixMap.sRect.iRectHeight = iHeight;
+    iWidth >>= 1;
+    iHeight >>= 1;
+    InitPixMap (ppPlanes[i], &sDstPixMap);
+    // the searches on the planes look at luma only
+    sDstPixMap.pPixel[1] = sDstPixMap.pPixel[2] = NULL;
+    sDstPixMap.sRect.iRectWidth  = iWidth;
+    sDstPixMap.sRect.iRectHeight = iHeight;
+    pVp->Process (METHOD_DOWNSAMPLE, &sSrcPixMap, &sDstPixMap);
+    memcpy (&sSrcPixMap, &sDstPixMap, sizeof (sSrcPixMap)); // confirmed_safe_unsafe_usage
+  }
+}
+
 //*********************************************************************************************************/
-void CWelsPreProcess::VaaCalculation (SVAAFrameInfo* pVaaInfo, SPicture* pCurPicture, SPicture* pRefPicture,
-                                      bool bCalculateSQDiff, bool bCalculateVar, bool bCalculateBGD) {
+void CWelsPreProcess::VaaCalculation (IWelsVP* pVp, SVAAFrameInfo* pVaaInfo, SPicture* pCurPicture,
+                                      SPicture* pRefPicture, bool bCalculateSQDiff, bool bCalculateVar,
+                                      bool bCalculateBGD) {
   pVaaInfo->sVaaCalcInfo.pCurY = pCurPicture->pData[0];
   pVaaInfo->sVaaCalcInfo.pRefY = pRefPicture->pData[0];
   {
@@ -705,13 +1272,13 @@ void CWelsPreProcess::VaaCalculation (SVAAFrameInfo* pVaaInfo, SPicture* pCurPic
     calc_param.iCalcSsd = bCalculateSQDiff;
     calc_param.pCalcResult = &pVaaInfo->sVaaCalcInfo;
 
-    m_pInterfaceVp->Set (iMethodIdx, &calc_param);
-    m_pInterfaceVp->Process (iMethodIdx, &sCurPixMap, &sRefPixMap);
+    pVp->Set (iMethodIdx, &calc_param);
+    pVp->Process (iMethodIdx, &sCurPixMap, &sRefPixMap);
   }
 }
 
-void CWelsPreProcess::BackgroundDetection (SVAAFrameInfo* pVaaInfo, SPicture* pCurPicture, SPicture* pRefPicture,
-    bool bDetectFlag) {
+void CWelsPreProcess::BackgroundDetection (IWelsVP* pVp, SVAAFrameInfo* pVaaInfo, SPicture* pCurPicture,
+    SPicture* pRefPicture, bool bDetectFlag) {
   if (bDetectFlag) {
     pVaaInfo->iPicWidth     = pCurPicture->iWidthInPixel;
     pVaaInfo->iPicHeight    = pCurPicture->iHeightInPixel;
@@ -756,8 +1323,8 @@ void CWelsPreProcess::BackgroundDetection (SVAAFrameInfo* pVaaInfo, SPicture* pC
 
     BGDParam.pBackgroundMbFlag = pVaaInfo->pVaaBackgroundMbFlag;
     BGDParam.pCalcRes = & (pVaaInfo->sVaaCalcInfo);
-    m_pInterfaceVp->Set (iMethodIdx, (void*)&BGDParam);
-    m_pInterfaceVp->Process (iMethodIdx, &sSrcPixMap, &sRefPixMap);
+    pVp->Set (iMethodIdx, (void*)&BGDParam);
+    pVp->Process (iMethodIdx, &sSrcPixMap, &sRefPixMap);
   } else {
     int32_t iPicWidthInMb  = (pCurPicture->iWidthInPixel  + 15) >> 4;
     int32_t iPicHeightInMb = (pCurPicture->iHeightInPixel + 15) >> 4;
@@ -765,7 +1332,8 @@ void CWelsPreProcess::BackgroundDetection (SVAAFrameInfo* pVaaInfo, SPicture* pC
   }
 }
 
-void CWelsPreProcess::AdaptiveQuantCalculation (SVAAFrameInfo* pVaaInfo, SPicture* pCurPicture, SPicture* pRefPicture) {
+void CWelsPreProcess::AdaptiveQuantCalculation (IWelsVP* pVp, SVAAFrameInfo* pVaaInfo, SPicture* pCurPicture,
+    SPicture* pRefPicture) {
   pVaaInfo->sAdaptiveQuantParam.pCalcResult = & (pVaaInfo->sVaaCalcInfo);
   pVaaInfo->sAdaptiveQuantParam.iAverMotionTextureIndexToDeltaQp = 0;
 
@@ -791,10 +1359,10 @@ void CWelsPreProcess::AdaptiveQuantCalculation (SVAAFrameInfo* pVaaInfo, SPictur
     pRef.sRect.iRectHeight = pRefPicture->iHeightInPixel;
     pRef.eFormat = VIDEO_FORMAT_I420;
 
-    iRet = m_pInterfaceVp->Set (iMethodIdx, (void*) & (pVaaInfo->sAdaptiveQuantParam));
-    iRet = m_pInterfaceVp->Process (iMethodIdx, &pSrc, &pRef);
+    iRet = pVp->Set (iMethodIdx, (void*) & (pVaaInfo->sAdaptiveQuantParam));
+    iRet = pVp->Process (iMethodIdx, &pSrc, &pRef);
     if (iRet == 0)
-      m_pInterfaceVp->Get (iMethodIdx, (void*) & (pVaaInfo->sAdaptiveQuantParam));
+      pVp->Get (iMethodIdx, (void*) & (pVaaInfo->sAdaptiveQuantParam));
   }
 }
 
@@ -1384,11 +1952,15 @@ void  WelsMoveMemory_c (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV,  int32_t
   }
 }
 
-void  CWelsPreProcess::WelsMoveMemoryWrapper (SWelsSvcCodingParam* pSvcParam, SPicture* pDstPic,
+/*!
+ * \brief   copy or convert the input into the source picture
+ * \return  0 - success; otherwise the input is invalid or its format is not supported
+ */
+int32_t CWelsPreProcess::WelsMoveMemoryWrapper (SWelsSvcCodingParam* pSvcParam, SPicture* pDstPic,
     const SSourcePicture* kpSrc,
     const int32_t kiTargetWidth, const int32_t kiTargetHeight) {
   if (VIDEO_FORMAT_I420 != (kpSrc->iColorFormat & (~VIDEO_FORMAT_VFlip)))
-    return;
+    return ColorspaceConvert (pSvcParam, pDstPic, kpSrc, kiTargetWidth, kiTargetHeight);
 
   int32_t  iSrcWidth       = kpSrc->iPicWidth;
   int32_t  iSrcHeight      = kpSrc->iPicHeight;
@@ -1423,30 +1995,35 @@ void  CWelsPreProcess::WelsMoveMemoryWrapper (SWelsSvcCodingParam* pSvcParam, SP
 
   if (pSrcY) {
     if (iSrcWidth <= 0 || iSrcHeight <= 0 || (iSrcWidth * iSrcHeight > (MAX_MBS_PER_FRAME << 8)))
-      return;
+      return 1;
     if (kiSrcTopOffsetY >= iSrcHeight || kiSrcLeftOffsetY >= iSrcWidth || iSrcWidth > kiSrcStrideY)
-      return;
+      return 1;
   }
   if (pDstY) {
     if (kiTargetWidth <= 0 || kiTargetHeight <= 0 || (kiTargetWidth * kiTargetHeight > (MAX_MBS_PER_FRAME << 8)))
-      return;
+      return 1;
     if (kiTargetWidth > kiDstStrideY)
-      return;
+      return 1;
   }
 
   if (pSrcY == NULL || pSrcU == NULL || pSrcV == NULL || pDstY == NULL || pDstU == NULL || pDstV == NULL
       || (iSrcWidth & 1) || (iSrcHeight & 1)) {
+    return 1;
   } else {
+    // input filled in place through ENCODER_OPTION_GET_SOURCE_BUFFER is already where it belongs
+    const bool kbInPlace = (pSrcY == pDstY && pSrcU == pDstU && pSrcV == pDstV && kiSrcStrideY == kiDstStrideY
+                            && kiSrcStrideUV == kiDstStrideUV && kpSrc->iStride[2] == pDstPic->iLineSize[2]);
     //i420_to_i420_c
-    WelsMoveMemory_c (pDstY,  pDstU,  pDstV,  kiDstStrideY, kiDstStrideUV,
-                      pSrcY,  pSrcU,  pSrcV, kiSrcStrideY, kiSrcStrideUV, iSrcWidth, iSrcHeight);
+    if (!kbInPlace)
+      WelsMoveMemory_c (pDstY,  pDstU,  pDstV,  kiDstStrideY, kiDstStrideUV,
+                        pSrcY,  pSrcU,  pSrcV, kiSrcStrideY, kiSrcStrideUV, iSrcWidth, iSrcHeight);
 
     //in VP Process
     if (kiTargetWidth > iSrcWidth || kiTargetHeight > iSrcHeight) {
       Padding (pDstY, pDstU, pDstV, kiDstStrideY, kiDstStrideUV, iSrcWidth, kiTargetWidth, iSrcHeight, kiTargetHeight);
     }
   }
-
+  return 0;
 }
 
 bool CWelsPreProcess::GetSceneChangeFlag (ESceneChangeIdc eSceneChangeIdc) {
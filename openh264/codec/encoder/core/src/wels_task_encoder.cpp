@@ -52,6 +52,7 @@
 #include "svc_enc_golomb.h"
 #include "svc_encode_slice.h"
 #include "slice_multi_threading.h"
+#include "deblocking.h"
 
 namespace WelsEnc {
 
@@ -336,6 +337,77 @@ WelsErrorType CWelsUpdateMbMapTask::Execute() {
   return ENC_RETURN_SUCCESS;
 }
 
+CWelsWavefrontMdTask::CWelsWavefrontMdTask (WelsCommon::IWelsTaskSink* pSink, sWelsEncCtx* pCtx,
+    const int32_t iWorkerIdx): CWelsBaseTask (pSink) {
+  m_pCtx = pCtx;
+  m_iWorkerIdx = iWorkerIdx;
+}
+
+CWelsWavefrontMdTask::~CWelsWavefrontMdTask() {
+}
+
+WelsErrorType CWelsWavefrontMdTask::Execute() {
+  WelsMdInterMbRowsWavefront (m_pCtx, m_iWorkerIdx);
+  return ENC_RETURN_SUCCESS;
+}
+
+CWelsDeblockingTask::CWelsDeblockingTask (WelsCommon::IWelsTaskSink* pSink, sWelsEncCtx* pCtx): CWelsBaseTask (pSink) {
+  m_pCtx = pCtx;
+}
+
+CWelsDeblockingTask::~CWelsDeblockingTask() {
+}
+
+WelsErrorType CWelsDeblockingTask::Execute() {
+  DeblockingFilterRowsWavefront (m_pCtx);
+  return ENC_RETURN_SUCCESS;
+}
+
+CWelsPreprocessTask::CWelsPreprocessTask (sWelsEncCtx* pCtx) : CWelsBaseTask (NULL) {
+  m_pSink = this;
+  m_pCtx = pCtx;
+  m_pSrcPic = NULL;
+  m_iSet = 0;
+  m_eTaskResult = ENC_RETURN_SUCCESS;
+  m_iWaitTaskNum = 0;
+  WelsEventOpen (&m_hTaskEvent);
+  WelsMutexInit (&m_hEventMutex);
+}
+
+CWelsPreprocessTask::~CWelsPreprocessTask() {
+  WelsEventClose (&m_hTaskEvent);
+  WelsMutexDestroy (&m_hEventMutex);
+}
+
+void CWelsPreprocessTask::SetSource (const SSourcePicture* kpSrcPic, const int32_t kiSet) {
+  m_pSrcPic = kpSrcPic;
+  m_iSet = kiSet;
+  m_eTaskResult = ENC_RETURN_SUCCESS;
+  m_iWaitTaskNum = 1;
+}
+
+WelsErrorType CWelsPreprocessTask::Execute() {
+  if (0 != m_pCtx->pVpp->StagePicture (m_pCtx, m_pSrcPic, m_iSet))
+    m_eTaskResult = ENC_RETURN_MEMALLOCERR;
+  return m_eTaskResult;
+}
+
+int CWelsPreprocessTask::OnTaskExecuted() {
+  WelsEventSignal (&m_hTaskEvent, &m_hEventMutex, &m_iWaitTaskNum);
+  return ENC_RETURN_SUCCESS;
+}
+
+int CWelsPreprocessTask::OnTaskCancelled() {
+  m_eTaskResult = ENC_RETURN_UNEXPECTED;
+  WelsEventSignal (&m_hTaskEvent, &m_hEventMutex, &m_iWaitTaskNum);
+  return ENC_RETURN_SUCCESS;
+}
+
+WelsErrorType CWelsPreprocessTask::WaitExecuted() {
+  WelsEventWait (&m_hTaskEvent, &m_hEventMutex, m_iWaitTaskNum);
+  return m_eTaskResult;
+}
+
 }
 
 
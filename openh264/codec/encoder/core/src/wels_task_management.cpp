@@ -76,12 +76,16 @@ IWelsTaskManage*   IWelsTaskManage::CreateTaskManage (sWelsEncCtx* pCtx, const i
 CWelsTaskManageBase::CWelsTaskManageBase()
   : m_pEncCtx (NULL),
     m_pThreadPool (NULL),
-    m_iWaitTaskNum (0) {
+    m_pPreprocessTask (NULL),
+    m_iWaitTaskNum (0),
+    m_bAsyncTasksQueued (false) {
 
   for (int32_t iDid = 0; iDid < MAX_DEPENDENCY_LAYER; iDid++) {
     m_iTaskNum[iDid] = 0;
     m_cEncodingTaskList[iDid] = new TASKLIST_TYPE();
     m_cPreEncodingTaskList[iDid] = new TASKLIST_TYPE();
+    m_cWavefrontMdTaskList[iDid] = new TASKLIST_TYPE();
+    m_cDeblockingTaskList[iDid] = new TASKLIST_TYPE();
   }
 
   WelsEventOpen (&m_hTaskEvent);
@@ -98,10 +102,14 @@ WelsErrorType CWelsTaskManageBase::Init (sWelsEncCtx* pEncCtx) {
   m_iThreadNum = m_pEncCtx->pSvcParam->iMultipleThreadIdc;
 
   int32_t iReturn = ENC_RETURN_SUCCESS;
-  //fprintf(stdout, "m_pThreadPool = &(CWelsThreadPool::GetInstance, this=%x\n", this);
-  iReturn = CWelsThreadPool::SetThreadNum (m_iThreadNum);
-  m_pThreadPool = (CWelsThreadPool::AddReference());
-  if ((iReturn != ENC_RETURN_SUCCESS) && pEncCtx) {
+  if (m_pEncCtx->pSvcParam->bThreadPoolParam) {
+    iReturn = CreateOwnThreadPool (m_pEncCtx->pSvcParam->sThreadPool);
+  } else {
+    //fprintf(stdout, "m_pThreadPool = &(CWelsThreadPool::GetInstance, this=%x\n", this);
+    iReturn = CWelsThreadPool::SetThreadNum (m_iThreadNum);
+    m_pThreadPool = (CWelsThreadPool::AddReference());
+  }
+  if ((iReturn != ENC_RETURN_SUCCESS) && pEncCtx && m_pThreadPool) {
     int32_t current_thread_num = m_pThreadPool->GetThreadNum();
     if (m_iThreadNum != current_thread_num) {
       WelsLog (& (pEncCtx->sLogCtx), WELS_LOG_WARNING,
@@ -116,15 +124,40 @@ WelsErrorType CWelsTaskManageBase::Init (sWelsEncCtx* pEncCtx) {
   for (int32_t iDid = 0; iDid < MAX_DEPENDENCY_LAYER; iDid++) {
     m_pcAllTaskList[CWelsBaseTask::WELS_ENC_TASK_ENCODING][iDid] = m_cEncodingTaskList[iDid];
     m_pcAllTaskList[CWelsBaseTask::WELS_ENC_TASK_UPDATEMBMAP][iDid] = m_cPreEncodingTaskList[iDid];
+    m_pcAllTaskList[CWelsBaseTask::WELS_ENC_TASK_WAVEFRONT_MD][iDid] = m_cWavefrontMdTaskList[iDid];
+    m_pcAllTaskList[CWelsBaseTask::WELS_ENC_TASK_DEBLOCKING][iDid] = m_cDeblockingTaskList[iDid];
     iReturn |= CreateTasks (pEncCtx, iDid);
   }
+  if (pEncCtx->pSvcParam->bEnableFramePipeline) {
+    m_pPreprocessTask = WELS_NEW_OP (CWelsPreprocessTask (pEncCtx), CWelsPreprocessTask);
+    WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == m_pPreprocessTask)
+  }
 
   //fprintf(stdout, "CWelsTaskManageBase Init m_iThreadNum %d m_iCurrentTaskNum %d pEncCtx->iMaxSliceCount %d\n", m_iThreadNum, m_iCurrentTaskNum, pEncCtx->iMaxSliceCount);
   return iReturn;
 }
 
+WelsErrorType CWelsTaskManageBase::CreateOwnThreadPool (const SThreadPoolParam& kParam) {
+  const int32_t kiThreadNum = (kParam.iThreadNum > 0) ? kParam.iThreadNum : m_iThreadNum;
+  const int32_t kiCpuNum = WELS_CLIP3 (kParam.iAffinityCpuNum, 0, MAX_THREAD_AFFINITY_CPU_NUM);
+  int32_t iAffinityCpus[MAX_THREAD_AFFINITY_CPU_NUM];
+  for (int32_t i = 0; i < kiCpuNum; i++) {
+    iAffinityCpus[i] = kParam.iAffinityCpu[i];
+  }
+
+  char szPoolName[MAX_THREAD_POOL_NAME_LEN];
+  memcpy (szPoolName, kParam.szPoolName, MAX_THREAD_POOL_NAME_LEN);
+  szPoolName[MAX_THREAD_POOL_NAME_LEN - 1] = '\0';
+  m_pThreadPool = CWelsThreadPool::AddNamedReference (szPoolName, kiThreadNum, iAffinityCpus, kiCpuNum);
+  WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == m_pThreadPool)
+
+  // a named pool keeps the size given by its first user
+  return (m_pThreadPool->GetThreadNum() == kiThreadNum) ? ENC_RETURN_SUCCESS : ENC_RETURN_UNEXPECTED;
+}
+
 void   CWelsTaskManageBase::Uninit() {
   DestroyTasks();
+  WELS_DELETE_OP (m_pPreprocessTask);
   //fprintf(stdout, "m_pThreadPool = m_pThreadPool->RemoveInstance\n");
   if (m_pThreadPool)
     m_pThreadPool->RemoveInstance();
@@ -135,6 +168,8 @@ void   CWelsTaskManageBase::Uninit() {
   for (int32_t iDid = 0; iDid < MAX_DEPENDENCY_LAYER; iDid++) {
     WELS_DELETE_OP (m_cEncodingTaskList[iDid]);
     WELS_DELETE_OP (m_cPreEncodingTaskList[iDid]);
+    WELS_DELETE_OP (m_cWavefrontMdTaskList[iDid]);
+    WELS_DELETE_OP (m_cDeblockingTaskList[iDid]);
   }
   WelsEventClose (&m_hTaskEvent);
   WelsMutexDestroy (&m_hEventMutex);
@@ -172,6 +207,22 @@ WelsErrorType CWelsTaskManageBase::CreateTasks (sWelsEncCtx* pEncCtx, const int3
     WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, true != m_cEncodingTaskList[kiCurDid]->push_back (pTask));
   }
 
+  //one MB-row wavefront worker per thread, rows are claimed dynamically by the workers
+  if (pEncCtx->pSvcParam->bUseWavefrontMd && uiSliceMode == SM_SINGLE_SLICE) {
+    for (int idx = 0; idx < pEncCtx->iActiveThreadsNum; idx++) {
+      pTask = WELS_NEW_OP (CWelsWavefrontMdTask (this, pEncCtx, idx), CWelsWavefrontMdTask);
+      WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pTask)
+      WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, true != m_cWavefrontMdTaskList[kiCurDid]->push_back (pTask));
+    }
+  }
+
+  //MB-row wavefront deblocking, the encoding thread works on the rows as well
+  for (int idx = 0; idx < pEncCtx->pSvcParam->iMultipleThreadIdc - 1; idx++) {
+    pTask = WELS_NEW_OP (CWelsDeblockingTask (this, pEncCtx), CWelsDeblockingTask);
+    WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, NULL == pTask)
+    WELS_VERIFY_RETURN_IF (ENC_RETURN_MEMALLOCERR, true != m_cDeblockingTaskList[kiCurDid]->push_back (pTask));
+  }
+
   //fprintf(stdout, "CWelsTaskManageBase CreateTasks m_iThreadNum %d kiTaskCount=%d\n", m_iThreadNum, kiTaskCount);
   return ENC_RETURN_SUCCESS;
 }
@@ -191,6 +242,8 @@ void CWelsTaskManageBase::DestroyTasks() {
     if (m_iTaskNum[iDid] > 0) {
       DestroyTaskList (m_cEncodingTaskList[iDid]);
       DestroyTaskList (m_cPreEncodingTaskList[iDid]);
+      DestroyTaskList (m_cWavefrontMdTaskList[iDid]);
+      DestroyTaskList (m_cDeblockingTaskList[iDid]);
       m_iTaskNum[iDid] = 0;
       m_pcAllTaskList[CWelsBaseTask::WELS_ENC_TASK_ENCODING][iDid] = NULL;
     }
@@ -254,6 +307,45 @@ WelsErrorType  CWelsTaskManageBase::ExecuteTasks (const CWelsBaseTask::ETaskType
   return ExecuteTaskList (m_pcAllTaskList[iTaskType]);
 }
 
+WelsErrorType  CWelsTaskManageBase::ExecuteTasksAsync (const CWelsBaseTask::ETaskType iTaskType) {
+  TASKLIST_TYPE* pTargetTaskList = m_pcAllTaskList[iTaskType][m_iCurDid];
+  m_iWaitTaskNum = pTargetTaskList->size();
+  if (0 == m_iWaitTaskNum) {
+    return ENC_RETURN_SUCCESS;
+  }
+
+  int32_t iCurrentTaskCount = m_iWaitTaskNum;
+  int32_t iIdx = 0;
+  while (iIdx < iCurrentTaskCount) {
+    m_pThreadPool->QueueTask (pTargetTaskList->getNode (iIdx));
+    iIdx ++;
+  }
+  m_bAsyncTasksQueued = true;
+  return ENC_RETURN_SUCCESS;
+}
+
+WelsErrorType  CWelsTaskManageBase::WaitTasks() {
+  if (m_bAsyncTasksQueued) {
+    WelsEventWait (&m_hTaskEvent, &m_hEventMutex, m_iWaitTaskNum);
+    m_bAsyncTasksQueued = false;
+  }
+  return ENC_RETURN_SUCCESS;
+}
+
+WelsErrorType  CWelsTaskManageBase::ExecutePreprocessAsync (const SSourcePicture* kpSrcPic, const int32_t kiSet) {
+  if (NULL == m_pPreprocessTask)
+    return ENC_RETURN_UNSUPPORTED_PARA;
+
+  m_pPreprocessTask->SetSource (kpSrcPic, kiSet);
+  if (WELS_THREAD_ERROR_OK != m_pThreadPool->QueueTask (m_pPreprocessTask))
+    return ENC_RETURN_UNEXPECTED;
+  return ENC_RETURN_SUCCESS;
+}
+
+WelsErrorType  CWelsTaskManageBase::WaitPreprocess() {
+  return m_pPreprocessTask->WaitExecuted();
+}
+
 int32_t  CWelsTaskManageBase::GetThreadPoolThreadNum() {
   return m_pThreadPool->GetThreadNum();
 }
@@ -0,0 +1,457 @@
+;*!
+;* \copy
+;*     Copyright (c)  2009-2013, Cisco Systems
+;*     All rights reserved.
+;*
+;*     Redistribution and use in source and binary forms, with or without
+;*     modification, are permitted provided that the following conditions
+;*     are met:
+;*
+;*        * Redistributions of source code must retain the above copyright
+;*          notice, this list of conditions and the following disclaimer.
+;*
+;*        * Redistributions in binary form must reproduce the above copyright
+;*          notice, this list of conditions and the following disclaimer in
+;*          the documentation and/or other materials provided with the
+;*          distribution.
+;*
+;*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+;*     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+;*     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+;*     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+;*     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+;*     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+;*     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+;*     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+;*     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+;*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+;*     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+;*     POSSIBILITY OF SUCH DAMAGE.
+;*
+;*
+;*  colorspace_convert.asm
+;*
+;*  Abstract
+;*      packed RGB / NV12 to I420 conversion of the encoder input
+;*
+;*  History
+;*      10/17/2026 Created
+;*
+;*
+;*************************************************************************/
+
+%include "asm_inc.asm"
+
+;***********************************************************************
+; Local Data (Read Only)
+;***********************************************************************
+%ifndef X86_32
+
+SECTION .rodata align=16
+
+; BT.601 limited range, 8 bit fixed point, for pixels held as dwords in B G R x or R G B x order
+align 16
+bgrx_y_coef: times 4 dw 25, 129, 66, 0
+bgrx_u_coef: times 4 dw 112, -74, -38, 0
+bgrx_v_coef: times 4 dw -18, -94, 112, 0
+rgbx_y_coef: times 4 dw 66, 129, 25, 0
+rgbx_u_coef: times 4 dw -38, -74, 112, 0
+rgbx_v_coef: times 4 dw 112, -94, -18, 0
+y_round: times 8 dd 4224                ; 128 + (16 << 8)
+uv_round: times 8 dd 32896              ; 128 + (128 << 8)
+avg_round: times 16 dw 2
+bgr_to_bgrx_shuf: times 2 db 0, 1, 2, 0x80, 3, 4, 5, 0x80, 6, 7, 8, 0x80, 9, 10, 11, 0x80
+
+%endif
+
+;***********************************************************************
+; Code
+;***********************************************************************
+
+SECTION .text
+
+%ifndef X86_32
+
+; the packed kernels convert 2 rows, r0 = pDstY, r1 = iDstStrideY, r2 = pDstU, r3 = pDstV, r4 = pSrc,
+; r5 = iSrcStride, r6 = iWidth which counts down; every pixel is unpacked into a dword of the order
+; the coefficients are given in and a 2x2 block is averaged before its U and V are computed
+
+; dst = [s0 + s1, s2 + s3, d0 + d1, d2 + d3] of the dwords s in dst and d in src, src is destroyed
+%macro SSE2_HAddPairD 3 ; dst, src, tmp
+    movaps          %3, %1
+    shufps          %1, %2, 0x88
+    shufps          %3, %2, 0xdd
+    paddd           %1, %3
+%endmacro
+
+; dst = 4 dwords c0 * w0 + c1 * w1 + c2 * w2 of the pixels held as words in lo (0, 1) and hi (2, 3)
+%macro SSE2_WeightPx4 5 ; dst, lo, hi, coef, tmp
+    movdqa          %1, %2
+    pmaddwd         %1, %4
+    movdqa          xmm14, %3
+    pmaddwd         xmm14, %4
+    SSE2_HAddPairD  %1, xmm14, %5
+%endmacro
+
+; 4 pixels of 3 bytes at p into the dwords of dst, the byte following them is read too
+%macro SSE2_LoadBgr4P 4 ; dst, tmp, tmp2, p
+    movd            %1, [%4]
+    movd            %2, [%4 + 3]
+    punpckldq       %1, %2
+    movd            %2, [%4 + 6]
+    movd            %3, [%4 + 9]
+    punpckldq       %2, %3
+    punpcklqdq      %1, %2
+%endmacro
+
+; 8 pixels of row 0 into xmm0, xmm1 and of row 1 into xmm2, xmm3
+%macro SSE2_LoadBgr8Px2Rows 0
+    SSE2_LoadBgr4P  xmm0, xmm4, xmm5, r4
+    SSE2_LoadBgr4P  xmm1, xmm4, xmm5, r4 + 12
+    SSE2_LoadBgr4P  xmm2, xmm4, xmm5, r4 + r5
+    SSE2_LoadBgr4P  xmm3, xmm4, xmm5, r4 + r5 + 12
+%endmacro
+
+%macro SSE2_LoadBgrx8Px2Rows 0
+    movdqu          xmm0, [r4]
+    movdqu          xmm1, [r4 + 16]
+    movdqu          xmm2, [r4 + r5]
+    movdqu          xmm3, [r4 + r5 + 16]
+%endmacro
+
+%macro SSE2_PackedToI420TwoRows 5 ; load macro, bytes per pixel, y coef, u coef, v coef
+    %assign  push_num 0
+    LOAD_7_PARA
+    PUSH_XMM 16
+    SIGN_EXTENSION r1, r1d
+    SIGN_EXTENSION r5, r5d
+    SIGN_EXTENSION r6, r6d
+    pxor            xmm15, xmm15
+.loop:
+    %1
+    ; words of the pixels 0, 1 / 2, 3 of each 4: row 0 in xmm4 / xmm0, xmm5 / xmm1, row 1 in xmm6 / xmm2, xmm7 / xmm3
+    movdqa          xmm4, xmm0
+    punpcklbw       xmm4, xmm15
+    punpckhbw       xmm0, xmm15
+    movdqa          xmm5, xmm1
+    punpcklbw       xmm5, xmm15
+    punpckhbw       xmm1, xmm15
+    movdqa          xmm6, xmm2
+    punpcklbw       xmm6, xmm15
+    punpckhbw       xmm2, xmm15
+    movdqa          xmm7, xmm3
+    punpcklbw       xmm7, xmm15
+    punpckhbw       xmm3, xmm15
+
+    SSE2_WeightPx4  xmm8, xmm4, xmm0, [%3], xmm12
+    SSE2_WeightPx4  xmm9, xmm5, xmm1, [%3], xmm12
+    SSE2_WeightPx4  xmm10, xmm6, xmm2, [%3], xmm12
+    SSE2_WeightPx4  xmm11, xmm7, xmm3, [%3], xmm12
+    movdqa          xmm12, [y_round]
+    paddd           xmm8, xmm12
+    paddd           xmm9, xmm12
+    paddd           xmm10, xmm12
+    paddd           xmm11, xmm12
+    psrld           xmm8, 8
+    psrld           xmm9, 8
+    psrld           xmm10, 8
+    psrld           xmm11, 8
+    packssdw        xmm8, xmm9
+    packssdw        xmm10, xmm11
+    packuswb        xmm8, xmm10
+    movq            [r0], xmm8
+    movhps          [r0 + r1], xmm8
+
+    ; 2x2 block sums, then the rounded averages of the blocks 0, 1 in xmm4 and 2, 3 in xmm5
+    paddw           xmm4, xmm6
+    paddw           xmm0, xmm2
+    paddw           xmm5, xmm7
+    paddw           xmm1, xmm3
+    movdqa          xmm2, xmm4
+    punpcklqdq      xmm4, xmm0
+    punpckhqdq      xmm2, xmm0
+    paddw           xmm4, xmm2
+    movdqa          xmm3, xmm5
+    punpcklqdq      xmm5, xmm1
+    punpckhqdq      xmm3, xmm1
+    paddw           xmm5, xmm3
+    movdqa          xmm12, [avg_round]
+    paddw           xmm4, xmm12
+    paddw           xmm5, xmm12
+    psrlw           xmm4, 2
+    psrlw           xmm5, 2
+
+    movdqa          xmm0, xmm4
+    pmaddwd         xmm0, [%4]
+    movdqa          xmm1, xmm5
+    pmaddwd         xmm1, [%4]
+    SSE2_HAddPairD  xmm0, xmm1, xmm2
+    pmaddwd         xmm4, [%5]
+    pmaddwd         xmm5, [%5]
+    SSE2_HAddPairD  xmm4, xmm5, xmm2
+    movdqa          xmm12, [uv_round]
+    paddd           xmm0, xmm12
+    paddd           xmm4, xmm12
+    psrad           xmm0, 8
+    psrad           xmm4, 8
+    packssdw        xmm0, xmm4
+    packuswb        xmm0, xmm0
+    movd            [r2], xmm0
+    psrlq           xmm0, 32
+    movd            [r3], xmm0
+
+    add             r0, 8
+    add             r2, 4
+    add             r3, 4
+    add             r4, 8 * %2
+    sub             r6, 8
+    jg              .loop
+    POP_XMM
+    LOAD_7_PARA_POP
+    ret
+%endmacro
+
+;***********************************************************************
+;   void WelsBgrToI420TwoRows_sse2 (uint8_t* pDstY, int32_t iDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+;                                   const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth);
+;   iWidth is a multiple of 8, the byte following the last pixel of a row is read
+;***********************************************************************
+WELS_EXTERN WelsBgrToI420TwoRows_sse2
+    SSE2_PackedToI420TwoRows SSE2_LoadBgr8Px2Rows, 3, bgrx_y_coef, bgrx_u_coef, bgrx_v_coef
+
+;***********************************************************************
+;   void WelsBgraToI420TwoRows_sse2 (uint8_t* pDstY, int32_t iDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+;                                    const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth);
+;   iWidth is a multiple of 8
+;***********************************************************************
+WELS_EXTERN WelsBgraToI420TwoRows_sse2
+    SSE2_PackedToI420TwoRows SSE2_LoadBgrx8Px2Rows, 4, bgrx_y_coef, bgrx_u_coef, bgrx_v_coef
+
+;***********************************************************************
+;   void WelsRgbaToI420TwoRows_sse2 (uint8_t* pDstY, int32_t iDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+;                                    const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth);
+;   iWidth is a multiple of 8
+;***********************************************************************
+WELS_EXTERN WelsRgbaToI420TwoRows_sse2
+    SSE2_PackedToI420TwoRows SSE2_LoadBgrx8Px2Rows, 4, rgbx_y_coef, rgbx_u_coef, rgbx_v_coef
+
+%endif ; !X86_32
+
+;***********************************************************************
+;   void WelsDeinterleaveUVRow_sse2 (uint8_t* pDstU, uint8_t* pDstV, const uint8_t* kpSrcUV, int32_t iWidthUV);
+;   iWidthUV is a multiple of 16
+;***********************************************************************
+WELS_EXTERN WelsDeinterleaveUVRow_sse2
+    %assign  push_num 0
+    LOAD_4_PARA
+    SIGN_EXTENSION r3, r3d
+    pcmpeqw         xmm4, xmm4
+    psrlw           xmm4, 8
+.loop:
+    movdqu          xmm0, [r2]
+    movdqu          xmm1, [r2 + 16]
+    movdqa          xmm2, xmm0
+    movdqa          xmm3, xmm1
+    pand            xmm0, xmm4
+    pand            xmm1, xmm4
+    psrlw           xmm2, 8
+    psrlw           xmm3, 8
+    packuswb        xmm0, xmm1
+    packuswb        xmm2, xmm3
+    movdqu          [r0], xmm0
+    movdqu          [r1], xmm2
+    add             r0, 16
+    add             r1, 16
+    add             r2, 32
+    sub             r3, 16
+    jg              .loop
+    LOAD_4_PARA_POP
+    ret
+
+%ifdef HAVE_AVX2
+%ifndef X86_32
+
+; the AVX2 kernels hold the pixels 0-3 in the low lane and 4-7 in the high lane of a ymm
+
+%macro AVX2_HAddPairD 3 ; dst, src, tmp
+    vshufps         %3, %1, %2, 0xdd
+    vshufps         %1, %1, %2, 0x88
+    vpaddd          %1, %1, %3
+%endmacro
+
+%macro AVX2_WeightPx8 5 ; dst, lo, hi, coef, tmp
+    vpmaddwd        %1, %2, %4
+    vpmaddwd        ymm14, %3, %4
+    AVX2_HAddPairD  %1, ymm14, %5
+%endmacro
+
+; 8 pixels of 3 bytes at p into the dwords of dst, 4 bytes following them are read too
+%macro AVX2_LoadBgr8P 3 ; dst(mm#), p, shuffle
+    vmovdqu         x%1, [%2]
+    vinserti128     y%1, y%1, [%2 + 12], 1
+    vpshufb         y%1, y%1, %3
+%endmacro
+
+; 16 pixels of row 0 into ymm0, ymm1 and of row 1 into ymm2, ymm3
+%macro AVX2_LoadBgr16Px2Rows 0
+    vmovdqu         ymm13, [bgr_to_bgrx_shuf]
+    AVX2_LoadBgr8P  mm0, r4, ymm13
+    AVX2_LoadBgr8P  mm1, r4 + 24, ymm13
+    AVX2_LoadBgr8P  mm2, r4 + r5, ymm13
+    AVX2_LoadBgr8P  mm3, r4 + r5 + 24, ymm13
+%endmacro
+
+%macro AVX2_LoadBgrx16Px2Rows 0
+    vmovdqu         ymm0, [r4]
+    vmovdqu         ymm1, [r4 + 32]
+    vmovdqu         ymm2, [r4 + r5]
+    vmovdqu         ymm3, [r4 + r5 + 32]
+%endmacro
+
+%macro AVX2_PackedToI420TwoRows 5 ; load macro, bytes per pixel, y coef, u coef, v coef
+    %assign  push_num 0
+    LOAD_7_PARA
+    PUSH_XMM 16
+    SIGN_EXTENSION r1, r1d
+    SIGN_EXTENSION r5, r5d
+    SIGN_EXTENSION r6, r6d
+    vpxor           ymm15, ymm15, ymm15
+.loop:
+    %1
+    vpunpcklbw      ymm4, ymm0, ymm15
+    vpunpckhbw      ymm0, ymm0, ymm15
+    vpunpcklbw      ymm5, ymm1, ymm15
+    vpunpckhbw      ymm1, ymm1, ymm15
+    vpunpcklbw      ymm6, ymm2, ymm15
+    vpunpckhbw      ymm2, ymm2, ymm15
+    vpunpcklbw      ymm7, ymm3, ymm15
+    vpunpckhbw      ymm3, ymm3, ymm15
+
+    AVX2_WeightPx8  ymm8, ymm4, ymm0, [%3], ymm12
+    AVX2_WeightPx8  ymm9, ymm5, ymm1, [%3], ymm12
+    AVX2_WeightPx8  ymm10, ymm6, ymm2, [%3], ymm12
+    AVX2_WeightPx8  ymm11, ymm7, ymm3, [%3], ymm12
+    vmovdqu         ymm12, [y_round]
+    vpaddd          ymm8, ymm8, ymm12
+    vpaddd          ymm9, ymm9, ymm12
+    vpaddd          ymm10, ymm10, ymm12
+    vpaddd          ymm11, ymm11, ymm12
+    vpsrld          ymm8, ymm8, 8
+    vpsrld          ymm9, ymm9, 8
+    vpsrld          ymm10, ymm10, 8
+    vpsrld          ymm11, ymm11, 8
+    vpackssdw       ymm8, ymm8, ymm9
+    vpackssdw       ymm10, ymm10, ymm11
+    vpermq          ymm8, ymm8, 0xd8
+    vpermq          ymm10, ymm10, 0xd8
+    vpackuswb       ymm8, ymm8, ymm10
+    vpermq          ymm8, ymm8, 0xd8
+    vmovdqu         [r0], xmm8
+    vextracti128    [r0 + r1], ymm8, 1
+
+    vpaddw          ymm4, ymm4, ymm6
+    vpaddw          ymm0, ymm0, ymm2
+    vpaddw          ymm5, ymm5, ymm7
+    vpaddw          ymm1, ymm1, ymm3
+    vpunpcklqdq     ymm2, ymm4, ymm0
+    vpunpckhqdq     ymm4, ymm4, ymm0
+    vpaddw          ymm4, ymm4, ymm2
+    vpunpcklqdq     ymm3, ymm5, ymm1
+    vpunpckhqdq     ymm5, ymm5, ymm1
+    vpaddw          ymm5, ymm5, ymm3
+    vmovdqu         ymm12, [avg_round]
+    vpaddw          ymm4, ymm4, ymm12
+    vpaddw          ymm5, ymm5, ymm12
+    vpsrlw          ymm4, ymm4, 2
+    vpsrlw          ymm5, ymm5, 2
+
+    ; U and V of the blocks 0, 1, 4, 5 in the low lane and 2, 3, 6, 7 in the high lane
+    vpmaddwd        ymm0, ymm4, [%4]
+    vpmaddwd        ymm1, ymm5, [%4]
+    AVX2_HAddPairD  ymm0, ymm1, ymm2
+    vpmaddwd        ymm4, ymm4, [%5]
+    vpmaddwd        ymm5, ymm5, [%5]
+    AVX2_HAddPairD  ymm4, ymm5, ymm2
+    vmovdqu         ymm12, [uv_round]
+    vpaddd          ymm0, ymm0, ymm12
+    vpaddd          ymm4, ymm4, ymm12
+    vpsrad          ymm0, ymm0, 8
+    vpsrad          ymm4, ymm4, 8
+    vpackssdw       ymm0, ymm0, ymm4
+    vpackuswb       ymm0, ymm0, ymm0
+    vextracti128    xmm1, ymm0, 1
+    vpunpcklwd      xmm0, xmm0, xmm1
+    vmovq           [r2], xmm0
+    vmovhps         [r3], xmm0
+
+    add             r0, 16
+    add             r2, 8
+    add             r3, 8
+    add             r4, 16 * %2
+    sub             r6, 16
+    jg              .loop
+    vzeroupper
+    POP_XMM
+    LOAD_7_PARA_POP
+    ret
+%endmacro
+
+;***********************************************************************
+;   void WelsBgrToI420TwoRows_avx2 (uint8_t* pDstY, int32_t iDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+;                                   const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth);
+;   iWidth is a multiple of 16, the 4 bytes following the last pixel of a row are read
+;***********************************************************************
+WELS_EXTERN WelsBgrToI420TwoRows_avx2
+    AVX2_PackedToI420TwoRows AVX2_LoadBgr16Px2Rows, 3, bgrx_y_coef, bgrx_u_coef, bgrx_v_coef
+
+;***********************************************************************
+;   void WelsBgraToI420TwoRows_avx2 (uint8_t* pDstY, int32_t iDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+;                                    const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth);
+;   iWidth is a multiple of 16
+;***********************************************************************
+WELS_EXTERN WelsBgraToI420TwoRows_avx2
+    AVX2_PackedToI420TwoRows AVX2_LoadBgrx16Px2Rows, 4, bgrx_y_coef, bgrx_u_coef, bgrx_v_coef
+
+;***********************************************************************
+;   void WelsRgbaToI420TwoRows_avx2 (uint8_t* pDstY, int32_t iDstStrideY, uint8_t* pDstU, uint8_t* pDstV,
+;                                    const uint8_t* kpSrc, int32_t iSrcStride, int32_t iWidth);
+;   iWidth is a multiple of 16
+;***********************************************************************
+WELS_EXTERN WelsRgbaToI420TwoRows_avx2
+    AVX2_PackedToI420TwoRows AVX2_LoadBgrx16Px2Rows, 4, rgbx_y_coef, rgbx_u_coef, rgbx_v_coef
+
+%endif ; !X86_32
+
+;***********************************************************************
+;   void WelsDeinterleaveUVRow_avx2 (uint8_t* pDstU, uint8_t* pDstV, const uint8_t* kpSrcUV, int32_t iWidthUV);
+;   iWidthUV is a multiple of 32
+;***********************************************************************
+WELS_EXTERN WelsDeinterleaveUVRow_avx2
+    %assign  push_num 0
+    LOAD_4_PARA
+    SIGN_EXTENSION r3, r3d
+    vpcmpeqw        ymm4, ymm4, ymm4
+    vpsrlw          ymm4, ymm4, 8
+.loop:
+    vmovdqu         ymm0, [r2]
+    vmovdqu         ymm1, [r2 + 32]
+    vpand           ymm2, ymm0, ymm4
+    vpand           ymm3, ymm1, ymm4
+    vpsrlw          ymm0, ymm0, 8
+    vpsrlw          ymm1, ymm1, 8
+    vpackuswb       ymm2, ymm2, ymm3
+    vpackuswb       ymm0, ymm0, ymm1
+    vpermq          ymm2, ymm2, 0xd8
+    vpermq          ymm0, ymm0, 0xd8
+    vmovdqu         [r0], ymm2
+    vmovdqu         [r1], ymm0
+    add             r0, 32
+    add             r1, 32
+    add             r2, 64
+    sub             r3, 32
+    jg              .loop
+    vzeroupper
+    LOAD_4_PARA_POP
+    ret
+
+%endif ; HAVE_AVX2
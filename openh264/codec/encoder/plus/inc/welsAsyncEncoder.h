@@ -0,0 +1,110 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file    welsAsyncEncoder.h
+ *
+ * \brief   bounded queue and worker thread behind ISVCEncoder::EncodeFrameAsync()
+ *
+ * \date    10/16/2026 Created
+ *
+ *************************************************************************************
+ */
+
+#ifndef WELS_PLUS_WELS_ASYNC_ENCODER_H__
+#define WELS_PLUS_WELS_ASYNC_ENCODER_H__
+
+#include "codec_app_def.h"
+#include "typedefs.h"
+#include "WelsThread.h"
+
+#define ASYNC_QUEUE_DEPTH_DEFAULT   4
+#define ASYNC_QUEUE_DEPTH_MAX       32
+
+namespace WelsEnc {
+
+class CWelsH264SVCEncoder;
+
+enum EAsyncFrameState {
+  ASYNC_FRAME_FREE = 0,   // available for EncodeFrameAsync()
+  ASYNC_FRAME_QUEUED,     // waiting for or under encoding on the worker thread
+  ASYNC_FRAME_ENCODED,    // waiting for GetEncodedFrame()
+  ASYNC_FRAME_OUT         // owned by the application until ReleaseEncodedFrame()
+};
+
+/*
+ * The encoder writes the NALs of a frame straight into pBsBuf, so nothing is copied out of
+ * SLayerBSInfo. sFrame has to stay the first member, the application only sees SEncodedFrame.
+ */
+typedef struct TagAsyncFrame {
+  SEncodedFrame     sFrame;
+  SSourcePicture    sSrcPic;
+  int32_t*          pNalLen;         // copy of the NAL lengths, sFrame.sBsInfo points into it
+  int32_t           iBsCapacity;
+  int32_t           iNalCapacity;
+  EAsyncFrameState  eState;
+} SAsyncFrame;
+
+class CWelsAsyncEncoder : public WelsCommon::CWelsThread {
+ public:
+  CWelsAsyncEncoder (CWelsH264SVCEncoder* pEncoder, const int32_t kiQueueDepth);
+  virtual ~CWelsAsyncEncoder();
+
+  int32_t         Init();
+  int32_t         Submit (const SSourcePicture* kpSrcPic, void* pUserData);
+  int32_t         GetEncodedFrame (SEncodedFrame** ppFrame, const bool kbWait);
+  int32_t         ReleaseFrame (SEncodedFrame* pFrame);
+  bool            HasFramesInFlight();
+  int32_t         GetQueueDepth() const {
+    return m_iQueueDepth;
+  }
+
+  virtual void    ExecuteTask();
+
+  static bool     ReserveFrameBuffer (SAsyncFrame* pFrame, const int32_t kiBsSize, const int32_t kiNalCount);
+
+ private:
+  CWelsH264SVCEncoder*  m_pEncoder;
+  SAsyncFrame*          m_pFrames;
+  int32_t               m_iQueueDepth;
+  // ring positions: next slot to submit, to encode and to hand out
+  int32_t               m_iSubmitIdx;
+  int32_t               m_iEncodeIdx;
+  int32_t               m_iOutputIdx;
+
+  WELS_MUTEX            m_hStateMutex;     // guards the ring positions and the frame states
+  WELS_CONDITION        m_hEncodedCond;    // a frame went to ASYNC_FRAME_ENCODED
+
+  DISALLOW_COPY_AND_ASSIGN (CWelsAsyncEncoder);
+};
+
+}
+
+#endif//WELS_PLUS_WELS_ASYNC_ENCODER_H__
@@ -49,6 +49,8 @@
 #include "param_svc.h"
 #include "extern.h"
 #include "cpu.h"
+#include "WelsLock.h"
+#include "welsAsyncEncoder.h"
 
 //#define OUTPUT_BIT_STREAM
 //#define DUMP_SRC_PICTURE
@@ -96,7 +98,18 @@ class CWelsH264SVCEncoder : public ISVCEncoder {
   virtual int EXTAPI SetOption (ENCODER_OPTION opt_id, void* option);
   virtual int EXTAPI GetOption (ENCODER_OPTION opt_id, void* option);
 
+  /*
+   * return: CM_RETURN: 0 - success; cmRetryLater - queue full or no frame ready; otherwise - failed;
+   */
+  virtual int EXTAPI EncodeFrameAsync (const SSourcePicture* kpSrcPic, void* pUserData);
+  virtual int EXTAPI GetEncodedFrame (SEncodedFrame** ppFrame, bool bWait);
+  virtual int EXTAPI ReleaseEncodedFrame (SEncodedFrame* pFrame);
+
+  /* called on the CWelsAsyncEncoder worker thread */
+  int EncodeAsyncFrame (SAsyncFrame* pFrame);
+
  private:
+  int ValidateAndEncodeFrame (const SSourcePicture* kpSrcPic, SFrameBSInfo* pBsInfo);
   int InitializeInternal (SWelsSvcCodingParam* argv);
   void TraceParamInfo(SEncParamExt *pParam);
   void LogStatistics (const int64_t kiCurrentFrameTs,int32_t iMaxDid);
@@ -111,6 +124,14 @@ class CWelsH264SVCEncoder : public ISVCEncoder {
   int32_t           m_iCspInternal;
   bool              m_bInitialFlag;
 
+  CWelsAsyncEncoder*  m_pAsyncEncoder;
+  SAsyncFrame*        m_pAsyncOutput;      // frame whose buffers the core writes to, only set on the worker thread
+  int32_t             m_iAsyncQueueDepth;
+  bool                m_bThreadPoolParam;
+  SThreadPoolParam    m_sThreadPoolParam;  // applied at the next (re)initialization
+  // serializes the worker thread against the synchronous interfaces
+  WelsCommon::CWelsLock m_cEncodeLock;
+
 #ifdef OUTPUT_BIT_STREAM
   FILE*             m_pFileBs;
   FILE*             m_pFileBsSize;
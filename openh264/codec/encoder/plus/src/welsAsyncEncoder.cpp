@@ -0,0 +1,190 @@
+/*!
+ * \copy
+ *     Copyright (c)  2009-2013, Cisco Systems
+ *     All rights reserved.
+ *
+ *     Redistribution and use in source and binary forms, with or without
+ *     modification, are permitted provided that the following conditions
+ *     are met:
+ *
+ *        * Redistributions of source code must retain the above copyright
+ *          notice, this list of conditions and the following disclaimer.
+ *
+ *        * Redistributions in binary form must reproduce the above copyright
+ *          notice, this list of conditions and the following disclaimer in
+ *          the documentation and/or other materials provided with the
+ *          distribution.
+ *
+ *     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *     "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *     LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *     FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *     COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *     INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *     BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *     LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *     CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *     ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *     POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * \file    welsAsyncEncoder.cpp
+ *
+ * \brief   bounded queue and worker thread behind ISVCEncoder::EncodeFrameAsync()
+ *
+ * \date    10/16/2026 Created
+ *
+ *************************************************************************************
+ */
+
+#include "welsAsyncEncoder.h"
+#include "welsEncoderExt.h"
+#include "memory_align.h"
+
+namespace WelsEnc {
+
+CWelsAsyncEncoder::CWelsAsyncEncoder (CWelsH264SVCEncoder* pEncoder, const int32_t kiQueueDepth)
+  : m_pEncoder (pEncoder),
+    m_pFrames (NULL),
+    m_iQueueDepth (kiQueueDepth),
+    m_iSubmitIdx (0),
+    m_iEncodeIdx (0),
+    m_iOutputIdx (0) {
+  WelsMutexInit (&m_hStateMutex);
+  WelsConditionInit (&m_hEncodedCond);
+}
+
+CWelsAsyncEncoder::~CWelsAsyncEncoder() {
+  // the worker reads the frames, stop it before they go away
+  Kill();
+
+  if (NULL != m_pFrames) {
+    for (int32_t i = 0; i < m_iQueueDepth; i++) {
+      WELS_SAFE_FREE (m_pFrames[i].sFrame.pBsBuf, "SAsyncFrame::sFrame.pBsBuf");
+      WELS_SAFE_FREE (m_pFrames[i].pNalLen, "SAsyncFrame::pNalLen");
+    }
+    WELS_SAFE_FREE (m_pFrames, "m_pFrames");
+  }
+  WelsConditionDestroy (&m_hEncodedCond);
+  WelsMutexDestroy (&m_hStateMutex);
+}
+
+int32_t CWelsAsyncEncoder::Init() {
+  m_pFrames = static_cast<SAsyncFrame*> (WelsCommon::WelsMallocz (m_iQueueDepth * sizeof (SAsyncFrame), "m_pFrames"));
+  if (NULL == m_pFrames)
+    return cmMallocMemeError;
+
+  if (WELS_THREAD_ERROR_OK != Start())
+    return cmMallocMemeError;
+  return cmResultSuccess;
+}
+
+bool CWelsAsyncEncoder::ReserveFrameBuffer (SAsyncFrame* pFrame, const int32_t kiBsSize, const int32_t kiNalCount) {
+  // encoder parameters may have grown the output since the last frame in this slot
+  if (pFrame->iBsCapacity < kiBsSize) {
+    WELS_SAFE_FREE (pFrame->sFrame.pBsBuf, "SAsyncFrame::sFrame.pBsBuf");
+    pFrame->iBsCapacity = 0;
+    pFrame->sFrame.pBsBuf = static_cast<uint8_t*> (WelsCommon::WelsMallocz (kiBsSize, "SAsyncFrame::sFrame.pBsBuf"));
+    if (NULL == pFrame->sFrame.pBsBuf)
+      return false;
+    pFrame->iBsCapacity = kiBsSize;
+  }
+  if (pFrame->iNalCapacity < kiNalCount) {
+    WELS_SAFE_FREE (pFrame->pNalLen, "SAsyncFrame::pNalLen");
+    pFrame->iNalCapacity = 0;
+    pFrame->pNalLen = static_cast<int32_t*> (WelsCommon::WelsMallocz (kiNalCount * sizeof (int32_t),
+                      "SAsyncFrame::pNalLen"));
+    if (NULL == pFrame->pNalLen)
+      return false;
+    pFrame->iNalCapacity = kiNalCount;
+  }
+  return true;
+}
+
+int32_t CWelsAsyncEncoder::Submit (const SSourcePicture* kpSrcPic, void* pUserData) {
+  WelsMutexLock (&m_hStateMutex);
+  SAsyncFrame* pFrame = &m_pFrames[m_iSubmitIdx];
+  if (ASYNC_FRAME_FREE != pFrame->eState) {
+    WelsMutexUnlock (&m_hStateMutex);
+    return cmRetryLater;
+  }
+  pFrame->sSrcPic           = *kpSrcPic;
+  pFrame->sFrame.pUserData  = pUserData;
+  pFrame->sFrame.iReturn    = cmResultSuccess;
+  pFrame->eState            = ASYNC_FRAME_QUEUED;
+  m_iSubmitIdx = (m_iSubmitIdx + 1) % m_iQueueDepth;
+  WelsMutexUnlock (&m_hStateMutex);
+
+  SignalThread();
+  return cmResultSuccess;
+}
+
+void CWelsAsyncEncoder::ExecuteTask() {
+  // one signal may stand for several submitted frames, drain the queue in order
+  while (!GetEndFlag()) {
+    WelsMutexLock (&m_hStateMutex);
+    SAsyncFrame* pFrame = &m_pFrames[m_iEncodeIdx];
+    const bool kbQueued = (ASYNC_FRAME_QUEUED == pFrame->eState);
+    WelsMutexUnlock (&m_hStateMutex);
+    if (!kbQueued)
+      break;
+
+    pFrame->sFrame.iReturn = m_pEncoder->EncodeAsyncFrame (pFrame);
+
+    WelsMutexLock (&m_hStateMutex);
+    pFrame->eState = ASYNC_FRAME_ENCODED;
+    m_iEncodeIdx = (m_iEncodeIdx + 1) % m_iQueueDepth;
+    WelsConditionBroadcast (&m_hEncodedCond);
+    WelsMutexUnlock (&m_hStateMutex);
+  }
+}
+
+int32_t CWelsAsyncEncoder::GetEncodedFrame (SEncodedFrame** ppFrame, const bool kbWait) {
+  int32_t iRet = cmRetryLater;
+  *ppFrame = NULL;
+  WelsMutexLock (&m_hStateMutex);
+  while (true) {
+    SAsyncFrame* pFrame = &m_pFrames[m_iOutputIdx];
+    if (ASYNC_FRAME_ENCODED == pFrame->eState) {
+      pFrame->eState = ASYNC_FRAME_OUT;
+      m_iOutputIdx = (m_iOutputIdx + 1) % m_iQueueDepth;
+      *ppFrame = &pFrame->sFrame;
+      iRet = cmResultSuccess;
+      break;
+    }
+    if (!kbWait || ASYNC_FRAME_QUEUED != pFrame->eState)
+      break;
+    // the worker changes the state and signals under the same lock, no encoded frame can be missed
+    WelsConditionWait (&m_hEncodedCond, &m_hStateMutex);
+  }
+  WelsMutexUnlock (&m_hStateMutex);
+  return iRet;
+}
+
+int32_t CWelsAsyncEncoder::ReleaseFrame (SEncodedFrame* pFrame) {
+  // sFrame is the first member, so the application's pointer is the slot itself
+  SAsyncFrame* pAsyncFrame = reinterpret_cast<SAsyncFrame*> (pFrame);
+  if (pAsyncFrame < m_pFrames || pAsyncFrame >= m_pFrames + m_iQueueDepth)
+    return cmInitParaError;
+
+  int32_t iRet = cmResultSuccess;
+  WelsMutexLock (&m_hStateMutex);
+  if (ASYNC_FRAME_OUT == pAsyncFrame->eState)
+    pAsyncFrame->eState = ASYNC_FRAME_FREE;
+  else
+    iRet = cmInitParaError;
+  WelsMutexUnlock (&m_hStateMutex);
+  return iRet;
+}
+
+bool CWelsAsyncEncoder::HasFramesInFlight() {
+  bool bInFlight = false;
+  WelsMutexLock (&m_hStateMutex);
+  for (int32_t i = 0; i < m_iQueueDepth; i++)
+    bInFlight |= (ASYNC_FRAME_FREE != m_pFrames[i].eState);
+  WelsMutexUnlock (&m_hStateMutex);
+  return bInFlight;
+}
+
+}
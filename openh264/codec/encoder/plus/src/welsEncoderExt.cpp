@@ -65,7 +65,12 @@ CWelsH264SVCEncoder::CWelsH264SVCEncoder()
     m_iMaxPicWidth (0),
     m_iMaxPicHeight (0),
     m_iCspInternal (0),
-    m_bInitialFlag (false) {
+    m_bInitialFlag (false),
+    m_pAsyncEncoder (NULL),
+    m_pAsyncOutput (NULL),
+    m_iAsyncQueueDepth (ASYNC_QUEUE_DEPTH_DEFAULT),
+    m_bThreadPoolParam (false) {
+  memset (&m_sThreadPoolParam, 0, sizeof (m_sThreadPoolParam));
 #ifdef REC_FRAME_COUNT
   int32_t m_uiCountFrameNum = 0;
 #endif//REC_FRAME_COUNT
@@ -331,6 +336,9 @@ int CWelsH264SVCEncoder::InitializeInternal (SWelsSvcCodingParam* pCfg) {
   m_iMaxPicWidth  = pCfg->iPicWidth;
   m_iMaxPicHeight = pCfg->iPicHeight;
 
+  pCfg->bThreadPoolParam = m_bThreadPoolParam;
+  pCfg->sThreadPool      = m_sThreadPoolParam;
+
   TraceParamInfo (pCfg);
   if (WelsInitEncoderExt (&m_pEncContext, pCfg, &m_pWelsTrace->m_sLogCtx, NULL)) {
     WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR, "CWelsH264SVCEncoder::Initialize(), WelsInitEncoderExt failed.");
@@ -358,6 +366,9 @@ int32_t CWelsH264SVCEncoder::Uninitialize() {
   WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO, "CWelsH264SVCEncoder::Uninitialize(), openh264 codec version = %s.",
            VERSION_NUMBER);
 
+  // stops the worker thread, frames still queued are dropped and all SEncodedFrame become invalid
+  WELS_DELETE_OP (m_pAsyncEncoder);
+
   if (NULL != m_pEncContext) {
     WelsUninitEncoderExt (&m_pEncContext);
     m_pEncContext = NULL;
@@ -373,11 +384,38 @@ int32_t CWelsH264SVCEncoder::Uninitialize() {
  *  SVC core encoding
  */
 int CWelsH264SVCEncoder::EncodeFrame (const SSourcePicture* kpSrcPic, SFrameBSInfo* pBsInfo) {
-  if (! (kpSrcPic && m_bInitialFlag && pBsInfo)) {
+  WelsCommon::CWelsAutoLock cLock (m_cEncodeLock);
+  return ValidateAndEncodeFrame (kpSrcPic, pBsInfo);
+}
+
+int CWelsH264SVCEncoder::ValidateAndEncodeFrame (const SSourcePicture* kpSrcPic, SFrameBSInfo* pBsInfo) {
+  if (! (m_bInitialFlag && pBsInfo)) {
     WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR, "CWelsH264SVCEncoder::EncodeFrame(), cmInitParaError.");
     return cmInitParaError;
   }
-  if (kpSrcPic->iColorFormat != videoFormatI420) {
+  // a NULL picture flushes a picture held back by the frame pipeline or the lookahead
+  if (NULL == kpSrcPic) {
+    if (!m_pEncContext->pSvcParam->bEnableFramePipeline && m_pEncContext->pSvcParam->iLookaheadFrames <= 0) {
+      WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR, "CWelsH264SVCEncoder::EncodeFrame(), cmInitParaError.");
+      return cmInitParaError;
+    }
+    return EncodeFrameInternal (NULL, pBsInfo);
+  }
+  bool bSupportedFormat = false;
+  switch (kpSrcPic->iColorFormat & (~videoFormatVFlip)) {
+  case videoFormatI420:
+  case videoFormatNV12:
+    bSupportedFormat = ! (kpSrcPic->iColorFormat & videoFormatVFlip);
+    break;
+  case videoFormatBGR:
+  case videoFormatBGRA:
+  case videoFormatRGBA:
+    bSupportedFormat = true; // bottom-up rows allowed through videoFormatVFlip
+    break;
+  default:
+    break;
+  }
+  if (!bSupportedFormat) {
     WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR, "CWelsH264SVCEncoder::EncodeFrame(), wrong iColorFormat %d",
              kpSrcPic->iColorFormat);
     return cmInitParaError;
@@ -403,14 +441,24 @@ int CWelsH264SVCEncoder::EncodeFrame (const SSourcePicture* kpSrcPic, SFrameBSIn
 
 int CWelsH264SVCEncoder ::EncodeFrameInternal (const SSourcePicture*  pSrcPic, SFrameBSInfo* pBsInfo) {
 
-  if ((pSrcPic->iPicWidth < 16) || ((pSrcPic->iPicHeight < 16))) {
+  if (pSrcPic != NULL && ((pSrcPic->iPicWidth < 16) || ((pSrcPic->iPicHeight < 16)))) {
     WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR, "Don't support width(%d) or height(%d) which is less than 16!",
              pSrcPic->iPicWidth, pSrcPic->iPicHeight);
     return cmUnsupportedData;
   }
 
+  const bool kbQueuedInput = m_pEncContext->pSvcParam->bEnableFramePipeline
+                               || m_pEncContext->pSvcParam->iLookaheadFrames > 0;
+  // the first pictures into the frame pipeline or the lookahead are only staged, there is nothing to account for
+  const bool kbEncodeFrame = !kbQueuedInput || (m_pEncContext->pVpp->GetStagedPicture (NULL, NULL == pSrcPic) >= 0);
+  // an asynchronous frame gets its NALs written straight into the buffer handed to the application
+  uint8_t* pFrameBs = m_pEncContext->pFrameBs;
+  if (NULL != m_pAsyncOutput)
+    m_pEncContext->pFrameBs = m_pAsyncOutput->sFrame.pBsBuf;
   const int64_t kiBeforeFrameUs = WelsTime();
-  const int32_t kiEncoderReturn = WelsEncoderEncodeExt (m_pEncContext, pBsInfo, pSrcPic);
+  const int32_t kiEncoderReturn = kbQueuedInput ? WelsEncoderEncodePipelined (m_pEncContext, pBsInfo, pSrcPic) :
+                                  WelsEncoderEncodeExt (m_pEncContext, pBsInfo, pSrcPic);
+  m_pEncContext->pFrameBs = pFrameBs;
   const int64_t kiCurrentFrameMs = (WelsTime() - kiBeforeFrameUs) / 1000;
   if ((kiEncoderReturn == ENC_RETURN_MEMALLOCERR) || (kiEncoderReturn == ENC_RETURN_MEMOVERFLOWFOUND)
       || (kiEncoderReturn == ENC_RETURN_VLCOVERFLOWFOUND)) {
@@ -418,13 +466,17 @@ int CWelsH264SVCEncoder ::EncodeFrameInternal (const SSourcePicture*  pSrcPic, S
              kiEncoderReturn);
     WelsUninitEncoderExt (&m_pEncContext);
     return cmMallocMemeError;
+  } else if (kiEncoderReturn == ENC_RETURN_INVALIDINPUT) {
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR, "CWelsH264SVCEncoder::EncodeFrame(), invalid input picture");
+    return cmUnsupportedData;
   } else if ((kiEncoderReturn != ENC_RETURN_SUCCESS) && (kiEncoderReturn == ENC_RETURN_CORRECTED)) {
     WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR, "unexpected return(%d) from EncodeFrameInternal()!",
              kiEncoderReturn);
     return cmUnknownReason;
   }
 
-  UpdateStatistics (pBsInfo, kiCurrentFrameMs);
+  if (kbEncodeFrame)
+    UpdateStatistics (pBsInfo, kiCurrentFrameMs);
 
   ///////////////////for test
 #ifdef OUTPUT_BIT_STREAM
@@ -470,7 +522,8 @@ int CWelsH264SVCEncoder ::EncodeFrameInternal (const SSourcePicture*  pSrcPic, S
   }
 #endif //OUTPUT_BIT_STREAM
 #ifdef DUMP_SRC_PICTURE
-  DumpSrcPicture (pSrcPic, m_pEncContext->pSvcParam->iUsageType);
+  if (pSrcPic != NULL)
+    DumpSrcPicture (pSrcPic, m_pEncContext->pSvcParam->iUsageType);
 #endif // DUMP_SRC_PICTURE
 
   return cmResultSuccess;
@@ -478,13 +531,90 @@ int CWelsH264SVCEncoder ::EncodeFrameInternal (const SSourcePicture*  pSrcPic, S
 }
 
 int CWelsH264SVCEncoder::EncodeParameterSets (SFrameBSInfo* pBsInfo) {
+  WelsCommon::CWelsAutoLock cLock (m_cEncodeLock);
   return WelsEncoderEncodeParameterSets (m_pEncContext, pBsInfo);
 }
 
+int CWelsH264SVCEncoder::EncodeFrameAsync (const SSourcePicture* kpSrcPic, void* pUserData) {
+  if (! (kpSrcPic && m_bInitialFlag && m_pEncContext)) {
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR, "CWelsH264SVCEncoder::EncodeFrameAsync(), cmInitParaError.");
+    return cmInitParaError;
+  }
+  if (m_pEncContext->pSvcParam->bEnableFramePipeline || m_pEncContext->pSvcParam->iLookaheadFrames > 0) {
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR,
+             "CWelsH264SVCEncoder::EncodeFrameAsync(), not supported together with bEnableFramePipeline or iLookaheadFrames");
+    return cmUnsupportedData;
+  }
+  if (NULL == m_pAsyncEncoder) {
+    m_pAsyncEncoder = WELS_NEW_OP (CWelsAsyncEncoder (this, m_iAsyncQueueDepth), CWelsAsyncEncoder);
+    if (NULL == m_pAsyncEncoder || cmResultSuccess != m_pAsyncEncoder->Init()) {
+      WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR,
+               "CWelsH264SVCEncoder::EncodeFrameAsync(), failed to start the encoding thread");
+      WELS_DELETE_OP (m_pAsyncEncoder);
+      return cmMallocMemeError;
+    }
+  }
+  return m_pAsyncEncoder->Submit (kpSrcPic, pUserData);
+}
+
+int CWelsH264SVCEncoder::GetEncodedFrame (SEncodedFrame** ppFrame, bool bWait) {
+  if (NULL == ppFrame) {
+    return cmInitParaError;
+  }
+  if (NULL == m_pAsyncEncoder) {
+    *ppFrame = NULL;
+    return cmRetryLater;
+  }
+  return m_pAsyncEncoder->GetEncodedFrame (ppFrame, bWait);
+}
+
+int CWelsH264SVCEncoder::ReleaseEncodedFrame (SEncodedFrame* pFrame) {
+  if (NULL == pFrame || NULL == m_pAsyncEncoder) {
+    return cmInitParaError;
+  }
+  return m_pAsyncEncoder->ReleaseFrame (pFrame);
+}
+
+int CWelsH264SVCEncoder::EncodeAsyncFrame (SAsyncFrame* pFrame) {
+  WelsCommon::CWelsAutoLock cLock (m_cEncodeLock);
+  memset (&pFrame->sFrame.sBsInfo, 0, sizeof (SFrameBSInfo));
+  if (! (m_bInitialFlag && m_pEncContext)) {
+    return cmInitExpected;
+  }
+  if (!CWelsAsyncEncoder::ReserveFrameBuffer (pFrame, m_pEncContext->iFrameBsSize, 0)) {
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR, "CWelsH264SVCEncoder::EncodeAsyncFrame(), cmMallocMemeError.");
+    return cmMallocMemeError;
+  }
+
+  m_pAsyncOutput = pFrame;
+  const int kiRet = ValidateAndEncodeFrame (&pFrame->sSrcPic, &pFrame->sFrame.sBsInfo);
+  m_pAsyncOutput = NULL;
+
+  SFrameBSInfo* pBsInfo = &pFrame->sFrame.sBsInfo;
+  if (NULL == m_pEncContext) { // a fatal error tore the context down
+    pBsInfo->iLayerNum = 0;
+    return kiRet;
+  }
+  // the core may grow its NAL length table while coding the frame, so the lengths are copied instead of written in place
+  const int32_t* kpNalLen = m_pEncContext->pOut->pNalLen;
+  if (!CWelsAsyncEncoder::ReserveFrameBuffer (pFrame, 0, m_pEncContext->pOut->iCountNals)) {
+    pBsInfo->iLayerNum = 0;
+    return cmMallocMemeError;
+  }
+  for (int32_t i = 0; i < pBsInfo->iLayerNum; i++) {
+    SLayerBSInfo* pLayerBsInfo = &pBsInfo->sLayerInfo[i];
+    const int32_t kiNalOffset = static_cast<int32_t> (pLayerBsInfo->pNalLengthInByte - kpNalLen);
+    memcpy (pFrame->pNalLen + kiNalOffset, pLayerBsInfo->pNalLengthInByte, pLayerBsInfo->iNalCount * sizeof (int32_t));
+    pLayerBsInfo->pNalLengthInByte = pFrame->pNalLen + kiNalOffset;
+  }
+  return kiRet;
+}
+
 /*
  *  Force key frame
  */
 int CWelsH264SVCEncoder::ForceIntraFrame (bool bIDR, int iLayerId) {
+  WelsCommon::CWelsAutoLock cLock (m_cEncodeLock);
   if (bIDR) {
     if (! (m_pEncContext && m_bInitialFlag)) {
       return 1;
@@ -689,9 +819,11 @@ int CWelsH264SVCEncoder::SetOption (ENCODER_OPTION eOptionId, void* pOption) {
   if (NULL == pOption) {
     return cmInitParaError;
   }
+  WelsCommon::CWelsAutoLock cLock (m_cEncodeLock);
 
   if ((NULL == m_pEncContext || false == m_bInitialFlag) && eOptionId != ENCODER_OPTION_TRACE_LEVEL
-      && eOptionId != ENCODER_OPTION_TRACE_CALLBACK && eOptionId != ENCODER_OPTION_TRACE_CALLBACK_CONTEXT) {
+      && eOptionId != ENCODER_OPTION_TRACE_CALLBACK && eOptionId != ENCODER_OPTION_TRACE_CALLBACK_CONTEXT
+      && eOptionId != ENCODER_OPTION_THREAD_POOL) {
     return cmInitExpected;
   }
 
@@ -1162,6 +1294,54 @@ int CWelsH264SVCEncoder::SetOption (ENCODER_OPTION eOptionId, void* pOption) {
              "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_GET_STATISTICS: this option is get-only!");
   }
   break;
+  case ENCODER_OPTION_GET_SOURCE_BUFFER: {
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_WARNING,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_GET_SOURCE_BUFFER: this option is get-only!");
+  }
+  return cmInitParaError;
+  case ENCODER_OPTION_MEMORY_USAGE: {
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_WARNING,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_MEMORY_USAGE: this option is get-only!");
+  }
+  return cmInitParaError;
+  case ENCODER_OPTION_ASYNC_QUEUE_DEPTH: {
+    int32_t iValue = * (static_cast<int32_t*> (pOption));
+    if (iValue < 1 || iValue > ASYNC_QUEUE_DEPTH_MAX) {
+      WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR,
+               "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_ASYNC_QUEUE_DEPTH, invalid depth %d (1..%d)", iValue,
+               ASYNC_QUEUE_DEPTH_MAX);
+      return cmInitParaError;
+    }
+    if (NULL != m_pAsyncEncoder) {
+      if (m_pAsyncEncoder->HasFramesInFlight()) {
+        WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_WARNING,
+                 "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_ASYNC_QUEUE_DEPTH, frames still in flight");
+        return cmRetryLater;
+      }
+      // recreated with the new depth by the next EncodeFrameAsync()
+      WELS_DELETE_OP (m_pAsyncEncoder);
+    }
+    m_iAsyncQueueDepth = iValue;
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_ASYNC_QUEUE_DEPTH, iAsyncQueueDepth = %d", iValue);
+  }
+  break;
+  case ENCODER_OPTION_THREAD_POOL: {
+    const SThreadPoolParam* pParam = static_cast<const SThreadPoolParam*> (pOption);
+    if (pParam->iThreadNum < 0 || pParam->iAffinityCpuNum < 0 || pParam->iAffinityCpuNum > MAX_THREAD_AFFINITY_CPU_NUM) {
+      WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_ERROR,
+               "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_THREAD_POOL, invalid iThreadNum %d or iAffinityCpuNum %d",
+               pParam->iThreadNum, pParam->iAffinityCpuNum);
+      return cmInitParaError;
+    }
+    m_sThreadPoolParam = *pParam;
+    m_sThreadPoolParam.szPoolName[MAX_THREAD_POOL_NAME_LEN - 1] = '\0';
+    m_bThreadPoolParam = true;
+    WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+             "CWelsH264SVCEncoder::SetOption():ENCODER_OPTION_THREAD_POOL, iThreadNum = %d, szPoolName = %s, iAffinityCpuNum = %d",
+             m_sThreadPoolParam.iThreadNum, m_sThreadPoolParam.szPoolName, m_sThreadPoolParam.iAffinityCpuNum);
+  }
+  break;
   case ENCODER_OPTION_STATISTICS_LOG_INTERVAL: {
     int32_t iValue = * (static_cast<int32_t*> (pOption));
     m_pEncContext->iStatisticsLogInterval = iValue;
@@ -1197,7 +1377,8 @@ int CWelsH264SVCEncoder::GetOption (ENCODER_OPTION eOptionId, void* pOption) {
   if (NULL == pOption) {
     return cmInitParaError;
   }
-  if (NULL == m_pEncContext || false == m_bInitialFlag) {
+  WelsCommon::CWelsAutoLock cLock (m_cEncodeLock);
+  if ((NULL == m_pEncContext || false == m_bInitialFlag) && eOptionId != ENCODER_OPTION_THREAD_POOL) {
     return cmInitExpected;
   }
 
@@ -1224,6 +1405,11 @@ int CWelsH264SVCEncoder::GetOption (ENCODER_OPTION eOptionId, void* pOption) {
     WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
              "CWelsH264SVCEncoder::GetOption():ENCODER_OPTION_SVC_ENCODE_PARAM_EXT");
     memcpy (pOption, m_pEncContext->pSvcParam, sizeof (SEncParamExt)); // confirmed_safe_unsafe_usage
+    // the encoder keeps its own copy of the statistics file name, hand that out so that setting the parameters
+    // back keeps the same two-pass configuration
+    SEncParamExt* pParamExt = (SEncParamExt*)pOption;
+    pParamExt->pRcStatsFileName = ('\0' != m_pEncContext->pSvcParam->sRcStatsFileName[0]) ?
+                                  m_pEncContext->pSvcParam->sRcStatsFileName : NULL;
   }
   break;
   case ENCODER_OPTION_SVC_ENCODE_PARAM_BASE: { // SVC Encoding Parameter
@@ -1301,6 +1487,29 @@ int CWelsH264SVCEncoder::GetOption (ENCODER_OPTION eOptionId, void* pOption) {
     * ((int32_t*)pOption) =  m_pEncContext->pSvcParam->iComplexityMode;
   }
   break;
+  case ENCODER_OPTION_GET_SOURCE_BUFFER: {
+    SSourcePicture* pSrcPic = static_cast<SSourcePicture*> (pOption);
+    if (0 != m_pEncContext->pVpp->GetSourceBuffer (m_pEncContext, pSrcPic)) {
+      WelsLog (&m_pWelsTrace->m_sLogCtx, WELS_LOG_INFO,
+               "CWelsH264SVCEncoder::GetOption():ENCODER_OPTION_GET_SOURCE_BUFFER, not available when input is scaled or pipelined");
+      return cmUnsupportedData;
+    }
+  }
+  break;
+  case ENCODER_OPTION_ASYNC_QUEUE_DEPTH: {
+    * (static_cast<int32_t*> (pOption)) = m_iAsyncQueueDepth;
+  }
+  break;
+  case ENCODER_OPTION_THREAD_POOL: {
+    * (static_cast<SThreadPoolParam*> (pOption)) = m_sThreadPoolParam;
+  }
+  break;
+  case ENCODER_OPTION_MEMORY_USAGE: {
+    SMemoryUsage* pUsage = static_cast<SMemoryUsage*> (pOption);
+    memset (pUsage, 0, sizeof (SMemoryUsage));
+    m_pEncContext->pMemAlign->WelsAddMemoryUsage (pUsage);
+  }
+  break;
   default:
     return cmInitParaError;
   }
@@ -4,6 +4,7 @@
 ENCODER_SRCDIR=codec/encoder
 ENCODER_CPP_SRCS=\
 	$(ENCODER_SRCDIR)/core/src/au_set.cpp\
+	$(ENCODER_SRCDIR)/core/src/colorspace_convert.cpp\
 	$(ENCODER_SRCDIR)/core/src/deblocking.cpp\
 	$(ENCODER_SRCDIR)/core/src/decode_mb_aux.cpp\
 	$(ENCODER_SRCDIR)/core/src/encode_mb_aux.cpp\
@@ -17,6 +18,7 @@ ENCODER_CPP_SRCS=\
 	$(ENCODER_SRCDIR)/core/src/paraset_strategy.cpp\
 	$(ENCODER_SRCDIR)/core/src/picture_handle.cpp\
 	$(ENCODER_SRCDIR)/core/src/ratectl.cpp\
+	$(ENCODER_SRCDIR)/core/src/rc_stats.cpp\
 	$(ENCODER_SRCDIR)/core/src/ref_list_mgr_svc.cpp\
 	$(ENCODER_SRCDIR)/core/src/sample.cpp\
 	$(ENCODER_SRCDIR)/core/src/set_mb_syn_cabac.cpp\
@@ -34,12 +36,14 @@ ENCODER_CPP_SRCS=\
 	$(ENCODER_SRCDIR)/core/src/wels_task_base.cpp\
 	$(ENCODER_SRCDIR)/core/src/wels_task_encoder.cpp\
 	$(ENCODER_SRCDIR)/core/src/wels_task_management.cpp\
+	$(ENCODER_SRCDIR)/plus/src/welsAsyncEncoder.cpp\
 	$(ENCODER_SRCDIR)/plus/src/welsEncoderExt.cpp\
 
 ENCODER_OBJS += $(ENCODER_CPP_SRCS:.cpp=.$(OBJ))
 
 ENCODER_ASM_SRCS=\
 	$(ENCODER_SRCDIR)/core/x86/coeff.asm\
+	$(ENCODER_SRCDIR)/core/x86/colorspace_convert.asm\
 	$(ENCODER_SRCDIR)/core/x86/dct.asm\
 	$(ENCODER_SRCDIR)/core/x86/intra_pred.asm\
 	$(ENCODER_SRCDIR)/core/x86/matrix_transpose.asm\
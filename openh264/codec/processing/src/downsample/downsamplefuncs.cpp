@@ -39,6 +39,7 @@
  *****************************************************************************/
 
 #include "downsample.h"
+#include "downsample_common.h"
 
 
 WELSVP_NAMESPACE_BEGIN
@@ -187,64 +188,8 @@ void GeneralBilinearFastDownsampler_c (uint8_t* pDst, const int32_t kiDstStride,
 void GeneralBilinearAccurateDownsampler_c (uint8_t* pDst, const int32_t kiDstStride, const int32_t kiDstWidth,
     const int32_t kiDstHeight,
     uint8_t* pSrc, const int32_t kiSrcStride, const int32_t kiSrcWidth, const int32_t kiSrcHeight) {
-  const int32_t kiScaleBit = 15;
-  const int32_t kiScale = (1 << kiScaleBit);
-  int32_t iScalex = WELS_ROUND ((float)kiSrcWidth / (float)kiDstWidth * kiScale);
-  int32_t iScaley = WELS_ROUND ((float)kiSrcHeight / (float)kiDstHeight * kiScale);
-  int64_t x;
-  int32_t iYInverse, iXInverse;
-
-  uint8_t* pByDst = pDst;
-  uint8_t* pByLineDst = pDst;
-
-  iYInverse = 1 << (kiScaleBit - 1);
-  for (int32_t i = 0; i < kiDstHeight - 1; i++) {
-    int32_t iYy = iYInverse >> kiScaleBit;
-    int32_t iFv = iYInverse & (kiScale - 1);
-
-    uint8_t* pBySrc = pSrc + iYy * kiSrcStride;
-
-    pByDst = pByLineDst;
-    iXInverse = 1 << (kiScaleBit - 1);
-    for (int32_t j = 0; j < kiDstWidth - 1; j++) {
-      int32_t iXx = iXInverse >> kiScaleBit;
-      int32_t iFu = iXInverse & (kiScale - 1);
-
-      uint8_t* pByCurrent = pBySrc + iXx;
-      uint8_t a, b, c, d;
-
-      a = *pByCurrent;
-      b = * (pByCurrent + 1);
-      c = * (pByCurrent + kiSrcStride);
-      d = * (pByCurrent + kiSrcStride + 1);
-
-      x = (((int64_t) (kiScale - 1 - iFu)) * (kiScale - 1 - iFv) * a + ((int64_t)iFu) * (kiScale - 1 - iFv) * b + ((int64_t) (
-             kiScale - 1 - iFu)) * iFv * c +
-           ((int64_t)iFu) * iFv * d + (int64_t) (1 << (2 * kiScaleBit - 1))) >> (2 * kiScaleBit);
-      x = WELS_CLAMP (x, 0, 255);
-      *pByDst++ = (uint8_t)x;
-
-      iXInverse += iScalex;
-    }
-    *pByDst = * (pBySrc + (iXInverse >> kiScaleBit));
-    pByLineDst += kiDstStride;
-    iYInverse += iScaley;
-  }
-
-  // last row special
-  {
-    int32_t iYy = iYInverse >> kiScaleBit;
-    uint8_t* pBySrc = pSrc + iYy * kiSrcStride;
-
-    pByDst = pByLineDst;
-    iXInverse = 1 << (kiScaleBit - 1);
-    for (int32_t j = 0; j < kiDstWidth; j++) {
-      int32_t iXx = iXInverse >> kiScaleBit;
-      *pByDst++ = * (pBySrc + iXx);
-
-      iXInverse += iScalex;
-    }
-  }
+  WelsGeneralBilinearDownsampleRows_c (pDst, kiDstStride, kiDstWidth, kiDstHeight, pSrc, kiSrcStride, kiSrcWidth,
+                                       kiSrcHeight, 0, kiDstHeight);
 }
 
 #if defined(X86_ASM) || defined(HAVE_NEON) || defined(HAVE_NEON_AARCH64)
@@ -41,6 +41,7 @@ class BaseThreadDecoderTest {
 
   bool Open (const char* fileName);
   ISVCDecoder* decoder_;
+  int32_t iFramesRemainingAtEos;
 
  private:
   void DecodeFrame (const uint8_t* src, size_t sliceSize, Callback* cbk);
@@ -106,12 +106,12 @@ void BaseDecoderTest::DecodeFrame (const uint8_t* src, size_t sliceSize, Callbac
       data[0],
       bufInfo.UsrData.sSystemBuffer.iWidth,
       bufInfo.UsrData.sSystemBuffer.iHeight,
-      bufInfo.UsrData.sSystemBuffer.iStride[0]
+      bufInfo.UsrData.sSystemBuffer.iStride[0],
       // u plane
       data[1],
       bufInfo.UsrData.sSystemBuffer.iWidth / 2,
       bufInfo.UsrData.sSystemBuffer.iHeight / 2,
-      bufInfo.UsrData.sSystemBuffer.iStride[1]
+      bufInfo.UsrData.sSystemBuffer.iStride[1],
       // v plane
       data[2],
       bufInfo.UsrData.sSystemBuffer.iWidth / 2,
@@ -143,12 +143,12 @@ void BaseDecoderTest::FlushFrame (Callback* cbk) {
       data[0],
       bufInfo.UsrData.sSystemBuffer.iWidth,
       bufInfo.UsrData.sSystemBuffer.iHeight,
-      bufInfo.UsrData.sSystemBuffer.iStride[0]
+      bufInfo.UsrData.sSystemBuffer.iStride[0],
       // u plane
       data[1],
       bufInfo.UsrData.sSystemBuffer.iWidth / 2,
       bufInfo.UsrData.sSystemBuffer.iHeight / 2,
-      bufInfo.UsrData.sSystemBuffer.iStride[1]
+      bufInfo.UsrData.sSystemBuffer.iStride[1],
       // v plane
       data[2],
       bufInfo.UsrData.sSystemBuffer.iWidth / 2,
@@ -238,7 +238,7 @@ bool BaseDecoderTest::DecodeNextFrame (Callback* cbk) {
       return false;
     }
     return true;
-  case EndOfStream:
+  case EndOfStream: {
     // 如果解码状态为EndOfStream，设置解码器的结束标志
     int32_t iEndOfStreamFlag = 1;
     decoder_->SetOption (DECODER_OPTION_END_OF_STREAM, &iEndOfStreamFlag);
@@ -247,6 +247,7 @@ bool BaseDecoderTest::DecodeNextFrame (Callback* cbk) {
     // 设置解码状态为End
     decodeStatus_ = End;
     break;
+  }
   case OpenFile:
   case End:
     // 如果解码状态为OpenFile或End，不做任何操作
@@ -139,7 +139,7 @@ static void Process (SBufferInfo* pInfo, FILE* pFp) {
 }
 
 BaseThreadDecoderTest::BaseThreadDecoderTest()
-  : decoder_ (NULL), uiTimeStamp (0), pYuvFile (NULL), bEnableYuvDumpTest (false), decodeStatus_ (OpenFile) {
+  : decoder_ (NULL), iFramesRemainingAtEos (0), uiTimeStamp (0), pYuvFile (NULL), bEnableYuvDumpTest (false), decodeStatus_ (OpenFile) {
 }
 
 int32_t BaseThreadDecoderTest::SetUp() {
@@ -298,6 +298,7 @@ bool BaseThreadDecoderTest::ThreadDecodeFile (const char* fileName, Callback* cb
   // Flush out last frames in decoder buffer
   int32_t num_of_frames_in_buffer = 0;
   decoder_->GetOption (DECODER_OPTION_NUM_OF_FRAMES_REMAINING_IN_BUFFER, &num_of_frames_in_buffer);
+  iFramesRemainingAtEos = num_of_frames_in_buffer;
   for (int32_t i = 0; i < num_of_frames_in_buffer; ++i) {
     FlushFrame (cbk);
   }
@@ -19,6 +19,9 @@ void CheckEncoderInterface (ISVCEncoder* p, CheckFunc check) {
   CHECK (7, p, ForceIntraFrame);
   CHECK (8, p, SetOption);
   CHECK (9, p, GetOption);
+  CHECK (10, p, EncodeFrameAsync);
+  CHECK (11, p, GetEncodedFrame);
+  CHECK (12, p, ReleaseEncodedFrame);
 }
 
 void CheckDecoderInterface (ISVCDecoder* p, CheckFunc check) {
@@ -34,6 +37,18 @@ void CheckDecoderInterface (ISVCDecoder* p, CheckFunc check) {
   CHECK (10, p, FlushFrame);
 }
 
+void CheckDecoderServiceInterface (ISVCDecoderService* p, CheckFunc check) {
+  CHECK (1, p, Initialize);
+  CHECK (2, p, Uninitialize);
+  CHECK (3, p, OpenStream);
+  CHECK (4, p, CloseStream);
+  CHECK (5, p, SubmitAccessUnit);
+  CHECK (6, p, GetDecodedFrame);
+  CHECK (7, p, ReleaseDecodedFrame);
+  CHECK (8, p, SetStreamOption);
+  CHECK (9, p, GetStreamOption);
+}
+
 struct bool_test_struct {
   char c;
   bool b;
@@ -9,6 +9,7 @@ static void CheckFunctionOrder (int expect, int actual, const char* name) {
 typedef void (*CheckFunc) (int, int, const char*);
 extern "C" void CheckEncoderInterface (ISVCEncoder* p, CheckFunc);
 extern "C" void CheckDecoderInterface (ISVCDecoder* p, CheckFunc);
+extern "C" void CheckDecoderServiceInterface (ISVCDecoderService* p, CheckFunc);
 extern "C" size_t GetBoolSize (void);
 extern "C" size_t GetBoolOffset (void);
 extern "C" size_t GetBoolStructSize (void);
@@ -59,6 +60,18 @@ struct SVCEncoderImpl : public ISVCEncoder {
     EXPECT_TRUE (gThis == this);
     return 9;
   }
+  virtual int EXTAPI EncodeFrameAsync (const SSourcePicture* kpSrcPic, void* pUserData) {
+    EXPECT_TRUE (gThis == this);
+    return 10;
+  }
+  virtual int EXTAPI GetEncodedFrame (SEncodedFrame** ppFrame, bool bWait) {
+    EXPECT_TRUE (gThis == this);
+    return 11;
+  }
+  virtual int EXTAPI ReleaseEncodedFrame (SEncodedFrame* pFrame) {
+    EXPECT_TRUE (gThis == this);
+    return 12;
+  }
 };
 
 struct SVCDecoderImpl : public ISVCDecoder {
@@ -112,6 +125,47 @@ struct SVCDecoderImpl : public ISVCDecoder {
   }
 };
 
+struct SVCDecoderServiceImpl : public ISVCDecoderService {
+  virtual ~SVCDecoderServiceImpl() {}
+  virtual long EXTAPI Initialize (const SDecoderServiceParam* pParam) {
+    EXPECT_TRUE (gThis == this);
+    return 1;
+  }
+  virtual long EXTAPI Uninitialize() {
+    EXPECT_TRUE (gThis == this);
+    return 2;
+  }
+  virtual long EXTAPI OpenStream (const SDecodingParam* pParam, int* pStreamId) {
+    EXPECT_TRUE (gThis == this);
+    return 3;
+  }
+  virtual long EXTAPI CloseStream (int iStreamId) {
+    EXPECT_TRUE (gThis == this);
+    return 4;
+  }
+  virtual long EXTAPI SubmitAccessUnit (int iStreamId, const unsigned char* pSrc, const int iSrcLen,
+                                        unsigned long long uiTimeStamp) {
+    EXPECT_TRUE (gThis == this);
+    return 5;
+  }
+  virtual long EXTAPI GetDecodedFrame (int iStreamId, SDecodedFrame** ppFrame, bool bWait) {
+    EXPECT_TRUE (gThis == this);
+    return 6;
+  }
+  virtual long EXTAPI ReleaseDecodedFrame (SDecodedFrame* pFrame) {
+    EXPECT_TRUE (gThis == this);
+    return 7;
+  }
+  virtual long EXTAPI SetStreamOption (int iStreamId, DECODER_OPTION eOptionId, void* pOption) {
+    EXPECT_TRUE (gThis == this);
+    return 8;
+  }
+  virtual long EXTAPI GetStreamOption (int iStreamId, DECODER_OPTION eOptionId, void* pOption) {
+    EXPECT_TRUE (gThis == this);
+    return 9;
+  }
+};
+
 TEST (ISVCEncoderTest, CheckFunctionOrder) {
   SVCEncoderImpl* p = new SVCEncoderImpl;
   gThis = p;
@@ -126,6 +180,13 @@ TEST (ISVCDecoderTest, CheckFunctionOrder) {
   delete p;
 }
 
+TEST (ISVCDecoderServiceTest, CheckFunctionOrder) {
+  SVCDecoderServiceImpl* p = new SVCDecoderServiceImpl;
+  gThis = p;
+  CheckDecoderServiceInterface (p, CheckFunctionOrder);
+  delete p;
+}
+
 struct bool_test_struct {
   char c;
   bool b;
@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 #include "utils/HashFunctions.h"
 #include "BaseDecoderTest.h"
+#include "downsample_common.h"
 #include <string>
+#include <vector>
 
 static void UpdateHashFromPlane (SHA1Context* ctx, const uint8_t* plane,
                                  int width, int height, int stride) {
@@ -41,26 +43,122 @@ class DecoderInitTest : public ::testing::Test, public BaseDecoderTest {
   virtual void TearDown() {
     BaseDecoderTest::TearDown();
   }
+  // initializes the decoder again with the parameters of BaseDecoderTest::SetUp(), after options that can only be
+  // changed on an uninitialized decoder
+  long ReinitializeDecoder() {
+    SDecodingParam decParam;
+    memset (&decParam, 0, sizeof (SDecodingParam));
+    decParam.uiTargetDqLayer = UCHAR_MAX;
+    decParam.eEcActiveIdc = ERROR_CON_SLICE_COPY;
+    decParam.sVideoProperty.eVideoBsType = VIDEO_BITSTREAM_DEFAULT;
+    return decoder_->Initialize (&decParam);
+  }
 };
 
 TEST_F (DecoderInitTest, JustInit) {}
 
+// decoder setups whose output has to match the plain decode bit for bit
+enum EDecoderOutputMode {
+  DEC_OUTPUT_DEFAULT = 0,
+  DEC_OUTPUT_DEBLOCKING_THREAD,    // loop filter one MB row behind reconstruction on a worker
+  DEC_OUTPUT_SLICE_THREADS,        // slices of a picture parsed and reconstructed in parallel
+  DEC_OUTPUT_FRAME_ALLOCATOR,      // pictures decoded into application buffers and held until the end
+  DEC_OUTPUT_LAZY_BORDER_EXPANSION // edge emulated motion compensation instead of padded references
+};
+
 struct FileParam {
   const char* fileName;
   const char* hashStr;
+  EDecoderOutputMode eMode;
 };
 
 class DecoderOutputTest : public ::testing::WithParamInterface<FileParam>,
   public DecoderInitTest, public BaseDecoderTest::Callback {
  public:
+  struct UserFrame {
+    unsigned char* pAlloc;
+    unsigned char* pBuffer;
+    int iSize;
+    int iRefs;
+  };
+  struct HeldFrame {
+    Frame sFrame;
+    UserFrame* pUserFrame;
+  };
   virtual void SetUp() {
     DecoderInitTest::SetUp();
     if (HasFatalFailure()) {
       return;
     }
     SHA1Reset (&ctx_);
+    iLiveFrames_ = 0;
+    switch (GetParam().eMode) {
+    case DEC_OUTPUT_DEBLOCKING_THREAD: {
+      int iDeblockingThread = 1;
+      ASSERT_EQ (0, decoder_->SetOption (DECODER_OPTION_DEBLOCKING_THREAD, &iDeblockingThread));
+      break;
+    }
+    case DEC_OUTPUT_SLICE_THREADS: {
+      int iSliceThreads = 4;
+      ASSERT_EQ (0, decoder_->SetOption (DECODER_OPTION_SLICE_THREADS, &iSliceThreads));
+      break;
+    }
+    case DEC_OUTPUT_FRAME_ALLOCATOR: {
+      // the allocator can only be registered on an uninitialized decoder
+      decoder_->Uninitialize();
+      SDecoderFrameAllocator sAllocator;
+      sAllocator.pUserData = this;
+      sAllocator.pfGetBuffer = GetBuffer;
+      sAllocator.pfReleaseBuffer = ReleaseBuffer;
+      ASSERT_EQ (0, decoder_->SetOption (DECODER_OPTION_FRAME_ALLOCATOR, &sAllocator));
+      ASSERT_EQ (0, ReinitializeDecoder());
+      break;
+    }
+    case DEC_OUTPUT_LAZY_BORDER_EXPANSION: {
+      int iLazy = 1;
+      EXPECT_NE (0, decoder_->SetOption (DECODER_OPTION_LAZY_BORDER_EXPANSION, &iLazy));
+      decoder_->Uninitialize();
+      ASSERT_EQ (0, decoder_->SetOption (DECODER_OPTION_LAZY_BORDER_EXPANSION, &iLazy));
+      ASSERT_EQ (0, ReinitializeDecoder());
+      iLazy = 0;
+      ASSERT_EQ (0, decoder_->GetOption (DECODER_OPTION_LAZY_BORDER_EXPANSION, &iLazy));
+      EXPECT_EQ (1, iLazy);
+      break;
+    }
+    default:
+      break;
+    }
   }
-  virtual void onDecodeFrame (const Frame& frame) {
+  static unsigned char* GetBuffer (void* pUserData, int iSize, void** ppUserFrame) {
+    DecoderOutputTest* pThis = (DecoderOutputTest*)pUserData;
+    UserFrame* pFrame = new UserFrame;
+    pFrame->pAlloc = new unsigned char[iSize + 15];
+    pFrame->pBuffer = (unsigned char*) (((uintptr_t)pFrame->pAlloc + 15) & ~ (uintptr_t)15);
+    pFrame->iSize = iSize;
+    pFrame->iRefs = 1;
+    pThis->frames_.push_back (pFrame);
+    ++pThis->iLiveFrames_;
+    *ppUserFrame = pFrame;
+    return pFrame->pBuffer;
+  }
+  static void ReleaseBuffer (void* pUserData, void* pUserFrame) {
+    DecoderOutputTest* pThis = (DecoderOutputTest*)pUserData;
+    pThis->Unref ((UserFrame*)pUserFrame);
+  }
+  void Unref (UserFrame* pFrame) {
+    if (--pFrame->iRefs > 0)
+      return;
+    for (size_t i = 0; i < frames_.size(); ++i) {
+      if (frames_[i] == pFrame) {
+        frames_.erase (frames_.begin() + i);
+        break;
+      }
+    }
+    delete [] pFrame->pAlloc;
+    delete pFrame;
+    --iLiveFrames_;
+  }
+  void HashFrame (const Frame& frame) {
     const Plane& y = frame.y;
     const Plane& u = frame.u;
     const Plane& v = frame.v;
@@ -68,8 +166,31 @@ class DecoderOutputTest : public ::testing::WithParamInterface<FileParam>,
     UpdateHashFromPlane (&ctx_, u.data, u.width, u.height, u.stride);
     UpdateHashFromPlane (&ctx_, v.data, v.width, v.height, v.stride);
   }
+  virtual void onDecodeFrame (const Frame& frame) {
+    if (GetParam().eMode != DEC_OUTPUT_FRAME_ALLOCATOR) {
+      HashFrame (frame);
+      return;
+    }
+    // keep every output picture instead of hashing it on the spot, as an application owning the buffers would
+    UserFrame* pOwner = NULL;
+    for (size_t i = 0; i < frames_.size(); ++i) {
+      if (frame.y.data >= frames_[i]->pBuffer && frame.y.data < frames_[i]->pBuffer + frames_[i]->iSize)
+        pOwner = frames_[i];
+    }
+    ASSERT_TRUE (pOwner != NULL);
+    ASSERT_TRUE (frame.v.data < pOwner->pBuffer + pOwner->iSize);
+    void* pUserFrame = NULL;
+    ASSERT_EQ (0, decoder_->GetOption (DECODER_OPTION_OUTPUT_USER_FRAME, &pUserFrame));
+    EXPECT_EQ (pOwner, pUserFrame);
+    ++pOwner->iRefs;
+    HeldFrame sHeld = {frame, pOwner};
+    held_.push_back (sHeld);
+  }
  protected:
   SHA1Context ctx_;
+  std::vector<UserFrame*> frames_;
+  std::vector<HeldFrame> held_;
+  int iLiveFrames_;
 };
 
 TEST_P (DecoderOutputTest, CompareOutput) {
@@ -81,11 +202,22 @@ TEST_P (DecoderOutputTest, CompareOutput) {
   ASSERT_TRUE (DecodeFile(p.fileName, this));
 #endif
 
+  if (p.eMode == DEC_OUTPUT_FRAME_ALLOCATOR) {
+    ASSERT_FALSE (held_.empty());
+    for (size_t i = 0; i < held_.size(); ++i) {
+      HashFrame (held_[i].sFrame);
+      Unref (held_[i].pUserFrame);
+    }
+  }
   unsigned char digest[SHA_DIGEST_LENGTH];
   SHA1Result (&ctx_, digest);
   if (!HasFatalFailure()) {
     CompareHash (digest, p.hashStr);
   }
+  if (p.eMode == DEC_OUTPUT_FRAME_ALLOCATOR) {
+    decoder_->Uninitialize();
+    EXPECT_EQ (0, iLiveFrames_);
+  }
 }
 static const FileParam kFileParamArray[] = {
   {"res/Adobe_PDF_sample_a_1024x768_50Frms.264", "9aa9a4d9598eb3e1093311826844f37c43e4c521"},
@@ -139,7 +271,513 @@ static const FileParam kFileParamArray[] = {
   {"res/VID_1280x544_cavlc_temporal_direct.264", "33bfa44b4a3c87fe28354cace1d4b99a03d2967d"},
   {"res/VID_1280x720_cavlc_temporal_direct.264", "4face6b5d73a378b6e564a831b49311c230158e4"},
   {"res/VID_1920x1080_cavlc_temporal_direct.264", "b35dc99604ea2a1fda5b84d1b9098cb7565dec8f"},
+  {"res/Adobe_PDF_sample_a_1024x768_50Frms.264", "9aa9a4d9598eb3e1093311826844f37c43e4c521", DEC_OUTPUT_DEBLOCKING_THREAD},
+  {"res/BA_MW_D.264", "afd7a9765961ca241bb4bdf344b31397bec7465a", DEC_OUTPUT_DEBLOCKING_THREAD},
+  {"res/CI1_FT_B.264", "cbfec15e17a504678b19a1191992131c92a1ac26", DEC_OUTPUT_DEBLOCKING_THREAD},
+  {"res/SVA_FM1_E.264", "fad08c4ff7cf2307b6579853d0f4652fc26645d3", DEC_OUTPUT_DEBLOCKING_THREAD},
+  {"res/test_cif_P_CABAC_slice.264", "521bbd0ba2422369b724c7054545cf107a56f959", DEC_OUTPUT_DEBLOCKING_THREAD},
+  {"res/Cisco_Men_whisper_640x320_CABAC_Bframe_9.264", "931ba1caf075e7b47445c1f4410ade77a46048f6", DEC_OUTPUT_DEBLOCKING_THREAD},
+  {"res/VID_1280x720_cavlc_temporal_direct.264", "4face6b5d73a378b6e564a831b49311c230158e4", DEC_OUTPUT_DEBLOCKING_THREAD},
+  {"res/BA1_FT_C.264", "418d152fb85709b6f172799dcb239038df437cfa", DEC_OUTPUT_SLICE_THREADS},
+  {"res/CVPCMNL1_SVA_C.264", "c2b0d964de727c64b9fccb58f63b567c82bda95a", DEC_OUTPUT_SLICE_THREADS},
+  {"res/MR1_BT_A.h264", "6e585f8359667a16b03e5f49a06f5ceae8d991e0", DEC_OUTPUT_SLICE_THREADS},
+  {"res/SVA_BA2_D.264", "98ff2d67860462d8d8bcc9352097c06cc401d97e", DEC_OUTPUT_SLICE_THREADS},
+  {"res/SVA_FM1_E.264", "fad08c4ff7cf2307b6579853d0f4652fc26645d3", DEC_OUTPUT_SLICE_THREADS},
+  {"res/test_cif_I_CABAC_slice.264", "19121bc67f2b13fb8f030504fc0827e1ac6d0fdb", DEC_OUTPUT_SLICE_THREADS},
+  {"res/test_cif_P_CABAC_slice.264", "521bbd0ba2422369b724c7054545cf107a56f959", DEC_OUTPUT_SLICE_THREADS},
+  {"res/test_scalinglist_jm.264", "992a25b4ec98db4a16d61c097e614eb16afe3478", DEC_OUTPUT_SLICE_THREADS},
+  {"res/Cisco_Men_whisper_640x320_CABAC_Bframe_9.264", "931ba1caf075e7b47445c1f4410ade77a46048f6", DEC_OUTPUT_SLICE_THREADS},
+  {"res/VID_1280x720_cavlc_temporal_direct.264", "4face6b5d73a378b6e564a831b49311c230158e4", DEC_OUTPUT_SLICE_THREADS},
+  {"res/BA_MW_D.264", "afd7a9765961ca241bb4bdf344b31397bec7465a", DEC_OUTPUT_FRAME_ALLOCATOR},
+  {"res/MIDR_MW_D.264", "9467030f4786f75644bf06a7fc809c36d1959827", DEC_OUTPUT_FRAME_ALLOCATOR},
+  {"res/SVA_FM1_E.264", "fad08c4ff7cf2307b6579853d0f4652fc26645d3", DEC_OUTPUT_FRAME_ALLOCATOR},
+  {"res/Cisco_Men_whisper_640x320_CABAC_Bframe_9.264", "931ba1caf075e7b47445c1f4410ade77a46048f6", DEC_OUTPUT_FRAME_ALLOCATOR},
+  {"res/Adobe_PDF_sample_a_1024x768_50Frms.264", "9aa9a4d9598eb3e1093311826844f37c43e4c521", DEC_OUTPUT_LAZY_BORDER_EXPANSION},
+  {"res/BA_MW_D.264", "afd7a9765961ca241bb4bdf344b31397bec7465a", DEC_OUTPUT_LAZY_BORDER_EXPANSION},
+  {"res/CI1_FT_B.264", "cbfec15e17a504678b19a1191992131c92a1ac26", DEC_OUTPUT_LAZY_BORDER_EXPANSION},
+  {"res/MR1_BT_A.h264", "6e585f8359667a16b03e5f49a06f5ceae8d991e0", DEC_OUTPUT_LAZY_BORDER_EXPANSION},
+  {"res/SVA_FM1_E.264", "fad08c4ff7cf2307b6579853d0f4652fc26645d3", DEC_OUTPUT_LAZY_BORDER_EXPANSION},
+  {"res/test_cif_P_CABAC_slice.264", "521bbd0ba2422369b724c7054545cf107a56f959", DEC_OUTPUT_LAZY_BORDER_EXPANSION},
+  {"res/Cisco_Men_whisper_640x320_CABAC_Bframe_9.264", "931ba1caf075e7b47445c1f4410ade77a46048f6", DEC_OUTPUT_LAZY_BORDER_EXPANSION},
+  {"res/VID_1280x720_cavlc_temporal_direct.264", "4face6b5d73a378b6e564a831b49311c230158e4", DEC_OUTPUT_LAZY_BORDER_EXPANSION},
 };
 
 INSTANTIATE_TEST_CASE_P (DecodeFile, DecoderOutputTest,
                          ::testing::ValuesIn (kFileParamArray));
+
+struct OutputFormatParam {
+  const char* fileName;
+  int iFormat;
+};
+
+class DecoderOutputFormatTest : public ::testing::WithParamInterface<OutputFormatParam>,
+  public DecoderInitTest, public BaseDecoderTest::Callback {
+ public:
+  virtual void SetUp() {
+    DecoderInitTest::SetUp();
+    if (HasFatalFailure()) {
+      return;
+    }
+    iFormat_ = videoFormatI420;
+    SHA1Reset (&ctx_);
+  }
+  // BT.601 limited range, the conversion the decoder is expected to do
+  static uint8_t Clip (int iX) {
+    return (uint8_t) (iX < 0 ? 0 : (iX > 255 ? 255 : iX));
+  }
+  void HashConvertedFrame (const Frame& frame) {
+    const int iWidth = frame.y.width, iHeight = frame.y.height;
+    std::vector<uint8_t> vRow (iWidth * 4);
+    for (int y = 0; y < iHeight; y++) {
+      const uint8_t* pY = frame.y.data + y * frame.y.stride;
+      const uint8_t* pU = frame.u.data + (y >> 1) * frame.u.stride;
+      const uint8_t* pV = frame.v.data + (y >> 1) * frame.v.stride;
+      const int iBpp = GetParam().iFormat == videoFormatBGR ? 3 : 4;
+      for (int x = 0; x < iWidth; x++) {
+        const int c = 298 * (pY[x] - 16), d = pU[x >> 1] - 128, e = pV[x >> 1] - 128;
+        const uint8_t r = Clip ((c + 409 * e + 128) >> 8);
+        const uint8_t g = Clip ((c - 100 * d - 208 * e + 128) >> 8);
+        const uint8_t b = Clip ((c + 516 * d + 128) >> 8);
+        uint8_t* p = &vRow[x * iBpp];
+        p[0] = iBpp == 3 ? b : r;
+        p[1] = g;
+        p[2] = iBpp == 3 ? r : b;
+        if (iBpp == 4)
+          p[3] = 255;
+      }
+      SHA1Input (&ctx_, &vRow[0], iWidth * iBpp);
+    }
+  }
+  virtual void onDecodeFrame (const Frame& frame) {
+    const int iWidth = frame.y.width, iHeight = frame.y.height;
+    if (iFormat_ == videoFormatI420 && GetParam().iFormat == videoFormatNV12) {
+      std::vector<uint8_t> vRow (iWidth);
+      UpdateHashFromPlane (&ctx_, frame.y.data, iWidth, iHeight, frame.y.stride);
+      for (int y = 0; y < iHeight / 2; y++) {
+        for (int x = 0; x < iWidth / 2; x++) {
+          vRow[2 * x] = frame.u.data[y * frame.u.stride + x];
+          vRow[2 * x + 1] = frame.v.data[y * frame.v.stride + x];
+        }
+        SHA1Input (&ctx_, &vRow[0], iWidth);
+      }
+    } else if (iFormat_ == videoFormatI420) {
+      HashConvertedFrame (frame);
+    } else if (iFormat_ == videoFormatNV12) {
+      UpdateHashFromPlane (&ctx_, frame.y.data, iWidth, iHeight, frame.y.stride);
+      UpdateHashFromPlane (&ctx_, frame.u.data, iWidth, iHeight / 2, frame.u.stride);
+    } else {
+      UpdateHashFromPlane (&ctx_, frame.y.data, iWidth * (iFormat_ == videoFormatBGR ? 3 : 4), iHeight, frame.y.stride);
+    }
+  }
+ protected:
+  SHA1Context ctx_;
+  int iFormat_;
+};
+
+TEST_P (DecoderOutputFormatTest, CompareWithI420Output) {
+  OutputFormatParam p = GetParam();
+#if defined(ANDROID_NDK)
+  std::string filename = std::string ("/sdcard/") + p.fileName;
+#else
+  std::string filename = p.fileName;
+#endif
+  ASSERT_TRUE (DecodeFile (filename.c_str(), this));
+  unsigned char refDigest[SHA_DIGEST_LENGTH];
+  SHA1Result (&ctx_, refDigest);
+
+  // the output format can only be changed on an uninitialized decoder
+  decoder_->Uninitialize();
+  ASSERT_EQ (0, decoder_->SetOption (DECODER_OPTION_OUTPUT_FORMAT, &p.iFormat));
+  int iFormat = videoFormatI420;
+  ASSERT_EQ (0, decoder_->GetOption (DECODER_OPTION_OUTPUT_FORMAT, &iFormat));
+  EXPECT_EQ (p.iFormat, iFormat);
+  ASSERT_EQ (0, ReinitializeDecoder());
+  EXPECT_NE (0, decoder_->SetOption (DECODER_OPTION_OUTPUT_FORMAT, &p.iFormat));
+
+  iFormat_ = p.iFormat;
+  SHA1Reset (&ctx_);
+  ASSERT_TRUE (DecodeFile (filename.c_str(), this));
+  unsigned char digest[SHA_DIGEST_LENGTH];
+  SHA1Result (&ctx_, digest);
+  EXPECT_EQ (0, memcmp (refDigest, digest, SHA_DIGEST_LENGTH));
+}
+static const OutputFormatParam kOutputFormatParamArray[] = {
+  {"res/BA_MW_D.264", videoFormatBGR},
+  {"res/BA_MW_D.264", videoFormatRGBA},
+  {"res/BA_MW_D.264", videoFormatNV12},
+  {"res/CVFC1_Sony_C.jsv", videoFormatBGR},
+  {"res/SVA_FM1_E.264", videoFormatRGBA},
+  {"res/test_cif_P_CABAC_slice.264", videoFormatBGR},
+  {"res/Cisco_Men_whisper_640x320_CABAC_Bframe_9.264", videoFormatNV12},
+  {"res/Cisco_Men_whisper_640x320_CABAC_Bframe_9.264", videoFormatBGR},
+};
+
+INSTANTIATE_TEST_CASE_P (DecodeFile, DecoderOutputFormatTest,
+                         ::testing::ValuesIn (kOutputFormatParamArray));
+
+struct ScaledOutputParam {
+  const char* fileName;
+  int iWidth;
+  int iHeight;
+};
+
+class DecoderScaledOutputTest : public ::testing::WithParamInterface<ScaledOutputParam>,
+  public DecoderInitTest, public BaseDecoderTest::Callback {
+ public:
+  virtual void SetUp() {
+    DecoderInitTest::SetUp();
+    if (HasFatalFailure()) {
+      return;
+    }
+    bScaled_ = false;
+    SHA1Reset (&ctx_);
+  }
+  virtual void onDecodeFrame (const Frame& frame) {
+    const ScaledOutputParam& p = GetParam();
+    if (bScaled_) {
+      EXPECT_EQ (p.iWidth, frame.y.width);
+      EXPECT_EQ (p.iHeight, frame.y.height);
+      UpdateHashFromPlane (&ctx_, frame.y.data, p.iWidth, p.iHeight, frame.y.stride);
+      UpdateHashFromPlane (&ctx_, frame.u.data, p.iWidth / 2, p.iHeight / 2, frame.u.stride);
+      UpdateHashFromPlane (&ctx_, frame.v.data, p.iWidth / 2, p.iHeight / 2, frame.v.stride);
+      return;
+    }
+    // the whole picture scaled at once, as an application would do after decoding
+    const Plane* planes[3] = {&frame.y, &frame.u, &frame.v};
+    for (int i = 0; i < 3; i++) {
+      const int iWidth = i ? p.iWidth / 2 : p.iWidth, iHeight = i ? p.iHeight / 2 : p.iHeight;
+      std::vector<uint8_t> vPlane (iWidth * iHeight);
+      WelsGeneralBilinearDownsampleRows_c (&vPlane[0], iWidth, iWidth, iHeight, planes[i]->data, planes[i]->stride,
+                                           planes[i]->width, planes[i]->height, 0, iHeight);
+      SHA1Input (&ctx_, &vPlane[0], iWidth * iHeight);
+    }
+  }
+ protected:
+  SHA1Context ctx_;
+  bool bScaled_;
+};
+
+TEST_P (DecoderScaledOutputTest, CompareWithScaledI420Output) {
+  ScaledOutputParam p = GetParam();
+#if defined(ANDROID_NDK)
+  std::string filename = std::string ("/sdcard/") + p.fileName;
+#else
+  std::string filename = p.fileName;
+#endif
+  ASSERT_TRUE (DecodeFile (filename.c_str(), this));
+  unsigned char refDigest[SHA_DIGEST_LENGTH];
+  SHA1Result (&ctx_, refDigest);
+
+  decoder_->Uninitialize();
+  SDecoderScaledOutput sScaled = {p.iWidth, p.iHeight};
+  ASSERT_EQ (0, decoder_->SetOption (DECODER_OPTION_SCALED_OUTPUT, &sScaled));
+  SDecoderScaledOutput sGot = {0, 0};
+  ASSERT_EQ (0, decoder_->GetOption (DECODER_OPTION_SCALED_OUTPUT, &sGot));
+  EXPECT_EQ (p.iWidth, sGot.iWidth);
+  EXPECT_EQ (p.iHeight, sGot.iHeight);
+  int iFormat = videoFormatBGR;
+  EXPECT_NE (0, decoder_->SetOption (DECODER_OPTION_OUTPUT_FORMAT, &iFormat));
+  ASSERT_EQ (0, ReinitializeDecoder());
+  EXPECT_NE (0, decoder_->SetOption (DECODER_OPTION_SCALED_OUTPUT, &sScaled));
+
+  bScaled_ = true;
+  SHA1Reset (&ctx_);
+  ASSERT_TRUE (DecodeFile (filename.c_str(), this));
+  unsigned char digest[SHA_DIGEST_LENGTH];
+  SHA1Result (&ctx_, digest);
+  EXPECT_EQ (0, memcmp (refDigest, digest, SHA_DIGEST_LENGTH));
+}
+static const ScaledOutputParam kScaledOutputParamArray[] = {
+  {"res/BA_MW_D.264", 88, 72},
+  {"res/BA_MW_D.264", 120, 90},
+  {"res/CVFC1_Sony_C.jsv", 160, 90},
+  {"res/SVA_FM1_E.264", 100, 60},
+  {"res/test_cif_P_CABAC_slice.264", 176, 144},
+  {"res/Cisco_Men_whisper_640x320_CABAC_Bframe_9.264", 320, 180},
+};
+
+INSTANTIATE_TEST_CASE_P (DecodeFile, DecoderScaledOutputTest,
+                         ::testing::ValuesIn (kScaledOutputParamArray));
+
+struct SkipFramesParam {
+  const char* fileName;
+  int iSkipFrames;
+  int iFrameCount;   // pictures in the file
+  int iSkippedCount; // of which the skip mode drops
+};
+
+class DecoderSkipFramesTest : public ::testing::WithParamInterface<SkipFramesParam>,
+  public DecoderInitTest, public BaseDecoderTest::Callback {
+ public:
+  virtual void onDecodeFrame (const Frame& frame) {
+    SHA1Context ctx;
+    std::string sDigest (SHA_DIGEST_LENGTH, '\0');
+    SHA1Reset (&ctx);
+    UpdateHashFromPlane (&ctx, frame.y.data, frame.y.width, frame.y.height, frame.y.stride);
+    UpdateHashFromPlane (&ctx, frame.u.data, frame.u.width, frame.u.height, frame.u.stride);
+    UpdateHashFromPlane (&ctx, frame.v.data, frame.v.width, frame.v.height, frame.v.stride);
+    SHA1Result (&ctx, (unsigned char*)&sDigest[0]);
+    vDigests_.push_back (sDigest);
+  }
+ protected:
+  std::vector<std::string> vDigests_;
+};
+
+TEST_P (DecoderSkipFramesTest, KeptFramesMatchFullDecode) {
+  SkipFramesParam p = GetParam();
+#if defined(ANDROID_NDK)
+  std::string filename = std::string ("/sdcard/") + p.fileName;
+#else
+  std::string filename = p.fileName;
+#endif
+  ASSERT_TRUE (DecodeFile (filename.c_str(), this));
+  std::vector<std::string> vFullDigests;
+  vFullDigests.swap (vDigests_);
+  ASSERT_EQ (p.iFrameCount, (int)vFullDigests.size());
+
+  // the mode can be changed on a running decoder, here at the IDR picture the file starts with
+  decoder_->Uninitialize();
+  ASSERT_EQ (0, ReinitializeDecoder());
+  int iSkipFrames = DECODER_SKIP_NON_INTRA + 1;
+  EXPECT_NE (0, decoder_->SetOption (DECODER_OPTION_SKIP_FRAMES, &iSkipFrames));
+  ASSERT_EQ (0, decoder_->SetOption (DECODER_OPTION_SKIP_FRAMES, &p.iSkipFrames));
+  iSkipFrames = DECODER_SKIP_NONE;
+  ASSERT_EQ (0, decoder_->GetOption (DECODER_OPTION_SKIP_FRAMES, &iSkipFrames));
+  EXPECT_EQ (p.iSkipFrames, iSkipFrames);
+
+  ASSERT_TRUE (DecodeFile (filename.c_str(), this));
+  SDecoderStatistics sStatistics;
+  ASSERT_EQ (0, decoder_->GetOption (DECODER_OPTION_GET_STATISTICS, &sStatistics));
+  unsigned int uiSkippedFrameCount = 0;
+  ASSERT_EQ (0, decoder_->GetOption (DECODER_OPTION_SKIPPED_FRAME_COUNT, &uiSkippedFrameCount));
+  EXPECT_EQ ((unsigned int)p.iSkippedCount, uiSkippedFrameCount);
+  EXPECT_EQ ((unsigned int) (p.iFrameCount - p.iSkippedCount), sStatistics.uiDecodedFrameCount);
+  EXPECT_EQ (0u, sStatistics.uiEcFrameNum);
+  // the pictures kept decode exactly as without dropping any
+  ASSERT_EQ (p.iFrameCount - p.iSkippedCount, (int)vDigests_.size());
+  size_t iFull = 0;
+  for (size_t i = 0; i < vDigests_.size(); i++) {
+    while (iFull < vFullDigests.size() && vFullDigests[iFull] != vDigests_[i])
+      iFull++;
+    ASSERT_LT (iFull, vFullDigests.size()) << "picture " << i << " is not in the full decode";
+    iFull++;
+  }
+}
+static const SkipFramesParam kSkipFramesParamArray[] = {
+  {"res/NRF_MW_E.264", DECODER_SKIP_NON_REF, 100, 66},
+  {"res/Cisco_Men_whisper_640x320_CABAC_Bframe_9.264", DECODER_SKIP_NON_REF, 9, 7},
+  {"res/test_vd_1d.264", DECODER_SKIP_NON_REF, 9, 4},
+  {"res/MIDR_MW_D.264", DECODER_SKIP_NON_INTRA, 100, 96},
+  {"res/CVFC1_Sony_C.jsv", DECODER_SKIP_NON_INTRA, 50, 46},
+  {"res/LS_SVA_D.264", DECODER_SKIP_NON_INTRA, 1700, 1666},
+};
+
+INSTANTIATE_TEST_CASE_P (DecodeFile, DecoderSkipFramesTest,
+                         ::testing::ValuesIn (kSkipFramesParamArray));
+
+// splits an Annex B file into access units: a new one starts at an AUD, SEI or parameter set, or at a slice with
+// first_mb_in_slice 0, following a slice
+static bool ReadAccessUnits (const char* fileName, std::vector<std::string>* pAus) {
+  FILE* pFile = fopen (fileName, "rb");
+  if (pFile == NULL)
+    return false;
+  std::string sBs;
+  char szBuf[4096];
+  size_t iRead;
+  while ((iRead = fread (szBuf, 1, sizeof (szBuf), pFile)) > 0)
+    sBs.append (szBuf, iRead);
+  fclose (pFile);
+
+  std::vector<size_t> vNalStarts; // at the zeros of the start code
+  for (size_t i = 0; i + 3 < sBs.size(); i++) {
+    if (sBs[i] == 0 && sBs[i + 1] == 0 && sBs[i + 2] == 1) {
+      vNalStarts.push_back ((i > 0 && sBs[i - 1] == 0) ? i - 1 : i);
+      i += 2;
+    }
+  }
+  vNalStarts.push_back (sBs.size());
+  size_t iAuStart = 0;
+  bool bSliceSeen = false;
+  for (size_t i = 0; i + 1 < vNalStarts.size(); i++) {
+    size_t iHeader = vNalStarts[i];
+    while (sBs[iHeader] == 0)
+      iHeader++;
+    iHeader++;
+    const int iNalType = sBs[iHeader] & 0x1f;
+    const bool bSlice = (iNalType == 1 || iNalType == 5);
+    const bool bFirstMb = bSlice && iHeader + 1 < sBs.size() && (sBs[iHeader + 1] & 0x80) != 0;
+    if (bSliceSeen && (bFirstMb || (iNalType >= 6 && iNalType <= 9))) {
+      pAus->push_back (sBs.substr (iAuStart, vNalStarts[i] - iAuStart));
+      iAuStart = vNalStarts[i];
+      bSliceSeen = false;
+    }
+    bSliceSeen |= bSlice;
+  }
+  if (iAuStart < sBs.size())
+    pAus->push_back (sBs.substr (iAuStart));
+  return !pAus->empty();
+}
+
+static std::string DecodedFrameDigest (const SBufferInfo& sInfo) {
+  const SSysMEMBuffer& sBuf = sInfo.UsrData.sSystemBuffer;
+  SHA1Context ctx;
+  std::string sDigest (SHA_DIGEST_LENGTH, '\0');
+  SHA1Reset (&ctx);
+  UpdateHashFromPlane (&ctx, sInfo.pDst[0], sBuf.iWidth, sBuf.iHeight, sBuf.iStride[0]);
+  UpdateHashFromPlane (&ctx, sInfo.pDst[1], sBuf.iWidth / 2, sBuf.iHeight / 2, sBuf.iStride[1]);
+  UpdateHashFromPlane (&ctx, sInfo.pDst[2], sBuf.iWidth / 2, sBuf.iHeight / 2, sBuf.iStride[1]);
+  SHA1Result (&ctx, (unsigned char*)&sDigest[0]);
+  return sDigest;
+}
+
+class DecoderServiceTest : public DecoderInitTest, public BaseDecoderTest::Callback {
+ public:
+  virtual void SetUp() {
+    DecoderInitTest::SetUp();
+    if (HasFatalFailure()) {
+      return;
+    }
+    memset (&decParam_, 0, sizeof (SDecodingParam));
+    decParam_.uiTargetDqLayer = UCHAR_MAX;
+    decParam_.eEcActiveIdc = ERROR_CON_SLICE_COPY;
+    decParam_.sVideoProperty.eVideoBsType = VIDEO_BITSTREAM_DEFAULT;
+    service_ = NULL;
+    ASSERT_EQ (0, WelsCreateDecoderService (&service_));
+    ASSERT_TRUE (service_ != NULL);
+  }
+  virtual void TearDown() {
+    WelsDestroyDecoderService (service_);
+    DecoderInitTest::TearDown();
+  }
+  virtual void onDecodeFrame (const Frame& frame) {
+    SHA1Context ctx;
+    std::string sDigest (SHA_DIGEST_LENGTH, '\0');
+    SHA1Reset (&ctx);
+    UpdateHashFromPlane (&ctx, frame.y.data, frame.y.width, frame.y.height, frame.y.stride);
+    UpdateHashFromPlane (&ctx, frame.u.data, frame.u.width, frame.u.height, frame.u.stride);
+    UpdateHashFromPlane (&ctx, frame.v.data, frame.v.width, frame.v.height, frame.v.stride);
+    SHA1Result (&ctx, (unsigned char*)&sDigest[0]);
+    vDigests_.push_back (sDigest);
+  }
+  // per picture digests of a plain single decoder run
+  void DecodeReference (const char* fileName, std::vector<std::string>* pDigests) {
+    decoder_->Uninitialize();
+    ASSERT_EQ (0, decoder_->Initialize (&decParam_));
+    vDigests_.clear();
+    ASSERT_TRUE (DecodeFile (fileName, this));
+    pDigests->swap (vDigests_);
+  }
+  // collects the stream's pictures until none is ready, or until its queue is drained with bWait
+  void CollectFrames (int iStreamId, bool bWait, std::vector<std::string>* pDigests) {
+    SDecodedFrame* pFrame = NULL;
+    while (0 == service_->GetDecodedFrame (iStreamId, &pFrame, bWait)) {
+      ASSERT_TRUE (pFrame != NULL);
+      EXPECT_EQ (iStreamId, pFrame->iStreamId);
+      EXPECT_EQ (1, pFrame->sBufferInfo.iBufferStatus);
+      pDigests->push_back (DecodedFrameDigest (pFrame->sBufferInfo));
+      ASSERT_EQ (0, service_->ReleaseDecodedFrame (pFrame));
+    }
+  }
+ protected:
+  SDecodingParam decParam_;
+  ISVCDecoderService* service_;
+  std::vector<std::string> vDigests_;
+};
+
+TEST_F (DecoderServiceTest, StreamsMatchSingleDecoders) {
+  static const char* kFiles[] = {
+    "res/BA1_FT_C.264",
+    "res/MIDR_MW_D.264",
+    "res/Cisco_Men_whisper_640x320_CABAC_Bframe_9.264",
+    "res/test_vd_1d.264",
+    "res/CVFC1_Sony_C.jsv",
+    "res/MIDR_MW_D.264",
+  };
+  const int kiStreamNum = sizeof (kFiles) / sizeof (kFiles[0]);
+  std::vector<std::string> vAus[kiStreamNum];
+  std::vector<std::string> vRefDigests[kiStreamNum];
+  std::vector<std::string> vDigests[kiStreamNum];
+  for (int i = 0; i < kiStreamNum; i++) {
+#if defined(ANDROID_NDK)
+    std::string filename = std::string ("/sdcard/") + kFiles[i];
+#else
+    std::string filename = kFiles[i];
+#endif
+    ASSERT_TRUE (ReadAccessUnits (filename.c_str(), &vAus[i]));
+    DecodeReference (filename.c_str(), &vRefDigests[i]);
+    ASSERT_FALSE (vRefDigests[i].empty());
+  }
+
+  SDecoderServiceParam sParam;
+  memset (&sParam, 0, sizeof (sParam));
+  sParam.sThreadPool.iThreadNum = 2;
+  ASSERT_EQ (0, service_->Initialize (&sParam));
+  int iStreamIds[kiStreamNum];
+  for (int i = 0; i < kiStreamNum; i++) {
+    ASSERT_EQ (0, service_->OpenStream (&decParam_, &iStreamIds[i]));
+  }
+  int iThreads = 1;
+  EXPECT_NE (0, service_->SetStreamOption (iStreamIds[0], DECODER_OPTION_NUM_OF_THREADS, &iThreads));
+
+  // feed the streams round robin, an access unit at a time, the last one ending the stream
+  size_t iNextAu[kiStreamNum] = {0};
+  for (bool bPending = true; bPending;) {
+    bPending = false;
+    for (int i = 0; i < kiStreamNum; i++) {
+      if (iNextAu[i] > vAus[i].size())
+        continue;
+      const bool kbEnd = (iNextAu[i] == vAus[i].size());
+      const unsigned char* pSrc = kbEnd ? NULL : (const unsigned char*)vAus[i][iNextAu[i]].data();
+      const int iLen = kbEnd ? 0 : (int)vAus[i][iNextAu[i]].size();
+      const long kiRet = service_->SubmitAccessUnit (iStreamIds[i], pSrc, iLen, iNextAu[i]);
+      if (0 == kiRet)
+        iNextAu[i]++;
+      else
+        ASSERT_EQ (cmRetryLater, kiRet);
+      CollectFrames (iStreamIds[i], false, &vDigests[i]);
+      bPending |= (iNextAu[i] <= vAus[i].size());
+    }
+  }
+  for (int i = 0; i < kiStreamNum; i++) {
+    CollectFrames (iStreamIds[i], true, &vDigests[i]);
+    EXPECT_TRUE (vRefDigests[i] == vDigests[i]) << kFiles[i];
+    EXPECT_EQ (0, service_->CloseStream (iStreamIds[i]));
+  }
+  EXPECT_EQ (0, service_->Uninitialize());
+}
+
+TEST_F (DecoderServiceTest, PictureBudgetHoldsSubmission) {
+#if defined(ANDROID_NDK)
+  std::string filename = std::string ("/sdcard/") + "res/MIDR_MW_D.264";
+#else
+  std::string filename = "res/MIDR_MW_D.264";
+#endif
+  std::vector<std::string> vAus;
+  ASSERT_TRUE (ReadAccessUnits (filename.c_str(), &vAus));
+  std::vector<std::string> vRefDigests;
+  DecodeReference (filename.c_str(), &vRefDigests);
+  ASSERT_FALSE (vRefDigests.empty());
+
+  // any picture uses the budget up
+  SDecoderServiceParam sParam;
+  memset (&sParam, 0, sizeof (sParam));
+  sParam.sThreadPool.iThreadNum = 1;
+  sParam.iPictureBudget = 1;
+  ASSERT_EQ (0, service_->Initialize (&sParam));
+  int iStreamId = -1;
+  ASSERT_EQ (0, service_->OpenStream (&decParam_, &iStreamId));
+  ASSERT_EQ (0, service_->SubmitAccessUnit (iStreamId, (const unsigned char*)vAus[0].data(), (int)vAus[0].size(), 0));
+  SDecodedFrame* pFrame = NULL;
+  ASSERT_EQ (0, service_->GetDecodedFrame (iStreamId, &pFrame, true));
+  EXPECT_EQ (cmRetryLater, service_->SubmitAccessUnit (iStreamId, (const unsigned char*)vAus[1].data(),
+             (int)vAus[1].size(), 1));
+
+  // the held picture outlives its stream and the budget comes back with it
+  ASSERT_EQ (0, service_->CloseStream (iStreamId));
+  EXPECT_TRUE (vRefDigests[0] == DecodedFrameDigest (pFrame->sBufferInfo));
+  ASSERT_EQ (0, service_->ReleaseDecodedFrame (pFrame));
+  EXPECT_NE (0, service_->ReleaseDecodedFrame (pFrame));
+  ASSERT_EQ (0, service_->OpenStream (&decParam_, &iStreamId));
+  EXPECT_EQ (0, service_->SubmitAccessUnit (iStreamId, (const unsigned char*)vAus[0].data(), (int)vAus[0].size(), 0));
+  EXPECT_EQ (0, service_->Uninitialize());
+}
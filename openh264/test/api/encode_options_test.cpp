@@ -2388,3 +2388,743 @@ TEST_F (EncodeDecodeTestAPI, ENCODER_OPTION_IDR_INTERVAL) {
     }
   }
 }
+
+TEST_F (EncodeDecodeTestAPI, SourceBufferInPlaceMatchesCopy) {
+  const int iWidth = 320, iHeight = 192;
+  encoder_->GetDefaultParams (&param_);
+  prepareParamDefault (1, 1, iWidth, iHeight, 30.0f, &param_);
+  int rv = encoder_->InitializeExt (&param_);
+  ASSERT_TRUE (rv == cmResultSuccess);
+
+  ISVCEncoder* pInPlaceEncoder = NULL;
+  ASSERT_EQ (0, WelsCreateSVCEncoder (&pInPlaceEncoder));
+  rv = pInPlaceEncoder->InitializeExt (&param_);
+  ASSERT_TRUE (rv == cmResultSuccess);
+  ASSERT_TRUE (InitialEncDec (iWidth, iHeight));
+
+  std::vector<unsigned char> vCopyBs, vInPlaceBs;
+  SFrameBSInfo sInPlaceInfo;
+  for (int iFrame = 0; iFrame < 10; iFrame++) {
+    SSourcePicture sLent;
+    memset (&sLent, 0, sizeof (SSourcePicture));
+    rv = pInPlaceEncoder->GetOption (ENCODER_OPTION_GET_SOURCE_BUFFER, &sLent);
+    ASSERT_TRUE (rv == cmResultSuccess);
+    ASSERT_EQ (iWidth, sLent.iPicWidth);
+    ASSERT_EQ (iHeight, sLent.iPicHeight);
+    // the lent buffer is read only through GetOption()
+    EXPECT_EQ (cmInitParaError, pInPlaceEncoder->SetOption (ENCODER_OPTION_GET_SOURCE_BUFFER, &sLent));
+
+    // fill the lent planes directly, the way a capture path would
+    for (int iPlane = 0; iPlane < 3; iPlane++) {
+      const int iPlaneWidth = iPlane ? (iWidth >> 1) : iWidth;
+      const int iPlaneHeight = iPlane ? (iHeight >> 1) : iHeight;
+      for (int y = 0; y < iPlaneHeight; y++) {
+        for (int x = 0; x < iPlaneWidth; x++)
+          sLent.pData[iPlane][y * sLent.iStride[iPlane] + x] = (unsigned char) ((x * (iPlane + 1) + y * 3 + iFrame * 5) ^
+              (y >> 2));
+        memcpy (EncPic.pData[iPlane] + y * EncPic.iStride[iPlane], sLent.pData[iPlane] + y * sLent.iStride[iPlane],
+                iPlaneWidth);
+      }
+    }
+    sLent.uiTimeStamp = EncPic.uiTimeStamp = iFrame * 33;
+
+    rv = encoder_->EncodeFrame (&EncPic, &info);
+    ASSERT_TRUE (rv == cmResultSuccess);
+    memset (&sInPlaceInfo, 0, sizeof (SFrameBSInfo));
+    rv = pInPlaceEncoder->EncodeFrame (&sLent, &sInPlaceInfo);
+    ASSERT_TRUE (rv == cmResultSuccess);
+
+    for (int i = 0; i < info.iLayerNum; i++) {
+      int iLen = 0;
+      for (int j = 0; j < info.sLayerInfo[i].iNalCount; j++)
+        iLen += info.sLayerInfo[i].pNalLengthInByte[j];
+      vCopyBs.insert (vCopyBs.end(), info.sLayerInfo[i].pBsBuf, info.sLayerInfo[i].pBsBuf + iLen);
+    }
+    for (int i = 0; i < sInPlaceInfo.iLayerNum; i++) {
+      int iLen = 0;
+      for (int j = 0; j < sInPlaceInfo.sLayerInfo[i].iNalCount; j++)
+        iLen += sInPlaceInfo.sLayerInfo[i].pNalLengthInByte[j];
+      vInPlaceBs.insert (vInPlaceBs.end(), sInPlaceInfo.sLayerInfo[i].pBsBuf, sInPlaceInfo.sLayerInfo[i].pBsBuf + iLen);
+    }
+  }
+  EXPECT_FALSE (vCopyBs.empty());
+  EXPECT_TRUE (vCopyBs == vInPlaceBs);
+
+  pInPlaceEncoder->Uninitialize();
+  WelsDestroySVCEncoder (pInPlaceEncoder);
+}
+
+static void AppendFrameBs (const SFrameBSInfo& sInfo, std::vector<unsigned char>* pBs) {
+  for (int i = 0; i < sInfo.iLayerNum; i++) {
+    int iLen = 0;
+    for (int j = 0; j < sInfo.sLayerInfo[i].iNalCount; j++)
+      iLen += sInfo.sLayerInfo[i].pNalLengthInByte[j];
+    pBs->insert (pBs->end(), sInfo.sLayerInfo[i].pBsBuf, sInfo.sLayerInfo[i].pBsBuf + iLen);
+  }
+}
+
+// the input pictures are given the timestamps kiFirstTimeStamp + iFrame * kiTimeStampStep
+static void EncodeFileWithThreads (const SEncParamExt& sBaseParam, const int iThreadNum, const char* pFileName,
+                                   std::vector<unsigned char>* pBs, const SThreadPoolParam* pPoolParam = NULL,
+                                   const long long kiFirstTimeStamp = 0, const int kiTimeStampStep = 83) {
+  ISVCEncoder* pEncoder = NULL;
+  ASSERT_EQ (0, WelsCreateSVCEncoder (&pEncoder));
+  SEncParamExt sParam = sBaseParam;
+  sParam.iMultipleThreadIdc = iThreadNum;
+  int iTraceLevel = WELS_LOG_QUIET;
+  pEncoder->SetOption (ENCODER_OPTION_TRACE_LEVEL, &iTraceLevel);
+  if (pPoolParam) {
+    ASSERT_EQ (cmResultSuccess, pEncoder->SetOption (ENCODER_OPTION_THREAD_POOL, (void*)pPoolParam));
+  }
+  ASSERT_EQ (cmResultSuccess, pEncoder->InitializeExt (&sParam));
+
+  FileInputStream fileStream;
+  ASSERT_TRUE (fileStream.Open (pFileName));
+  const int iFrameSize = sParam.iPicWidth * sParam.iPicHeight * 3 / 2;
+  BufferedData buf;
+  ASSERT_EQ (0, buf.SetLength (iFrameSize));
+
+  SSourcePicture sPic;
+  memset (&sPic, 0, sizeof (SSourcePicture));
+  sPic.iPicWidth    = sParam.iPicWidth;
+  sPic.iPicHeight   = sParam.iPicHeight;
+  sPic.iColorFormat = videoFormatI420;
+  sPic.iStride[0]   = sPic.iPicWidth;
+  sPic.iStride[1]   = sPic.iStride[2] = sPic.iPicWidth >> 1;
+  sPic.pData[0]     = buf.data();
+  sPic.pData[1]     = sPic.pData[0] + sPic.iPicWidth * sPic.iPicHeight;
+  sPic.pData[2]     = sPic.pData[1] + (sPic.iPicWidth * sPic.iPicHeight >> 2);
+
+  SFrameBSInfo sInfo;
+  for (int iFrame = 0; fileStream.read (buf.data(), iFrameSize) == iFrameSize; iFrame++) {
+    sPic.uiTimeStamp = kiFirstTimeStamp + iFrame * kiTimeStampStep;
+    memset (&sInfo, 0, sizeof (SFrameBSInfo));
+    ASSERT_EQ (cmResultSuccess, pEncoder->EncodeFrame (&sPic, &sInfo));
+    AppendFrameBs (sInfo, pBs);
+  }
+  // flush the pictures still held by the pipeline or the lookahead
+  const int iHeldFrames = (sParam.iLookaheadFrames > 0) ? sParam.iLookaheadFrames :
+                          (sParam.bEnableFramePipeline ? 1 : 0);
+  for (int i = 0; i < iHeldFrames; i++) {
+    memset (&sInfo, 0, sizeof (SFrameBSInfo));
+    ASSERT_EQ (cmResultSuccess, pEncoder->EncodeFrame (NULL, &sInfo));
+    AppendFrameBs (sInfo, pBs);
+  }
+  pEncoder->Uninitialize();
+  WelsDestroySVCEncoder (pEncoder);
+}
+
+TEST_F (EncodeDecodeTestAPI, WavefrontMdMatchesSingleThread) {
+  const char* pFileName = "res/CiscoVT2people_320x192_12fps.yuv";
+  SEncParamExt sParam;
+  encoder_->GetDefaultParams (&sParam);
+  prepareParamDefault (1, 1, 320, 192, 12.0f, &sParam);
+  sParam.iUsageType = CAMERA_VIDEO_REAL_TIME;
+  sParam.iRCMode = RC_BITRATE_MODE;
+  sParam.iTargetBitrate = sParam.sSpatialLayers[0].iSpatialBitrate = 300000;
+  sParam.sSpatialLayers[0].iMaxSpatialBitrate = UNSPECIFIED_BIT_RATE;
+  sParam.sSpatialLayers[0].sSliceArgument.uiSliceMode = SM_SINGLE_SLICE;
+  sParam.bEnableAdaptiveQuant = true;
+  sParam.bEnableBackgroundDetection = true;
+  sParam.bUseWavefrontMd = true;
+
+  for (int iEntropy = 0; iEntropy < 2; iEntropy++) {
+    sParam.iEntropyCodingModeFlag = iEntropy;
+    std::vector<unsigned char> vSingleThreadBs, vWavefrontBs;
+    EncodeFileWithThreads (sParam, 1, pFileName, &vSingleThreadBs);
+    EncodeFileWithThreads (sParam, 4, pFileName, &vWavefrontBs);
+    EXPECT_FALSE (vSingleThreadBs.empty());
+    EXPECT_TRUE (vSingleThreadBs == vWavefrontBs) << "iEntropyCodingModeFlag = " << iEntropy;
+  }
+}
+
+TEST_F (EncodeDecodeTestAPI, FramePipelineMatchesSequential) {
+  const char* pFileName = "res/CiscoVT2people_320x192_12fps.yuv";
+  SEncParamExt sParam;
+  encoder_->GetDefaultParams (&sParam);
+  prepareParamDefault (2, 1, 320, 192, 12.0f, &sParam);
+  sParam.iUsageType = CAMERA_VIDEO_REAL_TIME;
+  sParam.iRCMode = RC_BITRATE_MODE;
+  sParam.iTargetBitrate = 300000;
+  for (int i = 0; i < 2; i++) {
+    sParam.sSpatialLayers[i].iSpatialBitrate = (i + 1) * 100000;
+    sParam.sSpatialLayers[i].iMaxSpatialBitrate = UNSPECIFIED_BIT_RATE;
+    sParam.sSpatialLayers[i].sSliceArgument.uiSliceMode = SM_SINGLE_SLICE;
+  }
+  sParam.bEnableDenoise = true;
+  sParam.bEnableSceneChangeDetect = true;
+  sParam.bEnableAdaptiveQuant = true;
+
+  // analysed in place, analysed with the staging
+  for (int iBgd = 1; iBgd >= 0; iBgd--) {
+    sParam.bEnableBackgroundDetection = (iBgd != 0);
+    sParam.bEnableFramePipeline = false;
+    std::vector<unsigned char> vSequentialBs, vPipelineBs;
+    EncodeFileWithThreads (sParam, 1, pFileName, &vSequentialBs);
+    sParam.bEnableFramePipeline = true;
+    EncodeFileWithThreads (sParam, 2, pFileName, &vPipelineBs);
+    EXPECT_FALSE (vSequentialBs.empty());
+    EXPECT_TRUE (vSequentialBs == vPipelineBs) << "bEnableBackgroundDetection = " << iBgd;
+  }
+}
+
+// encodes kiFrameNum pictures, halves the resolution, which reinitializes the encoder, and encodes kiFrameNum more;
+// the change has to be refused while pictures are held back and go through once they are flushed
+static void EncodeResolutionChangeMidStream (const SEncParamExt& sBaseParam, const int iThreadNum,
+    int* pOutputFrameNum) {
+  const int kiFrameNum = 6;
+  *pOutputFrameNum = 0;
+  ISVCEncoder* pEncoder = NULL;
+  ASSERT_EQ (0, WelsCreateSVCEncoder (&pEncoder));
+  SEncParamExt sParam = sBaseParam;
+  sParam.iMultipleThreadIdc = iThreadNum;
+  int iTraceLevel = WELS_LOG_QUIET;
+  pEncoder->SetOption (ENCODER_OPTION_TRACE_LEVEL, &iTraceLevel);
+  ASSERT_EQ (cmResultSuccess, pEncoder->InitializeExt (&sParam));
+
+  FileInputStream fileStream;
+  ASSERT_TRUE (fileStream.Open ("res/CiscoVT2people_320x192_12fps.yuv"));
+  const int iFrameSize = sParam.iPicWidth * sParam.iPicHeight * 3 / 2;
+  std::vector<unsigned char> vFileFrames (iFrameSize * kiFrameNum);
+  ASSERT_EQ (iFrameSize * kiFrameNum, fileStream.read (&vFileFrames[0], vFileFrames.size()));
+
+  const int iHeldFrames = (sParam.iLookaheadFrames > 0) ? sParam.iLookaheadFrames :
+                          (sParam.bEnableFramePipeline ? 1 : 0);
+  SSourcePicture sPic;
+  memset (&sPic, 0, sizeof (SSourcePicture));
+  sPic.iColorFormat = videoFormatI420;
+  sPic.iStride[0]   = sParam.iPicWidth;
+  sPic.iStride[1]   = sPic.iStride[2] = sParam.iPicWidth >> 1;
+  SFrameBSInfo sInfo;
+  for (int iPart = 0; iPart < 2; iPart++) {
+    // the second part reads the top left quarter of the same pictures
+    sPic.iPicWidth  = sParam.iPicWidth;
+    sPic.iPicHeight = sParam.iPicHeight;
+    for (int iFrame = 0; iFrame < kiFrameNum + iHeldFrames; iFrame++) {
+      memset (&sInfo, 0, sizeof (SFrameBSInfo));
+      if (iFrame < kiFrameNum) {
+        sPic.pData[0]    = &vFileFrames[iFrame * iFrameSize];
+        sPic.pData[1]    = sPic.pData[0] + sPic.iStride[0] * sBaseParam.iPicHeight;
+        sPic.pData[2]    = sPic.pData[1] + (sPic.iStride[0] * sBaseParam.iPicHeight >> 2);
+        sPic.uiTimeStamp = (iPart * kiFrameNum + iFrame) * 83;
+        ASSERT_EQ (cmResultSuccess, pEncoder->EncodeFrame (&sPic, &sInfo));
+      } else {
+        ASSERT_EQ (cmResultSuccess, pEncoder->EncodeFrame (NULL, &sInfo));
+      }
+      if (sInfo.eFrameType != videoFrameTypeSkip && sInfo.iLayerNum > 0)
+        ++ (*pOutputFrameNum);
+      // the change is refused as long as anything is held back
+      if (iPart == 0 && iFrame + 1 == kiFrameNum && iHeldFrames > 0) {
+        SEncParamExt sHalfParam = sParam;
+        sHalfParam.iPicWidth  = sHalfParam.sSpatialLayers[0].iVideoWidth  = sParam.iPicWidth >> 1;
+        sHalfParam.iPicHeight = sHalfParam.sSpatialLayers[0].iVideoHeight = sParam.iPicHeight >> 1;
+        EXPECT_EQ (cmInitParaError, pEncoder->SetOption (ENCODER_OPTION_SVC_ENCODE_PARAM_EXT, &sHalfParam));
+      }
+    }
+    if (iPart == 0) {
+      sParam.iPicWidth  = sParam.sSpatialLayers[0].iVideoWidth  = sParam.iPicWidth >> 1;
+      sParam.iPicHeight = sParam.sSpatialLayers[0].iVideoHeight = sParam.iPicHeight >> 1;
+      ASSERT_EQ (cmResultSuccess, pEncoder->SetOption (ENCODER_OPTION_SVC_ENCODE_PARAM_EXT, &sParam));
+    }
+  }
+  pEncoder->Uninitialize();
+  WelsDestroySVCEncoder (pEncoder);
+}
+
+TEST_F (EncodeDecodeTestAPI, FramePipelineResolutionChangeKeepsFrames) {
+  SEncParamExt sParam;
+  encoder_->GetDefaultParams (&sParam);
+  prepareParamDefault (1, 1, 320, 192, 12.0f, &sParam);
+  sParam.iUsageType = CAMERA_VIDEO_REAL_TIME;
+  sParam.iRCMode = RC_BITRATE_MODE;
+  sParam.iTargetBitrate = sParam.sSpatialLayers[0].iSpatialBitrate = 300000;
+  sParam.sSpatialLayers[0].iMaxSpatialBitrate = UNSPECIFIED_BIT_RATE;
+  sParam.bEnableFrameSkip = false;
+  sParam.bEnableFramePipeline = true;
+
+  int iOutputFrameNum = 0;
+  EncodeResolutionChangeMidStream (sParam, 2, &iOutputFrameNum);
+  EXPECT_EQ (12, iOutputFrameNum);
+}
+
+TEST_F (EncodeDecodeTestAPI, WavefrontDeblockingMatchesSingleThread) {
+  const char* pFileName = "res/CiscoVT2people_320x192_12fps.yuv";
+  SEncParamExt sParam;
+  encoder_->GetDefaultParams (&sParam);
+  prepareParamDefault (1, 1, 320, 192, 12.0f, &sParam);
+  sParam.iUsageType = CAMERA_VIDEO_REAL_TIME;
+  sParam.iTemporalLayerNum = 2;
+  sParam.iRCMode = RC_QUALITY_MODE;
+  sParam.iTargetBitrate = sParam.sSpatialLayers[0].iSpatialBitrate = 200000;
+  sParam.sSpatialLayers[0].iMaxSpatialBitrate = UNSPECIFIED_BIT_RATE;
+  sParam.sSpatialLayers[0].sSliceArgument.uiSliceMode = SM_SINGLE_SLICE;
+  sParam.bUseWavefrontMd = true;
+
+  // deblocking along with the border expansion, border expansion alone
+  for (int iLoopFilterDisableIdc = 0; iLoopFilterDisableIdc < 2; iLoopFilterDisableIdc++) {
+    sParam.iLoopFilterDisableIdc = iLoopFilterDisableIdc;
+    std::vector<unsigned char> vSingleThreadBs, vWavefrontBs;
+    EncodeFileWithThreads (sParam, 1, pFileName, &vSingleThreadBs);
+    EncodeFileWithThreads (sParam, 4, pFileName, &vWavefrontBs);
+    EXPECT_FALSE (vSingleThreadBs.empty());
+    EXPECT_TRUE (vSingleThreadBs == vWavefrontBs) << "iLoopFilterDisableIdc = " << iLoopFilterDisableIdc;
+  }
+}
+
+TEST_F (EncodeDecodeTestAPI, OwnThreadPoolMatchesSharedPool) {
+  const char* pFileName = "res/CiscoVT2people_320x192_12fps.yuv";
+  SEncParamExt sParam;
+  encoder_->GetDefaultParams (&sParam);
+  prepareParamDefault (1, 1, 320, 192, 12.0f, &sParam);
+  sParam.iUsageType = CAMERA_VIDEO_REAL_TIME;
+  sParam.iRCMode = RC_BITRATE_MODE;
+  sParam.iTargetBitrate = sParam.sSpatialLayers[0].iSpatialBitrate = 300000;
+  sParam.sSpatialLayers[0].iMaxSpatialBitrate = UNSPECIFIED_BIT_RATE;
+  sParam.sSpatialLayers[0].sSliceArgument.uiSliceMode = SM_FIXEDSLCNUM_SLICE;
+  sParam.sSpatialLayers[0].sSliceArgument.uiSliceNum = 4;
+  // slice boundaries follow the measured slice times otherwise
+  sParam.bUseLoadBalancing = false;
+
+  SThreadPoolParam sPoolParam;
+  memset (&sPoolParam, 0, sizeof (SThreadPoolParam));
+  sPoolParam.iThreadNum = 2;
+  sPoolParam.iAffinityCpuNum = 1;
+  sPoolParam.iAffinityCpu[0] = 0;
+
+  std::vector<unsigned char> vSharedPoolBs, vOwnPoolBs, vNamedPoolBs;
+  EncodeFileWithThreads (sParam, 4, pFileName, &vSharedPoolBs);
+  EncodeFileWithThreads (sParam, 4, pFileName, &vOwnPoolBs, &sPoolParam);
+  strncpy (sPoolParam.szPoolName, "numa0", MAX_THREAD_POOL_NAME_LEN);
+  EncodeFileWithThreads (sParam, 4, pFileName, &vNamedPoolBs, &sPoolParam);
+  EXPECT_FALSE (vSharedPoolBs.empty());
+  EXPECT_TRUE (vSharedPoolBs == vOwnPoolBs);
+  EXPECT_TRUE (vSharedPoolBs == vNamedPoolBs);
+
+  SThreadPoolParam sGotParam;
+  ASSERT_EQ (cmResultSuccess, encoder_->SetOption (ENCODER_OPTION_THREAD_POOL, &sPoolParam));
+  ASSERT_EQ (cmResultSuccess, encoder_->GetOption (ENCODER_OPTION_THREAD_POOL, &sGotParam));
+  EXPECT_EQ (0, memcmp (&sPoolParam, &sGotParam, sizeof (SThreadPoolParam)));
+  sPoolParam.iAffinityCpuNum = MAX_THREAD_AFFINITY_CPU_NUM + 1;
+  EXPECT_EQ (cmInitParaError, encoder_->SetOption (ENCODER_OPTION_THREAD_POOL, &sPoolParam));
+}
+
+TEST_F (EncodeDecodeTestAPI, AsyncEncodeMatchesSync) {
+  const char* pFileName = "res/CiscoVT2people_320x192_12fps.yuv";
+  SEncParamExt sParam;
+  encoder_->GetDefaultParams (&sParam);
+  prepareParamDefault (1, 1, 320, 192, 12.0f, &sParam);
+  sParam.iRCMode = RC_BITRATE_MODE;
+  sParam.iTargetBitrate = sParam.sSpatialLayers[0].iSpatialBitrate = 300000;
+  sParam.sSpatialLayers[0].iMaxSpatialBitrate = UNSPECIFIED_BIT_RATE;
+
+  std::vector<unsigned char> vSyncBs, vAsyncBs;
+  EncodeFileWithThreads (sParam, 1, pFileName, &vSyncBs);
+
+  // every submitted picture has to stay untouched until its frame comes back
+  FileInputStream fileStream;
+  ASSERT_TRUE (fileStream.Open (pFileName));
+  const int iFrameSize = sParam.iPicWidth * sParam.iPicHeight * 3 / 2;
+  std::vector<std::vector<unsigned char> > vFrames;
+  std::vector<unsigned char> vFrame (iFrameSize);
+  while (fileStream.read (&vFrame[0], iFrameSize) == iFrameSize)
+    vFrames.push_back (vFrame);
+  ASSERT_FALSE (vFrames.empty());
+
+  ISVCEncoder* pEncoder = NULL;
+  ASSERT_EQ (0, WelsCreateSVCEncoder (&pEncoder));
+  int iTraceLevel = WELS_LOG_QUIET;
+  pEncoder->SetOption (ENCODER_OPTION_TRACE_LEVEL, &iTraceLevel);
+  ASSERT_EQ (cmResultSuccess, pEncoder->InitializeExt (&sParam));
+  int iQueueDepth = 0;
+  EXPECT_EQ (cmInitParaError, pEncoder->SetOption (ENCODER_OPTION_ASYNC_QUEUE_DEPTH, &iQueueDepth));
+  iQueueDepth = 3;
+  ASSERT_EQ (cmResultSuccess, pEncoder->SetOption (ENCODER_OPTION_ASYNC_QUEUE_DEPTH, &iQueueDepth));
+
+  SEncodedFrame* pFrame = NULL;
+  EXPECT_EQ (cmRetryLater, pEncoder->GetEncodedFrame (&pFrame, true));
+
+  SSourcePicture sPic;
+  memset (&sPic, 0, sizeof (SSourcePicture));
+  sPic.iPicWidth    = sParam.iPicWidth;
+  sPic.iPicHeight   = sParam.iPicHeight;
+  sPic.iColorFormat = videoFormatI420;
+  sPic.iStride[0]   = sPic.iPicWidth;
+  sPic.iStride[1]   = sPic.iStride[2] = sPic.iPicWidth >> 1;
+
+  size_t iSubmitted = 0, iReceived = 0;
+  while (iReceived < vFrames.size()) {
+    int iRet = cmRetryLater;
+    if (iSubmitted < vFrames.size()) {
+      sPic.pData[0]    = &vFrames[iSubmitted][0];
+      sPic.pData[1]    = sPic.pData[0] + sPic.iPicWidth * sPic.iPicHeight;
+      sPic.pData[2]    = sPic.pData[1] + (sPic.iPicWidth * sPic.iPicHeight >> 2);
+      sPic.uiTimeStamp = iSubmitted * 83;
+      iRet = pEncoder->EncodeFrameAsync (&sPic, &vFrames[iSubmitted]);
+      ASSERT_TRUE (iRet == cmResultSuccess || iRet == cmRetryLater) << iRet;
+      if (iRet == cmResultSuccess) {
+        iSubmitted++;
+        continue;
+      }
+      // the queue only frees up once a frame is released
+      EXPECT_EQ ((size_t)iQueueDepth, iSubmitted - iReceived);
+      EXPECT_EQ (cmRetryLater, pEncoder->SetOption (ENCODER_OPTION_ASYNC_QUEUE_DEPTH, &iQueueDepth));
+    }
+    ASSERT_EQ (cmResultSuccess, pEncoder->GetEncodedFrame (&pFrame, true));
+    EXPECT_EQ (cmResultSuccess, pFrame->iReturn);
+    EXPECT_TRUE (pFrame->pUserData == &vFrames[iReceived]);
+    EXPECT_EQ (pFrame->sBsInfo.sLayerInfo[0].pBsBuf, pFrame->pBsBuf);
+    vAsyncBs.insert (vAsyncBs.end(), pFrame->pBsBuf, pFrame->pBsBuf + pFrame->sBsInfo.iFrameSizeInBytes);
+    EXPECT_EQ (cmResultSuccess, pEncoder->ReleaseEncodedFrame (pFrame));
+    EXPECT_EQ (cmInitParaError, pEncoder->ReleaseEncodedFrame (pFrame));
+    iReceived++;
+  }
+  EXPECT_EQ (cmRetryLater, pEncoder->GetEncodedFrame (&pFrame, false));
+  pEncoder->Uninitialize();
+  WelsDestroySVCEncoder (pEncoder);
+
+  EXPECT_FALSE (vSyncBs.empty());
+  EXPECT_TRUE (vSyncBs == vAsyncBs);
+}
+
+static void CheckMemoryUsage (const SMemoryUsage& sUsage) {
+  long long iCategorySum = 0;
+  for (int i = 0; i < MEMORY_CATEGORY_NUM; i++) {
+    EXPECT_GE (sUsage.iCategoryCurrentBytes[i], 0);
+    EXPECT_GE (sUsage.iCategoryPeakBytes[i], sUsage.iCategoryCurrentBytes[i]);
+    iCategorySum += sUsage.iCategoryCurrentBytes[i];
+  }
+  EXPECT_EQ (sUsage.iCurrentBytes, iCategorySum);
+  EXPECT_GE (sUsage.iPeakBytes, sUsage.iCurrentBytes);
+  EXPECT_GT (sUsage.iCategoryCurrentBytes[MEMORY_CATEGORY_PICTURES], 0);
+  EXPECT_GT (sUsage.iCategoryCurrentBytes[MEMORY_CATEGORY_BITSTREAM], 0);
+  EXPECT_GT (sUsage.iCategoryCurrentBytes[MEMORY_CATEGORY_MB_CACHES], 0);
+}
+
+TEST_F (EncodeDecodeTestAPI, GetOptionMemoryUsage) {
+  SMemoryUsage sEncUsage, sDecUsage;
+  EXPECT_EQ (cmInitExpected, encoder_->GetOption (ENCODER_OPTION_MEMORY_USAGE, &sEncUsage));
+  prepareParamDefault (1, 1, 320, 192, 12.0f, &param_);
+  encoder_->Uninitialize();
+  ASSERT_EQ (cmResultSuccess, encoder_->InitializeExt (&param_));
+  EXPECT_EQ (cmInitParaError, encoder_->SetOption (ENCODER_OPTION_MEMORY_USAGE, &sEncUsage));
+  EXPECT_EQ (cmInitParaError, decoder_->SetOption (DECODER_OPTION_MEMORY_USAGE, &sDecUsage));
+  int32_t iTraceLevel = WELS_LOG_QUIET;
+  encoder_->SetOption (ENCODER_OPTION_TRACE_LEVEL, &iTraceLevel);
+  decoder_->SetOption (DECODER_OPTION_TRACE_LEVEL, &iTraceLevel);
+  ASSERT_TRUE (InitialEncDec (320, 192));
+
+  for (int iIdx = 0; iIdx < 3; iIdx++) {
+    EncodeOneFrame (0);
+    int iLen = 0;
+    encToDecData (info, iLen);
+    unsigned char* pData[3] = { NULL };
+    memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+    ASSERT_EQ (0, decoder_->DecodeFrameNoDelay (info.sLayerInfo[0].pBsBuf, iLen, pData, &dstBufInfo_));
+  }
+
+  ASSERT_EQ (cmResultSuccess, encoder_->GetOption (ENCODER_OPTION_MEMORY_USAGE, &sEncUsage));
+  CheckMemoryUsage (sEncUsage);
+  EXPECT_GT (sEncUsage.iCategoryCurrentBytes[MEMORY_CATEGORY_VAA], 0);
+  ASSERT_EQ (cmResultSuccess, decoder_->GetOption (DECODER_OPTION_MEMORY_USAGE, &sDecUsage));
+  CheckMemoryUsage (sDecUsage);
+  // a picture large enough for the frames needs at least the luma plane
+  EXPECT_GT (sDecUsage.iCategoryCurrentBytes[MEMORY_CATEGORY_PICTURES], 320 * 192);
+}
+
+TEST_F (EncodeDecodeTestAPI, PyramidMeMatchesSingleThread) {
+  const char* pFileName = "res/CiscoVT2people_320x192_12fps.yuv";
+  SEncParamExt sParam;
+  encoder_->GetDefaultParams (&sParam);
+  prepareParamDefault (2, 1, 320, 192, 12.0f, &sParam);
+  sParam.iUsageType = CAMERA_VIDEO_REAL_TIME;
+  sParam.iRCMode = RC_BITRATE_MODE;
+  sParam.iTargetBitrate = 300000;
+  for (int i = 0; i < 2; i++) {
+    sParam.sSpatialLayers[i].iSpatialBitrate = (i + 1) * 100000;
+    sParam.sSpatialLayers[i].iMaxSpatialBitrate = UNSPECIFIED_BIT_RATE;
+    sParam.sSpatialLayers[i].sSliceArgument.uiSliceMode = SM_SINGLE_SLICE;
+  }
+  sParam.bUseWavefrontMd = true;
+
+  std::vector<unsigned char> vDefaultBs, vSingleThreadBs, vWavefrontBs;
+  EncodeFileWithThreads (sParam, 1, pFileName, &vDefaultBs);
+  sParam.bEnablePyramidMe = true;
+  EncodeFileWithThreads (sParam, 1, pFileName, &vSingleThreadBs);
+  EncodeFileWithThreads (sParam, 4, pFileName, &vWavefrontBs);
+  EXPECT_FALSE (vSingleThreadBs.empty());
+  EXPECT_TRUE (vSingleThreadBs == vWavefrontBs);
+  // the seeds change the chosen vectors
+  EXPECT_FALSE (vDefaultBs == vSingleThreadBs);
+
+  unsigned char* pData[3] = { NULL };
+  memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+  EXPECT_EQ (dsErrorFree, decoder_->DecodeFrame2 (&vSingleThreadBs[0], (int)vSingleThreadBs.size(), pData,
+             &dstBufInfo_));
+}
+
+TEST_F (EncodeDecodeTestAPI, LookaheadMatchesFramePipeline) {
+  const char* pFileName = "res/CiscoVT2people_320x192_12fps.yuv";
+  SEncParamExt sParam;
+  encoder_->GetDefaultParams (&sParam);
+  prepareParamDefault (1, 1, 320, 192, 12.0f, &sParam);
+  sParam.iUsageType = CAMERA_VIDEO_REAL_TIME;
+  sParam.iRCMode = RC_BITRATE_MODE;
+  sParam.iTargetBitrate = sParam.sSpatialLayers[0].iSpatialBitrate = 300000;
+  sParam.sSpatialLayers[0].iMaxSpatialBitrate = UNSPECIFIED_BIT_RATE;
+  sParam.sSpatialLayers[0].sSliceArgument.uiSliceMode = SM_SINGLE_SLICE;
+
+  std::vector<unsigned char> vDefaultBs, vLookaheadBs, vPipelineBs;
+  EncodeFileWithThreads (sParam, 1, pFileName, &vDefaultBs);
+  sParam.iLookaheadFrames = 4;
+  EncodeFileWithThreads (sParam, 1, pFileName, &vLookaheadBs);
+  sParam.bEnableFramePipeline = true;
+  EncodeFileWithThreads (sParam, 2, pFileName, &vPipelineBs);
+  EXPECT_FALSE (vLookaheadBs.empty());
+  EXPECT_TRUE (vLookaheadBs == vPipelineBs);
+  // the costs ahead move bits between the frames
+  EXPECT_FALSE (vDefaultBs == vLookaheadBs);
+
+  unsigned char* pData[3] = { NULL };
+  memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+  EXPECT_EQ (dsErrorFree, decoder_->DecodeFrame2 (&vLookaheadBs[0], (int)vLookaheadBs.size(), pData, &dstBufInfo_));
+}
+
+TEST_F (EncodeDecodeTestAPI, LookaheadResolutionChangeKeepsFrames) {
+  SEncParamExt sParam;
+  encoder_->GetDefaultParams (&sParam);
+  prepareParamDefault (1, 1, 320, 192, 12.0f, &sParam);
+  sParam.iUsageType = CAMERA_VIDEO_REAL_TIME;
+  sParam.iRCMode = RC_BITRATE_MODE;
+  sParam.iTargetBitrate = sParam.sSpatialLayers[0].iSpatialBitrate = 300000;
+  sParam.sSpatialLayers[0].iMaxSpatialBitrate = UNSPECIFIED_BIT_RATE;
+  sParam.bEnableFrameSkip = false;
+  sParam.iLookaheadFrames = 4;
+
+  // the queue filled in the calling thread, on the lookahead thread
+  for (int iPipeline = 0; iPipeline < 2; iPipeline++) {
+    sParam.bEnableFramePipeline = (iPipeline != 0);
+    int iOutputFrameNum = 0;
+    EncodeResolutionChangeMidStream (sParam, iPipeline + 1, &iOutputFrameNum);
+    EXPECT_EQ (12, iOutputFrameNum) << "bEnableFramePipeline = " << iPipeline;
+  }
+}
+
+TEST_F (EncodeDecodeTestAPI, TwoPassRateControlUsesStatsFile) {
+  const char* pFileName = "res/CiscoVT2people_320x192_12fps.yuv";
+  const char* pStatsFileName = "rc_stats_test.bin";
+  SEncParamExt sParam;
+  encoder_->GetDefaultParams (&sParam);
+  prepareParamDefault (1, 1, 320, 192, 12.0f, &sParam);
+  sParam.iUsageType = CAMERA_VIDEO_REAL_TIME;
+  sParam.iRCMode = RC_BITRATE_MODE;
+  sParam.iTargetBitrate = sParam.sSpatialLayers[0].iSpatialBitrate = 300000;
+  sParam.sSpatialLayers[0].iMaxSpatialBitrate = UNSPECIFIED_BIT_RATE;
+  sParam.sSpatialLayers[0].sSliceArgument.uiSliceMode = SM_SINGLE_SLICE;
+  sParam.bEnableFrameSkip = false;
+
+  std::vector<unsigned char> vSinglePassBs, vFirstPassBs, vSecondPassBs;
+  EncodeFileWithThreads (sParam, 1, pFileName, &vSinglePassBs);
+  sParam.pRcStatsFileName = const_cast<char*> (pStatsFileName);
+  sParam.eRcPass = RC_FIRST_PASS;
+  EncodeFileWithThreads (sParam, 1, pFileName, &vFirstPassBs);
+  // a header of 5 ints, then per frame 20 bytes and 2 bytes per MB
+  FILE* pStatsFile = fopen (pStatsFileName, "rb");
+  ASSERT_TRUE (pStatsFile != NULL);
+  fseek (pStatsFile, 0, SEEK_END);
+  EXPECT_EQ (5 * 4 + 9 * (20 + 2 * 20 * 12), ftell (pStatsFile));
+  fclose (pStatsFile);
+  // the first pass does not try the partitions below 16x16
+  EXPECT_FALSE (vSinglePassBs == vFirstPassBs);
+
+  sParam.eRcPass = RC_SECOND_PASS;
+  EncodeFileWithThreads (sParam, 1, pFileName, &vSecondPassBs);
+  EXPECT_FALSE (vSecondPassBs.empty());
+  EXPECT_FALSE (vSinglePassBs == vSecondPassBs);
+  unsigned char* pData[3] = { NULL };
+  memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+  EXPECT_EQ (dsErrorFree, decoder_->DecodeFrame2 (&vSecondPassBs[0], (int)vSecondPassBs.size(), pData, &dstBufInfo_));
+
+  // a file of another encoding falls back to a single pass
+  pStatsFile = fopen (pStatsFileName, "wb");
+  ASSERT_TRUE (pStatsFile != NULL);
+  fputs ("not a statistics file", pStatsFile);
+  fclose (pStatsFile);
+  vSecondPassBs.clear();
+  EncodeFileWithThreads (sParam, 1, pFileName, &vSecondPassBs);
+  EXPECT_TRUE (vSinglePassBs == vSecondPassBs);
+  remove (pStatsFileName);
+  vSecondPassBs.clear();
+  EncodeFileWithThreads (sParam, 1, pFileName, &vSecondPassBs);
+  EXPECT_TRUE (vSinglePassBs == vSecondPassBs);
+}
+
+TEST_F (EncodeDecodeTestAPI, TwoPassMatchesRecordsByInputPicture) {
+  const char* pFileName = "res/CiscoVT2people_320x192_12fps.yuv";
+  const char* pStatsFileName = "rc_stats_index_test.bin";
+  SEncParamExt sParam;
+  encoder_->GetDefaultParams (&sParam);
+  prepareParamDefault (1, 1, 320, 192, 12.0f, &sParam);
+  sParam.iUsageType = CAMERA_VIDEO_REAL_TIME;
+  sParam.iRCMode = RC_BITRATE_MODE;
+  sParam.iTargetBitrate = sParam.sSpatialLayers[0].iSpatialBitrate = 300000;
+  sParam.sSpatialLayers[0].iMaxSpatialBitrate = UNSPECIFIED_BIT_RATE;
+  sParam.sSpatialLayers[0].sSliceArgument.uiSliceMode = SM_SINGLE_SLICE;
+  sParam.bEnableFrameSkip = false;
+
+  // constant timestamps, as a raw file encoding gives them
+  std::vector<unsigned char> vSinglePassBs, vFirstPassBs, vSecondPassBs;
+  EncodeFileWithThreads (sParam, 1, pFileName, &vSinglePassBs, NULL, 0, 0);
+  sParam.pRcStatsFileName = const_cast<char*> (pStatsFileName);
+  sParam.eRcPass = RC_FIRST_PASS;
+  EncodeFileWithThreads (sParam, 1, pFileName, &vFirstPassBs, NULL, 0, 0);
+  sParam.eRcPass = RC_SECOND_PASS;
+  EncodeFileWithThreads (sParam, 1, pFileName, &vSecondPassBs, NULL, 0, 0);
+  EXPECT_FALSE (vSecondPassBs.empty());
+  EXPECT_FALSE (vSinglePassBs == vSecondPassBs);
+  unsigned char* pData[3] = { NULL };
+  memset (&dstBufInfo_, 0, sizeof (SBufferInfo));
+  EXPECT_EQ (dsErrorFree, decoder_->DecodeFrame2 (&vSecondPassBs[0], (int)vSecondPassBs.size(), pData, &dstBufInfo_));
+
+  // records written for other timestamps belong to another input, the second pass falls back to a single one
+  vSinglePassBs.clear();
+  vSecondPassBs.clear();
+  sParam.eRcPass = RC_SINGLE_PASS;
+  EncodeFileWithThreads (sParam, 1, pFileName, &vSinglePassBs, NULL, 1000, 83);
+  sParam.eRcPass = RC_SECOND_PASS;
+  EncodeFileWithThreads (sParam, 1, pFileName, &vSecondPassBs, NULL, 1000, 83);
+  EXPECT_FALSE (vSinglePassBs.empty());
+  EXPECT_TRUE (vSinglePassBs == vSecondPassBs);
+  remove (pStatsFileName);
+}
+
+TEST_F (EncodeDecodeTestAPI, TwoPassParamsSurviveGetSetOption) {
+  const char* pStatsFileName = "rc_stats_option_test.bin";
+  SEncParamExt sParam;
+  encoder_->GetDefaultParams (&sParam);
+  prepareParamDefault (1, 1, 320, 192, 12.0f, &sParam);
+  sParam.iUsageType = CAMERA_VIDEO_REAL_TIME;
+  sParam.iRCMode = RC_BITRATE_MODE;
+  sParam.iTargetBitrate = sParam.sSpatialLayers[0].iSpatialBitrate = 300000;
+  sParam.sSpatialLayers[0].iMaxSpatialBitrate = UNSPECIFIED_BIT_RATE;
+  sParam.bEnableFrameSkip = false;
+  sParam.eRcPass = RC_FIRST_PASS;
+  sParam.pRcStatsFileName = const_cast<char*> (pStatsFileName);
+  int iTraceLevel = WELS_LOG_QUIET;
+  encoder_->SetOption (ENCODER_OPTION_TRACE_LEVEL, &iTraceLevel);
+  ASSERT_EQ (cmResultSuccess, encoder_->InitializeExt (&sParam));
+
+  FileInputStream fileStream;
+  ASSERT_TRUE (fileStream.Open ("res/CiscoVT2people_320x192_12fps.yuv"));
+  const int iFrameSize = sParam.iPicWidth * sParam.iPicHeight * 3 / 2;
+  BufferedData buf;
+  ASSERT_EQ (0, buf.SetLength (iFrameSize));
+  SSourcePicture sPic;
+  memset (&sPic, 0, sizeof (SSourcePicture));
+  sPic.iPicWidth    = sParam.iPicWidth;
+  sPic.iPicHeight   = sParam.iPicHeight;
+  sPic.iColorFormat = videoFormatI420;
+  sPic.iStride[0]   = sPic.iPicWidth;
+  sPic.iStride[1]   = sPic.iStride[2] = sPic.iPicWidth >> 1;
+  sPic.pData[0]     = buf.data();
+  sPic.pData[1]     = sPic.pData[0] + sPic.iPicWidth * sPic.iPicHeight;
+  sPic.pData[2]     = sPic.pData[1] + (sPic.iPicWidth * sPic.iPicHeight >> 2);
+
+  SFrameBSInfo sInfo;
+  SEncParamExt sGotParam;
+  int iFrameNum = 0;
+  for (; fileStream.read (buf.data(), iFrameSize) == iFrameSize; iFrameNum++) {
+    if (iFrameNum == 4) {
+      // a get/set round trip keeps the pass, a changed setting resets the encoder in the middle of the pass
+      memset (&sGotParam, 0, sizeof (SEncParamExt));
+      ASSERT_EQ (cmResultSuccess, encoder_->GetOption (ENCODER_OPTION_SVC_ENCODE_PARAM_EXT, &sGotParam));
+      EXPECT_EQ (RC_FIRST_PASS, sGotParam.eRcPass);
+      ASSERT_TRUE (sGotParam.pRcStatsFileName != NULL);
+      EXPECT_STREQ (pStatsFileName, sGotParam.pRcStatsFileName);
+      sGotParam.bEnableAdaptiveQuant = !sGotParam.bEnableAdaptiveQuant;
+      EXPECT_EQ (cmResultSuccess, encoder_->SetOption (ENCODER_OPTION_SVC_ENCODE_PARAM_EXT, &sGotParam));
+      memset (&sGotParam, 0, sizeof (SEncParamExt));
+      ASSERT_EQ (cmResultSuccess, encoder_->GetOption (ENCODER_OPTION_SVC_ENCODE_PARAM_EXT, &sGotParam));
+      EXPECT_EQ (RC_FIRST_PASS, sGotParam.eRcPass);
+    }
+    sPic.uiTimeStamp = iFrameNum * 83;
+    memset (&sInfo, 0, sizeof (SFrameBSInfo));
+    ASSERT_EQ (cmResultSuccess, encoder_->EncodeFrame (&sPic, &sInfo));
+  }
+  encoder_->Uninitialize();
+
+  // the records written before the reset are kept
+  FILE* pStatsFile = fopen (pStatsFileName, "rb");
+  ASSERT_TRUE (pStatsFile != NULL);
+  fseek (pStatsFile, 0, SEEK_END);
+  EXPECT_EQ (5 * 4 + iFrameNum * (20 + 2 * 20 * 12), ftell (pStatsFile));
+  fclose (pStatsFile);
+  remove (pStatsFileName);
+}
+
+TEST_F (EncodeDecodeTestAPI, LookaheadPlacesIdrAtSceneCut) {
+  const int kiLookahead = 4;
+  const int kiCutFrame = 24;
+  const int kiFrameNum = 32;
+  SEncParamExt sParam;
+  encoder_->GetDefaultParams (&sParam);
+  prepareParamDefault (1, 1, 320, 192, 12.0f, &sParam);
+  sParam.iUsageType = CAMERA_VIDEO_REAL_TIME;
+  sParam.iRCMode = RC_BITRATE_MODE;
+  sParam.iTargetBitrate = sParam.sSpatialLayers[0].iSpatialBitrate = 300000;
+  sParam.sSpatialLayers[0].iMaxSpatialBitrate = UNSPECIFIED_BIT_RATE;
+  sParam.bEnableFrameSkip = false;
+  sParam.bEnableSceneChangeDetect = true;
+  sParam.iLookaheadFrames = kiLookahead;
+  int iTraceLevel = WELS_LOG_QUIET;
+  encoder_->SetOption (ENCODER_OPTION_TRACE_LEVEL, &iTraceLevel);
+  ASSERT_EQ (cmResultSuccess, encoder_->InitializeExt (&sParam));
+
+  // the 9 frames of the file are played back and forth
+  const int kiFileFrameNum = 9;
+  FileInputStream fileStream;
+  ASSERT_TRUE (fileStream.Open ("res/CiscoVT2people_320x192_12fps.yuv"));
+  const int iFrameSize = sParam.iPicWidth * sParam.iPicHeight * 3 / 2;
+  std::vector<unsigned char> vFileFrames (iFrameSize * kiFileFrameNum);
+  ASSERT_EQ (iFrameSize * kiFileFrameNum, fileStream.read (&vFileFrames[0], vFileFrames.size()));
+  BufferedData buf;
+  ASSERT_EQ (0, buf.SetLength (iFrameSize));
+  SSourcePicture sPic;
+  memset (&sPic, 0, sizeof (SSourcePicture));
+  sPic.iPicWidth    = sParam.iPicWidth;
+  sPic.iPicHeight   = sParam.iPicHeight;
+  sPic.iColorFormat = videoFormatI420;
+  sPic.iStride[0]   = sPic.iPicWidth;
+  sPic.iStride[1]   = sPic.iStride[2] = sPic.iPicWidth >> 1;
+  sPic.pData[0]     = buf.data();
+  sPic.pData[1]     = sPic.pData[0] + sPic.iPicWidth * sPic.iPicHeight;
+  sPic.pData[2]     = sPic.pData[1] + (sPic.iPicWidth * sPic.iPicHeight >> 2);
+
+  std::vector<EVideoFrameType> vFrameTypes;
+  SFrameBSInfo sInfo;
+  for (int iFrame = 0; iFrame < kiFrameNum + kiLookahead; iFrame++) {
+    memset (&sInfo, 0, sizeof (SFrameBSInfo));
+    if (iFrame < kiFrameNum) {
+      const int iPhase = iFrame % ((kiFileFrameNum - 1) * 2);
+      const int iFileFrame = (iPhase < kiFileFrameNum) ? iPhase : (kiFileFrameNum - 1) * 2 - iPhase;
+      memcpy (buf.data(), &vFileFrames[iFileFrame * iFrameSize], iFrameSize);
+      // a different scene from kiCutFrame on
+      if (iFrame >= kiCutFrame) {
+        for (int i = 0; i < sPic.iPicWidth * sPic.iPicHeight; i++)
+          sPic.pData[0][i] = 255 - sPic.pData[0][i];
+      }
+      sPic.uiTimeStamp = iFrame * 83;
+      ASSERT_EQ (cmResultSuccess, encoder_->EncodeFrame (&sPic, &sInfo));
+    } else {
+      ASSERT_EQ (cmResultSuccess, encoder_->EncodeFrame (NULL, &sInfo));
+    }
+    // the first pictures are only queued
+    if (iFrame < kiLookahead) {
+      EXPECT_EQ (0, sInfo.iLayerNum);
+      continue;
+    }
+    vFrameTypes.push_back (sInfo.eFrameType);
+  }
+  ASSERT_EQ (kiFrameNum, (int)vFrameTypes.size());
+  for (int i = 0; i < kiFrameNum; i++)
+    EXPECT_EQ ((i == 0 || i == kiCutFrame) ? videoFrameTypeIDR : videoFrameTypeP, vFrameTypes[i]) << "frame " << i;
+}
@@ -151,3 +151,79 @@ static const FileParam kFileParamArray[] = {
 
 INSTANTIATE_TEST_CASE_P (ThreadDecodeFile, ThreadDecoderOutputTest,
                          ::testing::ValuesIn (kFileParamArray));
+
+class ThreadDecoderLowLatencyOutputTest : public ThreadDecoderOutputTest {
+};
+
+TEST_P (ThreadDecoderLowLatencyOutputTest, CompareWithBufferedOutput) {
+  FileParam p = GetParam();
+#if defined(ANDROID_NDK)
+  std::string filename = std::string ("/sdcard/") + p.fileName;
+#else
+  std::string filename = p.fileName;
+#endif
+  ASSERT_TRUE (ThreadDecodeFile (filename.c_str(), this));
+  unsigned char bufferedDigest[SHA_DIGEST_LENGTH];
+  SHA1Result (&ctx_, bufferedDigest);
+
+  BaseThreadDecoderTest::TearDown();
+  ASSERT_EQ (0, BaseThreadDecoderTest::SetUp());
+  int iLowLatency = 1;
+  ASSERT_EQ (0, decoder_->SetOption (DECODER_OPTION_LOW_LATENCY_THREADS, &iLowLatency));
+  SHA1Reset (&ctx_);
+  ASSERT_TRUE (ThreadDecodeFile (filename.c_str(), this));
+  unsigned char digest[SHA_DIGEST_LENGTH];
+  SHA1Result (&ctx_, digest);
+
+  // every picture left the decoder on the call that fed it
+  EXPECT_EQ (0, iFramesRemainingAtEos);
+  EXPECT_EQ (0, memcmp (bufferedDigest, digest, SHA_DIGEST_LENGTH));
+}
+static const FileParam kLowLatencyFileParamArray[] = {
+  {"res/BA_MW_D.264", ""},
+  {"res/BAMQ1_JVC_C.264", ""},
+  {"res/MIDR_MW_D.264", ""},
+  {"res/MPS_MW_A.264", ""},
+  {"res/NRF_MW_E.264", ""},
+  {"res/SVA_BA2_D.264", ""},
+};
+
+INSTANTIATE_TEST_CASE_P (ThreadDecodeFile, ThreadDecoderLowLatencyOutputTest,
+                         ::testing::ValuesIn (kLowLatencyFileParamArray));
+
+class ThreadDecoderDeblockingThreadOutputTest : public ThreadDecoderOutputTest {
+};
+
+TEST_P (ThreadDecoderDeblockingThreadOutputTest, CompareWithSerialDeblocking) {
+  FileParam p = GetParam();
+#if defined(ANDROID_NDK)
+  std::string filename = std::string ("/sdcard/") + p.fileName;
+#else
+  std::string filename = p.fileName;
+#endif
+  ASSERT_TRUE (ThreadDecodeFile (filename.c_str(), this));
+  unsigned char serialDigest[SHA_DIGEST_LENGTH];
+  SHA1Result (&ctx_, serialDigest);
+
+  BaseThreadDecoderTest::TearDown();
+  ASSERT_EQ (0, BaseThreadDecoderTest::SetUp());
+  int iDeblockingThread = 1;
+  ASSERT_EQ (0, decoder_->SetOption (DECODER_OPTION_DEBLOCKING_THREAD, &iDeblockingThread));
+  SHA1Reset (&ctx_);
+  ASSERT_TRUE (ThreadDecodeFile (filename.c_str(), this));
+  unsigned char digest[SHA_DIGEST_LENGTH];
+  SHA1Result (&ctx_, digest);
+
+  EXPECT_EQ (0, memcmp (serialDigest, digest, SHA_DIGEST_LENGTH));
+}
+static const FileParam kDeblockingThreadFileParamArray[] = {
+  {"res/BA_MW_D.264", ""},
+  {"res/MIDR_MW_D.264", ""},
+  {"res/SVA_BA2_D.264", ""},
+  {"res/BA1_Sony_D.jsv", ""},
+  {"res/Cisco_Men_whisper_640x320_CABAC_Bframe_9.264", ""},
+  {"res/VID_1280x720_cavlc_temporal_direct.264", ""},
+};
+
+INSTANTIATE_TEST_CASE_P (ThreadDecodeFile, ThreadDecoderDeblockingThreadOutputTest,
+                         ::testing::ValuesIn (kDeblockingThreadFileParamArray));
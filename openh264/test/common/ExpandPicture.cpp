@@ -272,3 +272,62 @@ TEST (ExpandPicture, ExpandPicForMotion) {
   }
 }
 
+TEST (ExpandPicture, ExpandPictureRows) {
+  SExpandPicFunc sExpandPicFuncAnchor;
+  SExpandPicFunc sExpandPicFunc;
+  int32_t iCpuCores = 1;
+  uint32_t uiCpuFlag = 0;
+  uint8_t* pPicAnchor[3] = {NULL, NULL, NULL};
+  uint8_t* pPicTest[3] = {NULL, NULL, NULL};
+  int32_t iStride[3];
+  InitExpandPictureFunc (&sExpandPicFuncAnchor, 0);
+  for (int32_t k = 0; k < 2; k++) {
+    if (k == 0) {
+      uiCpuFlag = 0;
+    } else {
+      uiCpuFlag = WelsCPUFeatureDetect (&iCpuCores);
+    }
+    InitExpandPictureFunc (&sExpandPicFunc, uiCpuFlag);
+    for (int32_t iTestIdx = 0; iTestIdx < EXPAND_PIC_TEST_NUM; iTestIdx++) {
+      int32_t iPicWidth           = 16 + (rand() % 200) * 2;
+      const int32_t iPicHeight    = 16 + (rand() % 100) * 2;
+      if (0 != uiCpuFlag) {
+        // the optimized functions take MB aligned pictures as ExpandReferencingPicture() does
+        iPicWidth = WELS_ALIGN (iPicWidth, 32);
+      }
+      const int32_t iMbHeight     = (iPicHeight + 15) >> 4;
+      iStride[0]                  = WELS_ALIGN (iPicWidth, MB_WIDTH_LUMA) + (PADDING_LENGTH << 1);
+      const int32_t iPicHeightExt = WELS_ALIGN (iPicHeight, MB_HEIGHT_LUMA) + (PADDING_LENGTH << 1);
+      iStride[1]                  = iStride[2] = iStride[0] >> 1;
+      const int32_t iLumaSize     = iStride[0] * iPicHeightExt;
+      const int32_t iChromaSize   = iStride[1] * (iPicHeightExt >> 1);
+      const int32_t iSize         = iLumaSize + (iChromaSize << 1);
+
+      uint8_t* pPicAnchorBuffer = static_cast<uint8_t*> (WelsMallocz (iSize, "pPicAnchor"));
+      uint8_t* pPicTestBuffer   = static_cast<uint8_t*> (WelsMallocz (iSize, "pPicTest"));
+      ASSERT_TRUE (pPicAnchorBuffer != NULL && pPicTestBuffer != NULL);
+      for (int32_t n = 0; n < iSize; n++) {
+        pPicAnchorBuffer[n] = pPicTestBuffer[n] = rand() % 256;
+      }
+      pPicAnchor[0] = pPicAnchorBuffer + (1 + iStride[0]) * PADDING_LENGTH;
+      pPicAnchor[1] = pPicAnchorBuffer + iLumaSize + (((1 + iStride[1]) * PADDING_LENGTH) >> 1);
+      pPicAnchor[2] = pPicAnchorBuffer + iLumaSize + iChromaSize + (((1 + iStride[2]) * PADDING_LENGTH) >> 1);
+      pPicTest[0]   = pPicTestBuffer + (1 + iStride[0]) * PADDING_LENGTH;
+      pPicTest[1]   = pPicTestBuffer + iLumaSize + (((1 + iStride[1]) * PADDING_LENGTH) >> 1);
+      pPicTest[2]   = pPicTestBuffer + iLumaSize + iChromaSize + (((1 + iStride[2]) * PADDING_LENGTH) >> 1);
+
+      ExpandReferencingPicture (pPicAnchor, iPicWidth, iPicHeight, iStride,
+                                sExpandPicFuncAnchor.pfExpandLumaPicture, sExpandPicFuncAnchor.pfExpandChromaPicture);
+      // MB rows in bottom-up order, as a wavefront may finish them in any order
+      for (int32_t iMbY = iMbHeight - 1; iMbY >= 0; iMbY--) {
+        ExpandReferencingPictureRows (pPicTest, iPicWidth, iPicHeight, iStride, iMbY << 4,
+                                      WELS_MIN ((iMbY + 1) << 4, iPicHeight), sExpandPicFunc.pfExpandLumaRows,
+                                      sExpandPicFunc.pfExpandChromaRows);
+      }
+      EXPECT_TRUE (CompareImage (pPicAnchorBuffer, pPicTestBuffer, iSize)) << iPicWidth << "x" << iPicHeight;
+
+      WELS_SAFE_FREE (pPicAnchorBuffer, "pPicAnchor");
+      WELS_SAFE_FREE (pPicTestBuffer, "pPicTest");
+    }
+  }
+}
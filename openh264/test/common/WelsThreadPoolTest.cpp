@@ -5,6 +5,7 @@
 #include <map>
 
 #include "typedefs.h"
+#include "measure_time.h"
 #include "WelsThreadLib.h"
 #include "WelsThreadPool.h"
 #include "WelsTask.h"
@@ -104,3 +105,217 @@ TEST (CThreadPoolTest, CThreadPoolTestMulti) {
   EXPECT_FALSE (CWelsThreadPool::IsReferenced());
 }
 
+static void RunTasksOnPool (CWelsThreadPool* pThreadPool) {
+  CThreadPoolTest cThreadPoolTest;
+  CSimpleTask* aTasks[TEST_TASK_NUM];
+  int32_t  i;
+  for (i = 0; i < TEST_TASK_NUM; i++) {
+    aTasks[i] = new CSimpleTask (&cThreadPoolTest);
+    pThreadPool->QueueTask (aTasks[i]);
+  }
+  while (cThreadPoolTest.GetTaskCount() < TEST_TASK_NUM) {
+    WelsSleep (1);
+  }
+  for (i = 0; i < TEST_TASK_NUM; i++) {
+    delete aTasks[i];
+  }
+}
+
+TEST (CThreadPoolTest, CThreadPoolTestInstances) {
+  // the first processor is the one every platform has
+  const int32_t kiAffinityCpus[2] = {0, 0};
+
+  CWelsThreadPool* pOwnPool = CWelsThreadPool::CreateInstance (2, kiAffinityCpus, 2);
+  ASSERT_TRUE (pOwnPool != NULL);
+  EXPECT_EQ (2, pOwnPool->GetThreadNum());
+  EXPECT_FALSE (CWelsThreadPool::IsReferenced());
+
+  CWelsThreadPool* pOtherPool = CWelsThreadPool::CreateInstance (3, NULL, 0);
+  ASSERT_TRUE (pOtherPool != NULL);
+  EXPECT_TRUE (pOwnPool != pOtherPool);
+
+  CWelsThreadPool* pNamedPool = CWelsThreadPool::AddNamedReference ("node0", 5, kiAffinityCpus, 1);
+  ASSERT_TRUE (pNamedPool != NULL);
+  CWelsThreadPool* pSameNamedPool = CWelsThreadPool::AddNamedReference ("node0", 2, NULL, 0);
+  EXPECT_EQ (pNamedPool, pSameNamedPool);
+  EXPECT_EQ (5, pSameNamedPool->GetThreadNum());
+  CWelsThreadPool* pOtherNamedPool = CWelsThreadPool::AddNamedReference ("node1", 2, NULL, 0);
+  ASSERT_TRUE (pOtherNamedPool != NULL);
+  EXPECT_TRUE (pNamedPool != pOtherNamedPool);
+
+  RunTasksOnPool (pOwnPool);
+  RunTasksOnPool (pOtherPool);
+  RunTasksOnPool (pSameNamedPool);
+  RunTasksOnPool (pOtherNamedPool);
+
+  pOwnPool->RemoveInstance();
+  pOtherPool->RemoveInstance();
+  pOtherNamedPool->RemoveInstance();
+  pSameNamedPool->RemoveInstance();
+  // still held by its first user
+  RunTasksOnPool (pNamedPool);
+  pNamedPool->RemoveInstance();
+
+  // a released name starts a new pool
+  pNamedPool = CWelsThreadPool::AddNamedReference ("node0", 2, NULL, 0);
+  ASSERT_TRUE (pNamedPool != NULL);
+  EXPECT_EQ (2, pNamedPool->GetThreadNum());
+  pNamedPool->RemoveInstance();
+  EXPECT_FALSE (CWelsThreadPool::IsReferenced());
+}
+
+#if defined(__linux__)
+static WELS_THREAD_ROUTINE_TYPE SetAffinityFunc (void* pResults) {
+  WELS_THREAD_ERROR_CODE* pErr = (WELS_THREAD_ERROR_CODE*)pResults;
+  pErr[0] = WelsThreadSetAffinity (0);
+  // far beyond a 64 bit mask, accepted by the set but matching no processor here
+  pErr[1] = WelsThreadSetAffinity (4095);
+  pErr[2] = WelsThreadSetAffinity (-1);
+  return 0;
+}
+
+TEST (CThreadPoolTest, CThreadPoolTestAffinityCpuIndex) {
+  WELS_THREAD_ERROR_CODE iErr[3] = {-1, 0, 0};
+  WELS_THREAD_HANDLE hThread;
+  // on a thread of its own, the pinning must not stick to the test runner
+  ASSERT_EQ (0, WelsThreadCreate (&hThread, SetAffinityFunc, iErr, 0));
+  WelsThreadJoin (hThread);
+  EXPECT_EQ (WELS_THREAD_ERROR_OK, iErr[0]);
+  EXPECT_NE (WELS_THREAD_ERROR_OK, iErr[1]);
+  EXPECT_NE (WELS_THREAD_ERROR_OK, iErr[2]);
+
+  // a processor index past 64 leaves the worker floating where the platform lacks it
+  const int32_t kiAffinityCpus[2] = {0, 100};
+  CWelsThreadPool* pPool = CWelsThreadPool::CreateInstance (2, kiAffinityCpus, 2);
+  ASSERT_TRUE (pPool != NULL);
+  RunTasksOnPool (pPool);
+  pPool->RemoveInstance();
+}
+#endif
+
+#define  BENCH_ROUND_NUM        200
+#define  BENCH_TASKS_PER_ROUND  4
+
+// stands for one encoder instance: queues a batch of slice tasks per frame and waits for all of them
+class CDispatchBenchEncoder : public IWelsTaskSink {
+ public:
+  CDispatchBenchEncoder (CWelsThreadPool* pThreadPool)
+    : m_pThreadPool (pThreadPool), m_iWaitTaskNum (0), m_iLatencySumUs (0), m_iExecutedNum (0) {
+    WelsEventOpen (&m_hTaskEvent);
+    WelsMutexInit (&m_hEventMutex);
+  }
+  virtual ~CDispatchBenchEncoder() {
+    WelsMutexDestroy (&m_hEventMutex);
+    WelsEventClose (&m_hTaskEvent);
+  }
+
+  virtual int OnTaskExecuted() {
+    WelsCommon::CWelsAutoLock cAutoLock (m_cWaitTaskNumLock);
+    WelsEventSignal (&m_hTaskEvent, &m_hEventMutex, &m_iWaitTaskNum);
+    return cmResultSuccess;
+  }
+  virtual int OnTaskCancelled() {
+    return OnTaskExecuted();
+  }
+
+  void AddLatency (const int64_t kiLatencyUs) {
+    WelsCommon::CWelsAutoLock cAutoLock (m_cLatencyLock);
+    m_iLatencySumUs += kiLatencyUs;
+    m_iExecutedNum ++;
+  }
+  int64_t GetLatencySumUs() const {
+    return m_iLatencySumUs;
+  }
+  int32_t GetExecutedNum() const {
+    return m_iExecutedNum;
+  }
+
+  void Run();
+
+ private:
+  CWelsThreadPool*  m_pThreadPool;
+  WELS_EVENT        m_hTaskEvent;
+  WELS_MUTEX        m_hEventMutex;
+  int32_t           m_iWaitTaskNum;
+  int64_t           m_iLatencySumUs;
+  int32_t           m_iExecutedNum;
+  WelsCommon::CWelsLock  m_cWaitTaskNumLock;
+  WelsCommon::CWelsLock  m_cLatencyLock;
+};
+
+// measures the time from QueueTask() to the start of Execute()
+class CDispatchBenchTask : public IWelsTask {
+ public:
+  CDispatchBenchTask (CDispatchBenchEncoder* pEncoder) : IWelsTask (pEncoder), m_pEncoder (pEncoder), m_iQueuedUs (0) {
+  }
+  void MarkQueued() {
+    m_iQueuedUs = WelsTime();
+  }
+  virtual int Execute() {
+    m_pEncoder->AddLatency (WelsTime() - m_iQueuedUs);
+    return cmResultSuccess;
+  }
+
+ private:
+  CDispatchBenchEncoder*  m_pEncoder;
+  int64_t                 m_iQueuedUs;
+};
+
+void CDispatchBenchEncoder::Run() {
+  CDispatchBenchTask* aTasks[BENCH_TASKS_PER_ROUND];
+  for (int32_t i = 0; i < BENCH_TASKS_PER_ROUND; i++) {
+    aTasks[i] = new CDispatchBenchTask (this);
+  }
+  for (int32_t iRound = 0; iRound < BENCH_ROUND_NUM; iRound++) {
+    m_iWaitTaskNum = BENCH_TASKS_PER_ROUND;
+    for (int32_t i = 0; i < BENCH_TASKS_PER_ROUND; i++) {
+      aTasks[i]->MarkQueued();
+      m_pThreadPool->QueueTask (aTasks[i]);
+    }
+    WelsEventWait (&m_hTaskEvent, &m_hEventMutex, m_iWaitTaskNum);
+  }
+  for (int32_t i = 0; i < BENCH_TASKS_PER_ROUND; i++) {
+    delete aTasks[i];
+  }
+}
+
+WELS_THREAD_ROUTINE_TYPE DispatchBenchFunc (void* pEncoder) {
+  static_cast<CDispatchBenchEncoder*> (pEncoder)->Run();
+  WELS_THREAD_ROUTINE_RETURN (0);
+}
+
+TEST (CThreadPoolTest, DispatchLatencyBenchmark) {
+  const int32_t kiEncoderNums[] = {1, 8, 32};
+  CWelsThreadPool* pThreadPool = (CWelsThreadPool::AddReference());
+  ASSERT_TRUE (pThreadPool != NULL);
+
+  for (size_t n = 0; n < sizeof (kiEncoderNums) / sizeof (kiEncoderNums[0]); n++) {
+    const int32_t kiEncoderNum = kiEncoderNums[n];
+    CDispatchBenchEncoder* pEncoders[32];
+    WELS_THREAD_HANDLE aThreads[32];
+    for (int32_t i = 0; i < kiEncoderNum; i++) {
+      pEncoders[i] = new CDispatchBenchEncoder (pThreadPool);
+    }
+    const int64_t kiStartUs = WelsTime();
+    for (int32_t i = 0; i < kiEncoderNum; i++) {
+      ASSERT_EQ (WELS_THREAD_ERROR_OK, WelsThreadCreate (&aThreads[i], DispatchBenchFunc, pEncoders[i], 0));
+    }
+    for (int32_t i = 0; i < kiEncoderNum; i++) {
+      WelsThreadJoin (aThreads[i]);
+    }
+    const int64_t kiElapsedUs = WelsTime() - kiStartUs;
+
+    int64_t iLatencySumUs = 0;
+    int32_t iExecutedNum = 0;
+    for (int32_t i = 0; i < kiEncoderNum; i++) {
+      iLatencySumUs += pEncoders[i]->GetLatencySumUs();
+      iExecutedNum += pEncoders[i]->GetExecutedNum();
+      delete pEncoders[i];
+    }
+    EXPECT_EQ (kiEncoderNum * BENCH_ROUND_NUM * BENCH_TASKS_PER_ROUND, iExecutedNum);
+    printf ("%2d encoders on %d pool threads: %d tasks in %lld us, average dispatch latency %.2f us\n", kiEncoderNum,
+            pThreadPool->GetThreadNum(), iExecutedNum, (long long)kiElapsedUs,
+            iExecutedNum ? (double)iLatencySumUs / iExecutedNum : 0.0);
+  }
+  pThreadPool->RemoveInstance();
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "cpu_core.h"
+#include "cpu.h"
+#include "output_convert.h"
+
+using namespace WelsDec;
+
+static void FillWithRandomData (uint8_t* p, int32_t iLen) {
+  for (int32_t i = 0; i < iLen; i++) {
+    p[i] = rand() % 256;
+  }
+}
+
+static uint8_t ClipRef (int32_t iValue) {
+  return iValue < 0 ? 0 : (iValue > 255 ? 255 : iValue);
+}
+
+TEST (OutputConvertTest, I420ToPackedRgb) {
+  const int32_t kiWidth = 34, kiHeight = 4, kiStrideY = kiWidth + 6, kiStrideUV = (kiWidth >> 1) + 3;
+  std::vector<uint8_t> vSrcY (kiStrideY * kiHeight), vSrcU (kiStrideUV * kiHeight / 2), vSrcV (vSrcU.size());
+  std::vector<uint8_t> vBgr (kiWidth * 3 * kiHeight), vRgba (kiWidth * 4 * kiHeight);
+  FillWithRandomData (&vSrcY[0], (int32_t)vSrcY.size());
+  FillWithRandomData (&vSrcU[0], (int32_t)vSrcU.size());
+  FillWithRandomData (&vSrcV[0], (int32_t)vSrcV.size());
+
+  WelsI420ToBgr_c (&vBgr[0], kiWidth * 3, &vSrcY[0], &vSrcU[0], &vSrcV[0], kiStrideY, kiStrideUV, kiWidth, kiHeight);
+  WelsI420ToRgba_c (&vRgba[0], kiWidth * 4, &vSrcY[0], &vSrcU[0], &vSrcV[0], kiStrideY, kiStrideUV, kiWidth, kiHeight);
+  for (int32_t y = 0; y < kiHeight; y++) {
+    for (int32_t x = 0; x < kiWidth; x++) {
+      const int32_t c = 298 * (vSrcY[y * kiStrideY + x] - 16) + 128;
+      const int32_t d = vSrcU[ (y >> 1) * kiStrideUV + (x >> 1)] - 128;
+      const int32_t e = vSrcV[ (y >> 1) * kiStrideUV + (x >> 1)] - 128;
+      const uint8_t* pBgr = &vBgr[ (y * kiWidth + x) * 3];
+      const uint8_t* pRgba = &vRgba[ (y * kiWidth + x) * 4];
+      ASSERT_EQ (ClipRef ((c + 409 * e) >> 8), pBgr[2]);
+      ASSERT_EQ (ClipRef ((c - 100 * d - 208 * e) >> 8), pBgr[1]);
+      ASSERT_EQ (ClipRef ((c + 516 * d) >> 8), pBgr[0]);
+      ASSERT_EQ (pBgr[2], pRgba[0]);
+      ASSERT_EQ (pBgr[1], pRgba[1]);
+      ASSERT_EQ (pBgr[0], pRgba[2]);
+      ASSERT_EQ (255, pRgba[3]);
+    }
+  }
+}
+
+#if defined(X86_ASM)
+// the SIMD converters must match the C ones at any even width, including the columns left to the C code
+static void TestPackedRgbSimd (PI420ToPackedRgbFunc pfRef, PI420ToPackedRgbFunc pfSimd, int32_t iBpp,
+                               uint32_t uiCpuFlag) {
+  int32_t iCpuCores = 0;
+  if (0 == (WelsCPUFeatureDetect (&iCpuCores) & uiCpuFlag))
+    return;
+  const int32_t kiWidths[] = { 2, 8, 16, 18, 30, 32, 34, 64, 66, 98 };
+  for (size_t w = 0; w < sizeof (kiWidths) / sizeof (kiWidths[0]); w++) {
+    const int32_t kiWidth = kiWidths[w], kiHeight = 6;
+    const int32_t kiStrideY = kiWidth + (int32_t)w, kiStrideUV = (kiWidth >> 1) + 5, kiDstStride = kiWidth * iBpp + 3;
+    // the last row of each plane ends its buffer, so that accesses past the pixels are caught by the sanitizers
+    std::vector<uint8_t> vSrcY (kiStrideY * (kiHeight - 1) + kiWidth);
+    std::vector<uint8_t> vSrcU (kiStrideUV * ((kiHeight >> 1) - 1) + (kiWidth >> 1)), vSrcV (vSrcU.size());
+    std::vector<uint8_t> vRef (kiDstStride * (kiHeight - 1) + kiWidth * iBpp, 0);
+    std::vector<uint8_t> vDst (vRef);
+    for (int32_t k = 0; k < 4; k++) {
+      FillWithRandomData (&vSrcY[0], (int32_t)vSrcY.size());
+      FillWithRandomData (&vSrcU[0], (int32_t)vSrcU.size());
+      FillWithRandomData (&vSrcV[0], (int32_t)vSrcV.size());
+      if (k == 0) {
+        for (size_t i = 0; i < vSrcU.size(); i++) {
+          vSrcU[i] = (vSrcU[i] & 1) ? 255 : 0;
+          vSrcV[i] = (vSrcV[i] & 1) ? 255 : 0;
+        }
+      }
+      pfRef (&vRef[0], kiDstStride, &vSrcY[0], &vSrcU[0], &vSrcV[0], kiStrideY, kiStrideUV, kiWidth, kiHeight);
+      pfSimd (&vDst[0], kiDstStride, &vSrcY[0], &vSrcU[0], &vSrcV[0], kiStrideY, kiStrideUV, kiWidth, kiHeight);
+      for (size_t i = 0; i < vRef.size(); i++) {
+        ASSERT_EQ (vRef[i], vDst[i]) << "width " << kiWidth << " at " << i;
+      }
+    }
+  }
+}
+
+static void TestNv12Simd (PI420ToNv12Func pfSimd, uint32_t uiCpuFlag) {
+  int32_t iCpuCores = 0;
+  if (0 == (WelsCPUFeatureDetect (&iCpuCores) & uiCpuFlag))
+    return;
+  const int32_t kiWidths[] = { 2, 16, 30, 32, 34, 64, 66, 98, 130 };
+  for (size_t w = 0; w < sizeof (kiWidths) / sizeof (kiWidths[0]); w++) {
+    const int32_t kiWidth = kiWidths[w], kiHeight = 6;
+    const int32_t kiStrideY = kiWidth + (int32_t)w, kiStrideUV = (kiWidth >> 1) + 5, kiDstStride = kiWidth + 3;
+    std::vector<uint8_t> vSrcY (kiStrideY * kiHeight);
+    std::vector<uint8_t> vSrcU (kiStrideUV * ((kiHeight >> 1) - 1) + (kiWidth >> 1)), vSrcV (vSrcU.size());
+    std::vector<uint8_t> vRef (kiDstStride * kiHeight + kiDstStride * ((kiHeight >> 1) - 1) + kiWidth, 0);
+    std::vector<uint8_t> vDst (vRef);
+    FillWithRandomData (&vSrcY[0], (int32_t)vSrcY.size());
+    FillWithRandomData (&vSrcU[0], (int32_t)vSrcU.size());
+    FillWithRandomData (&vSrcV[0], (int32_t)vSrcV.size());
+    WelsI420ToNv12_c (&vRef[0], &vRef[kiDstStride * kiHeight], kiDstStride, kiDstStride, &vSrcY[0], &vSrcU[0],
+                      &vSrcV[0], kiStrideY, kiStrideUV, kiWidth, kiHeight);
+    pfSimd (&vDst[0], &vDst[kiDstStride * kiHeight], kiDstStride, kiDstStride, &vSrcY[0], &vSrcU[0], &vSrcV[0],
+            kiStrideY, kiStrideUV, kiWidth, kiHeight);
+    for (size_t i = 0; i < vRef.size(); i++) {
+      ASSERT_EQ (vRef[i], vDst[i]) << "width " << kiWidth << " at " << i;
+    }
+  }
+}
+
+TEST (OutputConvertTest, I420ToBgr_sse2) {
+  TestPackedRgbSimd (WelsI420ToBgr_c, WelsI420ToBgr_sse2, 3, WELS_CPU_SSE2);
+}
+
+TEST (OutputConvertTest, I420ToRgba_sse2) {
+  TestPackedRgbSimd (WelsI420ToRgba_c, WelsI420ToRgba_sse2, 4, WELS_CPU_SSE2);
+}
+
+TEST (OutputConvertTest, I420ToNv12_sse2) {
+  TestNv12Simd (WelsI420ToNv12_sse2, WELS_CPU_SSE2);
+}
+
+#if defined(HAVE_AVX2)
+TEST (OutputConvertTest, I420ToBgr_avx2) {
+  TestPackedRgbSimd (WelsI420ToBgr_c, WelsI420ToBgr_avx2, 3, WELS_CPU_AVX2);
+}
+
+TEST (OutputConvertTest, I420ToRgba_avx2) {
+  TestPackedRgbSimd (WelsI420ToRgba_c, WelsI420ToRgba_avx2, 4, WELS_CPU_AVX2);
+}
+
+TEST (OutputConvertTest, I420ToNv12_avx2) {
+  TestNv12Simd (WelsI420ToNv12_avx2, WELS_CPU_AVX2);
+}
+#endif//HAVE_AVX2
+#endif//X86_ASM
@@ -1,9 +1,13 @@
 #include <gtest/gtest.h>
+#include <vector>
 #include "codec_app_def.h"
 #include "codec_api.h"
 #include "decoder_context.h"
 #include "decoder.h"
 #include "decoder_core.h"
+#include "au_parser.h"
+#include "cpu_core.h"
+#include "cpu.h"
 #include "welsCodecTrace.h"
 #include "../../common/src/welsCodecTrace.cpp"
 
@@ -442,4 +446,83 @@ TEST_F (DecoderParseSyntaxTest, DecoderParseSyntaxTestAll) {
   TestSpecificBsError();
 }
 
+static int32_t FindNalSyntaxBytesRef (const uint8_t* kpBuf, const int32_t kiBufSize) {
+  for (int32_t i = 0; i + 2 < kiBufSize; i++) {
+    if (kpBuf[i] == 0 && kpBuf[i + 1] == 0 && kpBuf[i + 2] <= 0x03)
+      return i;
+  }
+  return kiBufSize;
+}
+
+static uint8_t* DetectStartCodePrefixRef (const uint8_t* kpBuf, int32_t* pOffset, int32_t iBufSize) {
+  for (int32_t i = 0; i + 2 < iBufSize; i++) {
+    if (kpBuf[i] == 0 && kpBuf[i + 1] == 0 && kpBuf[i + 2] == 0x01) {
+      *pOffset = i + 3;
+      return (uint8_t*)kpBuf + i + 3;
+    }
+  }
+  return NULL;
+}
 
+TEST (DecoderNalScanTest, FindNalSyntaxBytes) {
+  PFindNalSyntaxBytesFunc pfFindNalSyntaxBytes = NULL;
+  WelsInitNalScanFunc (&pfFindNalSyntaxBytes, WelsCPUFeatureDetect (NULL));
+  ASSERT_TRUE (pfFindNalSyntaxBytes != NULL);
+  uint8_t uiBuf[96];
+  for (int32_t iTimes = 0; iTimes < 20000; iTimes++) {
+    const int32_t kiSize = rand() % (int32_t)sizeof (uiBuf);
+    const int32_t kiZeroPercent = rand() % 100;
+    for (int32_t i = 0; i < kiSize; i++)
+      uiBuf[i] = rand() % 100 < kiZeroPercent ? 0 : (uint8_t) (rand() % 2 ? 1 + rand() % 4 : rand() % 256);
+    const int32_t kiStart = kiSize > 0 ? rand() % kiSize : 0;
+    ASSERT_EQ (FindNalSyntaxBytesRef (uiBuf + kiStart, kiSize - kiStart),
+               pfFindNalSyntaxBytes (uiBuf + kiStart, kiSize - kiStart));
+    int32_t iOffset = -1, iOffsetRef = -1;
+    uint8_t* pRbsp = DetectStartCodePrefix (uiBuf, &iOffset, kiSize, pfFindNalSyntaxBytes);
+    ASSERT_EQ (DetectStartCodePrefixRef (uiBuf, &iOffsetRef, kiSize), pRbsp);
+    ASSERT_EQ (iOffsetRef, iOffset);
+  }
+}
+
+#if defined(X86_ASM) || defined(HAVE_NEON) || defined(HAVE_NEON_AARCH64)
+// the SIMD scans must match the C one at any size and alignment, including the tail left to the C code
+static void TestFindNalSyntaxBytesSimd (PFindNalSyntaxBytesFunc pfSimd, uint32_t uiCpuFlag) {
+  if (0 == (WelsCPUFeatureDetect (NULL) & uiCpuFlag))
+    return;
+  for (int32_t iTimes = 0; iTimes < 20000; iTimes++) {
+    const int32_t kiSize = rand() % 200;
+    const int32_t kiZeroPercent = rand() % 100;
+    // the buffer ends with the scanned bytes, so that reading past them is caught by the sanitizers
+    std::vector<uint8_t> vBuf (kiSize > 0 ? kiSize : 1);
+    for (int32_t i = 0; i < kiSize; i++)
+      vBuf[i] = rand() % 100 < kiZeroPercent ? 0 : (uint8_t) (rand() % 2 ? 1 + rand() % 4 : rand() % 256);
+    const int32_t kiStart = kiSize > 0 ? rand() % kiSize : 0;
+    ASSERT_EQ (WelsFindNalSyntaxBytes_c (&vBuf[kiStart], kiSize - kiStart), pfSimd (&vBuf[kiStart], kiSize - kiStart))
+        << "size " << kiSize - kiStart;
+  }
+}
+#endif
+
+#if defined(X86_ASM)
+TEST (DecoderNalScanTest, FindNalSyntaxBytes_sse2) {
+  TestFindNalSyntaxBytesSimd (WelsFindNalSyntaxBytes_sse2, WELS_CPU_SSE2);
+}
+
+#if defined(HAVE_AVX2)
+TEST (DecoderNalScanTest, FindNalSyntaxBytes_avx2) {
+  TestFindNalSyntaxBytesSimd (WelsFindNalSyntaxBytes_avx2, WELS_CPU_AVX2);
+}
+#endif//HAVE_AVX2
+#endif//X86_ASM
+
+#if defined(HAVE_NEON)
+TEST (DecoderNalScanTest, FindNalSyntaxBytes_neon) {
+  TestFindNalSyntaxBytesSimd (WelsFindNalSyntaxBytes_neon, WELS_CPU_NEON);
+}
+#endif//HAVE_NEON
+
+#if defined(HAVE_NEON_AARCH64)
+TEST (DecoderNalScanTest, FindNalSyntaxBytes_AArch64_neon) {
+  TestFindNalSyntaxBytesSimd (WelsFindNalSyntaxBytes_AArch64_neon, WELS_CPU_NEON);
+}
+#endif//HAVE_NEON_AARCH64
@@ -0,0 +1,313 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "codec_def.h"
+#include "codec_api.h"
+#include "cpu_core.h"
+#include "cpu.h"
+#include "colorspace_convert.h"
+
+using namespace WelsEnc;
+
+#define CSC_TEST_WIDTH  64
+#define CSC_TEST_HEIGHT 32
+
+static void FillWithRandomData (uint8_t* p, int32_t iLen) {
+  for (int32_t i = 0; i < iLen; i++) {
+    p[i] = rand() % 256;
+  }
+}
+
+static void PackedToI420Ref (uint8_t* pDstY, uint8_t* pDstU, uint8_t* pDstV, int32_t iStrideY, int32_t iStrideUV,
+                             const uint8_t* kpSrc, int32_t iSrcStride, int32_t iBpp, int32_t iRIdx, int32_t iBIdx,
+                             int32_t iWidth, int32_t iHeight) {
+  for (int32_t y = 0; y < iHeight; y++) {
+    for (int32_t x = 0; x < iWidth; x++) {
+      const uint8_t* p = kpSrc + y * iSrcStride + x * iBpp;
+      pDstY[y * iStrideY + x] = ((66 * p[iRIdx] + 129 * p[1] + 25 * p[iBIdx] + 128) >> 8) + 16;
+    }
+  }
+  for (int32_t y = 0; y < iHeight / 2; y++) {
+    for (int32_t x = 0; x < iWidth / 2; x++) {
+      int32_t iSum[3] = {0, 0, 0};
+      for (int32_t k = 0; k < 4; k++) {
+        const uint8_t* p = kpSrc + (2 * y + (k >> 1)) * iSrcStride + (2 * x + (k & 1)) * iBpp;
+        iSum[0] += p[iRIdx];
+        iSum[1] += p[1];
+        iSum[2] += p[iBIdx];
+      }
+      const int32_t r = (iSum[0] + 2) >> 2, g = (iSum[1] + 2) >> 2, b = (iSum[2] + 2) >> 2;
+      pDstU[y * iStrideUV + x] = (-38 * r - 74 * g + 112 * b + 32896) >> 8;
+      pDstV[y * iStrideUV + x] = (112 * r - 94 * g - 18 * b + 32896) >> 8;
+    }
+  }
+}
+
+static void TestPackedConvert (PPackedRgbToI420Func pfConvert, int32_t iBpp, int32_t iRIdx, int32_t iBIdx) {
+  const int32_t kiSrcStride = CSC_TEST_WIDTH * iBpp + 8;
+  std::vector<uint8_t> vSrc (kiSrcStride * CSC_TEST_HEIGHT);
+  std::vector<uint8_t> vRef (CSC_TEST_WIDTH * CSC_TEST_HEIGHT * 3 / 2);
+  std::vector<uint8_t> vDst (CSC_TEST_WIDTH * CSC_TEST_HEIGHT * 3 / 2);
+  uint8_t* pRefY = &vRef[0], *pRefU = pRefY + CSC_TEST_WIDTH * CSC_TEST_HEIGHT,
+           *pRefV = pRefU + CSC_TEST_WIDTH * CSC_TEST_HEIGHT / 4;
+  uint8_t* pDstY = &vDst[0], *pDstU = pDstY + CSC_TEST_WIDTH * CSC_TEST_HEIGHT,
+           *pDstV = pDstU + CSC_TEST_WIDTH * CSC_TEST_HEIGHT / 4;
+
+  for (int32_t k = 0; k < 10; k++) {
+    FillWithRandomData (&vSrc[0], (int32_t)vSrc.size());
+    PackedToI420Ref (pRefY, pRefU, pRefV, CSC_TEST_WIDTH, CSC_TEST_WIDTH / 2, &vSrc[0], kiSrcStride, iBpp, iRIdx, iBIdx,
+                     CSC_TEST_WIDTH, CSC_TEST_HEIGHT);
+    pfConvert (pDstY, pDstU, pDstV, CSC_TEST_WIDTH, CSC_TEST_WIDTH / 2, &vSrc[0], kiSrcStride, CSC_TEST_WIDTH,
+               CSC_TEST_HEIGHT);
+    for (size_t i = 0; i < vRef.size(); i++) {
+      ASSERT_EQ (vRef[i], vDst[i]) << "at " << i;
+    }
+  }
+}
+
+TEST (ColorspaceConvertTest, BgrToI420) {
+  TestPackedConvert (WelsBgrToI420_c, 3, 2, 0);
+}
+
+TEST (ColorspaceConvertTest, BgraToI420) {
+  TestPackedConvert (WelsBgraToI420_c, 4, 2, 0);
+}
+
+TEST (ColorspaceConvertTest, RgbaToI420) {
+  TestPackedConvert (WelsRgbaToI420_c, 4, 0, 2);
+}
+
+TEST (ColorspaceConvertTest, Nv12ToI420) {
+  const int32_t kiSrcStride = CSC_TEST_WIDTH + 16;
+  std::vector<uint8_t> vSrcY (kiSrcStride * CSC_TEST_HEIGHT);
+  std::vector<uint8_t> vSrcUV (kiSrcStride * CSC_TEST_HEIGHT / 2);
+  std::vector<uint8_t> vDst (CSC_TEST_WIDTH * CSC_TEST_HEIGHT * 3 / 2);
+  uint8_t* pDstY = &vDst[0], *pDstU = pDstY + CSC_TEST_WIDTH * CSC_TEST_HEIGHT,
+           *pDstV = pDstU + CSC_TEST_WIDTH * CSC_TEST_HEIGHT / 4;
+  FillWithRandomData (&vSrcY[0], (int32_t)vSrcY.size());
+  FillWithRandomData (&vSrcUV[0], (int32_t)vSrcUV.size());
+
+  WelsNv12ToI420_c (pDstY, pDstU, pDstV, CSC_TEST_WIDTH, CSC_TEST_WIDTH / 2, &vSrcY[0], &vSrcUV[0], kiSrcStride,
+                    kiSrcStride, CSC_TEST_WIDTH, CSC_TEST_HEIGHT);
+  for (int32_t y = 0; y < CSC_TEST_HEIGHT; y++) {
+    for (int32_t x = 0; x < CSC_TEST_WIDTH; x++) {
+      ASSERT_EQ (vSrcY[y * kiSrcStride + x], pDstY[y * CSC_TEST_WIDTH + x]);
+    }
+  }
+  for (int32_t y = 0; y < CSC_TEST_HEIGHT / 2; y++) {
+    for (int32_t x = 0; x < CSC_TEST_WIDTH / 2; x++) {
+      ASSERT_EQ (vSrcUV[y * kiSrcStride + 2 * x], pDstU[y * CSC_TEST_WIDTH / 2 + x]);
+      ASSERT_EQ (vSrcUV[y * kiSrcStride + 2 * x + 1], pDstV[y * CSC_TEST_WIDTH / 2 + x]);
+    }
+  }
+}
+
+#if defined(X86_ASM)
+// the SIMD converters must match the C ones at any width, including the columns left to the C code
+static void TestPackedConvertSimd (PPackedRgbToI420Func pfRef, PPackedRgbToI420Func pfSimd, int32_t iBpp,
+                                   uint32_t uiCpuFlag) {
+  int32_t iCpuCores = 0;
+  if (0 == (WelsCPUFeatureDetect (&iCpuCores) & uiCpuFlag))
+    return;
+  const int32_t kiWidths[] = { 2, 8, 16, 18, 30, 34, 64, 66, 98 };
+  for (size_t w = 0; w < sizeof (kiWidths) / sizeof (kiWidths[0]); w++) {
+    const int32_t kiWidth = kiWidths[w], kiHeight = 6;
+    const int32_t kiSrcStride = kiWidth * iBpp + (int32_t)w, kiStrideY = kiWidth + 3, kiStrideUV = (kiWidth >> 1) + 5;
+    // the last row ends the buffer, so that reading past the pixels of a row is caught by the sanitizers
+    std::vector<uint8_t> vSrc (kiSrcStride * (kiHeight - 1) + kiWidth * iBpp);
+    std::vector<uint8_t> vRef (kiStrideY * kiHeight + kiStrideUV * kiHeight, 0);
+    std::vector<uint8_t> vDst (vRef);
+    for (int32_t k = 0; k < 4; k++) {
+      FillWithRandomData (&vSrc[0], (int32_t)vSrc.size());
+      if (k == 0) {
+        for (size_t i = 0; i < vSrc.size(); i++)
+          vSrc[i] = (vSrc[i] & 1) ? 255 : 0;
+      }
+      pfRef (&vRef[0], &vRef[kiStrideY * kiHeight], &vRef[kiStrideY * kiHeight + kiStrideUV * (kiHeight >> 1)],
+             kiStrideY, kiStrideUV, &vSrc[0], kiSrcStride, kiWidth, kiHeight);
+      pfSimd (&vDst[0], &vDst[kiStrideY * kiHeight], &vDst[kiStrideY * kiHeight + kiStrideUV * (kiHeight >> 1)],
+              kiStrideY, kiStrideUV, &vSrc[0], kiSrcStride, kiWidth, kiHeight);
+      for (size_t i = 0; i < vRef.size(); i++) {
+        ASSERT_EQ (vRef[i], vDst[i]) << "width " << kiWidth << " at " << i;
+      }
+    }
+  }
+}
+
+static void TestNv12ConvertSimd (PNv12ToI420Func pfSimd, uint32_t uiCpuFlag) {
+  int32_t iCpuCores = 0;
+  if (0 == (WelsCPUFeatureDetect (&iCpuCores) & uiCpuFlag))
+    return;
+  const int32_t kiWidths[] = { 2, 16, 30, 32, 34, 64, 66, 98, 130 };
+  for (size_t w = 0; w < sizeof (kiWidths) / sizeof (kiWidths[0]); w++) {
+    const int32_t kiWidth = kiWidths[w], kiHeight = 6;
+    const int32_t kiSrcStride = kiWidth + (int32_t)w, kiStrideY = kiWidth + 3, kiStrideUV = (kiWidth >> 1) + 5;
+    std::vector<uint8_t> vSrcY (kiSrcStride * kiHeight);
+    std::vector<uint8_t> vSrcUV (kiSrcStride * ((kiHeight >> 1) - 1) + kiWidth);
+    std::vector<uint8_t> vRef (kiStrideY * kiHeight + kiStrideUV * kiHeight, 0);
+    std::vector<uint8_t> vDst (vRef);
+    FillWithRandomData (&vSrcY[0], (int32_t)vSrcY.size());
+    FillWithRandomData (&vSrcUV[0], (int32_t)vSrcUV.size());
+    WelsNv12ToI420_c (&vRef[0], &vRef[kiStrideY * kiHeight], &vRef[kiStrideY * kiHeight + kiStrideUV * (kiHeight >> 1)],
+                      kiStrideY, kiStrideUV, &vSrcY[0], &vSrcUV[0], kiSrcStride, kiSrcStride, kiWidth, kiHeight);
+    pfSimd (&vDst[0], &vDst[kiStrideY * kiHeight], &vDst[kiStrideY * kiHeight + kiStrideUV * (kiHeight >> 1)],
+            kiStrideY, kiStrideUV, &vSrcY[0], &vSrcUV[0], kiSrcStride, kiSrcStride, kiWidth, kiHeight);
+    for (size_t i = 0; i < vRef.size(); i++) {
+      ASSERT_EQ (vRef[i], vDst[i]) << "width " << kiWidth << " at " << i;
+    }
+  }
+}
+
+TEST (ColorspaceConvertTest, Nv12ToI420_sse2) {
+  TestNv12ConvertSimd (WelsNv12ToI420_sse2, WELS_CPU_SSE2);
+}
+
+#if !defined(X86_32_ASM)
+TEST (ColorspaceConvertTest, BgrToI420_sse2) {
+  TestPackedConvertSimd (WelsBgrToI420_c, WelsBgrToI420_sse2, 3, WELS_CPU_SSE2);
+}
+
+TEST (ColorspaceConvertTest, BgraToI420_sse2) {
+  TestPackedConvertSimd (WelsBgraToI420_c, WelsBgraToI420_sse2, 4, WELS_CPU_SSE2);
+}
+
+TEST (ColorspaceConvertTest, RgbaToI420_sse2) {
+  TestPackedConvertSimd (WelsRgbaToI420_c, WelsRgbaToI420_sse2, 4, WELS_CPU_SSE2);
+}
+#endif//!X86_32_ASM
+
+#if defined(HAVE_AVX2)
+TEST (ColorspaceConvertTest, Nv12ToI420_avx2) {
+  TestNv12ConvertSimd (WelsNv12ToI420_avx2, WELS_CPU_AVX2);
+}
+
+#if !defined(X86_32_ASM)
+TEST (ColorspaceConvertTest, BgrToI420_avx2) {
+  TestPackedConvertSimd (WelsBgrToI420_c, WelsBgrToI420_avx2, 3, WELS_CPU_AVX2);
+}
+
+TEST (ColorspaceConvertTest, BgraToI420_avx2) {
+  TestPackedConvertSimd (WelsBgraToI420_c, WelsBgraToI420_avx2, 4, WELS_CPU_AVX2);
+}
+
+TEST (ColorspaceConvertTest, RgbaToI420_avx2) {
+  TestPackedConvertSimd (WelsRgbaToI420_c, WelsRgbaToI420_avx2, 4, WELS_CPU_AVX2);
+}
+#endif//!X86_32_ASM
+#endif//HAVE_AVX2
+#endif//X86_ASM
+
+static void EncodeToBuffer (ISVCEncoder* pEncoder, SSourcePicture* pPic, std::vector<uint8_t>& vBs) {
+  SFrameBSInfo sInfo;
+  memset (&sInfo, 0, sizeof (SFrameBSInfo));
+  ASSERT_EQ (static_cast<int> (cmResultSuccess), pEncoder->EncodeFrame (pPic, &sInfo));
+  for (int32_t i = 0; i < sInfo.iLayerNum; i++) {
+    const SLayerBSInfo& kLayer = sInfo.sLayerInfo[i];
+    int32_t iLayerSize = 0;
+    for (int32_t j = 0; j < kLayer.iNalCount; j++)
+      iLayerSize += kLayer.pNalLengthInByte[j];
+    vBs.insert (vBs.end(), kLayer.pBsBuf, kLayer.pBsBuf + iLayerSize);
+  }
+}
+
+static ISVCEncoder* CreateTestEncoder (int32_t iWidth, int32_t iHeight) {
+  ISVCEncoder* pEncoder = NULL;
+  if (WelsCreateSVCEncoder (&pEncoder) != 0 || pEncoder == NULL)
+    return NULL;
+  SEncParamBase sParam;
+  memset (&sParam, 0, sizeof (SEncParamBase));
+  sParam.iUsageType = CAMERA_VIDEO_REAL_TIME;
+  sParam.fMaxFrameRate = 30;
+  sParam.iPicWidth = iWidth;
+  sParam.iPicHeight = iHeight;
+  sParam.iTargetBitrate = 1000000;
+  sParam.iRCMode = RC_OFF_MODE;
+  int iTraceLevel = WELS_LOG_QUIET;
+  pEncoder->SetOption (ENCODER_OPTION_TRACE_LEVEL, &iTraceLevel);
+  if (pEncoder->Initialize (&sParam) != cmResultSuccess) {
+    WelsDestroySVCEncoder (pEncoder);
+    return NULL;
+  }
+  return pEncoder;
+}
+
+// Encoding packed BGR directly must match encoding the same picture converted to I420 beforehand.
+TEST (ColorspaceConvertTest, EncodePackedInputMatchesI420) {
+  const int32_t kiWidth = 160, kiHeight = 96;
+  const int32_t kiFormats[] = { videoFormatBGR, videoFormatBGRA, videoFormatRGBA, videoFormatNV12 };
+
+  for (size_t f = 0; f < sizeof (kiFormats) / sizeof (kiFormats[0]); f++) {
+    ISVCEncoder* pPackedEncoder = CreateTestEncoder (kiWidth, kiHeight);
+    ISVCEncoder* pPlanarEncoder = CreateTestEncoder (kiWidth, kiHeight);
+    ASSERT_TRUE (pPackedEncoder != NULL && pPlanarEncoder != NULL);
+
+    const int32_t kiBpp = (kiFormats[f] == videoFormatBGR) ? 3 : 4;
+    std::vector<uint8_t> vPacked (kiWidth * kiHeight * kiBpp);
+    std::vector<uint8_t> vPlanar (kiWidth * kiHeight * 3 / 2);
+    std::vector<uint8_t> vBsPacked, vBsPlanar;
+
+    SSourcePicture sPacked, sPlanar;
+    memset (&sPacked, 0, sizeof (SSourcePicture));
+    memset (&sPlanar, 0, sizeof (SSourcePicture));
+    sPacked.iPicWidth = sPlanar.iPicWidth = kiWidth;
+    sPacked.iPicHeight = sPlanar.iPicHeight = kiHeight;
+    sPacked.iColorFormat = kiFormats[f];
+    sPlanar.iColorFormat = videoFormatI420;
+    sPlanar.iStride[0] = kiWidth;
+    sPlanar.iStride[1] = sPlanar.iStride[2] = kiWidth >> 1;
+    sPlanar.pData[0] = &vPlanar[0];
+    sPlanar.pData[1] = sPlanar.pData[0] + kiWidth * kiHeight;
+    sPlanar.pData[2] = sPlanar.pData[1] + (kiWidth * kiHeight >> 2);
+
+    for (int32_t iFrame = 0; iFrame < 5; iFrame++) {
+      for (int32_t y = 0; y < kiHeight; y++) {
+        for (int32_t x = 0; x < kiWidth * kiBpp; x++)
+          vPacked[y * kiWidth * kiBpp + x] = (uint8_t) ((x * 3 + y * 5 + iFrame * 7) ^ (x >> 3));
+      }
+      if (kiFormats[f] == videoFormatNV12) {
+        sPacked.iStride[0] = sPacked.iStride[1] = kiWidth;
+        sPacked.pData[0] = &vPacked[0];
+        sPacked.pData[1] = sPacked.pData[0] + kiWidth * kiHeight;
+        WelsNv12ToI420_c (sPlanar.pData[0], sPlanar.pData[1], sPlanar.pData[2], kiWidth, kiWidth >> 1, sPacked.pData[0],
+                          sPacked.pData[1], kiWidth, kiWidth, kiWidth, kiHeight);
+      } else {
+        sPacked.iStride[0] = kiWidth * kiBpp;
+        sPacked.pData[0] = &vPacked[0];
+        PPackedRgbToI420Func pfConvert = (kiFormats[f] == videoFormatBGR) ? WelsBgrToI420_c :
+                                         (kiFormats[f] == videoFormatBGRA) ? WelsBgraToI420_c : WelsRgbaToI420_c;
+        pfConvert (sPlanar.pData[0], sPlanar.pData[1], sPlanar.pData[2], kiWidth, kiWidth >> 1, sPacked.pData[0],
+                   sPacked.iStride[0], kiWidth, kiHeight);
+      }
+      EncodeToBuffer (pPackedEncoder, &sPacked, vBsPacked);
+      EncodeToBuffer (pPlanarEncoder, &sPlanar, vBsPlanar);
+    }
+    EXPECT_FALSE (vBsPlanar.empty());
+    EXPECT_TRUE (vBsPacked == vBsPlanar) << "format " << kiFormats[f];
+
+    pPackedEncoder->Uninitialize();
+    pPlanarEncoder->Uninitialize();
+    WelsDestroySVCEncoder (pPackedEncoder);
+    WelsDestroySVCEncoder (pPlanarEncoder);
+  }
+}
+
+// a packed input that cannot be converted fails the EncodeFrame() call instead of encoding a stale picture
+TEST (ColorspaceConvertTest, EncodeUnreadablePackedInputFails) {
+  const int32_t kiWidth = 160, kiHeight = 96;
+  ISVCEncoder* pEncoder = CreateTestEncoder (kiWidth, kiHeight);
+  ASSERT_TRUE (pEncoder != NULL);
+
+  SSourcePicture sPic;
+  memset (&sPic, 0, sizeof (SSourcePicture));
+  sPic.iPicWidth = kiWidth;
+  sPic.iPicHeight = kiHeight;
+  sPic.iColorFormat = videoFormatBGR;
+  sPic.iStride[0] = kiWidth * 3;
+  SFrameBSInfo sInfo;
+  memset (&sInfo, 0, sizeof (SFrameBSInfo));
+  EXPECT_EQ (static_cast<int> (cmUnsupportedData), pEncoder->EncodeFrame (&sPic, &sInfo));
+
+  pEncoder->Uninitialize();
+  WelsDestroySVCEncoder (pEncoder);
+}
@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 #include "memory_align.h"
+#include "WelsBufferArena.h"
 
 using namespace WelsCommon;
 
@@ -28,7 +29,7 @@ TEST (MemoryAlignTest, GetCacheLineSize_MaxUINT) {
 //Tests of WelsMallocAndFree Begin
 TEST (MemoryAlignTest, WelsMallocAndFreeOnceFunctionVerify) {
   const uint32_t kuiTargetAlignSize[4] = {32, 16, 64, 8};
-  const uint32_t kuiZero = 0;
+  const int64_t kiZero = 0;
   for (int i = 0; i < 4; i++) {
     const uint32_t kuiTestAlignSize = kuiTargetAlignSize[i];
     const uint32_t kuiTestDataSize  = abs (rand());
@@ -39,18 +40,111 @@ TEST (MemoryAlignTest, WelsMallocAndFreeOnceFunctionVerify) {
     const uint32_t kuiUsedCacheLineSize = ((kuiTestAlignSize == 0)
                                            || (kuiTestAlignSize & 0x0F)) ? (16) : (kuiTestAlignSize);
     const uint32_t kuiExtraAlignSize    = kuiUsedCacheLineSize - 1;
-    const uint32_t kuiExpectedSize      = sizeof (void**) + sizeof (int32_t) + kuiExtraAlignSize + uiSize;
+    const int64_t kiExpectedSize        = sizeof (void**) + 2 * sizeof (int32_t) + kuiExtraAlignSize + (int64_t)uiSize;
     uint8_t* pUnitTestData = static_cast<uint8_t*> (cTestMa.WelsMalloc (uiSize, strUnitTestTag));
     if (pUnitTestData != NULL) {
       ASSERT_TRUE ((((uintptr_t) (pUnitTestData)) & kuiExtraAlignSize) == 0);
-      EXPECT_EQ (kuiExpectedSize, cTestMa.WelsGetMemoryUsage());
+      EXPECT_EQ (kiExpectedSize, cTestMa.WelsGetMemoryUsage());
       cTestMa.WelsFree (pUnitTestData, strUnitTestTag);
-      EXPECT_EQ (kuiZero, cTestMa.WelsGetMemoryUsage());
+      EXPECT_EQ (kiZero, cTestMa.WelsGetMemoryUsage());
     } else {
       EXPECT_EQ (NULL, pUnitTestData);
-      EXPECT_EQ (kuiZero, cTestMa.WelsGetMemoryUsage());
+      EXPECT_EQ (kiZero, cTestMa.WelsGetMemoryUsage());
       cTestMa.WelsFree (pUnitTestData, strUnitTestTag);
-      EXPECT_EQ (kuiZero, cTestMa.WelsGetMemoryUsage());
+      EXPECT_EQ (kiZero, cTestMa.WelsGetMemoryUsage());
     }
   }
 }
+//Tests of WelsMallocAndFree End
+//Tests of CWelsBufferArena Begin
+TEST (MemoryAlignTest, BufferArenaSizeClasses) {
+  uint32_t uiLastBlockSize = 0;
+  for (uint32_t uiSize = WELS_BUFFER_ARENA_MIN_SIZE; uiSize <= WELS_BUFFER_ARENA_MAX_SIZE; uiSize += (uiSize >> 3) + 7) {
+    const uint32_t kuiBlockSize = CWelsBufferArena::GetBlockSize (uiSize);
+    EXPECT_GE (kuiBlockSize, uiSize + WELS_BUFFER_ARENA_MAX_ALIGN - 1 + sizeof (void**) + sizeof (int32_t));
+    EXPECT_LE (kuiBlockSize - uiSize, (uiSize >> 2) + 128);
+    EXPECT_GE (kuiBlockSize, uiLastBlockSize);
+    uiLastBlockSize = kuiBlockSize;
+  }
+}
+
+TEST (MemoryAlignTest, BufferArenaReusesBlocksAcrossInstances) {
+  CWelsBufferArena& cArena = CWelsBufferArena::GetInstance();
+  const char strUnitTestTag[100] = "pUnitTestData";
+  const uint32_t kuiSize = 1000 * 1000;
+  const uint32_t kuiZero = 0;
+  // start from an empty arena, whatever earlier tests left there
+  cArena.SetLimit (0);
+  cArena.SetLimit (WELS_BUFFER_ARENA_DEFAULT_LIMIT);
+
+  CMemoryAlign* pFirstMa = new CMemoryAlign (16);
+  uint8_t* pFirst = static_cast<uint8_t*> (pFirstMa->WelsMalloc (kuiSize, strUnitTestTag));
+  ASSERT_TRUE (pFirst != NULL);
+  memset (pFirst, 0xff, kuiSize);
+  pFirstMa->WelsFree (pFirst, strUnitTestTag);
+  EXPECT_EQ (0, pFirstMa->WelsGetMemoryUsage());
+  delete pFirstMa;
+  EXPECT_EQ (CWelsBufferArena::GetBlockSize (kuiSize), cArena.GetCachedBytes());
+
+  // a slightly different size of the same class gets the block back, zeroed
+  CMemoryAlign cSecondMa (16);
+  uint8_t* pSecond = static_cast<uint8_t*> (cSecondMa.WelsMallocz (kuiSize + 1000, strUnitTestTag));
+  ASSERT_TRUE (pSecond == pFirst);
+  EXPECT_EQ (kuiZero, cArena.GetCachedBytes());
+  EXPECT_EQ (0, pSecond[0]);
+  EXPECT_EQ (0, pSecond[kuiSize + 999]);
+  EXPECT_EQ ((int64_t) (sizeof (void**) + 2 * sizeof (int32_t) + 15 + kuiSize + 1000),
+             cSecondMa.WelsGetMemoryUsage());
+  cSecondMa.WelsFree (pSecond, strUnitTestTag);
+
+  // no limit keeps nothing
+  cArena.SetLimit (0);
+  EXPECT_EQ (kuiZero, cArena.GetCachedBytes());
+  pSecond = static_cast<uint8_t*> (cSecondMa.WelsMalloc (kuiSize, strUnitTestTag));
+  ASSERT_TRUE (pSecond != NULL);
+  cSecondMa.WelsFree (pSecond, strUnitTestTag);
+  EXPECT_EQ (kuiZero, cArena.GetCachedBytes());
+  cArena.SetLimit (WELS_BUFFER_ARENA_DEFAULT_LIMIT);
+}
+//Tests of CWelsBufferArena End
+//Tests of WelsAddMemoryUsage Begin
+TEST (MemoryAlignTest, MemoryUsageByCategory) {
+  CMemoryAlign cTestMa (16);
+  const uint32_t kuiPicSize = 100 * 1000;
+  const uint32_t kuiMbSize  = 1000;
+  void* pPic = cTestMa.WelsMalloc (kuiPicSize, "pPic->pBuffer");
+  void* pMb  = cTestMa.WelsMallocz (kuiMbSize, "pMbCache->pDct");
+  void* pBs  = cTestMa.WelsMalloc (kuiMbSize, "pFrameBs");
+  ASSERT_TRUE (pPic != NULL && pMb != NULL && pBs != NULL);
+
+  SMemoryUsage sUsage;
+  memset (&sUsage, 0, sizeof (SMemoryUsage));
+  cTestMa.WelsAddMemoryUsage (&sUsage);
+  EXPECT_EQ (cTestMa.WelsGetMemoryUsage(), sUsage.iCurrentBytes);
+  EXPECT_EQ (sUsage.iCurrentBytes, sUsage.iPeakBytes);
+  EXPECT_LT (kuiPicSize, sUsage.iCategoryCurrentBytes[MEMORY_CATEGORY_PICTURES]);
+  EXPECT_LT (kuiMbSize, sUsage.iCategoryCurrentBytes[MEMORY_CATEGORY_MB_CACHES]);
+  EXPECT_LT (kuiMbSize, sUsage.iCategoryCurrentBytes[MEMORY_CATEGORY_BITSTREAM]);
+  EXPECT_EQ (0, sUsage.iCategoryCurrentBytes[MEMORY_CATEGORY_VAA]);
+  EXPECT_EQ (0, sUsage.iCategoryCurrentBytes[MEMORY_CATEGORY_OTHERS]);
+  const long long kiPeakBytes = sUsage.iPeakBytes;
+  const long long kiPicBytes  = sUsage.iCategoryCurrentBytes[MEMORY_CATEGORY_PICTURES];
+
+  // the peak stays after a free, the current bytes go back to zero
+  cTestMa.WelsFree (pPic, "pPic->pBuffer");
+  cTestMa.WelsFree (pMb, "pMbCache->pDct");
+  cTestMa.WelsFree (pBs, "pFrameBs");
+  void* pOther = cTestMa.WelsMalloc (kuiMbSize, NULL);
+  ASSERT_TRUE (pOther != NULL);
+  memset (&sUsage, 0, sizeof (SMemoryUsage));
+  cTestMa.WelsAddMemoryUsage (&sUsage);
+  EXPECT_EQ (kiPeakBytes, sUsage.iPeakBytes);
+  EXPECT_EQ (kiPicBytes, sUsage.iCategoryPeakBytes[MEMORY_CATEGORY_PICTURES]);
+  EXPECT_EQ (0, sUsage.iCategoryCurrentBytes[MEMORY_CATEGORY_PICTURES]);
+  EXPECT_EQ (sUsage.iCurrentBytes, sUsage.iCategoryCurrentBytes[MEMORY_CATEGORY_OTHERS]);
+  cTestMa.WelsFree (pOther, NULL);
+  memset (&sUsage, 0, sizeof (SMemoryUsage));
+  cTestMa.WelsAddMemoryUsage (&sUsage);
+  EXPECT_EQ (0, sUsage.iCurrentBytes);
+}
+//Tests of WelsAddMemoryUsage End
@@ -530,6 +530,21 @@ TEST_F (SadSatdCFuncTest, WelsSampleSadFour4x8_c) {
   EXPECT_EQ (m_pSad[0] + m_pSad[1] + m_pSad[2] + m_pSad[3], iSumSad);
 }
 
+TEST_F (SadSatdCFuncTest, WelsSampleSadMulti16x16_c) {
+  for (int i = 0; i < (m_iStrideA << 5); i++)
+    m_pPixSrcA[i] = rand() % 256;
+  for (int i = 0; i < (m_iStrideB << 5); i++)
+    m_pPixSrcB[i] = rand() % 256;
+  int32_t iOffset[16];
+  int32_t iSad[16];
+  const int32_t kiCount = rand() % 16 + 1;
+  for (int i = 0; i < kiCount; i++)
+    iOffset[i] = (rand() % 17) * m_iStrideB + rand() % (m_iStrideB - 15);
+  WelsSampleSadMulti16x16_c (m_pPixSrcA, m_iStrideA, m_pPixSrcB, m_iStrideB, iOffset, kiCount, iSad);
+  for (int i = 0; i < kiCount; i++)
+    EXPECT_EQ (iSad[i], WelsSampleSad16x16_c (m_pPixSrcA, m_iStrideA, m_pPixSrcB + iOffset[i], m_iStrideB));
+}
+
 class SadSatdAssemblyFuncTest : public testing::Test {
  public:
   virtual void SetUp() {
@@ -767,3 +782,33 @@ GENERATE_SadFour_UT (WelsSampleSadFour8x16_lasx, WELS_CPU_LASX, 8, 16)
 GENERATE_SadFour_UT (WelsSampleSadFour16x8_lasx, WELS_CPU_LASX, 16, 8)
 GENERATE_SadFour_UT (WelsSampleSadFour16x16_lasx, WELS_CPU_LASX, 16, 16)
 #endif
+
+#define GENERATE_SadMulti_UT(func, ref, CPUFLAGS, width, height) \
+TEST_F (SadSatdAssemblyFuncTest, func) { \
+  if (0 == (m_uiCpuFeatureFlag & CPUFLAGS)) \
+    return; \
+  for (int i = 0; i < (m_iStrideA << 5); i++) \
+    m_pPixSrcA[i] = rand() % 256; \
+  for (int i = 0; i < (m_iStrideB << 5); i++) \
+    m_pPixSrcB[i] = rand() % 256; \
+  int32_t iOffset[16]; \
+  int32_t iSad[16]; \
+  int32_t iSadRef[16]; \
+  for (int32_t iCount = 0; iCount <= 16; iCount++) { \
+    for (int i = 0; i < iCount; i++) \
+      iOffset[i] = (rand() % (33 - height)) * m_iStrideB + rand() % (m_iStrideB - width + 1); \
+    func (m_pPixSrcA, m_iStrideA, m_pPixSrcB, m_iStrideB, iOffset, iCount, iSad); \
+    ref (m_pPixSrcA, m_iStrideA, m_pPixSrcB, m_iStrideB, iOffset, iCount, iSadRef); \
+    for (int i = 0; i < iCount; i++) \
+      EXPECT_EQ (iSad[i], iSadRef[i]); \
+  } \
+}
+
+#if defined(X86_ASM) && defined(HAVE_AVX2) && !defined(X86_32_ASM)
+GENERATE_SadMulti_UT (WelsSampleSadMulti16x16_avx2, WelsSampleSadMulti16x16_c, WELS_CPU_AVX2, 16, 16)
+GENERATE_SadMulti_UT (WelsSampleSadMulti16x8_avx2, WelsSampleSadMulti16x8_c, WELS_CPU_AVX2, 16, 8)
+GENERATE_SadMulti_UT (WelsSampleSadMulti8x16_avx2, WelsSampleSadMulti8x16_c, WELS_CPU_AVX2, 8, 16)
+GENERATE_SadMulti_UT (WelsSampleSadMulti8x8_avx2, WelsSampleSadMulti8x8_c, WELS_CPU_AVX2, 8, 8)
+GENERATE_SadMulti_UT (WelsSampleSadMulti16x16_avx512, WelsSampleSadMulti16x16_c, WELS_CPU_AVX512BW, 16, 16)
+GENERATE_SadMulti_UT (WelsSampleSadMulti16x8_avx512, WelsSampleSadMulti16x8_c, WELS_CPU_AVX512BW, 16, 8)
+#endif